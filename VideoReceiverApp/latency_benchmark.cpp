@@ -0,0 +1,773 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
+
+#include <algorithm>
+#include <functional>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include "QGCLoggingCategory.h"
+
+#include <GStreamer.h>
+#include <VideoReceiver.h>
+
+QGC_LOGGING_CATEGORY(BenchmarkLog, "VideoLatencyBenchmark")
+
+// Every frame leaving the sender carries a barcode in the top left corner of its luma plane: a magic marker, a frame
+// sequence number and the monotonic time at which the frame was handed to the encoder. Bits are painted as 16x16
+// blocks so they survive lossy encoding. Sender and receiver run in the same process so they share the clock.
+static const int        kBlockSize  = 16;
+static const int        kMagicBits  = 16;
+static const int        kSeqBits    = 32;
+static const int        kTimeBits   = 64;
+static const int        kTotalBits  = kMagicBits + kSeqBits + kTimeBits;
+static const quint16    kMagic      = 0xA55A;
+static const guint8     kBitOn      = 235;
+static const guint8     kBitOff     = 16;
+
+static bool
+lumaFirst(GstVideoFormat format)
+{
+    switch (format) {
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_YV12:
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21:
+    case GST_VIDEO_FORMAT_Y42B:
+    case GST_VIDEO_FORMAT_Y444:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void
+writeBarcode(GstVideoFrame* frame, quint32 seq, qint64 time)
+{
+    guint8* luma    = static_cast<guint8*>(GST_VIDEO_FRAME_PLANE_DATA(frame, 0));
+    const int stride    = GST_VIDEO_FRAME_PLANE_STRIDE(frame, 0);
+    const int columns   = GST_VIDEO_FRAME_WIDTH(frame) / kBlockSize;
+
+    for (int i = 0; i < kTotalBits; i++) {
+        bool bit;
+
+        if (i < kMagicBits) {
+            bit = (kMagic >> i) & 1;
+        } else if (i < kMagicBits + kSeqBits) {
+            bit = (seq >> (i - kMagicBits)) & 1;
+        } else {
+            bit = (static_cast<quint64>(time) >> (i - kMagicBits - kSeqBits)) & 1;
+        }
+
+        const int x = (i % columns) * kBlockSize;
+        const int y = (i / columns) * kBlockSize;
+
+        for (int row = y; row < y + kBlockSize; row++) {
+            memset(luma + row * stride + x, bit ? kBitOn : kBitOff, kBlockSize);
+        }
+    }
+}
+
+static bool
+readBarcode(const GstVideoFrame* frame, quint32& seq, qint64& time)
+{
+    const guint8* luma  = static_cast<const guint8*>(GST_VIDEO_FRAME_PLANE_DATA(frame, 0));
+    const int stride    = GST_VIDEO_FRAME_PLANE_STRIDE(frame, 0);
+    const int columns   = GST_VIDEO_FRAME_WIDTH(frame) / kBlockSize;
+
+    quint16 magic   = 0;
+    quint64 stamp   = 0;
+
+    seq = 0;
+
+    for (int i = 0; i < kTotalBits; i++) {
+        // Only the center of the block is sampled, edges are smeared by the encoder
+        const int x = (i % columns) * kBlockSize + kBlockSize / 4;
+        const int y = (i / columns) * kBlockSize + kBlockSize / 4;
+
+        int sum = 0;
+
+        for (int row = y; row < y + kBlockSize / 2; row++) {
+            for (int col = x; col < x + kBlockSize / 2; col++) {
+                sum += luma[row * stride + col];
+            }
+        }
+
+        const quint64 bit = sum / (kBlockSize * kBlockSize / 4) > (kBitOn + kBitOff) / 2 ? 1 : 0;
+
+        if (i < kMagicBits) {
+            magic |= bit << i;
+        } else if (i < kMagicBits + kSeqBits) {
+            seq |= bit << (i - kMagicBits);
+        } else {
+            stamp |= bit << (i - kMagicBits - kSeqBits);
+        }
+    }
+
+    time = static_cast<qint64>(stamp);
+
+    return magic == kMagic;
+}
+
+class VideoLatencyBenchmark
+{
+public:
+    VideoLatencyBenchmark(QCoreApplication& app)
+        : _app(app)
+    {}
+
+    int exec();
+
+private:
+    enum Transport {
+        TransportRtp,           ///< RTP over UDP
+        TransportTaisyncRelay,  ///< Raw h.264 over TCP, relayed to UDP the way QGC used to handle Taisync
+        TransportTaisync,       ///< Raw h.264 over TCP, received directly by the pipeline
+    };
+
+    struct Config {
+        VideoSettings::VideoDecoderOptions decoder;
+        Transport   transport;
+        int         buffer;
+        bool        sync;
+    };
+
+    // Filled from the sender and video sink streaming threads
+    struct Stats {
+        QMutex              lock;
+        bool                measuring   = false;
+        quint32             sent        = 0;
+        quint32             firstSeq    = 0;
+        quint32             lastSeq     = 0;
+        quint32             undecodable = 0;
+        QVector<qint64>     latencies;
+        QVector<quint32>    seqs;
+    };
+
+    void _startConfig();
+    void _finishConfig();
+    void _report(const Config& config, const QString& failure);
+    bool _startSender(int port, bool taisync);
+    void _stopSender();
+    bool _startRelay(int tcpPort, int udpPort);
+    void _stopRelay();
+    QString _decoderName();
+    void _dispatch(std::function<void()> code);
+
+    static GstPadProbeReturn _senderProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static void _onHandoff(GstElement* sink, GstBuffer* buffer, GstPad* pad, gpointer user_data);
+
+    QCoreApplication&   _app;
+    QTextStream         _out            {stdout};
+    VideoReceiver*      _receiver       = nullptr;
+    GstElement*         _sender         = nullptr;
+    GstElement*         _videoSink      = nullptr;
+    QTcpServer*         _relayServer    = nullptr;
+    QTcpSocket*         _relaySocket    = nullptr;
+    QUdpSocket*         _relayUdp       = nullptr;
+    QVector<Config>     _configs;
+    int                 _current        = -1;
+    int                 _activeDecoder  = -1;
+    unsigned            _duration       = 10;
+    unsigned            _warmup         = 1;
+    unsigned            _timeout        = 5;
+    int                 _port           = 5700;
+    int                 _fps            = 30;
+    bool                _running        = false;
+    bool                _decoding       = false;
+    QString             _decoderElement;
+    QString             _failure;
+    Stats               _stats;
+};
+
+int
+VideoLatencyBenchmark::exec()
+{
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription(QCoreApplication::translate("main",
+        "Measures the latency GstVideoReceiver adds between a local RTP/H.264 sender and the video sink."));
+
+    parser.addHelpOption();
+
+    QCommandLineOption durationOption(QStringList() << "d" << "duration",
+        QCoreApplication::translate("main", "Measurement time per configuration."),
+        QCoreApplication::translate("main", "seconds"));
+
+    parser.addOption(durationOption);
+
+    QCommandLineOption warmupOption(QStringList() << "w" << "warmup",
+        QCoreApplication::translate("main", "Time after the first decoded frame which is not measured."),
+        QCoreApplication::translate("main", "seconds"));
+
+    parser.addOption(warmupOption);
+
+    QCommandLineOption portOption(QStringList() << "p" << "port",
+        QCoreApplication::translate("main", "First UDP port, each configuration uses the next one."),
+        QCoreApplication::translate("main", "port"));
+
+    parser.addOption(portOption);
+
+    QCommandLineOption fpsOption("fps",
+        QCoreApplication::translate("main", "Sender frame rate."),
+        QCoreApplication::translate("main", "fps"));
+
+    parser.addOption(fpsOption);
+
+    QCommandLineOption decoderOption("decoder",
+        QCoreApplication::translate("main", "Only run with decoder option: 0 - default, 1 - software"),
+        QCoreApplication::translate("main", "decoder"));
+
+    parser.addOption(decoderOption);
+
+    QCommandLineOption taisyncOption("taisync",
+        QCoreApplication::translate("main", "Compare the Taisync TCP to UDP relay against receiving the TCP stream directly."));
+
+    parser.addOption(taisyncOption);
+
+    parser.process(_app);
+
+    if (parser.isSet(durationOption)) {
+        _duration = qMax(1u, parser.value(durationOption).toUInt());
+    }
+
+    if (parser.isSet(warmupOption)) {
+        _warmup = parser.value(warmupOption).toUInt();
+    }
+
+    if (parser.isSet(portOption)) {
+        _port = parser.value(portOption).toInt();
+    }
+
+    if (parser.isSet(fpsOption)) {
+        _fps = qBound(1, parser.value(fpsOption).toInt(), 120);
+    }
+
+    QVector<VideoSettings::VideoDecoderOptions> decoders;
+
+    if (parser.isSet(decoderOption)) {
+        decoders.append(static_cast<VideoSettings::VideoDecoderOptions>(parser.value(decoderOption).toInt()));
+    } else {
+        // Ranks raised by blacklist() are never lowered again, so the default ranking has to be measured first
+        decoders << VideoSettings::ForceVideoDecoderDefault << VideoSettings::ForceVideoDecoderSoftware;
+    }
+
+    for (VideoSettings::VideoDecoderOptions decoder : decoders) {
+        if (parser.isSet(taisyncOption)) {
+            // A raw byte stream carries no timestamps, jitter buffer and sink sync don't apply
+            for (Transport transport : {TransportTaisyncRelay, TransportTaisync}) {
+                _configs.append({decoder, transport, -1, false});
+            }
+        } else {
+            // buffer -1 is the low latency mode: no jitter buffer and the receiver turns sink sync off.
+            // Sink sync is overridden afterwards so that both sync modes are measured with and without jitter buffer.
+            for (int buffer : {-1, 0}) {
+                for (bool sync : {false, true}) {
+                    _configs.append({decoder, TransportRtp, buffer, sync});
+                }
+            }
+        }
+    }
+
+    _receiver = GStreamer::createVideoReceiver(nullptr);
+
+    QObject::connect(_receiver, &VideoReceiver::onStartComplete, &_app, [this](VideoReceiver::STATUS status){
+        if (status != VideoReceiver::STATUS_OK) {
+            _failure = QStringLiteral("start failed");
+            _dispatch([this](){
+                _finishConfig();
+            });
+        } else if (_sender == nullptr && _running) {
+            // Taisync senders connect to the receiver, which only listens once it has started
+            if (!_startSender(_port + 2 * _current, true)) {
+                _failure = QStringLiteral("sender failed");
+                _receiver->stop();
+            }
+        }
+    });
+
+    QObject::connect(_receiver, &VideoReceiver::decodingChanged, &_app, [this](bool active){
+        if (!active || _decoding || _current < 0) {
+            return;
+        }
+
+        _decoding = true;
+        _decoderElement = _decoderName();
+
+        // The receiver sets sync on the sink from the buffer mode when the sink is linked, which happened by now
+        g_object_set(_videoSink, "sync", _configs[_current].sync, NULL);
+
+        const int current = _current;
+
+        QTimer::singleShot(_warmup * 1000, &_app, [this, current](){
+            if (current == _current) {
+                QMutexLocker locker(&_stats.lock);
+                _stats.measuring = true;
+            }
+        });
+
+        QTimer::singleShot((_warmup + _duration) * 1000, &_app, [this, current](){
+            if (current == _current) {
+                _receiver->stop();
+            }
+        });
+    });
+
+    QObject::connect(_receiver, &VideoReceiver::onStopComplete, &_app, [this](VideoReceiver::STATUS){
+        _finishConfig();
+    });
+
+    _out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11")
+        .arg("transport", -9)
+        .arg("decoder", -16)
+        .arg("buffer", 6)
+        .arg("sync", 5)
+        .arg("frames", 7)
+        .arg("dropped", 8)
+        .arg("p50 ms", 8)
+        .arg("p90 ms", 8)
+        .arg("p99 ms", 8)
+        .arg("max ms", 8)
+        .arg("mean ms", 8) << endl;
+
+    _dispatch([this](){
+        _startConfig();
+    });
+
+    const int result = _app.exec();
+
+    delete _receiver;
+    _receiver = nullptr;
+
+    return result;
+}
+
+void
+VideoLatencyBenchmark::_startConfig()
+{
+    if (++_current >= _configs.count()) {
+        _app.exit(0);
+        return;
+    }
+
+    const Config& config = _configs[_current];
+
+    if (config.decoder != _activeDecoder) {
+        GStreamer::blacklist(config.decoder);
+        _activeDecoder = config.decoder;
+    }
+
+    {
+        QMutexLocker locker(&_stats.lock);
+        _stats.measuring    = false;
+        _stats.sent         = 0;
+        _stats.firstSeq     = 0;
+        _stats.lastSeq      = 0;
+        _stats.undecodable  = 0;
+        _stats.latencies.clear();
+        _stats.seqs.clear();
+    }
+
+    _decoding = false;
+    _decoderElement.clear();
+    _failure.clear();
+
+    // Each configuration gets fresh ports so that nothing left over from the previous one is received
+    const int port      = _port + 2 * _current;
+    const int relayPort = port + 1;
+
+    QString uri;
+
+    switch (config.transport) {
+    case TransportRtp:
+        uri = QStringLiteral("udp://0.0.0.0:%1").arg(port);
+        break;
+    case TransportTaisyncRelay:
+        uri = QStringLiteral("tsusb://0.0.0.0:%1").arg(relayPort);
+        break;
+    case TransportTaisync:
+        uri = QStringLiteral("taisync://0.0.0.0:%1").arg(port);
+        break;
+    }
+
+    if (config.transport == TransportRtp && !_startSender(port, false)) {
+        _report(config, QStringLiteral("sender failed"));
+        _dispatch([this](){
+            _startConfig();
+        });
+        return;
+    }
+
+    if (config.transport == TransportTaisyncRelay && !_startRelay(port, relayPort)) {
+        _report(config, QStringLiteral("relay failed"));
+        _dispatch([this](){
+            _startConfig();
+        });
+        return;
+    }
+
+    if ((_videoSink = gst_element_factory_make("fakesink", nullptr)) == nullptr) {
+        qCCritical(BenchmarkLog) << "Failed to create video sink";
+        _stopSender();
+        _stopRelay();
+        _app.exit(1);
+        return;
+    }
+
+    g_object_set(_videoSink, "signal-handoffs", TRUE, NULL);
+    g_signal_connect(_videoSink, "handoff", G_CALLBACK(_onHandoff), this);
+
+    _running = true;
+
+    _receiver->start(uri, _timeout, config.buffer);
+    _receiver->startDecoding(_videoSink);
+
+    const int current = _current;
+
+    QTimer::singleShot(_timeout * 1000, &_app, [this, current](){
+        if (current == _current && !_decoding) {
+            _failure = QStringLiteral("no video");
+            _receiver->stop();
+        }
+    });
+}
+
+void
+VideoLatencyBenchmark::_finishConfig()
+{
+    if (!_running) {
+        // Already finished, for example start failure followed by stop complete
+        return;
+    }
+
+    _running = false;
+
+    _stopSender();
+    _stopRelay();
+
+    _report(_configs[_current], _failure);
+
+    if (_videoSink != nullptr) {
+        gst_object_unref(_videoSink);
+        _videoSink = nullptr;
+    }
+
+    _dispatch([this](){
+        _startConfig();
+    });
+}
+
+void
+VideoLatencyBenchmark::_report(const Config& config, const QString& failure)
+{
+    static const char* decoderNames[] = { "default", "software", "nvidia", "vaapi", "d3d11", "videotoolbox" };
+
+    QString decoder = config.decoder >= 0 && config.decoder < static_cast<int>(sizeof(decoderNames) / sizeof(decoderNames[0])) ?
+                decoderNames[config.decoder] : QString::number(config.decoder);
+
+    if (!_decoderElement.isEmpty()) {
+        decoder += QStringLiteral("/") + _decoderElement;
+    }
+
+    static const char* transportNames[] = { "rtp", "relay", "taisync" };
+
+    const QString prefix = QStringLiteral("%1 %2 %3 %4 ")
+        .arg(transportNames[config.transport], -9)
+        .arg(decoder, -16)
+        .arg(config.buffer, 6)
+        .arg(config.sync ? "on" : "off", 5);
+
+    QMutexLocker locker(&_stats.lock);
+
+    if (!failure.isEmpty() || _stats.latencies.isEmpty()) {
+        _out << prefix << (failure.isEmpty() ? QStringLiteral("no frames measured") : failure) << endl;
+        return;
+    }
+
+    QVector<qint64> latencies = _stats.latencies;
+    std::sort(latencies.begin(), latencies.end());
+
+    // Nearest rank percentile
+    auto percentile = [&latencies](int p) {
+        const int rank = qBound(0, (latencies.count() * p + 99) / 100 - 1, latencies.count() - 1);
+        return latencies[rank] / 1000.0;
+    };
+
+    qint64 sum = 0;
+    for (qint64 latency : latencies) {
+        sum += latency;
+    }
+
+    // Frames the sender produced in the measured range which never made it to the sink
+    QVector<quint32> seqs = _stats.seqs;
+    std::sort(seqs.begin(), seqs.end());
+    seqs.erase(std::unique(seqs.begin(), seqs.end()), seqs.end());
+    const int expected  = static_cast<int>(_stats.lastSeq - _stats.firstSeq) + 1;
+    const int dropped   = qMax(0, expected - seqs.count());
+
+    _out << prefix << QStringLiteral("%1 %2 %3 %4 %5 %6 %7")
+        .arg(latencies.count(), 7)
+        .arg(dropped, 8)
+        .arg(percentile(50), 8, 'f', 1)
+        .arg(percentile(90), 8, 'f', 1)
+        .arg(percentile(99), 8, 'f', 1)
+        .arg(latencies.last() / 1000.0, 8, 'f', 1)
+        .arg(sum / 1000.0 / latencies.count(), 8, 'f', 1) << endl;
+
+    if (_stats.undecodable > 0) {
+        qCWarning(BenchmarkLog) << "Frames without readable timestamp:" << _stats.undecodable;
+    }
+}
+
+bool
+VideoLatencyBenchmark::_startSender(int port, bool taisync)
+{
+    // Software encoder tuned for latency, so that the encoder adds as little as possible to the measurement.
+    // Taisync ground units connect to QGC and send a raw h.264 byte stream.
+    const QString output = taisync ?
+        QStringLiteral("h264parse config-interval=-1 ! video/x-h264,stream-format=byte-stream,alignment=au ! "
+                       "tcpclientsink host=127.0.0.1 port=%1 sync=false").arg(port) :
+        QStringLiteral("rtph264pay config-interval=1 pt=96 ! udpsink host=127.0.0.1 port=%1 sync=false async=false").arg(port);
+
+    const QString description = QStringLiteral(
+        "videotestsrc is-live=true pattern=ball ! video/x-raw,format=I420,width=320,height=240,framerate=%1/1 ! "
+        "identity name=stamp ! x264enc tune=zerolatency speed-preset=ultrafast key-int-max=%1 bitrate=2000 ! %2")
+        .arg(_fps).arg(output);
+
+    GError* error = nullptr;
+
+    if ((_sender = gst_parse_launch(description.toUtf8().constData(), &error)) == nullptr) {
+        qCCritical(BenchmarkLog) << "Failed to create sender:" << (error ? error->message : "");
+        g_clear_error(&error);
+        return false;
+    }
+
+    g_clear_error(&error);
+
+    GstElement* stamp = gst_bin_get_by_name(GST_BIN(_sender), "stamp");
+    GstPad* pad = gst_element_get_static_pad(stamp, "src");
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _senderProbe, this, nullptr);
+    gst_object_unref(pad);
+    gst_object_unref(stamp);
+
+    if (gst_element_set_state(_sender, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        qCCritical(BenchmarkLog) << "Failed to start sender";
+        _stopSender();
+        return false;
+    }
+
+    return true;
+}
+
+void
+VideoLatencyBenchmark::_stopSender()
+{
+    if (_sender != nullptr) {
+        gst_element_set_state(_sender, GST_STATE_NULL);
+        gst_object_unref(_sender);
+        _sender = nullptr;
+    }
+}
+
+// Same relay TaisyncVideoReceiver used to do: everything read from TCP goes out as a single loopback datagram
+bool
+VideoLatencyBenchmark::_startRelay(int tcpPort, int udpPort)
+{
+    _relayServer    = new QTcpServer();
+    _relayUdp       = new QUdpSocket();
+
+    QObject::connect(_relayServer, &QTcpServer::newConnection, [this, udpPort](){
+        delete _relaySocket;
+
+        if ((_relaySocket = _relayServer->nextPendingConnection()) == nullptr) {
+            return;
+        }
+
+        QObject::connect(_relaySocket, &QIODevice::readyRead, [this, udpPort](){
+            QByteArray bytesIn = _relaySocket->read(_relaySocket->bytesAvailable());
+            _relayUdp->writeDatagram(bytesIn, QHostAddress::LocalHost, udpPort);
+        });
+    });
+
+    if (!_relayServer->listen(QHostAddress::LocalHost, tcpPort)) {
+        qCCritical(BenchmarkLog) << "Relay failed to listen:" << _relayServer->errorString();
+        _stopRelay();
+        return false;
+    }
+
+    return true;
+}
+
+void
+VideoLatencyBenchmark::_stopRelay()
+{
+    delete _relaySocket;
+    _relaySocket = nullptr;
+
+    delete _relayServer;
+    _relayServer = nullptr;
+
+    delete _relayUdp;
+    _relayUdp = nullptr;
+}
+
+QString
+VideoLatencyBenchmark::_decoderName()
+{
+    GstObject* pipeline = gst_element_get_parent(_videoSink);
+
+    if (pipeline == nullptr) {
+        return QString();
+    }
+
+    QString name;
+    GstIterator* it = gst_bin_iterate_recurse(GST_BIN(pipeline));
+    GValue item = G_VALUE_INIT;
+
+    while (name.isEmpty() && gst_iterator_next(it, &item) == GST_ITERATOR_OK) {
+        GstElement* element = GST_ELEMENT(g_value_get_object(&item));
+        GstElementFactory* factory = gst_element_get_factory(element);
+
+        if (factory != nullptr) {
+            const char* klass = gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+
+            if (klass != nullptr && strstr(klass, "Decoder") != nullptr && strstr(klass, "Video") != nullptr) {
+                name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+            }
+        }
+
+        g_value_reset(&item);
+    }
+
+    g_value_unset(&item);
+    gst_iterator_free(it);
+    gst_object_unref(pipeline);
+
+    return name;
+}
+
+void
+VideoLatencyBenchmark::_dispatch(std::function<void()> code)
+{
+    QMetaObject::invokeMethod(&_app, code, Qt::QueuedConnection);
+}
+
+GstPadProbeReturn
+VideoLatencyBenchmark::_senderProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    VideoLatencyBenchmark* self = static_cast<VideoLatencyBenchmark*>(user_data);
+
+    GstCaps* caps = gst_pad_get_current_caps(pad);
+
+    if (caps == nullptr) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstVideoInfo videoInfo;
+    const bool haveInfo = gst_video_info_from_caps(&videoInfo, caps);
+    gst_caps_unref(caps);
+
+    if (!haveInfo) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstBuffer* buffer = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+    GST_PAD_PROBE_INFO_DATA(info) = buffer;
+
+    GstVideoFrame frame;
+
+    if (!gst_video_frame_map(&frame, &videoInfo, buffer, GST_MAP_WRITE)) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    quint32 seq;
+
+    {
+        QMutexLocker locker(&self->_stats.lock);
+        seq = self->_stats.sent++;
+    }
+
+    writeBarcode(&frame, seq, g_get_monotonic_time());
+
+    gst_video_frame_unmap(&frame);
+
+    return GST_PAD_PROBE_OK;
+}
+
+void
+VideoLatencyBenchmark::_onHandoff(GstElement* sink, GstBuffer* buffer, GstPad* pad, gpointer user_data)
+{
+    Q_UNUSED(sink)
+
+    // Handoff is signalled when the sink renders the buffer, so with sync on this includes the wait for the clock
+    const qint64 now = g_get_monotonic_time();
+
+    VideoLatencyBenchmark* self = static_cast<VideoLatencyBenchmark*>(user_data);
+
+    GstCaps* caps = gst_pad_get_current_caps(pad);
+
+    if (caps == nullptr) {
+        return;
+    }
+
+    GstVideoInfo videoInfo;
+    const bool haveInfo = gst_video_info_from_caps(&videoInfo, caps);
+    gst_caps_unref(caps);
+
+    if (!haveInfo || !lumaFirst(GST_VIDEO_INFO_FORMAT(&videoInfo))) {
+        return;
+    }
+
+    GstVideoFrame frame;
+
+    if (!gst_video_frame_map(&frame, &videoInfo, buffer, GST_MAP_READ)) {
+        return;
+    }
+
+    quint32 seq;
+    qint64 time;
+    const bool valid = readBarcode(&frame, seq, time);
+
+    gst_video_frame_unmap(&frame);
+
+    QMutexLocker locker(&self->_stats.lock);
+
+    if (!self->_stats.measuring) {
+        return;
+    }
+
+    if (!valid || time > now) {
+        self->_stats.undecodable++;
+        return;
+    }
+
+    if (self->_stats.seqs.isEmpty()) {
+        self->_stats.firstSeq   = seq;
+        self->_stats.lastSeq    = seq;
+    } else {
+        self->_stats.firstSeq   = qMin(self->_stats.firstSeq, seq);
+        self->_stats.lastSeq    = qMax(self->_stats.lastSeq, seq);
+    }
+
+    self->_stats.seqs.append(seq);
+    self->_stats.latencies.append(now - time);
+}
+
+int main(int argc, char *argv[])
+{
+    GStreamer::initialize(argc, argv, 3);
+
+    QCoreApplication app(argc, argv);
+    VideoLatencyBenchmark benchmark(app);
+
+    return benchmark.exec();
+}
@@ -461,11 +461,20 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/qgcunittest
 
     HEADERS += \
+        src/AnalyzeView/MavlinkConsoleControllerTest.h \
         src/Audio/AudioOutputTest.h \
+        src/AutoPilotPlugins/APM/APMCompassCalTest.h \
+        src/comm/LinkReceiveBufferTest.h \
+        src/comm/MAVLinkSigningTest.h \
+        src/comm/SerialPortWatcherTest.h \
+        src/Compression/QGCCompressionTest.h \
         src/FactSystem/FactSystemTestBase.h \
         src/FactSystem/FactSystemTestGeneric.h \
         src/FactSystem/FactSystemTestPX4.h \
         src/FactSystem/ParameterManagerTest.h \
+        src/FactSystem/QGCSettingsStoreTest.h \
+        src/FollowMe/FollowMeEstimatorTest.h \
+        src/GPS/GPSSerialIOTest.h \
         src/MissionManager/CameraCalcTest.h \
         src/MissionManager/CameraSectionTest.h \
         src/MissionManager/CorridorScanComplexItemTest.h \
@@ -489,16 +498,25 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/TransectStyleComplexItemTest.h \
         src/MissionManager/TransectStyleComplexItemTestBase.h \
         src/MissionManager/VisualMissionItemTest.h \
+        src/QmlControls/AppMessagesTest.h \
+        src/QmlControls/FlightPathSegmentTest.h \
+        src/QmlControls/TerrainProfileTest.h \
         src/qgcunittest/GeoTest.h \
         src/qgcunittest/MavlinkLogTest.h \
         src/qgcunittest/MultiSignalSpy.h \
         src/qgcunittest/MultiSignalSpyV2.h \
         src/qgcunittest/UnitTest.h \
+        src/uas/UASMessageHandlerTest.h \
+        src/Vehicle/ComponentInformationManagerTest.h \
         src/Vehicle/FTPManagerTest.h \
+        src/Vehicle/InitialConnectStateMachineTest.h \
+        src/Vehicle/MAVLinkLogProcessorTest.h \
         src/Vehicle/RequestMessageTest.h \
         src/Vehicle/SendMavCommandWithHandlerTest.h \
         src/Vehicle/SendMavCommandWithSignallingTest.h \
         src/Vehicle/VehicleLinkManagerTest.h \
+        src/VideoManager/TelemetryTrackTest.h \
+        src/VideoManager/VideoStreamTest.h \
         #src/qgcunittest/RadioConfigTest.h \
         #src/AnalyzeView/LogDownloadTest.h \
         #src/qgcunittest/FileDialogTest.h \
@@ -507,11 +525,20 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         #src/qgcunittest/MessageBoxTest.h \
 
     SOURCES += \
+        src/AnalyzeView/MavlinkConsoleControllerTest.cc \
         src/Audio/AudioOutputTest.cc \
+        src/AutoPilotPlugins/APM/APMCompassCalTest.cc \
+        src/comm/LinkReceiveBufferTest.cc \
+        src/comm/MAVLinkSigningTest.cc \
+        src/comm/SerialPortWatcherTest.cc \
+        src/Compression/QGCCompressionTest.cc \
         src/FactSystem/FactSystemTestBase.cc \
         src/FactSystem/FactSystemTestGeneric.cc \
         src/FactSystem/FactSystemTestPX4.cc \
         src/FactSystem/ParameterManagerTest.cc \
+        src/FactSystem/QGCSettingsStoreTest.cc \
+        src/FollowMe/FollowMeEstimatorTest.cc \
+        src/GPS/GPSSerialIOTest.cc \
         src/MissionManager/CameraCalcTest.cc \
         src/MissionManager/CameraSectionTest.cc \
         src/MissionManager/CorridorScanComplexItemTest.cc \
@@ -535,17 +562,26 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/TransectStyleComplexItemTest.cc \
         src/MissionManager/TransectStyleComplexItemTestBase.cc \
         src/MissionManager/VisualMissionItemTest.cc \
+        src/QmlControls/AppMessagesTest.cc \
+        src/QmlControls/FlightPathSegmentTest.cc \
+        src/QmlControls/TerrainProfileTest.cc \
         src/qgcunittest/GeoTest.cc \
         src/qgcunittest/MavlinkLogTest.cc \
         src/qgcunittest/MultiSignalSpy.cc \
         src/qgcunittest/MultiSignalSpyV2.cc \
         src/qgcunittest/UnitTest.cc \
         src/qgcunittest/UnitTestList.cc \
+        src/uas/UASMessageHandlerTest.cc \
+        src/Vehicle/ComponentInformationManagerTest.cc \
         src/Vehicle/FTPManagerTest.cc \
+        src/Vehicle/InitialConnectStateMachineTest.cc \
+        src/Vehicle/MAVLinkLogProcessorTest.cc \
         src/Vehicle/RequestMessageTest.cc \
         src/Vehicle/SendMavCommandWithHandlerTest.cc \
         src/Vehicle/SendMavCommandWithSignallingTest.cc \
         src/Vehicle/VehicleLinkManagerTest.cc \
+        src/VideoManager/TelemetryTrackTest.cc \
+        src/VideoManager/VideoStreamTest.cc \
         #src/qgcunittest/RadioConfigTest.cc \
         #src/AnalyzeView/LogDownloadTest.cc \
         #src/qgcunittest/FileDialogTest.cc \
@@ -573,6 +609,7 @@ HEADERS += \
     src/Compression/QGCZlib.h \
     src/FirmwarePlugin/PX4/px4_custom_mode.h \
     src/FollowMe/FollowMe.h \
+    src/FollowMe/FollowMeEstimator.h \
     src/Joystick/Joystick.h \
     src/Joystick/JoystickManager.h \
     src/JsonHelper.h \
@@ -709,8 +746,10 @@ HEADERS += \
     src/comm/LinkConfiguration.h \
     src/comm/LinkInterface.h \
     src/comm/LinkManager.h \
+    src/comm/LinkReceiveBuffer.h \
     src/comm/LogReplayLink.h \
     src/comm/MAVLinkProtocol.h \
+    src/comm/MAVLinkSigning.h \
     src/comm/QGCMAVLink.h \
     src/comm/TCPLink.h \
     src/comm/UDPLink.h \
@@ -718,6 +757,7 @@ HEADERS += \
     src/uas/UAS.h \
     src/uas/UASInterface.h \
     src/uas/UASMessageHandler.h \
+    src/uas/UASMessageListModel.h \
     src/AnalyzeView/GeoTagController.h \
     src/AnalyzeView/ExifParser.h \
 
@@ -761,6 +801,7 @@ contains (DEFINES, QGC_ENABLE_PAIRING) {
 HEADERS += \
     src/comm/QGCSerialPortInfo.h \
     src/comm/SerialLink.h \
+    src/comm/SerialPortWatcher.h \
 }
 
 !MobileBuild {
@@ -773,6 +814,7 @@ HEADERS += \
     src/GPS/GPSManager.h \
     src/GPS/GPSPositionMessage.h \
     src/GPS/GPSProvider.h \
+    src/GPS/GPSSerialIO.h \
     src/GPS/RTCM/RTCMMavlink.h \
     src/GPS/definitions.h \
     src/GPS/satellite_info.h \
@@ -806,6 +848,7 @@ SOURCES += \
     src/Compression/QGCLZMA.cc \
     src/Compression/QGCZlib.cc \
     src/FollowMe/FollowMe.cc \
+    src/FollowMe/FollowMeEstimator.cc \
     src/Joystick/Joystick.cc \
     src/Joystick/JoystickManager.cc \
     src/JsonHelper.cc \
@@ -939,8 +982,10 @@ SOURCES += \
     src/comm/LinkConfiguration.cc \
     src/comm/LinkInterface.cc \
     src/comm/LinkManager.cc \
+    src/comm/LinkReceiveBuffer.cc \
     src/comm/LogReplayLink.cc \
     src/comm/MAVLinkProtocol.cc \
+    src/comm/MAVLinkSigning.cc \
     src/comm/QGCMAVLink.cc \
     src/comm/TCPLink.cc \
     src/comm/UDPLink.cc \
@@ -948,6 +993,7 @@ SOURCES += \
     src/main.cc \
     src/uas/UAS.cc \
     src/uas/UASMessageHandler.cc \
+    src/uas/UASMessageListModel.cc \
     src/AnalyzeView/GeoTagController.cc \
     src/AnalyzeView/ExifParser.cc \
 
@@ -967,6 +1013,7 @@ SOURCES += \
 SOURCES += \
     src/comm/QGCSerialPortInfo.cc \
     src/comm/SerialLink.cc \
+    src/comm/SerialPortWatcher.cc \
 }
 
 contains(DEFINES, QGC_ENABLE_BLUETOOTH) {
@@ -990,6 +1037,7 @@ SOURCES += \
     src/GPS/Drivers/src/sbf.cpp \
     src/GPS/GPSManager.cc \
     src/GPS/GPSProvider.cc \
+    src/GPS/GPSSerialIO.cc \
     src/GPS/RTCM/RTCMMavlink.cc \
     src/Joystick/JoystickSDL.cc \
     src/RunGuard.cc \
@@ -1198,6 +1246,7 @@ HEADERS += \
     src/FactSystem/FactSystem.h \
     src/FactSystem/FactValueSliderListModel.h \
     src/FactSystem/ParameterManager.h \
+    src/FactSystem/QGCSettingsStore.h \
     src/FactSystem/SettingsFact.h \
 
 SOURCES += \
@@ -1208,6 +1257,7 @@ SOURCES += \
     src/FactSystem/FactSystem.cc \
     src/FactSystem/FactValueSliderListModel.cc \
     src/FactSystem/ParameterManager.cc \
+    src/FactSystem/QGCSettingsStore.cc \
     src/FactSystem/SettingsFact.cc \
 
 #-------------------------------------------------------------------------------------
@@ -1244,11 +1294,9 @@ contains (DEFINES, QGC_GST_TAISYNC_DISABLED) {
         iOSBuild | AndroidBuild {
             HEADERS += \
                 src/Taisync/TaisyncTelemetry.h \
-                src/Taisync/TaisyncVideoReceiver.h \
 
             SOURCES += \
                 src/Taisync/TaisyncTelemetry.cc \
-                src/Taisync/TaisyncVideoReceiver.cc \
         }
     }
 }
@@ -1370,11 +1418,15 @@ INCLUDEPATH += \
 
 HEADERS += \
     src/VideoManager/SubtitleWriter.h \
-    src/VideoManager/VideoManager.h
+    src/VideoManager/TelemetryTrack.h \
+    src/VideoManager/VideoManager.h \
+    src/VideoManager/VideoStream.h
 
 SOURCES += \
     src/VideoManager/SubtitleWriter.cc \
-    src/VideoManager/VideoManager.cc
+    src/VideoManager/TelemetryTrack.cc \
+    src/VideoManager/VideoManager.cc \
+    src/VideoManager/VideoStream.cc
 
 contains (CONFIG, DISABLE_VIDEOSTREAMING) {
     message("Skipping support for video streaming (manual override from command line)")
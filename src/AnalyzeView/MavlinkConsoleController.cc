@@ -12,11 +12,18 @@
 #include "UAS.h"
 
 #include <QClipboard>
+#include <QTextCodec>
+
+constexpr int MavlinkConsoleController::maxNumLines;
+constexpr int MavlinkConsoleController::maxLineWidth;
+constexpr int MavlinkConsoleController::maxRowsPastEnd;
 
 MavlinkConsoleController::MavlinkConsoleController()
-    : QStringListModel()
+    : QAbstractListModel()
 {
     auto *manager = qgcApp()->toolbox()->multiVehicleManager();
+    _utf8Decoder = QTextCodec::codecForName("UTF-8")->makeDecoder();
+
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &MavlinkConsoleController::_setActiveVehicle);
     _setActiveVehicle(manager->activeVehicle());
 }
@@ -27,6 +34,7 @@ MavlinkConsoleController::~MavlinkConsoleController()
         QByteArray msg;
         _sendSerialData(msg, true);
     }
+    delete _utf8Decoder;
 }
 
 void
@@ -69,6 +77,16 @@ MavlinkConsoleController::handleClipboard(const QString& command_pre)
     return clipboardData;
 }
 
+void
+MavlinkConsoleController::copyToClipboard(void) const
+{
+    QStringList lines;
+    for (const Row_t& row : _rows) {
+        lines.append(row.text);
+    }
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
+
 void
 MavlinkConsoleController::_setActiveVehicle(Vehicle* vehicle)
 {
@@ -79,12 +97,7 @@ MavlinkConsoleController::_setActiveVehicle(Vehicle* vehicle)
     _vehicle = vehicle;
 
     if (_vehicle) {
-        _incoming_buffer.clear();
-        // Reset the model
-        setStringList(QStringList());
-        _cursorY = 0;
-        _cursorX = 0;
-        _cursor_home_pos = -1;
+        _reset();
         _uas_connections << connect(_vehicle, &Vehicle::mavlinkSerialControl, this, &MavlinkConsoleController::_receiveData);
     }
 }
@@ -95,36 +108,26 @@ MavlinkConsoleController::_receiveData(uint8_t device, uint8_t, uint16_t, uint32
     if (device != SERIAL_CONTROL_DEV_SHELL)
         return;
 
-    // Append incoming data and parse for ANSI codes
-    _incoming_buffer.append(data);
-    while(!_incoming_buffer.isEmpty()) {
-        bool newline = false;
-        int idx = _incoming_buffer.indexOf('\n');
-        if (idx == -1) {
-            // Read the whole incoming buffer
-            idx = _incoming_buffer.size();
-        } else {
-            newline = true;
-        }
+    const char* bytes = data.constData();
+    const int   count = data.size();
 
-        QByteArray fragment = _incoming_buffer.mid(0, idx);
-        if (_processANSItext(fragment)) {
-            writeLine(_cursorY, fragment);
-            if (newline) {
-                _cursorY++;
-                _cursorX = 0;
-                // ensure line exists
-                int rc = rowCount();
-                if (_cursorY >= rc) {
-                    insertRows(rc, 1 + _cursorY - rc);
-                }
+    for (int i = 0; i < count; ) {
+        if (_parseState == ParseText) {
+            // Write runs of printable characters in one go
+            int end = i;
+            while (end < count && (static_cast<uint8_t>(bytes[end]) >= 0x20 || bytes[end] == '\t') && bytes[end] != '\x7F') {
+                end++;
+            }
+            if (end > i) {
+                _write(bytes + i, end - i);
+                i = end;
+                continue;
             }
-            _incoming_buffer.remove(0, idx + (newline ? 1 : 0));
-        } else {
-            // ANSI processing failed, need more data
-            return;
         }
+        _processByte(bytes[i++]);
     }
+
+    _emitDirtyRows();
 }
 
 void
@@ -164,68 +167,289 @@ MavlinkConsoleController::_sendSerialData(QByteArray data, bool close)
     }
 }
 
-bool
-MavlinkConsoleController::_processANSItext(QByteArray &line)
+void
+MavlinkConsoleController::_processByte(char c)
 {
-    // Iterate over the incoming buffer to parse off known ANSI control codes
-    for (int i = 0; i < line.size(); i++) {
-        if (line.at(i) == '\x1B') {
-            // For ANSI codes we expect at least 3 incoming chars
-            if (i < line.size() - 2 && line.at(i+1) == '[') {
-                // Parse ANSI code
-                switch(line.at(i+2)) {
-                    default:
-                        continue;
-                    case 'H':
-                        if (_cursor_home_pos == -1) {
-                            // Assign new home position if home is unset
-                            _cursor_home_pos = _cursorY;
-                        } else {
-                            // Rewind write cursor position to home
-                            _cursorY = _cursor_home_pos;
-                            _cursorX = 0;
-                        }
-                        break;
-                    case 'K':
-                        // Erase the current line to the end
-                        if (_cursorY < rowCount()) {
-                            auto idx = index(_cursorY);
-                            QString updated = data(idx, Qt::DisplayRole).toString();
-                            int eraseIdx = _cursorX + i;
-                            if (eraseIdx < updated.length()) {
-                                setData(idx, updated.remove(eraseIdx, updated.length()));
-                            }
-                        }
-                        break;
-                    case '2':
-                        // Check for sufficient buffer size
-                        if ( i >= line.size() - 3)
-                            return false;
-
-                        if (line.at(i+3) == 'J' && _cursor_home_pos != -1) {
-                            // Erase everything and rewind to home
-                            bool blocked = blockSignals(true);
-                            for (int j = _cursor_home_pos; j < rowCount(); j++)
-                                setData(index(j), "");
-                            blockSignals(blocked);
-                            QVector<int> roles({Qt::DisplayRole, Qt::EditRole});
-                            emit dataChanged(index(_cursorY), index(rowCount()), roles);
-                        }
-                        // Even if we didn't understand this ANSI code, remove the 4th char
-                        line.remove(i+3,1);
-                        break;
+    switch (_parseState) {
+    case ParseText:
+        switch (c) {
+        case '\x1B':
+            _parseState = ParseEscape;
+            break;
+        case '\n':
+            _newLine();
+            break;
+        case '\r':
+            _cursorX = 0;
+            break;
+        case '\b':
+            if (_cursorX > 0) {
+                _cursorX--;
+            }
+            break;
+        default:
+            // Other control characters are not displayed
+            break;
+        }
+        break;
+    case ParseEscape:
+        if (c == '[') {
+            _csiParams.clear();
+            _parseState = ParseCSI;
+        } else {
+            // Only control sequences are supported, other escapes are dropped
+            _parseState = ParseText;
+        }
+        break;
+    case ParseCSI:
+        if (c >= 0x30 && c <= 0x3F) {
+            // Parameter bytes, a sequence may be split across any number of packets
+            if (_csiParams.size() < 32) {
+                _csiParams.append(c);
+            }
+        } else if (c >= 0x40 && c <= 0x7E) {
+            _processCSI(c);
+            _parseState = ParseText;
+        }
+        break;
+    }
+}
+
+void
+MavlinkConsoleController::_processCSI(char command)
+{
+    // Cursor addressing is relative to the home position, which is set by the first ESC[H after a command was sent
+    const int top = _cursor_home_pos == -1 ? 0 : _cursor_home_pos;
+
+    switch (command) {
+    case 'H':
+    case 'f':
+        if (_cursor_home_pos == -1) {
+            _cursor_home_pos = _cursorY;
+        }
+        _cursorY = _cursor_home_pos + qMax(_csiParam(0, 1), 1) - 1;
+        _cursorX = qMax(_csiParam(1, 1), 1) - 1;
+        _clampCursor();
+        _ensureRow(_cursorY);
+        break;
+    case 'A':
+        _cursorY = qMax(top, _cursorY - qMax(_csiParam(0, 1), 1));
+        break;
+    case 'B':
+        _cursorY += qMax(_csiParam(0, 1), 1);
+        _clampCursor();
+        _ensureRow(_cursorY);
+        break;
+    case 'C':
+        _cursorX += qMax(_csiParam(0, 1), 1);
+        _clampCursor();
+        break;
+    case 'D':
+        _cursorX = qMax(0, _cursorX - qMax(_csiParam(0, 1), 1));
+        break;
+    case 'G':
+        _cursorX = qMax(_csiParam(0, 1), 1) - 1;
+        _clampCursor();
+        break;
+    case 'J':
+        switch (_csiParam(0, 0)) {
+        case 0:
+            // Erase from cursor to end of screen
+            _eraseRow(_cursorY, _cursorX, -1);
+            for (int row = _cursorY + 1; row < _rows.count(); row++) {
+                _eraseRow(row, 0, -1);
+            }
+            break;
+        case 1:
+            // Erase from start of screen to cursor
+            for (int row = top; row < _cursorY; row++) {
+                _eraseRow(row, 0, -1);
+            }
+            _eraseRow(_cursorY, 0, _cursorX + 1);
+            break;
+        case 2:
+            // Erase everything below home, the cursor is left where it is
+            if (_cursor_home_pos != -1) {
+                for (int row = _cursor_home_pos; row < _rows.count(); row++) {
+                    _eraseRow(row, 0, -1);
                 }
-                // Remove the parsed ANSI code and decrement the bufferpos
-                line.remove(i, 3);
-                i--;
-            } else {
-                // We can reasonably expect a control code was fragemented
-                // Stop parsing here and wait for it to come in
-                return false;
             }
+            break;
         }
+        break;
+    case 'K':
+        switch (_csiParam(0, 0)) {
+        case 0:
+            _eraseRow(_cursorY, _cursorX, -1);
+            break;
+        case 1:
+            _eraseRow(_cursorY, 0, _cursorX + 1);
+            break;
+        case 2:
+            _eraseRow(_cursorY, 0, -1);
+            break;
+        }
+        break;
+    default:
+        // Text attributes (m) and everything else are ignored
+        break;
     }
-    return true;
+}
+
+int
+MavlinkConsoleController::_csiParam(int index, int defaultValue) const
+{
+    const QList<QByteArray> params = _csiParams.split(';');
+    if (index >= params.count()) {
+        return defaultValue;
+    }
+
+    // The parameters come from the vehicle, keep them small enough for the cursor arithmetic
+    bool ok;
+    int value = params[index].toInt(&ok);
+    return ok ? qBound(0, value, maxLineWidth) : defaultValue;
+}
+
+/// Keeps cursor addressing from the vehicle from growing the buffer or a line without bound
+void
+MavlinkConsoleController::_clampCursor(void)
+{
+    _cursorY = qMin(_cursorY, _rows.count() - 1 + maxRowsPastEnd);
+    _cursorX = qMin(_cursorX, maxLineWidth - 1);
+}
+
+void
+MavlinkConsoleController::_write(const char* text, int length)
+{
+    _ensureRow(_cursorY);
+
+    // A multi byte character may be split across packets, the decoder holds on to the partial sequence
+    const QString fragment = _utf8Decoder->toUnicode(text, length);
+    if (fragment.isEmpty()) {
+        return;
+    }
+    QString& rowText = _rows[_cursorY].text;
+    if (rowText.length() < _cursorX) {
+        rowText.append(QString(_cursorX - rowText.length(), QLatin1Char(' ')));
+    }
+    rowText.replace(_cursorX, fragment.length(), fragment);
+    _cursorX += fragment.length();
+
+    _markDirty(_cursorY);
+}
+
+void
+MavlinkConsoleController::_newLine(void)
+{
+    _cursorY++;
+    _cursorX = 0;
+    _ensureRow(_cursorY);
+}
+
+void
+MavlinkConsoleController::_ensureRow(int row)
+{
+    const int rc = _rows.count();
+    if (row >= rc) {
+        beginInsertRows(QModelIndex(), rc, row);
+        for (int i = rc; i <= row; i++) {
+            _rows.append(Row_t{QString(), QString(), false});
+        }
+        endInsertRows();
+        _markDirty(row);
+    }
+
+    if (_rows.count() > maxNumLines) {
+        const int count = _rows.count() - maxNumLines;
+        beginRemoveRows(QModelIndex(), 0, count - 1);
+        _rows.erase(_rows.begin(), _rows.begin() + count);
+        endRemoveRows();
+
+        _cursorY -= count;
+        _cursor_home_pos -= count;
+        if (_cursor_home_pos < 0)
+            _cursor_home_pos = -1;
+
+        if (_dirtyFirst != -1) {
+            _dirtyFirst = qMax(0, _dirtyFirst - count);
+            _dirtyLast -= count;
+            if (_dirtyLast < 0) {
+                _dirtyFirst = _dirtyLast = -1;
+            }
+        }
+    }
+}
+
+void
+MavlinkConsoleController::_eraseRow(int row, int from, int to)
+{
+    if (row < 0 || row >= _rows.count()) {
+        return;
+    }
+
+    QString& rowText = _rows[row].text;
+    if (from >= rowText.length()) {
+        return;
+    }
+
+    if (to == -1 || to >= rowText.length()) {
+        rowText.truncate(from);
+    } else {
+        rowText.replace(from, to - from, QString(to - from, QLatin1Char(' ')));
+    }
+
+    _markDirty(row);
+}
+
+void
+MavlinkConsoleController::_markDirty(int row)
+{
+    if (row < 0 || row >= _rows.count()) {
+        return;
+    }
+
+    _rows[row].richTextValid = false;
+
+    if (_dirtyFirst == -1) {
+        _dirtyFirst = _dirtyLast = row;
+    } else {
+        _dirtyFirst = qMin(_dirtyFirst, row);
+        _dirtyLast  = qMax(_dirtyLast, row);
+    }
+}
+
+void
+MavlinkConsoleController::_emitDirtyRows(void)
+{
+    if (_dirtyFirst == -1) {
+        return;
+    }
+
+    const int first = _dirtyFirst;
+    const int last  = qMin(_dirtyLast, _rows.count() - 1);
+    _dirtyFirst = _dirtyLast = -1;
+
+    if (first <= last) {
+        emit dataChanged(index(first), index(last), { Qt::DisplayRole, TextRole, RichTextRole });
+    }
+}
+
+void
+MavlinkConsoleController::_reset(void)
+{
+    beginResetModel();
+    _rows.clear();
+    endResetModel();
+
+    delete _utf8Decoder;
+    _utf8Decoder = QTextCodec::codecForName("UTF-8")->makeDecoder();
+
+    _parseState = ParseText;
+    _csiParams.clear();
+    _cursorY = 0;
+    _cursorX = 0;
+    _cursor_home_pos = -1;
+    _dirtyFirst = _dirtyLast = -1;
 }
 
 QString
@@ -242,41 +466,52 @@ MavlinkConsoleController::transformLineForRichText(const QString& line) const
     return ret;
 }
 
-QString
-MavlinkConsoleController::getText() const
+const QString&
+MavlinkConsoleController::_rowRichText(int row) const
 {
-    QString ret;
-    if (rowCount() > 0) {
-        ret = transformLineForRichText(data(index(0), Qt::DisplayRole).toString());
-    }
-    for (int i = 1; i < rowCount(); ++i) {
-        ret += "<br>" + transformLineForRichText(data(index(i), Qt::DisplayRole).toString());
+    const Row_t& r = _rows[row];
+    if (!r.richTextValid) {
+        r.richText = transformLineForRichText(r.text);
+        r.richTextValid = true;
     }
+    return r.richText;
+}
 
-    return ret;
+int
+MavlinkConsoleController::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+
+    return _rows.count();
 }
 
-void
-MavlinkConsoleController::writeLine(int line, const QByteArray &text)
+QVariant
+MavlinkConsoleController::data(const QModelIndex& index, int role) const
 {
-    auto rc = rowCount();
-    if (line >= rc) {
-        insertRows(rc, 1 + line - rc);
+    if (!index.isValid() || index.row() < 0 || index.row() >= _rows.count()) {
+        return QVariant();
     }
-    if (rowCount() > _max_num_lines) {
-        int count = rowCount() - _max_num_lines;
-        removeRows(0, count);
-        line -= count;
-        _cursorY -= count;
-        _cursor_home_pos -= count;
-        if (_cursor_home_pos < 0)
-            _cursor_home_pos = -1;
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return _rows[index.row()].text;
+    case RichTextRole:
+        return _rowRichText(index.row());
+    default:
+        return QVariant();
     }
-    auto idx = index(line);
-    QString updated = data(idx, Qt::DisplayRole).toString();
-    updated.replace(_cursorX, text.size(), text);
-    setData(idx, updated);
-    _cursorX += text.size();
+}
+
+QHash<int, QByteArray>
+MavlinkConsoleController::roleNames(void) const
+{
+    QHash<int, QByteArray> hash;
+
+    hash[TextRole]      = "text";
+    hash[RichTextRole]  = "richText";
+
+    return hash;
 }
 
 void MavlinkConsoleController::CommandHistory::append(const QString& command)
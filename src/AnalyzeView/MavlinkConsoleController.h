@@ -16,13 +16,20 @@
 #include <QObject>
 #include <QString>
 #include <QMetaObject>
-#include <QStringListModel>
+#include <QAbstractListModel>
+#include <QTextDecoder>
 
 // Fordward decls
 class Vehicle;
 
 /// Controller for MavlinkConsole.qml.
-class MavlinkConsoleController : public QStringListModel
+///
+/// The shell output is kept as a terminal screen buffer: one row per line, a cursor which ANSI control sequences
+/// can address and a parser which keeps its state between SERIAL_CONTROL packets. Rows touched by a packet are
+/// tracked and only those are reported through dataChanged once the packet is processed. The rich text for a row
+/// is cached until the row changes. The console page shows the rows through a ListView so only changed rows are
+/// laid out again.
+class MavlinkConsoleController : public QAbstractListModel
 {
     Q_OBJECT
 
@@ -30,6 +37,11 @@ public:
     MavlinkConsoleController();
     virtual ~MavlinkConsoleController();
 
+    enum Roles {
+        TextRole = Qt::UserRole + 1,    ///< Plain text of the row
+        RichTextRole,                   ///< Row formatted for a rich text control
+    };
+
     Q_INVOKABLE void sendCommand(QString command);
 
     Q_INVOKABLE QString historyUp(const QString& current);
@@ -42,20 +54,40 @@ public:
      */
     Q_INVOKABLE QString handleClipboard(const QString& command_pre);
 
-    Q_PROPERTY(QString text                     READ getText                    CONSTANT)
+    /// Copies the plain text of all rows to the clipboard
+    Q_INVOKABLE void copyToClipboard(void) const;
+
+    // Overrides from QAbstractListModel
+    int                     rowCount    (const QModelIndex& parent = QModelIndex()) const override;
+    QVariant                data        (const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray>  roleNames   (void) const override;
+
+    static constexpr int maxNumLines        = 500;  ///< history size (affects CPU load)
+    static constexpr int maxLineWidth       = 1024; ///< Cursor columns are clamped to this
+    static constexpr int maxRowsPastEnd     = 100;  ///< Cursor movement adds at most this many rows at once
 
 private slots:
     void _setActiveVehicle  (Vehicle* vehicle);
     void _receiveData(uint8_t device, uint8_t flags, uint16_t timeout, uint32_t baudrate, QByteArray data);
 
 private:
-    bool _processANSItext(QByteArray &line);
     void _sendSerialData(QByteArray, bool close = false);
-    void writeLine(int line, const QByteArray &text);
 
-    QString transformLineForRichText(const QString& line) const;
+    void _processByte       (char c);
+    void _processCSI        (char command);
+    int  _csiParam          (int index, int defaultValue) const;
+    void _write             (const char* text, int length);
+    void _newLine           (void);
+    void _ensureRow         (int row);
+    void _clampCursor       (void);
+    void _eraseRow          (int row, int from, int to);
+    void _markDirty         (int row);
+    void _emitDirtyRows     (void);
+    void _reset             (void);
+
+    const QString& _rowRichText(int row) const;
 
-    QString getText() const;
+    QString transformLineForRichText(const QString& line) const;
 
     class CommandHistory
     {
@@ -69,12 +101,27 @@ private:
         int _index = 0;
     };
 
-    static constexpr int _max_num_lines = 500; ///< history size (affects CPU load)
-
+    typedef enum {
+        ParseText,      ///< Plain text and single byte control characters
+        ParseEscape,    ///< ESC received
+        ParseCSI,       ///< ESC [ received, collecting parameters up to the final byte
+    } ParseState_t;
+
+    typedef struct {
+        QString         text;
+        mutable QString richText;
+        mutable bool    richTextValid;
+    } Row_t;
+
+    QList<Row_t>  _rows;
+    ParseState_t  _parseState{ParseText};
+    QTextDecoder* _utf8Decoder{nullptr};    ///< Keeps partial UTF-8 sequences split across packets
+    QByteArray    _csiParams;
     int           _cursor_home_pos{-1};
     int           _cursorY{0};
     int           _cursorX{0};
-    QByteArray    _incoming_buffer;
+    int           _dirtyFirst{-1};
+    int           _dirtyLast{-1};
     Vehicle*      _vehicle{nullptr};
     QList<QMetaObject::Connection> _uas_connections;
     CommandHistory _history;
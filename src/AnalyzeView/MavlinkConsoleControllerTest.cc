@@ -0,0 +1,212 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MavlinkConsoleControllerTest.h"
+#include "MavlinkConsoleController.h"
+#include "QGCApplication.h"
+#include "MockLink.h"
+
+#include <QElapsedTimer>
+
+void MavlinkConsoleControllerTest::init(void)
+{
+    UnitTest::init();
+
+    _connectMockLinkNoInitialConnectSequence();
+
+    _cReceived = 0;
+    connect(_vehicle, &Vehicle::mavlinkSerialControl, this, [this](uint8_t, uint8_t, uint16_t, uint32_t, QByteArray data) {
+        _cReceived += data.size();
+    });
+
+    _controller = new MavlinkConsoleController();
+}
+
+void MavlinkConsoleControllerTest::cleanup(void)
+{
+    delete _controller;
+    _controller = nullptr;
+
+    _disconnectMockLink();
+
+    UnitTest::cleanup();
+}
+
+/// Sends the data from the vehicle and waits for all of it to be processed
+void MavlinkConsoleControllerTest::_send(const QByteArray& data)
+{
+    const int cExpected = _cReceived + data.size();
+
+    _mockLink->sendShellOutput(data);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (_cReceived < cExpected && timer.elapsed() < 10000) {
+        QTest::qWait(1);
+    }
+    QCOMPARE(_cReceived, cExpected);
+}
+
+QStringList MavlinkConsoleControllerTest::_rows(void) const
+{
+    QStringList rows;
+    for (int i=0; i<_controller->rowCount(); i++) {
+        rows.append(_controller->data(_controller->index(i), MavlinkConsoleController::TextRole).toString());
+    }
+    return rows;
+}
+
+void MavlinkConsoleControllerTest::_textTest(void)
+{
+    _send("nsh> ls\r\nfoo\tbar\nWARN low battery\nabc\bX\n");
+
+    QCOMPARE(_rows(), QStringList({ "nsh> ls", "foo\tbar", "WARN low battery", "abX", "" }));
+
+    const QString richText = _controller->data(_controller->index(2), MavlinkConsoleController::RichTextRole).toString();
+    QVERIFY(richText.startsWith("<font color="));
+    QVERIFY(richText.endsWith("low&nbsp;battery"));
+}
+
+void MavlinkConsoleControllerTest::_cursorTest(void)
+{
+    // First ESC[H sets home at the current row, subsequent ones rewind to it
+    _send("line0\n\x1B[HAAAA\nBBBB\nCCCC\n");
+    QCOMPARE(_rows(), QStringList({ "line0", "AAAA", "BBBB", "CCCC", "" }));
+
+    // Rewind, clear the screen and draw a shorter one
+    _send("\x1B[H\x1B[2JDD\n");
+    QCOMPARE(_rows(), QStringList({ "line0", "DD", "", "", "" }));
+
+    // Cursor addressing, erase to end of line and erase whole line
+    _send("\x1B[3;3HX\x1B[1;1H12345\x1B[1;3H\x1B[K\x1B[4;1Hzz\x1B[2K");
+    QCOMPARE(_rows(), QStringList({ "line0", "12", "", "  X", "" }));
+
+    // Cursor movement relative to the current position, text attributes are dropped
+    _send("\x1B[2;1H\x1B[32mab\x1B[0m\x1B[2Dc\x1B[B\x1B[3Cd");
+    QCOMPARE(_rows(), QStringList({ "line0", "12", "cb", "  X d", "" }));
+
+    // Home is forgotten once a command is sent
+    _controller->sendCommand("top");
+    _send("\x1B[5;1Hnew home");
+    QCOMPARE(_rows().last(), QStringLiteral("new home"));
+}
+
+void MavlinkConsoleControllerTest::_fragmentedTest(void)
+{
+    // Every byte arrives in its own message, escape sequences are split at every position
+    const QByteArray data("prompt\n\x1B[Hfirst\nsecond\n\x1B[H\x1B[2J\x1B[2;4Hxy\x1B[1;1Habc\x1B[K\n");
+    for (char c : data) {
+        _send(QByteArray(1, c));
+    }
+
+    QCOMPARE(_rows(), QStringList({ "prompt", "abc", "   xy", "" }));
+}
+
+void MavlinkConsoleControllerTest::_utf8SplitTest(void)
+{
+    // Multi byte characters split across messages must not be replaced
+    const QByteArray data = QStringLiteral("temp 25\u00B0C \u2713\n").toUtf8();
+    for (char c : data) {
+        _send(QByteArray(1, c));
+    }
+
+    QCOMPARE(_rows(), QStringList({ QStringLiteral("temp 25\u00B0C \u2713"), "" }));
+}
+
+void MavlinkConsoleControllerTest::_largeCursorTest(void)
+{
+    // Cursor parameters from the vehicle must not grow the buffer or a line without bound
+    _send("prompt\n\x1B[H\x1B[999999999;999999999Hx\x1B[99999999999B\x1B[999999999Cy\x1B[999999999Gz\n");
+
+    QVERIFY(_controller->rowCount() <= MavlinkConsoleController::maxNumLines);
+    for (const QString& row : _rows()) {
+        QVERIFY(row.length() <= MavlinkConsoleController::maxLineWidth);
+    }
+    QVERIFY(_rows().filter("z").count() == 1);
+}
+
+void MavlinkConsoleControllerTest::_dirtyRowsTest(void)
+{
+    _send("header\n\x1B[Hrow1\nrow2\nrow3\nrow4\n");
+
+    QSignalSpy spyDataChanged(_controller, &QAbstractItemModel::dataChanged);
+    QSignalSpy spyRowsInserted(_controller, &QAbstractItemModel::rowsInserted);
+
+    // A single row rewritten through cursor addressing is the only change reported
+    _send("\x1B[3;1H\x1B[Krow3 updated");
+    QCOMPARE(spyDataChanged.count(), 1);
+    QCOMPARE(spyDataChanged[0][0].toModelIndex().row(), 3);
+    QCOMPARE(spyDataChanged[0][1].toModelIndex().row(), 3);
+    QCOMPARE(spyRowsInserted.count(), 0);
+
+    // Rows changed by one message are reported as a single range
+    spyDataChanged.clear();
+    _send("\x1B[1;1Hx\x1B[2;1Hy");
+    QCOMPARE(spyDataChanged.count(), 1);
+    QCOMPARE(spyDataChanged[0][0].toModelIndex().row(), 1);
+    QCOMPARE(spyDataChanged[0][1].toModelIndex().row(), 2);
+}
+
+/// Simulates the output of a chatty NSH session: top refreshing its screen in place followed by a dmesg flood
+void MavlinkConsoleControllerTest::_stressTest(void)
+{
+    const int cScreens          = 200;
+    const int cScreenRows       = 40;
+    const int cDmesgLines       = 5 * MavlinkConsoleController::maxNumLines;
+
+    _controller->sendCommand("top");
+    _send("nsh> top\n");
+
+    const int homeRow = _controller->rowCount() - 1;
+    int cFarRows = 0;
+
+    connect(_controller, &QAbstractItemModel::dataChanged, this, [&](const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+        if (topLeft.row() < homeRow || bottomRight.row() >= homeRow + cScreenRows + 1) {
+            cFarRows++;
+        }
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int screen=0; screen<cScreens; screen++) {
+        QByteArray data("\x1B[H\x1B[2J");
+        data += QStringLiteral("Processes: %1 total, %2 running\n").arg(30 + (screen % 7)).arg(screen % 5).toUtf8();
+        for (int row=1; row<cScreenRows; row++) {
+            data += QStringLiteral(" PID COMMAND                   CPU(ms) CPU(%)  USED/STACK PRIO(BASE) STATE %1 %2\n").arg(row).arg(screen).toUtf8();
+        }
+        _send(data);
+    }
+    const qint64 topMsecs = timer.restart();
+
+    QCOMPARE(cFarRows, 0);
+    QCOMPARE(_controller->rowCount(), homeRow + cScreenRows + 1);
+    QCOMPARE(_rows()[homeRow + 1], QStringLiteral(" PID COMMAND                   CPU(ms) CPU(%)  USED/STACK PRIO(BASE) STATE 1 %1").arg(cScreens - 1));
+
+    QByteArray dmesg;
+    for (int line=0; line<cDmesgLines; line++) {
+        dmesg += QStringLiteral("[%1] sensors: mag #0 timeout, resetting\n").arg(line).toUtf8();
+    }
+    _send(dmesg);
+    const qint64 dmesgMsecs = timer.elapsed();
+
+    // History is capped and the last lines are kept
+    QCOMPARE(_controller->rowCount(), MavlinkConsoleController::maxNumLines);
+    QCOMPARE(_rows()[MavlinkConsoleController::maxNumLines - 2], QStringLiteral("[%1] sensors: mag #0 timeout, resetting").arg(cDmesgLines - 1));
+
+    // Rich text of every row, as the console view builds it when first shown
+    QElapsedTimer textTimer;
+    textTimer.start();
+    for (int i=0; i<_controller->rowCount(); i++) {
+        _controller->data(_controller->index(i), MavlinkConsoleController::RichTextRole).toString();
+    }
+    const qint64 textUsecs = textTimer.nsecsElapsed() / 1000;
+
+    qDebug() << "top:" << cScreens << "screens in" << topMsecs << "msecs, dmesg:" << cDmesgLines << "lines in" << dmesgMsecs << "msecs, rich text of" << _controller->rowCount() << "rows in" << textUsecs << "usecs";
+}
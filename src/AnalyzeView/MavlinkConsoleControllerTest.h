@@ -0,0 +1,39 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MavlinkConsoleController;
+
+/// Tests the MavlinkConsoleController screen buffer with shell output sent as SERIAL_CONTROL messages by MockLink
+class MavlinkConsoleControllerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init               (void);
+    void cleanup            (void);
+
+    void _textTest          (void);
+    void _cursorTest        (void);
+    void _fragmentedTest    (void);
+    void _utf8SplitTest     (void);
+    void _largeCursorTest   (void);
+    void _dirtyRowsTest     (void);
+    void _stressTest        (void);
+
+private:
+    void        _send   (const QByteArray& data);
+    QStringList _rows   (void) const;
+
+    MavlinkConsoleController*   _controller     = nullptr;
+    int                         _cReceived      = 0;
+};
@@ -12,11 +12,15 @@
 #include "AutoPilotPlugin.h"
 #include "ParameterManager.h"
 
+#include <QtMath>
+
+#include <Eigen/Eigen>
+
 QGC_LOGGING_CATEGORY(APMCompassCalLog, "APMCompassCalLog")
 
 const float CalWorkerThread::mag_sphere_radius = 0.2f;
 const unsigned int CalWorkerThread::calibration_sides = 6;
-const unsigned int CalWorkerThread::calibration_total_points = 240;
+const unsigned int CalWorkerThread::calibration_total_points = 600;
 const unsigned int CalWorkerThread::calibraton_duration_seconds = CalWorkerThread::calibration_sides * 10;
 
 const char* CalWorkerThread::rgCompassParams[3][4] = {
@@ -25,6 +29,12 @@ const char* CalWorkerThread::rgCompassParams[3][4] = {
     { "COMPASS_OFS3_X", "COMPASS_OFS3_Y", "COMPASS_OFS3_Z", "COMPASS_DEV_ID3" },
 };
 
+const char* CalWorkerThread::rgSoftIronParams[3][6] = {
+    { "COMPASS_DIA_X",  "COMPASS_DIA_Y",    "COMPASS_DIA_Z",    "COMPASS_ODI_X",    "COMPASS_ODI_Y",    "COMPASS_ODI_Z" },
+    { "COMPASS_DIA2_X", "COMPASS_DIA2_Y",   "COMPASS_DIA2_Z",   "COMPASS_ODI2_X",   "COMPASS_ODI2_Y",   "COMPASS_ODI2_Z" },
+    { "COMPASS_DIA3_X", "COMPASS_DIA3_Y",   "COMPASS_DIA3_Z",   "COMPASS_ODI3_X",   "COMPASS_ODI3_Y",   "COMPASS_ODI3_Z" },
+};
+
 CalWorkerThread::CalWorkerThread(Vehicle* vehicle, QObject* parent)
     : QThread(parent)
     , _vehicle(vehicle)
@@ -105,10 +115,14 @@ CalWorkerThread::calibrate_return CalWorkerThread::calibrate(void)
     float sphere_y[max_mags];
     float sphere_z[max_mags];
     float sphere_radius[max_mags];
+    bool  soft_iron_valid[max_mags];
+    float soft_iron_diagonal[max_mags][3];
+    float soft_iron_offdiagonal[max_mags][3];
 
     // Sphere fit the data to get calibration values
     if (result == calibrate_return_ok) {
         for (unsigned cur_mag=0; cur_mag<max_mags; cur_mag++) {
+            soft_iron_valid[cur_mag] = false;
             if (rgCompassAvailable[cur_mag]) {
                 sphere_fit_least_squares(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
                                          worker_data.calibration_counter_total[cur_mag],
@@ -119,7 +133,44 @@ CalWorkerThread::calibrate_return CalWorkerThread::calibrate(void)
                 if (qIsNaN(sphere_x[cur_mag]) || qIsNaN(sphere_y[cur_mag]) || qIsNaN(sphere_z[cur_mag])) {
                     _emitVehicleTextMessage(QStringLiteral("[cal] ERROR: NaN in sphere fit for mag %1").arg(cur_mag));
                     result = calibrate_return_error;
+                    continue;
+                }
+
+                // The ellipsoid fit is only well conditioned if the samples go most of the way around the sphere
+                unsigned coverage = coverage_percentage(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
+                                                        worker_data.calibration_counter_total[cur_mag],
+                                                        sphere_x[cur_mag], sphere_y[cur_mag], sphere_z[cur_mag]);
+                if (coverage < min_ellipsoid_coverage_percentage) {
+                    _emitVehicleTextMessage(QStringLiteral("[cal] mag #%1 coverage %2%, calibrating offsets only").arg(cur_mag).arg(coverage));
+                    continue;
                 }
+
+                float center[3];
+                float radius;
+                if (ellipsoid_fit_least_squares(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
+                                                worker_data.calibration_counter_total[cur_mag],
+                                                center, soft_iron_diagonal[cur_mag], soft_iron_offdiagonal[cur_mag], &radius) != 0) {
+                    _emitVehicleTextMessage(QStringLiteral("[cal] mag #%1 ellipsoid fit failed, calibrating offsets only").arg(cur_mag));
+                    continue;
+                }
+
+                // Same sanity limits the firmware applies to its own soft-iron calibration
+                bool sane = true;
+                for (int i=0; i<3; i++) {
+                    if (soft_iron_diagonal[cur_mag][i] < 0.2f || soft_iron_diagonal[cur_mag][i] > 5.0f || fabsf(soft_iron_offdiagonal[cur_mag][i]) > 1.0f) {
+                        sane = false;
+                    }
+                }
+                if (!sane) {
+                    _emitVehicleTextMessage(QStringLiteral("[cal] mag #%1 soft-iron out of range, calibrating offsets only").arg(cur_mag));
+                    continue;
+                }
+
+                sphere_x[cur_mag] = center[0];
+                sphere_y[cur_mag] = center[1];
+                sphere_z[cur_mag] = center[2];
+                sphere_radius[cur_mag] = radius;
+                soft_iron_valid[cur_mag] = true;
             }
         }
     }
@@ -136,20 +187,19 @@ CalWorkerThread::calibrate_return CalWorkerThread::calibrate(void)
             if (rgCompassAvailable[cur_mag]) {
                 _emitVehicleTextMessage(QStringLiteral("[cal] mag #%1 off: x:%2 y:%3 z:%4").arg(cur_mag).arg(-sphere_x[cur_mag]).arg(-sphere_y[cur_mag]).arg(-sphere_z[cur_mag]));
 
-                float sensorId = 0.0f;
-                if (cur_mag == 0) {
-                    sensorId = 2.0f;
-                } else if (cur_mag == 1) {
-                    sensorId = 5.0f;
-                } else if (cur_mag == 2) {
-                    sensorId = 6.0f;
-                }
-                if (sensorId != 0.0f) {
-                    _vehicle->sendMavCommand(_vehicle->defaultComponentId(),
-                                             MAV_CMD_PREFLIGHT_SET_SENSOR_OFFSETS,
-                                             true, /* showErrors */
-                                             sensorId, -sphere_x[cur_mag], -sphere_y[cur_mag], -sphere_z[cur_mag]);
+                QVector3D diagonal(1, 1, 1);
+                QVector3D offDiagonal(0, 0, 0);
+                if (soft_iron_valid[cur_mag]) {
+                    diagonal    = QVector3D(soft_iron_diagonal[cur_mag][0], soft_iron_diagonal[cur_mag][1], soft_iron_diagonal[cur_mag][2]);
+                    offDiagonal = QVector3D(soft_iron_offdiagonal[cur_mag][0], soft_iron_offdiagonal[cur_mag][1], soft_iron_offdiagonal[cur_mag][2]);
+                    _emitVehicleTextMessage(QStringLiteral("[cal] mag #%1 dia: x:%2 y:%3 z:%4 odi: x:%5 y:%6 z:%7").arg(cur_mag)
+                                            .arg(diagonal.x()).arg(diagonal.y()).arg(diagonal.z())
+                                            .arg(offDiagonal.x()).arg(offDiagonal.y()).arg(offDiagonal.z()));
                 }
+
+                // Parameters and commands must be sent from the gui thread
+                emit compassCalibrated(static_cast<int>(cur_mag), QVector3D(-sphere_x[cur_mag], -sphere_y[cur_mag], -sphere_z[cur_mag]),
+                                       soft_iron_valid[cur_mag], diagonal, offDiagonal);
             }
         }
     }
@@ -161,7 +211,8 @@ CalWorkerThread::calibrate_return CalWorkerThread::mag_calibration_worker(detect
 {
     calibrate_return result = calibrate_return_ok;
 
-    unsigned int calibration_counter_side;
+    unsigned int calibration_counter_side[max_mags];
+    unsigned int last_progress = 0;
 
     mag_worker_data_t* worker_data = (mag_worker_data_t*)(data);
 
@@ -170,38 +221,59 @@ CalWorkerThread::calibrate_return CalWorkerThread::mag_calibration_worker(detect
 
     uint64_t calibration_deadline = QGC::groundTimeUsecs() + worker_data->calibration_interval_perside_useconds;
 
-    unsigned int loop_interval_usecs = (worker_data->calibration_interval_perside_seconds * 1000000) / worker_data->calibration_points_perside;
+    for (size_t cur_mag=0; cur_mag<max_mags; cur_mag++) {
+        calibration_counter_side[cur_mag] = 0;
+    }
 
-    calibration_counter_side = 0;
+    // Samples which arrived while waiting for the orientation belong to some other side
+    sampleQueue.clear();
+    uint32_t dropped_at_start = sampleQueue.dropped();
 
-    while (QGC::groundTimeUsecs() < calibration_deadline && calibration_counter_side < worker_data->calibration_points_perside) {
+    while (QGC::groundTimeUsecs() < calibration_deadline) {
         if (_cancel) {
             result = calibrate_return_cancelled;
             break;
         }
 
-        for (size_t cur_mag=0; cur_mag<max_mags; cur_mag++) {
-            if (!rgCompassAvailable[cur_mag]) {
+        // Record every sample which arrived since the last pass
+        CompassSampleQueue::Sample_t sample;
+        while (sampleQueue.pop(sample)) {
+            unsigned cur_mag = sample.compass;
+            if (cur_mag >= max_mags || !rgCompassAvailable[cur_mag] || calibration_counter_side[cur_mag] >= worker_data->calibration_points_perside) {
                 continue;
             }
 
-            lastScaledImuMutex.lock();
-            mavlink_scaled_imu_t copyLastScaledImu = rgLastScaledImu[cur_mag];
-            lastScaledImuMutex.unlock();
-
-            worker_data->x[cur_mag][worker_data->calibration_counter_total[cur_mag]] = copyLastScaledImu.xmag;
-            worker_data->y[cur_mag][worker_data->calibration_counter_total[cur_mag]] = copyLastScaledImu.ymag;
-            worker_data->z[cur_mag][worker_data->calibration_counter_total[cur_mag]] = copyLastScaledImu.zmag;
+            worker_data->x[cur_mag][worker_data->calibration_counter_total[cur_mag]] = sample.x;
+            worker_data->y[cur_mag][worker_data->calibration_counter_total[cur_mag]] = sample.y;
+            worker_data->z[cur_mag][worker_data->calibration_counter_total[cur_mag]] = sample.z;
             worker_data->calibration_counter_total[cur_mag]++;
+            calibration_counter_side[cur_mag]++;
         }
 
-        calibration_counter_side++;
+        // Side is complete once the slowest compass has all its points
+        unsigned int min_counter_side = worker_data->calibration_points_perside;
+        for (size_t cur_mag=0; cur_mag<max_mags; cur_mag++) {
+            if (rgCompassAvailable[cur_mag]) {
+                min_counter_side = qMin(min_counter_side, calibration_counter_side[cur_mag]);
+            }
+        }
 
         // Progress indicator for side
-        _emitVehicleTextMessage(QStringLiteral("[cal] %1 side calibration: progress <%2>").arg(detect_orientation_str(orientation)).arg(progress_percentage(worker_data) +
-                                                                                                                                        (unsigned)((100 / calibration_sides) * ((float)calibration_counter_side / (float)worker_data->calibration_points_perside))));
+        unsigned progress = progress_percentage(worker_data) + (unsigned)((100 / calibration_sides) * ((float)min_counter_side / (float)worker_data->calibration_points_perside));
+        if (progress != last_progress) {
+            last_progress = progress;
+            _emitVehicleTextMessage(QStringLiteral("[cal] %1 side calibration: progress <%2>").arg(detect_orientation_str(orientation)).arg(progress));
+        }
+
+        if (min_counter_side >= worker_data->calibration_points_perside) {
+            break;
+        }
+
+        usleep(20000);
+    }
 
-        usleep(loop_interval_usecs);
+    if (sampleQueue.dropped() != dropped_at_start) {
+        qCWarning(APMCompassCalLog) << "Samples dropped during side" << sampleQueue.dropped() - dropped_at_start;
     }
 
     if (result == calibrate_return_ok) {
@@ -209,6 +281,8 @@ CalWorkerThread::calibrate_return CalWorkerThread::mag_calibration_worker(detect
 
         worker_data->done_count++;
         _emitVehicleTextMessage(QStringLiteral("[cal] progress <%1>").arg(progress_percentage(worker_data)));
+
+        report_coverage(worker_data);
     }
 
     return result;
@@ -291,6 +365,27 @@ CalWorkerThread::calibrate_return CalWorkerThread::calibrate_from_orientation(
     return result;
 }
 
+void CalWorkerThread::report_coverage(mag_worker_data_t* worker_data)
+{
+    for (unsigned cur_mag=0; cur_mag<max_mags; cur_mag++) {
+        if (!rgCompassAvailable[cur_mag] || worker_data->calibration_counter_total[cur_mag] == 0) {
+            continue;
+        }
+
+        float sphere_x, sphere_y, sphere_z, sphere_radius;
+        sphere_fit_least_squares(worker_data->x[cur_mag], worker_data->y[cur_mag], worker_data->z[cur_mag],
+                                 worker_data->calibration_counter_total[cur_mag],
+                                 100, 0.0f,
+                                 &sphere_x, &sphere_y, &sphere_z, &sphere_radius);
+        if (!qIsNaN(sphere_x) && !qIsNaN(sphere_y) && !qIsNaN(sphere_z)) {
+            unsigned coverage = coverage_percentage(worker_data->x[cur_mag], worker_data->y[cur_mag], worker_data->z[cur_mag],
+                                                    worker_data->calibration_counter_total[cur_mag],
+                                                    sphere_x, sphere_y, sphere_z);
+            _emitVehicleTextMessage(QStringLiteral("[cal] mag #%1 coverage %2%").arg(cur_mag).arg(coverage));
+        }
+    }
+}
+
 enum CalWorkerThread::detect_orientation_return CalWorkerThread::detect_orientation(void)
 {
     bool    stillDetected = false;
@@ -301,9 +396,9 @@ enum CalWorkerThread::detect_orientation_return CalWorkerThread::detect_orientat
     int16_t lastZ = 0;
 
     while (true) {
-        lastScaledImuMutex.lock();
+        lastRawImuMutex.lock();
         mavlink_raw_imu_t   copyLastRawImu = lastRawImu;
-        lastScaledImuMutex.unlock();
+        lastRawImuMutex.unlock();
 
         int16_t xDelta = abs(lastX - copyLastRawImu.xacc);
         int16_t yDelta = abs(lastY - copyLastRawImu.yacc);
@@ -560,10 +655,114 @@ int CalWorkerThread::sphere_fit_least_squares(const float x[], const float y[],
     return 0;
 }
 
+int CalWorkerThread::ellipsoid_fit_least_squares(const float x[], const float y[], const float z[], unsigned int size,
+                                                 float center[3], float diagonal[3], float offdiagonal[3], float *radius)
+{
+    if (size < 9) {
+        return 1;
+    }
+
+    // Normal equations for D v = 1 with rows [ x^2, y^2, z^2, 2xy, 2xz, 2yz, 2x, 2y, 2z ]
+    Eigen::Matrix<double, 9, 9> DtD = Eigen::Matrix<double, 9, 9>::Zero();
+    Eigen::Matrix<double, 9, 1> Dt1 = Eigen::Matrix<double, 9, 1>::Zero();
+    Eigen::Matrix<double, 9, 1> row;
+
+    for (unsigned int i = 0; i < size; i++) {
+        double px = x[i];
+        double py = y[i];
+        double pz = z[i];
+
+        row << px * px, py * py, pz * pz, 2 * px * py, 2 * px * pz, 2 * py * pz, 2 * px, 2 * py, 2 * pz;
+        DtD.selfadjointView<Eigen::Lower>().rankUpdate(row);
+        Dt1 += row;
+    }
+
+    // LDLT only reads the lower triangle filled in above
+    Eigen::LDLT<Eigen::Matrix<double, 9, 9>> ldlt(DtD);
+    Eigen::Matrix<double, 9, 1> v = ldlt.solve(Dt1);
+    if (ldlt.info() != Eigen::Success || !v.allFinite()) {
+        return 1;
+    }
+
+    Eigen::Matrix3d A;
+    A << v(0), v(3), v(4),
+         v(3), v(1), v(5),
+         v(4), v(5), v(2);
+    Eigen::Vector3d b(v(6), v(7), v(8));
+
+    // Moving the origin to the center c = -A^-1 b gives u'Au = 1 + c'Ac
+    Eigen::Vector3d c = -A.ldlt().solve(b);
+    double k = 1.0 + c.dot(A * c);
+    if (!c.allFinite() || k <= 0) {
+        return 1;
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver(A / k);
+    if (eigenSolver.info() != Eigen::Success || eigenSolver.eigenvalues().minCoeff() <= 0) {
+        // Not an ellipsoid
+        return 1;
+    }
+
+    // W = M^1/2 maps the ellipsoid onto the unit sphere, scale it to a unit determinant
+    Eigen::Vector3d sqrtEigenvalues = eigenSolver.eigenvalues().cwiseSqrt();
+    Eigen::Matrix3d W = eigenSolver.eigenvectors() * sqrtEigenvalues.asDiagonal() * eigenSolver.eigenvectors().transpose();
+    double scale = cbrt(sqrtEigenvalues.prod());
+    W /= scale;
+
+    center[0]       = static_cast<float>(c(0));
+    center[1]       = static_cast<float>(c(1));
+    center[2]       = static_cast<float>(c(2));
+    diagonal[0]     = static_cast<float>(W(0, 0));
+    diagonal[1]     = static_cast<float>(W(1, 1));
+    diagonal[2]     = static_cast<float>(W(2, 2));
+    offdiagonal[0]  = static_cast<float>(W(0, 1));
+    offdiagonal[1]  = static_cast<float>(W(0, 2));
+    offdiagonal[2]  = static_cast<float>(W(1, 2));
+    *radius         = static_cast<float>(1.0 / scale);
+
+    return 0;
+}
+
+unsigned CalWorkerThread::coverage_percentage(const float x[], const float y[], const float z[], unsigned int size,
+                                              float center_x, float center_y, float center_z)
+{
+    static const unsigned bands     = 4;
+    static const unsigned sectors   = coverage_cells / bands;
+
+    bool     rgCovered[coverage_cells] = { };
+    unsigned covered = 0;
+
+    for (unsigned int i = 0; i < size; i++) {
+        float dx = x[i] - center_x;
+        float dy = y[i] - center_y;
+        float dz = z[i] - center_z;
+        float length = sqrtf(dx * dx + dy * dy + dz * dz);
+        if (length < FLT_EPSILON) {
+            continue;
+        }
+
+        // Bands of equal height on the unit sphere have equal area
+        unsigned band   = qMin(bands - 1, static_cast<unsigned>(((dz / length) + 1.0f) * 0.5f * bands));
+        float    angle  = atan2f(dy, dx) + static_cast<float>(M_PI);
+        unsigned sector = qMin(sectors - 1, static_cast<unsigned>(angle / (2.0f * static_cast<float>(M_PI)) * sectors));
+        unsigned cell   = band * sectors + sector;
+
+        if (!rgCovered[cell]) {
+            rgCovered[cell] = true;
+            covered++;
+        }
+    }
+
+    return (100 * covered) / coverage_cells;
+}
+
 APMCompassCal::APMCompassCal(void)
     : _vehicle(nullptr)
     , _calWorkerThread(nullptr)
 {
+    for (int i=0; i<3; i++) {
+        _rgSoftIronAvailable[i] = false;
+    }
 
 }
 
@@ -597,9 +796,25 @@ void APMCompassCal::startCalibration(void)
 
     _calWorkerThread = new CalWorkerThread(_vehicle);
     connect(_calWorkerThread, &CalWorkerThread::vehicleTextMessage, this, &APMCompassCal::vehicleTextMessage);
+    connect(_calWorkerThread, &CalWorkerThread::compassCalibrated,  this, &APMCompassCal::_compassCalibrated);
 
-    // Clear the offset parameters so we get raw data
+    // Clear the offset and soft-iron parameters so we get raw data
     for (int i=0; i<3; i++) {
+        _rgSoftIronAvailable[i] = true;
+        for (int j=0; j<6; j++) {
+            if (!_vehicle->parameterManager()->parameterExists(-1, CalWorkerThread::rgSoftIronParams[i][j])) {
+                _rgSoftIronAvailable[i] = false;
+            }
+        }
+        if (_rgSoftIronAvailable[i]) {
+            for (int j=0; j<6; j++) {
+                Fact* paramFact = _vehicle->parameterManager()->getParameter(-1, CalWorkerThread::rgSoftIronParams[i][j]);
+
+                _rgSavedSoftIron[i][j] = paramFact->rawValue().toFloat();
+                paramFact->setRawValue(j < 3 ? 1.0 : 0.0);
+            }
+        }
+
         _calWorkerThread->rgCompassAvailable[i] = true;
 
         const char* deviceIdParam = CalWorkerThread::rgCompassParams[i][3];
@@ -633,40 +848,86 @@ void APMCompassCal::cancelCalibration(void)
                 _vehicle->parameterManager()->getParameter(-1, offsetParam)-> setRawValue(_rgSavedCompassOffsets[i][j]);
             }
         }
+        if (_rgSoftIronAvailable[i]) {
+            for (int j=0; j<6; j++) {
+                _vehicle->parameterManager()->getParameter(-1, CalWorkerThread::rgSoftIronParams[i][j])->setRawValue(_rgSavedSoftIron[i][j]);
+            }
+        }
     }
 
     // Simulate a cancelled message
     _emitVehicleTextMessage(QStringLiteral("[cal] calibration cancelled"));
 }
 
+void APMCompassCal::_pushMagSample(uint8_t compass, int16_t x, int16_t y, int16_t z)
+{
+    CompassSampleQueue::Sample_t sample;
+
+    sample.compass  = compass;
+    sample.x        = x;
+    sample.y        = y;
+    sample.z        = z;
+    _calWorkerThread->sampleQueue.push(sample);
+}
+
 void APMCompassCal::_handleMavlinkRawImu(mavlink_message_t message)
 {
-    _calWorkerThread->lastScaledImuMutex.lock();
-    mavlink_msg_raw_imu_decode(&message, &_calWorkerThread->lastRawImu);
-    _calWorkerThread->rgLastScaledImu[0].xacc = _calWorkerThread->lastRawImu.xacc;
-    _calWorkerThread->rgLastScaledImu[0].yacc = _calWorkerThread->lastRawImu.yacc;
-    _calWorkerThread->rgLastScaledImu[0].zacc = _calWorkerThread->lastRawImu.zacc;
-    _calWorkerThread->rgLastScaledImu[0].xgyro = _calWorkerThread->lastRawImu.xgyro;
-    _calWorkerThread->rgLastScaledImu[0].ygyro = _calWorkerThread->lastRawImu.ygyro;
-    _calWorkerThread->rgLastScaledImu[0].zgyro = _calWorkerThread->lastRawImu.zgyro;
-    _calWorkerThread->rgLastScaledImu[0].xmag = _calWorkerThread->lastRawImu.xmag;
-    _calWorkerThread->rgLastScaledImu[0].ymag = _calWorkerThread->lastRawImu.ymag;
-    _calWorkerThread->rgLastScaledImu[0].zmag = _calWorkerThread->lastRawImu.zmag;
-    _calWorkerThread->lastScaledImuMutex.unlock();
+    mavlink_raw_imu_t rawImu;
+    mavlink_msg_raw_imu_decode(&message, &rawImu);
+
+    _calWorkerThread->lastRawImuMutex.lock();
+    _calWorkerThread->lastRawImu = rawImu;
+    _calWorkerThread->lastRawImuMutex.unlock();
+
+    _pushMagSample(0, rawImu.xmag, rawImu.ymag, rawImu.zmag);
 }
 
 void APMCompassCal::_handleMavlinkScaledImu2(mavlink_message_t message)
 {
-    _calWorkerThread->lastScaledImuMutex.lock();
-    mavlink_msg_scaled_imu2_decode(&message, (mavlink_scaled_imu2_t*)&_calWorkerThread->rgLastScaledImu[1]);
-    _calWorkerThread->lastScaledImuMutex.unlock();
+    mavlink_scaled_imu2_t scaledImu;
+    mavlink_msg_scaled_imu2_decode(&message, &scaledImu);
+    _pushMagSample(1, scaledImu.xmag, scaledImu.ymag, scaledImu.zmag);
 }
 
 void APMCompassCal::_handleMavlinkScaledImu3(mavlink_message_t message)
 {
-    _calWorkerThread->lastScaledImuMutex.lock();
-    mavlink_msg_scaled_imu3_decode(&message, (mavlink_scaled_imu3_t*)&_calWorkerThread->rgLastScaledImu[2]);
-    _calWorkerThread->lastScaledImuMutex.unlock();
+    mavlink_scaled_imu3_t scaledImu;
+    mavlink_msg_scaled_imu3_decode(&message, &scaledImu);
+    _pushMagSample(2, scaledImu.xmag, scaledImu.ymag, scaledImu.zmag);
+}
+
+void APMCompassCal::_compassCalibrated(int compass, QVector3D offsets, bool softIron, QVector3D diagonal, QVector3D offDiagonal)
+{
+    static const float rgSensorIds[CalWorkerThread::max_mags] = { 2.0f, 5.0f, 6.0f };
+
+    if (compass < 0 || compass >= static_cast<int>(CalWorkerThread::max_mags)) {
+        return;
+    }
+
+    _vehicle->sendMavCommand(_vehicle->defaultComponentId(),
+                             MAV_CMD_PREFLIGHT_SET_SENSOR_OFFSETS,
+                             true, /* showErrors */
+                             rgSensorIds[compass], offsets.x(), offsets.y(), offsets.z());
+
+    if (_rgSoftIronAvailable[compass]) {
+        // Put back what the vehicle had if only the offsets were calibrated
+        float rgValues[6];
+        if (softIron) {
+            rgValues[0] = diagonal.x();
+            rgValues[1] = diagonal.y();
+            rgValues[2] = diagonal.z();
+            rgValues[3] = offDiagonal.x();
+            rgValues[4] = offDiagonal.y();
+            rgValues[5] = offDiagonal.z();
+        } else {
+            for (int j=0; j<6; j++) {
+                rgValues[j] = _rgSavedSoftIron[compass][j];
+            }
+        }
+        for (int j=0; j<6; j++) {
+            _vehicle->parameterManager()->getParameter(-1, CalWorkerThread::rgSoftIronParams[compass][j])->setRawValue(rgValues[j]);
+        }
+    }
 }
 
 void APMCompassCal::_setSensorTransmissionSpeed(bool fast)
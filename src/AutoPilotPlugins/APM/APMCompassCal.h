@@ -15,12 +15,68 @@
 #include <QThread>
 #include <QVector3D>
 
+#include <atomic>
+
 #include "QGCLoggingCategory.h"
 #include "QGCMAVLink.h"
 #include "Vehicle.h"
 
 Q_DECLARE_LOGGING_CATEGORY(APMCompassCalLog)
 
+/// Single producer, single consumer lock free queue of magnetometer samples. The mavlink handlers on the gui thread
+/// push every sample and the calibration worker thread drains them, so no sample is lost or recorded twice.
+class CompassSampleQueue
+{
+public:
+    typedef struct {
+        uint8_t compass;
+        float   x;
+        float   y;
+        float   z;
+    } Sample_t;
+
+    static const uint32_t capacity = 1024;  ///< Must be a power of two
+
+    /// Producer side
+    ///     @return false: queue is full, sample was dropped
+    bool push(const Sample_t& sample)
+    {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == capacity) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _samples[head & (capacity - 1)] = sample;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side
+    ///     @return false: queue is empty
+    bool pop(Sample_t& sample)
+    {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        sample = _samples[tail & (capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side: throws away all queued samples
+    void clear(void) { _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release); }
+
+    uint32_t count  (void) const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+    uint32_t dropped(void) const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    Sample_t                _samples[capacity];
+    std::atomic<uint32_t>   _head       { 0 };
+    std::atomic<uint32_t>   _tail       { 0 };
+    std::atomic<uint32_t>   _dropped    { 0 };
+};
+
 class CalWorkerThread : public QThread
 {
     Q_OBJECT
@@ -37,15 +93,74 @@ public:
     static const unsigned max_mags = 3;
 
     bool                    rgCompassAvailable[max_mags];
-    QMutex                  lastScaledImuMutex;
-    mavlink_raw_imu_t       lastRawImu;
-    mavlink_scaled_imu_t    rgLastScaledImu[max_mags];
+    QMutex                  lastRawImuMutex;
+    mavlink_raw_imu_t       lastRawImu;             ///< Accelerometer values are used for orientation detection
+    CompassSampleQueue      sampleQueue;            ///< Every magnetometer sample received
 
     static const char*      rgCompassParams[3][4];
+    static const char*      rgSoftIronParams[3][6]; ///< DIA_X, DIA_Y, DIA_Z, ODI_X, ODI_Y, ODI_Z
+
+    /**
+     * Least-squares fit of a sphere to a set of points.
+     *
+     * Fits a sphere to a set of points on the sphere surface.
+     *
+     * @param x point coordinates on the X axis
+     * @param y point coordinates on the Y axis
+     * @param z point coordinates on the Z axis
+     * @param size number of points
+     * @param max_iterations abort if maximum number of iterations have been reached. If unsure, set to 100.
+     * @param delta abort if error is below delta. If unsure, set to 0 to run max_iterations times.
+     * @param sphere_x coordinate of the sphere center on the X axis
+     * @param sphere_y coordinate of the sphere center on the Y axis
+     * @param sphere_z coordinate of the sphere center on the Z axis
+     * @param sphere_radius sphere radius
+     *
+     * @return 0 on success, 1 on failure
+     */
+    static int sphere_fit_least_squares(const float x[], const float y[], const float z[],
+                     unsigned int size, unsigned int max_iterations, float delta, float *sphere_x, float *sphere_y, float *sphere_z,
+                     float *sphere_radius);
+
+    /**
+     * Least-squares fit of a general ellipsoid to a set of points.
+     *
+     * Fits x'Ax + 2b'x = 1 and converts the result to the ellipsoid center and the symmetric soft-iron matrix
+     * which maps the ellipsoid back onto a sphere: |soft_iron * (p - center)| == radius. The matrix is scaled
+     * to a determinant of one, so the diagonal is close to one for a mildly distorted field.
+     *
+     * @param x point coordinates on the X axis
+     * @param y point coordinates on the Y axis
+     * @param z point coordinates on the Z axis
+     * @param size number of points, at least 9
+     * @param center ellipsoid center (x, y, z)
+     * @param diagonal soft-iron matrix diagonal (xx, yy, zz)
+     * @param offdiagonal soft-iron matrix off diagonal (xy, xz, yz)
+     * @param radius radius of the corrected sphere
+     *
+     * @return 0 on success, 1 on failure (too few points or the points do not describe an ellipsoid)
+     */
+    static int ellipsoid_fit_least_squares(const float x[], const float y[], const float z[], unsigned int size,
+                                           float center[3], float diagonal[3], float offdiagonal[3], float *radius);
+
+    /**
+     * Percentage of the sphere around the specified center which is covered by the points.
+     *
+     * The sphere is split into 32 equal area cells (4 bands of equal height times 8 sectors).
+     */
+    static unsigned coverage_percentage(const float x[], const float y[], const float z[], unsigned int size,
+                                        float center_x, float center_y, float center_z);
+
+    static const unsigned coverage_cells = 32;
+    static const unsigned min_ellipsoid_coverage_percentage = 75;   ///< Below this only offsets are calibrated
 
 signals:
     void vehicleTextMessage(int vehicleId, int compId, int severity, QString text);
 
+    /// Calibration result for a single compass. Signalled from the worker thread.
+    ///     @param softIron false: Soft-iron values are not valid, only offsets were calibrated
+    void compassCalibrated(int compass, QVector3D offsets, bool softIron, QVector3D diagonal, QVector3D offDiagonal);
+
 private:
     void _emitVehicleTextMessage(const QString& message);
 
@@ -88,28 +203,6 @@ private:
         calibrate_return_cancelled
     };
 
-    /**
-     * Least-squares fit of a sphere to a set of points.
-     *
-     * Fits a sphere to a set of points on the sphere surface.
-     *
-     * @param x point coordinates on the X axis
-     * @param y point coordinates on the Y axis
-     * @param z point coordinates on the Z axis
-     * @param size number of points
-     * @param max_iterations abort if maximum number of iterations have been reached. If unsure, set to 100.
-     * @param delta abort if error is below delta. If unsure, set to 0 to run max_iterations times.
-     * @param sphere_x coordinate of the sphere center on the X axis
-     * @param sphere_y coordinate of the sphere center on the Y axis
-     * @param sphere_z coordinate of the sphere center on the Z axis
-     * @param sphere_radius sphere radius
-     *
-     * @return 0 on success, 1 on failure
-     */
-    int sphere_fit_least_squares(const float x[], const float y[], const float z[],
-                     unsigned int size, unsigned int max_iterations, float delta, float *sphere_x, float *sphere_y, float *sphere_z,
-                     float *sphere_radius);
-
     /// Wait for vehicle to become still and detect it's orientation
     ///	@return Returns detect_orientation_return according to orientation of still vehicle
     enum detect_orientation_return detect_orientation(void);
@@ -127,6 +220,7 @@ private:
     calibrate_return calibrate(void);
     calibrate_return mag_calibration_worker(detect_orientation_return orientation, void* data);
     unsigned progress_percentage(mag_worker_data_t* worker_data);
+    void report_coverage(mag_worker_data_t* worker_data);
 
     Vehicle*    _vehicle;
     bool        _cancel;
@@ -153,15 +247,19 @@ private slots:
     void _handleMavlinkRawImu(mavlink_message_t message);
     void _handleMavlinkScaledImu2(mavlink_message_t message);
     void _handleMavlinkScaledImu3(mavlink_message_t message);
+    void _compassCalibrated(int compass, QVector3D offsets, bool softIron, QVector3D diagonal, QVector3D offDiagonal);
 
 private:
     void _setSensorTransmissionSpeed(bool fast);
     void _stopCalibration(void);
     void _emitVehicleTextMessage(const QString& message);
+    void _pushMagSample(uint8_t compass, int16_t x, int16_t y, int16_t z);
 
     Vehicle*            _vehicle;
     CalWorkerThread*    _calWorkerThread;
     float               _rgSavedCompassOffsets[3][3];
+    float               _rgSavedSoftIron[3][6];
+    bool                _rgSoftIronAvailable[3];
 };
 
 #endif
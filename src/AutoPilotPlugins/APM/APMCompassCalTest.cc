@@ -0,0 +1,203 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "APMCompassCalTest.h"
+#include "APMCompassCal.h"
+
+#include <QElapsedTimer>
+#include <QtConcurrent>
+
+#include <Eigen/Eigen>
+#include <random>
+
+// Distortion applied to the synthetic samples: hard-iron offset and a symmetric soft-iron matrix with unit determinant
+static const float  _fieldRadius    = 450.0f;
+static const float  _noiseStdDev    = 2.0f;
+static const double _rgOffset[3]    = { 120.0, -80.0, 45.0 };
+static const double _rgSoftIron[3][3] = {
+    { 1.10,  0.05, -0.03 },
+    { 0.05,  0.90,  0.02 },
+    { -0.03, 0.02,  1.00 },
+};
+
+static Eigen::Matrix3d _softIron(void)
+{
+    Eigen::Matrix3d softIron;
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<3; j++) {
+            softIron(i, j) = _rgSoftIron[i][j];
+        }
+    }
+    return softIron / cbrt(softIron.determinant());
+}
+
+/// Generates samples on a sphere of _fieldRadius which are then distorted the way a vehicle's magnetic environment does
+void APMCompassCalTest::_generateSamples(int count, bool upperHalfOnly, bool distorted)
+{
+    std::mt19937                            generator(42);
+    std::uniform_real_distribution<double>  uniform(-1.0, 1.0);
+    std::normal_distribution<float>         noise(0.0f, _noiseStdDev);
+
+    Eigen::Matrix3d distortion = distorted ? _softIron().inverse() : Eigen::Matrix3d::Identity();
+    Eigen::Vector3d offset(_rgOffset[0], _rgOffset[1], _rgOffset[2]);
+
+    _x.clear();
+    _y.clear();
+    _z.clear();
+    while (_x.count() < count) {
+        Eigen::Vector3d direction(uniform(generator), uniform(generator), uniform(generator));
+        double length = direction.norm();
+        if (length > 1.0 || length < 0.1 || (upperHalfOnly && direction.z() < 0.1 * length)) {
+            continue;
+        }
+
+        Eigen::Vector3d sample = distortion * (direction * (_fieldRadius / length)) + offset;
+        _x.append(static_cast<float>(sample.x()) + noise(generator));
+        _y.append(static_cast<float>(sample.y()) + noise(generator));
+        _z.append(static_cast<float>(sample.z()) + noise(generator));
+    }
+}
+
+void APMCompassCalTest::_sampleQueueTest(void)
+{
+    CompassSampleQueue  queue;
+    const int           cSamples = 100000;
+
+    // Overflow drops the newest sample and counts it
+    CompassSampleQueue::Sample_t sample = { 0, 0, 0, 0 };
+    for (uint32_t i=0; i<CompassSampleQueue::capacity; i++) {
+        QVERIFY(queue.push(sample));
+    }
+    QVERIFY(!queue.push(sample));
+    QCOMPARE(queue.dropped(), 1u);
+    queue.clear();
+    QCOMPARE(queue.count(), 0u);
+    QVERIFY(!queue.pop(sample));
+
+    // Every sample from the producer thread arrives exactly once and in order
+    QFuture<void> producer = QtConcurrent::run([&queue, cSamples]() {
+        for (int i=0; i<cSamples; i++) {
+            CompassSampleQueue::Sample_t sample = { static_cast<uint8_t>(i % 3), static_cast<float>(i), 0, 0 };
+            while (!queue.push(sample)) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    });
+
+    int next = 0;
+    while (next < cSamples) {
+        if (queue.pop(sample)) {
+            QCOMPARE(sample.compass, static_cast<uint8_t>(next % 3));
+            QCOMPARE(static_cast<int>(sample.x), next);
+            next++;
+        } else {
+            QThread::yieldCurrentThread();
+        }
+    }
+    producer.waitForFinished();
+    QCOMPARE(queue.count(), 0u);
+}
+
+void APMCompassCalTest::_sphereFitTest(void)
+{
+    _generateSamples(600, false /* upperHalfOnly */, false /* distorted */);
+
+    float sphere_x, sphere_y, sphere_z, sphere_radius;
+    QCOMPARE(CalWorkerThread::sphere_fit_least_squares(_x.constData(), _y.constData(), _z.constData(), static_cast<unsigned>(_x.count()),
+                                                       100, 0.0f, &sphere_x, &sphere_y, &sphere_z, &sphere_radius), 0);
+    QVERIFY(qAbs(sphere_x - _rgOffset[0]) < 1.0);
+    QVERIFY(qAbs(sphere_y - _rgOffset[1]) < 1.0);
+    QVERIFY(qAbs(sphere_z - _rgOffset[2]) < 1.0);
+    QVERIFY(qAbs(sphere_radius - _fieldRadius) < 2.0f);
+
+    // Soft-iron of an undistorted field is identity
+    float center[3], diagonal[3], offdiagonal[3], radius;
+    QCOMPARE(CalWorkerThread::ellipsoid_fit_least_squares(_x.constData(), _y.constData(), _z.constData(), static_cast<unsigned>(_x.count()),
+                                                          center, diagonal, offdiagonal, &radius), 0);
+    for (int i=0; i<3; i++) {
+        QVERIFY(qAbs(diagonal[i] - 1.0f) < 0.01f);
+        QVERIFY(qAbs(offdiagonal[i]) < 0.01f);
+    }
+}
+
+void APMCompassCalTest::_ellipsoidFitTest(void)
+{
+    _generateSamples(600, false /* upperHalfOnly */, true /* distorted */);
+
+    float center[3], diagonal[3], offdiagonal[3], radius;
+    QCOMPARE(CalWorkerThread::ellipsoid_fit_least_squares(_x.constData(), _y.constData(), _z.constData(), static_cast<unsigned>(_x.count()),
+                                                          center, diagonal, offdiagonal, &radius), 0);
+
+    Eigen::Matrix3d expected = _softIron();
+    for (int i=0; i<3; i++) {
+        QVERIFY(qAbs(center[i] - _rgOffset[i]) < 1.0);
+    }
+    QVERIFY(qAbs(diagonal[0] - expected(0, 0)) < 0.01);
+    QVERIFY(qAbs(diagonal[1] - expected(1, 1)) < 0.01);
+    QVERIFY(qAbs(diagonal[2] - expected(2, 2)) < 0.01);
+    QVERIFY(qAbs(offdiagonal[0] - expected(0, 1)) < 0.01);
+    QVERIFY(qAbs(offdiagonal[1] - expected(0, 2)) < 0.01);
+    QVERIFY(qAbs(offdiagonal[2] - expected(1, 2)) < 0.01);
+    QVERIFY(qAbs(radius - _fieldRadius) < 2.0f);
+
+    // The sphere fit can only absorb the distortion into a worse offset
+    float sphere_x, sphere_y, sphere_z, sphere_radius;
+    CalWorkerThread::sphere_fit_least_squares(_x.constData(), _y.constData(), _z.constData(), static_cast<unsigned>(_x.count()),
+                                              100, 0.0f, &sphere_x, &sphere_y, &sphere_z, &sphere_radius);
+    double sphereError      = qAbs(sphere_x - _rgOffset[0]) + qAbs(sphere_y - _rgOffset[1]) + qAbs(sphere_z - _rgOffset[2]);
+    double ellipsoidError   = qAbs(center[0] - _rgOffset[0]) + qAbs(center[1] - _rgOffset[1]) + qAbs(center[2] - _rgOffset[2]);
+    qDebug() << "Offset error - sphere:ellipsoid" << sphereError << ellipsoidError;
+    QVERIFY(ellipsoidError < sphereError);
+
+    // Points which are all on a plane are not an ellipsoid
+    QVector<float> flat(_x.count(), 0.0f);
+    QCOMPARE(CalWorkerThread::ellipsoid_fit_least_squares(_x.constData(), _y.constData(), flat.constData(), static_cast<unsigned>(_x.count()),
+                                                          center, diagonal, offdiagonal, &radius), 1);
+    QCOMPARE(CalWorkerThread::ellipsoid_fit_least_squares(_x.constData(), _y.constData(), _z.constData(), 8,
+                                                          center, diagonal, offdiagonal, &radius), 1);
+}
+
+void APMCompassCalTest::_coverageTest(void)
+{
+    _generateSamples(600, false /* upperHalfOnly */, false /* distorted */);
+    QCOMPARE(CalWorkerThread::coverage_percentage(_x.constData(), _y.constData(), _z.constData(), static_cast<unsigned>(_x.count()),
+                                                  _rgOffset[0], _rgOffset[1], _rgOffset[2]), 100u);
+
+    _generateSamples(600, true /* upperHalfOnly */, false /* distorted */);
+    QCOMPARE(CalWorkerThread::coverage_percentage(_x.constData(), _y.constData(), _z.constData(), static_cast<unsigned>(_x.count()),
+                                                  _rgOffset[0], _rgOffset[1], _rgOffset[2]), 50u);
+
+    QCOMPARE(CalWorkerThread::coverage_percentage(_x.constData(), _y.constData(), _z.constData(), 0, 0, 0, 0), 0u);
+}
+
+void APMCompassCalTest::_fitTimeBenchmark(void)
+{
+    const int cFits = 100;
+
+    _generateSamples(600, false /* upperHalfOnly */, true /* distorted */);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i=0; i<cFits; i++) {
+        float sphere_x, sphere_y, sphere_z, sphere_radius;
+        CalWorkerThread::sphere_fit_least_squares(_x.constData(), _y.constData(), _z.constData(), static_cast<unsigned>(_x.count()),
+                                                  100, 0.0f, &sphere_x, &sphere_y, &sphere_z, &sphere_radius);
+    }
+    qint64 sphereNsecs = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i=0; i<cFits; i++) {
+        float center[3], diagonal[3], offdiagonal[3], radius;
+        QCOMPARE(CalWorkerThread::ellipsoid_fit_least_squares(_x.constData(), _y.constData(), _z.constData(), static_cast<unsigned>(_x.count()),
+                                                              center, diagonal, offdiagonal, &radius), 0);
+    }
+    qint64 ellipsoidNsecs = timer.nsecsElapsed();
+
+    qDebug() << "Fit time for" << _x.count() << "samples - sphere(usecs):ellipsoid(usecs)" << (sphereNsecs / cFits) / 1000.0 << (ellipsoidNsecs / cFits) / 1000.0;
+}
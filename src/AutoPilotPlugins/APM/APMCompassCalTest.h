@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QVector>
+
+/// Tests the APMCompassCal sample queue and fits against synthetic magnetometer data with a known distortion
+class APMCompassCalTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _sampleQueueTest   (void);
+    void _sphereFitTest     (void);
+    void _ellipsoidFitTest  (void);
+    void _coverageTest      (void);
+    void _fitTimeBenchmark  (void);
+
+private:
+    void _generateSamples(int count, bool upperHalfOnly, bool distorted);
+
+    QVector<float> _x;
+    QVector<float> _y;
+    QVector<float> _z;
+};
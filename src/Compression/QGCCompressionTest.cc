@@ -0,0 +1,197 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCCompressionTest.h"
+#include "QGCLZMA.h"
+#include "QGCZlib.h"
+#include "JsonHelper.h"
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
+#include "zlib.h"
+
+const char* QGCCompressionTest::_compressedMetaDataResource    = ":MockLink/Parameter.MetaData.json.xz";
+const char* QGCCompressionTest::_metaDataResource              = ":MockLink/Parameter.MetaData.json";
+
+QByteArray QGCCompressionTest::_readResource(const QString& resource)
+{
+    QFile file(resource);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+QByteArray QGCCompressionTest::_gzip(const QByteArray& data)
+{
+    QByteArray  compressed(static_cast<int>(compressBound(static_cast<uLong>(data.size()))) + 64, 0);
+    z_stream    strm;
+
+    memset(&strm, 0, sizeof(strm));
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16+MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return QByteArray();
+    }
+    strm.next_in    = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+    strm.avail_in   = static_cast<uInt>(data.size());
+    strm.next_out   = reinterpret_cast<Bytef*>(compressed.data());
+    strm.avail_out  = static_cast<uInt>(compressed.size());
+    int ret = deflate(&strm, Z_FINISH);
+    compressed.resize(static_cast<int>(strm.total_out));
+    deflateEnd(&strm);
+
+    return ret == Z_STREAM_END ? compressed : QByteArray();
+}
+
+void QGCCompressionTest::_lzmaInflateTest(void)
+{
+    QByteArray compressed   = _readResource(_compressedMetaDataResource);
+    QByteArray expected     = _readResource(_metaDataResource);
+    QVERIFY(!compressed.isEmpty());
+    QVERIFY(!expected.isEmpty());
+
+    // Memory to memory
+    QByteArray decompressed;
+    QVERIFY(QGCLZMA::inflateLZMA(compressed, decompressed));
+    QCOMPARE(decompressed, expected);
+
+    // Device to device
+    QBuffer input(&compressed);
+    QByteArray outputBytes;
+    QBuffer output(&outputBytes);
+    input.open(QIODevice::ReadOnly);
+    output.open(QIODevice::WriteOnly);
+    QVERIFY(QGCLZMA::inflateLZMA(&input, &output));
+    QCOMPARE(outputBytes, expected);
+
+    // File to file
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QString compressedFileName  = tempDir.filePath("metadata.json.xz");
+    QString jsonFileName        = tempDir.filePath("metadata.json");
+    QFile compressedFile(compressedFileName);
+    QVERIFY(compressedFile.open(QIODevice::WriteOnly));
+    compressedFile.write(compressed);
+    compressedFile.close();
+    QVERIFY(QGCLZMA::inflateLZMAFile(compressedFileName, jsonFileName));
+    QCOMPARE(_readResource(jsonFileName), expected);
+}
+
+void QGCCompressionTest::_lzmaChunkedTest(void)
+{
+    QByteArray compressed   = _readResource(_compressedMetaDataResource);
+    QByteArray expected     = _readResource(_metaDataResource);
+
+    // 239 is the size of a MAVLink FTP data payload
+    for (int chunkSize: { 1, 7, 239, 4096 }) {
+        QGCLZMAInflater inflater;
+        QByteArray      decompressed;
+
+        for (int offset=0; offset<compressed.size(); offset+=chunkSize) {
+            QVERIFY(!inflater.finished());
+            QVERIFY(inflater.addData(compressed.constData() + offset, qMin(chunkSize, compressed.size() - offset)));
+            decompressed.append(inflater.takeOutput());
+        }
+
+        QVERIFY(inflater.finished());
+        QVERIFY(!inflater.hasError());
+        QCOMPARE(decompressed, expected);
+    }
+}
+
+void QGCCompressionTest::_lzmaCorruptTest(void)
+{
+    QByteArray compressed = _readResource(_compressedMetaDataResource);
+    QByteArray decompressed;
+
+    // Truncated stream
+    QVERIFY(!QGCLZMA::inflateLZMA(compressed.left(compressed.size() / 2), decompressed));
+
+    // Corrupt data
+    QByteArray corrupt = compressed;
+    corrupt[corrupt.size() / 2] = corrupt[corrupt.size() / 2] ^ 0x55;
+    QVERIFY(!QGCLZMA::inflateLZMA(corrupt, decompressed));
+
+    // Not xz at all
+    QGCLZMAInflater inflater;
+    QVERIFY(!inflater.addData(_readResource(_metaDataResource)));
+    QVERIFY(inflater.hasError());
+    QVERIFY(!inflater.errorString().isEmpty());
+}
+
+void QGCCompressionTest::_gzipInflateTest(void)
+{
+    QByteArray expected     = _readResource(_metaDataResource);
+    QByteArray compressed   = _gzip(expected);
+    QVERIFY(!compressed.isEmpty());
+
+    QByteArray decompressed;
+    QVERIFY(QGCZlib::inflateGzip(compressed, decompressed));
+    QCOMPARE(decompressed, expected);
+
+    for (int chunkSize: { 1, 239, 4096 }) {
+        QGCZlibInflater inflater;
+        QByteArray      chunkedDecompressed;
+
+        for (int offset=0; offset<compressed.size(); offset+=chunkSize) {
+            QVERIFY(inflater.addData(compressed.mid(offset, chunkSize)));
+            chunkedDecompressed.append(inflater.takeOutput());
+        }
+
+        QVERIFY(inflater.finished());
+        QCOMPARE(chunkedDecompressed, expected);
+    }
+
+    QVERIFY(!QGCZlib::inflateGzip(compressed.left(compressed.size() / 2), decompressed));
+}
+
+/// Compares the old metadata path (inflate to a temp file then parse the file) with inflating straight into the json parser
+void QGCCompressionTest::_metaDataBenchmark(void)
+{
+    const int       cIterations = 20;
+    QByteArray      compressed  = _readResource(_compressedMetaDataResource);
+    QTemporaryDir   tempDir;
+
+    QVERIFY(tempDir.isValid());
+    QString compressedFileName  = tempDir.filePath("parameter.json.xz");
+    QString jsonFileName        = tempDir.filePath("parameter.json");
+    QFile compressedFile(compressedFileName);
+    QVERIFY(compressedFile.open(QIODevice::WriteOnly));
+    compressedFile.write(compressed);
+    compressedFile.close();
+
+    QElapsedTimer   timer;
+    QString         errorString;
+
+    timer.start();
+    for (int i=0; i<cIterations; i++) {
+        QJsonDocument jsonDoc;
+        QVERIFY(QGCLZMA::inflateLZMAFile(compressedFileName, jsonFileName));
+        QVERIFY(JsonHelper::isJsonFile(jsonFileName, jsonDoc, errorString));
+    }
+    qint64 fileNSecs = timer.nsecsElapsed();
+
+    timer.start();
+    for (int i=0; i<cIterations; i++) {
+        QJsonDocument   jsonDoc;
+        QByteArray      jsonBytes;
+        QFile           file(compressedFileName);
+        QBuffer         jsonBuffer(&jsonBytes);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        jsonBuffer.open(QIODevice::WriteOnly);
+        QVERIFY(QGCLZMA::inflateLZMA(&file, &jsonBuffer));
+        QVERIFY(JsonHelper::isJsonFile(jsonBytes, jsonDoc, errorString));
+    }
+    qint64 memoryNSecs = timer.nsecsElapsed();
+
+    qDebug() << QStringLiteral("Parameter metadata inflate+parse: via temp file %1 ms, in memory %2 ms (%3 iterations)")
+                .arg(fileNSecs / 1000000.0, 0, 'f', 2).arg(memoryNSecs / 1000000.0, 0, 'f', 2).arg(cIterations);
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Tests streaming decompression in QGCLZMA and QGCZlib
+class QGCCompressionTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _lzmaInflateTest       (void);
+    void _lzmaChunkedTest       (void);
+    void _lzmaCorruptTest       (void);
+    void _gzipInflateTest       (void);
+    void _metaDataBenchmark     (void);
+
+private:
+    QByteArray _readResource(const QString& resource);
+    QByteArray _gzip        (const QByteArray& data);
+
+    static const char* _compressedMetaDataResource;
+    static const char* _metaDataResource;
+};
@@ -29,99 +29,143 @@ bool QGCLZMA::inflateLZMAFile(const QString& lzmaFilename, const QString& decomp
         return false;
     }
 
+    return inflateLZMA(&inputFile, &outputFile);
+}
+
+bool QGCLZMA::inflateLZMA(QIODevice* input, QIODevice* output)
+{
+    const qint64    cBuffer = 1024 * 16;
+    QGCLZMAInflater inflater;
 
-    // TODO: call once during startup
-    xz_crc32_init();
-    xz_crc64_init();
+    while (!inflater.finished()) {
+        QByteArray chunk = input->read(cBuffer);
+        if (chunk.isEmpty()) {
+            break;
+        }
+        if (!inflater.addData(chunk)) {
+            qWarning() << "QGCLZMA::inflateLZMA:" << inflater.errorString();
+            return false;
+        }
 
+        QByteArray inflated = inflater.takeOutput();
+        if (output->write(inflated) != inflated.size()) {
+            qWarning() << "QGCLZMA::inflateLZMA: output write failed:" << output->errorString();
+            return false;
+        }
+    }
 
-    xz_dec *s = xz_dec_init(XZ_DYNALLOC, (uint32_t)-1);
-    if (s == nullptr) {
-        qWarning() << "QGCLZMA::inflateLZMAFile: Memory allocation failed";
+    if (!inflater.finished()) {
+        qWarning() << "QGCLZMA::inflateLZMA: unexpected end of compressed data";
         return false;
     }
 
-    const int buf_size = 4 * 1024;
-    uint8_t in[buf_size];
-    uint8_t out[buf_size];
+    return true;
+}
 
-    xz_buf b;
-    b.in = in;
-    b.in_pos = 0;
-    b.in_size = 0;
-    b.out = out;
-    b.out_pos = 0;
-    b.out_size = buf_size;
-
-    while (true) {
-        if (b.in_pos == b.in_size) {
-            b.in_size = static_cast<size_t>(inputFile.read((char*)in, sizeof(in)));
-            b.in_pos = 0;
-        }
+bool QGCLZMA::inflateLZMA(const QByteArray& compressed, QByteArray& decompressed)
+{
+    QGCLZMAInflater inflater;
 
-        xz_ret ret = xz_dec_run(s, &b);
+    decompressed.clear();
 
-        if (b.out_pos == sizeof(out)) {
-            size_t cBytesWritten = (size_t)outputFile.write((char*)out, static_cast<int>(b.out_pos));
-            if (cBytesWritten != b.out_pos) {
-                qWarning() << "QGCLZMA::inflateLZMAFile: output file write failed:" << outputFile.fileName() << outputFile.errorString();
-                goto error;
-            }
+    if (!inflater.addData(compressed)) {
+        qWarning() << "QGCLZMA::inflateLZMA:" << inflater.errorString();
+        return false;
+    }
+    if (!inflater.finished()) {
+        qWarning() << "QGCLZMA::inflateLZMA: unexpected end of compressed data";
+        return false;
+    }
 
-            b.out_pos = 0;
-        }
+    decompressed = inflater.takeOutput();
+    return true;
+}
 
-        if (ret == XZ_OK)
-            continue;
+QGCLZMAInflater::QGCLZMAInflater(void)
+{
+    // The crc tables only need to be set up once
+    static const bool crcInitialized = []() {
+        xz_crc32_init();
+        xz_crc64_init();
+        return true;
+    }();
+    Q_UNUSED(crcInitialized)
+
+    _dec = xz_dec_init(XZ_DYNALLOC, (uint32_t)-1);
+    if (_dec == nullptr) {
+        _errorString = QStringLiteral("Memory allocation failed");
+    }
+}
 
-        if (ret == XZ_UNSUPPORTED_CHECK) {
-            qWarning() << "QGCLZMA::inflateLZMAFile: Unsupported check; not verifying file integrity";
-            continue;
-        }
+QGCLZMAInflater::~QGCLZMAInflater()
+{
+    if (_dec) {
+        xz_dec_end(_dec);
+    }
+}
 
-        size_t cBytesWritten = (size_t)outputFile.write((char*)out, static_cast<int>(b.out_pos));
-        if (cBytesWritten != b.out_pos) {
-            qWarning() << "QGCLZMA::inflateLZMAFile: output file write failed:" << outputFile.fileName() << outputFile.errorString();
-            goto error;
-        }
+bool QGCLZMAInflater::addData(const char* data, int size)
+{
+    if (hasError()) {
+        return false;
+    }
+    if (_finished || size <= 0) {
+        return true;
+    }
+
+    xz_buf b;
+    b.in        = reinterpret_cast<const uint8_t*>(data);
+    b.in_pos    = 0;
+    b.in_size   = static_cast<size_t>(size);
+
+    do {
+        // Decompress straight into the output buffer
+        int outputStart = _output.size();
+        _output.resize(outputStart + _outputChunkSize);
+        b.out       = reinterpret_cast<uint8_t*>(_output.data() + outputStart);
+        b.out_pos   = 0;
+        b.out_size  = _outputChunkSize;
+
+        xz_ret ret = xz_dec_run(_dec, &b);
+        _output.resize(outputStart + static_cast<int>(b.out_pos));
 
         switch (ret) {
+        case XZ_OK:
+            break;
+        case XZ_UNSUPPORTED_CHECK:
+            qWarning() << "QGCLZMAInflater: Unsupported check; not verifying file integrity";
+            break;
         case XZ_STREAM_END:
-            xz_dec_end(s);
+            _finished = true;
             return true;
-
         case XZ_MEM_ERROR:
-            qWarning() << "QGCLZMA::inflateLZMAFile: Memory allocation failed";
-            goto error;
-
+            _errorString = QStringLiteral("Memory allocation failed");
+            return false;
         case XZ_MEMLIMIT_ERROR:
-            qWarning() << "QGCLZMA::inflateLZMAFile: Memory usage limit reached";
-            goto error;
-
+            _errorString = QStringLiteral("Memory usage limit reached");
+            return false;
         case XZ_FORMAT_ERROR:
-            qWarning() << "QGCLZMA::inflateLZMAFile: Not a .xz file";
-            goto error;
-
+            _errorString = QStringLiteral("Not a .xz file");
+            return false;
         case XZ_OPTIONS_ERROR:
-            qWarning() << "QGCLZMA::inflateLZMAFile: Unsupported options in the .xz headers";
-            goto error;
-
+            _errorString = QStringLiteral("Unsupported options in the .xz headers");
+            return false;
         case XZ_DATA_ERROR:
         case XZ_BUF_ERROR:
-            qWarning() << "QGCLZMA::inflateLZMAFile: File is corrupt";
-            goto error;
-
+            _errorString = QStringLiteral("File is corrupt");
+            return false;
         default:
-            qWarning() << "QGCLZMA::inflateLZMAFile: Bug!";
-            goto error;
+            _errorString = QStringLiteral("Bug!");
+            return false;
         }
-    }
+    } while (b.in_pos < b.in_size || b.out_pos == b.out_size);
 
-    xz_dec_end(s);
     return true;
+}
 
-error:
-    xz_dec_end(s);
-    return false;
-
+QByteArray QGCLZMAInflater::takeOutput(void)
+{
+    QByteArray output;
+    output.swap(_output);
+    return output;
 }
@@ -10,6 +10,10 @@
 #pragma once
 
 #include <QString>
+#include <QByteArray>
+
+class QIODevice;
+struct xz_dec;
 
 class QGCLZMA
 {
@@ -18,4 +22,45 @@ public:
     ///     @param lzmaFilename         Fully qualified path to lzma file
     ///     @param decompressedFilename Fully qualified path to for file to decompress to
     static bool inflateLZMAFile(const QString& lzmaFilename, const QString& decompressedFilename);
+
+    /// Decompresses everything which can be read from the input device to the output device
+    ///     @param input    Device open for reading positioned at the start of the xz data
+    ///     @param output   Device open for writing
+    static bool inflateLZMA(QIODevice* input, QIODevice* output);
+
+    /// Decompresses xz data held in memory
+    ///     @param[out] decompressed Decompressed data
+    static bool inflateLZMA(const QByteArray& compressed, QByteArray& decompressed);
+};
+
+/// Incremental xz decompression. Compressed data can be fed in as it arrives in chunks of any size.
+/// Decompressed data accumulates until it is taken.
+class QGCLZMAInflater
+{
+public:
+    QGCLZMAInflater(void);
+    ~QGCLZMAInflater();
+
+    /// Decompresses the next chunk of the compressed stream. Data past the end of the stream is ignored.
+    ///     @return false: stream is corrupt, see errorString
+    bool addData(const char* data, int size);
+    bool addData(const QByteArray& data) { return addData(data.constData(), data.size()); }
+
+    bool        finished    (void) const { return _finished; }     ///< true: end of compressed stream reached
+    bool        hasError    (void) const { return !_errorString.isEmpty(); }
+    QString     errorString (void) const { return _errorString; }
+
+    /// Decompressed data which has not been taken yet
+    const QByteArray& output(void) const { return _output; }
+
+    /// Returns and clears the decompressed data accumulated so far
+    QByteArray takeOutput(void);
+
+private:
+    xz_dec*     _dec        = nullptr;
+    bool        _finished   = false;
+    QString     _errorString;
+    QByteArray  _output;
+
+    static const int _outputChunkSize = 16 * 1024;
 };
@@ -17,13 +17,6 @@
 
 bool QGCZlib::inflateGzipFile(const QString& gzippedFileName, const QString& decompressedFilename)
 {
-    bool            success                 = true;
-    int             ret;
-    const int       cBuffer                 = 1024 * 5;
-    unsigned char   inputBuffer[cBuffer];
-    unsigned char   outputBuffer[cBuffer];
-    z_stream        strm;
-
     QFile inputFile(gzippedFileName);
     if (!inputFile.open(QIODevice::ReadOnly)) {
         qWarning() << "QGCZlib::inflateGzipFile: open input file failed" << gzippedFileName << inputFile.errorString();
@@ -36,50 +29,123 @@ bool QGCZlib::inflateGzipFile(const QString& gzippedFileName, const QString& dec
         return false;
     }
 
-    strm.zalloc     = nullptr;
-    strm.zfree      = nullptr;
-    strm.opaque     = nullptr;
-    strm.avail_in   = 0;
-    strm.next_in    = nullptr;
+    return inflateGzip(&inputFile, &outputFile);
+}
+
+bool QGCZlib::inflateGzip(QIODevice* input, QIODevice* output)
+{
+    const qint64    cBuffer = 1024 * 16;
+    QGCZlibInflater inflater;
+
+    while (!inflater.finished()) {
+        QByteArray chunk = input->read(cBuffer);
+        if (chunk.isEmpty()) {
+            break;
+        }
+        if (!inflater.addData(chunk)) {
+            qWarning() << "QGCZlib::inflateGzip: inflate failed:" << inflater.errorString();
+            return false;
+        }
+
+        QByteArray inflated = inflater.takeOutput();
+        if (output->write(inflated) != inflated.size()) {
+            qWarning() << "QGCZlib::inflateGzip: output write failed:" << output->errorString();
+            return false;
+        }
+    }
+
+    if (!inflater.finished()) {
+        qWarning() << "QGCZlib::inflateGzip: unexpected end of compressed data";
+        return false;
+    }
+
+    return true;
+}
+
+bool QGCZlib::inflateGzip(const QByteArray& compressed, QByteArray& decompressed)
+{
+    QGCZlibInflater inflater;
+
+    decompressed.clear();
+
+    if (!inflater.addData(compressed)) {
+        qWarning() << "QGCZlib::inflateGzip: inflate failed:" << inflater.errorString();
+        return false;
+    }
+    if (!inflater.finished()) {
+        qWarning() << "QGCZlib::inflateGzip: unexpected end of compressed data";
+        return false;
+    }
+
+    decompressed = inflater.takeOutput();
+    return true;
+}
+
+QGCZlibInflater::QGCZlibInflater(void)
+    : _stream(new z_stream)
+{
+    _stream->zalloc     = nullptr;
+    _stream->zfree      = nullptr;
+    _stream->opaque     = nullptr;
+    _stream->avail_in   = 0;
+    _stream->next_in    = nullptr;
 
-    ret = inflateInit2(&strm, 16+MAX_WBITS);
+    int ret = inflateInit2(_stream, 16+MAX_WBITS);
     if (ret != Z_OK) {
-        qWarning() << "QGCZlib::inflateGzipFile: inflateInit2 failed:" << ret;
-        goto Error;
+        _errorString = QStringLiteral("inflateInit2 failed: %1").arg(ret);
+        delete _stream;
+        _stream = nullptr;
+    }
+}
+
+QGCZlibInflater::~QGCZlibInflater()
+{
+    if (_stream) {
+        inflateEnd(_stream);
+        delete _stream;
     }
+}
+
+bool QGCZlibInflater::addData(const char* data, int size)
+{
+    if (hasError()) {
+        return false;
+    }
+    if (_finished || size <= 0) {
+        return true;
+    }
+
+    _stream->next_in    = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    _stream->avail_in   = static_cast<uInt>(size);
 
     do {
-        strm.avail_in = static_cast<unsigned>(inputFile.read((char*)inputBuffer, cBuffer));
-        if (strm.avail_in == 0) {
+        // Inflate straight into the output buffer
+        int outputStart = _output.size();
+        _output.resize(outputStart + _outputChunkSize);
+        _stream->next_out   = reinterpret_cast<Bytef*>(_output.data() + outputStart);
+        _stream->avail_out  = _outputChunkSize;
+
+        int ret = inflate(_stream, Z_NO_FLUSH);
+        _output.resize(outputStart + _outputChunkSize - static_cast<int>(_stream->avail_out));
+
+        if (ret == Z_STREAM_END) {
+            _finished = true;
             break;
+        } else if (ret == Z_BUF_ERROR) {
+            // No progress possible, more input needed
+            break;
+        } else if (ret != Z_OK) {
+            _errorString = QStringLiteral("inflate failed: %1 %2").arg(ret).arg(_stream->msg ? _stream->msg : "");
+            return false;
         }
-        strm.next_in = inputBuffer;
-
-        do {
-            strm.avail_out  = cBuffer;
-            strm.next_out   = outputBuffer;
-
-            ret = inflate(&strm, Z_NO_FLUSH);
-            if (ret != Z_OK && ret != Z_STREAM_END) {
-                qWarning() << "QGCZlib::inflateGzipFile: inflate failed:" << ret;
-                goto Error;
-            }
-
-            unsigned cBytesInflated = cBuffer - strm.avail_out;
-            qint64 cBytesWritten = outputFile.write((char*)outputBuffer, static_cast<int>(cBytesInflated));
-            if (cBytesWritten != cBytesInflated) {
-                qWarning() << "QGCZlib::inflateGzipFile: output file write failed:" << outputFile.fileName() << outputFile.errorString();
-                goto Error;
-
-            }
-        } while (strm.avail_out == 0);
-    } while (ret != Z_STREAM_END);
-
-Out:
-    inflateEnd(&strm);
-    return success;
-
-Error:
-    success = false;
-    goto Out;
+    } while (_stream->avail_in != 0 || _stream->avail_out == 0);
+
+    return true;
+}
+
+QByteArray QGCZlibInflater::takeOutput(void)
+{
+    QByteArray output;
+    output.swap(_output);
+    return output;
 }
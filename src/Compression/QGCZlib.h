@@ -10,6 +10,10 @@
 #pragma once
 
 #include <QString>
+#include <QByteArray>
+
+class QIODevice;
+struct z_stream_s;
 
 class QGCZlib
 {
@@ -18,4 +22,45 @@ public:
     ///     @param gzipFilename         Fully qualified path to gzip file
     ///     @param decompressedFilename Fully qualified path to for file to decompress to
     static bool inflateGzipFile(const QString& gzippedFileName, const QString& decompressedFilename);
+
+    /// Decompresses everything which can be read from the input device to the output device
+    ///     @param input    Device open for reading positioned at the start of the gzip data
+    ///     @param output   Device open for writing
+    static bool inflateGzip(QIODevice* input, QIODevice* output);
+
+    /// Decompresses gzip data held in memory
+    ///     @param[out] decompressed Decompressed data
+    static bool inflateGzip(const QByteArray& compressed, QByteArray& decompressed);
+};
+
+/// Incremental gzip decompression. Compressed data can be fed in as it arrives in chunks of any size.
+/// Decompressed data accumulates until it is taken.
+class QGCZlibInflater
+{
+public:
+    QGCZlibInflater(void);
+    ~QGCZlibInflater();
+
+    /// Decompresses the next chunk of the compressed stream. Data past the end of the stream is ignored.
+    ///     @return false: stream is corrupt, see errorString
+    bool addData(const char* data, int size);
+    bool addData(const QByteArray& data) { return addData(data.constData(), data.size()); }
+
+    bool        finished    (void) const { return _finished; }     ///< true: end of compressed stream reached
+    bool        hasError    (void) const { return !_errorString.isEmpty(); }
+    QString     errorString (void) const { return _errorString; }
+
+    /// Decompressed data which has not been taken yet
+    const QByteArray& output(void) const { return _output; }
+
+    /// Returns and clears the decompressed data accumulated so far
+    QByteArray takeOutput(void);
+
+private:
+    z_stream_s* _stream     = nullptr;
+    bool        _finished   = false;
+    QString     _errorString;
+    QByteArray  _output;
+
+    static const int _outputChunkSize = 16 * 1024;
 };
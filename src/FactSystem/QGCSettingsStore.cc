@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCSettingsStore.h"
+
+#include <QCoreApplication>
+
+QGC_LOGGING_CATEGORY(QGCSettingsStoreLog, "QGCSettingsStoreLog")
+
+QGCSettingsStore* QGCSettingsStore::_instance = nullptr;
+
+QGCSettingsStore::QGCSettingsStore(const QString& fileName, QObject* parent)
+    : QObject   (parent)
+    , _settings (fileName.isEmpty() ? QSettings().fileName() : fileName, QSettings::IniFormat)
+{
+    _settings.setAtomicSyncRequired(true);
+
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(flushDelayMsecs);
+    connect(&_flushTimer, &QTimer::timeout, this, &QGCSettingsStore::flush);
+}
+
+QGCSettingsStore::~QGCSettingsStore()
+{
+    flush();
+    if (_instance == this) {
+        _instance = nullptr;
+    }
+}
+
+QGCSettingsStore* QGCSettingsStore::instance(void)
+{
+    if (!_instance) {
+        // Parented to the application so anything still queued is written when it goes away
+        _instance = new QGCSettingsStore(QString(), QCoreApplication::instance());
+    }
+    return _instance;
+}
+
+QString QGCSettingsStore::key(const QString& group, const QString& name)
+{
+    return group.isEmpty() ? name : QStringLiteral("%1/%2").arg(group, name);
+}
+
+QVariant QGCSettingsStore::value(const QString& key, const QVariant& defaultValue) const
+{
+    auto it = _pending.constFind(key);
+    if (it != _pending.constEnd()) {
+        return it.value();
+    }
+    return _settings.value(key, defaultValue);
+}
+
+bool QGCSettingsStore::contains(const QString& key) const
+{
+    return _pending.contains(key) || _settings.contains(key);
+}
+
+void QGCSettingsStore::setValue(const QString& key, const QVariant& value)
+{
+    if (!_pending.contains(key) && _settings.contains(key) && _settings.value(key) == value) {
+        return;
+    }
+
+    _writeRequestCount++;
+    _pending[key] = value;
+    _flushTimer.start();
+}
+
+void QGCSettingsStore::flush(void)
+{
+    _flushTimer.stop();
+
+    if (_pending.isEmpty()) {
+        return;
+    }
+
+    for (auto it = _pending.constBegin(); it != _pending.constEnd(); ++it) {
+        _settings.setValue(it.key(), it.value());
+    }
+    _settings.sync();
+    _syncCount++;
+
+    const int count = _pending.count();
+    _pending.clear();
+
+    if (_settings.status() != QSettings::NoError) {
+        qCWarning(QGCSettingsStoreLog) << "Writing settings failed" << _settings.fileName() << _settings.status();
+    } else {
+        qCDebug(QGCSettingsStoreLog) << "Wrote" << count << "settings";
+    }
+
+    emit flushed(count);
+}
+
+void QGCSettingsStore::discardPending(void)
+{
+    _flushTimer.stop();
+    _pending.clear();
+}
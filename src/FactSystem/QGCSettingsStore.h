@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QSettings>
+#include <QTimer>
+#include <QVariant>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(QGCSettingsStoreLog)
+
+/// Central write-back store for SettingsFact values.
+///
+/// Every QSettings object which is destroyed with changes pending rewrites the whole settings file. Editing a setting from
+/// a slider or text field used to do that for each intermediate value. The store instead keeps changed values in memory
+/// and writes them out together once no further change has arrived for flushDelayMsecs, as well as on shutdown. The write
+/// itself goes through QSettings::sync which replaces the file atomically (QSaveFile), so a crash during the write leaves
+/// the previous settings intact.
+///
+/// Values which have not been flushed yet are only visible through the store. Must only be used from the gui thread.
+class QGCSettingsStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param fileName Ini file to use, empty for the application settings file
+    QGCSettingsStore(const QString& fileName = QString(), QObject* parent = nullptr);
+    ~QGCSettingsStore();
+
+    /// @return Store for the application settings file
+    static QGCSettingsStore* instance(void);
+
+    /// @return Full settings key for the specified group and name
+    static QString key(const QString& group, const QString& name);
+
+    QVariant    value       (const QString& key, const QVariant& defaultValue = QVariant()) const;
+    bool        contains    (const QString& key) const;
+
+    /// Queues the value to be written. Setting a key to the value it already holds is ignored.
+    void setValue(const QString& key, const QVariant& value);
+
+    /// Writes all queued values to the settings file immediately
+    void flush(void);
+
+    /// Drops all queued values without writing them
+    void discardPending(void);
+
+    bool    hasPending          (void) const { return !_pending.isEmpty(); }
+    int     pendingCount        (void) const { return _pending.count(); }
+    QString fileName            (void) const { return _settings.fileName(); }
+
+    /// Number of setValue calls which changed a value, each of which used to be a file write
+    quint64 writeRequestCount   (void) const { return _writeRequestCount; }
+
+    /// Number of times the settings file was actually written
+    quint64 syncCount           (void) const { return _syncCount; }
+
+    static const int flushDelayMsecs = 500;
+
+signals:
+    /// Signalled after queued values were written
+    ///     @param count Number of values written
+    void flushed(int count);
+
+private:
+    QSettings                   _settings;
+    QHash<QString, QVariant>    _pending;
+    QTimer                      _flushTimer;
+    quint64                     _writeRequestCount  = 0;
+    quint64                     _syncCount          = 0;
+
+    static QGCSettingsStore* _instance;
+};
@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCSettingsStoreTest.h"
+#include "QGCSettingsStore.h"
+#include "SettingsFact.h"
+
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QSignalSpy>
+
+void QGCSettingsStoreTest::init(void)
+{
+    UnitTest::init();
+
+    _tempDir = new QTemporaryDir();
+    QVERIFY(_tempDir->isValid());
+}
+
+void QGCSettingsStoreTest::cleanup(void)
+{
+    delete _tempDir;
+    _tempDir = nullptr;
+
+    UnitTest::cleanup();
+}
+
+QString QGCSettingsStoreTest::_iniFile(void) const
+{
+    return _tempDir->filePath(QStringLiteral("settings.ini"));
+}
+
+void QGCSettingsStoreTest::_coalesceTest(void)
+{
+    QGCSettingsStore store(_iniFile());
+    QSignalSpy spyFlushed(&store, &QGCSettingsStore::flushed);
+
+    const QString key = QGCSettingsStore::key(QStringLiteral("Group"), QStringLiteral("value"));
+    QCOMPARE(key, QStringLiteral("Group/value"));
+
+    // Simulate dragging a slider across its range
+    for (int i=0; i<100; i++) {
+        store.setValue(key, i);
+    }
+    QCOMPARE(store.writeRequestCount(), 100ull);
+    QCOMPARE(store.pendingCount(), 1);
+    QCOMPARE(store.syncCount(), 0ull);
+
+    // Visible through the store right away, but nothing written yet
+    QCOMPARE(store.value(key).toInt(), 99);
+    QVERIFY(store.contains(key));
+    QVERIFY(!QSettings(_iniFile(), QSettings::IniFormat).contains(key));
+
+    QVERIFY(spyFlushed.wait(QGCSettingsStore::flushDelayMsecs * 4));
+    QCOMPARE(spyFlushed.count(), 1);
+    QCOMPARE(spyFlushed[0][0].toInt(), 1);
+    QCOMPARE(store.syncCount(), 1ull);
+    QVERIFY(!store.hasPending());
+    QCOMPARE(QSettings(_iniFile(), QSettings::IniFormat).value(key).toInt(), 99);
+}
+
+void QGCSettingsStoreTest::_unchangedValueTest(void)
+{
+    QGCSettingsStore store(_iniFile());
+
+    store.setValue(QStringLiteral("value"), 10);
+    store.flush();
+    QCOMPARE(store.syncCount(), 1ull);
+
+    // Writing back the stored value, as invisible settings do on every start, does not touch the file
+    store.setValue(QStringLiteral("value"), 10);
+    QVERIFY(!store.hasPending());
+    store.flush();
+    QCOMPARE(store.writeRequestCount(), 1ull);
+    QCOMPARE(store.syncCount(), 1ull);
+
+    // Changing away and back again within the debounce still writes once
+    store.setValue(QStringLiteral("value"), 11);
+    store.setValue(QStringLiteral("value"), 10);
+    store.flush();
+    QCOMPARE(store.syncCount(), 2ull);
+    QCOMPARE(QSettings(_iniFile(), QSettings::IniFormat).value(QStringLiteral("value")).toInt(), 10);
+}
+
+void QGCSettingsStoreTest::_flushOnDestroyTest(void)
+{
+    QGCSettingsStore* store = new QGCSettingsStore(_iniFile());
+    store->setValue(QStringLiteral("Group/a"), QStringLiteral("text"));
+    store->setValue(QStringLiteral("Group/b"), true);
+    QCOMPARE(store->syncCount(), 0ull);
+    delete store;
+
+    QSettings settings(_iniFile(), QSettings::IniFormat);
+    QCOMPARE(settings.value(QStringLiteral("Group/a")).toString(), QStringLiteral("text"));
+    QCOMPARE(settings.value(QStringLiteral("Group/b")).toBool(), true);
+}
+
+void QGCSettingsStoreTest::_discardTest(void)
+{
+    QGCSettingsStore store(_iniFile());
+    QSignalSpy spyFlushed(&store, &QGCSettingsStore::flushed);
+
+    store.setValue(QStringLiteral("value"), 1);
+    store.discardPending();
+    QVERIFY(!store.hasPending());
+    QVERIFY(!store.contains(QStringLiteral("value")));
+
+    QTest::qWait(QGCSettingsStore::flushDelayMsecs * 2);
+    QCOMPARE(spyFlushed.count(), 0);
+    QCOMPARE(store.syncCount(), 0ull);
+}
+
+void QGCSettingsStoreTest::_settingsFactWriteBenchmark(void)
+{
+    static const char*  settingsGroup   = "QGCSettingsStoreTest";
+    static const int    cSliderSteps    = 50;
+
+    QGCSettingsStore* store = QGCSettingsStore::instance();
+    store->flush();
+
+    const quint64 startRequests = store->writeRequestCount();
+    const quint64 startSyncs    = store->syncCount();
+
+    // Startup: create a fact for every application setting, same as SettingsManager does
+    QElapsedTimer timer;
+    timer.start();
+
+    QMap<QString, FactMetaData*> metaDataMap = FactMetaData::createMapFromJsonFile(QStringLiteral(":/json/App.SettingsGroup.json"), this);
+    QVERIFY(!metaDataMap.isEmpty());
+    QList<SettingsFact*> facts;
+    for (FactMetaData* metaData: metaDataMap) {
+        facts.append(new SettingsFact(settingsGroup, metaData, this));
+    }
+    store->flush();
+
+    const qint64  startupMsecs    = timer.elapsed();
+    const quint64 startupRequests = store->writeRequestCount() - startRequests;
+    const quint64 startupSyncs    = store->syncCount() - startSyncs;
+    QVERIFY(startupSyncs <= 1);
+
+    // Typical edits: drag sliders for numeric settings and flip boolean settings, all within one debounce period
+    timer.restart();
+    quint64 editValues = 0;
+    for (SettingsFact* fact: facts) {
+        if (fact->type() == FactMetaData::valueTypeBool) {
+            fact->setRawValue(!fact->rawValue().toBool());
+            fact->setRawValue(!fact->rawValue().toBool());
+            editValues += 2;
+        } else if (fact->type() == FactMetaData::valueTypeDouble && !fact->minIsDefaultForType() && !fact->maxIsDefaultForType()) {
+            const double min = fact->rawMin().toDouble();
+            const double max = fact->rawMax().toDouble();
+            for (int i=1; i<=cSliderSteps; i++) {
+                fact->setRawValue(min + ((max - min) * i) / cSliderSteps);
+                editValues++;
+            }
+        }
+    }
+    const quint64 editRequests = store->writeRequestCount() - startRequests - startupRequests;
+    QCOMPARE(store->syncCount() - startSyncs - startupSyncs, 0ull);
+
+    QSignalSpy spyFlushed(store, &QGCSettingsStore::flushed);
+    QVERIFY(spyFlushed.wait(QGCSettingsStore::flushDelayMsecs * 4));
+    const qint64  editMsecs = timer.elapsed();
+    const quint64 editSyncs = store->syncCount() - startSyncs - startupSyncs;
+    QCOMPARE(editSyncs, 1ull);
+
+    qDebug() << "Startup:" << facts.count() << "facts," << startupRequests << "write requests," << startupSyncs << "file writes," << startupMsecs << "msecs";
+    qDebug() << "Edits:" << editValues << "values," << editRequests << "write requests (file writes before coalescing)," << editSyncs << "file writes," << editMsecs << "msecs including debounce";
+
+    qDeleteAll(facts);
+    store->flush();
+}
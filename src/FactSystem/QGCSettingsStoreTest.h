@@ -0,0 +1,35 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QTemporaryDir>
+
+/// Tests write coalescing in QGCSettingsStore and reports the settings file writes caused by SettingsFact
+class QGCSettingsStoreTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init                       (void);
+    void cleanup                    (void);
+
+    void _coalesceTest              (void);
+    void _unchangedValueTest        (void);
+    void _flushOnDestroyTest        (void);
+    void _discardTest               (void);
+    void _settingsFactWriteBenchmark(void);
+
+private:
+    QString _iniFile(void) const;
+
+    QTemporaryDir* _tempDir = nullptr;
+};
@@ -11,8 +11,7 @@
 #include "SettingsFact.h"
 #include "QGCCorePlugin.h"
 #include "QGCApplication.h"
-
-#include <QSettings>
+#include "QGCSettingsStore.h"
 
 SettingsFact::SettingsFact(QObject* parent)
     : Fact(parent)
@@ -25,11 +24,8 @@ SettingsFact::SettingsFact(QString settingsGroup, FactMetaData* metaData, QObjec
     , _settingsGroup(settingsGroup)
     , _visible      (true)
 {
-    QSettings settings;
-
-    if (!_settingsGroup.isEmpty()) {
-        settings.beginGroup(_settingsGroup);
-    }
+    QGCSettingsStore*   store   = QGCSettingsStore::instance();
+    QString             key     = QGCSettingsStore::key(_settingsGroup, _name);
 
     // Allow core plugin a chance to override the default value
     _visible = qgcApp()->toolbox()->corePlugin()->adjustSettingMetaData(settingsGroup, *metaData);
@@ -44,11 +40,11 @@ SettingsFact::SettingsFact(QString settingsGroup, FactMetaData* metaData, QObjec
             if (_visible) {
                 QVariant typedValue;
                 QString errorString;
-                metaData->convertAndValidateRaw(settings.value(_name, rawDefaultValue), true /* conertOnly */, typedValue, errorString);
+                metaData->convertAndValidateRaw(store->value(key, rawDefaultValue), true /* conertOnly */, typedValue, errorString);
                 _rawValue = typedValue;
             } else {
-                // Setting is not visible, force to default value always
-                settings.setValue(_name, rawDefaultValue);
+                // Setting is not visible, force to default value always. The store skips the write if it already is.
+                store->setValue(key, rawDefaultValue);
                 _rawValue = rawDefaultValue;
             }
         }
@@ -74,11 +70,6 @@ const SettingsFact& SettingsFact::operator=(const SettingsFact& other)
 
 void SettingsFact::_rawValueChanged(QVariant value)
 {
-    QSettings settings;
-
-    if (!_settingsGroup.isEmpty()) {
-        settings.beginGroup(_settingsGroup);
-    }
-
-    settings.setValue(_name, value);
+    // Written out by the store once editing settles down
+    QGCSettingsStore::instance()->setValue(QGCSettingsStore::key(_settingsGroup, _name), value);
 }
@@ -1044,6 +1044,10 @@ void FirmwarePlugin::sendGCSMotionReport(Vehicle* vehicle, FollowMe::GCSMotionRe
         follow_target.lon =                 motionReport.lon_int;
         follow_target.vel[0] =              static_cast<float>(motionReport.vxMetersPerSec);
         follow_target.vel[1] =              static_cast<float>(motionReport.vyMetersPerSec);
+        follow_target.vel[2] =              static_cast<float>(motionReport.vzMetersPerSec);
+        follow_target.acc[0] =              static_cast<float>(motionReport.axMetersPerSec2);
+        follow_target.acc[1] =              static_cast<float>(motionReport.ayMetersPerSec2);
+        follow_target.acc[2] =              static_cast<float>(motionReport.azMetersPerSec2);
 
         mavlink_message_t message;
         mavlink_msg_follow_target_encode_chan(static_cast<uint8_t>(mavlinkProtocol->getSystemId()),
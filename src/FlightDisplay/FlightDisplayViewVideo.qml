@@ -170,6 +170,74 @@ Item {
                 opacity:        _camera ? (_camera.thermalMode === QGCCameraControl.THERMAL_BLEND ? _camera.thermalOpacity / 100 : 1.0) : 0
             }
         }
+        //-- Additional camera streams, shown as thumbnails. Tapping one pauses or resumes decoding of that stream.
+        Row {
+            anchors.left:       parent.left
+            anchors.bottom:     parent.bottom
+            anchors.margins:    ScreenTools.defaultFontPixelWidth
+            spacing:            ScreenTools.defaultFontPixelWidth
+            visible:            !QGroundControl.videoManager.fullScreen
+            z:                  pinchZoom.z + 1
+
+            Repeater {
+                model: QGroundControl.videoManager.streams
+
+                Rectangle {
+                    width:          visible ? ScreenTools.defaultFontPixelHeight * 10 : 0
+                    height:         width * (_videoSize.width > 0 ? _videoSize.height / _videoSize.width : 9 / 16)
+                    color:          "black"
+                    border.color:   "white"
+                    border.width:   1
+                    visible:        _additionalStream
+
+                    // Primary and thermal streams are shown above
+                    property bool   _additionalStream:  index > 1
+                    property var    _stream:            object
+                    property size   _videoSize:         _stream.videoSize
+
+                    Loader {
+                        id:                 streamVideoLoader
+                        anchors.fill:       parent
+                        anchors.margins:    1
+                        active:             _additionalStream
+                        visible:            _stream.decoding
+                        sourceComponent:    streamVideoComponent
+                    }
+
+                    Component {
+                        id: streamVideoComponent
+                        QGCVideoBackground {
+                            id:         streamVideo
+                            receiver:   _stream.receiver
+                            Component.onCompleted: QGroundControl.videoManager.setVideoItem(index, streamVideo)
+                        }
+                    }
+
+                    QGCLabel {
+                        anchors.centerIn:   parent
+                        text:               _stream.decodingEnabled ? qsTr("WAITING FOR VIDEO") : qsTr("PAUSED")
+                        color:              "white"
+                        font.pointSize:     ScreenTools.smallFontPointSize
+                        visible:            !_stream.decoding
+                    }
+
+                    QGCLabel {
+                        anchors.left:       parent.left
+                        anchors.top:        parent.top
+                        anchors.margins:    ScreenTools.defaultFontPixelWidth * 0.5
+                        text:               _stream.name
+                        color:              "white"
+                        font.pointSize:     ScreenTools.smallFontPointSize
+                    }
+
+                    MouseArea {
+                        anchors.fill:   parent
+                        onClicked:      _stream.decodingEnabled = !_stream.decodingEnabled
+                    }
+                }
+            }
+        }
+
         //-- Zoom
         PinchArea {
             id:             pinchZoom
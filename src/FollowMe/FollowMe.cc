@@ -7,7 +7,7 @@
  *
  ****************************************************************************/
 
-#include <QElapsedTimer>
+#include <QDateTime>
 #include <cmath>
 
 #include "MultiVehicleManager.h"
@@ -21,6 +21,10 @@
 
 QGC_LOGGING_CATEGORY(FollowMeLog, "FollowMeLog")
 
+constexpr int FollowMe::transportLatencyMsecs;
+constexpr int FollowMe::_minSendIntervalMsecs;
+constexpr int FollowMe::_maxSendIntervalMsecs;
+
 FollowMe::FollowMe(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
 {
@@ -31,8 +35,9 @@ void FollowMe::setToolbox(QGCToolbox* toolbox)
 {
     QGCTool::setToolbox(toolbox);
 
-    connect(&_gcsMotionReportTimer,                                     &QTimer::timeout,       this, &FollowMe::_sendGCSMotionReport);
-    connect(toolbox->settingsManager()->appSettings()->followTarget(),  &Fact::rawValueChanged, this, &FollowMe::_settingsChanged);
+    connect(&_gcsMotionReportTimer,                                     &QTimer::timeout,                           this, &FollowMe::_sendGCSMotionReport);
+    connect(toolbox->settingsManager()->appSettings()->followTarget(),  &Fact::rawValueChanged,                     this, &FollowMe::_settingsChanged);
+    connect(toolbox->qgcPositionManager(),                              &QGCPositionManager::positionInfoUpdated,   this, &FollowMe::_positionInfoUpdated);
 
     _settingsChanged();
 }
@@ -63,7 +68,7 @@ void FollowMe::_settingsChanged()
 void FollowMe::_enableFollowSend()
 {
     if (!_gcsMotionReportTimer.isActive()) {
-        _gcsMotionReportTimer.setInterval(qMin(_toolbox->qgcPositionManager()->updateInterval(), 250));
+        _gcsMotionReportTimer.setInterval(sendIntervalMsecs(_estimator.groundSpeed()));
         _gcsMotionReportTimer.start();
     }
 }
@@ -75,76 +80,106 @@ void FollowMe::_disableFollowSend()
     }
 }
 
-void FollowMe::_sendGCSMotionReport()
+void FollowMe::_positionInfoUpdated(QGeoPositionInfo positionInfo)
 {
-    QGeoPositionInfo    geoPositionInfo =   _toolbox->qgcPositionManager()->geoPositionInfo();
-    QGeoCoordinate      gcsCoordinate =     geoPositionInfo.coordinate();
+    _estimator.update(positionInfo);
 
-    if (!geoPositionInfo.isValid()) {
-        return;
-    }
-
-    // First check to see if any vehicles need follow me updates
-    bool needFollowMe = false;
-    if (_currentMode == MODE_ALWAYS) {
-        needFollowMe = true;
-    } else if (_currentMode == MODE_FOLLOWME) {
-        QmlObjectListModel* vehicles = _toolbox->multiVehicleManager()->vehicles();
-        for (int i=0; i<vehicles->count(); i++) {
-            Vehicle* vehicle = vehicles->value<Vehicle*>(i);
-            if (_isFollowFlightMode(vehicle, vehicle->flightMode())) {
-                needFollowMe = true;
-            }
+    // Send faster when the ground station is moving faster
+    if (_gcsMotionReportTimer.isActive()) {
+        int interval = sendIntervalMsecs(_estimator.groundSpeed());
+        if (interval != _gcsMotionReportTimer.interval()) {
+            qCDebug(FollowMeLog) << "Send interval" << interval;
+            _gcsMotionReportTimer.setInterval(interval);
         }
     }
-    if (!needFollowMe) {
-        return;
-    }
+}
 
-    GCSMotionReport motionReport = {};
-    uint8_t         estimatation_capabilities = 0;
+int FollowMe::sendIntervalMsecs(double groundSpeed)
+{
+    // 1Hz when standing still, increasing by 1Hz per meter/sec up to 10Hz
+    int interval = static_cast<int>(1000.0 / (1.0 + qMax(groundSpeed, 0.0)));
+    return qBound(static_cast<int>(_minSendIntervalMsecs), interval, static_cast<int>(_maxSendIntervalMsecs));
+}
+
+uint8_t FollowMe::buildMotionReport(const FollowMeEstimator& estimator, const QGeoPositionInfo& positionInfo, qint64 msecsSinceEpoch, GCSMotionReport& motionReport)
+{
+    FollowMeEstimator::State_t  state;
+    uint8_t                     estimatation_capabilities = 0;
+
+    motionReport = {};
+    motionReport.pos_std_dev[0] = motionReport.pos_std_dev[1] = motionReport.pos_std_dev[2] = -1;
 
-    // get the current location coordinates
+    if (!estimator.predict(msecsSinceEpoch, state)) {
+        return 0;
+    }
 
-    motionReport.lat_int =          static_cast<int>(gcsCoordinate.latitude()  * 1e7);
-    motionReport.lon_int =          static_cast<int>(gcsCoordinate.longitude() * 1e7);
-    motionReport.altMetersAMSL =    gcsCoordinate.altitude();
+    motionReport.lat_int =          static_cast<int>(state.coordinate.latitude()  * 1e7);
+    motionReport.lon_int =          static_cast<int>(state.coordinate.longitude() * 1e7);
+    motionReport.altMetersAMSL =    qIsNaN(state.coordinate.altitude()) ? 0 : state.coordinate.altitude();
     estimatation_capabilities |=    (1 << POS);
 
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::Direction) == true) {
+    if (!qIsNaN(state.headingDegrees)) {
         estimatation_capabilities |= (1 << HEADING);
-        motionReport.headingDegrees = geoPositionInfo.attribute(QGeoPositionInfo::Direction);
+        motionReport.headingDegrees = state.headingDegrees;
     }
 
     // get the current eph and epv
 
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::HorizontalAccuracy)) {
-        motionReport.pos_std_dev[0] = motionReport.pos_std_dev[1] = geoPositionInfo.attribute(QGeoPositionInfo::HorizontalAccuracy);
+    if (positionInfo.hasAttribute(QGeoPositionInfo::HorizontalAccuracy)) {
+        motionReport.pos_std_dev[0] = motionReport.pos_std_dev[1] = positionInfo.attribute(QGeoPositionInfo::HorizontalAccuracy);
     }
 
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::VerticalAccuracy)) {
-        motionReport.pos_std_dev[2] = geoPositionInfo.attribute(QGeoPositionInfo::VerticalAccuracy);
+    if (positionInfo.hasAttribute(QGeoPositionInfo::VerticalAccuracy)) {
+        motionReport.pos_std_dev[2] = positionInfo.attribute(QGeoPositionInfo::VerticalAccuracy);
     }
 
-    // calculate z velocity if it's available
+    // Velocity and acceleration are only known once the estimator has seen more than one fix
 
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::VerticalSpeed)) {
-        motionReport.vzMetersPerSec = geoPositionInfo.attribute(QGeoPositionInfo::VerticalSpeed);
+    if (estimator.fixCount() > 1) {
+        estimatation_capabilities |= (1 << VEL) | (1 << ACCEL);
+
+        motionReport.vxMetersPerSec     = state.vNorth;
+        motionReport.vyMetersPerSec     = state.vEast;
+        motionReport.vzMetersPerSec     = state.vDown;
+        motionReport.axMetersPerSec2    = state.aNorth;
+        motionReport.ayMetersPerSec2    = state.aEast;
+        motionReport.azMetersPerSec2    = state.aDown;
     }
 
-    // calculate x,y velocity if it's available
+    return estimatation_capabilities;
+}
 
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::Direction) && geoPositionInfo.hasAttribute(QGeoPositionInfo::GroundSpeed) == true) {
-        estimatation_capabilities |= (1 << VEL);
+void FollowMe::_sendGCSMotionReport()
+{
+    if (!_estimator.isValid()) {
+        return;
+    }
 
-        qreal direction = _degreesToRadian(geoPositionInfo.attribute(QGeoPositionInfo::Direction));
-        qreal velocity  = geoPositionInfo.attribute(QGeoPositionInfo::GroundSpeed);
+    // First check to see if any vehicles need follow me updates
+    bool needFollowMe = false;
+    if (_currentMode == MODE_ALWAYS) {
+        needFollowMe = true;
+    } else if (_currentMode == MODE_FOLLOWME) {
+        QmlObjectListModel* vehicles = _toolbox->multiVehicleManager()->vehicles();
+        for (int i=0; i<vehicles->count(); i++) {
+            Vehicle* vehicle = vehicles->value<Vehicle*>(i);
+            if (_isFollowFlightMode(vehicle, vehicle->flightMode())) {
+                needFollowMe = true;
+            }
+        }
+    }
+    if (!needFollowMe) {
+        return;
+    }
 
-        motionReport.vxMetersPerSec = cos(direction)*velocity;
-        motionReport.vyMetersPerSec = sin(direction)*velocity;
-    } else {
-        motionReport.vxMetersPerSec = 0;
-        motionReport.vyMetersPerSec = 0;
+    // Predict where the ground station will be by the time the vehicle receives the report
+    GCSMotionReport motionReport;
+    uint8_t         estimatation_capabilities = buildMotionReport(_estimator,
+                                                                  _toolbox->qgcPositionManager()->geoPositionInfo(),
+                                                                  QDateTime::currentMSecsSinceEpoch() + transportLatencyMsecs,
+                                                                  motionReport);
+    if (estimatation_capabilities == 0) {
+        return;
     }
 
     QmlObjectListModel* vehicles = _toolbox->multiVehicleManager()->vehicles();
@@ -158,11 +193,6 @@ void FollowMe::_sendGCSMotionReport()
     }
 }
 
-double FollowMe::_degreesToRadian(double deg)
-{
-    return deg * M_PI / 180.0;
-}
-
 void FollowMe::_vehicleAdded(Vehicle* vehicle)
 {
     connect(vehicle, &Vehicle::flightModeChanged, this, &FollowMe::_enableIfVehicleInFollow);
@@ -19,6 +19,7 @@
 
 #include "QGCToolbox.h"
 #include "MAVLinkProtocol.h"
+#include "FollowMeEstimator.h"
 
 class Vehicle;
 
@@ -39,6 +40,9 @@ public:
         double  vxMetersPerSec;     //	X velocity in NED frame in meter / s
         double  vyMetersPerSec;     //	Y velocity in NED frame in meter / s
         double  vzMetersPerSec;     //	Z velocity in NED frame in meter / s
+        double  axMetersPerSec2;    // X acceleration in NED frame in meter / s^2
+        double  ayMetersPerSec2;    // Y acceleration in NED frame in meter / s^2
+        double  azMetersPerSec2;    // Z acceleration in NED frame in meter / s^2
         double  pos_std_dev[3];     // -1 for unknown
     };
 
@@ -53,8 +57,20 @@ public:
 
     void setToolbox(QGCToolbox* toolbox) override;
 
+    /// Fills in a motion report from the estimator state predicted for the specified time
+    ///     @param positionInfo Last raw position info, used for accuracy information
+    ///     @return Estimation capabilities bitmask (1 << POS, ...), 0 if the estimator has no position yet
+    static uint8_t buildMotionReport(const FollowMeEstimator& estimator, const QGeoPositionInfo& positionInfo, qint64 msecsSinceEpoch, GCSMotionReport& motionReport);
+
+    /// @return Interval to send motion reports at when the ground station is moving at the specified speed
+    static int sendIntervalMsecs(double groundSpeed);
+
+    /// Latency from the time a report is sent until the vehicle uses it, the report is predicted ahead by this amount
+    static constexpr int transportLatencyMsecs = 100;
+
 private slots:
     void _sendGCSMotionReport       (void);
+    void _positionInfoUpdated       (QGeoPositionInfo positionInfo);
     void _settingsChanged           (void);
     void _vehicleAdded              (Vehicle* vehicle);
     void _vehicleRemoved            (Vehicle* vehicle);
@@ -69,9 +85,12 @@ private:
 
     void    _disableFollowSend  (void);
     void    _enableFollowSend   (void);
-    double  _degreesToRadian    (double deg);
     bool    _isFollowFlightMode (Vehicle* vehicle, const QString& flightMode);
 
-    QTimer      _gcsMotionReportTimer;
-    uint32_t    _currentMode;
+    QTimer              _gcsMotionReportTimer;
+    uint32_t            _currentMode;
+    FollowMeEstimator   _estimator;
+
+    static constexpr int _minSendIntervalMsecs = 100;
+    static constexpr int _maxSendIntervalMsecs = 1000;
 };
@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FollowMeEstimator.h"
+#include "QGCGeo.h"
+
+#include <QDateTime>
+#include <QtMath>
+
+constexpr double    FollowMeEstimator::alpha;
+constexpr double    FollowMeEstimator::beta;
+constexpr double    FollowMeEstimator::gamma;
+constexpr double    FollowMeEstimator::velocityGain;
+constexpr double    FollowMeEstimator::maxAcceleration;
+constexpr int       FollowMeEstimator::maxPredictionMsecs;
+constexpr double    FollowMeEstimator::minHeadingSpeed;
+constexpr double    FollowMeEstimator::maxOriginDistance;
+
+FollowMeEstimator::FollowMeEstimator(void)
+{
+
+}
+
+void FollowMeEstimator::reset(void)
+{
+    _origin         = QGeoCoordinate();
+    _hasAltitude    = false;
+    _fixCount       = 0;
+    _lastFixMsecs   = 0;
+    _sourceHeading  = qQNaN();
+    for (int axis=0; axis<3; axis++) {
+        _pos[axis] = _vel[axis] = _accel[axis] = 0;
+    }
+}
+
+void FollowMeEstimator::update(const QGeoPositionInfo& positionInfo)
+{
+    if (!positionInfo.isValid() || !positionInfo.timestamp().isValid()) {
+        return;
+    }
+
+    QGeoCoordinate  coord       = positionInfo.coordinate();
+    qint64          fixMsecs    = positionInfo.timestamp().toMSecsSinceEpoch();
+    bool            hasAltitude = coord.type() == QGeoCoordinate::Coordinate3D;
+
+    _sourceHeading = positionInfo.hasAttribute(QGeoPositionInfo::Direction) ? positionInfo.attribute(QGeoPositionInfo::Direction) : qQNaN();
+
+    if (_fixCount > 0 && (fixMsecs <= _lastFixMsecs || _origin.distanceTo(coord) > maxOriginDistance || hasAltitude != _hasAltitude)) {
+        if (fixMsecs <= _lastFixMsecs) {
+            // Duplicate or out of order fix
+            return;
+        }
+        // Moved too far from the local origin (or altitude availability changed), start over from this fix
+        reset();
+    }
+
+    if (_fixCount == 0) {
+        _origin         = coord;
+        _hasAltitude    = hasAltitude;
+        _lastFixMsecs   = fixMsecs;
+        _fixCount       = 1;
+        if (!_hasAltitude) {
+            _origin.setAltitude(0);
+        }
+        return;
+    }
+
+    double measurement[3];
+    QGeoCoordinate coord3D(coord.latitude(), coord.longitude(), _hasAltitude ? coord.altitude() : 0);
+    convertGeoToNed(coord3D, _origin, &measurement[0], &measurement[1], &measurement[2]);
+
+    double dt = (fixMsecs - _lastFixMsecs) / 1000.0;
+    for (int axis=0; axis<3; axis++) {
+        _filterAxis(axis, measurement[axis], dt);
+    }
+
+    // Blend in velocity from the source if it has one, this is usually better than the differentiated position
+    if (positionInfo.hasAttribute(QGeoPositionInfo::Direction) && positionInfo.hasAttribute(QGeoPositionInfo::GroundSpeed)) {
+        double direction    = qDegreesToRadians(positionInfo.attribute(QGeoPositionInfo::Direction));
+        double speed        = positionInfo.attribute(QGeoPositionInfo::GroundSpeed);
+
+        _vel[0] += velocityGain * (qCos(direction) * speed - _vel[0]);
+        _vel[1] += velocityGain * (qSin(direction) * speed - _vel[1]);
+    }
+    if (_hasAltitude && positionInfo.hasAttribute(QGeoPositionInfo::VerticalSpeed)) {
+        _vel[2] += velocityGain * (-positionInfo.attribute(QGeoPositionInfo::VerticalSpeed) - _vel[2]);
+    }
+
+    _lastFixMsecs = fixMsecs;
+    _fixCount++;
+}
+
+void FollowMeEstimator::_filterAxis(int axis, double measurement, double dt)
+{
+    // Predict to the time of the fix
+    _pos[axis] += _vel[axis] * dt + 0.5 * _accel[axis] * dt * dt;
+    _vel[axis] += _accel[axis] * dt;
+
+    // Correct
+    double residual = measurement - _pos[axis];
+    _pos[axis]      += alpha * residual;
+    _vel[axis]      += (beta / dt) * residual;
+    _accel[axis]    += (gamma / (2.0 * dt * dt)) * residual;
+    _accel[axis]    = qBound(-maxAcceleration, _accel[axis], maxAcceleration);
+}
+
+double FollowMeEstimator::groundSpeed(void) const
+{
+    return qSqrt(_vel[0] * _vel[0] + _vel[1] * _vel[1]);
+}
+
+bool FollowMeEstimator::predict(qint64 msecsSinceEpoch, State_t& state) const
+{
+    if (!isValid()) {
+        return false;
+    }
+
+    double dt = qBound(static_cast<qint64>(0), msecsSinceEpoch - _lastFixMsecs, static_cast<qint64>(maxPredictionMsecs)) / 1000.0;
+
+    double pos[3];
+    double vel[3];
+    for (int axis=0; axis<3; axis++) {
+        pos[axis] = _pos[axis] + _vel[axis] * dt + 0.5 * _accel[axis] * dt * dt;
+        vel[axis] = _vel[axis] + _accel[axis] * dt;
+    }
+
+    convertNedToGeo(pos[0], pos[1], pos[2], _origin, &state.coordinate);
+    if (!_hasAltitude) {
+        state.coordinate.setAltitude(qQNaN());
+    }
+
+    state.vNorth        = vel[0];
+    state.vEast         = vel[1];
+    state.vDown         = _hasAltitude ? vel[2] : 0;
+    state.aNorth        = _accel[0];
+    state.aEast         = _accel[1];
+    state.aDown         = _hasAltitude ? _accel[2] : 0;
+    state.groundSpeed   = qSqrt(vel[0] * vel[0] + vel[1] * vel[1]);
+
+    if (state.groundSpeed >= minHeadingSpeed) {
+        state.headingDegrees = qRadiansToDegrees(qAtan2(vel[1], vel[0]));
+        if (state.headingDegrees < 0) {
+            state.headingDegrees += 360.0;
+        }
+    } else {
+        state.headingDegrees = _sourceHeading;
+    }
+
+    return true;
+}
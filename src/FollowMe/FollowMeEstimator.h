@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QGeoCoordinate>
+#include <QGeoPositionInfo>
+
+/// Constant acceleration (alpha-beta-gamma) estimator for the ground station position used by FollowMe.
+///
+/// Position fixes are filtered on a local tangent plane around the first fix. The filtered state can then be
+/// extrapolated to an arbitrary time, which is used to compensate for the age of the last fix plus the transport
+/// latency to the vehicle. Fixes from the position source are noisy and arrive at a low rate, so without this the
+/// vehicle sees a jittery position which is always behind.
+class FollowMeEstimator
+{
+public:
+    FollowMeEstimator(void);
+
+    typedef struct {
+        QGeoCoordinate  coordinate;
+        double          vNorth;             ///< meters/sec
+        double          vEast;              ///< meters/sec
+        double          vDown;              ///< meters/sec
+        double          aNorth;             ///< meters/sec^2
+        double          aEast;              ///< meters/sec^2
+        double          aDown;              ///< meters/sec^2
+        double          headingDegrees;     ///< NaN if not moving fast enough to know
+        double          groundSpeed;        ///< meters/sec
+    } State_t;
+
+    /// Feeds a new position fix into the estimator. Fixes without a valid timestamp or older than the last fix are ignored.
+    void update(const QGeoPositionInfo& positionInfo);
+
+    /// Extrapolates the estimated state to the specified time
+    ///     @param msecsSinceEpoch Time to predict for, prediction horizon is limited to maxPredictionMsecs past the last fix
+    ///     @return false: estimator has no position yet
+    bool predict(qint64 msecsSinceEpoch, State_t& state) const;
+
+    void    reset           (void);
+    bool    isValid         (void) const { return _fixCount > 0; }
+    int     fixCount        (void) const { return _fixCount; }
+    qint64  lastFixMsecs    (void) const { return _lastFixMsecs; }
+
+    /// @return Current estimated horizontal speed in meters/sec
+    double  groundSpeed     (void) const;
+
+    static constexpr double alpha               = 0.4;
+    static constexpr double beta                = 0.1;
+    static constexpr double gamma               = 0.01;
+    static constexpr double velocityGain        = 0.5;      ///< Weight of a measured velocity from the position source
+    static constexpr double maxAcceleration     = 5.0;      ///< meters/sec^2
+    static constexpr int    maxPredictionMsecs  = 1500;
+    static constexpr double minHeadingSpeed     = 1.0;      ///< meters/sec, below this the heading is considered unknown
+    static constexpr double maxOriginDistance   = 10000;    ///< meters, local origin is moved if the fix gets further away than this
+
+private:
+    void _filterAxis    (int axis, double measurement, double dt);
+
+    QGeoCoordinate  _origin;
+    bool            _hasAltitude    = false;
+    int             _fixCount       = 0;
+    qint64          _lastFixMsecs   = 0;
+    double          _pos[3]         = { 0, 0, 0 };  ///< NED meters from _origin
+    double          _vel[3]         = { 0, 0, 0 };
+    double          _accel[3]       = { 0, 0, 0 };
+    double          _sourceHeading  = qQNaN();
+};
@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FollowMeEstimatorTest.h"
+#include "FollowMeEstimator.h"
+#include "FollowMe.h"
+#include "SimulatedPosition.h"
+
+#include <QElapsedTimer>
+
+/// Replays the simulated track through an estimator. For each step the position predicted for the time of the next fix
+/// is compared against the true position at that time, as is the last raw (stale) fix which is what FollowMe used to send.
+///     @param[out] predictedError Mean error of the prediction in meters
+///     @param[out] rawError Mean error of the raw position in meters
+void FollowMeEstimatorTest::_replay(SimulatedPosition& simulatedPosition, int cSteps, int stepMsecs, double& predictedError, double& rawError)
+{
+    FollowMeEstimator   estimator;
+    QGeoPositionInfo    lastPositionInfo;
+    QElapsedTimer       timer;
+    qint64              updateNsecs = 0;
+    int                 cSamples    = 0;
+    const int           cWarmup     = 10;
+
+    QMetaObject::Connection connection = connect(&simulatedPosition, &SimulatedPosition::positionUpdated, this, [&](const QGeoPositionInfo& positionInfo) {
+        timer.start();
+        estimator.update(positionInfo);
+        updateNsecs += timer.nsecsElapsed();
+        lastPositionInfo = positionInfo;
+    });
+
+    predictedError = rawError = 0;
+    for (int i=0; i<cSteps; i++) {
+        FollowMeEstimator::State_t state;
+        bool havePrediction = estimator.predict(lastPositionInfo.timestamp().toMSecsSinceEpoch() + stepMsecs, state);
+
+        simulatedPosition.replayStep(stepMsecs);
+
+        if (i > cWarmup && havePrediction) {
+            QGeoCoordinate truePosition = simulatedPosition.truePosition();
+            predictedError  += state.coordinate.distanceTo(truePosition);
+            rawError        += lastPositionInfo.coordinate().distanceTo(truePosition);
+            cSamples++;
+        }
+        lastPositionInfo = simulatedPosition.lastKnownPosition();
+    }
+
+    disconnect(connection);
+
+    QVERIFY(cSamples > 0);
+    predictedError  /= cSamples;
+    rawError        /= cSamples;
+    qDebug() << "Mean error at" << stepMsecs << "msecs latency - predicted(m):raw(m):update(usecs)" << predictedError << rawError << (updateNsecs / cSteps) / 1000.0;
+}
+
+void FollowMeEstimatorTest::_straightLineTest(void)
+{
+    SimulatedPosition simulatedPosition;
+
+    simulatedPosition.setPosition(QGeoCoordinate(47.3977420, 8.5455941, 488), QDateTime::fromMSecsSinceEpoch(1600000000000));
+    simulatedPosition.setReportVelocity(false);
+    simulatedPosition.setMotion(90, 5, 0);
+    simulatedPosition.setPositionNoise(2, 1);
+
+    double predictedError, rawError;
+    _replay(simulatedPosition, 120, 1000, predictedError, rawError);
+
+    // Position only source: the estimator must both smooth the noise and make up for the fix being a second old
+    QVERIFY(predictedError < 2.0);
+    QVERIFY(predictedError < rawError / 2);
+}
+
+void FollowMeEstimatorTest::_turnTest(void)
+{
+    SimulatedPosition simulatedPosition;
+
+    simulatedPosition.setPosition(QGeoCoordinate(47.3977420, 8.5455941, 488), QDateTime::fromMSecsSinceEpoch(1600000000000));
+    simulatedPosition.setMotion(0, 8, 0, 6);
+    simulatedPosition.setPositionNoise(1, 2);
+
+    double predictedError, rawError;
+    _replay(simulatedPosition, 120, 500, predictedError, rawError);
+
+    QVERIFY(predictedError < rawError / 2);
+}
+
+void FollowMeEstimatorTest::_ignoreStaleTest(void)
+{
+    SimulatedPosition   simulatedPosition;
+    FollowMeEstimator   estimator;
+
+    simulatedPosition.setPosition(QGeoCoordinate(47.3977420, 8.5455941, 488), QDateTime::fromMSecsSinceEpoch(1600000000000));
+    simulatedPosition.setMotion(90, 5, 0);
+
+    QVERIFY(!estimator.isValid());
+    simulatedPosition.replayStep(1000);
+    QGeoPositionInfo positionInfo = simulatedPosition.lastKnownPosition();
+    estimator.update(positionInfo);
+    QCOMPARE(estimator.fixCount(), 1);
+
+    // Same fix again is ignored
+    estimator.update(positionInfo);
+    QCOMPARE(estimator.fixCount(), 1);
+
+    // Fix with no timestamp is ignored
+    QGeoPositionInfo noTimestamp(positionInfo.coordinate(), QDateTime());
+    estimator.update(noTimestamp);
+    QCOMPARE(estimator.fixCount(), 1);
+
+    simulatedPosition.replayStep(1000);
+    estimator.update(simulatedPosition.lastKnownPosition());
+    QCOMPARE(estimator.fixCount(), 2);
+
+    // Prediction horizon is limited
+    FollowMeEstimator::State_t state1, state2;
+    QVERIFY(estimator.predict(estimator.lastFixMsecs() + FollowMeEstimator::maxPredictionMsecs, state1));
+    QVERIFY(estimator.predict(estimator.lastFixMsecs() + FollowMeEstimator::maxPredictionMsecs * 10, state2));
+    QCOMPARE(state1.coordinate, state2.coordinate);
+
+    estimator.reset();
+    QVERIFY(!estimator.isValid());
+    QVERIFY(!estimator.predict(0, state1));
+}
+
+void FollowMeEstimatorTest::_motionReportTest(void)
+{
+    SimulatedPosition           simulatedPosition;
+    FollowMeEstimator           estimator;
+    FollowMe::GCSMotionReport   motionReport;
+
+    simulatedPosition.setPosition(QGeoCoordinate(47.3977420, 8.5455941, 488), QDateTime::fromMSecsSinceEpoch(1600000000000));
+    simulatedPosition.setMotion(90, 5, 0);
+
+    QCOMPARE(FollowMe::buildMotionReport(estimator, QGeoPositionInfo(), 0, motionReport), static_cast<uint8_t>(0));
+
+    simulatedPosition.replayStep(1000);
+    estimator.update(simulatedPosition.lastKnownPosition());
+    uint8_t capabilities = FollowMe::buildMotionReport(estimator, simulatedPosition.lastKnownPosition(), estimator.lastFixMsecs(), motionReport);
+    QCOMPARE(capabilities & (1 << FollowMe::POS), 1 << FollowMe::POS);
+    QCOMPARE(capabilities & (1 << FollowMe::VEL), 0);
+
+    for (int i=0; i<10; i++) {
+        simulatedPosition.replayStep(1000);
+        estimator.update(simulatedPosition.lastKnownPosition());
+    }
+
+    // Report is predicted ahead by the transport latency
+    capabilities = FollowMe::buildMotionReport(estimator, simulatedPosition.lastKnownPosition(), estimator.lastFixMsecs() + FollowMe::transportLatencyMsecs, motionReport);
+    QCOMPARE(capabilities & ((1 << FollowMe::POS) | (1 << FollowMe::VEL) | (1 << FollowMe::ACCEL) | (1 << FollowMe::HEADING)),
+             (1 << FollowMe::POS) | (1 << FollowMe::VEL) | (1 << FollowMe::ACCEL) | (1 << FollowMe::HEADING));
+    QVERIFY(qAbs(motionReport.headingDegrees - 90) < 5);
+    QVERIFY(qAbs(motionReport.vyMetersPerSec - 5) < 0.5);
+    QVERIFY(qAbs(motionReport.vxMetersPerSec) < 0.5);
+
+    QGeoCoordinate expected = simulatedPosition.truePosition().atDistanceAndAzimuth(5 * FollowMe::transportLatencyMsecs / 1000.0, 90);
+    QGeoCoordinate reported(motionReport.lat_int / 1e7, motionReport.lon_int / 1e7);
+    QVERIFY(reported.distanceTo(expected) < 0.5);
+}
+
+void FollowMeEstimatorTest::_sendIntervalTest(void)
+{
+    QCOMPARE(FollowMe::sendIntervalMsecs(0), 1000);
+    QCOMPARE(FollowMe::sendIntervalMsecs(-1), 1000);
+    QCOMPARE(FollowMe::sendIntervalMsecs(1), 500);
+    QCOMPARE(FollowMe::sendIntervalMsecs(4), 200);
+    QCOMPARE(FollowMe::sendIntervalMsecs(9), 100);
+    QCOMPARE(FollowMe::sendIntervalMsecs(50), 100);
+}
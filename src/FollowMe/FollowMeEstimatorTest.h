@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class SimulatedPosition;
+
+/// Tests FollowMeEstimator prediction against deterministic SimulatedPosition tracks
+class FollowMeEstimatorTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _straightLineTest  (void);
+    void _turnTest          (void);
+    void _ignoreStaleTest   (void);
+    void _motionReportTest  (void);
+    void _sendIntervalTest  (void);
+
+private:
+    void _replay(SimulatedPosition& simulatedPosition, int cSteps, int stepMsecs, double& predictedError, double& rawError);
+};
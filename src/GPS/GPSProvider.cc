@@ -14,6 +14,7 @@
 #include "SettingsManager.h"
 
 #define GPS_RECEIVE_TIMEOUT 1200
+#define GPS_WRITE_TIMEOUT   2000
 
 #include <QDebug>
 
@@ -42,6 +43,8 @@ void GPSProvider::run()
         delete[] fakeData;
 #endif /* SIMULATE_RTCM_OUTPUT */
 
+    delete _serialIO;
+    _serialIO = nullptr;
     if (_serial) delete _serial;
 
     _serial = new QSerialPort();
@@ -69,6 +72,8 @@ void GPSProvider::run()
     _serial->setStopBits(QSerialPort::OneStop);
     _serial->setFlowControl(QSerialPort::NoFlowControl);
 
+    _serialIO = new GPSSerialIO(_serial);
+
     unsigned int baudrate;
     GPSBaseStationSupport* gpsDriver = nullptr;
 
@@ -123,7 +128,7 @@ void GPSProvider::run()
                     ++numTries;
                 }
             }
-            if (_serial->error() != QSerialPort::NoError && _serial->error() != QSerialPort::TimeoutError) {
+            if (_serialIO->error()) {
                 break;
             }
         }
@@ -160,6 +165,7 @@ GPSProvider::GPSProvider(const QString& device,
 GPSProvider::~GPSProvider()
 {
     if (_pReportSatInfo) delete(_pReportSatInfo);
+    delete _serialIO;
     if (_serial) delete _serial;
 }
 
@@ -179,8 +185,11 @@ void GPSProvider::publishGPSSatellite()
 
 void GPSProvider::gotRTCMData(uint8_t* data, size_t len)
 {
+    // The message is complete with the data the driver read last, which gives the time it arrived from the base
+    const qint64 timestampUsecs = _serialIO ? _serialIO->lastReadUsecs() : GPSSerialIO::monotonicUsecs();
+
     QByteArray message((char*)data, static_cast<int>(len));
-    emit RTCMDataUpdate(message);
+    emit RTCMDataUpdate(message, timestampUsecs);
 }
 
 int GPSProvider::callbackEntry(GPSCallbackType type, void *data1, int data2, void *user)
@@ -193,19 +202,11 @@ int GPSProvider::callback(GPSCallbackType type, void *data1, int data2)
 {
     switch (type) {
         case GPSCallbackType::readDeviceData: {
-            if (_serial->bytesAvailable() == 0) {
-                int timeout = *((int *) data1);
-                if (!_serial->waitForReadyRead(timeout))
-                    return 0; //timeout
-            }
-            return (int)_serial->read((char*) data1, data2);
+            int timeout = *((int *) data1);
+            return _serialIO->read((char*) data1, data2, timeout);
         }
         case GPSCallbackType::writeDeviceData:
-            if (_serial->write((char*) data1, data2) >= 0) {
-                if (_serial->waitForBytesWritten(-1))
-                    return data2;
-            }
-            return -1;
+            return _serialIO->write((char*) data1, data2, GPS_WRITE_TIMEOUT);
 
         case GPSCallbackType::setBaudrate:
             return _serial->setBaudRate(data2) ? 0 : -1;
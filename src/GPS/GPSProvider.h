@@ -18,6 +18,7 @@
 #include <atomic>
 
 #include "GPSPositionMessage.h"
+#include "GPSSerialIO.h"
 #include "Drivers/src/gps_helper.h"
 
 
@@ -57,7 +58,7 @@ public:
 signals:
     void positionUpdate(GPSPositionMessage message);
     void satelliteInfoUpdate(GPSSatelliteMessage message);
-    void RTCMDataUpdate(QByteArray message);
+    void RTCMDataUpdate(QByteArray message, qint64 timestampUsecs);
     void surveyInStatus(float duration, float accuracyMM, double latitude, double longitude, float altitude, bool valid, bool active);
 
 protected:
@@ -89,4 +90,5 @@ private:
 	struct satellite_info_s    *_pReportSatInfo = nullptr;
 
 	QSerialPort *_serial = nullptr;
+	GPSSerialIO *_serialIO = nullptr;
 };
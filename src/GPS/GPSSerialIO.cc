@@ -0,0 +1,242 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+#include "GPSSerialIO.h"
+#include "QGCLoggingCategory.h"
+
+#include <QSerialPort>
+
+#include <chrono>
+#include <cstring>
+
+#if !defined(Q_OS_WIN)
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+constexpr int GPSSerialIO::defaultBufferSize;
+
+GPSSerialIO::GPSSerialIO(QSerialPort* port, int bufferSize)
+    : _port     (port)
+    , _buffer   (bufferSize, 0)
+{
+#if !defined(Q_OS_WIN)
+    _fd = static_cast<int>(port->handle());
+    ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) | O_NONBLOCK);
+#endif
+}
+
+#if !defined(Q_OS_WIN)
+GPSSerialIO::GPSSerialIO(int fd, int bufferSize)
+    : _fd       (fd)
+    , _buffer   (bufferSize, 0)
+{
+    ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) | O_NONBLOCK);
+}
+#endif
+
+qint64 GPSSerialIO::monotonicUsecs(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int GPSSerialIO::read(char* data, int maxLength, int timeoutMsecs)
+{
+    if (_error) {
+        return -1;
+    }
+    if (_count == 0) {
+        if (_waitAndFill(timeoutMsecs) < 0) {
+            return -1;
+        }
+    }
+    return _take(data, maxLength);
+}
+
+int GPSSerialIO::_take(char* data, int maxLength)
+{
+    const int size      = _buffer.size();
+    const int length    = qMin(maxLength, _count);
+    const int first     = qMin(length, size - _head);
+
+    memcpy(data, _buffer.constData() + _head, static_cast<size_t>(first));
+    memcpy(data + first, _buffer.constData(), static_cast<size_t>(length - first));
+
+    _head   = (_head + length) % size;
+    _count -= length;
+    if (length > 0) {
+        _lastReadUsecs = _fillUsecs;
+    }
+    return length;
+}
+
+/// Moves everything the device has ready into the free space of the ring buffer without blocking
+///     @return Number of bytes added, -1 on error
+int GPSSerialIO::_drain(void)
+{
+    const int size  = _buffer.size();
+    int drained     = 0;
+
+    while (_count < size) {
+        const int tail      = (_head + _count) % size;
+        const int length    = qMin(size - _count, size - tail);
+
+#if defined(Q_OS_WIN)
+        const qint64 cRead = _port->read(_buffer.data() + tail, length);
+        if (cRead < 0) {
+            qCWarning(RTKGPSLog) << "GPS: read failed" << _port->errorString();
+            _error = true;
+            return -1;
+        }
+#else
+        const ssize_t cRead = ::read(_fd, _buffer.data() + tail, static_cast<size_t>(length));
+        if (cRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            qCWarning(RTKGPSLog) << "GPS: read failed" << strerror(errno);
+            _error = true;
+            return -1;
+        }
+        if (cRead == 0) {
+            qCWarning(RTKGPSLog) << "GPS: device closed";
+            _error = true;
+            return -1;
+        }
+#endif
+        _count  += static_cast<int>(cRead);
+        drained += static_cast<int>(cRead);
+        if (cRead < length) {
+            break;
+        }
+    }
+
+    if (drained > 0) {
+        _fillUsecs = monotonicUsecs();
+    }
+    return drained;
+}
+
+/// Waits for the device to become readable and drains it into the ring buffer
+///     @return Number of bytes added, 0 on timeout, -1 on error
+int GPSSerialIO::_waitAndFill(int timeoutMsecs)
+{
+#if defined(Q_OS_WIN)
+    if (_port->bytesAvailable() == 0 && !_port->waitForReadyRead(timeoutMsecs)) {
+        if (_port->error() != QSerialPort::NoError && _port->error() != QSerialPort::TimeoutError) {
+            qCWarning(RTKGPSLog) << "GPS: wait for read failed" << _port->errorString();
+            _error = true;
+            return -1;
+        }
+        return 0;
+    }
+    return _drain();
+#else
+    const qint64 deadline = monotonicUsecs() + static_cast<qint64>(timeoutMsecs) * 1000;
+
+    while (true) {
+        const int remainingMsecs = static_cast<int>(qMax(0LL, (deadline - monotonicUsecs() + 999) / 1000));
+
+        struct pollfd pfd;
+        pfd.fd      = _fd;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+
+        const int ret = ::poll(&pfd, 1, remainingMsecs);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qCWarning(RTKGPSLog) << "GPS: poll failed" << strerror(errno);
+            _error = true;
+            return -1;
+        }
+        if (ret == 0) {
+            return 0;
+        }
+        if (pfd.revents & POLLIN) {
+            return _drain();
+        }
+        qCWarning(RTKGPSLog) << "GPS: device error or hangup";
+        _error = true;
+        return -1;
+    }
+#endif
+}
+
+int GPSSerialIO::write(const char* data, int length, int timeoutMsecs)
+{
+    if (_error) {
+        return -1;
+    }
+
+#if defined(Q_OS_WIN)
+    if (_port->write(data, length) != length || !_port->waitForBytesWritten(timeoutMsecs)) {
+        qCWarning(RTKGPSLog) << "GPS: write failed" << _port->errorString();
+        return -1;
+    }
+    return length;
+#else
+    const qint64 deadline = monotonicUsecs() + static_cast<qint64>(timeoutMsecs) * 1000;
+    int written = 0;
+
+    while (written < length) {
+        const ssize_t cWritten = ::write(_fd, data + written, static_cast<size_t>(length - written));
+        if (cWritten > 0) {
+            written += static_cast<int>(cWritten);
+            continue;
+        }
+        if (cWritten < 0 && errno == EINTR) {
+            continue;
+        }
+        if (cWritten < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            qCWarning(RTKGPSLog) << "GPS: write failed" << strerror(errno);
+            _error = true;
+            return -1;
+        }
+
+        // The device is not accepting data: wait for it, keeping up with its output meanwhile
+        const qint64 remainingUsecs = deadline - monotonicUsecs();
+        if (remainingUsecs <= 0) {
+            qCWarning(RTKGPSLog) << "GPS: write timed out with" << length - written << "of" << length << "bytes pending";
+            return -1;
+        }
+
+        struct pollfd pfd;
+        pfd.fd      = _fd;
+        pfd.events  = POLLOUT | (_count < _buffer.size() ? POLLIN : 0);
+        pfd.revents = 0;
+
+        const int ret = ::poll(&pfd, 1, static_cast<int>((remainingUsecs + 999) / 1000));
+        if (ret < 0 && errno != EINTR) {
+            qCWarning(RTKGPSLog) << "GPS: poll failed" << strerror(errno);
+            _error = true;
+            return -1;
+        }
+        if (ret > 0) {
+            if ((pfd.revents & POLLIN) && _drain() < 0) {
+                return -1;
+            }
+            if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) && !(pfd.revents & (POLLIN | POLLOUT))) {
+                qCWarning(RTKGPSLog) << "GPS: device error or hangup";
+                _error = true;
+                return -1;
+            }
+        }
+    }
+
+    return length;
+#endif
+}
@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+
+class QSerialPort;
+
+/**
+ ** class GPSSerialIO
+ * Non-blocking I/O between a GPS serial device and the GPS driver.
+ *
+ * Bytes read from the device are kept in a ring buffer which the driver reads from, so a single read on the
+ * device serves many small driver reads. Reads and writes are both bounded by a timeout: a wedged receiver
+ * can no longer hang the GPS thread. On unix the tty descriptor is polled directly, and input arriving while
+ * a write is waiting for the device is drained into the ring buffer so it does not pile up in the kernel.
+ * Elsewhere the QSerialPort waitFor calls are used.
+ */
+class GPSSerialIO
+{
+public:
+    GPSSerialIO(QSerialPort* port, int bufferSize = defaultBufferSize);
+#if !defined(Q_OS_WIN)
+    /// I/O on an already configured tty descriptor, the descriptor is not closed by GPSSerialIO
+    GPSSerialIO(int fd, int bufferSize = defaultBufferSize);
+#endif
+
+    /// Reads up to maxLength bytes, waiting at most timeoutMsecs for data if none is buffered
+    ///     @return Number of bytes read, 0 on timeout, -1 on error
+    int read(char* data, int maxLength, int timeoutMsecs);
+
+    /// Writes all of data, giving up if the device does not accept it within timeoutMsecs
+    ///     @return length on success, -1 on error or timeout
+    int write(const char* data, int length, int timeoutMsecs);
+
+    bool    error           (void) const { return _error; }
+    int     bytesAvailable  (void) const { return _count; }
+
+    /// @return Monotonic time in usecs at which the newest byte returned by read() was received from the device
+    qint64  lastReadUsecs   (void) const { return _lastReadUsecs; }
+
+    /// @return Monotonic time in usecs, comparable across threads
+    static qint64 monotonicUsecs(void);
+
+    static constexpr int defaultBufferSize = 4096;
+
+private:
+    int     _waitAndFill    (int timeoutMsecs);
+    int     _drain          (void);
+    int     _take           (char* data, int maxLength);
+
+    QSerialPort*    _port           = nullptr;
+    int             _fd             = -1;
+    QByteArray      _buffer;
+    int             _head           = 0;    ///< Index of the oldest buffered byte
+    int             _count          = 0;    ///< Number of buffered bytes
+    bool            _error          = false;
+    qint64          _fillUsecs      = 0;    ///< Time of the last device read which returned data
+    qint64          _lastReadUsecs  = 0;
+};
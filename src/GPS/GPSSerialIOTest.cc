@@ -0,0 +1,302 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GPSSerialIOTest.h"
+#include "GPSSerialIO.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <thread>
+#endif
+
+static QByteArray _ubxFrame(uint8_t msgClass, uint8_t msgId, const QByteArray& payload)
+{
+    QByteArray frame;
+
+    frame.append(static_cast<char>(0xB5)).append(static_cast<char>(0x62));
+    frame.append(static_cast<char>(msgClass)).append(static_cast<char>(msgId));
+    frame.append(static_cast<char>(payload.size() & 0xFF)).append(static_cast<char>(payload.size() >> 8));
+    frame.append(payload);
+
+    uint8_t ckA = 0;
+    uint8_t ckB = 0;
+    for (int i=2; i<frame.size(); i++) {
+        ckA += static_cast<uint8_t>(frame[i]);
+        ckB += ckA;
+    }
+    frame.append(static_cast<char>(ckA)).append(static_cast<char>(ckB));
+
+    return frame;
+}
+
+static QByteArray _nmeaSentence(const QByteArray& body)
+{
+    uint8_t checksum = 0;
+    for (char c: body) {
+        checksum ^= static_cast<uint8_t>(c);
+    }
+    return "$" + body + "*" + QByteArray::number(checksum, 16).rightJustified(2, '0').toUpper() + "\r\n";
+}
+
+/// @return Number of UBX frames with a valid checksum in stream
+static int _countUbxFrames(const QByteArray& stream)
+{
+    int count = 0;
+    int i = 0;
+    while (i + 8 <= stream.size()) {
+        if (static_cast<uint8_t>(stream[i]) != 0xB5 || static_cast<uint8_t>(stream[i + 1]) != 0x62) {
+            i++;
+            continue;
+        }
+        const int length = static_cast<uint8_t>(stream[i + 4]) | (static_cast<uint8_t>(stream[i + 5]) << 8);
+        if (i + 8 + length > stream.size()) {
+            break;
+        }
+        const QByteArray frame = stream.mid(i, 8 + length);
+        if (_ubxFrame(static_cast<uint8_t>(frame[2]), static_cast<uint8_t>(frame[3]), frame.mid(6, length)) == frame) {
+            count++;
+            i += frame.size();
+        } else {
+            i++;
+        }
+    }
+    return count;
+}
+
+/// @return Number of NMEA sentences with a valid checksum in stream
+static int _countNmeaSentences(const QByteArray& stream)
+{
+    int count = 0;
+    for (const QByteArray& line: stream.split('\n')) {
+        const int star = line.lastIndexOf('*');
+        if (line.startsWith('$') && star > 0 && _nmeaSentence(line.mid(1, star - 1)) == line + "\n") {
+            count++;
+        }
+    }
+    return count;
+}
+
+void GPSSerialIOTest::init(void)
+{
+    UnitTest::init();
+
+#if defined(Q_OS_UNIX)
+    _master = ::posix_openpt(O_RDWR | O_NOCTTY);
+    QVERIFY(_master >= 0);
+    QCOMPARE(::grantpt(_master), 0);
+    QCOMPARE(::unlockpt(_master), 0);
+
+    _slave = ::open(::ptsname(_master), O_RDWR | O_NOCTTY);
+    QVERIFY(_slave >= 0);
+
+    // The receiver talks binary, no line discipline in the way
+    struct termios tio;
+    QCOMPARE(::tcgetattr(_slave, &tio), 0);
+    ::cfmakeraw(&tio);
+    QCOMPARE(::tcsetattr(_slave, TCSANOW, &tio), 0);
+#endif
+}
+
+void GPSSerialIOTest::cleanup(void)
+{
+#if defined(Q_OS_UNIX)
+    if (_slave >= 0) {
+        ::close(_slave);
+    }
+    if (_master >= 0) {
+        ::close(_master);
+    }
+#endif
+    _slave  = -1;
+    _master = -1;
+
+    UnitTest::cleanup();
+}
+
+/// Writes the stream from the receiver side in irregular chunks and reads it back through GPSSerialIO in small
+/// pieces, the way the drivers do
+void GPSSerialIOTest::_streamTest(const QByteArray& stream, int bufferSize)
+{
+#if defined(Q_OS_UNIX)
+    GPSSerialIO io(_slave, bufferSize);
+
+    std::thread writer([this, &stream]() {
+        int written = 0;
+        int chunk   = 0;
+        while (written < stream.size()) {
+            const int length = qMin(stream.size() - written, 1 + (chunk++ * 37) % 300);
+            const ssize_t cWritten = ::write(_master, stream.constData() + written, static_cast<size_t>(length));
+            if (cWritten <= 0) {
+                return;
+            }
+            written += static_cast<int>(cWritten);
+            if (chunk % 8 == 0) {
+                QThread::usleep(500);
+            }
+        }
+    });
+
+    QByteArray  received;
+    bool        readFailed      = false;
+    bool        timestampsValid = true;
+    qint64      lastReadUsecs   = 0;
+    int         cReads          = 0;
+    char        data[64];
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!readFailed && received.size() < stream.size() && timer.elapsed() < 10000) {
+        const int cRead = io.read(data, 1 + (cReads++ % static_cast<int>(sizeof(data))), 100);
+        if (cRead < 0) {
+            readFailed = true;
+        } else if (cRead > 0) {
+            timestampsValid &= io.lastReadUsecs() >= lastReadUsecs && io.lastReadUsecs() <= GPSSerialIO::monotonicUsecs();
+            lastReadUsecs = io.lastReadUsecs();
+            received.append(data, cRead);
+        }
+    }
+
+    // Unblock the writer if the stream was not read completely
+    if (received.size() < stream.size()) {
+        ::close(_slave);
+        _slave = -1;
+    }
+    writer.join();
+
+    QVERIFY(!readFailed);
+    QVERIFY(timestampsValid);
+    QCOMPARE(received.size(), stream.size());
+    QVERIFY(received == stream);
+#else
+    Q_UNUSED(stream)
+    Q_UNUSED(bufferSize)
+#endif
+}
+
+void GPSSerialIOTest::_ubloxStreamTest(void)
+{
+#if defined(Q_OS_UNIX)
+    const int cEpochs = 200;
+
+    // NAV-PVT and NAV-SVINFO each epoch, with the odd byte of noise between frames as seen at startup
+    QByteArray stream;
+    for (int epoch=0; epoch<cEpochs; epoch++) {
+        QByteArray pvt(92, 0);
+        for (int i=0; i<pvt.size(); i++) {
+            pvt[i] = static_cast<char>(epoch + i);
+        }
+        stream.append(_ubxFrame(0x01, 0x07, pvt));
+        stream.append(_ubxFrame(0x01, 0x30, QByteArray(8 + 12 * (epoch % 20), static_cast<char>(epoch))));
+        if (epoch % 10 == 0) {
+            stream.append(static_cast<char>(0xB5));
+        }
+    }
+
+    // A buffer smaller than a frame forces the ring to wrap on nearly every fill
+    _streamTest(stream, 61);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QCOMPARE(_countUbxFrames(stream), 2 * cEpochs);
+#else
+    QSKIP("Simulated receiver requires a pseudo terminal");
+#endif
+}
+
+void GPSSerialIOTest::_trimbleStreamTest(void)
+{
+#if defined(Q_OS_UNIX)
+    const int cEpochs = 500;
+
+    QByteArray stream;
+    for (int epoch=0; epoch<cEpochs; epoch++) {
+        stream.append(_nmeaSentence(QStringLiteral("GPGGA,%1.00,4717.11399,N,00833.91590,E,4,12,0.8,499.6,M,48.0,M,1.0,0000").arg(120000 + epoch).toLatin1()));
+        stream.append(_nmeaSentence(QStringLiteral("PASHR,POS,3,12,%1.00,4717.11399,N,00833.91590,E,499.6,,0.0,0.0,0.0,0.8,0.6,0.5,0.4,P-1").arg(120000 + epoch).toLatin1()));
+    }
+
+    _streamTest(stream, GPSSerialIO::defaultBufferSize);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QCOMPARE(_countNmeaSentences(stream), 2 * cEpochs);
+#else
+    QSKIP("Simulated receiver requires a pseudo terminal");
+#endif
+}
+
+void GPSSerialIOTest::_readTimeoutTest(void)
+{
+#if defined(Q_OS_UNIX)
+    GPSSerialIO io(_slave);
+    char data[16];
+
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(io.read(data, static_cast<int>(sizeof(data)), 50), 0);
+    QVERIFY(timer.elapsed() >= 40);
+    QVERIFY(timer.elapsed() < 1000);
+    QVERIFY(!io.error());
+#else
+    QSKIP("Simulated receiver requires a pseudo terminal");
+#endif
+}
+
+void GPSSerialIOTest::_writeTimeoutTest(void)
+{
+#if defined(Q_OS_UNIX)
+    GPSSerialIO io(_slave);
+
+    // The receiver sends a sentence but never reads what is written to it
+    const QByteArray sentence = _nmeaSentence("GPGGA,120000.00,4717.11399,N,00833.91590,E,4,12,0.8,499.6,M,48.0,M,1.0,0000");
+    QCOMPARE(::write(_master, sentence.constData(), static_cast<size_t>(sentence.size())), static_cast<ssize_t>(sentence.size()));
+
+    const QByteArray config(1024 * 1024, static_cast<char>(0x55));
+
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(io.write(config.constData(), config.size(), 200), -1);
+    QVERIFY(timer.elapsed() >= 150);
+    QVERIFY(timer.elapsed() < 2000);
+    QVERIFY(!io.error());
+
+    // Input arriving while the write was stuck has been buffered
+    QCOMPARE(io.bytesAvailable(), sentence.size());
+    char data[256];
+    QCOMPARE(io.read(data, static_cast<int>(sizeof(data)), 0), sentence.size());
+    QVERIFY(QByteArray(data, sentence.size()) == sentence);
+#else
+    QSKIP("Simulated receiver requires a pseudo terminal");
+#endif
+}
+
+void GPSSerialIOTest::_hangupTest(void)
+{
+#if defined(Q_OS_UNIX)
+    GPSSerialIO io(_slave);
+
+    ::close(_master);
+    _master = -1;
+
+    char data[16];
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(io.read(data, static_cast<int>(sizeof(data)), 1000), -1);
+    QVERIFY(timer.elapsed() < 500);
+    QVERIFY(io.error());
+    QCOMPARE(io.write(data, static_cast<int>(sizeof(data)), 100), -1);
+#else
+    QSKIP("Simulated receiver requires a pseudo terminal");
+#endif
+}
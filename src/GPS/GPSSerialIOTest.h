@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Tests GPSSerialIO against simulated u-blox and Trimble receivers on a pseudo terminal
+class GPSSerialIOTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init               (void);
+    void cleanup            (void);
+
+    void _ubloxStreamTest   (void);
+    void _trimbleStreamTest (void);
+    void _readTimeoutTest   (void);
+    void _writeTimeoutTest  (void);
+    void _hangupTest        (void);
+
+private:
+    void _streamTest(const QByteArray& stream, int bufferSize);
+
+    int _master = -1;   ///< Receiver side of the pty
+    int _slave  = -1;   ///< GPS side of the pty, used by GPSSerialIO
+};
@@ -9,11 +9,12 @@
 
 
 #include "RTCMMavlink.h"
+#include "GPSSerialIO.h"
 
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
 
-#include <cstdio>
+QGC_LOGGING_CATEGORY(RTCMMavlinkLog, "RTCMMavlinkLog")
 
 RTCMMavlink::RTCMMavlink(QGCToolbox& toolbox)
     : _toolbox(toolbox)
@@ -21,15 +22,25 @@ RTCMMavlink::RTCMMavlink(QGCToolbox& toolbox)
     _bandwidthTimer.start();
 }
 
-void RTCMMavlink::RTCMDataUpdate(QByteArray message)
+void RTCMMavlink::RTCMDataUpdate(QByteArray message, qint64 timestampUsecs)
 {
     /* statistics */
+    // Age is the time from the message arriving from the base until it is handed to the vehicle links
+    const qint64 ageUsecs = GPSSerialIO::monotonicUsecs() - timestampUsecs;
+    _ageSumUsecs += ageUsecs;
+    _ageMaxUsecs = std::max(_ageMaxUsecs, ageUsecs);
+    _ageMessageCounter++;
+
     _bandwidthByteCounter += message.size();
     qint64 elapsed = _bandwidthTimer.elapsed();
     if (elapsed > 1000) {
-        printf("RTCM bandwidth: %.2f kB/s\n", (float) _bandwidthByteCounter / elapsed * 1000.f / 1024.f);
+        qCDebug(RTCMMavlinkLog) << "RTCM bandwidth:" << static_cast<double>(_bandwidthByteCounter) / elapsed * 1000.0 / 1024.0 << "kB/s,"
+                                << "age avg:" << _ageSumUsecs / 1000.0 / _ageMessageCounter << "ms max:" << _ageMaxUsecs / 1000.0 << "ms";
         _bandwidthTimer.restart();
         _bandwidthByteCounter = 0;
+        _ageMessageCounter = 0;
+        _ageSumUsecs = 0;
+        _ageMaxUsecs = 0;
     }
 
     const int maxMessageLength = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
@@ -15,6 +15,9 @@
 
 #include "QGCToolbox.h"
 #include "MAVLinkProtocol.h"
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(RTCMMavlinkLog)
 
 /**
  ** class RTCMMavlink
@@ -28,7 +31,8 @@ public:
     //TODO: API to select device(s)?
 
 public slots:
-    void RTCMDataUpdate(QByteArray message);
+    /// @param timestampUsecs GPSSerialIO::monotonicUsecs() time at which the message was received from the base
+    void RTCMDataUpdate(QByteArray message, qint64 timestampUsecs);
 
 private:
     void sendMessageToVehicle(const mavlink_gps_rtcm_data_t& msg);
@@ -36,5 +40,8 @@ private:
     QGCToolbox& _toolbox;
     QElapsedTimer _bandwidthTimer;
     int _bandwidthByteCounter = 0;
+    int _ageMessageCounter = 0;
+    qint64 _ageSumUsecs = 0;
+    qint64 _ageMaxUsecs = 0;
     uint8_t _sequenceId = 0;
 };
@@ -9,6 +9,7 @@
 
 #include <QDebug>
 #include <QString>
+#include <QVector>
 
 #include <cmath>
 #include <limits>
@@ -24,60 +25,75 @@
 
 static const double epsilon = std::numeric_limits<double>::epsilon();
 
-void convertGeoToNed(QGeoCoordinate coord, QGeoCoordinate origin, double* x, double* y, double* z)
+QGCGeoTangentOrigin_t geoTangentOrigin(const QGeoCoordinate& origin)
 {
-    if (coord == origin) {
+    QGCGeoTangentOrigin_t tangentOrigin;
+
+    tangentOrigin.latRad    = origin.latitude() * M_DEG_TO_RAD;
+    tangentOrigin.lonRad    = origin.longitude() * M_DEG_TO_RAD;
+    tangentOrigin.sinLat    = sin(tangentOrigin.latRad);
+    tangentOrigin.cosLat    = cos(tangentOrigin.latRad);
+    tangentOrigin.altitude  = origin.altitude();
+
+    return tangentOrigin;
+}
+
+// Shared by the single coordinate and batch conversions such that both produce the same results
+static inline void _geoToNed(const QGCGeoTangentOrigin_t& origin, double lat_rad, double lon_rad, double& x, double& y)
+{
+    if (lat_rad == origin.latRad && lon_rad == origin.lonRad) {
         // Short circuit to prevent NaNs in calculation
-        *x = *y = *z = 0;
+        x = y = 0;
         return;
     }
 
-    double lat_rad = coord.latitude() * M_DEG_TO_RAD;
-    double lon_rad = coord.longitude() * M_DEG_TO_RAD;
-
-    double ref_lon_rad = origin.longitude() * M_DEG_TO_RAD;
-    double ref_lat_rad = origin.latitude() * M_DEG_TO_RAD;
-
     double sin_lat = sin(lat_rad);
     double cos_lat = cos(lat_rad);
-    double cos_d_lon = cos(lon_rad - ref_lon_rad);
+    double cos_d_lon = cos(lon_rad - origin.lonRad);
 
-    double ref_sin_lat = sin(ref_lat_rad);
-    double ref_cos_lat = cos(ref_lat_rad);
-
-    double c = acos(ref_sin_lat * sin_lat + ref_cos_lat * cos_lat * cos_d_lon);
+    double c = acos(origin.sinLat * sin_lat + origin.cosLat * cos_lat * cos_d_lon);
     double k = (fabs(c) < epsilon) ? 1.0 : (c / sin(c));
 
-    *x = k * (ref_cos_lat * sin_lat - ref_sin_lat * cos_lat * cos_d_lon) * CONSTANTS_RADIUS_OF_EARTH;
-    *y = k * cos_lat * sin(lon_rad - ref_lon_rad) * CONSTANTS_RADIUS_OF_EARTH;
-
-    *z = -(coord.altitude() - origin.altitude());
+    x = k * (origin.cosLat * sin_lat - origin.sinLat * cos_lat * cos_d_lon) * CONSTANTS_RADIUS_OF_EARTH;
+    y = k * cos_lat * sin(lon_rad - origin.lonRad) * CONSTANTS_RADIUS_OF_EARTH;
 }
 
-void convertNedToGeo(double x, double y, double z, QGeoCoordinate origin, QGeoCoordinate *coord) {
+static inline void _nedToGeo(const QGCGeoTangentOrigin_t& origin, double x, double y, double& lat_rad, double& lon_rad)
+{
     double x_rad = x / CONSTANTS_RADIUS_OF_EARTH;
     double y_rad = y / CONSTANTS_RADIUS_OF_EARTH;
     double c = sqrt(x_rad * x_rad + y_rad * y_rad);
-    double sin_c = sin(c);
-    double cos_c = cos(c);
 
-    double ref_lon_rad = origin.longitude() * M_DEG_TO_RAD;
-    double ref_lat_rad = origin.latitude() * M_DEG_TO_RAD;
+    if (fabs(c) > epsilon) {
+        double sin_c = sin(c);
+        double cos_c = cos(c);
 
-    double ref_sin_lat = sin(ref_lat_rad);
-    double ref_cos_lat = cos(ref_lat_rad);
+        lat_rad = asin(cos_c * origin.sinLat + (x_rad * sin_c * origin.cosLat) / c);
+        lon_rad = (origin.lonRad + atan2(y_rad * sin_c, c * origin.cosLat * cos_c - x_rad * origin.sinLat * sin_c));
+    } else {
+        lat_rad = origin.latRad;
+        lon_rad = origin.lonRad;
+    }
+}
 
+void convertGeoToNed(QGeoCoordinate coord, QGeoCoordinate origin, double* x, double* y, double* z)
+{
+    if (coord == origin) {
+        // Short circuit to prevent NaNs in calculation
+        *x = *y = *z = 0;
+        return;
+    }
+
+    _geoToNed(geoTangentOrigin(origin), coord.latitude() * M_DEG_TO_RAD, coord.longitude() * M_DEG_TO_RAD, *x, *y);
+
+    *z = -(coord.altitude() - origin.altitude());
+}
+
+void convertNedToGeo(double x, double y, double z, QGeoCoordinate origin, QGeoCoordinate *coord) {
     double lat_rad;
     double lon_rad;
 
-    if (fabs(c) > epsilon) {
-        lat_rad = asin(cos_c * ref_sin_lat + (x_rad * sin_c * ref_cos_lat) / c);
-        lon_rad = (ref_lon_rad + atan2(y_rad * sin_c, c * ref_cos_lat * cos_c - x_rad * ref_sin_lat * sin_c));
-
-    } else {
-        lat_rad = ref_lat_rad;
-        lon_rad = ref_lon_rad;
-    }
+    _nedToGeo(geoTangentOrigin(origin), x, y, lat_rad, lon_rad);
 
     coord->setLatitude(lat_rad * M_RAD_TO_DEG);
     coord->setLongitude(lon_rad * M_RAD_TO_DEG);
@@ -85,6 +101,80 @@ void convertNedToGeo(double x, double y, double z, QGeoCoordinate origin, QGeoCo
     coord->setAltitude(-z + origin.altitude());
 }
 
+void convertGeoToNed(const QGCGeoTangentOrigin_t& origin, const double* lat, const double* lon, const double* alt, double* x, double* y, double* z, int count)
+{
+    for (int i=0; i<count; i++) {
+        _geoToNed(origin, lat[i] * M_DEG_TO_RAD, lon[i] * M_DEG_TO_RAD, x[i], y[i]);
+    }
+    if (alt && z) {
+        for (int i=0; i<count; i++) {
+            z[i] = -(alt[i] - origin.altitude);
+        }
+    }
+}
+
+void convertNedToGeo(const QGCGeoTangentOrigin_t& origin, const double* x, const double* y, const double* z, double* lat, double* lon, double* alt, int count)
+{
+    for (int i=0; i<count; i++) {
+        _nedToGeo(origin, x[i], y[i], lat[i], lon[i]);
+        lat[i] *= M_RAD_TO_DEG;
+        lon[i] *= M_RAD_TO_DEG;
+    }
+    if (z && alt) {
+        for (int i=0; i<count; i++) {
+            alt[i] = -z[i] + origin.altitude;
+        }
+    }
+}
+
+QList<QPointF> convertGeoToNed(const QList<QGeoCoordinate>& coords, const QGeoCoordinate& origin)
+{
+    const int       count = coords.count();
+    QVector<double> lat(count);
+    QVector<double> lon(count);
+    QVector<double> north(count);
+    QVector<double> east(count);
+
+    for (int i=0; i<count; i++) {
+        lat[i] = coords[i].latitude();
+        lon[i] = coords[i].longitude();
+    }
+
+    convertGeoToNed(geoTangentOrigin(origin), lat.constData(), lon.constData(), nullptr, north.data(), east.data(), nullptr, count);
+
+    QList<QPointF> points;
+    points.reserve(count);
+    for (int i=0; i<count; i++) {
+        points.append(QPointF(east[i], north[i]));
+    }
+
+    return points;
+}
+
+QList<QGeoCoordinate> convertNedToGeo(const QList<QPointF>& points, const QGeoCoordinate& origin)
+{
+    const int       count = points.count();
+    QVector<double> north(count);
+    QVector<double> east(count);
+    QVector<double> lat(count);
+    QVector<double> lon(count);
+
+    for (int i=0; i<count; i++) {
+        north[i]    = points[i].y();
+        east[i]     = points[i].x();
+    }
+
+    convertNedToGeo(geoTangentOrigin(origin), north.constData(), east.constData(), nullptr, lat.data(), lon.data(), nullptr, count);
+
+    QList<QGeoCoordinate> coords;
+    coords.reserve(count);
+    for (int i=0; i<count; i++) {
+        coords.append(QGeoCoordinate(lat[i], lon[i], origin.altitude()));
+    }
+
+    return coords;
+}
+
 int convertGeoToUTM(const QGeoCoordinate& coord, double& easting, double& northing)
 {
     try {
@@ -111,20 +201,26 @@ bool convertUTMToGeo(double easting, double northing, int zone, bool southhemi,
     return true;
 }
 
-QString convertGeoToMGRS(const QGeoCoordinate& coord)
+int convertGeoToUTM(const double* lat, const double* lon, double* easting, double* northing, int* zone, int count)
 {
-    int zone;
-    bool northp;
-    double x, y;
-    std::string mgrs;
+    int cFailed = 0;
 
-    try {
-        GeographicLib::UTMUPS::Forward(coord.latitude(), coord.longitude(), zone, northp, x, y);
-        GeographicLib::MGRS::Forward(zone, northp, x, y, coord.latitude(), 5, mgrs);
-    } catch(...) {
-        mgrs = "";
+    for (int i=0; i<count; i++) {
+        try {
+            bool northp;
+            GeographicLib::UTMUPS::Forward(lat[i], lon[i], zone[i], northp, easting[i], northing[i]);
+        } catch(...) {
+            zone[i] = 0;
+            cFailed++;
+        }
     }
 
+    return cFailed;
+}
+
+// Splits the MGRS string into "<zone/square> <easting> <northing>"
+static QString _formatMGRS(const std::string& mgrs)
+{
     QString qstr = QString::fromStdString(mgrs);
     for (int i = qstr.length() - 1; i >= 0; i--) {
         if (!qstr.at(i).isDigit()) {
@@ -136,6 +232,40 @@ QString convertGeoToMGRS(const QGeoCoordinate& coord)
     return qstr;
 }
 
+static std::string _geoToMGRS(double lat, double lon)
+{
+    int zone;
+    bool northp;
+    double x, y;
+    std::string mgrs;
+
+    try {
+        GeographicLib::UTMUPS::Forward(lat, lon, zone, northp, x, y);
+        GeographicLib::MGRS::Forward(zone, northp, x, y, lat, 5, mgrs);
+    } catch(...) {
+        mgrs = "";
+    }
+
+    return mgrs;
+}
+
+QString convertGeoToMGRS(const QGeoCoordinate& coord)
+{
+    return _formatMGRS(_geoToMGRS(coord.latitude(), coord.longitude()));
+}
+
+QStringList convertGeoToMGRS(const double* lat, const double* lon, int count)
+{
+    QStringList rgMGRS;
+
+    rgMGRS.reserve(count);
+    for (int i=0; i<count; i++) {
+        rgMGRS.append(_formatMGRS(_geoToMGRS(lat[i], lon[i])));
+    }
+
+    return rgMGRS;
+}
+
 bool convertMGRSToGeo(QString mgrs, QGeoCoordinate& coord)
 {
     int zone, prec;
@@ -19,6 +19,9 @@
 #define QGCGEO_H
 
 #include <QGeoCoordinate>
+#include <QList>
+#include <QPointF>
+#include <QStringList>
 
 /**
  * @brief Project a geodetic coordinate on to local tangential plane (LTP) as coordinate with East,
@@ -105,4 +108,50 @@ QString convertGeoToMGRS(const QGeoCoordinate& coord);
 // The function returns true if conversion succeeded.
 bool convertMGRSToGeo(QString mgrs, QGeoCoordinate& coord);
 
+// Batch conversion functions
+//
+// The functions below work on structure-of-arrays input/output (separate latitude, longitude, altitude arrays) of
+// count elements. They are intended for the planners which convert whole polygons or transect sets at once. The
+// reference point trigonometry is only done once per call and the inner loops only touch contiguous double arrays,
+// which keeps them free of QGeoCoordinate accessors and friendly to auto-vectorization. Results match the single
+// coordinate versions above.
+
+/// Local tangent plane origin with the reference point trigonometry precomputed
+typedef struct {
+    double latRad;
+    double lonRad;
+    double sinLat;
+    double cosLat;
+    double altitude;
+} QGCGeoTangentOrigin_t;
+
+QGCGeoTangentOrigin_t geoTangentOrigin(const QGeoCoordinate& origin);
+
+/// Batch version of convertGeoToNed.
+///     @param alt Altitudes in meters, may be nullptr in which case z is not written
+///     @param z Down component, may be nullptr
+void convertGeoToNed(const QGCGeoTangentOrigin_t& origin, const double* lat, const double* lon, const double* alt, double* x, double* y, double* z, int count);
+
+/// Batch version of convertNedToGeo.
+///     @param z Down component in meters, may be nullptr in which case alt is not written
+///     @param alt Altitudes, may be nullptr
+void convertNedToGeo(const QGCGeoTangentOrigin_t& origin, const double* x, const double* y, const double* z, double* lat, double* lon, double* alt, int count);
+
+/// Converts a list of coordinates to 2D points on the local tangent plane at origin. Altitude is ignored.
+///     @return Points as QPointF(east, north) in meters
+QList<QPointF> convertGeoToNed(const QList<QGeoCoordinate>& coords, const QGeoCoordinate& origin);
+
+/// Converts a list of 2D points on the local tangent plane at origin back to coordinates. Altitude is set to the origin altitude.
+///     @param points Points as QPointF(east, north) in meters
+QList<QGeoCoordinate> convertNedToGeo(const QList<QPointF>& points, const QGeoCoordinate& origin);
+
+/// Batch version of convertGeoToUTM. Each point uses its own standard zone.
+///     @param zone Array to hold the zone for each point, 0 if the conversion of that point failed
+///     @return Number of points which failed conversion
+int convertGeoToUTM(const double* lat, const double* lon, double* easting, double* northing, int* zone, int count);
+
+/// Batch version of convertGeoToMGRS.
+///     @return MGRS strings, empty string for points which failed conversion
+QStringList convertGeoToMGRS(const double* lat, const double* lon, int count);
+
 #endif // QGCGEO_H
@@ -33,6 +33,8 @@
 #include "TakeoffMissionItem.h"
 #include "PlanViewSettings.h"
 
+#include <QElapsedTimer>
+
 #define UPDATE_TIMEOUT 5000 ///< How often we check for bounding box changes
 
 QGC_LOGGING_CATEGORY(MissionControllerLog, "MissionControllerLog")
@@ -709,7 +711,20 @@ bool MissionController::_loadJsonMissionFileV1(const QJsonObject& json, QmlObjec
 
 bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString)
 {
-    // Validate root object keys
+    JsonLoadState_t loadState;
+
+    if (_loadJsonMissionFileV2Start(json, visualItems, loadState, errorString) &&
+            _loadJsonMissionFileV2Items(loadState, -1 /* all items */, errorString) &&
+            _loadJsonMissionFileV2Finish(loadState, errorString)) {
+        return true;
+    }
+    _revertJsonLoadControllerVehicle(loadState);
+
+    return false;
+}
+
+bool MissionController::_validateJsonMissionRootKeys(const QJsonObject& json, QString& errorString)
+{
     QList<JsonHelper::KeyValidateInfo> rootKeyInfoList = {
         { _jsonPlannedHomePositionKey,      QJsonValue::Array,  true },
         { _jsonItemsKey,                    QJsonValue::Array,  true },
@@ -719,60 +734,119 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
         { _jsonHoverSpeedKey,               QJsonValue::Double, false },
         { _jsonGlobalPlanAltitudeModeKey,   QJsonValue::Double, false },
     };
-    if (!JsonHelper::validateKeys(json, rootKeyInfoList, errorString)) {
+    return JsonHelper::validateKeys(json, rootKeyInfoList, errorString);
+}
+
+/// Validates the root keys and item types of a V2 mission json object without creating any items. Safe to call from any
+/// thread.
+bool MissionController::validateJsonMission(const QJsonObject& json, QString& errorString)
+{
+    if (!_validateJsonMissionRootKeys(json, errorString)) {
         return false;
     }
 
-    setGlobalAltitudeMode(QGroundControlQmlGlobal::AltitudeModeNone);   // Mixed mode
-
-    qCDebug(MissionControllerLog) << "MissionController::_loadJsonMissionFileV2 itemCount:" << json[_jsonItemsKey].toArray().count();
-
-    AppSettings* appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
+    const QJsonArray rgMissionItems(json[_jsonItemsKey].toArray());
+    for (int i=0; i<rgMissionItems.count(); i++) {
+        const QJsonValue& itemValue = rgMissionItems[i];
+        if (!itemValue.isObject()) {
+            errorString = tr("Mission item %1 is not an object").arg(i);
+            return false;
+        }
+        const QJsonObject itemObject = itemValue.toObject();
 
-    // Get the firmware/vehicle type from the plan file
-    MAV_AUTOPILOT   planFileFirmwareType =  static_cast<MAV_AUTOPILOT>(json[_jsonFirmwareTypeKey].toInt());
-    MAV_TYPE        planFileVehicleType =   static_cast<MAV_TYPE>     (QGCMAVLink::vehicleClassToMavType(appSettings->offlineEditingVehicleClass()->rawValue().toInt()));
-    if (json.contains(_jsonVehicleTypeKey)) {
-        planFileVehicleType = static_cast<MAV_TYPE>(json[_jsonVehicleTypeKey].toInt());
-    }
+        QList<JsonHelper::KeyValidateInfo> itemKeyInfoList = {
+            { VisualMissionItem::jsonTypeKey,  QJsonValue::String, true },
+        };
+        if (!JsonHelper::validateKeys(itemObject, itemKeyInfoList, errorString)) {
+            return false;
+        }
+        QString itemType = itemObject[VisualMissionItem::jsonTypeKey].toString();
 
-    // Update firmware/vehicle offline settings if we aren't connect to a vehicle
-    if (_masterController->offline()) {
-        appSettings->offlineEditingFirmwareClass()->setRawValue(QGCMAVLink::firmwareClass(static_cast<MAV_AUTOPILOT>(json[_jsonFirmwareTypeKey].toInt())));
-        if (json.contains(_jsonVehicleTypeKey)) {
-            appSettings->offlineEditingVehicleClass()->setRawValue(QGCMAVLink::vehicleClass(planFileVehicleType));
+        if (itemType == VisualMissionItem::jsonTypeComplexItemValue) {
+            QList<JsonHelper::KeyValidateInfo> complexItemKeyInfoList = {
+                { ComplexMissionItem::jsonComplexItemTypeKey,  QJsonValue::String, true },
+            };
+            if (!JsonHelper::validateKeys(itemObject, complexItemKeyInfoList, errorString)) {
+                return false;
+            }
+        } else if (itemType != VisualMissionItem::jsonTypeSimpleItemValue) {
+            errorString = tr("Unknown item type: %1").arg(itemType);
+            return false;
         }
     }
 
-    // The controller vehicle always tracks the Plan file firmware/vehicle types so update it
-    _controllerVehicle->stopTrackingFirmwareVehicleTypeChanges();
-    _controllerVehicle->_offlineFirmwareTypeSettingChanged(planFileFirmwareType);
-    _controllerVehicle->_offlineVehicleTypeSettingChanged(planFileVehicleType);
+    return true;
+}
 
-    if (json.contains(_jsonCruiseSpeedKey)) {
-        appSettings->offlineEditingCruiseSpeed()->setRawValue(json[_jsonCruiseSpeedKey].toDouble());
-    }
-    if (json.contains(_jsonHoverSpeedKey)) {
-        appSettings->offlineEditingHoverSpeed()->setRawValue(json[_jsonHoverSpeedKey].toDouble());
-    }
-    if (json.contains(_jsonGlobalPlanAltitudeModeKey)) {
-        setGlobalAltitudeMode(json[_jsonGlobalPlanAltitudeModeKey].toVariant().value<QGroundControlQmlGlobal::AltitudeMode>());
+bool MissionController::_loadJsonMissionFileV2Start(const QJsonObject& json, QmlObjectListModel* visualItems, JsonLoadState_t& loadState, QString& errorString)
+{
+    if (!_validateJsonMissionRootKeys(json, errorString)) {
+        return false;
     }
 
+    qCDebug(MissionControllerLog) << "MissionController::_loadJsonMissionFileV2 itemCount:" << json[_jsonItemsKey].toArray().count();
+
     QGeoCoordinate homeCoordinate;
     if (!JsonHelper::loadGeoCoordinate(json[_jsonPlannedHomePositionKey], true /* altitudeRequired */, homeCoordinate, errorString)) {
         return false;
     }
+
+    AppSettings* appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
+
+    // Get the plan file settings, they are applied once the load completes
+    loadState.firmwareType      = static_cast<MAV_AUTOPILOT>(json[_jsonFirmwareTypeKey].toInt());
+    loadState.vehicleType       = static_cast<MAV_TYPE>(QGCMAVLink::vehicleClassToMavType(appSettings->offlineEditingVehicleClass()->rawValue().toInt()));
+    loadState.vehicleTypeInFile = json.contains(_jsonVehicleTypeKey);
+    if (loadState.vehicleTypeInFile) {
+        loadState.vehicleType = static_cast<MAV_TYPE>(json[_jsonVehicleTypeKey].toInt());
+    }
+    loadState.cruiseSpeed           = json.contains(_jsonCruiseSpeedKey) ? QVariant(json[_jsonCruiseSpeedKey].toDouble()) : QVariant();
+    loadState.hoverSpeed            = json.contains(_jsonHoverSpeedKey) ? QVariant(json[_jsonHoverSpeedKey].toDouble()) : QVariant();
+    loadState.globalAltitudeMode    = QGroundControlQmlGlobal::AltitudeModeNone;   // Mixed mode
+    if (json.contains(_jsonGlobalPlanAltitudeModeKey)) {
+        loadState.globalAltitudeMode = json[_jsonGlobalPlanAltitudeModeKey].toVariant().value<QGroundControlQmlGlobal::AltitudeMode>();
+    }
+
+    // The controller vehicle always tracks the Plan file firmware/vehicle types. The items depend on them while loading
+    // so they are updated now, and restored if the load does not complete.
+    loadState.controllerVehicleChanged  = true;
+    loadState.previousFirmwareType      = _controllerVehicle->firmwareType();
+    loadState.previousVehicleType       = _controllerVehicle->vehicleType();
+    _controllerVehicle->stopTrackingFirmwareVehicleTypeChanges();
+    _controllerVehicle->_offlineFirmwareTypeSettingChanged(loadState.firmwareType);
+    _controllerVehicle->_offlineVehicleTypeSettingChanged(loadState.vehicleType);
     MissionSettingsItem* settingsItem = new MissionSettingsItem(_masterController, _flyView, visualItems);
     settingsItem->setCoordinate(homeCoordinate);
     visualItems->insert(0, settingsItem);
     qCDebug(MissionControllerLog) << "plannedHomePosition" << homeCoordinate;
 
-    // Read mission items
+    loadState.visualItems           = visualItems;
+    loadState.settingsItem          = settingsItem;
+    loadState.rgMissionItems        = json[_jsonItemsKey].toArray();
+    loadState.nextItemIndex         = 0;
+    loadState.nextSequenceNumber    = 1;    // Start with 1 since home is in 0
+    loadState.loadedItems.clear();
+
+    return true;
+}
+
+/// Creates the next mission items from the json, without adding them to the visual items yet
+///     @param maxMsecs Stop once this much time has elapsed, -1 to load all remaining items
+bool MissionController::_loadJsonMissionFileV2Items(JsonLoadState_t& loadState, int maxMsecs, QString& errorString)
+{
+    QmlObjectListModel*     visualItems         = loadState.visualItems;
+    MissionSettingsItem*    settingsItem        = loadState.settingsItem;
+    const QJsonArray&       rgMissionItems      = loadState.rgMissionItems;
+    int&                    nextSequenceNumber  = loadState.nextSequenceNumber;
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    // At least one item is loaded each call
+    int cItemsLoaded = 0;
+    while (loadState.nextItemIndex < rgMissionItems.count() && (maxMsecs < 0 || cItemsLoaded++ == 0 || loadTimer.elapsed() < maxMsecs)) {
+        int i = loadState.nextItemIndex++;
 
-    int nextSequenceNumber = 1; // Start with 1 since home is in 0
-    const QJsonArray rgMissionItems(json[_jsonItemsKey].toArray());
-    for (int i=0; i<rgMissionItems.count(); i++) {
         // Convert to QJsonObject
         const QJsonValue& itemValue = rgMissionItems[i];
         if (!itemValue.isObject()) {
@@ -796,14 +870,14 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
             if (simpleItem->load(itemObject, nextSequenceNumber, errorString)) {
                 if (TakeoffMissionItem::isTakeoffCommand(static_cast<MAV_CMD>(simpleItem->command()))) {
                     // This needs to be a TakeoffMissionItem
-                    TakeoffMissionItem* takeoffItem = new TakeoffMissionItem(_masterController, _flyView, settingsItem, true /* forLoad */, this);
+                    TakeoffMissionItem* takeoffItem = new TakeoffMissionItem(_masterController, _flyView, settingsItem, true /* forLoad */, visualItems);
                     takeoffItem->load(itemObject, nextSequenceNumber, errorString);
                     simpleItem->deleteLater();
                     simpleItem = takeoffItem;
                 }
                 qCDebug(MissionControllerLog) << "Loading simple item: nextSequenceNumber:command" << nextSequenceNumber << simpleItem->command();
                 nextSequenceNumber = simpleItem->lastSequenceNumber() + 1;
-                visualItems->append(simpleItem);
+                loadState.loadedItems.append(simpleItem);
             } else {
                 return false;
             }
@@ -824,7 +898,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = surveyItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Survey load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(surveyItem);
+                loadState.loadedItems.append(surveyItem);
             } else if (complexItemType == FixedWingLandingComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Fixed Wing Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
                 FixedWingLandingComplexItem* landingItem = new FixedWingLandingComplexItem(_masterController, _flyView, visualItems);
@@ -833,7 +907,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "FW Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(landingItem);
+                loadState.loadedItems.append(landingItem);
             } else if (complexItemType == VTOLLandingComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading VTOL Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
                 VTOLLandingComplexItem* landingItem = new VTOLLandingComplexItem(_masterController, _flyView, visualItems);
@@ -842,7 +916,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "VTOL Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(landingItem);
+                loadState.loadedItems.append(landingItem);
             } else if (complexItemType == StructureScanComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Structure Scan: nextSequenceNumber" << nextSequenceNumber;
                 StructureScanComplexItem* structureItem = new StructureScanComplexItem(_masterController, _flyView, QString() /* kmlFile */, visualItems);
@@ -851,7 +925,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = structureItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Structure Scan load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(structureItem);
+                loadState.loadedItems.append(structureItem);
             } else if (complexItemType == CorridorScanComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Corridor Scan: nextSequenceNumber" << nextSequenceNumber;
                 CorridorScanComplexItem* corridorItem = new CorridorScanComplexItem(_masterController, _flyView, QString() /* kmlFile */, visualItems);
@@ -860,7 +934,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = corridorItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Corridor Scan load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(corridorItem);
+                loadState.loadedItems.append(corridorItem);
             } else {
                 errorString = tr("Unsupported complex item type: %1").arg(complexItemType);
             }
@@ -870,6 +944,17 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
         }
     }
 
+    return true;
+}
+
+bool MissionController::_loadJsonMissionFileV2Finish(JsonLoadState_t& loadState, QString& errorString)
+{
+    QmlObjectListModel* visualItems = loadState.visualItems;
+
+    // Adding all items at once only updates the model a single time
+    visualItems->append(loadState.loadedItems);
+    loadState.loadedItems.clear();
+
     // Fix up the DO_JUMP commands jump sequence number by finding the item with the matching doJumpId
     for (int i=0; i<visualItems->count(); i++) {
         if (visualItems->value<VisualMissionItem*>(i)->isSimpleItem()) {
@@ -895,9 +980,44 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
         }
     }
 
+    // The load can no longer fail, apply the plan file settings
+    AppSettings* appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
+
+    // Update firmware/vehicle offline settings if we aren't connect to a vehicle
+    if (_masterController->offline()) {
+        appSettings->offlineEditingFirmwareClass()->setRawValue(QGCMAVLink::firmwareClass(loadState.firmwareType));
+        if (loadState.vehicleTypeInFile) {
+            appSettings->offlineEditingVehicleClass()->setRawValue(QGCMAVLink::vehicleClass(loadState.vehicleType));
+        }
+    }
+    if (loadState.cruiseSpeed.isValid()) {
+        appSettings->offlineEditingCruiseSpeed()->setRawValue(loadState.cruiseSpeed);
+    }
+    if (loadState.hoverSpeed.isValid()) {
+        appSettings->offlineEditingHoverSpeed()->setRawValue(loadState.hoverSpeed);
+    }
+    setGlobalAltitudeMode(loadState.globalAltitudeMode);
+    loadState.controllerVehicleChanged = false;
+
     return true;
 }
 
+/// Puts the controller vehicle back the way it was before a load which did not complete
+void MissionController::_revertJsonLoadControllerVehicle(JsonLoadState_t& loadState)
+{
+    if (!loadState.controllerVehicleChanged) {
+        return;
+    }
+    loadState.controllerVehicleChanged = false;
+
+    _controllerVehicle->_offlineFirmwareTypeSettingChanged(loadState.previousFirmwareType);
+    _controllerVehicle->_offlineVehicleTypeSettingChanged(loadState.previousVehicleType);
+    if (_visualItems && _visualItems->count() <= 1) {
+        // An empty plan follows the offline firmware/vehicle type settings
+        _allItemsRemoved();
+    }
+}
+
 bool MissionController::_loadItemsFromJson(const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString)
 {
     // V1 file format has no file type key and version key is string. Convert to new format.
@@ -1026,6 +1146,72 @@ bool MissionController::load(const QJsonObject& json, QString& errorString)
     return true;
 }
 
+bool MissionController::startLoad(const QJsonObject& json, QString& errorString)
+{
+    cancelLoad();
+
+    QString errorStr;
+    QString errorMessage = tr("Mission: %1");
+
+    QmlObjectListModel* loadedVisualItems = new QmlObjectListModel(this);
+    if (!_loadJsonMissionFileV2Start(json, loadedVisualItems, _stagedLoadState, errorStr)) {
+        errorString = errorMessage.arg(errorStr);
+        loadedVisualItems->deleteLater();
+        return false;
+    }
+
+    return true;
+}
+
+bool MissionController::loadNextItems(int maxMsecs, QString& errorString)
+{
+    QString errorStr;
+
+    if (!_stagedLoadState.visualItems) {
+        qCWarning(MissionControllerLog) << "loadNextItems called without startLoad";
+        return false;
+    }
+    if (!_loadJsonMissionFileV2Items(_stagedLoadState, maxMsecs, errorStr)) {
+        errorString = tr("Mission: %1").arg(errorStr);
+        cancelLoad();
+        return false;
+    }
+
+    return true;
+}
+
+bool MissionController::finishLoad(QString& errorString)
+{
+    QString errorStr;
+
+    if (!_stagedLoadState.visualItems || loadedItemCount() != loadItemCount()) {
+        qCWarning(MissionControllerLog) << "finishLoad called before all items are loaded";
+        return false;
+    }
+    if (!_loadJsonMissionFileV2Finish(_stagedLoadState, errorStr)) {
+        errorString = tr("Mission: %1").arg(errorStr);
+        cancelLoad();
+        return false;
+    }
+
+    QmlObjectListModel* loadedVisualItems = _stagedLoadState.visualItems;
+    _stagedLoadState = JsonLoadState_t();
+    _initLoadedVisualItems(loadedVisualItems);
+
+    return true;
+}
+
+void MissionController::cancelLoad(void)
+{
+    _revertJsonLoadControllerVehicle(_stagedLoadState);
+    if (_stagedLoadState.visualItems) {
+        // Items not yet added to the model are children of it as well
+        _stagedLoadState.visualItems->deleteLater();
+        _stagedLoadState.visualItems = nullptr;
+    }
+    _stagedLoadState = JsonLoadState_t();
+}
+
 bool MissionController::loadJsonFile(QFile& file, QString& errorString)
 {
     QString         errorStr;
@@ -18,6 +18,7 @@
 #include "QGroundControlQmlGlobal.h"
 
 #include <QHash>
+#include <QJsonArray>
 
 class FlightPathSegment;
 class VisualMissionItem;
@@ -195,6 +196,20 @@ public:
     bool loadJsonFile(QFile& file, QString& errorString);
     bool loadTextFile(QFile& file, QString& errorString);
 
+    /// Loads a mission from plan file json in steps, so the caller can keep the ui responsive and report progress. The
+    /// loaded items replace the current ones once finishLoad succeeds. Any load failure cancels the load.
+    bool    startLoad       (const QJsonObject& json, QString& errorString);
+    bool    loadNextItems   (int maxMsecs, QString& errorString);              ///< Loads items until maxMsecs have elapsed
+    bool    finishLoad      (QString& errorString);
+    void    cancelLoad      (void);
+    bool    loadInProgress  (void) const { return _stagedLoadState.visualItems != nullptr; }
+    int     loadItemCount   (void) const { return _stagedLoadState.rgMissionItems.count(); }
+    int     loadedItemCount (void) const { return _stagedLoadState.nextItemIndex; }
+
+    /// Validates the root keys of mission json, such as a plan file mission object, and the type keys of each item without
+    /// creating any items. The remaining item keys are only checked as the items are loaded. Safe to call from any thread.
+    static bool validateJsonMission(const QJsonObject& json, QString& errorString);
+
     QGCGeoBoundingCube* travelBoundingCube  () { return &_travelBoundingCube; }
     QGeoCoordinate      takeoffCoordinate   () { return _takeoffCoordinate; }
 
@@ -318,6 +333,29 @@ private slots:
     void _takeoffItemNotRequiredChanged         (void);
 
 private:
+    /// Position within a plan file mission which is being loaded
+    /// Plan file settings are only applied to the current plan once the load completes. The exception is the controller
+    /// vehicle firmware/vehicle type, which the items need while loading. It is restored if the load does not complete.
+    struct JsonLoadState_t {
+        QmlObjectListModel*     visualItems         = nullptr;
+        MissionSettingsItem*    settingsItem        = nullptr;
+        QJsonArray              rgMissionItems;
+        int                     nextItemIndex       = 0;
+        int                     nextSequenceNumber  = 1;
+        QList<QObject*>         loadedItems;                    ///< Added to visualItems all at once when the load completes
+
+        MAV_AUTOPILOT                           firmwareType        = MAV_AUTOPILOT_GENERIC;
+        MAV_TYPE                                vehicleType         = MAV_TYPE_GENERIC;
+        bool                                    vehicleTypeInFile   = false;
+        QVariant                                cruiseSpeed;                                            ///< Invalid if not in the file
+        QVariant                                hoverSpeed;                                             ///< Invalid if not in the file
+        QGroundControlQmlGlobal::AltitudeMode   globalAltitudeMode  = QGroundControlQmlGlobal::AltitudeModeNone;
+
+        bool                                    controllerVehicleChanged    = false;
+        MAV_AUTOPILOT                           previousFirmwareType        = MAV_AUTOPILOT_GENERIC;
+        MAV_TYPE                                previousVehicleType         = MAV_TYPE_GENERIC;
+    };
+
     void                    _init                               (void);
     void                    _recalcSequence                     (void);
     void                    _recalcChildItems                   (void);
@@ -345,6 +383,10 @@ private:
     void                    _updateBatteryInfo                  (int waypointIndex);
     bool                    _loadItemsFromJson                  (const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString);
     void                    _initLoadedVisualItems              (QmlObjectListModel* loadedVisualItems);
+    bool                    _loadJsonMissionFileV2Start         (const QJsonObject& json, QmlObjectListModel* visualItems, JsonLoadState_t& loadState, QString& errorString);
+    bool                    _loadJsonMissionFileV2Items         (JsonLoadState_t& loadState, int maxMsecs, QString& errorString);
+    bool                    _loadJsonMissionFileV2Finish        (JsonLoadState_t& loadState, QString& errorString);
+    void                    _revertJsonLoadControllerVehicle    (JsonLoadState_t& loadState);
     FlightPathSegment*      _addFlightPathSegment               (FlightPathSegmentHashTable& prevItemPairHashTable, VisualItemPair& pair);
     void                    _addTimeDistance                    (bool vtolInHover, double hoverTime, double cruiseTime, double extraTime, double distance, int seqNum);
     VisualMissionItem*      _insertSimpleMissionItemWorker      (QGeoCoordinate coordinate, MAV_CMD command, int visualItemIndex, bool makeCurrentItem);
@@ -359,6 +401,7 @@ private:
     static double           _normalizeLat                       (double lat);
     static double           _normalizeLon                       (double lon);
     static bool             _convertToMissionItems              (QmlObjectListModel* visualMissionItems, QList<MissionItem*>& rgMissionItems, QObject* missionItemParent);
+    static bool             _validateJsonMissionRootKeys        (const QJsonObject& json, QString& errorString);
 
 private:
     Vehicle*                    _controllerVehicle =            nullptr;
@@ -397,6 +440,7 @@ private:
     double                      _minAMSLAltitude =              0;
     double                      _maxAMSLAltitude =              0;
     bool                        _missionContainsVTOLTakeoff =   false;
+    JsonLoadState_t             _stagedLoadState;
 
     QGroundControlQmlGlobal::AltitudeMode _globalAltMode = QGroundControlQmlGlobal::AltitudeModeRelative;
 
@@ -11,6 +11,7 @@
 #include "MissionManagerTest.h"
 #include "LinkManager.h"
 #include "MultiVehicleManager.h"
+#include "GeoFenceManager.h"
 
 const MissionManagerTest::TestCase_t MissionManagerTest::_rgTestCases[] = {
     { "0\t0\t3\t16\t10\t20\t30\t40\t-10\t-20\t-30\t1\r\n",  { 0, QGeoCoordinate(-10.0, -20.0, -30.0), MAV_CMD_NAV_WAYPOINT,     10.0, 20.0, 30.0, 40.0, true, false, MAV_FRAME_GLOBAL_RELATIVE_ALT } },
@@ -27,13 +28,9 @@ MissionManagerTest::MissionManagerTest(void)
     
 }
 
-void MissionManagerTest::_writeItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail)
+/// Creates the items for the test cases in the form the editor sends them to the mission manager
+void MissionManagerTest::_createTestItems(QList<MissionItem*>& missionItems)
 {
-    _mockLink->setMissionItemFailureMode(failureMode, failureAckResult);
-    
-    // Setup our test case data
-    QList<MissionItem*> missionItems;
-    
     // Editor has a home position item on the front, so we do the same
     MissionItem* homeItem = new MissionItem(nullptr /* Vehicle */, this);
     homeItem->setCommand(MAV_CMD_NAV_WAYPOINT);
@@ -56,6 +53,18 @@ void MissionManagerTest::_writeItems(MockLinkMissionItemHandler::FailureMode_t f
         
         missionItems.append(missionItem);
     }
+}
+
+void MissionManagerTest::_writeItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail)
+{
+    _mockLink->setMissionItemFailureMode(failureMode, failureAckResult);
+    
+    // Setup our test case data
+    QList<MissionItem*> missionItems;
+    _createTestItems(missionItems);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
     
     // Send the items to the vehicle
     _missionManager->writeMissionItems(missionItems);
@@ -360,3 +369,105 @@ void MissionManagerTest::_testErrorAckFailureStrings(void)
     }
 
 }
+
+/// Writes the items and waits for the write to complete
+///     @return Number of items transferred to the vehicle
+int MissionManagerTest::_writeChangedItems(PlanManager* planManager, const QList<MissionItem*>& items)
+{
+    QSignalSpy  sendCompleteSpy(planManager, &PlanManager::sendComplete);
+    int         itemsWritten = _mockLink->missionItemsWritten();
+
+    planManager->writeMissionItems(items);
+    if (sendCompleteSpy.count() == 0 && !sendCompleteSpy.wait(_missionManagerSignalWaitTime)) {
+        return -1;
+    }
+    if (sendCompleteSpy[0][0].toBool() /* error */) {
+        return -1;
+    }
+
+    return _mockLink->missionItemsWritten() - itemsWritten;
+}
+
+void MissionManagerTest::_testPartialWritePX4(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    // PX4 does not store home, so editor item n is vehicle item n-1
+    QList<MissionItem*> missionItems;
+    _createTestItems(missionItems);
+    QCOMPARE(_writeChangedItems(_missionManager, missionItems), (int)_cTestCases);
+
+    // Single altitude change only sends the changed item
+    missionItems.clear();
+    _createTestItems(missionItems);
+    missionItems[3]->setParam7(missionItems[3]->param7() + 10);
+    QCOMPARE(_writeChangedItems(_missionManager, missionItems), 1);
+
+    // Changes are sent as a single contiguous range
+    missionItems.clear();
+    _createTestItems(missionItems);
+    missionItems[1]->setParam1(missionItems[1]->param1() + 1);
+    missionItems[3]->setParam7(missionItems[3]->param7() + 10);
+    missionItems[4]->setParam2(missionItems[4]->param2() + 1);
+    QCOMPARE(_writeChangedItems(_missionManager, missionItems), 4);
+
+    // Vehicle has the complete mission
+    QSignalSpy newMissionItemsSpy(_missionManager, &MissionManager::newMissionItemsAvailable);
+    _missionManager->loadFromVehicle();
+    QVERIFY(newMissionItemsSpy.wait(_missionManagerSignalWaitTime));
+    QCOMPARE(_missionManager->missionItems().count(), (int)_cTestCases);
+    for (int i=0; i<_missionManager->missionItems().count(); i++) {
+        const TestCase_t*   testCase    = &_rgTestCases[i];
+        MissionItem*        actual      = _missionManager->missionItems()[i];
+        QCOMPARE(actual->param1(),                  testCase->expectedItem.param1 + (i == 0 ? 1 : 0));
+        QCOMPARE(actual->param2(),                  testCase->expectedItem.param2 + (i == 3 ? 1 : 0));
+        QCOMPARE(actual->coordinate().altitude(),   testCase->expectedItem.coordinate.altitude() + (i == 2 ? 10 : 0));
+    }
+
+    // Mission read back from the vehicle counts as synced, so reverting the changes sends the same range
+    missionItems.clear();
+    _createTestItems(missionItems);
+    QCOMPARE(_writeChangedItems(_missionManager, missionItems), 4);
+
+    // Vehicle which does not support partial writes gets the full mission, from then on without trying again
+    _mockLink->setMissionItemPartialWriteSupported(false);
+    missionItems.clear();
+    _createTestItems(missionItems);
+    missionItems[3]->setParam7(missionItems[3]->param7() + 10);
+    QCOMPARE(_writeChangedItems(_missionManager, missionItems), (int)_cTestCases);
+    _mockLink->setMissionItemPartialWriteSupported(true);
+    missionItems.clear();
+    _createTestItems(missionItems);
+    QCOMPARE(_writeChangedItems(_missionManager, missionItems), (int)_cTestCases);
+}
+
+void MissionManagerTest::_testUnchangedFenceSkippedPX4(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    PlanManager* geoFenceManager = _vehicle->geoFenceManager();
+
+    // First pass sends the fence, second is unchanged and skipped, third changes a single item. Fences are always sent complete.
+    static const int rgExpectedItemsWritten[] = { 4, 0, 4 };
+
+    for (int i=0; i<3; i++) {
+        QList<MissionItem*> fenceItems;
+        for (int vertex=0; vertex<4; vertex++) {
+            fenceItems.append(new MissionItem(vertex,
+                                              MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION,
+                                              MAV_FRAME_GLOBAL,
+                                              4,                                      // vertex count
+                                              0, 0, 0,                                // param 2-4 unused
+                                              47.3769 + (vertex & 1) * 0.001,
+                                              8.549444 + (vertex & 2) * 0.001,
+                                              i == 2 && vertex == 0 ? 100 : 0,
+                                              false,                                  // autocontinue
+                                              false,                                  // isCurrentItem
+                                              this));
+        }
+
+        QCOMPARE(_writeChangedItems(geoFenceManager, fenceItems), rgExpectedItemsWritten[i]);
+        QVERIFY(!geoFenceManager->inProgress());
+        QCOMPARE(geoFenceManager->missionItems().count(), 4);
+    }
+}
@@ -32,10 +32,14 @@ private slots:
     void _testReadFailureHandlingPX4(void);
     void _testReadFailureHandlingAPM(void);
     void _testErrorAckFailureStrings(void);
+    void _testPartialWritePX4(void);
+    void _testUnchangedFenceSkippedPX4(void);
 
 private:
     void _roundTripItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail);
     void _writeItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail);
+    void _createTestItems(QList<MissionItem*>& missionItems);
+    int  _writeChangedItems(PlanManager* planManager, const QList<MissionItem*>& items);
     void _testWriteFailureHandlingWorker(void);
     void _testReadFailureHandlingWorker(void);
     
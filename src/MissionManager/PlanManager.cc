@@ -15,6 +15,9 @@
 #include "MissionCommandTree.h"
 #include "MissionCommandUIInfo.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+
 QGC_LOGGING_CATEGORY(PlanManagerLog, "PlanManagerLog")
 
 PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
@@ -47,18 +50,24 @@ void PlanManager::_writeMissionItemsWorker(void)
 
     emit progressPct(0);
 
-    qCDebug(PlanManagerLog) << QStringLiteral("writeMissionItems %1 count:").arg(_planTypeString()) << _writeMissionItems.count();
+    qCDebug(PlanManagerLog) << QStringLiteral("writeMissionItems %1 count:partialFirst:partialLast").arg(_planTypeString()) << _writeMissionItems.count() << _partialWriteFirstIndex << _partialWriteLastIndex;
 
     // Prime write list
+    int firstIndex  = _partialWriteInProgress() ? _partialWriteFirstIndex : 0;
+    int lastIndex   = _partialWriteInProgress() ? _partialWriteLastIndex : _writeMissionItems.count() - 1;
     _itemIndicesToWrite.clear();
-    for (int i=0; i<_writeMissionItems.count(); i++) {
+    for (int i=firstIndex; i<=lastIndex; i++) {
         _itemIndicesToWrite << i;
     }
 
     _retryCount = 0;
     _setTransactionInProgress(TransactionWrite);
     _connectToMavlink();
-    _writeMissionCount();
+    if (_partialWriteInProgress()) {
+        _writeMissionPartialList();
+    } else {
+        _writeMissionCount();
+    }
 }
 
 
@@ -94,6 +103,36 @@ void PlanManager::writeMissionItems(const QList<MissionItem*>& missionItems)
         }
     }
 
+    if (_syncedItemHashesValid && _syncedItemHashes.count() == _writeMissionItems.count()) {
+        int firstChanged    = -1;
+        int lastChanged     = -1;
+        for (int i=0; i<_writeMissionItems.count(); i++) {
+            if (_itemHash(_writeMissionItems[i]) != _syncedItemHashes[i]) {
+                if (firstChanged == -1) {
+                    firstChanged = i;
+                }
+                lastChanged = i;
+            }
+        }
+
+        // An unchanged mission is still sent since uploading a mission also restarts it on the vehicle
+        if (firstChanged == -1 && _planType != MAV_MISSION_TYPE_MISSION) {
+            qCDebug(PlanManagerLog) << QStringLiteral("writeMissionItems %1 items unchanged from vehicle, skipping write").arg(_planTypeString());
+            _clearAndDeleteMissionItems();
+            _missionItems = _writeMissionItems;
+            _writeMissionItems.clear();
+            emit progressPct(1);
+            emit sendComplete(false /* error */);
+            return;
+        }
+
+        // Partial writes are only defined for missions
+        if (firstChanged != -1 && _planType == MAV_MISSION_TYPE_MISSION && _partialWriteSupported && lastChanged - firstChanged + 1 < _writeMissionItems.count()) {
+            _partialWriteFirstIndex = firstChanged;
+            _partialWriteLastIndex  = lastChanged;
+        }
+    }
+
     _writeMissionItemsWorker();
 }
 
@@ -121,6 +160,50 @@ void PlanManager::_writeMissionCount(void)
     _startAckTimeout(AckMissionRequest);
 }
 
+/// Begins a write of the changed range of items only. The vehicle keeps the items outside of the range.
+void PlanManager::_writeMissionPartialList(void)
+{
+    qCDebug(PlanManagerLog) << QStringLiteral("_writeMissionPartialList %1 first:last").arg(_planTypeString()) << _partialWriteFirstIndex << _partialWriteLastIndex;
+
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
+    if (!weakLink.expired()) {
+        mavlink_message_t       message;
+        SharedLinkInterfacePtr  sharedLink = weakLink.lock();
+
+        mavlink_msg_mission_write_partial_list_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
+                                                         qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
+                                                         sharedLink->mavlinkChannel(),
+                                                         &message,
+                                                         _vehicle->id(),
+                                                         MAV_COMP_ID_AUTOPILOT1,
+                                                         _partialWriteFirstIndex,
+                                                         _partialWriteLastIndex,
+                                                         _planType);
+
+        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+    }
+    _startAckTimeout(AckMissionRequest);
+}
+
+/// Restarts a failed partial write as a write of all items
+void PlanManager::_fallbackToFullWrite(void)
+{
+    qCDebug(PlanManagerLog) << QStringLiteral("_fallbackToFullWrite %1 partial write failed, writing all items _partialWriteSupported:").arg(_planTypeString()) << _partialWriteSupported;
+
+    _partialWriteFirstIndex = -1;
+    _partialWriteLastIndex  = -1;
+    _lastMissionRequest     = -1;
+    _retryCount             = 0;
+
+    _itemIndicesToWrite.clear();
+    for (int i=0; i<_writeMissionItems.count(); i++) {
+        _itemIndicesToWrite << i;
+    }
+
+    emit progressPct(0);
+    _writeMissionCount();
+}
+
 void PlanManager::loadFromVehicle(void)
 {
     if (_vehicle->isOfflineEditingVehicle()) {
@@ -146,6 +229,7 @@ void PlanManager::_requestList(void)
     qCDebug(PlanManagerLog) << QStringLiteral("_requestList %1 _planType:_retryCount").arg(_planTypeString()) << _planType << _retryCount;
 
     _itemIndicesToRead.clear();
+    _readItemHashes.clear();
     _clearMissionItems();
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
@@ -201,7 +285,13 @@ void PlanManager::_ackTimeout(void)
         break;
     case AckMissionRequest:
         // MISSION_REQUEST is expected, or MISSION_ACK to end sequence
-        if (_itemIndicesToWrite.count() == 0) {
+        if (_partialWriteInProgress()) {
+            if (_lastMissionRequest == -1) {
+                // Vehicle ignored MISSION_WRITE_PARTIAL_LIST, don't try it again
+                _partialWriteSupported = false;
+            }
+            _fallbackToFullWrite();
+        } else if (_itemIndicesToWrite.count() == 0) {
             // Vehicle did not send final MISSION_ACK at end of sequence
             _sendError(ProtocolError, tr("Mission write failed, vehicle failed to send final ack."));
             _finishTransaction(false);
@@ -338,6 +428,7 @@ void PlanManager::_handleMissionCount(const mavlink_message_t& message)
         // Prime read list
         for (int i=0; i<missionCount.count; i++) {
             _itemIndicesToRead << i;
+            _readItemHashes << QByteArray();
         }
         _missionItemCountToRead = missionCount.count;
         _requestNextMissionItem();
@@ -397,11 +488,16 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
     bool        autoContinue;
     bool        isCurrentItem;
     int         seq;
+    QByteArray  itemHash;
 
     if (missionItemInt) {
         mavlink_mission_item_int_t missionItem;
         mavlink_msg_mission_item_int_decode(&message, &missionItem);
 
+        itemHash = _itemHash((MAV_FRAME)missionItem.frame, (MAV_CMD)missionItem.command, missionItem.autocontinue,
+                             missionItem.param1, missionItem.param2, missionItem.param3, missionItem.param4,
+                             missionItem.x, missionItem.y, missionItem.z);
+
         command =       (MAV_CMD)missionItem.command,
         frame =         (MAV_FRAME)missionItem.frame,
         param1 =        missionItem.param1;
@@ -418,6 +514,12 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
         mavlink_mission_item_t missionItem;
         mavlink_msg_mission_item_decode(&message, &missionItem);
 
+        double x = missionItem.frame == MAV_FRAME_MISSION ? missionItem.x : missionItem.x * 1e7;
+        double y = missionItem.frame == MAV_FRAME_MISSION ? missionItem.y : missionItem.y * 1e7;
+        itemHash = _itemHash((MAV_FRAME)missionItem.frame, (MAV_CMD)missionItem.command, missionItem.autocontinue,
+                             missionItem.param1, missionItem.param2, missionItem.param3, missionItem.param4,
+                             qIsNaN(x) ? INT32_MAX : static_cast<int32_t>(x), qIsNaN(y) ? INT32_MAX : static_cast<int32_t>(y), missionItem.z);
+
         command =       (MAV_CMD)missionItem.command,
         frame =         (MAV_FRAME)missionItem.frame,
         param1 =        missionItem.param1;
@@ -454,11 +556,16 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
     if (ardupilotHomePositionUpdate) {
         QGeoCoordinate newHomePosition(param5, param6, param7);
         _vehicle->_setHomePosition(newHomePosition);
+        if (_syncedItemHashes.count()) {
+            // Home item on the vehicle no longer matches what was last synced
+            _syncedItemHashes[0] = QByteArray();
+        }
         return;
     }
     
     if (_itemIndicesToRead.contains(seq)) {
         _itemIndicesToRead.removeOne(seq);
+        _readItemHashes[seq] = itemHash;
 
         MissionItem* item = new MissionItem(seq,
                                             command,
@@ -657,7 +764,13 @@ void PlanManager::_handleMissionAck(const mavlink_message_t& message)
         break;
     case AckMissionRequest:
         // MISSION_REQUEST is expected, or MAV_MISSION_ACCEPTED to end sequence
-        if (missionAck.type == MAV_MISSION_ACCEPTED) {
+        if (_partialWriteInProgress() && (missionAck.type != MAV_MISSION_ACCEPTED || _itemIndicesToWrite.count() != 0)) {
+            if (_lastMissionRequest == -1) {
+                // Vehicle rejected MISSION_WRITE_PARTIAL_LIST, don't try it again
+                _partialWriteSupported = false;
+            }
+            _fallbackToFullWrite();
+        } else if (missionAck.type == MAV_MISSION_ACCEPTED) {
             if (_itemIndicesToWrite.count() == 0) {
                 qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionAck write sequence complete %1").arg(_planTypeString());
                 _finishTransaction(true);
@@ -868,6 +981,8 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
 
     _itemIndicesToRead.clear();
     _itemIndicesToWrite.clear();
+    _partialWriteFirstIndex = -1;
+    _partialWriteLastIndex  = -1;
 
     // First thing we do is clear the transaction. This way inProgesss is off when we signal transaction complete.
     TransactionType_t currentTransactionType = _transactionInProgress;
@@ -875,10 +990,14 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
 
     switch (currentTransactionType) {
     case TransactionRead:
-        if (!success) {
+        if (success) {
+            _setSyncedItemHashes(_readItemHashes);
+        } else {
             // Read from vehicle failed, clear partial list
             _clearAndDeleteMissionItems();
+            _invalidateSyncedItemHashes();
         }
+        _readItemHashes.clear();
         emit newMissionItemsAvailable(false);
         break;
     case TransactionWrite:
@@ -892,19 +1011,28 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
                     emit currentIndexChanged(-1);
                     emit lastCurrentIndexChanged(-1);
                 }
+                QList<QByteArray> itemHashes;
                 _clearAndDeleteMissionItems();
                 for (int i=0; i<_writeMissionItems.count(); i++) {
                     _missionItems.append(_writeMissionItems[i]);
+                    itemHashes.append(_itemHash(_writeMissionItems[i]));
                 }
                 _writeMissionItems.clear();
+                _setSyncedItemHashes(itemHashes);
             } else {
-                // Write failed, throw out the write list
+                // Write failed, throw out the write list. What the vehicle has now is unknown.
                 _clearAndDeleteWriteMissionItems();
+                _invalidateSyncedItemHashes();
             }
             emit sendComplete(!success /* error */);
         }
         break;
     case TransactionRemoveAll:
+        if (success) {
+            _setSyncedItemHashes(QList<QByteArray>());
+        } else {
+            _invalidateSyncedItemHashes();
+        }
         emit removeAllComplete(!success /* error */);
         break;
     default:
@@ -993,6 +1121,49 @@ void PlanManager::_clearAndDeleteWriteMissionItems(void)
     _writeMissionItems.clear();
 }
 
+void PlanManager::_setSyncedItemHashes(const QList<QByteArray>& itemHashes)
+{
+    _syncedItemHashes       = itemHashes;
+    _syncedItemHashesValid  = true;
+}
+
+void PlanManager::_invalidateSyncedItemHashes(void)
+{
+    _syncedItemHashes.clear();
+    _syncedItemHashesValid = false;
+}
+
+/// @return Hash of the item content as it is stored on the vehicle
+QByteArray PlanManager::_itemHash(MAV_FRAME frame, MAV_CMD command, bool autoContinue, float param1, float param2, float param3, float param4, int32_t x, int32_t y, float z)
+{
+    // _INT frames are changed on the way in, so they are the same content
+    if (frame == MAV_FRAME_GLOBAL_INT) {
+        frame = MAV_FRAME_GLOBAL;
+    } else if (frame == MAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
+        frame = MAV_FRAME_GLOBAL_RELATIVE_ALT;
+    }
+
+    QByteArray  content;
+    QDataStream stream(&content, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << static_cast<qint32>(frame) << static_cast<qint32>(command) << autoContinue
+           << param1 << param2 << param3 << param4
+           << static_cast<qint32>(x) << static_cast<qint32>(y) << z;
+
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+}
+
+/// @return Hash of the item as it is sent to the vehicle by _handleMissionRequest
+QByteArray PlanManager::_itemHash(const MissionItem* item)
+{
+    double x = item->frame() == MAV_FRAME_MISSION ? item->param5() : item->param5() * 1e7;
+    double y = item->frame() == MAV_FRAME_MISSION ? item->param6() : item->param6() * 1e7;
+
+    return _itemHash(item->frame(), item->command(), item->autoContinue(),
+                     static_cast<float>(item->param1()), static_cast<float>(item->param2()), static_cast<float>(item->param3()), static_cast<float>(item->param4()),
+                     qIsNaN(x) ? INT32_MAX : static_cast<int32_t>(x), qIsNaN(y) ? INT32_MAX : static_cast<int32_t>(y), static_cast<float>(item->param7()));
+}
+
 void PlanManager::_connectToMavlink(void)
 {
     connect(_vehicle, &Vehicle::mavlinkMessageReceived, this, &PlanManager::_mavlinkMessageReceived);
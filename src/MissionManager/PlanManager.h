@@ -48,6 +48,9 @@ public:
 
     /// Writes the specified set of mission items to the vehicle
     /// IMPORTANT NOTE: PlanManager will take control of the MissionItem objects with the missionItems list. It will free them when done.
+    /// Only the changes from what was last synced with the vehicle are sent where possible: an unchanged fence or rally point
+    /// list is not sent at all, and a mission with the same item count only sends the contiguous range of changed items using
+    /// MISSION_WRITE_PARTIAL_LIST. If the vehicle rejects the partial write the full list is sent instead.
     ///     @param missionItems Items to send to vehicle
     ///     Signals sendComplete when done
     void writeMissionItems(const QList<MissionItem*>& missionItems);
@@ -124,6 +127,11 @@ protected:
     void _finishTransaction(bool success, bool apmGuidedItemWrite = false);
     void _requestList(void);
     void _writeMissionCount(void);
+    void _writeMissionPartialList(void);
+    void _fallbackToFullWrite(void);
+    bool _partialWriteInProgress(void) const { return _partialWriteFirstIndex != -1; }
+    void _setSyncedItemHashes(const QList<QByteArray>& itemHashes);
+    void _invalidateSyncedItemHashes(void);
     void _writeMissionItemsWorker(void);
     void _clearAndDeleteMissionItems(void);
     void _clearAndDeleteWriteMissionItems(void);
@@ -133,6 +141,9 @@ protected:
     void _disconnectFromMavlink(void);
     QString _planTypeString(void);
 
+    static QByteArray _itemHash(MAV_FRAME frame, MAV_CMD command, bool autoContinue, float param1, float param2, float param3, float param4, int32_t x, int32_t y, float z);
+    static QByteArray _itemHash(const MissionItem* item);
+
 protected:
     Vehicle*            _vehicle =              nullptr;
     MissionCommandTree* _missionCommandTree =   nullptr;
@@ -154,6 +165,13 @@ protected:
     int                 _currentMissionIndex;
     int                 _lastCurrentIndex;
 
+    QList<QByteArray>   _syncedItemHashes;                  ///< Content hash of each item as last synced with the vehicle
+    bool                _syncedItemHashesValid  = false;    ///< false: Vehicle contents unknown, for example after a failed transaction
+    QList<QByteArray>   _readItemHashes;                    ///< Hashes of the items received during the current read
+    int                 _partialWriteFirstIndex = -1;       ///< First item of the MISSION_WRITE_PARTIAL_LIST write in progress, -1 for a full write
+    int                 _partialWriteLastIndex  = -1;
+    bool                _partialWriteSupported  = true;     ///< false: Vehicle did not respond to MISSION_WRITE_PARTIAL_LIST
+
 private:
     void _setTransactionInProgress(TransactionType_t type);
 };
@@ -27,6 +27,8 @@
 #include <QDomDocument>
 #include <QJsonDocument>
 #include <QFileInfo>
+#include <QTimer>
+#include <QtConcurrent>
 
 QGC_LOGGING_CATEGORY(PlanMasterControllerLog, "PlanMasterControllerLog")
 
@@ -232,6 +234,7 @@ void PlanMasterController::loadFromVehicle(void)
     } else if (syncInProgress()) {
         qCWarning(PlanMasterControllerLog) << "PlanMasterController::loadFromVehicle called while syncInProgress";
     } else {
+        _cancelLoadFromFile();
         _loadGeoFence = true;
         qCDebug(PlanMasterControllerLog) << "PlanMasterController::loadFromVehicle calling _missionController.loadFromVehicle";
         _missionController.loadFromVehicle();
@@ -352,12 +355,20 @@ void PlanMasterController::sendToVehicle(void)
 }
 
 void PlanMasterController::loadFromFile(const QString& filename)
+{
+    _cancelLoadFromFile();
+    _loadFromFile(filename);
+}
+
+/// Loads the plan file in one go
+///     @return true: plan file was loaded
+bool PlanMasterController::_loadFromFile(const QString& filename)
 {
     QString errorString;
     QString errorMessage = tr("Error loading Plan file (%1). %2").arg(filename).arg("%1");
 
     if (filename.isEmpty()) {
-        return;
+        return false;
     }
 
     QFileInfo fileInfo(filename);
@@ -366,7 +377,7 @@ void PlanMasterController::loadFromFile(const QString& filename)
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         errorString = file.errorString() + QStringLiteral(" ") + filename;
         qgcApp()->showAppMessage(errorMessage.arg(errorString));
-        return;
+        return false;
     }
 
     bool success = false;
@@ -388,7 +399,7 @@ void PlanMasterController::loadFromFile(const QString& filename)
 
         if (!JsonHelper::isJsonFile(bytes, jsonDoc, errorString)) {
             qgcApp()->showAppMessage(errorMessage.arg(errorString));
-            return;
+            return false;
         }
 
         QJsonObject json = jsonDoc.object();
@@ -398,7 +409,7 @@ void PlanMasterController::loadFromFile(const QString& filename)
         int version;
         if (!JsonHelper::validateExternalQGCJsonFile(json, kPlanFileType, kPlanFileVersion, kPlanFileVersion, version, errorString)) {
             qgcApp()->showAppMessage(errorMessage.arg(errorString));
-            return;
+            return false;
         }
 
         QList<JsonHelper::KeyValidateInfo> rgKeyInfo = {
@@ -408,7 +419,7 @@ void PlanMasterController::loadFromFile(const QString& filename)
         };
         if (!JsonHelper::validateKeys(json, rgKeyInfo, errorString)) {
             qgcApp()->showAppMessage(errorMessage.arg(errorString));
-            return;
+            return false;
         }
 
         if (!_missionController.load(json[kJsonMissionObjectKey].toObject(), errorString) ||
@@ -422,6 +433,15 @@ void PlanMasterController::loadFromFile(const QString& filename)
         }
     }
 
+    _setCurrentPlanFile(filename, success);
+
+    return success;
+}
+
+void PlanMasterController::_setCurrentPlanFile(const QString& filename, bool success)
+{
+    QFileInfo fileInfo(filename);
+
     if(success){
         _currentPlanFile = QString::asprintf("%s/%s.%s", fileInfo.path().toLocal8Bit().data(), fileInfo.completeBaseName().toLocal8Bit().data(), AppSettings::planFileExtension);
     } else {
@@ -434,6 +454,226 @@ void PlanMasterController::loadFromFile(const QString& filename)
     }
 }
 
+void PlanMasterController::startLoadFromFile(const QString& filename)
+{
+    _cancelLoadFromFile();
+
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    QString suffix = QFileInfo(filename).suffix();
+    if (suffix == AppSettings::missionFileExtension || suffix == AppSettings::waypointsFileExtension || suffix == QStringLiteral("txt")) {
+        // Legacy mission formats are small, they still load in one go
+        emit loadFromFileComplete(_loadFromFile(filename));
+        return;
+    }
+
+    qCDebug(PlanMasterControllerLog) << "startLoadFromFile" << filename;
+
+    _planLoad.filename = filename;
+    _setLoadProgress(0);
+    _setLoadInProgress(true);
+
+    // File read and json parse happen on a worker thread. Results are thrown away if the load was cancelled or restarted.
+    int generation  = _loadGeneration;
+    auto watcher    = new QFutureWatcher<PlanFileLoad_t>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation]() {
+        if (generation == _loadGeneration) {
+            _planFileRead(watcher->result());
+        } else {
+            qCDebug(PlanMasterControllerLog) << "Discarding stale plan file read" << generation << _loadGeneration;
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&PlanMasterController::_readPlanFile, filename));
+}
+
+/// Reads and parses the plan file. Called on a worker thread.
+PlanMasterController::PlanFileLoad_t PlanMasterController::_readPlanFile(const QString& filename)
+{
+    PlanFileLoad_t  planLoad;
+    QFile           file(filename);
+
+    planLoad.filename = filename;
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        planLoad.errorString = file.errorString() + QStringLiteral(" ") + filename;
+        return planLoad;
+    }
+
+    QJsonDocument jsonDoc;
+    if (JsonHelper::isJsonFile(file.readAll(), jsonDoc, planLoad.errorString)) {
+        planLoad.json = jsonDoc.object();
+    }
+
+    return planLoad;
+}
+
+/// Validates the plan file structure, including all mission items, without creating anything. Called on a worker thread.
+PlanMasterController::PlanFileLoad_t PlanMasterController::_validatePlanFile(const PlanFileLoad_t& planLoad)
+{
+    PlanFileLoad_t validatedLoad = planLoad;
+
+    int version;
+    if (!JsonHelper::validateExternalQGCJsonFile(validatedLoad.json, kPlanFileType, kPlanFileVersion, kPlanFileVersion, version, validatedLoad.errorString)) {
+        return validatedLoad;
+    }
+
+    QList<JsonHelper::KeyValidateInfo> rgKeyInfo = {
+        { kJsonMissionObjectKey,        QJsonValue::Object, true },
+        { kJsonGeoFenceObjectKey,       QJsonValue::Object, true },
+        { kJsonRallyPointsObjectKey,    QJsonValue::Object, true },
+    };
+    if (!JsonHelper::validateKeys(validatedLoad.json, rgKeyInfo, validatedLoad.errorString)) {
+        return validatedLoad;
+    }
+
+    QString errorString;
+    if (!MissionController::validateJsonMission(validatedLoad.json[kJsonMissionObjectKey].toObject(), errorString)) {
+        validatedLoad.errorString = tr("Mission: %1").arg(errorString);
+    }
+
+    return validatedLoad;
+}
+
+void PlanMasterController::_planFileRead(const PlanFileLoad_t& planLoad)
+{
+    if (!planLoad.errorString.isEmpty()) {
+        _endLoadFromFile(false, planLoad.errorString);
+        return;
+    }
+
+    PlanFileLoad_t preLoad = planLoad;
+
+    //-- Allow plugins to pre process the load. This must happen on the main thread before validation.
+    qgcApp()->toolbox()->corePlugin()->preLoadFromJson(this, preLoad.json);
+
+    int generation  = _loadGeneration;
+    auto watcher    = new QFutureWatcher<PlanFileLoad_t>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation]() {
+        if (generation == _loadGeneration) {
+            _planFileValidated(watcher->result());
+        } else {
+            qCDebug(PlanMasterControllerLog) << "Discarding stale plan file validation" << generation << _loadGeneration;
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&PlanMasterController::_validatePlanFile, preLoad));
+}
+
+void PlanMasterController::_planFileValidated(const PlanFileLoad_t& planLoad)
+{
+    if (!planLoad.errorString.isEmpty()) {
+        _endLoadFromFile(false, planLoad.errorString);
+        return;
+    }
+
+    // Mission items are QObjects so they must be created on the main thread. They are created in time slices so the
+    // ui stays responsive for large missions.
+    QString errorString;
+    _planLoad = planLoad;
+    if (!_missionController.startLoad(_planLoad.json[kJsonMissionObjectKey].toObject(), errorString)) {
+        _endLoadFromFile(false, errorString);
+        return;
+    }
+    _loadNextMissionItems();
+}
+
+void PlanMasterController::_loadNextMissionItems(void)
+{
+    QString errorString;
+
+    if (!_missionController.loadNextItems(_loadSliceMsecs, errorString)) {
+        _endLoadFromFile(false, errorString);
+        return;
+    }
+
+    int itemCount   = _missionController.loadItemCount();
+    int generation  = _loadGeneration;
+    _setLoadProgress(itemCount ? static_cast<double>(_missionController.loadedItemCount()) / itemCount : 1.0);
+    if (generation != _loadGeneration) {
+        // Load was cancelled from a loadProgressChanged handler
+        return;
+    }
+
+    if (_missionController.loadedItemCount() < itemCount) {
+        QTimer::singleShot(0, this, [this, generation]() {
+            if (generation == _loadGeneration) {
+                _loadNextMissionItems();
+            }
+        });
+        return;
+    }
+
+    if (!_missionController.finishLoad(errorString)) {
+        _endLoadFromFile(false, errorString);
+        return;
+    }
+    if (!_geoFenceController.load(_planLoad.json[kJsonGeoFenceObjectKey].toObject(), errorString) ||
+            !_rallyPointController.load(_planLoad.json[kJsonRallyPointsObjectKey].toObject(), errorString)) {
+        // The mission has already been replaced, so the plan no longer matches the previous file
+        _setCurrentPlanFile(_planLoad.filename, false);
+        _endLoadFromFile(false, errorString);
+        return;
+    }
+
+    //-- Allow plugins to post process the load
+    qgcApp()->toolbox()->corePlugin()->postLoadFromJson(this, _planLoad.json);
+    _endLoadFromFile(true);
+}
+
+/// Completes a load started by startLoadFromFile
+///     @param errorString Error to show to the user on failure
+void PlanMasterController::_endLoadFromFile(bool success, const QString& errorString)
+{
+    QString filename = _planLoad.filename;
+
+    _planLoad = PlanFileLoad_t();
+    _loadGeneration++;
+    _missionController.cancelLoad();
+
+    if (success) {
+        _setCurrentPlanFile(filename, true);
+    } else {
+        qgcApp()->showAppMessage(tr("Error loading Plan file (%1). %2").arg(filename).arg(errorString));
+    }
+
+    _setLoadProgress(success ? 1.0 : 0);
+    _setLoadInProgress(false);
+    emit loadFromFileComplete(success);
+}
+
+/// Throws away any load in progress from startLoadFromFile, leaving the current plan as is
+void PlanMasterController::_cancelLoadFromFile(void)
+{
+    if (_loadInProgress) {
+        qCDebug(PlanMasterControllerLog) << "Cancelling plan file load";
+        _planLoad = PlanFileLoad_t();
+        _loadGeneration++;
+        _missionController.cancelLoad();
+        _setLoadProgress(0);
+        _setLoadInProgress(false);
+        emit loadFromFileComplete(false);
+    }
+}
+
+void PlanMasterController::_setLoadInProgress(bool loadInProgress)
+{
+    if (loadInProgress != _loadInProgress) {
+        _loadInProgress = loadInProgress;
+        emit loadInProgressChanged(_loadInProgress);
+    }
+}
+
+void PlanMasterController::_setLoadProgress(double loadProgress)
+{
+    if (!qFuzzyCompare(loadProgress + 1.0, _loadProgress + 1.0)) {
+        _loadProgress = loadProgress;
+        emit loadProgressChanged(_loadProgress);
+    }
+}
+
 QJsonDocument PlanMasterController::saveToJson()
 {
     QJsonObject planJson;
@@ -522,6 +762,7 @@ void PlanMasterController::saveToKml(const QString& filename)
 
 void PlanMasterController::removeAll(void)
 {
+    _cancelLoadFromFile();
     _missionController.removeAll();
     _geoFenceController.removeAll();
     _rallyPointController.removeAll();
@@ -536,6 +777,7 @@ void PlanMasterController::removeAll(void)
 
 void PlanMasterController::removeAllFromVehicle(void)
 {
+    _cancelLoadFromFile();
     if (!offline()) {
         _missionController.removeAllFromVehicle();
         if (_geoFenceController.supported()) {
@@ -606,6 +848,8 @@ void PlanMasterController::sendPlanToVehicle(Vehicle* vehicle, const QString& fi
 
 void PlanMasterController::_showPlanFromManagerVehicle(void)
 {
+    _cancelLoadFromFile();
+
     if (!_managerVehicle->initialPlanRequestComplete() && !syncInProgress()) {
         // Something went wrong with initial load. All controllers are idle, so just force it off
         _managerVehicle->forceInitialPlanRequestComplete();
@@ -51,6 +51,8 @@ public:
     Q_PROPERTY(QStringList              loadNameFilters         READ loadNameFilters                        CONSTANT)                       ///< File filter list loading plan files
     Q_PROPERTY(QStringList              saveNameFilters         READ saveNameFilters                        CONSTANT)                       ///< File filter list saving plan files
     Q_PROPERTY(QmlObjectListModel*      planCreators            MEMBER _planCreators                        NOTIFY planCreatorsChanged)
+    Q_PROPERTY(bool                     loadInProgress          READ loadInProgress                         NOTIFY loadInProgressChanged)   ///< true: A plan file is being loaded by startLoadFromFile
+    Q_PROPERTY(double                   loadProgress            READ loadProgress                           NOTIFY loadProgressChanged)     ///< Fraction of mission items loaded so far, 0 to 1
 
     /// Should be called immediately upon Component.onCompleted.
     Q_INVOKABLE void start(void);
@@ -75,6 +77,7 @@ public:
     Q_INVOKABLE void loadFromVehicle(void);
     Q_INVOKABLE void sendToVehicle(void);
     Q_INVOKABLE void loadFromFile(const QString& filename);
+    Q_INVOKABLE void startLoadFromFile(const QString& filename);    ///< Loads the plan file without blocking the ui, signals loadFromFileComplete when done
     Q_INVOKABLE void saveToCurrent();
     Q_INVOKABLE void saveToFile(const QString& filename);
     Q_INVOKABLE void saveToKml(const QString& filename);
@@ -96,6 +99,8 @@ public:
     QStringList loadNameFilters (void) const;
     QStringList saveNameFilters (void) const;
     bool        isEmpty         (void) const;
+    bool        loadInProgress  (void) const { return _loadInProgress; }
+    double      loadProgress    (void) const { return _loadProgress; }
 
     void        setFlyView(bool flyView) { _flyView = flyView; }
 
@@ -119,6 +124,9 @@ signals:
     void planCreatorsChanged                (QmlObjectListModel* planCreators);
     void managerVehicleChanged              (Vehicle* managerVehicle);
     void promptForPlanUsageOnVehicleChange  (void);
+    void loadInProgressChanged              (bool loadInProgress);
+    void loadProgressChanged                (double loadProgress);
+    void loadFromFileComplete               (bool success);
 
 private slots:
     void _activeVehicleChanged      (Vehicle* activeVehicle);
@@ -134,8 +142,27 @@ private slots:
 #endif
 
 private:
+    /// Plan file contents handed between the load worker and the main thread
+    typedef struct {
+        QString     filename;
+        QJsonObject json;
+        QString     errorString;
+    } PlanFileLoad_t;
+
     void _commonInit                (void);
     void _showPlanFromManagerVehicle(void);
+    bool _loadFromFile              (const QString& filename);
+    void _setCurrentPlanFile        (const QString& filename, bool success);
+    void _planFileRead              (const PlanFileLoad_t& planLoad);
+    void _planFileValidated         (const PlanFileLoad_t& planLoad);
+    void _loadNextMissionItems      (void);
+    void _endLoadFromFile           (bool success, const QString& errorString = QString());
+    void _cancelLoadFromFile        (void);
+    void _setLoadInProgress         (bool loadInProgress);
+    void _setLoadProgress           (double loadProgress);
+
+    static PlanFileLoad_t _readPlanFile     (const QString& filename);
+    static PlanFileLoad_t _validatePlanFile (const PlanFileLoad_t& planLoad);
 
     MultiVehicleManager*    _multiVehicleMgr =          nullptr;
     Vehicle*                _controllerVehicle =        nullptr;    ///< Offline controller vehicle
@@ -152,4 +179,10 @@ private:
     QString                 _currentPlanFile;
     bool                    _deleteWhenSendCompleted =  false;
     QmlObjectListModel*     _planCreators =             nullptr;
+    bool                    _loadInProgress =           false;
+    double                  _loadProgress =             0;
+    int                     _loadGeneration =           0;          ///< Incremented on each load or cancel, used to throw away stale load steps
+    PlanFileLoad_t          _planLoad;                              ///< Plan file being loaded by startLoadFromFile
+
+    static const int        _loadSliceMsecs =           30;         ///< Max time spent creating mission items before yielding to the event loop
 };
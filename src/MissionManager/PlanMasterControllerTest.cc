@@ -16,6 +16,13 @@
 #include "SettingsManager.h"
 #include "AppSettings.h"
 
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
+#include <functional>
+
 PlanMasterControllerTest::PlanMasterControllerTest(void)
     : _masterController(nullptr)
 {
@@ -51,3 +58,182 @@ void PlanMasterControllerTest::_testMissionPlannerFileLoad(void)
     _masterController->loadFromFile(":/unittest/MissionPlanner.waypoints");
     QCOMPARE(_masterController->missionController()->visualItems()->count(), 6);
 }
+
+void PlanMasterControllerTest::_testPlanFileBackgroundLoad(void)
+{
+    const QString planFile = QStringLiteral(":/unittest/SectionTest.plan");
+
+    _masterController->loadFromFile(planFile);
+    QmlObjectListModel* visualItems = _masterController->missionController()->visualItems();
+    QVERIFY(visualItems->count() > 1);
+
+    QList<int>  rgSequenceNumbers;
+    QString     currentPlanFile = _masterController->currentPlanFile();
+    for (int i=0; i<visualItems->count(); i++) {
+        rgSequenceNumbers.append(visualItems->value<VisualMissionItem*>(i)->sequenceNumber());
+    }
+
+    // Background load must produce the same items in the same order
+    _masterController->removeAll();
+    QSignalSpy completeSpy(_masterController, &PlanMasterController::loadFromFileComplete);
+    _masterController->startLoadFromFile(planFile);
+    QVERIFY(_masterController->loadInProgress());
+    QVERIFY(completeSpy.wait(10000));
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), true);
+    QVERIFY(!_masterController->loadInProgress());
+    QCOMPARE(_masterController->loadProgress(), 1.0);
+    QCOMPARE(_masterController->currentPlanFile(), currentPlanFile);
+
+    visualItems = _masterController->missionController()->visualItems();
+    QCOMPARE(visualItems->count(), rgSequenceNumbers.count());
+    for (int i=0; i<visualItems->count(); i++) {
+        QCOMPARE(visualItems->value<VisualMissionItem*>(i)->sequenceNumber(), rgSequenceNumbers[i]);
+    }
+
+    // Clearing the plan while loading throws the load away
+    _masterController->removeAll();
+    _masterController->startLoadFromFile(planFile);
+    _masterController->removeAll();
+    QCOMPARE(completeSpy.count(), 1);
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), false);
+    QVERIFY(!_masterController->loadInProgress());
+    QTest::qWait(100);
+    QCOMPARE(completeSpy.count(), 0);
+    QCOMPARE(_masterController->missionController()->visualItems()->count(), 1);
+
+    // Bad files report failure without touching the current plan
+    _masterController->loadFromFile(planFile);
+    _masterController->startLoadFromFile(QStringLiteral(":/unittest/DoesNotExist.plan"));
+    QVERIFY(completeSpy.wait(10000));
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), false);
+    QCOMPARE(_masterController->missionController()->visualItems()->count(), rgSequenceNumbers.count());
+    QCOMPARE(_masterController->currentPlanFile(), currentPlanFile);
+}
+
+/// Loads a plan with thousands of waypoints using both the blocking and background loads
+void PlanMasterControllerTest::_testLargePlanFileLoad(void)
+{
+    const int cWaypoints = 5000;
+
+    // Use the mission settings from an existing plan with generated waypoints
+    QFile sourceFile(QStringLiteral(":/unittest/SectionTest.plan"));
+    QVERIFY(sourceFile.open(QIODevice::ReadOnly | QIODevice::Text));
+    QJsonObject planJson    = QJsonDocument::fromJson(sourceFile.readAll()).object();
+    QJsonObject missionJson = planJson[PlanMasterController::kJsonMissionObjectKey].toObject();
+
+    QJsonArray rgItems;
+    for (int i=0; i<cWaypoints; i++) {
+        QJsonObject itemJson;
+        itemJson[VisualMissionItem::jsonTypeKey]    = VisualMissionItem::jsonTypeSimpleItemValue;
+        itemJson["autoContinue"]                    = true;
+        itemJson["command"]                         = static_cast<int>(MAV_CMD_NAV_WAYPOINT);
+        itemJson["doJumpId"]                        = i + 1;
+        itemJson["frame"]                           = static_cast<int>(MAV_FRAME_GLOBAL_RELATIVE_ALT);
+        itemJson["params"]                          = QJsonArray({ 0, 0, 0, QJsonValue(), 47.6 + ((i / 100) * 0.001), 8.5 + ((i % 100) * 0.001), 50 });
+        rgItems.append(itemJson);
+    }
+    missionJson["items"]                    = rgItems;
+    missionJson["firmwareType"]             = static_cast<int>(MAV_AUTOPILOT_ARDUPILOTMEGA);
+    missionJson["vehicleType"]              = static_cast<int>(MAV_TYPE_FIXED_WING);
+    missionJson["cruiseSpeed"]              = 21;
+    missionJson["globalPlanAltitudeMode"]   = static_cast<int>(QGroundControlQmlGlobal::AltitudeModeAbsolute);
+    planJson[PlanMasterController::kJsonMissionObjectKey] = missionJson;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QString planFile = tempDir.filePath(QStringLiteral("LargePlan.plan"));
+    QFile file(planFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write(QJsonDocument(planJson).toJson());
+    file.close();
+
+    QElapsedTimer timer;
+    timer.start();
+    _masterController->loadFromFile(planFile);
+    const qint64 blockingMsecs = timer.elapsed();
+    QCOMPARE(_masterController->missionController()->visualItems()->count(), cWaypoints + 1);
+
+    _masterController->removeAll();
+
+    // Track the longest time the event loop was blocked during the background load
+    QSignalSpy      completeSpy(_masterController, &PlanMasterController::loadFromFileComplete);
+    QElapsedTimer   sliceTimer;
+    qint64          maxSliceMsecs   = 0;
+    int             cProgress       = 0;
+    double          lastProgress    = 0;
+    bool            progressOrdered = true;
+    QMetaObject::Connection progressConnection = connect(_masterController, &PlanMasterController::loadProgressChanged, this, [&](double loadProgress) {
+        maxSliceMsecs = qMax(maxSliceMsecs, sliceTimer.restart());
+        progressOrdered &= loadProgress >= lastProgress;
+        lastProgress = loadProgress;
+        cProgress++;
+    });
+
+    timer.restart();
+    sliceTimer.start();
+    _masterController->startLoadFromFile(planFile);
+    QVERIFY(completeSpy.wait(60000));
+    const qint64 backgroundMsecs = timer.elapsed();
+
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), true);
+    QCOMPARE(_masterController->missionController()->visualItems()->count(), cWaypoints + 1);
+    QCOMPARE(_masterController->missionController()->visualItems()->value<VisualMissionItem*>(cWaypoints)->sequenceNumber(), cWaypoints);
+    QVERIFY(progressOrdered);
+    QCOMPARE(lastProgress, 1.0);
+    QVERIFY(cProgress > 1);
+    QCOMPARE(_masterController->missionController()->globalAltitudeMode(), QGroundControlQmlGlobal::AltitudeModeAbsolute);
+    QCOMPARE(_masterController->controllerVehicle()->firmwareType(), MAV_AUTOPILOT_ARDUPILOTMEGA);
+    disconnect(progressConnection);
+
+    qDebug() << cWaypoints << "waypoints: blocking load" << blockingMsecs << "msecs, background load" << backgroundMsecs << "msecs in"
+             << cProgress << "steps, longest step" << maxSliceMsecs << "msecs";
+
+    // A load cancelled part way through leaves the settings of the current plan alone
+    _masterController->loadFromFile(QStringLiteral(":/unittest/SectionTest.plan"));
+
+    MissionController*  missionController   = _masterController->missionController();
+    Vehicle*            controllerVehicle   = _masterController->controllerVehicle();
+    AppSettings*        appSettings         = qgcApp()->toolbox()->settingsManager()->appSettings();
+    const int           cSectionTestItems   = missionController->visualItems()->count();
+    const QGroundControlQmlGlobal::AltitudeMode altitudeMode = missionController->globalAltitudeMode();
+    const QVariant      firmwareClass       = appSettings->offlineEditingFirmwareClass()->rawValue();
+    const QVariant      cruiseSpeed         = appSettings->offlineEditingCruiseSpeed()->rawValue();
+    QCOMPARE(controllerVehicle->firmwareType(), MAV_AUTOPILOT_PX4);
+    QCOMPARE(controllerVehicle->vehicleType(), MAV_TYPE_QUADROTOR);
+    QVERIFY(altitudeMode != QGroundControlQmlGlobal::AltitudeModeAbsolute);
+
+    std::function<void(void)> cancelLoad;
+    connect(_masterController, &PlanMasterController::loadProgressChanged, this, [&cancelLoad](double loadProgress) {
+        if (loadProgress > 0 && loadProgress < 1 && cancelLoad) {
+            cancelLoad();
+            cancelLoad = nullptr;
+        }
+    });
+
+    // Replaced by a load which fails, the current plan stays
+    cancelLoad = [this]() { _masterController->startLoadFromFile(QStringLiteral(":/unittest/DoesNotExist.plan")); };
+    _masterController->startLoadFromFile(planFile);
+    QVERIFY(QTest::qWaitFor([&completeSpy]() { return completeSpy.count() == 2; }, 60000));
+    QVERIFY(!cancelLoad);
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), false);
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), false);
+    QCOMPARE(missionController->visualItems()->count(), cSectionTestItems);
+    QCOMPARE(missionController->globalAltitudeMode(), altitudeMode);
+    QCOMPARE(controllerVehicle->firmwareType(), MAV_AUTOPILOT_PX4);
+    QCOMPARE(controllerVehicle->vehicleType(), MAV_TYPE_QUADROTOR);
+    QCOMPARE(appSettings->offlineEditingFirmwareClass()->rawValue(), firmwareClass);
+    QCOMPARE(appSettings->offlineEditingCruiseSpeed()->rawValue(), cruiseSpeed);
+
+    // Cleared by removeAll
+    cancelLoad = [this]() { _masterController->removeAll(); };
+    _masterController->startLoadFromFile(planFile);
+    QVERIFY(completeSpy.wait(60000));
+    QVERIFY(!cancelLoad);
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), false);
+    QTest::qWait(100);
+    QCOMPARE(completeSpy.count(), 0);
+    QCOMPARE(missionController->visualItems()->count(), 1);
+    QCOMPARE(missionController->globalAltitudeMode(), altitudeMode);
+    QCOMPARE(controllerVehicle->firmwareType(), MAV_AUTOPILOT_PX4);
+    QCOMPARE(appSettings->offlineEditingFirmwareClass()->rawValue(), firmwareClass);
+}
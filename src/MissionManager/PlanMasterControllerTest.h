@@ -33,6 +33,8 @@ private slots:
 
     void _testMissionFileLoad(void);
     void _testMissionPlannerFileLoad(void);
+    void _testPlanFileBackgroundLoad(void);
+    void _testLargePlanFileLoad(void);
 
 private:
     PlanMasterController*   _masterController;
@@ -147,8 +147,9 @@ QPolygonF QGCMapPolygon::_toPolygonF(void) const
     QPolygonF polygon;
 
     if (_polygonPath.count() > 2) {
-        for (int i=0; i<_polygonPath.count(); i++) {
-            polygon.append(_pointFFromCoord(_polygonPath[i].value<QGeoCoordinate>()));
+        // Same coordinate system as _pointFFromCoord
+        for (const QPointF& point : convertGeoToNed(coordinateList(), _polygonPath[0].value<QGeoCoordinate>())) {
+            polygon.append(QPointF(point.x(), -point.y()));
         }
     }
 
@@ -405,19 +406,7 @@ QList<QPointF> QGCMapPolygon::nedPolygon(void) const
     QList<QPointF>  nedPolygon;
 
     if (count() > 0) {
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
-
-        for (int i=0; i<_polygonModel.count(); i++) {
-            double y, x, down;
-            QGeoCoordinate vertex = vertexCoordinate(i);
-            if (i == 0) {
-                // This avoids a nan calculation that comes out of convertGeoToNed
-                x = y = 0;
-            } else {
-                convertGeoToNed(vertex, tangentOrigin, &y, &x, &down);
-            }
-            nedPolygon += QPointF(x, y);
-        }
+        nedPolygon = convertGeoToNed(coordinateList(), vertexCoordinate(0));
     }
 
     return nedPolygon;
@@ -456,7 +445,7 @@ void QGCMapPolygon::offset(double distance)
 
         // Intersect the offset edges to generate new vertices
         QPointF         newVertex;
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
+        QList<QPointF>  rgNewNedVertices;
         for (int i=0; i<rgOffsetEdges.count(); i++) {
             int prevIndex = i == 0 ? rgOffsetEdges.count() - 1 : i - 1;
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
@@ -469,10 +458,9 @@ void QGCMapPolygon::offset(double distance)
                 qWarning("Intersection failed");
                 return;
             }
-            QGeoCoordinate coord;
-            convertNedToGeo(newVertex.y(), newVertex.x(), 0, tangentOrigin, &coord);
-            rgNewPolygon.append(coord);
+            rgNewNedVertices.append(newVertex);
         }
+        rgNewPolygon = convertNedToGeo(rgNewNedVertices, vertexCoordinate(0));
     }
 
     // Update internals
@@ -276,19 +276,7 @@ QList<QPointF> QGCMapPolyline::nedPolyline(void)
     QList<QPointF>  nedPolyline;
 
     if (count() > 0) {
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
-
-        for (int i=0; i<_polylinePath.count(); i++) {
-            double y, x, down;
-            QGeoCoordinate vertex = vertexCoordinate(i);
-            if (i == 0) {
-                // This avoids a nan calculation that comes out of convertGeoToNed
-                x = y = 0;
-            } else {
-                convertGeoToNed(vertex, tangentOrigin, &y, &x, &down);
-            }
-            nedPolyline += QPointF(x, y);
-        }
+        nedPolyline = convertGeoToNed(coordinateList(), vertexCoordinate(0));
     }
 
     return nedPolyline;
@@ -324,12 +312,10 @@ QList<QGeoCoordinate> QGCMapPolyline::offsetPolyline(double distance)
             rgOffsetEdges.append(offsetEdge);
         }
 
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
+        QList<QPointF> rgNewNedVertices;
 
         // Add first vertex
-        QGeoCoordinate coord;
-        convertNedToGeo(rgOffsetEdges[0].p1().y(), rgOffsetEdges[0].p1().x(), 0, tangentOrigin, &coord);
-        rgNewPolyline.append(coord);
+        rgNewNedVertices.append(rgOffsetEdges[0].p1());
 
         // Intersect the offset edges to generate new central vertices
         QPointF  newVertex;
@@ -343,14 +329,13 @@ QList<QGeoCoordinate> QGCMapPolyline::offsetPolyline(double distance)
                 // Two lines are colinear
                 newVertex = rgOffsetEdges[i].p2();
             }
-            convertNedToGeo(newVertex.y(), newVertex.x(), 0, tangentOrigin, &coord);
-            rgNewPolyline.append(coord);
+            rgNewNedVertices.append(newVertex);
         }
 
         // Add last vertex
-        int lastIndex = rgOffsetEdges.count() - 1;
-        convertNedToGeo(rgOffsetEdges[lastIndex].p2().y(), rgOffsetEdges[lastIndex].p2().x(), 0, tangentOrigin, &coord);
-        rgNewPolyline.append(coord);
+        rgNewNedVertices.append(rgOffsetEdges.last().p2());
+
+        rgNewPolyline = convertNedToGeo(rgNewNedVertices, vertexCoordinate(0));
     }
 
     return rgNewPolyline;
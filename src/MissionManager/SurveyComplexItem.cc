@@ -646,6 +646,25 @@ void SurveyComplexItem::_adjustLineDirection(const QList<QLineF>& lineList, QLis
     }
 }
 
+QList<QList<QGeoCoordinate>> SurveyComplexItem::_linesToTransects(const QList<QLineF>& lines, const QGeoCoordinate& tangentOrigin)
+{
+    QList<QPointF> points;
+    points.reserve(lines.count() * 2);
+    for (const QLineF& line : lines) {
+        points.append(line.p1());
+        points.append(line.p2());
+    }
+
+    QList<QGeoCoordinate>           coords = convertNedToGeo(points, tangentOrigin);
+    QList<QList<QGeoCoordinate>>    transects;
+
+    for (int i=0; i<coords.count(); i+=2) {
+        transects.append(QList<QGeoCoordinate>({ coords[i], coords[i + 1] }));
+    }
+
+    return transects;
+}
+
 double SurveyComplexItem::_clampGridAngle90(double gridAngle)
 {
     // Clamp grid angle to -90<->90. This prevents transects from being rotated to a reversed order.
@@ -714,20 +733,12 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
 
     // Convert polygon to NED
 
-    QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
+    QList<QGeoCoordinate>   vertices        = _surveyAreaPolygon.coordinateList();
+    QGeoCoordinate          tangentOrigin   = vertices[0];
     qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
-        double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
-        if (i == 0) {
-            // This avoids a nan calculation that comes out of convertGeoToNed
-            x = y = 0;
-        } else {
-            convertGeoToNed(vertex, tangentOrigin, &y, &x, &down);
-        }
-        polygonPoints += QPointF(x, y);
-        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertex << polygonPoints.last().x() << polygonPoints.last().y();
+    QList<QPointF> polygonPoints = convertGeoToNed(vertices, tangentOrigin);
+    for (int i=0; i<polygonPoints.count(); i++) {
+        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertices[i] << polygonPoints[i].x() << polygonPoints[i].y();
     }
 
     // Generate transects
@@ -810,18 +821,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     _adjustLineDirection(intersectLines, resultLines);
 
     // Convert from NED to Geo
-    QList<QList<QGeoCoordinate>> transects;
-    for (const QLineF& line : resultLines) {
-        QGeoCoordinate          coord;
-        QList<QGeoCoordinate>   transect;
-
-        convertNedToGeo(line.p1().y(), line.p1().x(), 0, tangentOrigin, &coord);
-        transect.append(coord);
-        convertNedToGeo(line.p2().y(), line.p2().x(), 0, tangentOrigin, &coord);
-        transect.append(coord);
-
-        transects.append(transect);
-    }
+    QList<QList<QGeoCoordinate>> transects = _linesToTransects(resultLines, tangentOrigin);
 
     _adjustTransectsToEntryPointLocation(transects);
 
@@ -930,20 +930,12 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
 
     // Convert polygon to NED
 
-    QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
+    QList<QGeoCoordinate>   vertices        = _surveyAreaPolygon.coordinateList();
+    QGeoCoordinate          tangentOrigin   = vertices[0];
     qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
-        double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
-        if (i == 0) {
-            // This avoids a nan calculation that comes out of convertGeoToNed
-            x = y = 0;
-        } else {
-            convertGeoToNed(vertex, tangentOrigin, &y, &x, &down);
-        }
-        polygonPoints += QPointF(x, y);
-        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertex << polygonPoints.last().x() << polygonPoints.last().y();
+    QList<QPointF> polygonPoints = convertGeoToNed(vertices, tangentOrigin);
+    for (int i=0; i<polygonPoints.count(); i++) {
+        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertices[i] << polygonPoints[i].x() << polygonPoints[i].y();
     }
 
     // convert into QPolygonF
@@ -1219,17 +1211,7 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects.append(transect);
     }
 
-    for (const QLineF& line: resultLines) {
-        QList<QGeoCoordinate>   transect;
-        QGeoCoordinate          coord;
-
-        convertNedToGeo(line.p1().y(), line.p1().x(), 0, tangentOrigin, &coord);
-        transect.append(coord);
-        convertNedToGeo(line.p2().y(), line.p2().x(), 0, tangentOrigin, &coord);
-        transect.append(coord);
-
-        transects.append(transect);
-    }
+    transects.append(_linesToTransects(resultLines, tangentOrigin));
 
     _adjustTransectsToEntryPointLocation(transects);
 
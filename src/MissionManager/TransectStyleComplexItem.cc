@@ -22,6 +22,7 @@
 #include "MissionCommandUIInfo.h"
 
 #include <QPolygonF>
+#include <QtConcurrent>
 
 QGC_LOGGING_CATEGORY(TransectStyleComplexItemLog, "TransectStyleComplexItemLog")
 
@@ -398,6 +399,9 @@ void TransectStyleComplexItem::_rebuildTransects(void)
     _rgPathHeightInfo.clear();
     _rgFlightPathCoordInfo.clear();
 
+    // Any terrain adjustment still running on a worker thread is now out of date
+    _terrainAdjustGeneration++;
+
     _rebuildTransectsPhase1();
 
     _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
@@ -407,7 +411,7 @@ void TransectStyleComplexItem::_rebuildTransects(void)
         _queryTransectsPathHeightInfo();
     } else {
         // Not following terrain so we can build the flight path now
-        _buildRawFlightPath();
+        _buildRawFlightPath(_transects, nullptr, _cameraCalc.distanceToSurface()->rawValue().toDouble(), _rgFlightPathCoordInfo);
     }
 
     // Calc bounding cube
@@ -555,18 +559,46 @@ void TransectStyleComplexItem::_reallyQueryTransectsPathHeightInfo(void)
         _currentTerrainFollowQuery = nullptr;
     }
 
-    // Append all transects into a single PolyPath query
-    QList<QGeoCoordinate> transectPoints;
+    // Terrain profiles are cached per segment. Only segments which are not part of the previous flight path need to be
+    // queried. Segments which are no longer part of the flight path are dropped from the cache.
+    QHash<QString, TerrainPathQuery::PathHeightInfo_t>  previousCache;
+    QList<QPair<QGeoCoordinate, QGeoCoordinate>>        rgQuerySegments;
+
+    previousCache.swap(_terrainSegmentCache);
+    _terrainSegmentKeys.clear();
+    _terrainSegmentQueryKeys.clear();
+
+    // Walk all transects as a single path such that the turn segments in between transects are included
+    QGeoCoordinate prevCoord;
     for (const QList<CoordInfo_t>& transect: _transects) {
         for (const CoordInfo_t& coordInfo: transect) {
-            transectPoints.append(coordInfo.coord);
+            if (prevCoord.isValid()) {
+                QString key = _terrainSegmentKey(prevCoord, coordInfo.coord);
+                _terrainSegmentKeys.append(key);
+                if (!_terrainSegmentCache.contains(key)) {
+                    auto iter = previousCache.constFind(key);
+                    if (iter != previousCache.constEnd()) {
+                        _terrainSegmentCache[key] = iter.value();
+                    } else if (!_terrainSegmentQueryKeys.contains(key)) {
+                        _terrainSegmentQueryKeys.append(key);
+                        rgQuerySegments.append(qMakePair(prevCoord, coordInfo.coord));
+                    }
+                }
+            }
+            prevCoord = coordInfo.coord;
         }
     }
 
-    if (transectPoints.count() > 1) {
+    qCDebug(TransectStyleComplexItemLog) << "_reallyQueryTransectsPathHeightInfo segments:cached:query" << _terrainSegmentKeys.count() << _terrainSegmentCache.count() << rgQuerySegments.count();
+
+    if (rgQuerySegments.count()) {
+        _terrainQuerySegmentCount += rgQuerySegments.count();
         _currentTerrainFollowQuery = new TerrainPolyPathQuery(true /* autoDelete */);
         connect(_currentTerrainFollowQuery, &TerrainPolyPathQuery::terrainDataReceived, this, &TransectStyleComplexItem::_polyPathTerrainData);
-        _currentTerrainFollowQuery->requestData(transectPoints);
+        _currentTerrainFollowQuery->requestSegmentData(rgQuerySegments);
+    } else if (_terrainSegmentKeys.count()) {
+        // Everything we need is already cached
+        _startTerrainAdjust();
     }
 }
 
@@ -576,12 +608,18 @@ void TransectStyleComplexItem::_polyPathTerrainData(bool success, const QList<Te
     emit readyForSaveStateChanged();
 
     if (success) {
-        // Now that we have terrain data we can adjust
-        _rgPathHeightInfo = rgPathHeightInfo;
-        _adjustTransectsForTerrain();
-        emit readyForSaveStateChanged();
-    }
+        if (rgPathHeightInfo.count() == _terrainSegmentQueryKeys.count()) {
+            for (int i=0; i<rgPathHeightInfo.count(); i++) {
+                _terrainSegmentCache[_terrainSegmentQueryKeys[i]] = rgPathHeightInfo[i];
+            }
+            _terrainSegmentQueryKeys.clear();
 
+            // Now that we have terrain data we can adjust
+            _startTerrainAdjust();
+        } else {
+            qCWarning(TransectStyleComplexItemLog) << "_polyPathTerrainData unexpected result count" << rgPathHeightInfo.count() << _terrainSegmentQueryKeys.count();
+        }
+    }
 
     QObject* object = qobject_cast<QObject*>(sender());
     if (object) {
@@ -611,34 +649,83 @@ TransectStyleComplexItem::ReadyForSaveState TransectStyleComplexItem::readyForSa
                 (terrainReady ? ReadyForSave : NotReadyForSaveTerrain);
 }
 
-void TransectStyleComplexItem::_adjustTransectsForTerrain(void)
+/// Kicks off calculation of the terrain adjusted flight path on a worker thread using the cached terrain profiles
+void TransectStyleComplexItem::_startTerrainAdjust(void)
 {
-    if (_followTerrain) {
-        if (_rgPathHeightInfo.count() == 0) {
-            qCWarning(TransectStyleComplexItemLog) << "_adjustTransectPointsForTerrain called when terrain data not ready";
-            qgcApp()->showAppMessage(tr("INTERNAL ERROR: TransectStyleComplexItem::_adjustTransectPointsForTerrain called when terrain data not ready. Plan will be incorrect."));
+    TerrainAdjustInput_t input;
+
+    for (const QString& key: _terrainSegmentKeys) {
+        auto iter = _terrainSegmentCache.constFind(key);
+        if (iter == _terrainSegmentCache.constEnd()) {
+            qCWarning(TransectStyleComplexItemLog) << "_startTerrainAdjust called when terrain data not ready";
+            qgcApp()->showAppMessage(tr("INTERNAL ERROR: TransectStyleComplexItem::_startTerrainAdjust called when terrain data not ready. Plan will be incorrect."));
             return;
         }
+        input.rgPathHeightInfo.append(iter.value());
+    }
 
-        _buildRawFlightPath();
-        _adjustForMaxRates();
-        _adjustForTolerance();
+    input.transects         = _transects;
+    input.distanceToSurface = _cameraCalc.distanceToSurface()->rawValue().toDouble();
+    input.maxClimbRate      = _terrainAdjustMaxClimbRateFact.rawValue().toDouble();
+    input.maxDescentRate    = _terrainAdjustMaxDescentRateFact.rawValue().toDouble();
+    input.vehicleSpeed      = _vehicleSpeed;
+    input.tolerance         = _terrainAdjustToleranceFact.rawValue().toDouble();
+
+    // Results are thrown away if the transects were rebuilt while the calculation was running
+    int                                         generation          = _terrainAdjustGeneration;
+    QList<TerrainPathQuery::PathHeightInfo_t>   rgPathHeightInfo    = input.rgPathHeightInfo;
+    auto                                        watcher             = new QFutureWatcher<QList<CoordInfo_t>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation, rgPathHeightInfo]() {
+        if (generation == _terrainAdjustGeneration) {
+            _terrainAdjustComplete(rgPathHeightInfo, watcher->result());
+        } else {
+            qCDebug(TransectStyleComplexItemLog) << "Discarding stale terrain adjustment" << generation << _terrainAdjustGeneration;
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&TransectStyleComplexItem::_terrainAdjustedFlightPath, input));
+}
 
-        emit lastSequenceNumberChanged(lastSequenceNumber());
-        emit _updateFlightPathSegmentsSignal();
+/// Called on the main thread with the results of _terrainAdjustedFlightPath
+void TransectStyleComplexItem::_terrainAdjustComplete(const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo, const QList<CoordInfo_t>& rgFlightPathCoordInfo)
+{
+    _rgPathHeightInfo       = rgPathHeightInfo;
+    _rgFlightPathCoordInfo  = rgFlightPathCoordInfo;
 
-        _amslEntryAltChanged();
-        _amslExitAltChanged();
+    emit lastSequenceNumberChanged(lastSequenceNumber());
+    emit _updateFlightPathSegmentsSignal();
 
-        _minAMSLAltitude = qQNaN();
-        _maxAMSLAltitude = qQNaN();
-        for (const CoordInfo_t& coordInfo: _rgFlightPathCoordInfo) {
-            _minAMSLAltitude = std::fmin(_minAMSLAltitude, coordInfo.coord.altitude());
-            _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, coordInfo.coord.altitude());
-        }
-        emit minAMSLAltitudeChanged();
-        emit maxAMSLAltitudeChanged();
+    _amslEntryAltChanged();
+    _amslExitAltChanged();
+
+    _minAMSLAltitude = qQNaN();
+    _maxAMSLAltitude = qQNaN();
+    for (const CoordInfo_t& coordInfo: _rgFlightPathCoordInfo) {
+        _minAMSLAltitude = std::fmin(_minAMSLAltitude, coordInfo.coord.altitude());
+        _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, coordInfo.coord.altitude());
     }
+    emit minAMSLAltitudeChanged();
+    emit maxAMSLAltitudeChanged();
+
+    emit readyForSaveStateChanged();
+}
+
+QString TransectStyleComplexItem::_terrainSegmentKey(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord)
+{
+    return QString::asprintf("%.8f,%.8f,%.8f,%.8f", fromCoord.latitude(), fromCoord.longitude(), toCoord.latitude(), toCoord.longitude());
+}
+
+/// Builds the terrain adjusted flight path. This is run on a worker thread so it must only use the supplied input.
+QList<TransectStyleComplexItem::CoordInfo_t> TransectStyleComplexItem::_terrainAdjustedFlightPath(const TerrainAdjustInput_t& input)
+{
+    QList<CoordInfo_t> rgFlightPathCoordInfo;
+
+    if (_buildRawFlightPath(input.transects, &input.rgPathHeightInfo, input.distanceToSurface, rgFlightPathCoordInfo)) {
+        _adjustForMaxRates(rgFlightPathCoordInfo, input.maxClimbRate, input.maxDescentRate, input.vehicleSpeed);
+        _adjustForTolerance(rgFlightPathCoordInfo, input.tolerance);
+    }
+
+    return rgFlightPathCoordInfo;
 }
 
 /// Returns the altitude in between the two points on a line.
@@ -680,12 +767,8 @@ int TransectStyleComplexItem::_maxPathHeight(const TerrainPathQuery::PathHeightI
     return maxIndex;
 }
 
-void TransectStyleComplexItem::_adjustForMaxRates(void)
+void TransectStyleComplexItem::_adjustForMaxRates(QList<CoordInfo_t>& rgFlightPathCoordInfo, double maxClimbRate, double maxDescentRate, double flightSpeed)
 {
-    double maxClimbRate     = _terrainAdjustMaxClimbRateFact.rawValue().toDouble();
-    double maxDescentRate   = _terrainAdjustMaxDescentRateFact.rawValue().toDouble();
-    double flightSpeed      = _vehicleSpeed;
-
     if (qIsNaN(flightSpeed) || (maxClimbRate == 0 && maxDescentRate == 0)) {
         if (qIsNaN(flightSpeed)) {
             qWarning() << "TransectStyleComplexItem::_adjustForMaxRates called with flightSpeed = NaN";
@@ -696,21 +779,28 @@ void TransectStyleComplexItem::_adjustForMaxRates(void)
         return;
     }
 
+    // Only altitudes are adjusted below, so the time to fly each segment can be calculated up front
+    QVector<double> rgSegmentSeconds(qMax(rgFlightPathCoordInfo.count() - 1, 0));
+    for (int i=0; i<rgSegmentSeconds.count(); i++) {
+        rgSegmentSeconds[i] = rgFlightPathCoordInfo[i].coord.distanceTo(rgFlightPathCoordInfo[i+1].coord) / flightSpeed;
+    }
+
     if (maxClimbRate > 0) {
+        // Climb adjustments raise the from coordinate, so walk backwards. That way a raised coordinate is already taken into
+        // account for the segment prior to it in the same pass. Descent adjustments raise the to coordinate, so walk forwards.
         bool climbRateAdjusted;
         do {
             //qDebug() << "climb rate pass";
             climbRateAdjusted = false;
-            for (int i=0; i<_rgFlightPathCoordInfo.count() - 1; i++) {
-                QGeoCoordinate& fromCoord   = _rgFlightPathCoordInfo[i].coord;
-                QGeoCoordinate& toCoord     = _rgFlightPathCoordInfo[i+1].coord;
+            for (int i=rgFlightPathCoordInfo.count() - 2; i>=0; i--) {
+                QGeoCoordinate& fromCoord   = rgFlightPathCoordInfo[i].coord;
+                QGeoCoordinate& toCoord     = rgFlightPathCoordInfo[i+1].coord;
 
                 double altDifference    = toCoord.altitude() - fromCoord.altitude();
-                double distance         = fromCoord.distanceTo(toCoord);
-                double seconds          = distance / flightSpeed;
+                double seconds          = rgSegmentSeconds[i];
                 double climbRate        = altDifference / seconds;
 
-                //qDebug() << QString("Index:%1 altDifference:%2 distance:%3 seconds:%4 climbRate:%5").arg(i).arg(altDifference).arg(distance).arg(seconds).arg(climbRate);
+                //qDebug() << QString("Index:%1 altDifference:%2 seconds:%3 climbRate:%4").arg(i).arg(altDifference).arg(seconds).arg(climbRate);
 
                 if (climbRate > 0 && climbRate - maxClimbRate > 0.1) {
                     double maxAltitudeDelta = maxClimbRate * seconds;
@@ -728,16 +818,15 @@ void TransectStyleComplexItem::_adjustForMaxRates(void)
         do {
             //qDebug() << "descent rate pass";
             descentRateAdjusted = false;
-            for (int i=0; i<_rgFlightPathCoordInfo.count() - 1; i++) {
-                QGeoCoordinate& fromCoord   = _rgFlightPathCoordInfo[i-1].coord;
-                QGeoCoordinate& toCoord     = _rgFlightPathCoordInfo[i].coord;
+            for (int i=1; i<rgFlightPathCoordInfo.count(); i++) {
+                QGeoCoordinate& fromCoord   = rgFlightPathCoordInfo[i-1].coord;
+                QGeoCoordinate& toCoord     = rgFlightPathCoordInfo[i].coord;
 
                 double altDifference    = toCoord.altitude() - fromCoord.altitude();
-                double distance         = fromCoord.distanceTo(toCoord);
-                double seconds          = distance / flightSpeed;
+                double seconds          = rgSegmentSeconds[i-1];
                 double descentRate      = altDifference / seconds;
 
-                //qDebug() << QString("Index:%1 altDifference:%2 distance:%3 seconds:%4 descentRate:%5").arg(i).arg(altDifference).arg(distance).arg(seconds).arg(descentRate);
+                //qDebug() << QString("Index:%1 altDifference:%2 seconds:%3 descentRate:%4").arg(i).arg(altDifference).arg(seconds).arg(descentRate);
 
                 if (descentRate < 0 && descentRate - maxDescentRate < -0.1) {
                     double maxAltitudeDelta = maxDescentRate * seconds;
@@ -750,19 +839,23 @@ void TransectStyleComplexItem::_adjustForMaxRates(void)
     }
 }
 
-void TransectStyleComplexItem::_adjustForTolerance(void)
+void TransectStyleComplexItem::_adjustForTolerance(QList<CoordInfo_t>& rgFlightPathCoordInfo, double tolerance)
 {
+    if (rgFlightPathCoordInfo.isEmpty()) {
+        return;
+    }
+
     QList<CoordInfo_t>  adjustedFlightPath;
-    double              tolerance           = _terrainAdjustToleranceFact.rawValue().toDouble();
-    CoordInfo_t&        lastCoordInfo       = _rgFlightPathCoordInfo.first();
+    CoordInfo_t         lastCoordInfo       = rgFlightPathCoordInfo.first();
 
+    adjustedFlightPath.reserve(rgFlightPathCoordInfo.count());
     adjustedFlightPath.append(lastCoordInfo);
 
     int coordIndex = 1;
-    while (coordIndex < _rgFlightPathCoordInfo.count()) {
+    while (coordIndex < rgFlightPathCoordInfo.count()) {
         // Walk forward until we fall out of tolerence. When we fall out of tolerance add that point.
         // We always add non-interstitial points no matter what.
-        const CoordInfo_t& nextCoordInfo = _rgFlightPathCoordInfo[coordIndex];
+        const CoordInfo_t& nextCoordInfo = rgFlightPathCoordInfo[coordIndex];
         if (nextCoordInfo.coordType != CoordTypeInteriorTerrainAdded || qAbs(lastCoordInfo.coord.altitude() - nextCoordInfo.coord.altitude()) > tolerance) {
             adjustedFlightPath.append(nextCoordInfo);
             lastCoordInfo = nextCoordInfo;
@@ -770,50 +863,59 @@ void TransectStyleComplexItem::_adjustForTolerance(void)
         coordIndex++;
     }
 
-    _rgFlightPathCoordInfo = adjustedFlightPath;
+    rgFlightPathCoordInfo = adjustedFlightPath;
 }
 
 /// Build flight path prior to any post-processing adjustment.
-bool TransectStyleComplexItem::_buildRawFlightPath(void)
+///     @param prgPathHeightInfo Terrain heights for each segment including turn segments, nullptr for no terrain following
+bool TransectStyleComplexItem::_buildRawFlightPath(const QList<QList<CoordInfo_t>>& transects, const QList<TerrainPathQuery::PathHeightInfo_t>* prgPathHeightInfo, double distanceToSurface, QList<CoordInfo_t>& rgFlightPathCoordInfo)
 {
-    if (_followTerrain && _rgPathHeightInfo.count() == 0) {
-        qCWarning(TransectStyleComplexItemLog) << "TransectStyleComplexItem::_buildRawFlightPath _followTerrain with _rgPathHeightInfo.count() == 0";
-        return false;
-    }
+    bool followTerrain = prgPathHeightInfo != nullptr;
 
-    double distanceToSurface = _cameraCalc.distanceToSurface()->rawValue().toDouble();
+    rgFlightPathCoordInfo.clear();
+
+    if (followTerrain) {
+        int cSegments = 0;
+        for (const QList<CoordInfo_t>& transect: transects) {
+            cSegments += transect.count();
+        }
+        cSegments--;
+        if (prgPathHeightInfo->count() == 0 || prgPathHeightInfo->count() != cSegments) {
+            qCWarning(TransectStyleComplexItemLog) << "TransectStyleComplexItem::_buildRawFlightPath terrain data does not match transects" << prgPathHeightInfo->count() << cSegments;
+            return false;
+        }
+    }
 
-    _rgFlightPathCoordInfo.clear();
     int pathHeightIndex = 0;
-    for (int transectIndex=0; transectIndex<_transects.count(); transectIndex++) {
-        const QList<CoordInfo_t>& transect = _transects[transectIndex];
+    for (int transectIndex=0; transectIndex<transects.count(); transectIndex++) {
+        const QList<CoordInfo_t>& transect = transects[transectIndex];
 
         for (int transectCoordIndex=0; transectCoordIndex<transect.count() - 1; transectCoordIndex++) {
             CoordInfo_t fromCoordInfo   = transect[transectCoordIndex];
             CoordInfo_t toCoordInfo     = transect[transectCoordIndex+1];
 
-            const auto* prgPathHeightInfo = _followTerrain ? &_rgPathHeightInfo[pathHeightIndex++] : nullptr;
+            const auto* pPathHeightInfo = followTerrain ? &(*prgPathHeightInfo)[pathHeightIndex++] : nullptr;
 
             fromCoordInfo.coord.setAltitude(distanceToSurface);
             toCoordInfo.coord.setAltitude(distanceToSurface);
-            if (_followTerrain) {
-                fromCoordInfo.coord.setAltitude(fromCoordInfo.coord.altitude() + prgPathHeightInfo->heights.first());
-                toCoordInfo.coord.setAltitude(toCoordInfo.coord.altitude() + prgPathHeightInfo->heights.last());
+            if (followTerrain) {
+                fromCoordInfo.coord.setAltitude(fromCoordInfo.coord.altitude() + pPathHeightInfo->heights.first());
+                toCoordInfo.coord.setAltitude(toCoordInfo.coord.altitude() + pPathHeightInfo->heights.last());
             }
 
             if (transectCoordIndex == 0) {
-                _rgFlightPathCoordInfo.append(fromCoordInfo);
+                rgFlightPathCoordInfo.append(fromCoordInfo);
             }
 
             // For follow terrain we add interstitial points at max resolution of our terrain data
-            if (_followTerrain) {
-                int cHeights = prgPathHeightInfo->heights.count();
+            if (followTerrain) {
+                int cHeights = pPathHeightInfo->heights.count();
 
                 double azimuth  = fromCoordInfo.coord.azimuthTo(toCoordInfo.coord);
                 double distance = fromCoordInfo.coord.distanceTo(toCoordInfo.coord);
 
                 for (int pathHeightIndex=1; pathHeightIndex<cHeights - 1; pathHeightIndex++) {
-                    double interstitialTerrainHeight = prgPathHeightInfo->heights[pathHeightIndex];
+                    double interstitialTerrainHeight = pPathHeightInfo->heights[pathHeightIndex];
                     double percentTowardsTo = (1.0 / (cHeights - 1)) * pathHeightIndex;
 
                     CoordInfo_t interstitialCoordInfo;
@@ -821,21 +923,21 @@ bool TransectStyleComplexItem::_buildRawFlightPath(void)
                     interstitialCoordInfo.coord     = fromCoordInfo.coord.atDistanceAndAzimuth(distance * percentTowardsTo, azimuth);
                     interstitialCoordInfo.coord.setAltitude(interstitialTerrainHeight + distanceToSurface);
 
-                    _rgFlightPathCoordInfo.append(interstitialCoordInfo);
+                    rgFlightPathCoordInfo.append(interstitialCoordInfo);
                 }
             }
 
-            _rgFlightPathCoordInfo.append(toCoordInfo);
+            rgFlightPathCoordInfo.append(toCoordInfo);
         }
 
         // Add terrain interstitial points to the turn segment if not the last transect
-        if (_followTerrain && transectIndex != _transects.count() - 1) {
-            const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo = _rgPathHeightInfo[pathHeightIndex++];
+        if (followTerrain && transectIndex != transects.count() - 1) {
+            const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo = (*prgPathHeightInfo)[pathHeightIndex++];
 
             int cHeights = pathHeightInfo.heights.count();
 
-            CoordInfo_t fromCoordInfo   = _transects[transectIndex].last();
-            CoordInfo_t toCoordInfo     = _transects[transectIndex+1].first();
+            CoordInfo_t fromCoordInfo   = transects[transectIndex].last();
+            CoordInfo_t toCoordInfo     = transects[transectIndex+1].first();
 
             double azimuth  = fromCoordInfo.coord.azimuthTo(toCoordInfo.coord);
             double distance = fromCoordInfo.coord.distanceTo(toCoordInfo.coord);
@@ -849,7 +951,7 @@ bool TransectStyleComplexItem::_buildRawFlightPath(void)
                 interstitialCoordInfo.coord     = fromCoordInfo.coord.atDistanceAndAzimuth(distance * percentTowardsTo, azimuth);
                 interstitialCoordInfo.coord.setAltitude(interstitialTerrainHeight + distanceToSurface);
 
-                _rgFlightPathCoordInfo.append(interstitialCoordInfo);
+                rgFlightPathCoordInfo.append(interstitialCoordInfo);
             }
         }
     }
@@ -945,6 +1047,10 @@ void TransectStyleComplexItem::_followTerrainChanged(bool followTerrain)
     if (followTerrain) {
         _refly90DegreesFact.setRawValue(false);
         _hoverAndCaptureFact.setRawValue(false);
+    } else {
+        _terrainSegmentCache.clear();
+        _terrainSegmentKeys.clear();
+        _terrainSegmentQueryKeys.clear();
     }
 }
 
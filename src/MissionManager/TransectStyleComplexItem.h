@@ -18,6 +18,8 @@
 #include "CameraCalc.h"
 #include "TerrainQuery.h"
 
+#include <QHash>
+
 Q_DECLARE_LOGGING_CATEGORY(TransectStyleComplexItemLog)
 
 class PlanMasterController;
@@ -181,6 +183,7 @@ protected:
     QList<QList<CoordInfo_t>>                   _transects;
     QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;      ///< Path height for each segment includes turn segments
     QList<CoordInfo_t>                          _rgFlightPathCoordInfo; ///< Fully calculated flight path (including terrain if needed)
+    int                                         _terrainQuerySegmentCount = 0;  ///< Total number of segments sent out for terrain queries
 
     bool            _ignoreRecalc =     false;
     double          _complexDistance =  qQNaN();
@@ -231,15 +234,36 @@ private:
         bool useConditionGate;
     } BuildMissionItemsState_t;
 
+    /// Everything needed to calculate the terrain adjusted flight path. This is a copy of the item state such that
+    /// the calculation can be done on a worker thread.
+    typedef struct {
+        QList<QList<CoordInfo_t>>                   transects;
+        QList<TerrainPathQuery::PathHeightInfo_t>   rgPathHeightInfo;
+        double                                      distanceToSurface;
+        double                                      maxClimbRate;
+        double                                      maxDescentRate;
+        double                                      vehicleSpeed;
+        double                                      tolerance;
+    } TerrainAdjustInput_t;
+
     void    _queryTransectsPathHeightInfo   (void);
-    void    _adjustTransectsForTerrain      (void);
-    bool    _buildRawFlightPath             (void);
-    void    _adjustForMaxRates              (void);
-    void    _adjustForTolerance             (void);
+    void    _startTerrainAdjust             (void);
+    void    _terrainAdjustComplete          (const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo, const QList<CoordInfo_t>& rgFlightPathCoordInfo);
     double  _altitudeBetweenCoords          (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double percentTowardsTo);
     int     _maxPathHeight                  (const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo, int fromIndex, int toIndex, double& maxHeight);
     BuildMissionItemsState_t _buildMissionItemsState(void) const;
 
+    static QString              _terrainSegmentKey          (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord);
+    static QList<CoordInfo_t>   _terrainAdjustedFlightPath  (const TerrainAdjustInput_t& input);
+    static bool                 _buildRawFlightPath         (const QList<QList<CoordInfo_t>>& transects, const QList<TerrainPathQuery::PathHeightInfo_t>* prgPathHeightInfo, double distanceToSurface, QList<CoordInfo_t>& rgFlightPathCoordInfo);
+    static void                 _adjustForMaxRates          (QList<CoordInfo_t>& rgFlightPathCoordInfo, double maxClimbRate, double maxDescentRate, double flightSpeed);
+    static void                 _adjustForTolerance         (QList<CoordInfo_t>& rgFlightPathCoordInfo, double tolerance);
+
     TerrainPolyPathQuery*       _currentTerrainFollowQuery =            nullptr;
     QTimer                      _terrainQueryTimer;
+    int                         _terrainAdjustGeneration =              0;  ///< Incremented on each rebuild, used to throw away stale adjustment results
+
+    QHash<QString, TerrainPathQuery::PathHeightInfo_t>  _terrainSegmentCache;       ///< Terrain profile for each segment of the current flight path
+    QStringList                                         _terrainSegmentKeys;        ///< Cache keys for all segments of the current flight path, in order
+    QStringList                                         _terrainSegmentQueryKeys;   ///< Cache keys for the segments in the outstanding terrain query, in order
 };
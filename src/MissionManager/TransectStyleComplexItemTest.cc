@@ -10,6 +10,8 @@
 #include "TransectStyleComplexItemTest.h"
 #include "QGCApplication.h"
 
+#include <QElapsedTimer>
+
 TransectStyleComplexItemTest::TransectStyleComplexItemTest(void)
 {
 }
@@ -246,6 +248,82 @@ void TransectStyleComplexItemTest::_testFollowTerrain(void)
     }
 }
 
+bool TransectStyleComplexItemTest::_waitForTerrainReady(void)
+{
+    return QTest::qWaitFor([&]() { return _transectStyleItem->readyForSaveState() == TransectStyleComplexItem::ReadyForSave; }, 10000);
+}
+
+void TransectStyleComplexItemTest::_testTerrainSegmentCache(void)
+{
+    _transectStyleItem->setupLargeSurvey(500, 5);
+    _transectStyleItem->setFollowTerrain(true);
+    QVERIFY(_waitForTerrainReady());
+
+    // 5 transects and the 4 turns in between
+    QCOMPARE(_transectStyleItem->terrainQuerySegmentCount(), 9);
+    QList<QGeoCoordinate> rgFlightPath = _transectStyleItem->flightPathCoords();
+    QVERIFY(rgFlightPath.count() > 10);
+
+    // Changing the terrain adjustment settings doesn't change the transects so everything should come from the cache
+    _transectStyleItem->terrainAdjustTolerance()->setRawValue(_transectStyleItem->terrainAdjustTolerance()->rawValue().toDouble() + 1);
+    QCOMPARE(_transectStyleItem->readyForSaveState(), TransectStyleComplexItem::NotReadyForSaveTerrain);
+    QVERIFY(_waitForTerrainReady());
+    QCOMPARE(_transectStyleItem->terrainQuerySegmentCount(), 9);
+
+    // Put the tolerance back, flight path should be identical to the one built from fresh terrain data
+    _transectStyleItem->terrainAdjustTolerance()->setRawValue(_transectStyleItem->terrainAdjustTolerance()->rawValue().toDouble() - 1);
+    QVERIFY(_waitForTerrainReady());
+    QCOMPARE(_transectStyleItem->terrainQuerySegmentCount(), 9);
+    QCOMPARE(_transectStyleItem->flightPathCoords(), rgFlightPath);
+
+    // Adding a transect should only query the new transect and the turn to it
+    _transectStyleItem->setLargeSurveyTransectCount(6);
+    QVERIFY(_waitForTerrainReady());
+    QCOMPARE(_transectStyleItem->terrainQuerySegmentCount(), 11);
+
+    // Switching terrain following off and back on starts from scratch
+    _transectStyleItem->setFollowTerrain(false);
+    _transectStyleItem->setFollowTerrain(true);
+    QVERIFY(_waitForTerrainReady());
+    QCOMPARE(_transectStyleItem->terrainQuerySegmentCount(), 22);
+}
+
+void TransectStyleComplexItemTest::_testLargeSurveyTerrainAdjust(void)
+{
+    const double    maxClimbRate    = 0.25;
+    const double    maxDescentRate  = 0.25;
+    const int       cTransects      = 100;
+    QElapsedTimer   timer;
+
+    // Transects run east/west across the linear slope region, climbing at roughly 0.5 m/s at the default flight speed
+    _transectStyleItem->setupLargeSurvey(3000, cTransects);
+    _transectStyleItem->terrainAdjustMaxClimbRate()->setRawValue(maxClimbRate);
+    _transectStyleItem->terrainAdjustMaxDescentRate()->setRawValue(maxDescentRate);
+
+    timer.start();
+    _transectStyleItem->setFollowTerrain(true);
+    QVERIFY(_waitForTerrainReady());
+    qint64 queryMsecs = timer.elapsed();
+    QCOMPARE(_transectStyleItem->terrainQuerySegmentCount(), (cTransects * 2) - 1);
+
+    timer.start();
+    _transectStyleItem->terrainAdjustTolerance()->setRawValue(_transectStyleItem->terrainAdjustTolerance()->rawValue().toDouble() + 1);
+    QVERIFY(_waitForTerrainReady());
+    qint64 cachedMsecs = timer.elapsed();
+    QCOMPARE(_transectStyleItem->terrainQuerySegmentCount(), (cTransects * 2) - 1);
+
+    QList<QGeoCoordinate> rgFlightPath = _transectStyleItem->flightPathCoords();
+    qDebug() << "Large survey terrain adjust: flight path coords" << rgFlightPath.count() << "query+adjust msecs" << queryMsecs << "cached adjust msecs" << cachedMsecs;
+
+    // Validate rate limits were applied
+    const double flightSpeed = 5;
+    for (int i=0; i<rgFlightPath.count() - 1; i++) {
+        double seconds  = rgFlightPath[i].distanceTo(rgFlightPath[i+1]) / flightSpeed;
+        double rate     = (rgFlightPath[i+1].altitude() - rgFlightPath[i].altitude()) / seconds;
+        QVERIFY2(rate <= maxClimbRate + 0.1 && rate >= -maxDescentRate - 0.1, qPrintable(QStringLiteral("index:%1 rate:%2").arg(i).arg(rate)));
+    }
+}
+
 TestTransectStyleItem::TestTransectStyleItem(PlanMasterController* masterController, QObject* parent)
     : TransectStyleComplexItem      (masterController, false /* flyView */, QStringLiteral("UnitTestTransect"), parent)
     , rebuildTransectsPhase1Called  (false)
@@ -269,6 +347,23 @@ void TestTransectStyleItem::_rebuildTransectsPhase1(void)
         return;
     }
 
+    if (largeSurveyTransectCount > 0) {
+        // Parallel east/west transects from the north edge of the polygon towards the south edge, alternating direction
+        QGeoCoordinate northWest = surveyAreaPolygon()->vertexCoordinate(0);
+        QGeoCoordinate northEast = surveyAreaPolygon()->vertexCoordinate(1);
+
+        for (int i=0; i<largeSurveyTransectCount; i++) {
+            QGeoCoordinate west = northWest.atDistanceAndAzimuth(largeSurveyTransectSpacing * i, 180);
+            QGeoCoordinate east = northEast.atDistanceAndAzimuth(largeSurveyTransectSpacing * i, 180);
+            if (i & 1) {
+                _transects.append(QList<TransectStyleComplexItem::CoordInfo_t>{{east, CoordTypeSurveyEntry}, {west, CoordTypeSurveyExit}});
+            } else {
+                _transects.append(QList<TransectStyleComplexItem::CoordInfo_t>{{west, CoordTypeSurveyEntry}, {east, CoordTypeSurveyExit}});
+            }
+        }
+        return;
+    }
+
     _transects.append(QList<TransectStyleComplexItem::CoordInfo_t>{
         {surveyAreaPolygon()->vertexCoordinate(0), CoordTypeSurveyEntry},
         {surveyAreaPolygon()->vertexCoordinate(2), CoordTypeSurveyExit}}
@@ -287,3 +382,30 @@ void TestTransectStyleItem::adjustSurveAreaPolygon(void)
     surveyAreaPolygon()->adjustVertex(0, vertex);
 }
 
+void TestTransectStyleItem::setupLargeSurvey(double edgeDistance, int transectCount)
+{
+    largeSurveyTransectCount    = transectCount;
+    largeSurveyTransectSpacing  = edgeDistance / qMax(transectCount - 1, 1);
+
+    QGeoCoordinate northWest = UnitTestTerrainQuery::linearSlopeRegion.center();
+    surveyAreaPolygon()->clear();
+    surveyAreaPolygon()->appendVertex(northWest);
+    surveyAreaPolygon()->appendVertex(surveyAreaPolygon()->vertexCoordinate(0).atDistanceAndAzimuth(edgeDistance, 90));
+    surveyAreaPolygon()->appendVertex(surveyAreaPolygon()->vertexCoordinate(1).atDistanceAndAzimuth(edgeDistance, 180));
+    surveyAreaPolygon()->appendVertex(surveyAreaPolygon()->vertexCoordinate(2).atDistanceAndAzimuth(edgeDistance, -90.0));
+}
+
+void TestTransectStyleItem::setLargeSurveyTransectCount(int transectCount)
+{
+    largeSurveyTransectCount = transectCount;
+    _rebuildTransects();
+}
+
+QList<QGeoCoordinate> TestTransectStyleItem::flightPathCoords(void) const
+{
+    QList<QGeoCoordinate> rgCoords;
+    for (const CoordInfo_t& coordInfo: _rgFlightPathCoordInfo) {
+        rgCoords.append(coordInfo.coord);
+    }
+    return rgCoords;
+}
@@ -36,6 +36,8 @@ private slots:
     //void _testAltMode           (void);
     void _testAltitudes         (void);
     //void _testFollowTerrain     (void);
+    void _testTerrainSegmentCache       (void);
+    void _testLargeSurveyTerrainAdjust  (void);
 
 private:
     void _testDirty             (void);
@@ -44,6 +46,8 @@ private:
     void _testAltMode           (void);
     //void _testAltitudes         (void);
     void _testFollowTerrain     (void);
+    bool _waitForTerrainReady   (void);
+
     MultiSignalSpyV2*       _multiSpy =             nullptr;
     TestTransectStyleItem*  _transectStyleItem =    nullptr;
 };
@@ -57,6 +61,14 @@ public:
 
     void adjustSurveAreaPolygon(void);
 
+    /// Switches to a square survey of the specified size with the specified number of parallel transects. Changing
+    /// the transect count afterwards keeps the transect spacing, such that the existing transects stay the same.
+    void setupLargeSurvey(double edgeDistance, int transectCount);
+    void setLargeSurveyTransectCount(int transectCount);
+
+    int                     terrainQuerySegmentCount(void) const { return _terrainQuerySegmentCount; }
+    QList<QGeoCoordinate>   flightPathCoords        (void) const;
+
     // Overrides from ComplexMissionItem
     QString patternName         (void) const final { return QString(); }
     QString mapVisualQML        (void) const final { return QString(); }
@@ -70,6 +82,8 @@ public:
     bool rebuildTransectsPhase1Called;
     bool recalcComplexDistanceCalled;
     bool recalcCameraShotsCalled;
+    int     largeSurveyTransectCount    = 0;
+    double  largeSurveyTransectSpacing  = 0;
 
 private slots:
     // Overrides from TransectStyleComplexItem
@@ -220,6 +220,13 @@ Item {
             globals.planMasterControllerPlanView = _planMasterController
         }
 
+        onLoadFromFileComplete: {
+            if (success) {
+                _planMasterController.fitViewportToItems()
+                _missionController.setCurrentPlanViewSeqNum(0, true)
+            }
+        }
+
         onPromptForPlanUsageOnVehicleChange: {
             if (!_promptForPlanUsageShowing) {
                 _promptForPlanUsageShowing = true
@@ -371,9 +378,7 @@ Item {
         }
 
         onAcceptedForLoad: {
-            _planMasterController.loadFromFile(file)
-            _planMasterController.fitViewportToItems()
-            _missionController.setCurrentPlanViewSeqNum(0, true)
+            _planMasterController.startLoadFromFile(file)
             close()
         }
     }
@@ -921,6 +926,17 @@ Item {
             }
         }
 
+        ProgressBar {
+            anchors.margins:        _toolsMargin
+            anchors.top:            parent.top
+            anchors.left:           toolStrip.right
+            anchors.right:          rightPanel.left
+            minimumValue:           0
+            maximumValue:           1
+            value:                  _planMasterController.loadProgress
+            visible:                _planMasterController.loadInProgress
+        }
+
         MapScale {
             id:                     mapScale
             anchors.margins:        _toolsMargin
@@ -10,6 +10,7 @@
 #include <QtCore>
 #include <QDateTime>
 #include <QDate>
+#include <QtMath>
 
 #include "SimulatedPosition.h"
 #include "QGCApplication.h"
@@ -21,11 +22,7 @@ SimulatedPosition::SimulatedPosition()
     _updateTimer.setSingleShot(false);
 
     // Initialize position to normal PX4 Gazebo home position
-    _lastPosition.setTimestamp(QDateTime::currentDateTime());
-    _lastPosition.setCoordinate(QGeoCoordinate(47.3977420, 8.5455941, 488));
-    _lastPosition.setAttribute(QGeoPositionInfo::Attribute::Direction, _heading);
-    _lastPosition.setAttribute(QGeoPositionInfo::Attribute::GroundSpeed, _horizontalVelocityMetersPerSec);
-    _lastPosition.setAttribute(QGeoPositionInfo::Attribute::VerticalSpeed, _verticalVelocityMetersPerSec);
+    setPosition(QGeoCoordinate(47.3977420, 8.5455941, 488), QDateTime::currentDateTime());
 
     // When a vehicle shows up we switch location to the vehicle home position
     connect(qgcApp()->toolbox()->multiVehicleManager(), &MultiVehicleManager::vehicleAdded, this, &SimulatedPosition::_vehicleAdded);
@@ -33,6 +30,38 @@ SimulatedPosition::SimulatedPosition()
     connect(&_updateTimer, &QTimer::timeout, this, &SimulatedPosition::_updatePosition);
 }
 
+void SimulatedPosition::setPosition(const QGeoCoordinate& coordinate, const QDateTime& timestamp)
+{
+    _truePosition = coordinate;
+    _lastPosition.setTimestamp(timestamp);
+    _lastPosition.setCoordinate(coordinate);
+    setMotion(_heading, _horizontalVelocityMetersPerSec, _verticalVelocityMetersPerSec, _turnRateDegreesPerSec);
+}
+
+void SimulatedPosition::setMotion(double headingDegrees, double horizontalSpeed, double verticalSpeed, double turnRateDegreesPerSec)
+{
+    _heading                        = headingDegrees;
+    _horizontalVelocityMetersPerSec = horizontalSpeed;
+    _verticalVelocityMetersPerSec   = verticalSpeed;
+    _turnRateDegreesPerSec          = turnRateDegreesPerSec;
+
+    if (_reportVelocity) {
+        _lastPosition.setAttribute(QGeoPositionInfo::Attribute::Direction, _heading);
+        _lastPosition.setAttribute(QGeoPositionInfo::Attribute::GroundSpeed, _horizontalVelocityMetersPerSec);
+        _lastPosition.setAttribute(QGeoPositionInfo::Attribute::VerticalSpeed, _verticalVelocityMetersPerSec);
+    } else {
+        _lastPosition.removeAttribute(QGeoPositionInfo::Attribute::Direction);
+        _lastPosition.removeAttribute(QGeoPositionInfo::Attribute::GroundSpeed);
+        _lastPosition.removeAttribute(QGeoPositionInfo::Attribute::VerticalSpeed);
+    }
+}
+
+void SimulatedPosition::setPositionNoise(double stdDevMeters, quint32 seed)
+{
+    _noiseStdDevMeters = stdDevMeters;
+    _noiseGenerator.seed(seed);
+}
+
 QGeoPositionInfo SimulatedPosition::lastKnownPosition(bool /*fromSatellitePositioningMethodsOnly*/) const
 {
     return _lastPosition;
@@ -60,13 +89,36 @@ void SimulatedPosition::requestUpdate(int /*timeout*/)
 
 void SimulatedPosition::_updatePosition(void)
 {
-    int intervalMsecs = _updateTimer.interval();
+    _advance(_updateTimer.interval(), QDateTime::currentDateTime());
+}
+
+void SimulatedPosition::replayStep(int msecs)
+{
+    _advance(msecs, _lastPosition.timestamp().addMSecs(msecs));
+}
 
-    QGeoCoordinate  coord =                 _lastPosition.coordinate();
-    double          horizontalDistance =    _horizontalVelocityMetersPerSec * (1000.0 / static_cast<double>(intervalMsecs));
-    double          verticalDistance =      _verticalVelocityMetersPerSec * (1000.0 / static_cast<double>(intervalMsecs));
+void SimulatedPosition::_advance(int msecs, const QDateTime& timestamp)
+{
+    double seconds              = msecs / 1000.0;
+    double horizontalDistance   = _horizontalVelocityMetersPerSec * seconds;
+    double verticalDistance     = _verticalVelocityMetersPerSec * seconds;
+
+    // Move along the arc using the mid point heading
+    double turn = _turnRateDegreesPerSec * seconds;
+    _truePosition = _truePosition.atDistanceAndAzimuth(horizontalDistance, _heading + (turn / 2.0), verticalDistance);
+    _heading = fmod(_heading + turn + 360.0, 360.0);
+
+    QGeoCoordinate reportedPosition = _truePosition;
+    if (_noiseStdDevMeters > 0) {
+        std::normal_distribution<double> noise(0, _noiseStdDevMeters);
+        double north    = noise(_noiseGenerator);
+        double east     = noise(_noiseGenerator);
+        reportedPosition = reportedPosition.atDistanceAndAzimuth(qSqrt(north * north + east * east), qRadiansToDegrees(qAtan2(east, north)));
+    }
 
-    _lastPosition.setCoordinate(coord.atDistanceAndAzimuth(horizontalDistance, _heading, verticalDistance));
+    _lastPosition.setTimestamp(timestamp);
+    _lastPosition.setCoordinate(reportedPosition);
+    setMotion(_heading, _horizontalVelocityMetersPerSec, _verticalVelocityMetersPerSec, _turnRateDegreesPerSec);
 
     emit positionUpdated(_lastPosition);
 }
@@ -79,7 +131,8 @@ QGeoPositionInfoSource::Error SimulatedPosition::error() const
 void SimulatedPosition::_vehicleAdded(Vehicle* vehicle)
 {
     if (vehicle->homePosition().isValid()) {
-        _lastPosition.setCoordinate(vehicle->homePosition());
+        _truePosition = vehicle->homePosition();
+        _lastPosition.setCoordinate(_truePosition);
     } else {
         connect(vehicle, &Vehicle::homePositionChanged, this, &SimulatedPosition::_vehicleHomePositionChanged);
     }
@@ -90,7 +143,8 @@ void SimulatedPosition::_vehicleHomePositionChanged(QGeoCoordinate homePosition)
     Vehicle* vehicle = qobject_cast<Vehicle*>(sender());
 
     if (homePosition.isValid()) {
-        _lastPosition.setCoordinate(homePosition);
+        _truePosition = homePosition;
+        _lastPosition.setCoordinate(_truePosition);
         disconnect(vehicle, &Vehicle::homePositionChanged, this, &SimulatedPosition::_vehicleHomePositionChanged);
     }
 }
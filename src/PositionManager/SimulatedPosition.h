@@ -13,8 +13,15 @@
 #include "QGCToolbox.h"
 #include <QTimer>
 
+#include <random>
+
 class Vehicle;
 
+/// Simulated ground station position moving at a constant speed, heading and turn rate.
+///
+/// Besides the timer driven mode used by QGCPositionManager the simulation can be stepped manually with replayStep.
+/// Together with seeded position noise this gives a deterministic position track for unit tests of consumers such as
+/// FollowMe.
 class SimulatedPosition : public QGeoPositionInfoSource
 {
    Q_OBJECT
@@ -28,6 +35,26 @@ public:
     int                 minimumUpdateInterval       (void) const override { return _updateIntervalMsecs; }
     Error               error                       (void) const override;
 
+    /// Sets the simulated position without emitting an update
+    void setPosition        (const QGeoCoordinate& coordinate, const QDateTime& timestamp);
+    void setMotion          (double headingDegrees, double horizontalSpeed, double verticalSpeed, double turnRateDegreesPerSec = 0);
+
+    /// Adds gaussian noise to the reported position. The true position is not affected.
+    ///     @param stdDevMeters Horizontal standard deviation, 0 for no noise
+    ///     @param seed Seed for the noise generator such that runs are repeatable
+    void setPositionNoise   (double stdDevMeters, quint32 seed);
+
+    /// Sets whether the reported updates include the Direction/GroundSpeed/VerticalSpeed attributes
+    void setReportVelocity  (bool reportVelocity) { _reportVelocity = reportVelocity; }
+
+    /// Advances the simulation by the specified time and emits positionUpdated. The timestamp of the update is the
+    /// previous timestamp plus msecs, independent of wall clock time.
+    void replayStep         (int msecs);
+
+    /// @return Noise free position at the time of the last update
+    QGeoCoordinate  truePosition    (void) const { return _truePosition; }
+    double          heading         (void) const { return _heading; }
+
 public slots:
     void startUpdates   (void) override;
     void stopUpdates    (void) override;
@@ -39,11 +66,18 @@ private slots:
     void _vehicleHomePositionChanged    (QGeoCoordinate homePosition);
 
 private:
+    void _advance(int msecs, const QDateTime& timestamp);
+
     QTimer              _updateTimer;
     QGeoPositionInfo    _lastPosition;
+    QGeoCoordinate      _truePosition;
+    double              _heading =                          45;
+    double              _horizontalVelocityMetersPerSec =   0.5;
+    double              _verticalVelocityMetersPerSec =     0.1;
+    double              _turnRateDegreesPerSec =            0;
+    double              _noiseStdDevMeters =                0;
+    bool                _reportVelocity =                   true;
+    std::mt19937        _noiseGenerator;
 
-    static constexpr int    _updateIntervalMsecs =              1000;
-    static constexpr double _horizontalVelocityMetersPerSec =   0.5;
-    static constexpr double _verticalVelocityMetersPerSec =     0.1;
-    static constexpr double _heading =                          45;
+    static constexpr int _updateIntervalMsecs = 1000;
 };
@@ -86,7 +86,9 @@
 #include "QGCMapPolygon.h"
 #include "QGCMapCircle.h"
 #include "ParameterManager.h"
+#include "ComponentInformationManager.h"
 #include "SettingsManager.h"
+#include "QGCSettingsStore.h"
 #include "QGCCorePlugin.h"
 #include "QGCCameraManager.h"
 #include "CameraCalc.h"
@@ -307,6 +309,9 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
         QDir paramDir(ParameterManager::parameterCacheDir());
         paramDir.removeRecursively();
         paramDir.mkpath(paramDir.absolutePath());
+
+        // Clear component information metadata cache
+        ComponentInformationManager::metaDataCacheDir().removeRecursively();
     } else {
         // Determine if upgrade message for settings version bump is required. Check and clear must happen before toolbox is started since
         // that will write some settings.
@@ -326,6 +331,7 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
         airframe.remove();
         QFile parameter(cachedParameterMetaDataFile());
         parameter.remove();
+        ComponentInformationManager::metaDataCacheDir().removeRecursively();
     }
 
     // Set up our logging filters
@@ -498,6 +504,9 @@ void QGCApplication::_shutdown()
     delete _qmlAppEngine;
     delete _toolbox;
     delete _gpsRtkFactGroup;
+
+    // Write out any settings edits which are still waiting for the debounce to expire
+    QGCSettingsStore::instance()->flush();
 }
 
 QGCApplication::~QGCApplication()
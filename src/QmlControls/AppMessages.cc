@@ -17,9 +17,13 @@
 #include "SettingsManager.h"
 #include "AppSettings.h"
 
-#include <QStringListModel>
 #include <QtConcurrent>
 #include <QTextStream>
+#include <QFileInfo>
+#include <QDir>
+
+#include <algorithm>
+#include <cstring>
 
 Q_GLOBAL_STATIC(AppLogModel, debug_model)
 
@@ -27,12 +31,13 @@ static QtMessageHandler old_handler;
 
 static void msgHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
 {
-    const char symbols[] = { 'D', 'E', '!', 'X', 'I' };
-    QString output = QString("[%1] at %2:%3 - \"%4\"").arg(symbols[type]).arg(context.file).arg(context.line).arg(msg);
-
     // Avoid recursion
-    if (!QString(context.category).startsWith("qt.quick")) {
-        debug_model->log(output);
+    if (!(context.category && strncmp(context.category, "qt.quick", 8) == 0) && !debug_model.isDestroyed()) {
+        if (type == QtFatalMsg) {
+            debug_model->writer()->logFatal(type, context, msg);
+        } else {
+            debug_model->writer()->log(type, context, msg);
+        }
     }
 
     if (old_handler != nullptr) {
@@ -54,19 +59,376 @@ AppLogModel *AppMessages::getModel()
     return debug_model;
 }
 
-AppLogModel::AppLogModel() : QStringListModel()
+/// Log messages from a single thread on their way to the writer thread. The owning thread is the only producer and
+/// the writer thread the only consumer, so the ring needs no locking.
+class AppLogThreadBuffer
+{
+public:
+    /// Called from the owning thread only. Since the writer thread only frees entries a later push can't fail.
+    bool full(void) const
+    {
+        return _tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_acquire) >= capacity;
+    }
+
+    /// Moves the entry into the buffer, called from the owning thread only after checking full()
+    void push(AppLogEntry& entry)
+    {
+        const quint32 tail = _tail.load(std::memory_order_relaxed);
+        _entries[tail % capacity] = std::move(entry);
+        _tail.store(tail + 1, std::memory_order_release);
+    }
+
+    /// Moves all queued entries to the end of entries, called from the writer thread only
+    void drain(std::vector<AppLogEntry>& entries)
+    {
+        const quint32 head = _head.load(std::memory_order_relaxed);
+        const quint32 tail = _tail.load(std::memory_order_acquire);
+        for (quint32 i=head; i!=tail; i++) {
+            entries.push_back(std::move(_entries[i % capacity]));
+        }
+        _head.store(tail, std::memory_order_release);
+    }
+
+    quint32 count(void) const { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+
+    static const quint32 capacity = 1024;
+
+    std::atomic<bool> finished { false };   ///< Owning thread has exited, no more entries will be pushed
+
+private:
+    AppLogEntry             _entries[capacity];
+    std::atomic<quint32>    _head { 0 };    ///< Next entry to drain
+    std::atomic<quint32>    _tail { 0 };    ///< Next free entry
+};
+
+/// Releases the calling thread's buffer on thread exit. The writer drops it once the remaining entries are drained.
+struct AppLogThreadBufferHolder {
+    ~AppLogThreadBufferHolder()
+    {
+        if (buffer) {
+            buffer->finished = true;
+        }
+    }
+
+    std::shared_ptr<AppLogThreadBuffer> buffer;
+    int                                 writerId = -1;
+};
+
+static thread_local AppLogThreadBufferHolder threadBufferHolder;
+static std::atomic<int> nextWriterId { 0 };
+
+const qint64    AppLogWriter::defaultMaxFileSize;
+const int       AppLogWriter::defaultMaxFiles;
+const int       AppLogWriter::writeIntervalMsecs;
+
+AppLogWriter::AppLogWriter(QObject* parent)
+    : QThread   (parent)
+    , _id       (nextWriterId++)
+{
+
+}
+
+AppLogWriter::~AppLogWriter()
+{
+    stop();
+}
+
+AppLogThreadBuffer* AppLogWriter::_threadBuffer(void)
+{
+    AppLogThreadBufferHolder& holder = threadBufferHolder;
+
+    if (!holder.buffer || holder.writerId != _id) {
+        if (holder.buffer) {
+            holder.buffer->finished = true;
+        }
+        holder.buffer   = std::make_shared<AppLogThreadBuffer>();
+        holder.writerId = _id;
+
+        QMutexLocker locker(&_threadBuffersMutex);
+        _threadBuffers.push_back(holder.buffer);
+    }
+
+    return holder.buffer.get();
+}
+
+void AppLogWriter::log(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    AppLogThreadBuffer* buffer = _threadBuffer();
+    if (buffer->full()) {
+        _linesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Only queued messages are numbered, so a missing number is always a message on its way into a buffer
+    AppLogEntry entry;
+    entry.sequence  = _sequence.fetch_add(1, std::memory_order_relaxed);
+    entry.type      = type;
+    entry.file      = QByteArray(context.file);
+    entry.line      = context.line;
+    entry.message   = message;
+    buffer->push(entry);
+
+    if (buffer->count() == AppLogThreadBuffer::capacity / 2) {
+        // Don't wait for the next interval when a burst is filling the buffer
+        _wakeCondition.wakeOne();
+    }
+}
+
+void AppLogWriter::logFatal(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    if (QThread::currentThread() == this) {
+        // The writer thread itself is failing, possibly part way through writing. Only add this message to the file.
+        AppLogEntry entry;
+        entry.type      = type;
+        entry.file      = QByteArray(context.file);
+        entry.line      = context.line;
+        entry.message   = message;
+        if (_logFile.isOpen()) {
+            _logFile.write(formatEntry(entry).toUtf8() + '\n');
+            _logFile.flush();
+        }
+        return;
+    }
+
+    QMutexLocker locker(&_processMutex);
+
+    // Make room in the buffer first so the message can't be dropped
+    _updateLogFile();
+    _processBuffers(true /* flush */);
+    log(type, context, message);
+    _processBuffers(true /* flush */);
+}
+
+void AppLogWriter::setLogFile(const QString& filename, qint64 maxFileSize, int maxFiles)
+{
+    QMutexLocker locker(&_logFileMutex);
+
+    _requestedLogFile       = filename;
+    _requestedMaxFileSize   = maxFileSize;
+    _requestedMaxFiles      = qMax(1, maxFiles);
+    _logFileChanged         = true;
+}
+
+void AppLogWriter::stop(void)
+{
+    if (isRunning()) {
+        _stop = true;
+        _wakeCondition.wakeOne();
+        wait();
+    }
+}
+
+void AppLogWriter::run(void)
+{
+    while (!_stop) {
+        _wakeMutex.lock();
+        _wakeCondition.wait(&_wakeMutex, writeIntervalMsecs);
+        _wakeMutex.unlock();
+
+        QMutexLocker locker(&_processMutex);
+        _updateLogFile();
+        _processBuffers(false /* flush */);
+    }
+
+    // Everything logged before stop
+    QMutexLocker locker(&_processMutex);
+    _updateLogFile();
+    _processBuffers(true /* flush */);
+    _logFile.close();
+}
+
+QString AppLogWriter::formatEntry(const AppLogEntry& entry)
+{
+    static const char symbols[] = { 'D', 'E', '!', 'X', 'I' };
+
+    QString output;
+    output.reserve(entry.message.length() + 64);
+    output += QLatin1Char('[');
+    output += QLatin1Char(symbols[entry.type]);
+    output += QLatin1String("] at ");
+    output += QLatin1String(entry.file);
+    output += QLatin1Char(':');
+    output += QString::number(entry.line);
+    output += QLatin1String(" - \"");
+    output += entry.message;
+    output += QLatin1Char('"');
+
+    return output;
+}
+
+/// @param flush true: write all collected entries, even those still waiting for an earlier entry
+void AppLogWriter::_processBuffers(bool flush)
+{
+    std::vector<std::shared_ptr<AppLogThreadBuffer>> buffers;
+    {
+        QMutexLocker locker(&_threadBuffersMutex);
+        buffers = _threadBuffers;
+    }
+
+    const size_t cPending = _pendingEntries.size();
+    for (const std::shared_ptr<AppLogThreadBuffer>& buffer: buffers) {
+        // Check for exit before draining so nothing pushed before the exit is left behind
+        const bool finished = buffer->finished;
+        buffer->drain(_pendingEntries);
+        if (finished) {
+            QMutexLocker locker(&_threadBuffersMutex);
+            _threadBuffers.erase(std::remove(_threadBuffers.begin(), _threadBuffers.end(), buffer), _threadBuffers.end());
+        }
+    }
+
+    const quint64 dropped = _linesDropped;
+    if (_pendingEntries.empty() && dropped == _lastDropped) {
+        return;
+    }
+
+    // Each buffer is in order, merge them back into the order the messages were logged in
+    if (_pendingEntries.size() != cPending) {
+        std::sort(_pendingEntries.begin(), _pendingEntries.end(), [](const AppLogEntry& a, const AppLogEntry& b) { return a.sequence < b.sequence; });
+    }
+
+    // Write up to the first missing sequence. The missing entry was numbered but not yet queued when the buffers were
+    // drained, it shows up in the next collection. Entries after the gap are only held back for one interval.
+    size_t cReady = 0;
+    while (cReady < _pendingEntries.size() && _pendingEntries[cReady].sequence <= _nextSequence) {
+        _nextSequence = qMax(_nextSequence, _pendingEntries[cReady].sequence + 1);
+        cReady++;
+    }
+    if (cReady < _pendingEntries.size() && (flush || _gapHeld)) {
+        cReady          = _pendingEntries.size();
+        _nextSequence   = _pendingEntries.back().sequence + 1;
+    }
+    _gapHeld = cReady < _pendingEntries.size();
+
+    if (cReady == 0 && dropped == _lastDropped) {
+        return;
+    }
+
+    QStringList lines;
+    lines.reserve(static_cast<int>(cReady) + 1);
+    if (dropped != _lastDropped) {
+        lines.append(QStringLiteral("[E] AppLogWriter - %1 log messages dropped, %2 in total").arg(dropped - _lastDropped).arg(dropped));
+        _lastDropped = dropped;
+    }
+    for (size_t i=0; i<cReady; i++) {
+        lines.append(formatEntry(_pendingEntries[i]));
+    }
+    _pendingEntries.erase(_pendingEntries.begin(), _pendingEntries.begin() + static_cast<std::ptrdiff_t>(cReady));
+
+    _writeToFile(lines);
+    emit linesAvailable(lines);
+
+    _linesProcessed.fetch_add(cReady, std::memory_order_release);
+}
+
+void AppLogWriter::_updateLogFile(void)
+{
+    QString filename;
+    {
+        QMutexLocker locker(&_logFileMutex);
+        if (!_logFileChanged) {
+            return;
+        }
+        _logFileChanged = false;
+        filename        = _requestedLogFile;
+        _maxFileSize    = _requestedMaxFileSize;
+        _maxFiles       = _requestedMaxFiles;
+    }
+
+    _logFile.close();
+    _logFile.setFileName(filename);
+    _logFileSize = 0;
+    if (!filename.isEmpty() && !_logFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        emit logFileError(QStringLiteral("%1 : %2").arg(_logFile.fileName()).arg(_logFile.errorString()));
+    }
+}
+
+void AppLogWriter::_writeToFile(const QStringList& lines)
+{
+    if (!_logFile.isOpen()) {
+        return;
+    }
+
+    for (const QString& line: lines) {
+        const QByteArray bytes = line.toUtf8() + '\n';
+        if (_logFileSize > 0 && _logFileSize + bytes.length() > _maxFileSize) {
+            _rotateLogFile();
+            if (!_logFile.isOpen()) {
+                return;
+            }
+        }
+        _logFile.write(bytes);
+        _logFileSize += bytes.length();
+    }
+
+    // Once per batch rather than once per line
+    _logFile.flush();
+}
+
+void AppLogWriter::_rotateLogFile(void)
+{
+    const QString   filename = _logFile.fileName();
+    const QFileInfo fileInfo(filename);
+
+    auto rotatedFilename = [&fileInfo](int index) {
+        QString rotatedName = QStringLiteral("%1.%2").arg(fileInfo.completeBaseName()).arg(index);
+        if (!fileInfo.suffix().isEmpty()) {
+            rotatedName += QStringLiteral(".") + fileInfo.suffix();
+        }
+        return fileInfo.dir().absoluteFilePath(rotatedName);
+    };
+
+    _logFile.close();
+
+    QFile::remove(rotatedFilename(_maxFiles - 1));
+    for (int i=_maxFiles-2; i>=1; i--) {
+        QFile::rename(rotatedFilename(i), rotatedFilename(i + 1));
+    }
+    if (_maxFiles > 1) {
+        QFile::rename(filename, rotatedFilename(1));
+    }
+
+    _logFile.setFileName(filename);
+    _logFileSize = 0;
+    if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        emit logFileError(QStringLiteral("%1 : %2").arg(_logFile.fileName()).arg(_logFile.errorString()));
+    }
+}
+
+AppLogModel::AppLogModel() : QAbstractListModel()
+{
+    _lines.resize(maxLines);
+
+    _writer = new AppLogWriter();
+    connect(_writer, &AppLogWriter::linesAvailable, this, &AppLogModel::_linesAvailable,   Qt::QueuedConnection);
+    connect(_writer, &AppLogWriter::logFileError,   this, &AppLogModel::_logFileError,     Qt::QueuedConnection);
+    _writer->start();
+}
+
+AppLogModel::~AppLogModel()
+{
+    _writer->stop();
+    delete _writer;
+}
+
+int AppLogModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : _lineCount;
+}
+
+QVariant AppLogModel::data(const QModelIndex& index, int role) const
 {
-#ifdef __mobile__
-    Qt::ConnectionType contype = Qt::QueuedConnection;
-#else
-    Qt::ConnectionType contype = Qt::AutoConnection;
-#endif
-    connect(this, &AppLogModel::emitLog, this, &AppLogModel::threadsafeLog, contype);
+    if (!index.isValid() || index.row() >= _lineCount || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    return _lines[(_firstLine + index.row()) % maxLines];
 }
 
 void AppLogModel::writeMessages(const QString dest_file)
 {
-    const QString writebuffer(stringList().join('\n').append('\n'));
+    QString writebuffer;
+    for (int i=0; i<_lineCount; i++) {
+        writebuffer.append(_lines[(_firstLine + i) % maxLines]).append('\n');
+    }
 
     QtConcurrent::run([dest_file, writebuffer] {
         emit debug_model->writeStarted();
@@ -83,36 +445,44 @@ void AppLogModel::writeMessages(const QString dest_file)
     });
 }
 
-void AppLogModel::log(const QString message)
+void AppLogModel::_linesAvailable(QStringList lines)
 {
-    emit debug_model->emitLog(message);
-}
-
-void AppLogModel::threadsafeLog(const QString message)
-{
-    const int line = rowCount();
-    insertRows(line, 1);
-    setData(index(line), message, Qt::DisplayRole);
-
-    if (qgcApp() && qgcApp()->logOutput() && _logFile.fileName().isEmpty()) {
-        qDebug() << _logFile.fileName().isEmpty() << qgcApp()->logOutput();
+    if (!_logFileRequested && qgcApp() && qgcApp()->logOutput()) {
         QGCToolbox* toolbox = qgcApp()->toolbox();
         // Be careful of toolbox not being open yet
         if (toolbox) {
             QString saveDirPath = qgcApp()->toolbox()->settingsManager()->appSettings()->crashSavePath();
             QDir saveDir(saveDirPath);
-            QString saveFilePath = saveDir.absoluteFilePath(QStringLiteral("QGCConsole.log"));
-
-            _logFile.setFileName(saveFilePath);
-            if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                qgcApp()->showAppMessage(tr("Open console log output file failed %1 : %2").arg(_logFile.fileName()).arg(_logFile.errorString()));
-            }
+            _writer->setLogFile(saveDir.absoluteFilePath(QStringLiteral("QGCConsole.log")));
+            _logFileRequested = true;
         }
     }
 
-    if (_logFile.isOpen()) {
-        QTextStream out(&_logFile);
-        out << message << "\n";
-        _logFile.flush();
+    // Only the newest maxLines of the batch can be shown
+    const int firstNew  = qMax(0, lines.count() - maxLines);
+    const int cNew      = lines.count() - firstNew;
+    if (cNew == 0) {
+        return;
+    }
+
+    const int cRemove = qMax(0, _lineCount + cNew - maxLines);
+    if (cRemove > 0) {
+        beginRemoveRows(QModelIndex(), 0, cRemove - 1);
+        _firstLine = (_firstLine + cRemove) % maxLines;
+        _lineCount -= cRemove;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), _lineCount, _lineCount + cNew - 1);
+    for (int i=firstNew; i<lines.count(); i++) {
+        _lines[(_firstLine + _lineCount++) % maxLines] = lines[i];
+    }
+    endInsertRows();
+}
+
+void AppLogModel::_logFileError(QString errorString)
+{
+    if (qgcApp()) {
+        qgcApp()->showAppMessage(tr("Open console log output file failed %1").arg(errorString));
     }
 }
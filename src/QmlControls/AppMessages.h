@@ -11,35 +11,153 @@
 #pragma once
 
 #include <QObject>
-#include <QStringListModel>
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
 #include <QUrl>
 #include <QFile>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 // Hackish way to force only this translation unit to have public ctor access
 #ifndef _LOG_CTOR_ACCESS_
 #define _LOG_CTOR_ACCESS_ private
 #endif
 
-class AppLogModel : public QStringListModel
+class AppLogThreadBuffer;
+
+/// Single log message as captured by the message handler. Formatting is left to the writer thread.
+struct AppLogEntry {
+    quint64     sequence    = 0;
+    QtMsgType   type        = QtDebugMsg;
+    QByteArray  file;                       ///< Copied, the context of QML messages only lives for the call
+    int         line        = 0;
+    QString     message;
+};
+
+/// Moves log messages off the logging threads. Each thread appends to its own lock-free ring buffer. A background
+/// thread periodically collects the buffers, formats the messages in the order they were logged, appends them to the
+/// console log file with size based rotation and hands them to the model in batches. Messages are numbered when they
+/// are queued. A message that follows a number not collected yet is held back until the next collection, so the order
+/// is kept across batches. Messages logged while a thread's buffer is full are dropped and reported as a single line
+/// with the number dropped.
+class AppLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    AppLogWriter(QObject* parent = nullptr);
+    ~AppLogWriter();
+
+    /// Queues the message, may be called from any thread
+    void log(QtMsgType type, const QMessageLogContext& context, const QString& message);
+
+    /// Writes the message and everything queued before it to the log file before returning, so nothing is lost when
+    /// the application aborts. May be called from any thread.
+    void logFatal(QtMsgType type, const QMessageLogContext& context, const QString& message);
+
+    /// Starts writing the log to the specified file, rotating it once it reaches maxFileSize bytes. Rotated files are
+    /// named <base>.1.<suffix> through <base>.<maxFiles-1>.<suffix>, with 1 the most recent. An empty filename stops
+    /// writing to file. May be called from any thread.
+    void setLogFile(const QString& filename, qint64 maxFileSize = defaultMaxFileSize, int maxFiles = defaultMaxFiles);
+
+    /// Stops the writer thread after processing all queued messages
+    void stop(void);
+
+    quint64 linesProcessed  (void) const { return _linesProcessed; }
+    quint64 linesDropped    (void) const { return _linesDropped; }
+
+    static QString formatEntry(const AppLogEntry& entry);
+
+    static const qint64 defaultMaxFileSize  = 10 * 1024 * 1024;
+    static const int    defaultMaxFiles     = 5;
+    static const int    writeIntervalMsecs  = 50;
+
+signals:
+    /// Formatted lines in the order they were logged. Emitted from the writer thread.
+    void linesAvailable(QStringList lines);
+    void logFileError(QString errorString);
+
+protected:
+    // QThread override
+    void run(void) final;
+
+private:
+    AppLogThreadBuffer* _threadBuffer   (void);
+    void                _processBuffers (bool flush);
+    void                _updateLogFile  (void);
+    void                _writeToFile    (const QStringList& lines);
+    void                _rotateLogFile  (void);
+
+    std::atomic<quint64>    _sequence       { 0 };
+    std::atomic<quint64>    _linesProcessed { 0 };
+    std::atomic<quint64>    _linesDropped   { 0 };
+    std::atomic<bool>       _stop           { false };
+    const int               _id;            ///< Distinguishes thread buffers registered with previous writers
+
+    QMutex                  _wakeMutex;
+    QWaitCondition          _wakeCondition;
+
+    QMutex                                              _threadBuffersMutex;
+    std::vector<std::shared_ptr<AppLogThreadBuffer>>    _threadBuffers;
+
+    QMutex  _logFileMutex;              ///< Protects the requested log file settings below
+    QString _requestedLogFile;
+    qint64  _requestedMaxFileSize   = defaultMaxFileSize;
+    int     _requestedMaxFiles      = defaultMaxFiles;
+    bool    _logFileChanged         = false;
+
+    QMutex  _processMutex;              ///< Held while collecting and writing, protects the members below
+
+    // Only accessed with _processMutex held, normally from the writer thread
+    QFile                       _logFile;
+    qint64                      _maxFileSize    = defaultMaxFileSize;
+    int                         _maxFiles       = defaultMaxFiles;
+    qint64                      _logFileSize    = 0;
+    quint64                     _lastDropped    = 0;
+    quint64                     _nextSequence   = 0;        ///< Sequence of the next entry to write
+    bool                        _gapHeld        = false;    ///< Entries were held back for a missing sequence last time
+    std::vector<AppLogEntry>    _pendingEntries;            ///< Collected entries not written yet
+};
+
+/// Most recent application log lines for the QML console, kept in a fixed size ring buffer
+class AppLogModel : public QAbstractListModel
 {
     Q_OBJECT
 public:
     Q_INVOKABLE void writeMessages(const QString dest_file);
-    static void log(const QString message);
+
+    AppLogWriter* writer(void) { return _writer; }
+
+    // Overrides from QAbstractListModel
+    int         rowCount    (const QModelIndex& parent = QModelIndex()) const override;
+    QVariant    data        (const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    static const int maxLines = 10000;
 
 signals:
-    void emitLog(const QString message);
     void writeStarted();
     void writeFinished(bool success);
 
 private slots:
-    void threadsafeLog(const QString message);
+    void _linesAvailable(QStringList lines);
+    void _logFileError  (QString errorString);
 
 private:
-    QFile _logFile;
+    AppLogWriter*       _writer             = nullptr;
+    QVector<QString>    _lines;                     ///< Ring buffer of maxLines
+    int                 _firstLine          = 0;    ///< Index in _lines of row 0
+    int                 _lineCount          = 0;
+    bool                _logFileRequested   = false;
 
 _LOG_CTOR_ACCESS_:
     AppLogModel();
+    ~AppLogModel();
 };
 
 
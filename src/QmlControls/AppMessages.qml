@@ -39,7 +39,7 @@ Item {
             Connections {
                 target: debugMessageModel
 
-                onDataChanged: {
+                onRowsInserted: {
                     // Keep the view in sync if the button is checked
                     if (loaded) {
                         if (followTail.checked) {
@@ -0,0 +1,196 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "AppMessagesTest.h"
+#include "AppMessages.h"
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QRegularExpression>
+
+#include <thread>
+#include <atomic>
+
+/// Waits until cLines more lines than processed/dropped have gone through the writer
+bool AppMessagesTest::_waitForLines(AppLogWriter* writer, quint64 processed, quint64 dropped, quint64 cLines)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 30000) {
+        // Lines from the rest of the application may be mixed in, so this can only be a lower bound
+        if ((writer->linesProcessed() - processed) + (writer->linesDropped() - dropped) >= cLines) {
+            // Let the queued batches reach the model
+            QTest::qWait(AppLogWriter::writeIntervalMsecs * 2);
+            return true;
+        }
+        QTest::qWait(10);
+    }
+    return false;
+}
+
+/// Logs from several threads at once, the way the link, video and vehicle threads do with debug categories enabled
+void AppMessagesTest::_throughputTest(void)
+{
+    const int cThreads          = 8;
+    const int cLinesPerThread   = 20000;
+
+    AppLogModel*    model       = AppMessages::getModel();
+    AppLogWriter*   writer      = model->writer();
+    const quint64   processed   = writer->linesProcessed();
+    const quint64   dropped     = writer->linesDropped();
+
+    // Dropped messages are reported in the log itself
+    std::atomic<bool> droppedReported { false };
+    QMetaObject::Connection connection = connect(writer, &AppLogWriter::linesAvailable, this, [&droppedReported](QStringList lines) {
+        if (!lines.filter("log messages dropped").isEmpty()) {
+            droppedReported = true;
+        }
+    }, Qt::DirectConnection);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> threads;
+    for (int threadIndex=0; threadIndex<cThreads; threadIndex++) {
+        threads.emplace_back([writer, threadIndex]() {
+            const QMessageLogContext context(__FILE__, __LINE__, Q_FUNC_INFO, "AppMessagesTest");
+            for (int line=0; line<cLinesPerThread; line++) {
+                writer->log(QtDebugMsg, context, QStringLiteral("AppMessagesTest thread %1 line %2").arg(threadIndex).arg(line));
+            }
+        });
+    }
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+    const qint64 logMsecs = timer.elapsed();
+
+    QVERIFY(_waitForLines(writer, processed, dropped, cThreads * cLinesPerThread));
+    const qint64 totalMsecs = timer.elapsed();
+    disconnect(connection);
+
+    // The model only keeps the newest lines. Lines dropped by a full thread buffer never reach it.
+    QVERIFY(model->rowCount() <= AppLogModel::maxLines);
+    if (writer->linesProcessed() >= static_cast<quint64>(AppLogModel::maxLines)) {
+        QCOMPARE(model->rowCount(), AppLogModel::maxLines);
+    }
+
+    // Lines from each thread stay in order
+    QRegularExpression lineRegExp("AppMessagesTest thread (\\d+) line (\\d+)");
+    QVector<int> lastLine(cThreads, -1);
+    int cTestLines = 0;
+    for (int row=0; row<model->rowCount(); row++) {
+        QRegularExpressionMatch match = lineRegExp.match(model->data(model->index(row)).toString());
+        if (match.hasMatch()) {
+            const int threadIndex   = match.captured(1).toInt();
+            const int line          = match.captured(2).toInt();
+            QVERIFY(line > lastLine[threadIndex]);
+            lastLine[threadIndex] = line;
+            cTestLines++;
+        }
+    }
+    QVERIFY(cTestLines > 0);
+
+    const quint64 cDropped = writer->linesDropped() - dropped;
+    QCOMPARE(droppedReported.load(), cDropped != 0);
+    qDebug() << cThreads * cLinesPerThread << "lines logged from" << cThreads << "threads in" << logMsecs << "msecs,"
+             << "through the writer in" << totalMsecs << "msecs," << cDropped << "dropped";
+}
+
+void AppMessagesTest::_rotationTest(void)
+{
+    const qint64    maxFileSize = 4096;
+    const int       maxFiles    = 3;
+    const int       cLines      = 500;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString logFile = tempDir.filePath("QGCConsole.log");
+
+    AppLogWriter* writer = AppMessages::getModel()->writer();
+    writer->setLogFile(logFile, maxFileSize, maxFiles);
+
+    const quint64 processed = writer->linesProcessed();
+    const quint64 dropped   = writer->linesDropped();
+
+    const QMessageLogContext context(__FILE__, __LINE__, Q_FUNC_INFO, "AppMessagesTest");
+    for (int line=0; line<cLines; line++) {
+        writer->log(QtDebugMsg, context, QStringLiteral("AppMessagesTest rotation line %1").arg(line));
+    }
+    QVERIFY(_waitForLines(writer, processed, dropped, cLines));
+
+    writer->setLogFile(QString());
+    QTest::qWait(AppLogWriter::writeIntervalMsecs * 2);
+
+    QCOMPARE(QDir(tempDir.path()).entryList(QDir::Files).count(), maxFiles);
+    for (const QString& filename: { QStringLiteral("QGCConsole.log"), QStringLiteral("QGCConsole.1.log"), QStringLiteral("QGCConsole.2.log") }) {
+        QFileInfo fileInfo(tempDir.filePath(filename));
+        QVERIFY(fileInfo.exists());
+        QVERIFY(fileInfo.size() > 0);
+        QVERIFY(fileInfo.size() <= maxFileSize);
+    }
+
+    // The newest lines are in the current file
+    QFile file(logFile);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QVERIFY(file.readAll().contains(QStringLiteral("AppMessagesTest rotation line %1\"").arg(cLines - 1).toUtf8()));
+}
+
+/// QML messages pass a file name which only lives for the duration of the call
+void AppMessagesTest::_contextFileTest(void)
+{
+    AppLogModel*    model       = AppMessages::getModel();
+    AppLogWriter*   writer      = model->writer();
+    const quint64   processed   = writer->linesProcessed();
+    const quint64   dropped     = writer->linesDropped();
+
+    {
+        QByteArray file("qrc:/qml/AppMessagesTest.qml");
+        const QMessageLogContext context(file.constData(), 42, nullptr, "qml");
+        writer->log(QtWarningMsg, context, QStringLiteral("AppMessagesTest context file"));
+        file.fill('X');
+    }
+    QVERIFY(_waitForLines(writer, processed, dropped, 1));
+
+    // Lines from the rest of the application may follow
+    bool found = false;
+    for (int row=model->rowCount() - 1; row>=0 && !found; row--) {
+        found = model->data(model->index(row)).toString().endsWith(QStringLiteral("at qrc:/qml/AppMessagesTest.qml:42 - \"AppMessagesTest context file\""));
+    }
+    QVERIFY(found);
+}
+
+/// A fatal message aborts right after the handler, so it and the lines before it must be in the file on return
+void AppMessagesTest::_fatalTest(void)
+{
+    const int cLines = 100;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString logFile = tempDir.filePath("QGCConsole.log");
+
+    AppLogWriter* writer = AppMessages::getModel()->writer();
+    writer->setLogFile(logFile);
+
+    const QMessageLogContext context(__FILE__, __LINE__, Q_FUNC_INFO, "AppMessagesTest");
+    for (int line=0; line<cLines; line++) {
+        writer->log(QtDebugMsg, context, QStringLiteral("AppMessagesTest before fatal line %1").arg(line));
+    }
+    // A real fatal message would abort the test, the writer handles any type the same way
+    writer->logFatal(QtCriticalMsg, context, QStringLiteral("AppMessagesTest fatal"));
+
+    QFile file(logFile);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QByteArray bytes = file.readAll();
+    QVERIFY(bytes.contains(QStringLiteral("AppMessagesTest before fatal line %1\"").arg(cLines - 1).toUtf8()));
+    QVERIFY(bytes.contains("AppMessagesTest fatal\""));
+    QVERIFY(bytes.indexOf("AppMessagesTest before fatal line 0\"") < bytes.indexOf("AppMessagesTest fatal\""));
+
+    writer->setLogFile(QString());
+    QTest::qWait(AppLogWriter::writeIntervalMsecs * 2);
+}
@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class AppLogWriter;
+
+/// Tests the AppMessages log pipeline: throughput from several threads, model bounds, log file rotation and
+/// message context capture
+class AppMessagesTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _throughputTest    (void);
+    void _rotationTest      (void);
+    void _contextFileTest   (void);
+    void _fatalTest         (void);
+
+private:
+    bool _waitForLines(AppLogWriter* writer, quint64 processed, quint64 dropped, quint64 cLines);
+};
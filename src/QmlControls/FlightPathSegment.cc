@@ -20,9 +20,7 @@ FlightPathSegment::FlightPathSegment(const QGeoCoordinate& coord1, double amslCo
     , _coord2AMSLAlt     (amslCoord2Alt)
     , _queryTerrainData (queryTerrainData)
 {
-    _delayedTerrainPathQueryTimer.setSingleShot(true);
-    _delayedTerrainPathQueryTimer.setInterval(200);
-    _delayedTerrainPathQueryTimer.callOnTimeout(this, &FlightPathSegment::_sendTerrainPathQuery);
+    connect(&_terrainProfileQuery, &TerrainProfileQuery::terrainDataReceived, this, &FlightPathSegment::_terrainDataReceived);
     _updateTotalDistance();
 
     qCDebug(FlightPathSegmentLog) << this << "new" << coord1 << coord2 << amslCoord1Alt << amslCoord2Alt << _totalDistance;
@@ -35,7 +33,7 @@ void FlightPathSegment::setCoordinate1(const QGeoCoordinate &coordinate)
     if (_coord1 != coordinate) {
         _coord1 = coordinate;
         emit coordinate1Changed(_coord1);
-        _delayedTerrainPathQueryTimer.start();
+        _sendTerrainPathQuery();
         _updateTotalDistance();
     }
 }
@@ -45,7 +43,7 @@ void FlightPathSegment::setCoordinate2(const QGeoCoordinate &coordinate)
     if (_coord2 != coordinate) {
         _coord2 = coordinate;
         emit coordinate2Changed(_coord2);
-        _delayedTerrainPathQueryTimer.start();
+        _sendTerrainPathQuery();
         _updateTotalDistance();
     }
 }
@@ -80,24 +78,20 @@ void FlightPathSegment::_sendTerrainPathQuery(void)
 {
     if (_queryTerrainData && _coord1.isValid() && _coord2.isValid()) {
         qCDebug(FlightPathSegmentLog) << this << "_sendTerrainPathQuery";
-        // Clear any previous query
-        if (_currentTerrainPathQuery) {
-            // We are already waiting on another query. We don't care about those results any more.
-            disconnect(_currentTerrainPathQuery, &TerrainPathQuery::terrainDataReceived, this, &FlightPathSegment::_terrainDataReceived);
-            _currentTerrainPathQuery = nullptr;
-        }
 
         // Clear old terrain data
-        _amslTerrainHeights.clear();
-        _distanceBetween = 0;
-        _finalDistanceBetween = 0;
-        emit distanceBetweenChanged(0);
-        emit finalDistanceBetweenChanged(0);
-        emit amslTerrainHeightsChanged();
+        if (!_amslTerrainHeights.isEmpty()) {
+            _amslTerrainHeights.clear();
+            _distanceBetween = 0;
+            _finalDistanceBetween = 0;
+            emit distanceBetweenChanged(0);
+            emit finalDistanceBetweenChanged(0);
+            emit amslTerrainHeightsChanged();
+        }
 
-        _currentTerrainPathQuery = new TerrainPathQuery(true /* autoDelete */);
-        connect(_currentTerrainPathQuery, &TerrainPathQuery::terrainDataReceived, this, &FlightPathSegment::_terrainDataReceived);
-        _currentTerrainPathQuery->requestData(_coord1, _coord2);
+        // The request is delayed and batched with the other segments. A previous request which is still outstanding
+        // is replaced, so its results are never signalled.
+        _terrainProfileQuery.requestData(_coord1, _coord2);
     }
 }
 
@@ -121,9 +115,6 @@ void FlightPathSegment::_terrainDataReceived(bool success, const TerrainPathQuer
         emit amslTerrainHeightsChanged();
     }
 
-    _currentTerrainPathQuery->deleteLater();
-    _currentTerrainPathQuery = nullptr;
-
     _updateTerrainCollision();
 }
 
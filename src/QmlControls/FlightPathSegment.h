@@ -11,7 +11,6 @@
 
 #include <QObject>
 #include <QGeoCoordinate>
-#include <QTimer>
 
 #include "TerrainQuery.h"
 #include "QGCLoggingCategory.h"
@@ -82,8 +81,7 @@ private:
     bool                _queryTerrainData;
     bool                _terrainCollision =             false;
     bool                _specialVisual =                false;
-    QTimer              _delayedTerrainPathQueryTimer;
-    TerrainPathQuery*   _currentTerrainPathQuery =      nullptr;
+    TerrainProfileQuery _terrainProfileQuery;           ///< Batched with all other segments, rerequesting replaces an outstanding request
     QVariantList        _amslTerrainHeights;
     double              _distanceBetween =              0;
     double              _finalDistanceBetween =         0;
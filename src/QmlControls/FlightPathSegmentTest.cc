@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FlightPathSegmentTest.h"
+#include "FlightPathSegment.h"
+#include "TerrainQuery.h"
+
+#include <QElapsedTimer>
+
+/// Waits until all segments have terrain heights
+bool FlightPathSegmentTest::_waitForTerrainHeights(const QList<FlightPathSegment*>& segments)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 10000) {
+        bool allHeights = true;
+        for (const FlightPathSegment* segment: segments) {
+            if (segment->amslTerrainHeights().isEmpty()) {
+                allHeights = false;
+                break;
+            }
+        }
+        if (allHeights) {
+            return true;
+        }
+        QTest::qWait(10);
+    }
+    return false;
+}
+
+/// Builds the flight path of an 800 waypoint mission over the sloped test terrain, then edits it the way a user does
+void FlightPathSegmentTest::_batchedTerrainQueryTest(void)
+{
+    const int       cSegments       = 800;
+    const int       cSegmentsPerRow = 40;
+    const double    amslAlt         = UnitTestTerrainQuery::LinearSlopeRegion::maxAMSLElevation + 100;
+
+    // Lawnmower pattern of ~150m segments across the region
+    QList<QGeoCoordinate> rgCoords;
+    const QGeoCoordinate& topLeft = UnitTestTerrainQuery::linearSlopeRegion.topLeft();
+    for (int i=0; i<=cSegments; i++) {
+        int row = i / cSegmentsPerRow;
+        int col = i % cSegmentsPerRow;
+        if (row % 2) {
+            col = cSegmentsPerRow - 1 - col;
+        }
+        rgCoords.append(QGeoCoordinate(topLeft.latitude() - 0.005 - (row * 0.003), topLeft.longitude() + 0.005 + (col * 0.002)));
+    }
+
+    TerrainProfileBatchManager* batchManager    = TerrainProfileQuery::batchManager();
+    const int                   batchCount      = batchManager->batchCount();
+    const int                   pathCount       = batchManager->pathCount();
+    const int                   cacheHitCount   = batchManager->cacheHitCount();
+
+    QObject segmentParent;
+    QList<FlightPathSegment*> segments;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i=0; i<cSegments; i++) {
+        segments.append(new FlightPathSegment(rgCoords[i], amslAlt, rgCoords[i+1], amslAlt, true /* queryTerrainData */, &segmentParent));
+    }
+    QVERIFY(_waitForTerrainHeights(segments));
+    const qint64 initialMsecs = timer.elapsed();
+
+    // All segments go out in a single request
+    QCOMPARE(batchManager->batchCount() - batchCount, 1);
+    QCOMPARE(batchManager->pathCount() - pathCount, cSegments);
+
+    for (const FlightPathSegment* segment: segments) {
+        double distanceBetween;
+        double finalDistanceBetween;
+        QList<QGeoCoordinate> pathCoords = TerrainTileManager::pathQueryToCoords(segment->coordinate1(), segment->coordinate2(), distanceBetween, finalDistanceBetween);
+        QCOMPARE(segment->amslTerrainHeights().count(), pathCoords.count());
+        QCOMPARE(segment->distanceBetween(), distanceBetween);
+        QVERIFY(!segment->terrainCollision());
+    }
+
+    // Terrain raises to the east so heights along an eastbound segment must increase
+    const QVariantList& eastboundHeights = segments[0]->amslTerrainHeights();
+    QVERIFY(eastboundHeights.first().toDouble() < eastboundHeights.last().toDouble());
+
+    segments[0]->setCoord1AMSLAlt(UnitTestTerrainQuery::LinearSlopeRegion::minAMSLElevation - 10);
+    segments[0]->setCoord2AMSLAlt(UnitTestTerrainQuery::LinearSlopeRegion::minAMSLElevation - 10);
+    QVERIFY(segments[0]->terrainCollision());
+
+    // Dragging a waypoint only requests the two segments attached to it
+    QGeoCoordinate movedCoord = rgCoords[cSegments / 2].atDistanceAndAzimuth(100, 45);
+    timer.restart();
+    segments[(cSegments / 2) - 1]->setCoordinate2(movedCoord);
+    segments[cSegments / 2]->setCoordinate1(movedCoord);
+    QVERIFY(_waitForTerrainHeights(segments));
+    const qint64 moveMsecs = timer.elapsed();
+
+    QCOMPARE(batchManager->batchCount() - batchCount, 2);
+    QCOMPARE(batchManager->pathCount() - pathCount, cSegments + 2);
+
+    // Changing the altitude of a waypoint doesn't change the terrain below it
+    QGeoCoordinate altitudeCoord = rgCoords[10];
+    altitudeCoord.setAltitude(amslAlt + 50);
+    segments[9]->setCoordinate2(altitudeCoord);
+    segments[10]->setCoordinate1(altitudeCoord);
+    QVERIFY(_waitForTerrainHeights(segments));
+
+    QCOMPARE(batchManager->batchCount() - batchCount, 2);
+    QCOMPARE(batchManager->cacheHitCount() - cacheHitCount, 2);
+
+    qDebug() << cSegments << "segments: initial terrain in" << initialMsecs << "msecs, moved waypoint in" << moveMsecs << "msecs";
+}
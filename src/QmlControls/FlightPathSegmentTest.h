@@ -9,21 +9,18 @@
 
 #pragma once
 
-#include "TaisyncHandler.h"
-#include <QUdpSocket>
+#include "UnitTest.h"
 
-class TaisyncVideoReceiver : public TaisyncHandler
+class FlightPathSegment;
+
+/// Tests that the terrain queries of a large number of flight path segments are batched and cached
+class FlightPathSegmentTest : public UnitTest
 {
     Q_OBJECT
-public:
-
-    explicit TaisyncVideoReceiver       (QObject* parent = nullptr);
-    bool start                          () override;
-    bool close                          () override;
 
 private slots:
-    void    _readBytes                  () override;
+    void _batchedTerrainQueryTest(void);
 
 private:
-    QUdpSocket*     _udpVideoSocket     = nullptr;
+    bool _waitForTerrainHeights(const QList<FlightPathSegment*>& segments);
 };
@@ -15,6 +15,7 @@
 #include "ComplexMissionItem.h"
 
 #include <QSGSimpleRectNode>
+#include <QtMath>
 
 QGC_LOGGING_CATEGORY(TerrainProfileLog, "TerrainProfileLog")
 
@@ -65,6 +66,7 @@ void TerrainProfile::_createGeometry(QSGGeometryNode*& geometryNode, QSGGeometry
     geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
     geometry->setDrawingMode(drawingMode);
     geometry->setLineWidth(2);
+    geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
 
     geometryNode = new QSGGeometryNode;
     geometryNode->setFlag(QSGNode::OwnsGeometry);
@@ -74,266 +76,381 @@ void TerrainProfile::_createGeometry(QSGGeometryNode*& geometryNode, QSGGeometry
     geometryNode->setGeometry(geometry);
 }
 
-void TerrainProfile::_updateSegmentCounts(FlightPathSegment* segment, int& cFlightProfileSegments, int& cTerrainProfilePoints, int& cMissingTerrainSegments, int& cTerrainCollisionSegments, double& minTerrainHeight, double& maxTerrainHeight)
+QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
 {
-    if (_shouldAddFlightProfileSegment(segment)) {
-        cFlightProfileSegments++;
-    }
+    QSGNode* rootNode = static_cast<QSGNode *>(oldNode);
 
-    if (_shouldAddMissingTerrainSegment(segment)) {
-        cMissingTerrainSegments += 1;
-    } else {
-        cTerrainProfilePoints += segment->amslTerrainHeights().count();
-        for (int i=0; i<segment->amslTerrainHeights().count(); i++) {
-            minTerrainHeight = std::fmin(minTerrainHeight, segment->amslTerrainHeights()[i].value<double>());
-            maxTerrainHeight = std::fmax(maxTerrainHeight, segment->amslTerrainHeights()[i].value<double>());
+    // Collect the spans which make up the flight path, in distance order
+    QVector<TerrainProfileGeometry::PathSpan_t> spans;
+    for (int viIndex=0; viIndex<_visualItems->count(); viIndex++) {
+        VisualMissionItem*  visualItem =    _visualItems->value<VisualMissionItem*>(viIndex);
+        ComplexMissionItem* complexItem =   _visualItems->value<ComplexMissionItem*>(viIndex);
+
+        if (complexItem) {
+            if (complexItem->flightPathSegments()->count() == 0) {
+                spans.append({ nullptr, complexItem->complexDistance() });
+            } else {
+                for (int segmentIndex=0; segmentIndex<complexItem->flightPathSegments()->count(); segmentIndex++) {
+                    FlightPathSegment* segment = complexItem->flightPathSegments()->value<FlightPathSegment*>(segmentIndex);
+                    spans.append({ segment, segment->totalDistance() });
+                }
+            }
+        }
+
+        if (visualItem->simpleFlightPathSegment()) {
+            FlightPathSegment* segment = visualItem->simpleFlightPathSegment();
+            spans.append({ segment, segment->totalDistance() });
         }
     }
-    if (segment->terrainCollision()) {
-        cTerrainCollisionSegments++;
+
+    // Instantiate nodes
+    if (!rootNode) {
+        rootNode = new QSGNode;
+
+        QSGGeometryNode*    terrainProfileNode =        nullptr;
+        QSGGeometryNode*    missingTerrainNode =        nullptr;
+        QSGGeometryNode*    flightProfileNode =         nullptr;
+        QSGGeometryNode*    terrainCollisionNode =      nullptr;
+        QSGGeometry*        terrainProfileGeometry =    nullptr;
+        QSGGeometry*        missingTerrainGeometry =    nullptr;
+        QSGGeometry*        flightProfileGeometry =     nullptr;
+        QSGGeometry*        terrainCollisionGeometry =  nullptr;
+
+        _createGeometry(terrainProfileNode,     terrainProfileGeometry,     QSGGeometry::DrawLineStrip, "green");
+        _createGeometry(missingTerrainNode,     missingTerrainGeometry,     QSGGeometry::DrawLines,     "yellow");
+        _createGeometry(flightProfileNode,      flightProfileGeometry,      QSGGeometry::DrawLines,     "orange");
+        _createGeometry(terrainCollisionNode,   terrainCollisionGeometry,   QSGGeometry::DrawLines,     "red");
+
+        rootNode->appendChildNode(terrainProfileNode);
+        rootNode->appendChildNode(missingTerrainNode);
+        rootNode->appendChildNode(flightProfileNode);
+        rootNode->appendChildNode(terrainCollisionNode);
     }
-}
 
-void TerrainProfile::_addTerrainProfileSegment(FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainVertices, int& terrainProfileVertexIndex)
-{
-    double terrainDistance = 0;
-    for (int heightIndex=0; heightIndex<segment->amslTerrainHeights().count(); heightIndex++) {
-        // Move along the x axis which is distance
-        if (heightIndex == 0) {
-            // The first point in the segment is at the position of the last point. So nothing to do here.
-        } else if (heightIndex == segment->amslTerrainHeights().count() - 2) {
-            // The distance between the last two heights differs with each terrain query
-            terrainDistance += segment->finalDistanceBetween();
-        } else {
-            // The distance between all terrain heights except for the last is the same
-            terrainDistance += segment->distanceBetween();
+    QSGGeometry* geometries[TerrainProfileGeometry::GeometryCount];
+    for (int i=0; i<TerrainProfileGeometry::GeometryCount; i++) {
+        geometries[i] = static_cast<QSGGeometryNode*>(rootNode->childAtIndex(i))->geometry();
+    }
+
+    int changedGeometries = _geometry.update(spans, _missionController->missionDistance(), _missionController->minAMSLAltitude(), _missionController->maxAMSLAltitude(), _visibleWidth, height(), geometries);
+    for (int i=0; i<TerrainProfileGeometry::GeometryCount; i++) {
+        if (changedGeometries & (1 << i)) {
+            rootNode->childAtIndex(i)->markDirty(QSGNode::DirtyGeometry);
         }
+    }
 
-        // Move along the y axis which is a view or terrain height as a percentage between the min/max AMSL altitude for all segments
-        double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex].value<double>();
-        double terrainHeightPercent = (amslTerrainHeight - _minAMSLAlt) / amslAltRange;
+    _pixelsPerMeter =   _geometry.pixelsPerMeter();
+    _minAMSLAlt =       _geometry.minAMSLAlt();
+    _maxAMSLAlt =       _geometry.maxAMSLAlt();
 
-        float x = (currentDistance + terrainDistance) * _pixelsPerMeter;
-        float y = height() - (terrainHeightPercent * height());
-        terrainVertices[terrainProfileVertexIndex++].set(x, y);
-    }
+    static int counter = 0;
+    qCDebug(TerrainProfileLog) << "missionController min/max" << _missionController->minAMSLAltitude() << _missionController->maxAMSLAltitude();
+    qCDebug(TerrainProfileLog) << QStringLiteral("updatePaintNode counter:%1 spans:%2 patchedSpans:%3 patchedColumns:%4 changedGeometries:%5 _minAMSLAlt:%6 _maxAMSLAlt:%7")
+                               .arg(counter++).arg(spans.count()).arg(_geometry.lastPatchedSpans()).arg(_geometry.lastPatchedColumns()).arg(changedGeometries).arg(_minAMSLAlt).arg(_maxAMSLAlt);
+
+    setImplicitWidth(_visibleWidth/*(_totalDistance * pixelsPerMeter) + (_horizontalMargin * 2)*/);
+    setWidth(implicitWidth());
+
+    emit implicitWidthChanged();
+    emit widthChanged();
+    emit pixelsPerMeterChanged();
+    emit minAMSLAltChanged();
+    emit maxAMSLAltChanged();
+
+    return rootNode;
 }
 
-void TerrainProfile::_addMissingTerrainSegment(FlightPathSegment* segment, double currentDistance, QSGGeometry::Point2D* missingTerrainVertices, int& missingterrainProfileVertexIndex)
+TerrainProfileGeometry::TerrainProfileGeometry(void)
 {
-    if (_shouldAddMissingTerrainSegment(segment)) {
-        float x = currentDistance * _pixelsPerMeter;
-        float y = height();
-        missingTerrainVertices[missingterrainProfileVertexIndex++].set(x, y);
-        missingTerrainVertices[missingterrainProfileVertexIndex++].set(x + (segment->totalDistance() * _pixelsPerMeter), y);
-    }
+
 }
 
-void TerrainProfile::_addTerrainCollisionSegment(FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainCollisionVertices, int& terrainCollisionVertexIndex)
+bool TerrainProfileGeometry::_spanChanged(const SpanState_t& spanState, const PathSpan_t& span, double startDistance) const
 {
-    if (segment->terrainCollision()) {
-        double amslCoord1Height =       segment->coord1AMSLAlt();
-        double amslCoord2Height =       segment->coord2AMSLAlt();
-        double coord1HeightPercent =    (amslCoord1Height - _minAMSLAlt) / amslAltRange;
-        double coord2HeightPercent =    (amslCoord2Height - _minAMSLAlt) / amslAltRange;
+    if (spanState.segment != span.segment || !_sameValue(spanState.startDistance, startDistance) || !_sameValue(spanState.distance, span.distance)) {
+        return true;
+    }
+    if (!span.segment) {
+        return false;
+    }
 
-        float x = currentDistance * _pixelsPerMeter;
-        float y = height() - (coord1HeightPercent * height());
+    FlightPathSegment* segment = span.segment;
+    return !_sameValue(spanState.coord1AMSLAlt, segment->coord1AMSLAlt()) ||
+            !_sameValue(spanState.coord2AMSLAlt, segment->coord2AMSLAlt()) ||
+            spanState.terrainCollision != segment->terrainCollision() ||
+            !spanState.amslTerrainHeights.isSharedWith(segment->amslTerrainHeights()) ||
+            !_sameValue(spanState.distanceBetween, segment->distanceBetween()) ||
+            !_sameValue(spanState.finalDistanceBetween, segment->finalDistanceBetween());
+}
 
-        terrainCollisionVertices[terrainCollisionVertexIndex++].set(x, y);
+void TerrainProfileGeometry::_setSpanState(SpanState_t& spanState, const PathSpan_t& span, double startDistance)
+{
+    FlightPathSegment* segment = span.segment;
+
+    spanState.segment               = segment;
+    spanState.startDistance         = startDistance;
+    spanState.distance              = span.distance;
+    spanState.coord1AMSLAlt         = segment ? segment->coord1AMSLAlt() : qQNaN();
+    spanState.coord2AMSLAlt         = segment ? segment->coord2AMSLAlt() : qQNaN();
+    spanState.terrainCollision      = segment ? segment->terrainCollision() : false;
+    spanState.amslTerrainHeights    = segment ? segment->amslTerrainHeights() : QVariantList();
+    spanState.distanceBetween       = segment ? segment->distanceBetween() : 0;
+    spanState.finalDistanceBetween  = segment ? segment->finalDistanceBetween() : 0;
+    spanState.minTerrainHeight      = qQNaN();
+    spanState.maxTerrainHeight      = qQNaN();
+    for (const QVariant& amslTerrainHeight: spanState.amslTerrainHeights) {
+        spanState.minTerrainHeight = std::fmin(spanState.minTerrainHeight, amslTerrainHeight.toDouble());
+        spanState.maxTerrainHeight = std::fmax(spanState.maxTerrainHeight, amslTerrainHeight.toDouble());
+    }
+}
 
-        x += segment->totalDistance() * _pixelsPerMeter;
-        y = height() - (coord2HeightPercent * height());
+int TerrainProfileGeometry::_distanceToColumn(double distance) const
+{
+    return qBound(0, static_cast<int>(distance * _pixelsPerMeter), _columnMinHeights.count() - 1);
+}
 
-        terrainCollisionVertices[terrainCollisionVertexIndex++].set(x, y);
+/// @return false: Span has no terrain heights
+bool TerrainProfileGeometry::_spanColumns(const SpanState_t& spanState, int& firstColumn, int& lastColumn) const
+{
+    if (spanState.amslTerrainHeights.isEmpty()) {
+        return false;
     }
+    firstColumn = _distanceToColumn(spanState.startDistance);
+    lastColumn  = _distanceToColumn(spanState.startDistance + spanState.distance);
+    return true;
 }
 
-void TerrainProfile::_addFlightProfileSegment(FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* flightProfileVertices, int& flightProfileVertexIndex)
+/// Rebuilds the min/max terrain heights of the specified columns from all spans which cover them
+void TerrainProfileGeometry::_buildColumns(int firstColumn, int lastColumn)
 {
-    if (!_shouldAddFlightProfileSegment(segment)) {
-        return;
+    for (int column=firstColumn; column<=lastColumn; column++) {
+        _columnMinHeights[column] = qQNaN();
+        _columnMaxHeights[column] = qQNaN();
     }
 
-    double amslCoord1Height =       segment->coord1AMSLAlt();
-    double amslCoord2Height =       segment->coord2AMSLAlt();
-    double coord1HeightPercent =    (amslCoord1Height - _minAMSLAlt) / amslAltRange;
-    double coord2HeightPercent =    (amslCoord2Height - _minAMSLAlt) / amslAltRange;
-
-    float x = currentDistance * _pixelsPerMeter;
-    float y = height() - (coord1HeightPercent * height());
+    for (const SpanState_t& spanState: _spans) {
+        int spanFirstColumn;
+        int spanLastColumn;
+        if (!_spanColumns(spanState, spanFirstColumn, spanLastColumn) || spanLastColumn < firstColumn || spanFirstColumn > lastColumn) {
+            continue;
+        }
 
-    flightProfileVertices[flightProfileVertexIndex++].set(x, y);
+        // All terrain heights except for the last are the same distance apart
+        const QVariantList& amslTerrainHeights = spanState.amslTerrainHeights;
+        for (int heightIndex=0; heightIndex<amslTerrainHeights.count(); heightIndex++) {
+            double terrainDistance;
+            if (heightIndex == amslTerrainHeights.count() - 1 && heightIndex > 0) {
+                terrainDistance = ((heightIndex - 1) * spanState.distanceBetween) + spanState.finalDistanceBetween;
+            } else {
+                terrainDistance = heightIndex * spanState.distanceBetween;
+            }
 
-    x += segment->totalDistance() * _pixelsPerMeter;
-    y = height() - (coord2HeightPercent * height());
+            int column = _distanceToColumn(spanState.startDistance + terrainDistance);
+            if (column >= firstColumn && column <= lastColumn) {
+                double amslTerrainHeight = amslTerrainHeights[heightIndex].toDouble();
+                _columnMinHeights[column] = std::fmin(_columnMinHeights[column], amslTerrainHeight);
+                _columnMaxHeights[column] = std::fmax(_columnMaxHeights[column], amslTerrainHeight);
+            }
+        }
+    }
+}
 
-    flightProfileVertices[flightProfileVertexIndex++].set(x, y);
+float TerrainProfileGeometry::_altToY(double amslAlt) const
+{
+    // The y axis is the height as a percentage between the min/max AMSL altitude for all segments
+    double heightPercent = (amslAlt - _minAMSLAlt) / (_maxAMSLAlt - _minAMSLAlt);
+    return static_cast<float>(_height - (heightPercent * _height));
 }
 
-QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+/// Each column is a vertical line from the min to the max terrain height which the line strip then connects to the next
+/// column. Columns without terrain heights collapse onto the end of the previous column, so the strip runs straight
+/// across them. Columns before the first terrain height collapse onto the start of the first.
+void TerrainProfileGeometry::_writeColumnVertices(QSGGeometry::Point2D* vertices, int firstColumn, int lastColumn)
 {
-    QSGNode*        rootNode =                  static_cast<QSGNode *>(oldNode);
-    QSGGeometry*    terrainProfileGeometry =    nullptr;
-    QSGGeometry*    missingTerrainGeometry =    nullptr;
-    QSGGeometry*    flightProfileGeometry =     nullptr;
-    QSGGeometry*    terrainCollisionGeometry =  nullptr;
-    int             cTerrainProfilePoints =     0;
-    int             cMissingTerrainSegments =   0;
-    int             cFlightProfileSegments =    0;
-    int             cTerrainCollisionSegments = 0;
-    double          minTerrainHeight =          qQNaN();
-    double          maxTerrainHeight =          qQNaN();
-
-    // First we need to determine:
-    //  - how many terrain profile vertices we need
-    //  - how many missing terrain segments there are
-    //  - how many flight profile segments we need
-    //  - how many terrain collision segments there are
-    //  - what is the total distance so we can calculate pixels per meter
+    const int cColumns = _columnMinHeights.count();
 
-    for (int viIndex=0; viIndex<_visualItems->count(); viIndex++) {
-        VisualMissionItem*  visualItem =    _visualItems->value<VisualMissionItem*>(viIndex);
-        ComplexMissionItem* complexItem =   _visualItems->value<ComplexMissionItem*>(viIndex);
+    int firstTerrainColumn = 0;
+    while (firstTerrainColumn < cColumns && qIsNaN(_columnMinHeights[firstTerrainColumn])) {
+        firstTerrainColumn++;
+    }
+    if (firstColumn <= firstTerrainColumn) {
+        firstColumn = 0;
+    }
+    while (lastColumn + 1 < cColumns && qIsNaN(_columnMinHeights[lastColumn + 1])) {
+        lastColumn++;
+    }
 
-        if (visualItem->simpleFlightPathSegment()) {
-            FlightPathSegment* segment = visualItem->simpleFlightPathSegment();
-            _updateSegmentCounts(segment, cFlightProfileSegments, cTerrainProfilePoints, cMissingTerrainSegments, cTerrainCollisionSegments, minTerrainHeight, maxTerrainHeight);
-        }
+    for (int column=firstColumn; column<=lastColumn; column++) {
+        QSGGeometry::Point2D& minVertex = vertices[column * 2];
+        QSGGeometry::Point2D& maxVertex = vertices[(column * 2) + 1];
 
-        if (complexItem) {
-            for (int segmentIndex=0; segmentIndex<complexItem->flightPathSegments()->count(); segmentIndex++) {
-                FlightPathSegment* segment = complexItem->flightPathSegments()->value<FlightPathSegment*>(segmentIndex);
-                _updateSegmentCounts(segment, cFlightProfileSegments, cTerrainProfilePoints, cMissingTerrainSegments, cTerrainCollisionSegments, minTerrainHeight, maxTerrainHeight);
+        if (!qIsNaN(_columnMinHeights[column])) {
+            minVertex.set(column, _altToY(_columnMinHeights[column]));
+            maxVertex.set(column, _altToY(_columnMaxHeights[column]));
+        } else if (column < firstTerrainColumn) {
+            if (firstTerrainColumn < cColumns) {
+                minVertex.set(firstTerrainColumn, _altToY(_columnMinHeights[firstTerrainColumn]));
+            } else {
+                minVertex.set(0, static_cast<float>(_height));
             }
+            maxVertex = minVertex;
+        } else {
+            minVertex = maxVertex = vertices[(column * 2) - 1];
         }
     }
 
-    // The profile view min/max is setup to include a full terrain profile as well as the flight path segments.
-    _minAMSLAlt = std::fmin(_missionController->minAMSLAltitude(), minTerrainHeight);
-    _maxAMSLAlt = std::fmax(_missionController->maxAMSLAltitude(), maxTerrainHeight);
+    _lastPatchedColumns += lastColumn - firstColumn + 1;
+}
 
-    // We add a buffer to the min/max alts such that the visuals don't draw lines right at the edges of the display
-    double amslAltRange = _maxAMSLAlt - _minAMSLAlt;
-    double amslAltRangeBuffer = amslAltRange * 0.1;
-    _maxAMSLAlt += amslAltRangeBuffer;
-    if (_minAMSLAlt > 0.0) {
-        _minAMSLAlt -= amslAltRangeBuffer;
-        _minAMSLAlt = std::fmax(_minAMSLAlt, 0.0);
+void TerrainProfileGeometry::_writeSpanVertices(QSGGeometry* geometries[GeometryCount], int spanIndex)
+{
+    const SpanState_t&      spanState           = _spans[spanIndex];
+    QSGGeometry::Point2D*   flightVertices      = geometries[GeometryFlightProfile]->vertexDataAsPoint2D() + (spanIndex * 2);
+    QSGGeometry::Point2D*   missingVertices     = geometries[GeometryMissingTerrain]->vertexDataAsPoint2D() + (spanIndex * 2);
+    QSGGeometry::Point2D*   collisionVertices   = geometries[GeometryTerrainCollision]->vertexDataAsPoint2D() + (spanIndex * 2);
+    float                   x1                  = static_cast<float>(spanState.startDistance * _pixelsPerMeter);
+    float                   x2                  = static_cast<float>((spanState.startDistance + spanState.distance) * _pixelsPerMeter);
+    float                   bottom              = static_cast<float>(_height);
+
+    // Spans which don't draw a line get a degenerate one
+    flightVertices[0].set(x1, bottom);
+    flightVertices[1] = flightVertices[0];
+    missingVertices[0].set(x1, bottom);
+    missingVertices[1] = missingVertices[0];
+    collisionVertices[0].set(x1, bottom);
+    collisionVertices[1] = collisionVertices[0];
+
+    _lastPatchedSpans++;
+
+    if (!spanState.segment) {
+        return;
     }
-    amslAltRange = _maxAMSLAlt - _minAMSLAlt;
-
-    static int counter = 0;
-    qCDebug(TerrainProfileLog) << "missionController min/max" << _missionController->minAMSLAltitude() << _missionController->maxAMSLAltitude();
-    qCDebug(TerrainProfileLog) << QStringLiteral("updatePaintNode counter:%1 cFlightProfileSegments:%2 cTerrainProfilePoints:%3 cMissingTerrainSegments:%4 cTerrainCollisionSegments:%5 _minAMSLAlt:%6 _maxAMSLAlt:%7 maxTerrainHeight:%8")
-                               .arg(counter++).arg(cFlightProfileSegments).arg(cTerrainProfilePoints).arg(cMissingTerrainSegments).arg(cTerrainCollisionSegments).arg(_minAMSLAlt).arg(_maxAMSLAlt).arg(maxTerrainHeight);
-
-    _pixelsPerMeter = _visibleWidth / _missionController->missionDistance();
 
-    // Instantiate nodes
-    if (!rootNode) {
-        rootNode = new QSGNode;
+    if (!qIsNaN(spanState.coord1AMSLAlt) && !qIsNaN(spanState.coord2AMSLAlt)) {
+        flightVertices[0].set(x1, _altToY(spanState.coord1AMSLAlt));
+        flightVertices[1].set(x2, _altToY(spanState.coord2AMSLAlt));
+    }
+    if (spanState.amslTerrainHeights.isEmpty()) {
+        missingVertices[1].set(x2, bottom);
+    }
+    if (spanState.terrainCollision) {
+        collisionVertices[0].set(x1, _altToY(spanState.coord1AMSLAlt));
+        collisionVertices[1].set(x2, _altToY(spanState.coord2AMSLAlt));
+    }
+}
 
-        QSGGeometryNode* terrainProfileNode =   nullptr;
-        QSGGeometryNode* missingTerrainNode =   nullptr;
-        QSGGeometryNode* flightProfileNode =    nullptr;
-        QSGGeometryNode* terrainCollisionNode = nullptr;
+int TerrainProfileGeometry::update(const QVector<PathSpan_t>& spans, double missionDistance, double missionMinAMSLAlt, double missionMaxAMSLAlt, double width, double height, QSGGeometry* geometries[GeometryCount])
+{
+    const int cSpans    = spans.count();
+    const int cColumns  = qMax(1, qCeil(width)) + 1;
+
+    _lastPatchedSpans   = 0;
+    _lastPatchedColumns = 0;
+
+    // A different layout moves every vertex, so everything is rebuilt
+    bool rebuildAll = cSpans != _spans.count() ||
+            !_sameValue(missionDistance, _missionDistance) ||
+            !_sameValue(width, _width) ||
+            !_sameValue(height, _height) ||
+            geometries[GeometryTerrainProfile]->vertexCount() != cColumns * 2;
+    for (int i=GeometryMissingTerrain; i<GeometryCount; i++) {
+        rebuildAll |= geometries[i]->vertexCount() != cSpans * 2;
+    }
 
-        _createGeometry(terrainProfileNode,     terrainProfileGeometry,     QSGGeometry::DrawLineStrip, "green");
-        _createGeometry(missingTerrainNode,     missingTerrainGeometry,     QSGGeometry::DrawLines,     "yellow");
-        _createGeometry(flightProfileNode,      flightProfileGeometry,      QSGGeometry::DrawLines,     "orange");
-        _createGeometry(terrainCollisionNode,   terrainCollisionGeometry,   QSGGeometry::DrawLines,     "red");
+    _missionDistance    = missionDistance;
+    _width              = width;
+    _height             = height;
+    _pixelsPerMeter     = missionDistance > 0 ? width / missionDistance : 0;
 
-        rootNode->appendChildNode(terrainProfileNode);
-        rootNode->appendChildNode(missingTerrainNode);
-        rootNode->appendChildNode(flightProfileNode);
-        rootNode->appendChildNode(terrainCollisionNode);
+    if (rebuildAll) {
+        _spans.resize(cSpans);
+        _columnMinHeights.fill(qQNaN(), cColumns);
+        _columnMaxHeights.fill(qQNaN(), cColumns);
     }
 
-    // Allocate space for the vertices
-
-    QSGNode* node = rootNode->childAtIndex(0);
-    terrainProfileGeometry = static_cast<QSGGeometryNode*>(node)->geometry();
-    terrainProfileGeometry->allocate(cTerrainProfilePoints);
-    node->markDirty(QSGNode::DirtyGeometry);
-
-    node = rootNode->childAtIndex(1);
-    missingTerrainGeometry = static_cast<QSGGeometryNode*>(node)->geometry();
-    missingTerrainGeometry->allocate(cMissingTerrainSegments * 2);
-    node->markDirty(QSGNode::DirtyGeometry);
-
-    node = rootNode->childAtIndex(2);
-    flightProfileGeometry = static_cast<QSGGeometryNode*>(node)->geometry();
-    flightProfileGeometry->allocate(cFlightProfileSegments * 2);
-    node->markDirty(QSGNode::DirtyGeometry);
-
-    node = rootNode->childAtIndex(3);
-    terrainCollisionGeometry = static_cast<QSGGeometryNode*>(node)->geometry();
-    terrainCollisionGeometry->allocate(cTerrainCollisionSegments * 2);
-    node->markDirty(QSGNode::DirtyGeometry);
-
-    int                     flightProfileVertexIndex =          0;
-    int                     terrainProfileVertexIndex =         0;
-    int                     missingterrainProfileVertexIndex =  0;
-    int                     terrainCollisionVertexIndex =       0;
-    double                  currentDistance =                   0;
-    QSGGeometry::Point2D*   flightProfileVertices =             flightProfileGeometry->vertexDataAsPoint2D();
-    QSGGeometry::Point2D*   terrainProfileVertices =            terrainProfileGeometry->vertexDataAsPoint2D();
-    QSGGeometry::Point2D*   missingTerrainVertices =            missingTerrainGeometry->vertexDataAsPoint2D();
-    QSGGeometry::Point2D*   terrainCollisionVertices =          terrainCollisionGeometry->vertexDataAsPoint2D();
-
-    // This step places the vertices for display into the nodes
-    for (int viIndex=0; viIndex<_visualItems->count(); viIndex++) {
-        VisualMissionItem*  visualItem =    _visualItems->value<VisualMissionItem*>(viIndex);
-        ComplexMissionItem* complexItem =   _visualItems->value<ComplexMissionItem*>(viIndex);
+    // Find the changed spans and the terrain columns they covered before and after the change
+    QVector<int>    changedSpans;
+    int             firstChangedColumn  = cColumns;
+    int             lastChangedColumn   = -1;
+    double          startDistance       = 0;
+    for (int spanIndex=0; spanIndex<cSpans; spanIndex++) {
+        SpanState_t& spanState = _spans[spanIndex];
+
+        if (rebuildAll || _spanChanged(spanState, spans[spanIndex], startDistance)) {
+            int firstColumn;
+            int lastColumn;
+
+            if (!rebuildAll && _spanColumns(spanState, firstColumn, lastColumn)) {
+                firstChangedColumn  = qMin(firstChangedColumn, firstColumn);
+                lastChangedColumn   = qMax(lastChangedColumn, lastColumn);
+            }
+            _setSpanState(spanState, spans[spanIndex], startDistance);
+            if (_spanColumns(spanState, firstColumn, lastColumn)) {
+                firstChangedColumn  = qMin(firstChangedColumn, firstColumn);
+                lastChangedColumn   = qMax(lastChangedColumn, lastColumn);
+            }
+            changedSpans.append(spanIndex);
+        }
 
-        if (complexItem) {
-            if (complexItem->flightPathSegments()->count() == 0) {
-                currentDistance += complexItem->complexDistance();
-            } else {
-                for (int segmentIndex=0; segmentIndex<complexItem->flightPathSegments()->count(); segmentIndex++) {
-                    FlightPathSegment* segment = complexItem->flightPathSegments()->value<FlightPathSegment*>(segmentIndex);
+        startDistance += spans[spanIndex].distance;
+    }
 
-                    _addFlightProfileSegment    (segment, currentDistance, amslAltRange,    flightProfileVertices,      flightProfileVertexIndex);
-                    _addTerrainProfileSegment   (segment, currentDistance, amslAltRange,    terrainProfileVertices,     terrainProfileVertexIndex);
-                    _addMissingTerrainSegment   (segment, currentDistance,                  missingTerrainVertices,     missingterrainProfileVertexIndex);
-                    _addTerrainCollisionSegment (segment, currentDistance, amslAltRange,    terrainCollisionVertices,   terrainCollisionVertexIndex);
+    if (!rebuildAll && changedSpans.isEmpty()) {
+        return 0;
+    }
 
-                    currentDistance += segment->totalDistance();
-                }
-            }
-        }
+    // The profile view min/max is setup to include a full terrain profile as well as the flight path segments.
+    double minTerrainHeight = qQNaN();
+    double maxTerrainHeight = qQNaN();
+    for (const SpanState_t& spanState: _spans) {
+        minTerrainHeight = std::fmin(minTerrainHeight, spanState.minTerrainHeight);
+        maxTerrainHeight = std::fmax(maxTerrainHeight, spanState.maxTerrainHeight);
+    }
+    double minAMSLAlt = std::fmin(missionMinAMSLAlt, minTerrainHeight);
+    double maxAMSLAlt = std::fmax(missionMaxAMSLAlt, maxTerrainHeight);
 
-        if (visualItem->simpleFlightPathSegment()) {
-            FlightPathSegment* segment = visualItem->simpleFlightPathSegment();
+    // We add a buffer to the min/max alts such that the visuals don't draw lines right at the edges of the display
+    double amslAltRangeBuffer = (maxAMSLAlt - minAMSLAlt) * 0.1;
+    maxAMSLAlt += amslAltRangeBuffer;
+    if (minAMSLAlt > 0.0) {
+        minAMSLAlt -= amslAltRangeBuffer;
+        minAMSLAlt = std::fmax(minAMSLAlt, 0.0);
+    }
 
-            _addFlightProfileSegment    (segment, currentDistance, amslAltRange,    flightProfileVertices,      flightProfileVertexIndex);
-            _addTerrainProfileSegment   (segment, currentDistance, amslAltRange,    terrainProfileVertices,     terrainProfileVertexIndex);
-            _addMissingTerrainSegment   (segment, currentDistance,                  missingTerrainVertices,     missingterrainProfileVertexIndex);
-            _addTerrainCollisionSegment (segment, currentDistance, amslAltRange,    terrainCollisionVertices,   terrainCollisionVertexIndex);
+    // A different altitude range moves every vertex vertically
+    bool rewriteAll = rebuildAll || !_sameValue(minAMSLAlt, _minAMSLAlt) || !_sameValue(maxAMSLAlt, _maxAMSLAlt);
+    _minAMSLAlt = minAMSLAlt;
+    _maxAMSLAlt = maxAMSLAlt;
 
-            currentDistance += segment->totalDistance();
+    if (rebuildAll) {
+        for (int i=0; i<GeometryCount; i++) {
+            geometries[i]->allocate(i == GeometryTerrainProfile ? cColumns * 2 : cSpans * 2);
         }
+        _buildColumns(0, cColumns - 1);
+    } else if (lastChangedColumn >= firstChangedColumn) {
+        _buildColumns(firstChangedColumn, lastChangedColumn);
     }
 
-    setImplicitWidth(_visibleWidth/*(_totalDistance * pixelsPerMeter) + (_horizontalMargin * 2)*/);
-    setWidth(implicitWidth());
-
-    emit implicitWidthChanged();
-    emit widthChanged();
-    emit pixelsPerMeterChanged();
-    emit minAMSLAltChanged();
-    emit maxAMSLAltChanged();
+    int changedGeometries = 0;
 
-    return rootNode;
-}
+    if (rewriteAll) {
+        _writeColumnVertices(geometries[GeometryTerrainProfile]->vertexDataAsPoint2D(), 0, cColumns - 1);
+        changedGeometries |= 1 << GeometryTerrainProfile;
+    } else if (lastChangedColumn >= firstChangedColumn) {
+        _writeColumnVertices(geometries[GeometryTerrainProfile]->vertexDataAsPoint2D(), firstChangedColumn, lastChangedColumn);
+        changedGeometries |= 1 << GeometryTerrainProfile;
+    }
 
-bool TerrainProfile::_shouldAddFlightProfileSegment  (FlightPathSegment* segment)
-{
-    return !qIsNaN(segment->coord1AMSLAlt()) && !qIsNaN(segment->coord2AMSLAlt());
-}
+    if (rewriteAll) {
+        for (int spanIndex=0; spanIndex<cSpans; spanIndex++) {
+            _writeSpanVertices(geometries, spanIndex);
+        }
+    } else {
+        for (int spanIndex: changedSpans) {
+            _writeSpanVertices(geometries, spanIndex);
+        }
+    }
+    changedGeometries |= (1 << GeometryMissingTerrain) | (1 << GeometryFlightProfile) | (1 << GeometryTerrainCollision);
 
-bool TerrainProfile::_shouldAddMissingTerrainSegment (FlightPathSegment* segment)
-{
-    return segment->amslTerrainHeights().count() == 0;
+    return changedGeometries;
 }
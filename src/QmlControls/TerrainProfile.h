@@ -13,6 +13,8 @@
 #include <QTimer>
 #include <QSGGeometryNode>
 #include <QSGGeometry>
+#include <QVector>
+#include <QVariantList>
 
 #include "QGCLoggingCategory.h"
 
@@ -22,6 +24,82 @@ class MissionController;
 class QmlObjectListModel;
 class FlightPathSegment;
 
+/// Builds the vertices of the terrain profile view. It is independent of the scene graph so the geometry build can be
+/// benchmarked without rendering.
+///
+/// The flight profile, missing terrain and terrain collision lines have a fixed two vertex range per span. That range is
+/// patched in place when the span changes, and spans which don't draw a line get a degenerate one. Terrain heights are
+/// decimated to the min/max height within each pixel column, so the terrain vertex count depends on the view width and
+/// not on the mission length. A changed span only rebuilds the terrain columns it covers.
+class TerrainProfileGeometry
+{
+public:
+    TerrainProfileGeometry(void);
+
+    typedef struct {
+        FlightPathSegment*  segment;    ///< nullptr for a complex item without flight path segments
+        double              distance;   ///< Distance covered by the span
+    } PathSpan_t;
+
+    /// Geometry types, in the order of the terrain profile child nodes
+    enum GeometryType {
+        GeometryTerrainProfile,
+        GeometryMissingTerrain,
+        GeometryFlightProfile,
+        GeometryTerrainCollision,
+        GeometryCount
+    };
+
+    /// Updates the vertices for the spans which make up the mission flight path
+    ///     @param geometries Geometry for each GeometryType, reallocated only when the vertex count changes
+    /// @return Mask of (1 << GeometryType) for the geometries whose vertices changed
+    int update(const QVector<PathSpan_t>& spans, double missionDistance, double missionMinAMSLAlt, double missionMaxAMSLAlt, double width, double height, QSGGeometry* geometries[GeometryCount]);
+
+    double  minAMSLAlt          (void) const { return _minAMSLAlt; }
+    double  maxAMSLAlt          (void) const { return _maxAMSLAlt; }
+    double  pixelsPerMeter      (void) const { return _pixelsPerMeter; }
+    int     lastPatchedSpans    (void) const { return _lastPatchedSpans; }      ///< Spans whose vertices were rebuilt by the last update
+    int     lastPatchedColumns  (void) const { return _lastPatchedColumns; }    ///< Terrain columns rebuilt by the last update
+
+private:
+    typedef struct {
+        FlightPathSegment*  segment;
+        double              startDistance;
+        double              distance;
+        double              coord1AMSLAlt;
+        double              coord2AMSLAlt;
+        bool                terrainCollision;
+        QVariantList        amslTerrainHeights;     ///< Shared with the segment, so changed heights no longer share data
+        double              distanceBetween;
+        double              finalDistanceBetween;
+        double              minTerrainHeight;
+        double              maxTerrainHeight;
+    } SpanState_t;
+
+    bool    _spanChanged            (const SpanState_t& spanState, const PathSpan_t& span, double startDistance) const;
+    void    _setSpanState           (SpanState_t& spanState, const PathSpan_t& span, double startDistance);
+    bool    _spanColumns            (const SpanState_t& spanState, int& firstColumn, int& lastColumn) const;
+    int     _distanceToColumn       (double distance) const;
+    void    _buildColumns           (int firstColumn, int lastColumn);
+    void    _writeColumnVertices    (QSGGeometry::Point2D* vertices, int firstColumn, int lastColumn);
+    void    _writeSpanVertices      (QSGGeometry* geometries[GeometryCount], int spanIndex);
+    float   _altToY                 (double amslAlt) const;
+
+    static bool _sameValue(double value1, double value2) { return (qIsNaN(value1) && qIsNaN(value2)) || value1 == value2; }
+
+    QVector<SpanState_t>    _spans;
+    QVector<double>         _columnMinHeights;      ///< Min terrain height within each pixel column, NaN for no heights
+    QVector<double>         _columnMaxHeights;
+    double                  _missionDistance    = 0;
+    double                  _width              = 0;
+    double                  _height             = 0;
+    double                  _pixelsPerMeter     = 0;
+    double                  _minAMSLAlt         = 0;
+    double                  _maxAMSLAlt         = 0;
+    int                     _lastPatchedSpans   = 0;
+    int                     _lastPatchedColumns = 0;
+};
+
 class TerrainProfile : public QQuickItem
 {
     Q_OBJECT
@@ -58,20 +136,14 @@ private slots:
 
 private:
     void    _createGeometry                 (QSGGeometryNode*& geometryNode, QSGGeometry*& geometry, QSGGeometry::DrawingMode drawingMode, const QColor& color);
-    void    _updateSegmentCounts            (FlightPathSegment* segment, int& cFlightProfileSegments, int& cTerrainPoints, int& cMissingTerrainSegments, int& cTerrainCollisionSegments, double& minTerrainHeight, double& maxTerrainHeight);
-    void    _addTerrainProfileSegment       (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainProfileVertices, int& terrainVertexIndex);
-    void    _addMissingTerrainSegment       (FlightPathSegment* segment, double currentDistance, QSGGeometry::Point2D* missingTerrainVertices, int& missingTerrainVertexIndex);
-    void    _addTerrainCollisionSegment     (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainCollisionVertices, int& terrainCollisionVertexIndex);
-    void    _addFlightProfileSegment        (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* flightProfileVertices, int& flightProfileVertexIndex);
-    bool    _shouldAddFlightProfileSegment  (FlightPathSegment* segment);
-    bool    _shouldAddMissingTerrainSegment (FlightPathSegment* segment);
-
-    MissionController*  _missionController =    nullptr;
-    QmlObjectListModel* _visualItems =          nullptr;
-    double              _visibleWidth =         0;
-    double              _pixelsPerMeter =       0;
-    double              _minAMSLAlt =           0;
-    double              _maxAMSLAlt =           0;
+
+    MissionController*      _missionController =    nullptr;
+    QmlObjectListModel*     _visualItems =          nullptr;
+    TerrainProfileGeometry  _geometry;
+    double                  _visibleWidth =         0;
+    double                  _pixelsPerMeter =       0;
+    double                  _minAMSLAlt =           0;
+    double                  _maxAMSLAlt =           0;
 
     static const int _lineWidth =       7;
 
@@ -0,0 +1,118 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainProfileTest.h"
+#include "TerrainProfile.h"
+#include "FlightPathSegment.h"
+#include "TerrainQuery.h"
+
+#include <QElapsedTimer>
+
+void TerrainProfileTest::_geometryTest(void)
+{
+    const int       cSegments   = 800;
+    const double    width       = 1000;
+    const double    height      = 200;
+    const double    amslAlt     = UnitTestTerrainQuery::LinearSlopeRegion::maxAMSLElevation + 100;
+
+    // Segments run back and forth across the full width of the sloped terrain, ~200 terrain heights each
+    QList<QGeoCoordinate> rgCoords;
+    const QGeoCoordinate& topLeft = UnitTestTerrainQuery::linearSlopeRegion.topLeft();
+    for (int i=0; i<=cSegments; i++) {
+        rgCoords.append(QGeoCoordinate(topLeft.latitude() - 0.005 - (i * 0.0001), topLeft.longitude() + ((i % 2) ? 0.085 : 0.005)));
+    }
+
+    QObject segmentParent;
+    QVector<TerrainProfileGeometry::PathSpan_t> spans;
+    double missionDistance = 0;
+    for (int i=0; i<cSegments; i++) {
+        FlightPathSegment* segment = new FlightPathSegment(rgCoords[i], amslAlt, rgCoords[i+1], amslAlt, true /* queryTerrainData */, &segmentParent);
+        spans.append({ segment, segment->totalDistance() });
+        missionDistance += segment->totalDistance();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    bool allHeights = false;
+    while (!allHeights && timer.elapsed() < 10000) {
+        QTest::qWait(10);
+        allHeights = true;
+        for (const TerrainProfileGeometry::PathSpan_t& span: spans) {
+            allHeights &= !span.segment->amslTerrainHeights().isEmpty();
+        }
+    }
+    QVERIFY(allHeights);
+
+    int cTerrainHeights = 0;
+    for (const TerrainProfileGeometry::PathSpan_t& span: spans) {
+        cTerrainHeights += span.segment->amslTerrainHeights().count();
+    }
+
+    QSGGeometry terrainProfileGeometry   (QSGGeometry::defaultAttributes_Point2D(), 0);
+    QSGGeometry missingTerrainGeometry   (QSGGeometry::defaultAttributes_Point2D(), 0);
+    QSGGeometry flightProfileGeometry    (QSGGeometry::defaultAttributes_Point2D(), 0);
+    QSGGeometry terrainCollisionGeometry (QSGGeometry::defaultAttributes_Point2D(), 0);
+    QSGGeometry* geometries[TerrainProfileGeometry::GeometryCount] = { &terrainProfileGeometry, &missingTerrainGeometry, &flightProfileGeometry, &terrainCollisionGeometry };
+
+    const double minAMSLAlt = UnitTestTerrainQuery::LinearSlopeRegion::minAMSLElevation;
+    TerrainProfileGeometry profileGeometry;
+
+    // Full build
+    timer.restart();
+    int changedGeometries = profileGeometry.update(spans, missionDistance, minAMSLAlt, amslAlt, width, height, geometries);
+    const qint64 buildUsecs = timer.nsecsElapsed() / 1000;
+
+    QCOMPARE(changedGeometries, (1 << TerrainProfileGeometry::GeometryCount) - 1);
+    QCOMPARE(profileGeometry.lastPatchedSpans(), cSegments);
+
+    // Terrain vertices are bounded by the view width, not by the number of terrain heights
+    QVERIFY(terrainProfileGeometry.vertexCount() <= (width + 2) * 2);
+    QVERIFY(terrainProfileGeometry.vertexCount() < cTerrainHeights);
+    QCOMPARE(flightProfileGeometry.vertexCount(), cSegments * 2);
+
+    const QSGGeometry::Point2D* terrainVertices = terrainProfileGeometry.vertexDataAsPoint2D();
+    for (int i=0; i<terrainProfileGeometry.vertexCount(); i++) {
+        QVERIFY(terrainVertices[i].x >= 0 && terrainVertices[i].x <= width + 1);
+        QVERIFY(terrainVertices[i].y >= 0 && terrainVertices[i].y <= height);
+    }
+
+    // Nothing changed
+    QCOMPARE(profileGeometry.update(spans, missionDistance, minAMSLAlt, amslAlt, width, height, geometries), 0);
+
+    // Editing the altitude of a single segment only patches that segment
+    FlightPathSegment* segment = spans[cSegments / 2].segment;
+    timer.restart();
+    segment->setCoord2AMSLAlt(amslAlt - 10);
+    changedGeometries = profileGeometry.update(spans, missionDistance, minAMSLAlt, amslAlt, width, height, geometries);
+    const qint64 altitudeUsecs = timer.nsecsElapsed() / 1000;
+
+    QVERIFY(changedGeometries & (1 << TerrainProfileGeometry::GeometryFlightProfile));
+    QVERIFY(!(changedGeometries & (1 << TerrainProfileGeometry::GeometryTerrainProfile)));
+    QCOMPARE(profileGeometry.lastPatchedSpans(), 1);
+    QCOMPARE(profileGeometry.lastPatchedColumns(), 0);
+    QCOMPARE(flightProfileGeometry.vertexDataAsPoint2D()[cSegments + 1].y, static_cast<float>(height - (((amslAlt - 10) - profileGeometry.minAMSLAlt()) / (profileGeometry.maxAMSLAlt() - profileGeometry.minAMSLAlt()) * height)));
+
+    // New terrain heights for a segment only rebuild the columns it covers. Changing the altitude of the coordinate
+    // requests the heights again without moving the segment.
+    QGeoCoordinate altitudeCoord = segment->coordinate2();
+    altitudeCoord.setAltitude(amslAlt);
+    segment->setCoordinate2(altitudeCoord);
+    QTRY_VERIFY_WITH_TIMEOUT(!segment->amslTerrainHeights().isEmpty(), 10000);
+    timer.restart();
+    changedGeometries = profileGeometry.update(spans, missionDistance, minAMSLAlt, amslAlt, width, height, geometries);
+    const qint64 terrainUsecs = timer.nsecsElapsed() / 1000;
+
+    QVERIFY(changedGeometries & (1 << TerrainProfileGeometry::GeometryTerrainProfile));
+    QCOMPARE(profileGeometry.lastPatchedSpans(), 1);
+    QVERIFY(profileGeometry.lastPatchedColumns() > 0);
+    QVERIFY(profileGeometry.lastPatchedColumns() < 10);
+
+    qDebug() << cSegments << "segments" << cTerrainHeights << "terrain heights:" << terrainProfileGeometry.vertexCount() << "terrain vertices,"
+             << "full build" << buildUsecs << "usecs, altitude edit" << altitudeUsecs << "usecs, terrain update" << terrainUsecs << "usecs";
+}
@@ -15,7 +15,6 @@
 #include <QTcpSocket>
 
 #if defined(__ios__) || defined(__android__)
-#define TAISYNC_VIDEO_UDP_PORT      5600
 #define TAISYNC_VIDEO_TCP_PORT      8000
 #define TAISYNC_SETTINGS_PORT       8200
 #define TAISYNC_TELEM_PORT          8400
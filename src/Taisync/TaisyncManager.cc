@@ -72,11 +72,6 @@ TaisyncManager::_close()
         _telemetrySocket->deleteLater();
         _telemetrySocket = nullptr;
     }
-    if (_taiVideo) {
-        _taiVideo->close();
-        _taiVideo->deleteLater();
-        _taiVideo = nullptr;
-    }
 #endif
 }
 
@@ -339,22 +334,13 @@ TaisyncManager::_setVideoEnabled()
         pVSettings->aspectRatio()->setRawValue(1024.0 / 768.0);
         pVSettings->videoSource()->setRawValue(QString(VideoSettings::videoSourceUDPH264));
 #if defined(__ios__) || defined(__android__)
-        if(!_taiVideo) {
-            //-- iOS and Android receive raw h.264 and need a different pipeline
-            qgcApp()->toolbox()->videoManager()->setIsTaisync(true);
-            _taiVideo = new TaisyncVideoReceiver(this);
-            _taiVideo->start();
-        }
+        //-- iOS and Android receive raw h.264 over TCP and need a different pipeline
+        qgcApp()->toolbox()->videoManager()->setIsTaisync(true);
 #endif
     } else {
         //-- Restore video settings.
 #if defined(__ios__) || defined(__android__)
         qgcApp()->toolbox()->videoManager()->setIsTaisync(false);
-        if (_taiVideo) {
-            _taiVideo->close();
-            _taiVideo->deleteLater();
-            _taiVideo = nullptr;
-        }
 #endif
         VideoSettings* pVSettings = qgcApp()->toolbox()->settingsManager()->videoSettings();
         _restoreVideoSettings(pVSettings->videoSource());
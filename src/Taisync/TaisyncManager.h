@@ -15,7 +15,6 @@
 #include "Fact.h"
 #if defined(__ios__) || defined(__android__)
 #include "TaisyncTelemetry.h"
-#include "TaisyncVideoReceiver.h"
 #endif
 
 #include <QTimer>
@@ -134,7 +133,6 @@ private:
     TaisyncSettings*        _taiSettings    = nullptr;
 #if defined(__ios__) || defined(__android__)
     TaisyncTelemetry*       _taiTelemetery  = nullptr;
-    TaisyncVideoReceiver*   _taiVideo       = nullptr;
     QUdpSocket*             _telemetrySocket= nullptr;
 #endif
     bool            _enableVideo            = true;
@@ -31,6 +31,7 @@ QGC_LOGGING_CATEGORY(TerrainQueryVerboseLog, "TerrainQueryVerboseLog")
 
 Q_GLOBAL_STATIC(TerrainAtCoordinateBatchManager, _TerrainAtCoordinateBatchManager)
 Q_GLOBAL_STATIC(TerrainTileManager, _terrainTileManager)
+Q_GLOBAL_STATIC(TerrainProfileBatchManager, _terrainProfileBatchManager)
 
 TerrainAirMapQuery::TerrainAirMapQuery(QObject* parent)
     : TerrainQueryInterface(parent)
@@ -430,38 +431,54 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>&
 {
     error = false;
 
+    QMutexLocker tilesLocker(&_tilesMutex);
+
+    // Consecutive coordinates, such as those along a path, are mostly within the same tile. So the tile lookup is
+    // shared until the coordinates move to a different tile.
+    UrlFactory*         urlFactory  = getQGCMapEngine()->urlFactory();
+    const TerrainTile*  tile        = nullptr;
+    int                 tileX       = -1;
+    int                 tileY       = -1;
+
     for (const QGeoCoordinate& coordinate: coordinates) {
-        QString tileHash = _getTileHash(coordinate);
-        qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates hash:coordinate" << tileHash << coordinate;
+        int coordTileX = urlFactory->long2tileX("Airmap Elevation", coordinate.longitude(), 1);
+        int coordTileY = urlFactory->lat2tileY("Airmap Elevation", coordinate.latitude(), 1);
+
+        if (!tile || coordTileX != tileX || coordTileY != tileY) {
+            QString tileHash = _getTileHash(coordTileX, coordTileY);
+            qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates hash:coordinate" << tileHash << coordinate;
+
+            auto iter = _tiles.constFind(tileHash);
+            if (iter == _tiles.constEnd()) {
+                if (_state != State::Downloading) {
+                    QNetworkRequest request = urlFactory->getTileURL("Airmap Elevation", coordTileX, coordTileY, 1, &_networkManager);
+                    qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates query from database" << request.url();
+                    QGeoTileSpec spec;
+                    spec.setX(coordTileX);
+                    spec.setY(coordTileY);
+                    spec.setZoom(1);
+                    spec.setMapId(urlFactory->getIdFromType("Airmap Elevation"));
+                    QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(&_networkManager, request, spec);
+                    connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
+                    _state = State::Downloading;
+                }
 
-        _tilesMutex.lock();
-        if (_tiles.contains(tileHash)) {
-            double elevation = _tiles[tileHash].elevation(coordinate);
-            if (qIsNaN(elevation)) {
-                error = true;
-                qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates Internal Error: missing elevation in tile cache";
-            } else {
-                qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates returning elevation from tile cache" << elevation;
+                return false;
             }
-            altitudes.push_back(elevation);
-        } else {
-            if (_state != State::Downloading) {
-                QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL("Airmap Elevation", getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation",coordinate.longitude(), 1), getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1), 1, &_networkManager);
-                qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates query from database" << request.url();
-                QGeoTileSpec spec;
-                spec.setX(getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation", coordinate.longitude(), 1));
-                spec.setY(getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1));
-                spec.setZoom(1);
-                spec.setMapId(getQGCMapEngine()->urlFactory()->getIdFromType("Airmap Elevation"));
-                QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(&_networkManager, request, spec);
-                connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
-                _state = State::Downloading;
-            }
-            _tilesMutex.unlock();
 
-            return false;
+            tile    = &iter.value();
+            tileX   = coordTileX;
+            tileY   = coordTileY;
         }
-        _tilesMutex.unlock();
+
+        double elevation = tile->elevation(coordinate);
+        if (qIsNaN(elevation)) {
+            error = true;
+            qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates Internal Error: missing elevation in tile cache";
+        } else {
+            qCDebug(TerrainQueryVerboseLog) << "TerrainTileManager::getAltitudesForCoordinates returning elevation from tile cache" << elevation;
+        }
+        altitudes.push_back(elevation);
     }
 
     return true;
@@ -557,14 +574,10 @@ void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::N
     }
 }
 
-QString TerrainTileManager::_getTileHash(const QGeoCoordinate& coordinate)
+QString TerrainTileManager::_getTileHash(int tileX, int tileY)
 {
-    QString ret = QGCMapEngine::getTileHash(
-        "Airmap Elevation",
-        getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation", coordinate.longitude(), 1),
-        getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1),
-        1);
-    qCDebug(TerrainQueryVerboseLog) << "Computing unique tile hash for " << coordinate << ret;
+    QString ret = QGCMapEngine::getTileHash("Airmap Elevation", tileX, tileY, 1);
+    qCDebug(TerrainQueryVerboseLog) << "Computing unique tile hash for " << tileX << tileY << ret;
 
     return ret;
 }
@@ -755,6 +768,205 @@ void TerrainPathQuery::_pathHeights(bool success, double distanceBetween, double
     }
 }
 
+TerrainProfileBatchManager::TerrainProfileBatchManager(void)
+{
+    qRegisterMetaType<TerrainPathQuery::PathHeightInfo_t>();
+
+    _cache.setMaxCost(_maxCacheHeights);
+
+    _batchTimer.setSingleShot(true);
+    _batchTimer.setInterval(_batchTimeout);
+    connect(&_batchTimer, &QTimer::timeout, this, &TerrainProfileBatchManager::_sendBatch);
+    connect(&_terrainQuery, &TerrainQueryInterface::coordinateHeightsReceived, this, &TerrainProfileBatchManager::_coordinateHeights);
+}
+
+void TerrainProfileBatchManager::addQuery(TerrainProfileQuery* terrainProfileQuery, const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord)
+{
+    // A new request from the same query replaces the previous one, wherever it is
+    _removeQuery(terrainProfileQuery);
+
+    connect(terrainProfileQuery, &TerrainProfileQuery::destroyed, this, &TerrainProfileBatchManager::_queryObjectDestroyed, Qt::UniqueConnection);
+    QueuedRequestInfo_t queuedRequestInfo = { terrainProfileQuery, fromCoord, toCoord };
+    _requestQueue.append(queuedRequestInfo);
+
+    // Restarting the timer on each request collects the whole set of changes, such as a mission load or a dragged
+    // waypoint, into a single batch
+    _batchTimer.start();
+}
+
+QString TerrainProfileBatchManager::_cacheKey(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord)
+{
+    // Heights along a path only depend on the end point positions and the sample spacing, not on altitudes
+    return QString::asprintf("%.8f,%.8f,%.8f,%.8f,%.3f",
+                             fromCoord.latitude(), fromCoord.longitude(),
+                             toCoord.latitude(), toCoord.longitude(),
+                             TerrainTile::tileValueSpacingMeters);
+}
+
+void TerrainProfileBatchManager::_sendBatch(void)
+{
+    qCDebug(TerrainQueryLog) << "TerrainProfileBatchManager::_sendBatch _state:_requestQueue.count" << static_cast<int>(_state) << _requestQueue.count();
+
+    if (_state != State::Idle) {
+        // Waiting for last download the complete, wait some more
+        _batchTimer.start();
+        return;
+    }
+
+    QList<QueuedRequestInfo_t> requestQueue = _requestQueue;
+    _requestQueue.clear();
+    _sentRequests.clear();
+
+    QList<QGeoCoordinate>   coords;
+    QHash<QString, int>     sentRequestIndices;
+
+    for (const QueuedRequestInfo_t& requestInfo: requestQueue) {
+        QString cacheKey = _cacheKey(requestInfo.fromCoord, requestInfo.toCoord);
+
+        const TerrainPathQuery::PathHeightInfo_t* cachedPathHeightInfo = _cache.object(cacheKey);
+        if (cachedPathHeightInfo) {
+            qCDebug(TerrainQueryVerboseLog) << "TerrainProfileBatchManager::_sendBatch cache hit" << cacheKey;
+            _cacheHitCount++;
+            disconnect(requestInfo.terrainProfileQuery, &TerrainProfileQuery::destroyed, this, &TerrainProfileBatchManager::_queryObjectDestroyed);
+            requestInfo.terrainProfileQuery->_signalTerrainData(true, *cachedPathHeightInfo);
+            continue;
+        }
+
+        if (sentRequestIndices.contains(cacheKey)) {
+            // Same path requested twice in this batch
+            _sentRequests[sentRequestIndices[cacheKey]].terrainProfileQueries.append(requestInfo.terrainProfileQuery);
+            continue;
+        }
+
+        SentRequestInfo_t sentRequestInfo;
+        QList<QGeoCoordinate> pathCoords = TerrainTileManager::pathQueryToCoords(requestInfo.fromCoord, requestInfo.toCoord, sentRequestInfo.distanceBetween, sentRequestInfo.finalDistanceBetween);
+
+        // Consecutive flight path segments share an end point, so the sample is only requested once
+        if (!coords.isEmpty() &&
+                coords.last().latitude() == pathCoords.first().latitude() &&
+                coords.last().longitude() == pathCoords.first().longitude()) {
+            pathCoords.removeFirst();
+            sentRequestInfo.firstIndex = coords.count() - 1;
+        } else {
+            sentRequestInfo.firstIndex = coords.count();
+        }
+        coords += pathCoords;
+
+        sentRequestInfo.cacheKey                = cacheKey;
+        sentRequestInfo.cHeights                = coords.count() - sentRequestInfo.firstIndex;
+        sentRequestInfo.terrainProfileQueries.append(requestInfo.terrainProfileQuery);
+        sentRequestIndices[cacheKey] = _sentRequests.count();
+        _sentRequests.append(sentRequestInfo);
+    }
+
+    if (_sentRequests.isEmpty()) {
+        return;
+    }
+
+    qCDebug(TerrainQueryLog) << "TerrainProfileBatchManager::_sendBatch requesting paths:coords" << _sentRequests.count() << coords.count();
+
+    _batchCount++;
+    _pathCount      += _sentRequests.count();
+    _cSentHeights   = coords.count();
+    _state          = State::Downloading;
+    _terrainQuery.requestCoordinateHeights(coords);
+}
+
+void TerrainProfileBatchManager::_batchFailed(void)
+{
+    TerrainPathQuery::PathHeightInfo_t noPathHeightInfo;
+    noPathHeightInfo.distanceBetween        = 0;
+    noPathHeightInfo.finalDistanceBetween   = 0;
+
+    QList<SentRequestInfo_t> sentRequests = _sentRequests;
+    _sentRequests.clear();
+
+    for (const SentRequestInfo_t& sentRequestInfo: sentRequests) {
+        for (TerrainProfileQuery* terrainProfileQuery: sentRequestInfo.terrainProfileQueries) {
+            disconnect(terrainProfileQuery, &TerrainProfileQuery::destroyed, this, &TerrainProfileBatchManager::_queryObjectDestroyed);
+            terrainProfileQuery->_signalTerrainData(false, noPathHeightInfo);
+        }
+    }
+}
+
+void TerrainProfileBatchManager::_removeQuery(TerrainProfileQuery* terrainProfileQuery)
+{
+    int i = 0;
+    while (i < _requestQueue.count()) {
+        if (_requestQueue[i].terrainProfileQuery == terrainProfileQuery) {
+            _requestQueue.removeAt(i);
+        } else {
+            i++;
+        }
+    }
+
+    // The path is still downloaded and cached, it just isn't signalled to this query anymore
+    for (SentRequestInfo_t& sentRequestInfo: _sentRequests) {
+        sentRequestInfo.terrainProfileQueries.removeAll(terrainProfileQuery);
+    }
+}
+
+void TerrainProfileBatchManager::_queryObjectDestroyed(QObject* terrainProfileQuery)
+{
+    qCDebug(TerrainQueryLog) << "TerrainProfileBatchManager::_queryObjectDestroyed" << terrainProfileQuery;
+
+    // The object is already destroyed, the pointer is only used for comparison
+    _removeQuery(static_cast<TerrainProfileQuery*>(terrainProfileQuery));
+}
+
+void TerrainProfileBatchManager::_coordinateHeights(bool success, QList<double> heights)
+{
+    _state = State::Idle;
+
+    qCDebug(TerrainQueryLog) << "TerrainProfileBatchManager::_coordinateHeights signalled success:count" << success << heights.count();
+
+    if (!success || heights.count() != _cSentHeights) {
+        _batchFailed();
+    } else {
+        QList<SentRequestInfo_t> sentRequests = _sentRequests;
+        _sentRequests.clear();
+
+        for (const SentRequestInfo_t& sentRequestInfo: sentRequests) {
+            TerrainPathQuery::PathHeightInfo_t* pathHeightInfo = new TerrainPathQuery::PathHeightInfo_t;
+            pathHeightInfo->distanceBetween         = sentRequestInfo.distanceBetween;
+            pathHeightInfo->finalDistanceBetween    = sentRequestInfo.finalDistanceBetween;
+            pathHeightInfo->heights                 = heights.mid(sentRequestInfo.firstIndex, sentRequestInfo.cHeights);
+
+            // Signal before inserting into the cache since the cache may delete the entry immediately if it is too large
+            for (TerrainProfileQuery* terrainProfileQuery: sentRequestInfo.terrainProfileQueries) {
+                disconnect(terrainProfileQuery, &TerrainProfileQuery::destroyed, this, &TerrainProfileBatchManager::_queryObjectDestroyed);
+                terrainProfileQuery->_signalTerrainData(true, *pathHeightInfo);
+            }
+            _cache.insert(sentRequestInfo.cacheKey, pathHeightInfo, sentRequestInfo.cHeights);
+        }
+    }
+
+    if (_requestQueue.count()) {
+        _batchTimer.start();
+    }
+}
+
+TerrainProfileQuery::TerrainProfileQuery(QObject* parent)
+    : QObject(parent)
+{
+
+}
+
+void TerrainProfileQuery::requestData(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord)
+{
+    _terrainProfileBatchManager->addQuery(this, fromCoord, toCoord);
+}
+
+TerrainProfileBatchManager* TerrainProfileQuery::batchManager(void)
+{
+    return _terrainProfileBatchManager;
+}
+
+void TerrainProfileQuery::_signalTerrainData(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo)
+{
+    emit terrainDataReceived(success, pathHeightInfo);
+}
+
 TerrainPolyPathQuery::TerrainPolyPathQuery(bool autoDelete)
     : _autoDelete   (autoDelete)
     , _pathQuery    (false /* autoDelete */)
@@ -777,10 +989,28 @@ void TerrainPolyPathQuery::requestData(const QList<QGeoCoordinate>& polyPath)
 {
     qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::requestData count" << polyPath.count();
 
+    QList<QPair<QGeoCoordinate, QGeoCoordinate>> rgSegments;
+    for (int i=0; i<polyPath.count() - 1; i++) {
+        rgSegments.append(qMakePair(polyPath[i], polyPath[i+1]));
+    }
+
+    requestSegmentData(rgSegments);
+}
+
+void TerrainPolyPathQuery::requestSegmentData(const QList<QPair<QGeoCoordinate, QGeoCoordinate>>& rgSegments)
+{
+    qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::requestSegmentData count" << rgSegments.count();
+
+    if (rgSegments.isEmpty()) {
+        qCWarning(TerrainQueryLog) << "TerrainPolyPathQuery::requestSegmentData called with no segments";
+        return;
+    }
+
     // Kick off first request
-    _rgCoords = polyPath;
+    _rgSegments = rgSegments;
+    _rgPathHeightInfo.clear();
     _curIndex = 0;
-    _pathQuery.requestData(_rgCoords[0], _rgCoords[1]);
+    _pathQuery.requestData(_rgSegments[0].first, _rgSegments[0].second);
 }
 
 void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo)
@@ -795,7 +1025,7 @@ void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQ
 
     _rgPathHeightInfo.append(pathHeightInfo);
 
-    if (++_curIndex >= _rgCoords.count() - 1) {
+    if (++_curIndex >= _rgSegments.count()) {
         // We've finished all requests
         qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::_terrainDataReceived complete";
         emit terrainDataReceived(true /* success */, _rgPathHeightInfo);
@@ -803,7 +1033,7 @@ void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQ
             deleteLater();
         }
     } else {
-        _pathQuery.requestData(_rgCoords[_curIndex], _rgCoords[_curIndex+1]);
+        _pathQuery.requestData(_rgSegments[_curIndex].first, _rgSegments[_curIndex].second);
     }
 }
 
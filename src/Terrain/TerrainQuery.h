@@ -19,12 +19,14 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QCache>
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryLog)
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryVerboseLog)
 
 class TerrainAtCoordinateQuery;
+class TerrainProfileQuery;
 
 /// Base class for offline/online terrain queries
 class TerrainQueryInterface : public QObject
@@ -146,7 +148,7 @@ private:
     } QueuedRequestInfo_t;
 
     void    _tileFailed                         (void);
-    QString _getTileHash                        (const QGeoCoordinate& coordinate);
+    QString _getTileHash                        (int tileX, int tileY);
 
     QList<QueuedRequestInfo_t>  _requestQueue;
     State                       _state = State::Idle;
@@ -269,6 +271,88 @@ private:
 
 Q_DECLARE_METATYPE(TerrainPathQuery::PathHeightInfo_t)
 
+/// Used internally by TerrainProfileQuery to batch all outstanding path requests, such as the flight path segments of a
+/// whole mission, into a single coordinate request. Adjacent paths share their common end point sample. Results are
+/// cached by path end points and sample spacing, so only paths which changed are requested again.
+class TerrainProfileBatchManager : public QObject {
+    Q_OBJECT
+
+public:
+    TerrainProfileBatchManager(void);
+
+    void addQuery(TerrainProfileQuery* terrainProfileQuery, const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord);
+
+    int batchCount      (void) const { return _batchCount; }        ///< Coordinate requests sent
+    int pathCount       (void) const { return _pathCount; }         ///< Paths requested in all batches
+    int cacheHitCount   (void) const { return _cacheHitCount; }     ///< Paths returned from the cache
+
+private slots:
+    void _sendBatch             (void);
+    void _queryObjectDestroyed  (QObject* terrainProfileQuery);
+    void _coordinateHeights     (bool success, QList<double> heights);
+
+private:
+    typedef struct {
+        TerrainProfileQuery*    terrainProfileQuery;
+        QGeoCoordinate          fromCoord;
+        QGeoCoordinate          toCoord;
+    } QueuedRequestInfo_t;
+
+    typedef struct {
+        QString                     cacheKey;
+        int                         firstIndex;             ///< Index of the first height for the path within the batch
+        int                         cHeights;
+        double                      distanceBetween;
+        double                      finalDistanceBetween;
+        QList<TerrainProfileQuery*> terrainProfileQueries;  ///< Queries still waiting for this path
+    } SentRequestInfo_t;
+
+    enum class State {
+        Idle,
+        Downloading,
+    };
+
+    void    _removeQuery    (TerrainProfileQuery* terrainProfileQuery);
+    void    _batchFailed    (void);
+    QString _cacheKey       (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord);
+
+    QList<QueuedRequestInfo_t>                          _requestQueue;
+    QList<SentRequestInfo_t>                            _sentRequests;
+    int                                                 _cSentHeights   = 0;
+    QCache<QString, TerrainPathQuery::PathHeightInfo_t> _cache;                 ///< Cost is the number of heights
+    State                                               _state          = State::Idle;
+    const int                                           _batchTimeout   = 200;
+    QTimer                                              _batchTimer;
+    TerrainOfflineAirMapQuery                           _terrainQuery;
+    int                                                 _batchCount     = 0;
+    int                                                 _pathCount      = 0;
+    int                                                 _cacheHitCount  = 0;
+
+    static const int _maxCacheHeights = 1000000;
+};
+
+/// Terrain heights along a path, batched together with the path requests of all other TerrainProfileQuery objects.
+/// Requesting again replaces the outstanding request, the results of the previous request are not signalled.
+class TerrainProfileQuery : public QObject
+{
+    Q_OBJECT
+
+public:
+    TerrainProfileQuery(QObject* parent = nullptr);
+
+    /// Async terrain query for terrain heights between two lat/lon coordinates. When the query is done, the
+    /// terrainDataReceived() signal is emitted.
+    void requestData(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord);
+
+    static TerrainProfileBatchManager* batchManager(void);
+
+    // Internal method
+    void _signalTerrainData(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo);
+
+signals:
+    void terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo);
+};
+
 class TerrainPolyPathQuery : public QObject
 {
     Q_OBJECT
@@ -283,6 +367,11 @@ public:
     void requestData(const QVariantList& polyPath);
     void requestData(const QList<QGeoCoordinate>& polyPath);
 
+    /// Async terrain query for terrain heights along each of the specified segments. Segments do not need to be
+    /// connected to each other. Results are returned in the same order as the segments.
+    ///     @param rgSegments List of from/to coordinate pairs
+    void requestSegmentData(const QList<QPair<QGeoCoordinate, QGeoCoordinate>>& rgSegments);
+
 signals:
     /// Signalled when terrain data comes back from server
     void terrainDataReceived(bool success, const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo);
@@ -292,9 +381,9 @@ private slots:
 
 private:
     bool                                        _autoDelete;
-    int                                         _curIndex = 0;
-    QList<QGeoCoordinate>                       _rgCoords;
-    QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;
+    int                                                 _curIndex = 0;
+    QList<QPair<QGeoCoordinate, QGeoCoordinate>>        _rgSegments;
+    QList<TerrainPathQuery::PathHeightInfo_t>           _rgPathHeightInfo;
     TerrainPathQuery                            _pathQuery;
 };
 
@@ -30,7 +30,8 @@ public:
     /// Called to pass the COMPONENT_INFORMATION message in
     void setMessage(const mavlink_message_t& message);
 
-    virtual void setJson(const QString& metaDataJsonFileName, const QString& translationJsonFileName) = 0;
+    /// Called with the downloaded (and already decompressed) json. Empty if not available.
+    virtual void setJson(const QByteArray& metaDataJson, const QByteArray& translationJson) = 0;
 
     COMP_METADATA_TYPE  type;
     Vehicle*            vehicle            = nullptr;
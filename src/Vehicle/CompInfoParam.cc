@@ -31,11 +31,11 @@ CompInfoParam::CompInfoParam(uint8_t compId, Vehicle* vehicle, QObject* parent)
 
 }
 
-void CompInfoParam::setJson(const QString& metadataJsonFileName, const QString& translationJsonFileName)
+void CompInfoParam::setJson(const QByteArray& metadataJson, const QByteArray& translationJson)
 {
-    qCDebug(CompInfoParamLog) << "setJson: metadataJsonFileName:translationJsonFileName" << metadataJsonFileName << translationJsonFileName;
+    qCDebug(CompInfoParamLog) << "setJson: metadataJson:translationJson sizes" << metadataJson.size() << translationJson.size();
 
-    if (metadataJsonFileName.isEmpty()) {
+    if (metadataJson.isEmpty()) {
         // This will fall back to using the old FirmwarePlugin mechanism for parameter meta data.
         // In this case paramter metadata is loaded through the _parameterMajorVersionKnown call which happens after parameter are downloaded
         return;
@@ -46,7 +46,7 @@ void CompInfoParam::setJson(const QString& metadataJsonFileName, const QString&
 
     _noJsonMetadata = false;
 
-    if (!JsonHelper::isJsonFile(metadataJsonFileName, jsonDoc, errorString)) {
+    if (!JsonHelper::isJsonFile(metadataJson, jsonDoc, errorString)) {
         qCWarning(CompInfoParamLog) << "Metadata json file open failed: compid:" << compId << errorString;
         return;
     }
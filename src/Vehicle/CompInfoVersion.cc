@@ -28,16 +28,16 @@ CompInfoVersion::CompInfoVersion(uint8_t compId, Vehicle* vehicle, QObject* pare
 
 }
 
-void CompInfoVersion::setJson(const QString& metadataJsonFileName, const QString& /*translationJsonFileName*/)
+void CompInfoVersion::setJson(const QByteArray& metadataJson, const QByteArray& /*translationJson*/)
 {
-    if (metadataJsonFileName.isEmpty()) {
+    if (metadataJson.isEmpty()) {
         return;
     }
 
     QString         errorString;
     QJsonDocument   jsonDoc;
 
-    if (!JsonHelper::isJsonFile(metadataJsonFileName, jsonDoc, errorString)) {
+    if (!JsonHelper::isJsonFile(metadataJson, jsonDoc, errorString)) {
         qCWarning(CompInfoVersionLog) << "Metadata json file open failed: compid:" << compId << errorString;
         return;
     }
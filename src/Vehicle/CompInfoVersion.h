@@ -32,7 +32,7 @@ public:
     bool isMetaDataTypeSupported(COMP_METADATA_TYPE type) { return _supportedTypes.contains(type); }
 
     // Overrides from CompInfo
-    void setJson(const QString& metadataJsonFileName, const QString& translationJsonFileName) override;
+    void setJson(const QByteArray& metadataJson, const QByteArray& translationJson) override;
 
 private:
     QList<COMP_METADATA_TYPE>   _supportedTypes;
@@ -22,6 +22,11 @@
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QSettings>
+#include <QDateTime>
 
 QGC_LOGGING_CATEGORY(ComponentInformationManagerLog, "ComponentInformationManagerLog")
 
@@ -35,8 +40,7 @@ int ComponentInformationManager::_cStates = sizeof(ComponentInformationManager::
 
 RequestMetaDataTypeStateMachine::StateFn RequestMetaDataTypeStateMachine::_rgStates[]= {
     RequestMetaDataTypeStateMachine::_stateRequestCompInfo,
-    RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson,
-    RequestMetaDataTypeStateMachine::_stateRequestTranslationJson,
+    RequestMetaDataTypeStateMachine::_stateRequestJson,
     RequestMetaDataTypeStateMachine::_stateRequestComplete,
 };
 
@@ -117,6 +121,38 @@ CompInfoVersion* ComponentInformationManager::compInfoVersion(uint8_t compId)
     return _compInfoMap.contains(compId) && _compInfoMap[compId].contains(COMP_METADATA_TYPE_VERSION) ? qobject_cast<CompInfoVersion*>(_compInfoMap[compId][COMP_METADATA_TYPE_VERSION]) : nullptr;
 }
 
+QDir ComponentInformationManager::metaDataCacheDir(void)
+{
+    const QString spath(QFileInfo(QSettings().fileName()).dir().absolutePath());
+    return spath + QDir::separator() + "CompInfoCache";
+}
+
+/// The cache is content addressed: the file name is made from the uid the vehicle advertises for the json and the uri
+/// it is available from, so a change to either results in a new download.
+QString ComponentInformationManager::_cachedJsonFile(const QString& uri, uint32_t uid)
+{
+    const QByteArray uriHash = QCryptographicHash::hash(uri.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+    return metaDataCacheDir().filePath(QStringLiteral("%1_%2.json").arg(uid, 8, 16, QLatin1Char('0')).arg(QString::fromLatin1(uriHash)));
+}
+
+void ComponentInformationManager::_cacheJson(const QString& uri, uint32_t uid, const QByteArray& json)
+{
+    QDir cacheDir = metaDataCacheDir();
+    cacheDir.mkpath(cacheDir.absolutePath());
+
+    QSaveFile file(_cachedJsonFile(uri, uid));
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+        qCWarning(ComponentInformationManagerLog) << "Write to metadata cache failed" << file.fileName() << file.errorString();
+        return;
+    }
+
+    // Drop the least recently used entries once the cache is full, a cache hit refreshes the modification time
+    const QFileInfoList rgEntries = cacheDir.entryInfoList(QStringList("*.json"), QDir::Files, QDir::Time);
+    for (int i=_maxCachedJsonFiles; i<rgEntries.count(); i++) {
+        QFile::remove(rgEntries[i].absoluteFilePath());
+    }
+}
+
 RequestMetaDataTypeStateMachine::RequestMetaDataTypeStateMachine(ComponentInformationManager* compMgr)
     : _compMgr(compMgr)
 {
@@ -125,10 +161,12 @@ RequestMetaDataTypeStateMachine::RequestMetaDataTypeStateMachine(ComponentInform
 
 void RequestMetaDataTypeStateMachine::request(CompInfo* compInfo)
 {
-    _compInfo   = compInfo;
-    _stateIndex = -1;
-    _jsonMetadataFileName.clear();
-    _jsonTranslationFileName.clear();
+    _compInfo       = compInfo;
+    _stateIndex     = -1;
+    _cPendingJson   = 0;
+    _jsonMetadata.clear();
+    _jsonTranslation.clear();
+    _ftpQueue.clear();
 
     start();
 }
@@ -206,151 +244,186 @@ void RequestMetaDataTypeStateMachine::_stateRequestCompInfo(StateMachine* stateM
     }
 }
 
-QString RequestMetaDataTypeStateMachine::_downloadCompleteJsonWorker(const QString& fileName, const QString& inflatedFileName)
+/// Reads the downloaded json. Compressed json is inflated straight into memory without going through a second file.
+///     @return Json bytes, empty on failure
+QByteArray RequestMetaDataTypeStateMachine::_downloadCompleteJsonWorker(const QString& fileName)
 {
-    QString outputFileName = fileName;
+    QByteArray  jsonBytes;
+    QFile       file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(ComponentInformationManagerLog) << "Open of downloaded json failed" << fileName << file.errorString();
+        return jsonBytes;
+    }
 
     if (fileName.endsWith(".lzma", Qt::CaseInsensitive) || fileName.endsWith(".xz", Qt::CaseInsensitive)) {
-        outputFileName = (QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath(inflatedFileName));
-        if (QGCLZMA::inflateLZMAFile(fileName, outputFileName)) {
-            QFile(fileName).remove();
-        } else {
-            qCWarning(ComponentInformationManagerLog) << "Inflate of compressed json failed" << inflatedFileName;
-            outputFileName.clear();
+        QBuffer jsonBuffer(&jsonBytes);
+        jsonBuffer.open(QIODevice::WriteOnly);
+        if (!QGCLZMA::inflateLZMA(&file, &jsonBuffer)) {
+            qCWarning(ComponentInformationManagerLog) << "Inflate of compressed json failed" << fileName;
+            jsonBytes.clear();
         }
     } else {
-        outputFileName = fileName;
+        jsonBytes = file.readAll();
     }
 
-    return outputFileName;
+    file.close();
+    file.remove();
+
+    return jsonBytes;
 }
 
-void RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson(const QString& fileName, const QString& errorMsg)
+QString RequestMetaDataTypeStateMachine::_jsonUri(JsonType_t jsonType) const
 {
-    qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson fileName:errorMsg" << fileName << errorMsg;
-
-    disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson);
-    if (errorMsg.isEmpty()) {
-        _jsonMetadataFileName = _downloadCompleteJsonWorker(fileName, "metadata.json");
-    } else if (qgcApp()->runningUnitTests()) {
-        // Unit test should always succeed
-        qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson failed filename:errorMsg" << fileName << errorMsg;
-    }
+    return jsonType == JsonMetaData ? _compInfo->uriMetaData : _compInfo->uriTranslation;
+}
 
-    advance();
+uint32_t RequestMetaDataTypeStateMachine::_jsonUid(JsonType_t jsonType) const
+{
+    return jsonType == JsonMetaData ? _compInfo->uidMetaData : _compInfo->uidTranslation;
 }
 
-void RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson(const QString& fileName, const QString& errorMsg)
+QString RequestMetaDataTypeStateMachine::_jsonTypeToString(JsonType_t jsonType) const
 {
-    QString jsonTranslationFileName;
+    return jsonType == JsonMetaData ? QStringLiteral("metadata") : QStringLiteral("translation");
+}
 
-    qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson fileName:errorMsg" << fileName << errorMsg;
+/// Called once for each json requested, the state machine advances when all of them are complete
+///     @param downloaded true: json was downloaded from the uri, false: json came from the cache or is not available
+void RequestMetaDataTypeStateMachine::_jsonReceived(JsonType_t jsonType, const QByteArray& json, bool downloaded)
+{
+    if (jsonType == JsonMetaData) {
+        _jsonMetadata = json;
+    } else {
+        _jsonTranslation = json;
+    }
 
-    disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson);
-    if (errorMsg.isEmpty()) {
-        _jsonTranslationFileName = _downloadCompleteJsonWorker(fileName, "translation.json");
-    } else if (qgcApp()->runningUnitTests()) {
-        // Unit test should always succeed
-        qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson failed filename:errorMsg" << fileName << errorMsg;
+    if (downloaded && !json.isEmpty() && _jsonUid(jsonType) != 0) {
+        ComponentInformationManager::_cacheJson(_jsonUri(jsonType), _jsonUid(jsonType), json);
     }
 
-    advance();
+    if (--_cPendingJson == 0) {
+        advance();
+    }
 }
 
-void RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson(QString remoteFile, QString localFile, QString errorMsg)
+void RequestMetaDataTypeStateMachine::_requestJson(JsonType_t jsonType)
 {
-    qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
+    const QString   uri = _jsonUri(jsonType);
+    const uint32_t  uid = _jsonUid(jsonType);
+
+    // A uid of 0 means the vehicle does not identify the content, so it can't be cached
+    if (uid != 0) {
+        QFile cacheFile(ComponentInformationManager::_cachedJsonFile(uri, uid));
+        if (cacheFile.open(QIODevice::ReadOnly)) {
+            const QByteArray    json = cacheFile.readAll();
+            QJsonParseError     jsonParseError;
+            QJsonDocument::fromJson(json, &jsonParseError);
+            if (jsonParseError.error == QJsonParseError::NoError) {
+                qCDebug(ComponentInformationManagerLog) << "Using cached" << _jsonTypeToString(jsonType) << "json" << uri << uid << cacheFile.fileName();
+                cacheFile.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+                cacheFile.close();
+                _jsonReceived(jsonType, json, false /* downloaded */);
+                return;
+            }
 
-    disconnect(qobject_cast<QGCFileDownload*>(sender()), &QGCFileDownload::downloadComplete, this, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson);
-    if (errorMsg.isEmpty()) {
-        _jsonMetadataFileName = _downloadCompleteJsonWorker(localFile, "metadata.json");
-    } else if (qgcApp()->runningUnitTests()) {
-        // Unit test should always succeed
-        qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson failed remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
+            // A truncated or corrupt entry is replaced by a fresh download
+            qCWarning(ComponentInformationManagerLog) << "Discarding corrupt metadata cache entry" << cacheFile.fileName() << jsonParseError.errorString();
+            cacheFile.remove();
+        }
     }
 
-    advance();
+    qCDebug(ComponentInformationManagerLog) << "Downloading" << _jsonTypeToString(jsonType) << "json" << uri;
+    if (_uriIsMAVLinkFTP(uri)) {
+        _ftpQueue.append(jsonType);
+        if (_ftpQueue.count() == 1) {
+            _startNextFtpDownload();
+        }
+    } else {
+        QGCFileDownload* download = new QGCFileDownload(this);
+        connect(download, &QGCFileDownload::downloadComplete, this, [this, download, jsonType](QString remoteFile, QString localFile, QString errorMsg) {
+            qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine http download complete remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
+            download->deleteLater();
+
+            QByteArray json;
+            if (errorMsg.isEmpty()) {
+                json = _downloadCompleteJsonWorker(localFile);
+            } else if (qgcApp()->runningUnitTests()) {
+                // Unit test should always succeed
+                qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine http download failed remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
+            }
+            _jsonReceived(jsonType, json, true /* downloaded */);
+        });
+        if (!download->download(uri)) {
+            qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_requestJson QGCFileDownload::download returned failure" << _jsonTypeToString(jsonType);
+            download->deleteLater();
+            _jsonReceived(jsonType, QByteArray(), false /* downloaded */);
+        }
+    }
 }
 
-void RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson(QString remoteFile, QString localFile, QString errorMsg)
+void RequestMetaDataTypeStateMachine::_startNextFtpDownload(void)
 {
-    QString jsonTranslationFileName;
+    FTPManager* ftpManager = _compInfo->vehicle->ftpManager();
 
-    qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
+    connect(ftpManager, &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
+    if (!ftpManager->download(_jsonUri(_ftpQueue.first()), QStandardPaths::writableLocation(QStandardPaths::TempLocation))) {
+        qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_startNextFtpDownload FTPManager::download returned failure" << _jsonTypeToString(_ftpQueue.first());
+        disconnect(ftpManager, &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
 
-    disconnect(qobject_cast<QGCFileDownload*>(sender()), &QGCFileDownload::downloadComplete, this, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson);
+        const JsonType_t jsonType = _ftpQueue.takeFirst();
+        if (!_ftpQueue.isEmpty()) {
+            _startNextFtpDownload();
+        }
+        _jsonReceived(jsonType, QByteArray(), false /* downloaded */);
+    }
+}
+
+void RequestMetaDataTypeStateMachine::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg)
+{
+    qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadComplete fileName:errorMsg" << fileName << errorMsg;
+
+    disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
+
+    const JsonType_t jsonType = _ftpQueue.takeFirst();
+
+    QByteArray json;
     if (errorMsg.isEmpty()) {
-        _jsonTranslationFileName = _downloadCompleteJsonWorker(localFile, "translation.json");
+        json = _downloadCompleteJsonWorker(fileName);
     } else if (qgcApp()->runningUnitTests()) {
         // Unit test should always succeed
-        qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson failed remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
+        qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadComplete failed filename:errorMsg" << fileName << errorMsg;
     }
 
-    advance();
+    // Keep FTP busy while the completed json is handed over
+    if (!_ftpQueue.isEmpty()) {
+        _startNextFtpDownload();
+    }
+    _jsonReceived(jsonType, json, true /* downloaded */);
 }
 
-void RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson(StateMachine* stateMachine)
+void RequestMetaDataTypeStateMachine::_stateRequestJson(StateMachine* stateMachine)
 {
     RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
     CompInfo*                           compInfo        = requestMachine->compInfo();
-    FTPManager*                         ftpManager      = compInfo->vehicle->ftpManager();
-
-    if (compInfo->available) {
-        qCDebug(ComponentInformationManagerLog) << "Downloading metadata json" << compInfo->uriMetaData;
-        if (_uriIsMAVLinkFTP(compInfo->uriMetaData)) {
-            connect(ftpManager, &FTPManager::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson);
-            if (!ftpManager->download(compInfo->uriMetaData, QStandardPaths::writableLocation(QStandardPaths::TempLocation))) {
-                qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson FTPManager::download returned failure";
-                disconnect(ftpManager, &FTPManager::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson);
-                requestMachine->advance();
-            }
-        } else {
-            QGCFileDownload* download = new QGCFileDownload(requestMachine);
-            connect(download, &QGCFileDownload::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson);
-            if (!download->download(compInfo->uriMetaData)) {
-                qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson QGCFileDownload::download returned failure";
-                disconnect(download, &QGCFileDownload::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson);
-                requestMachine->advance();
-            }
-        }
-    } else {
-        qCDebug(ComponentInformationManagerLog) << "Skipping metadata json download. Component information not available";
+
+    if (!compInfo->available) {
+        qCDebug(ComponentInformationManagerLog) << "Skipping json download. Component information not available";
         requestMachine->advance();
+        return;
     }
-}
-
-void RequestMetaDataTypeStateMachine::_stateRequestTranslationJson(StateMachine* stateMachine)
-{
-    RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
-    CompInfo*                           compInfo        = requestMachine->compInfo();
-    FTPManager*                         ftpManager      = compInfo->vehicle->ftpManager();
 
-    if (compInfo->available) {
-        if (compInfo->uriTranslation.isEmpty()) {
-            qCDebug(ComponentInformationManagerLog) << "Skipping translation json download. No translation json specified";
-            requestMachine->advance();
-        } else {
-            qCDebug(ComponentInformationManagerLog) << "Downloading translation json" << compInfo->uriTranslation;
-            if (_uriIsMAVLinkFTP(compInfo->uriTranslation)) {
-                connect(ftpManager, &FTPManager::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson);
-                if (!ftpManager->download(compInfo->uriTranslation, QStandardPaths::writableLocation(QStandardPaths::TempLocation))) {
-                    qCWarning(ComponentInformationManagerLog) << "_stateRequestTranslationJson::_stateRequestMetaDataJson FTPManager::download returned failure";
-                    connect(ftpManager, &FTPManager::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson);
-                    requestMachine->advance();
-                }
-            } else {
-                QGCFileDownload* download = new QGCFileDownload(requestMachine);
-                connect(download, &QGCFileDownload::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson);
-                if (!download->download(compInfo->uriTranslation)) {
-                    qCWarning(ComponentInformationManagerLog) << "_stateRequestTranslationJson::_stateRequestMetaDataJson QGCFileDownload::download returned failure";
-                    disconnect(download, &QGCFileDownload::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson);
-                    requestMachine->advance();
-                }
-            }
-        }
+    QList<JsonType_t> rgJsonTypes = { JsonMetaData };
+    if (compInfo->uriTranslation.isEmpty()) {
+        qCDebug(ComponentInformationManagerLog) << "Skipping translation json download. No translation json specified";
     } else {
-        qCDebug(ComponentInformationManagerLog) << "Skipping translation json download. Component information not available";
-        requestMachine->advance();
+        rgJsonTypes.append(JsonTranslation);
+    }
+
+    // All requests are counted up front since a request may complete before the next one is started
+    requestMachine->_cPendingJson = rgJsonTypes.count();
+    for (JsonType_t jsonType: rgJsonTypes) {
+        requestMachine->_requestJson(jsonType);
     }
 }
 
@@ -359,14 +432,10 @@ void RequestMetaDataTypeStateMachine::_stateRequestComplete(StateMachine* stateM
     RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
     CompInfo*                           compInfo        = requestMachine->compInfo();
 
-    compInfo->setJson(requestMachine->_jsonMetadataFileName, requestMachine->_jsonTranslationFileName);
+    compInfo->setJson(requestMachine->_jsonMetadata, requestMachine->_jsonTranslation);
 
-    if (!requestMachine->_jsonMetadataFileName.isEmpty()) {
-        QFile(requestMachine->_jsonMetadataFileName).remove();
-    }
-    if (!requestMachine->_jsonTranslationFileName.isEmpty()) {
-        QFile(requestMachine->_jsonTranslationFileName).remove();
-    }
+    requestMachine->_jsonMetadata.clear();
+    requestMachine->_jsonTranslation.clear();
 
     requestMachine->advance();
 }
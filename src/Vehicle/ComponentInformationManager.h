@@ -13,6 +13,8 @@
 #include "QGCMAVLink.h"
 #include "StateMachine.h"
 
+#include <QDir>
+
 Q_DECLARE_LOGGING_CATEGORY(ComponentInformationManagerLog)
 
 class Vehicle;
@@ -21,6 +23,10 @@ class CompInfo;
 class CompInfoParam;
 class CompInfoVersion;
 
+/// Requests the COMPONENT_INFORMATION for a single metadata type and then its metadata and translation json.
+/// Both json files are requested at the same time. Json available over http is downloaded in parallel, MAVLink FTP
+/// downloads are queued since FTPManager only supports a single download at a time. Json the vehicle identifies with
+/// a uid is kept in the metadata cache and only downloaded again once the uid or uri changes.
 class RequestMetaDataTypeStateMachine : public StateMachine
 {
     Q_OBJECT
@@ -38,24 +44,34 @@ public:
     void            statesCompleted (void) const final;
 
 private slots:
-    void    _ftpDownloadCompleteMetaDataJson    (const QString& file, const QString& errorMsg);
-    void    _ftpDownloadCompleteTranslationJson (const QString& file, const QString& errorMsg);
-    void    _httpDownloadCompleteMetaDataJson   (QString remoteFile, QString localFile, QString errorMsg);
-    void    _httpDownloadCompleteTranslationJson(QString remoteFile, QString localFile, QString errorMsg);
-    QString _downloadCompleteJsonWorker         (const QString& jsonFileName, const QString& inflatedFileName);
+    void    _ftpDownloadComplete        (const QString& file, const QString& errorMsg);
 
 private:
+    typedef enum {
+        JsonMetaData,
+        JsonTranslation,
+    } JsonType_t;
+
+    void        _requestJson                (JsonType_t jsonType);
+    void        _startNextFtpDownload       (void);
+    void        _jsonReceived               (JsonType_t jsonType, const QByteArray& json, bool downloaded);
+    QString     _jsonUri                    (JsonType_t jsonType) const;
+    uint32_t    _jsonUid                    (JsonType_t jsonType) const;
+    QString     _jsonTypeToString           (JsonType_t jsonType) const;
+    QByteArray  _downloadCompleteJsonWorker (const QString& jsonFileName);
+
     static void _stateRequestCompInfo           (StateMachine* stateMachine);
-    static void _stateRequestMetaDataJson       (StateMachine* stateMachine);
-    static void _stateRequestTranslationJson    (StateMachine* stateMachine);
+    static void _stateRequestJson               (StateMachine* stateMachine);
     static void _stateRequestComplete           (StateMachine* stateMachine);
     static bool _uriIsMAVLinkFTP                (const QString& uri);
 
 
     ComponentInformationManager*    _compMgr                    = nullptr;
     CompInfo*                       _compInfo                   = nullptr;
-    QString                         _jsonMetadataFileName;
-    QString                         _jsonTranslationFileName;
+    QByteArray                      _jsonMetadata;
+    QByteArray                      _jsonTranslation;
+    int                             _cPendingJson               = 0;    ///< Json requests not yet complete
+    QList<JsonType_t>               _ftpQueue;                          ///< Active FTP download first, followed by waiting ones
 
     static StateFn  _rgStates[];
     static int      _cStates;
@@ -75,6 +91,9 @@ public:
     CompInfoParam*      compInfoParam                   (uint8_t compId);
     CompInfoVersion*    compInfoVersion                 (uint8_t compId);
 
+    /// @return Directory which holds metadata json downloaded from vehicles
+    static QDir         metaDataCacheDir                (void);
+
     // Overrides from StateMachine
     int             stateCount  (void) const final;
     const StateFn*  rgStates    (void) const final;
@@ -83,6 +102,9 @@ private:
     void _stateRequestCompInfoComplete  (void);
     bool _isCompTypeSupported           (COMP_METADATA_TYPE type);
 
+    static QString  _cachedJsonFile     (const QString& uri, uint32_t uid);
+    static void     _cacheJson          (const QString& uri, uint32_t uid, const QByteArray& json);
+
     static void _stateRequestCompInfoVersion        (StateMachine* stateMachine);
     static void _stateRequestCompInfoParam          (StateMachine* stateMachine);
     static void _stateRequestAllCompInfoComplete    (StateMachine* stateMachine);
@@ -97,5 +119,7 @@ private:
     static StateFn                  _rgStates[];
     static int                      _cStates;
 
+    static const int                _maxCachedJsonFiles = 50;
+
     friend class RequestMetaDataTypeStateMachine;
 };
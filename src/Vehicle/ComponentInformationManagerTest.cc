@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ComponentInformationManagerTest.h"
+#include "ComponentInformationManager.h"
+#include "CompInfoVersion.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+#include "MockLink.h"
+
+#include <QElapsedTimer>
+#include <QDateTime>
+
+/// Connects a PX4 MockLink through the full initial connect sequence, counting the files opened through MockLinkFTP
+void ComponentInformationManagerTest::_connect(qint64& connectMsecs)
+{
+    QSignalSpy spyVehicle(qgcApp()->toolbox()->multiVehicleManager(), &MultiVehicleManager::activeVehicleChanged);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    _cFtpOpens = 0;
+    _mockLink = MockLink::startPX4MockLink(false);
+    connect(_mockLink->mockLinkFTP(), &MockLinkFTP::openCommandReceived, this, [this](const QString&) { _cFtpOpens++; });
+
+    QCOMPARE(spyVehicle.wait(10000), true);
+    _vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    QVERIFY(_vehicle);
+
+    QSignalSpy spyConnect(_vehicle, &Vehicle::initialConnectComplete);
+    QCOMPARE(spyConnect.wait(30000), true);
+
+    connectMsecs = timer.elapsed();
+}
+
+void ComponentInformationManagerTest::_metaDataCacheWorker(const QDir& cacheDir)
+{
+    // Cold cache: version metadata, parameter metadata and parameter translation are downloaded over MAVLink FTP and cached.
+    // The parameter metadata and translation are requested together.
+    qint64 coldMsecs = 0;
+    _connect(coldMsecs);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QCOMPARE(_cFtpOpens, 3);
+    QFileInfoList rgEntries = cacheDir.entryInfoList(QStringList("*.json"), QDir::Files);
+    QCOMPARE(rgEntries.count(), 3);
+    QVERIFY(_vehicle->compInfoManager()->compInfoVersion(MAV_COMP_ID_AUTOPILOT1)->isMetaDataTypeSupported(COMP_METADATA_TYPE_PARAMETER));
+    _disconnectMockLink();
+
+    // Age the entries so the refresh of the modification time on a cache hit is visible
+    const QDateTime agedTime = QDateTime::currentDateTimeUtc().addDays(-1);
+    for (const QFileInfo& entry : rgEntries) {
+        QFile file(entry.absoluteFilePath());
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QVERIFY(file.setFileTime(agedTime, QFileDevice::FileModificationTime));
+    }
+
+    // Warm cache: the vehicle advertises the same uids, nothing is transferred
+    qint64 warmMsecs = 0;
+    _connect(warmMsecs);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QCOMPARE(_cFtpOpens, 0);
+    QVERIFY(_vehicle->compInfoManager()->compInfoVersion(MAV_COMP_ID_AUTOPILOT1)->isMetaDataTypeSupported(COMP_METADATA_TYPE_PARAMETER));
+    _disconnectMockLink();
+    rgEntries = cacheDir.entryInfoList(QStringList("*.json"), QDir::Files);
+    for (const QFileInfo& entry : rgEntries) {
+        QVERIFY(entry.lastModified() > agedTime);
+    }
+
+    // A truncated entry is discarded and downloaded again
+    const QString truncatedFile = rgEntries[0].absoluteFilePath();
+    QFile file(truncatedFile);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() / 2));
+    file.close();
+    qint64 truncatedMsecs = 0;
+    _connect(truncatedMsecs);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QCOMPARE(_cFtpOpens, 1);
+    QVERIFY(_vehicle->compInfoManager()->compInfoVersion(MAV_COMP_ID_AUTOPILOT1)->isMetaDataTypeSupported(COMP_METADATA_TYPE_PARAMETER));
+    _disconnectMockLink();
+    QCOMPARE(QFileInfo(truncatedFile).size(), rgEntries[0].size());
+
+    qDebug() << "Initial connect with cold metadata cache" << coldMsecs << "msecs, warm" << warmMsecs << "msecs";
+}
+
+void ComponentInformationManagerTest::_metaDataCacheTest(void)
+{
+    Fact* useCompInfoFact = qgcApp()->toolbox()->settingsManager()->appSettings()->useComponentInformationQuery();
+    useCompInfoFact->setRawValue(true);
+
+    QDir cacheDir = ComponentInformationManager::metaDataCacheDir();
+    cacheDir.removeRecursively();
+
+    _metaDataCacheWorker(cacheDir);
+
+    useCompInfoFact->setRawValue(false);
+}
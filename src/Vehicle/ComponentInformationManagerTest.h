@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QDir>
+
+/// Tests the ComponentInformationManager metadata cache against MockLinkFTP
+class ComponentInformationManagerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _metaDataCacheTest(void);
+
+private:
+    void _connect               (qint64& connectMsecs);
+    void _metaDataCacheWorker   (const QDir& cacheDir);
+
+    int _cFtpOpens = 0;
+};
@@ -18,55 +18,184 @@
 
 QGC_LOGGING_CATEGORY(InitialConnectStateMachineLog, "InitialConnectStateMachineLog")
 
-const StateMachine::StateFn InitialConnectStateMachine::_rgStates[] = {
-    InitialConnectStateMachine::_stateRequestCapabilities,
-    InitialConnectStateMachine::_stateRequestProtocolVersion,
-    InitialConnectStateMachine::_stateRequestCompInfo,
-    InitialConnectStateMachine::_stateRequestParameters,
-    InitialConnectStateMachine::_stateRequestMission,
-    InitialConnectStateMachine::_stateRequestGeoFence,
-    InitialConnectStateMachine::_stateRequestRallyPoints,
-    InitialConnectStateMachine::_stateSignalInitialConnectComplete
+#define STEP_MASK(step) (1u << InitialConnectStateMachine::step)
+
+const InitialConnectStateMachine::StepInfo_t InitialConnectStateMachine::_rgSteps[InitialConnectStateMachine::StepCount] = {
+    { "Capabilities",       InitialConnectStateMachine::_stepRequestCapabilities,       0 },
+    { "ProtocolVersion",    InitialConnectStateMachine::_stepRequestProtocolVersion,    STEP_MASK(StepCapabilities) },
+    { "CompInfo",           InitialConnectStateMachine::_stepRequestCompInfo,           STEP_MASK(StepProtocolVersion) },
+    { "Parameters",         InitialConnectStateMachine::_stepRequestParameters,         STEP_MASK(StepCompInfo) },
+    { "Mission",            InitialConnectStateMachine::_stepRequestMission,            STEP_MASK(StepProtocolVersion) },
+    { "GeoFence",           InitialConnectStateMachine::_stepRequestGeoFence,           STEP_MASK(StepMission) },
+    { "RallyPoints",        InitialConnectStateMachine::_stepRequestRallyPoints,        STEP_MASK(StepGeoFence) },
 };
 
-const int InitialConnectStateMachine::_cStates = sizeof(InitialConnectStateMachine::_rgStates) / sizeof(InitialConnectStateMachine::_rgStates[0]);
+const uint32_t InitialConnectStateMachine::_allStepsMask;
 
 InitialConnectStateMachine::InitialConnectStateMachine(Vehicle* vehicle)
     : _vehicle(vehicle)
 {
+    for (int step=0; step<StepCount; step++) {
+        _rgStepStats[step] = { StepWaiting, -1, -1, 0, 0 };
+    }
+}
+
+const char* InitialConnectStateMachine::stepName(Step_t step)
+{
+    return _rgSteps[step].name;
+}
+
+void InitialConnectStateMachine::start(void)
+{
+    _active = true;
+    _connectTimer.start();
+    _startReadySteps();
+}
+
+void InitialConnectStateMachine::_startReadySteps(void)
+{
+    for (int step=0; step<StepCount && _active; step++) {
+        StepStats_t& stats = _rgStepStats[step];
+
+        if (stats.state == StepWaiting && (_rgSteps[step].dependencies & ~_completedSteps) == 0) {
+            stats.state         = StepRunning;
+            stats.startMsecs    = static_cast<int>(_connectTimer.elapsed());
+            qCDebug(InitialConnectStateMachineLog) << "Starting" << _rgSteps[step].name << "at" << stats.startMsecs << "msecs";
+
+            // The step may complete synchronously, which starts the steps waiting on it before we return
+            (*_rgSteps[step].stepFn)(this);
+        }
+    }
+}
+
+void InitialConnectStateMachine::stepComplete(Step_t step)
+{
+    StepStats_t& stats = _rgStepStats[step];
+
+    if (!_active || stats.state != StepRunning) {
+        qCDebug(InitialConnectStateMachineLog) << "Ignoring completion of step which is not running" << _rgSteps[step].name;
+        return;
+    }
+
+    stats.state         = StepDone;
+    stats.completeMsecs = static_cast<int>(_connectTimer.elapsed());
+    _completedSteps    |= 1u << step;
+    qCDebug(InitialConnectStateMachineLog) << "Completed" << _rgSteps[step].name << "in" << stats.completeMsecs - stats.startMsecs << "msecs";
+
+    if (step == StepParameters) {
+        qCDebug(InitialConnectStateMachineLog) << "Vehicle ready for use after" << stats.completeMsecs << "msecs";
+    }
 
+    if (complete()) {
+        _active = false;
+        _logStepStats();
+        qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete";
+        emit _vehicle->initialConnectComplete();
+    } else {
+        _startReadySteps();
+    }
 }
 
-int InitialConnectStateMachine::stateCount(void) const
+void InitialConnectStateMachine::_logStepStats(void) const
 {
-    return _cStates;
+    qCDebug(InitialConnectStateMachineLog) << "Initial connect complete after" << _connectTimer.elapsed() << "msecs";
+    for (int step=0; step<StepCount; step++) {
+        const StepStats_t& stats = _rgStepStats[step];
+        qCDebug(InitialConnectStateMachineLog).noquote() << QStringLiteral("    %1 start:%2 msecs duration:%3 msecs received:%4 bytes sent:%5 bytes")
+                                                  .arg(QString(_rgSteps[step].name), -16)
+                                                  .arg(stats.startMsecs)
+                                                  .arg(stats.completeMsecs - stats.startMsecs)
+                                                  .arg(stats.bytesReceived)
+                                                  .arg(stats.bytesSent);
+    }
 }
 
-const InitialConnectStateMachine::StateFn* InitialConnectStateMachine::rgStates(void) const
+void InitialConnectStateMachine::messageReceived(const mavlink_message_t& message)
 {
-    return &_rgStates[0];
+    if (_active) {
+        int step = _stepForMessage(message);
+        if (_stepRunning(step)) {
+            _rgStepStats[step].bytesReceived += mavlink_msg_get_send_buffer_length(&message);
+        }
+    }
 }
 
-void InitialConnectStateMachine::statesCompleted(void) const
+void InitialConnectStateMachine::messageSent(const mavlink_message_t& message)
 {
+    if (_active) {
+        int step = _stepForMessage(message);
+        if (_stepRunning(step)) {
+            _rgStepStats[step].bytesSent += mavlink_msg_get_send_buffer_length(&message);
+        }
+    }
+}
+
+/// @return Step which the message is part of, StepCount if none
+int InitialConnectStateMachine::_stepForMessage(const mavlink_message_t& message) const
+{
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_AUTOPILOT_VERSION:
+        return StepCapabilities;
+    case MAVLINK_MSG_ID_PROTOCOL_VERSION:
+        return StepProtocolVersion;
+    case MAVLINK_MSG_ID_COMPONENT_INFORMATION:
+    case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+        return StepCompInfo;
+    case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+    case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+    case MAVLINK_MSG_ID_PARAM_VALUE:
+        return StepParameters;
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+    case MAVLINK_MSG_ID_MISSION_COUNT:
+    case MAVLINK_MSG_ID_MISSION_REQUEST:
+    case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+    case MAVLINK_MSG_ID_MISSION_ITEM:
+    case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+    case MAVLINK_MSG_ID_MISSION_ACK:
+        // Mission, fence and rally points take turns on the mission protocol
+        for (int step: { StepMission, StepGeoFence, StepRallyPoints }) {
+            if (_stepRunning(step)) {
+                return step;
+            }
+        }
+        return StepCount;
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+        return _stepForCommand(mavlink_msg_command_long_get_command(&message));
+    case MAVLINK_MSG_ID_COMMAND_ACK:
+        return _stepForCommand(mavlink_msg_command_ack_get_command(&message));
+    default:
+        return StepCount;
+    }
+}
 
+int InitialConnectStateMachine::_stepForCommand(int command) const
+{
+    switch (command) {
+    case MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES:
+        return StepCapabilities;
+    case MAV_CMD_REQUEST_PROTOCOL_VERSION:
+        return StepProtocolVersion;
+    case MAV_CMD_REQUEST_MESSAGE:
+        return StepCompInfo;
+    default:
+        return StepCount;
+    }
 }
 
-void InitialConnectStateMachine::_stateRequestCapabilities(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestCapabilities(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestCapabilities Skipping capability request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stepRequestCapabilities Skipping capability request due to no primary link";
+        connectMachine->stepComplete(StepCapabilities);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping capability request due to link type";
-            connectMachine->advance();
+            connectMachine->stepComplete(StepCapabilities);
         } else {
             qCDebug(InitialConnectStateMachineLog) << "Requesting capabilities";
             vehicle->_waitForMavlinkMessage(_waitForAutopilotVersionResultHandler, connectMachine, MAVLINK_MSG_ID_AUTOPILOT_VERSION, 1000);
@@ -100,7 +229,7 @@ void InitialConnectStateMachine::_capabilitiesCmdResultHandler(void* resultHandl
         qCDebug(InitialConnectStateMachineLog) << "Setting no capabilities";
         vehicle->_setCapabilities(0);
         vehicle->_waitForMavlinkMessageClear();
-        connectMachine->advance();
+        connectMachine->stepComplete(StepCapabilities);
     }
 }
 
@@ -161,26 +290,25 @@ void InitialConnectStateMachine::_waitForAutopilotVersionResultHandler(void* res
 
         vehicle->_setCapabilities(autopilotVersion.capabilities);
     }
-    connectMachine->advance();
+    connectMachine->stepComplete(StepCapabilities);
 }
 
-void InitialConnectStateMachine::_stateRequestProtocolVersion(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestProtocolVersion(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestProtocolVersion Skipping protocol version request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stepRequestProtocolVersion Skipping protocol version request due to no primary link";
+        connectMachine->stepComplete(StepProtocolVersion);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestProtocolVersion Skipping protocol version request due to link type";
-            connectMachine->advance();
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestProtocolVersion Skipping protocol version request due to link type";
+            connectMachine->stepComplete(StepProtocolVersion);
         } else {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestProtocolVersion Requesting protocol version";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestProtocolVersion Requesting protocol version";
             vehicle->_waitForMavlinkMessage(_waitForProtocolVersionResultHandler, connectMachine, MAVLINK_MSG_ID_PROTOCOL_VERSION, 1000);
             vehicle->sendMavCommandWithHandler(_protocolVersionCmdResultHandler,
                                                connectMachine,
@@ -213,7 +341,7 @@ void InitialConnectStateMachine::_protocolVersionCmdResultHandler(void* resultHa
         vehicle->_mavlinkProtocolRequestComplete = true;
         vehicle->_setMaxProtoVersionFromBothSources();
         vehicle->_waitForMavlinkMessageClear();
-        connectMachine->advance();
+        connectMachine->stepComplete(StepProtocolVersion);
     }
 }
 
@@ -239,115 +367,100 @@ void InitialConnectStateMachine::_waitForProtocolVersionResultHandler(void* resu
         vehicle->_mavlinkProtocolRequestComplete = true;
         vehicle->_setMaxProtoVersionFromBothSources();
     }
-    connectMachine->advance();
+    connectMachine->stepComplete(StepProtocolVersion);
 }
 
-void InitialConnectStateMachine::_stateRequestCompInfo(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestCompInfo(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    qCDebug(InitialConnectStateMachineLog) << "_stateRequestCompInfo";
-    vehicle->_componentInformationManager->requestAllComponentInformation(_stateRequestCompInfoComplete, connectMachine);
+    qCDebug(InitialConnectStateMachineLog) << "_stepRequestCompInfo";
+    vehicle->_componentInformationManager->requestAllComponentInformation(_stepRequestCompInfoComplete, connectMachine);
 }
 
-void InitialConnectStateMachine::_stateRequestCompInfoComplete(void* requestAllCompleteFnData)
+void InitialConnectStateMachine::_stepRequestCompInfoComplete(void* requestAllCompleteFnData)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(requestAllCompleteFnData);
 
-    connectMachine->advance();
+    connectMachine->stepComplete(StepCompInfo);
 }
 
-void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestParameters(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    qCDebug(InitialConnectStateMachineLog) << "_stateRequestParameters";
+    qCDebug(InitialConnectStateMachineLog) << "_stepRequestParameters";
     vehicle->_parameterManager->refreshAllParameters();
 }
 
-void InitialConnectStateMachine::_stateRequestMission(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestMission(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stepRequestMission: Skipping first mission load request due to no primary link";
+        connectMachine->stepComplete(StepMission);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to link type";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestMission: Skipping first mission load request due to link type";
             vehicle->_firstMissionLoadComplete();
         } else {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestMission";
             vehicle->_missionManager->loadFromVehicle();
         }
     }
 }
 
-void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestGeoFence(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stepRequestGeoFence: Skipping first geofence load request due to no primary link";
+        connectMachine->stepComplete(StepGeoFence);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to link type";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestGeoFence: Skipping first geofence load request due to link type";
             vehicle->_firstGeoFenceLoadComplete();
         } else {
             if (vehicle->_geoFenceManager->supported()) {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence";
+                qCDebug(InitialConnectStateMachineLog) << "_stepRequestGeoFence";
                 vehicle->_geoFenceManager->loadFromVehicle();
             } else {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: skipped due to no support";
+                qCDebug(InitialConnectStateMachineLog) << "_stepRequestGeoFence: skipped due to no support";
                 vehicle->_firstGeoFenceLoadComplete();
             }
         }
     }
 }
 
-void InitialConnectStateMachine::_stateRequestRallyPoints(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestRallyPoints(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stepRequestRallyPoints: Skipping first rally point load request due to no primary link";
+        connectMachine->stepComplete(StepRallyPoints);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to link type";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestRallyPoints: Skipping first rally point load request due to link type";
             vehicle->_firstRallyPointLoadComplete();
         } else {
             if (vehicle->_rallyPointManager->supported()) {
                 vehicle->_rallyPointManager->loadFromVehicle();
             } else {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: skipping due to no support";
+                qCDebug(InitialConnectStateMachineLog) << "_stepRequestRallyPoints: skipping due to no support";
                 vehicle->_firstRallyPointLoadComplete();
             }
         }
     }
 }
-
-void InitialConnectStateMachine::_stateSignalInitialConnectComplete(StateMachine* stateMachine)
-{
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
-
-    qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete";
-    emit vehicle->initialConnectComplete();
-}
-
@@ -9,35 +9,103 @@
 
 #pragma once
 
-#include "StateMachine.h"
 #include "QGCMAVLink.h"
 #include "QGCLoggingCategory.h"
 #include "Vehicle.h"
 
+#include <QElapsedTimer>
+
 Q_DECLARE_LOGGING_CATEGORY(InitialConnectStateMachineLog)
 
 class Vehicle;
 
-class InitialConnectStateMachine : public StateMachine
+/// Runs the steps of the initial connect sequence. Each step starts as soon as the steps it depends on are
+/// complete, so independent steps run concurrently:
+///
+///     Capabilities -> ProtocolVersion -> CompInfo -> Parameters
+///                                     -> Mission  -> GeoFence -> RallyPoints
+///
+/// Capabilities and protocol version share the single Vehicle::_waitForMavlinkMessage slot. Parameters need the
+/// parameter metadata from component information. Mission, fence and rally points share the mission protocol
+/// which only supports one transfer at a time, and fence/rally support depends on capabilities and protocol version.
+///
+/// Wall time and bytes transferred are recorded for each step.
+class InitialConnectStateMachine
 {
 public:
     InitialConnectStateMachine(Vehicle* vehicle);
 
-    // Overrides from StateMachine
-    int             stateCount      (void) const final;
-    const StateFn*  rgStates        (void) const final;
-    void            statesCompleted (void) const final;
+    typedef enum {
+        StepCapabilities,
+        StepProtocolVersion,
+        StepCompInfo,
+        StepParameters,
+        StepMission,
+        StepGeoFence,
+        StepRallyPoints,
+        StepCount
+    } Step_t;
+
+    /// Starts all steps which have no dependencies
+    void start(void);
+
+    /// Marks the step as complete and starts the steps which were waiting on it. Completing a step which is not
+    /// running is ignored.
+    void stepComplete(Step_t step);
+
+    /// Accounts message bytes to the running step the message belongs to
+    void messageReceived    (const mavlink_message_t& message);
+    void messageSent        (const mavlink_message_t& message);
+
+    bool        active              (void) const { return _active; }
+    bool        complete            (void) const { return _completedSteps == _allStepsMask; }
+    static const char* stepName     (Step_t step);
+
+    /// @return Msecs from start() until the step started/completed, -1 if it has not
+    int         stepStartMsecs      (Step_t step) const { return _rgStepStats[step].startMsecs; }
+    int         stepCompleteMsecs   (Step_t step) const { return _rgStepStats[step].completeMsecs; }
+
+    /// @return Bytes of the step's messages transferred while it was running
+    quint64     stepBytesReceived   (Step_t step) const { return _rgStepStats[step].bytesReceived; }
+    quint64     stepBytesSent       (Step_t step) const { return _rgStepStats[step].bytesSent; }
 
 private:
-    static void _stateRequestCapabilities               (StateMachine* stateMachine);
-    static void _stateRequestProtocolVersion            (StateMachine* stateMachine);
-    static void _stateRequestCompInfo                   (StateMachine* stateMachine);
-    static void _stateRequestCompInfoComplete           (void* requestAllCompleteFnData);
-    static void _stateRequestParameters                 (StateMachine* stateMachine);
-    static void _stateRequestMission                    (StateMachine* stateMachine);
-    static void _stateRequestGeoFence                   (StateMachine* stateMachine);
-    static void _stateRequestRallyPoints                (StateMachine* stateMachine);
-    static void _stateSignalInitialConnectComplete      (StateMachine* stateMachine);
+    typedef void (*StepFn)(InitialConnectStateMachine* connectMachine);
+
+    typedef enum {
+        StepWaiting,
+        StepRunning,
+        StepDone
+    } StepState_t;
+
+    typedef struct {
+        const char* name;
+        StepFn      stepFn;
+        uint32_t    dependencies;   ///< Mask of steps which must complete before this one starts
+    } StepInfo_t;
+
+    typedef struct {
+        StepState_t state;
+        int         startMsecs;
+        int         completeMsecs;
+        quint64     bytesReceived;
+        quint64     bytesSent;
+    } StepStats_t;
+
+    void    _startReadySteps    (void);
+    int     _stepForMessage     (const mavlink_message_t& message) const;
+    int     _stepForCommand     (int command) const;
+    bool    _stepRunning        (int step) const { return step >= 0 && step < StepCount && _rgStepStats[step].state == StepRunning; }
+    void    _logStepStats       (void) const;
+
+    static void _stepRequestCapabilities                (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestProtocolVersion             (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestCompInfo                    (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestCompInfoComplete            (void* requestAllCompleteFnData);
+    static void _stepRequestParameters                  (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestMission                     (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestGeoFence                    (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestRallyPoints                 (InitialConnectStateMachine* connectMachine);
 
     static void _capabilitiesCmdResultHandler           (void* resultHandlerData, int compId, MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode);
     static void _protocolVersionCmdResultHandler        (void* resultHandlerData, int compId, MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode);
@@ -45,8 +113,12 @@ private:
     static void _waitForAutopilotVersionResultHandler   (void* resultHandlerData, bool noResponsefromVehicle, const mavlink_message_t& message);
     static void _waitForProtocolVersionResultHandler    (void* resultHandlerData, bool noResponsefromVehicle, const mavlink_message_t& message);
 
-    Vehicle* _vehicle;
+    Vehicle*        _vehicle;
+    bool            _active         = false;
+    uint32_t        _completedSteps = 0;
+    QElapsedTimer   _connectTimer;
+    StepStats_t     _rgStepStats[StepCount];
 
-    static const StateFn    _rgStates[];
-    static const int        _cStates;
+    static const StepInfo_t _rgSteps[StepCount];
+    static const uint32_t   _allStepsMask = (1u << StepCount) - 1;
 };
@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "InitialConnectStateMachineTest.h"
+#include "InitialConnectStateMachine.h"
+#include "MultiVehicleManager.h"
+#include "ParameterManager.h"
+#include "QGCApplication.h"
+#include "MockLink.h"
+
+void InitialConnectStateMachineTest::_connectWorker(int latencyMsecs, int dropInterval)
+{
+    QSignalSpy spyVehicle(qgcApp()->toolbox()->multiVehicleManager(), &MultiVehicleManager::activeVehicleChanged);
+
+    _parametersReadyMsecs = -1;
+    _connectTimer.start();
+
+    _mockLink = MockLink::startPX4MockLink(false);
+    _mockLink->setLinkQuality(latencyMsecs, dropInterval);
+
+    QCOMPARE(spyVehicle.wait(10000), true);
+    _vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    QVERIFY(_vehicle);
+
+    connect(_vehicle->parameterManager(), &ParameterManager::parametersReadyChanged, this, [this](bool parametersReady) {
+        if (parametersReady && _parametersReadyMsecs < 0) {
+            _parametersReadyMsecs = _connectTimer.elapsed();
+        }
+    });
+
+    QSignalSpy spyConnect(_vehicle, &Vehicle::initialConnectComplete);
+    QCOMPARE(spyConnect.wait(60000), true);
+    const qint64 completeMsecs = _connectTimer.elapsed();
+
+    InitialConnectStateMachine* connectMachine = _vehicle->initialConnectStateMachine();
+    QVERIFY(connectMachine->complete());
+    QVERIFY(!connectMachine->active());
+    for (int i=0; i<InitialConnectStateMachine::StepCount; i++) {
+        InitialConnectStateMachine::Step_t step = static_cast<InitialConnectStateMachine::Step_t>(i);
+        QVERIFY(connectMachine->stepStartMsecs(step) >= 0);
+        QVERIFY(connectMachine->stepCompleteMsecs(step) >= connectMachine->stepStartMsecs(step));
+    }
+
+    // The plan is loaded alongside the parameters instead of after them
+    QVERIFY(connectMachine->stepStartMsecs(InitialConnectStateMachine::StepMission) < connectMachine->stepCompleteMsecs(InitialConnectStateMachine::StepParameters));
+
+    QVERIFY(connectMachine->stepBytesSent(InitialConnectStateMachine::StepParameters) > 0);
+    QVERIFY(connectMachine->stepBytesReceived(InitialConnectStateMachine::StepParameters) > 0);
+    QVERIFY(connectMachine->stepBytesSent(InitialConnectStateMachine::StepMission) > 0);
+    QVERIFY(connectMachine->stepBytesReceived(InitialConnectStateMachine::StepMission) > 0);
+
+    QVERIFY(_parametersReadyMsecs > 0);
+    QVERIFY(_parametersReadyMsecs <= completeMsecs);
+
+    qDebug() << "Link latency" << latencyMsecs << "msecs drop interval" << dropInterval << "- parameters ready after" << _parametersReadyMsecs << "msecs, initial connect complete after" << completeMsecs << "msecs";
+    for (int i=0; i<InitialConnectStateMachine::StepCount; i++) {
+        InitialConnectStateMachine::Step_t step = static_cast<InitialConnectStateMachine::Step_t>(i);
+        qDebug() << "   " << InitialConnectStateMachine::stepName(step)
+                 << "start" << connectMachine->stepStartMsecs(step)
+                 << "duration" << connectMachine->stepCompleteMsecs(step) - connectMachine->stepStartMsecs(step)
+                 << "received" << connectMachine->stepBytesReceived(step)
+                 << "sent" << connectMachine->stepBytesSent(step);
+    }
+
+    _disconnectMockLink();
+}
+
+void InitialConnectStateMachineTest::_perfectLinkTest(void)
+{
+    _connectWorker(0, 0);
+}
+
+void InitialConnectStateMachineTest::_slowLossyLinkTest(void)
+{
+    // Round trip in the range of a long range telemetry radio, with 4% of messages lost each way
+    _connectWorker(100, 25);
+}
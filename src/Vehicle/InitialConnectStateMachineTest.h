@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QElapsedTimer>
+
+/// Measures time-to-ready of the initial connect sequence against MockLink over perfect and degraded links
+class InitialConnectStateMachineTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _perfectLinkTest   (void);
+    void _slowLossyLinkTest (void);
+
+private:
+    void _connectWorker(int latencyMsecs, int dropInterval);
+
+    QElapsedTimer   _connectTimer;
+    qint64          _parametersReadyMsecs = -1;
+};
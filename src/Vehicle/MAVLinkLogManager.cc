@@ -20,6 +20,7 @@
 #include <QNetworkReply>
 #include <QFile>
 #include <QFileInfo>
+#include <QtEndian>
 
 QGC_LOGGING_CATEGORY(MAVLinkLogManagerLog, "MAVLinkLogManagerLog")
 
@@ -117,6 +118,8 @@ MAVLinkLogProcessor::MAVLinkLogProcessor()
     , _written(0)
     , _sequence(-1)
     , _numDrops(0)
+    , _pendingDrops(0)
+    , _lastTimestamp(0)
     , _gotHeader(false)
     , _error(false)
     , _record(nullptr)
@@ -134,6 +137,10 @@ void
 MAVLinkLogProcessor::close()
 {
     if(_fd) {
+        _flush();
+        if(_record) {
+            _record->setSize(_written);
+        }
         fclose(_fd);
         _fd = nullptr;
     }
@@ -150,7 +157,7 @@ MAVLinkLogProcessor::valid()
 bool
 MAVLinkLogProcessor::create(MAVLinkLogManager* manager, const QString path, uint8_t id)
 {
-    _fileName.asprintf("%s/%03d-%s%s",
+    _fileName = QString::asprintf("%s/%03d-%s%s",
                       path.toLatin1().data(),
                       id,
                       QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss-zzz").toLocal8Bit().data(),
@@ -160,6 +167,8 @@ MAVLinkLogProcessor::create(MAVLinkLogManager* manager, const QString path, uint
         _record = new MAVLinkLogFiles(manager, _fileName, true);
         _record->setWriting(true);
         _sequence = -1;
+        _writeBuffer.reserve(kWriteBufferSize);
+        _updateTimer.start();
         return true;
     }
     return false;
@@ -201,96 +210,180 @@ MAVLinkLogProcessor::_checkSequence(uint16_t seq, int& num_drops)
 
 //-----------------------------------------------------------------------------
 void
-MAVLinkLogProcessor::_writeData(void* data, int len)
+MAVLinkLogProcessor::_writeData(const void* data, int len)
 {
     if(!_error) {
-        _error = fwrite(data, 1, len, _fd) != (size_t)len;
-        if(!_error) {
-            _written += len;
-            if(_record) {
-                _record->setSize(_written);
-            }
-        } else {
-            qCDebug(MAVLinkLogManagerLog) << "File IO error:" << len << "bytes into" << _fileName;
+        _writeBuffer.append(static_cast<const char*>(data), len);
+        _written += len;
+        if(_writeBuffer.length() >= kWriteBufferSize) {
+            _flush();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogProcessor::_flush()
+{
+    if(_fd && !_error && _writeBuffer.length()) {
+        _error = fwrite(_writeBuffer.constData(), 1, _writeBuffer.length(), _fd) != (size_t)_writeBuffer.length();
+        if(_error) {
+            qCDebug(MAVLinkLogManagerLog) << "File IO error:" << _writeBuffer.length() << "bytes into" << _fileName;
+        }
+    }
+    //-- Keeps the reserved capacity
+    _writeBuffer.resize(0);
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogProcessor::_periodicUpdate()
+{
+    //-- The size is shown in the UI, there is no point in updating it for every packet
+    if(_updateTimer.elapsed() >= kUpdateMsecs) {
+        _flush();
+        if(_record) {
+            _record->setSize(_written);
         }
+        _updateTimer.restart();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+MAVLinkLogProcessor::_ulogTimestamp(const uint8_t* message, int length, uint64_t& timestamp)
+{
+    //-- Logged data starts with the uint64 timestamp of the topic, logged strings have it after the log level
+    int offset;
+    switch(message[2]) {
+    case 'D':
+        offset = 5;     // header + msg_id
+        break;
+    case 'L':
+        offset = 4;     // header + log_level
+        break;
+    default:
+        return false;
+    }
+    if(length < offset + 8) {
+        return false;
     }
+    timestamp = qFromLittleEndian<quint64>(message + offset);
+    return timestamp != 0;
 }
 
 //-----------------------------------------------------------------------------
-QByteArray
-MAVLinkLogProcessor::_writeUlogMessage(QByteArray& data)
+void
+MAVLinkLogProcessor::_writeDropout(uint64_t timestamp)
+{
+    //-- Use the actual gap between the log timestamps around the dropout. If those are unusable
+    //   fall back to guessing from the number of lost packets.
+    uint64_t duration_ms = (uint64_t)_pendingDrops * 10;
+    if(_lastTimestamp && timestamp > _lastTimestamp) {
+        duration_ms = (timestamp - _lastTimestamp) / 1000;
+    }
+    duration_ms = qMin(duration_ms, (uint64_t)UINT16_MAX);
+    uint8_t dropout[] = {2, 0, 'O', (uint8_t)(duration_ms & 0xff), (uint8_t)(duration_ms >> 8)};
+    _writeData(dropout, sizeof(dropout));
+    _pendingDrops = 0;
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogProcessor::_writeUlogMessage(const uint8_t* message, int length)
+{
+    uint64_t timestamp = 0;
+    bool haveTimestamp = _ulogTimestamp(message, length, timestamp);
+    //-- A dropout is written ahead of the first message after it which tells us how long it was
+    if(_pendingDrops && haveTimestamp) {
+        _writeDropout(timestamp);
+    }
+    _writeData(message, length);
+    if(haveTimestamp) {
+        _lastTimestamp = timestamp;
+    }
+}
+
+//-----------------------------------------------------------------------------
+int
+MAVLinkLogProcessor::_writeUlogMessages(const uint8_t* data, int length)
 {
     //-- Write ulog data w/o integrity checking, assuming data starts with a
-    //   valid ulog message. returns the remaining data at the end.
-    while(data.length() > 2) {
-        uint8_t* ptr = (uint8_t*)data.data();
-        int message_length = ptr[0] + (ptr[1] * 256) + 3; // 3 = ULog msg header
-        if(message_length > data.length())
+    //   valid ulog message. Returns the number of bytes used.
+    int offset = 0;
+    while(length - offset > 2) {
+        int message_length = data[offset] + (data[offset + 1] * 256) + 3; // 3 = ULog msg header
+        if(offset + message_length > length)
             break;
-        _writeData(data.data(), message_length);
-        data.remove(0, message_length);
+        _writeUlogMessage(data + offset, message_length);
+        offset += message_length;
     }
-    return data;
+    return offset;
 }
 
 //-----------------------------------------------------------------------------
 bool
-MAVLinkLogProcessor::processStreamData(uint16_t sequence, uint8_t first_message, QByteArray data)
+MAVLinkLogProcessor::processStreamData(uint16_t sequence, uint8_t first_message, const QByteArray& data)
 {
     int num_drops = 0;
     _error = false;
-    while(_checkSequence(sequence, num_drops)) {
-        //-- The first 16 bytes need special treatment (this sounds awfully brittle)
-        if(!_gotHeader) {
-            if(data.size() < 16) {
-                //-- Shouldn't happen but if it does, we might as well close shop.
-                qCWarning(MAVLinkLogManagerLog) << "Corrupt log header. Canceling log download.";
-                return false;
-            }
-            //-- Write header
-            _writeData(data.data(), 16);
-            data.remove(0, 16);
-            _gotHeader = true;
-            // What about data start offset now that we removed 16 bytes off the start?
-        }
-        if(_gotHeader && num_drops > 0) {
-            if(num_drops > 25) num_drops = 25;
-            //-- Hocus Pocus
-            //   Write a dropout message. We don't really know the actual duration,
-            //   so just use the number of drops * 10 ms
-            uint8_t bogus[] = {2, 0, 79, 0, 0};
-            bogus[3] = num_drops * 10;
-            _writeData(bogus, sizeof(bogus));
-        }
-        if(num_drops > 0) {
-            _writeUlogMessage(_ulogMessage);
-            _ulogMessage.clear();
-            //-- If no useful information in this message. Drop it.
-            if(first_message == 255) {
-                break;
-            }
-            if(first_message > 0) {
-                data.remove(0, first_message);
-                first_message = 0;
-            }
+    if(!_checkSequence(sequence, num_drops)) {
+        //-- Duplicate or reordered packet
+        return true;
+    }
+    const uint8_t*  ptr     = reinterpret_cast<const uint8_t*>(data.constData());
+    const int       length  = data.length();
+    int             offset  = 0;
+    //-- The first 16 bytes are the file header, which is not a ULog message
+    if(!_gotHeader) {
+        if(length < 16) {
+            //-- Shouldn't happen but if it does, we might as well close shop.
+            qCWarning(MAVLinkLogManagerLog) << "Corrupt log header. Canceling log download.";
+            return false;
         }
-        if(first_message == 255 && _ulogMessage.length() > 0) {
-            _ulogMessage.append(data);
-            break;
+        _writeData(ptr, 16);
+        offset = 16;
+        _gotHeader = true;
+    }
+    if(num_drops > 0) {
+        //-- The message which was in progress can't be completed
+        _ulogMessage.clear();
+        _pendingDrops += num_drops;
+        //-- If no useful information in this message. Drop it.
+        if(first_message == 255) {
+            _periodicUpdate();
+            return !_error;
         }
-        if(_ulogMessage.length()) {
-            _writeData(_ulogMessage.data(), _ulogMessage.length());
-            if(first_message) {
-                _writeData(data.left(first_message).data(), first_message);
+        offset = qMax(offset, (int)first_message);
+    } else if(_ulogMessage.length()) {
+        if(first_message == 255) {
+            //-- No message starts in this packet, but the one in progress may end with it
+            _ulogMessage.append(reinterpret_cast<const char*>(ptr + offset), length - offset);
+            int used = _writeUlogMessages(reinterpret_cast<const uint8_t*>(_ulogMessage.constData()), _ulogMessage.length());
+            if(used) {
+                _ulogMessage.remove(0, used);
             }
-            _ulogMessage.clear();
-        }
-        if(first_message) {
-            data.remove(0, first_message);
+            _periodicUpdate();
+            return !_error;
         }
-        _ulogMessage = _writeUlogMessage(data);
-        break;
+        //-- Complete the message started in an earlier packet
+        int end = qBound(offset, (int)first_message, length);
+        _ulogMessage.append(reinterpret_cast<const char*>(ptr + offset), end - offset);
+        _writeUlogMessage(reinterpret_cast<const uint8_t*>(_ulogMessage.constData()), _ulogMessage.length());
+        _ulogMessage.clear();
+        offset = end;
+    } else if(first_message == 255) {
+        //-- Middle of a message we don't have the start of
+        return !_error;
+    } else {
+        offset = qMax(offset, (int)first_message);
+    }
+    offset += _writeUlogMessages(ptr + offset, length - offset);
+    //-- Keep the start of the message which continues in the next packet
+    if(offset < length) {
+        _ulogMessage.append(reinterpret_cast<const char*>(ptr + offset), length - offset);
     }
+    _periodicUpdate();
     return !_error;
 }
 
@@ -12,6 +12,7 @@
 #define MAVLinkLogManager_H
 
 #include <QObject>
+#include <QElapsedTimer>
 
 #include "QmlObjectListModel.h"
 #include "QGCLoggingCategory.h"
@@ -73,6 +74,8 @@ private:
 };
 
 //-----------------------------------------------------------------------------
+/// Writes the ULog stream from LOGGING_DATA messages to a file. Messages are parsed in place and file writes are
+/// buffered, so the cost per packet does not depend on the amount of data in flight.
 class MAVLinkLogProcessor
 {
 public:
@@ -83,19 +86,34 @@ public:
     bool                create      (MAVLinkLogManager *manager, const QString path, uint8_t id);
     MAVLinkLogFiles*    record      () { return _record; }
     QString             fileName    () { return _fileName; }
-    bool                processStreamData(uint16_t _sequence, uint8_t first_message, QByteArray data);
+    quint32             written     () { return _written; }
+    int                 numDrops    () { return _numDrops; }
+    bool                processStreamData(uint16_t _sequence, uint8_t first_message, const QByteArray& data);
+
+    static const int    kWriteBufferSize    = 64 * 1024;    ///< Buffered bytes before the file is written
+    static const int    kUpdateMsecs        = 500;          ///< Interval for file writes and size updates at low rates
+
 private:
-    bool                _checkSequence(uint16_t seq, int &num_drops);
-    QByteArray          _writeUlogMessage(QByteArray &data);
-    void                _writeData(void* data, int len);
+    bool                _checkSequence      (uint16_t seq, int &num_drops);
+    int                 _writeUlogMessages  (const uint8_t* data, int length);
+    void                _writeUlogMessage   (const uint8_t* message, int length);
+    void                _writeDropout       (uint64_t timestamp);
+    void                _writeData          (const void* data, int len);
+    void                _flush              ();
+    void                _periodicUpdate     ();
+    static bool         _ulogTimestamp      (const uint8_t* message, int length, uint64_t& timestamp);
 private:
     FILE*               _fd;
     quint32             _written;
     int                 _sequence;
     int                 _numDrops;
+    int                 _pendingDrops;
+    uint64_t            _lastTimestamp;
     bool                _gotHeader;
     bool                _error;
     QByteArray          _ulogMessage;
+    QByteArray          _writeBuffer;
+    QElapsedTimer       _updateTimer;
     QString             _fileName;
     MAVLinkLogFiles*    _record;
 };
@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogProcessorTest.h"
+#include "MAVLinkLogManager.h"
+#include "QGCApplication.h"
+#include "MockLink.h"
+
+#include <QElapsedTimer>
+#include <QtEndian>
+
+#include <random>
+
+static const int        _ulogHeaderSize     = 16;
+static const uint64_t   _dataIntervalUsecs  = 10000;
+
+void MAVLinkLogProcessorTest::init(void)
+{
+    UnitTest::init();
+
+    _tempDir = new QTemporaryDir();
+    QVERIFY(_tempDir->isValid());
+}
+
+void MAVLinkLogProcessorTest::cleanup(void)
+{
+    delete _tempDir;
+    _tempDir = nullptr;
+
+    UnitTest::cleanup();
+}
+
+/// Generates a ULog file with a format definition, a subscription and then data messages of varying size which are
+/// _dataIntervalUsecs apart. Every 50th message is a logged string.
+///     @param[out] messageStarts Offsets of all messages following the file header
+QByteArray MAVLinkLogProcessorTest::_generateULog(int cDataMessages, QVector<int>& messageStarts)
+{
+    std::mt19937                        generator(7);
+    std::uniform_int_distribution<int>  padding(4, 300);
+
+    QByteArray ulog("ULog\x01\x12\x35\x01", 8);
+    ulog.append(8, '\0');
+    messageStarts.clear();
+
+    auto appendMessage = [&ulog, &messageStarts](char type, const QByteArray& payload) {
+        messageStarts.append(ulog.length());
+        ulog.append(static_cast<char>(payload.length() & 0xff));
+        ulog.append(static_cast<char>(payload.length() >> 8));
+        ulog.append(type);
+        ulog.append(payload);
+    };
+
+    appendMessage('F', QByteArrayLiteral("sensor:uint64_t timestamp;float x;"));
+    appendMessage('A', QByteArray("\0\0\0sensor", 9));
+
+    uint64_t timestamp = 1000000;
+    for (int i=0; i<cDataMessages; i++) {
+        timestamp += _dataIntervalUsecs;
+
+        uint8_t rawTimestamp[sizeof(timestamp)];
+        qToLittleEndian<quint64>(timestamp, rawTimestamp);
+
+        if (i % 50 == 49) {
+            QByteArray payload(1, '6');
+            payload.append(reinterpret_cast<const char*>(rawTimestamp), sizeof(rawTimestamp));
+            payload.append(QStringLiteral("Logged string %1").arg(i).toLatin1());
+            appendMessage('L', payload);
+        } else {
+            QByteArray payload(2, '\0');
+            payload.append(reinterpret_cast<const char*>(rawTimestamp), sizeof(rawTimestamp));
+            payload.append(padding(generator), static_cast<char>(i));
+            appendMessage('D', payload);
+        }
+    }
+
+    return ulog;
+}
+
+/// Splits the ULog data into LOGGING_DATA packets the way the PX4 logger does
+QList<MAVLinkLogProcessorTest::Packet_t> MAVLinkLogProcessorTest::_packetize(const QByteArray& ulog, const QVector<int>& messageStarts)
+{
+    const int       cMaxData    = 249;
+    QList<Packet_t> packets;
+    int             startIndex  = 0;
+    uint16_t        sequence    = 0;
+
+    for (int offset=0; offset<ulog.length(); offset+=cMaxData) {
+        Packet_t packet;
+
+        packet.sequence     = sequence++;
+        packet.data         = ulog.mid(offset, cMaxData);
+        packet.firstMessage = offset == 0 ? 0 : 255;
+        while (startIndex < messageStarts.count() && messageStarts[startIndex] < offset) {
+            startIndex++;
+        }
+        if (offset != 0 && startIndex < messageStarts.count() && messageStarts[startIndex] < offset + packet.data.length()) {
+            packet.firstMessage = static_cast<uint8_t>(messageStarts[startIndex] - offset);
+        }
+        packets.append(packet);
+    }
+
+    return packets;
+}
+
+/// @return false: log does not consist of complete messages
+bool MAVLinkLogProcessorTest::_splitMessages(const QByteArray& ulog, QList<QByteArray>& messages)
+{
+    messages.clear();
+
+    int offset = _ulogHeaderSize;
+    while (offset + 3 <= ulog.length()) {
+        int length = static_cast<uint8_t>(ulog[offset]) + (static_cast<uint8_t>(ulog[offset + 1]) * 256) + 3;
+        if (offset + length > ulog.length()) {
+            return false;
+        }
+        messages.append(ulog.mid(offset, length));
+        offset += length;
+    }
+
+    return offset == ulog.length();
+}
+
+/// @return Timestamp of a data or logged string message, 0 for other messages
+uint64_t MAVLinkLogProcessorTest::_timestamp(const QByteArray& message)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(message.constData());
+
+    switch (message[2]) {
+    case 'D':
+        return qFromLittleEndian<quint64>(data + 5);
+    case 'L':
+        return qFromLittleEndian<quint64>(data + 4);
+    default:
+        return 0;
+    }
+}
+
+bool MAVLinkLogProcessorTest::_createProcessor(MAVLinkLogProcessor& processor)
+{
+    return processor.create(qgcApp()->toolbox()->mavlinkLogManager(), _tempDir->path(), 1);
+}
+
+QByteArray MAVLinkLogProcessorTest::_readLog(MAVLinkLogProcessor& processor)
+{
+    processor.close();
+    delete processor.record();
+
+    QFile file(processor.fileName());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+void MAVLinkLogProcessorTest::_streamTest(void)
+{
+    QVector<int>    messageStarts;
+    QByteArray      ulog    = _generateULog(20000, messageStarts);
+    QList<Packet_t> packets = _packetize(ulog, messageStarts);
+
+    MAVLinkLogProcessor processor;
+    QVERIFY(_createProcessor(processor));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const Packet_t& packet: packets) {
+        QVERIFY(processor.processStreamData(packet.sequence, packet.firstMessage, packet.data));
+    }
+    qint64 processNsecs = timer.nsecsElapsed();
+
+    QCOMPARE(processor.numDrops(), 0);
+    QCOMPARE(static_cast<int>(processor.written()), ulog.length());
+    QCOMPARE(_readLog(processor), ulog);
+
+    qDebug() << "Processed" << ulog.length() << "bytes in" << packets.count() << "packets -" << (ulog.length() / (processNsecs / 1000.0)) << "MB/sec";
+}
+
+void MAVLinkLogProcessorTest::_dropoutTest(void)
+{
+    QVector<int>    messageStarts;
+    QByteArray      ulog    = _generateULog(5000, messageStarts);
+    QList<Packet_t> packets = _packetize(ulog, messageStarts);
+
+    MAVLinkLogProcessor processor;
+    QVERIFY(_createProcessor(processor));
+
+    // Lose one packet in 20 and a burst of 10 in the middle
+    int cDropped = 0;
+    for (int i=0; i<packets.count(); i++) {
+        if (i % 20 == 10 || (i >= 500 && i < 510)) {
+            cDropped++;
+            continue;
+        }
+        const Packet_t& packet = packets[i];
+        QVERIFY(processor.processStreamData(packet.sequence, packet.firstMessage, packet.data));
+    }
+    QCOMPARE(processor.numDrops(), cDropped);
+
+    QByteArray log = _readLog(processor);
+    QCOMPARE(log.left(_ulogHeaderSize), ulog.left(_ulogHeaderSize));
+
+    // Output must be whole messages, each of which is either from the original log or a dropout
+    QList<QByteArray> messages;
+    QVERIFY(_splitMessages(log, messages));
+
+    uint64_t    lastTimestamp   = 0;
+    int         cDropouts       = 0;
+    int         maxDropoutMsecs = 0;
+    for (int i=0; i<messages.count(); i++) {
+        const QByteArray& message = messages[i];
+        if (message[2] == 'O') {
+            QCOMPARE(message.length(), 5);
+            int durationMsecs = static_cast<uint8_t>(message[3]) + (static_cast<uint8_t>(message[4]) * 256);
+
+            // Duration comes from the timestamps around the gap rather than a guess
+            QVERIFY(i + 1 < messages.count());
+            uint64_t nextTimestamp = _timestamp(messages[i + 1]);
+            QVERIFY(nextTimestamp > lastTimestamp);
+            QCOMPARE(static_cast<uint64_t>(durationMsecs), (nextTimestamp - lastTimestamp) / 1000);
+            QVERIFY(durationMsecs >= static_cast<int>(_dataIntervalUsecs / 1000));
+
+            maxDropoutMsecs = qMax(maxDropoutMsecs, durationMsecs);
+            cDropouts++;
+        } else {
+            QVERIFY(ulog.indexOf(message) != -1);
+            if (_timestamp(message)) {
+                lastTimestamp = _timestamp(message);
+            }
+        }
+    }
+    QVERIFY(cDropouts > 0);
+
+    // The 10 packet burst covers roughly 10 * 249 bytes of ~170 byte messages at 10 msecs each
+    QVERIFY(maxDropoutMsecs > 100);
+
+    qDebug() << "Dropped packets:dropouts:longest(msecs)" << cDropped << cDropouts << maxDropoutMsecs;
+}
+
+void MAVLinkLogProcessorTest::_mockLinkStream(int bytesPerSecond, int cDataMessages)
+{
+    QVector<int>    messageStarts;
+    QByteArray      ulog = _generateULog(cDataMessages, messageStarts);
+
+    _connectMockLinkNoInitialConnectSequence();
+
+    MAVLinkLogProcessor processor;
+    QVERIFY(_createProcessor(processor));
+
+    QElapsedTimer   processTimer;
+    qint64          processNsecs    = 0;
+    int             cPackets        = 0;
+    bool            writeFailed     = false;
+
+    QMetaObject::Connection connection = connect(_vehicle, &Vehicle::mavlinkLogData, this,
+                                                 [&](Vehicle*, uint8_t, uint8_t, uint16_t sequence, uint8_t firstMessage, QByteArray data, bool) {
+        processTimer.start();
+        writeFailed |= !processor.processStreamData(sequence, firstMessage, data);
+        processNsecs += processTimer.nsecsElapsed();
+        cPackets++;
+    });
+
+    QElapsedTimer streamTimer;
+    streamTimer.start();
+    _mockLink->startULogStream(ulog, bytesPerSecond);
+
+    const qint64 timeoutMsecs = ((static_cast<qint64>(ulog.length()) * 1000) / bytesPerSecond) + 10000;
+    while ((!_mockLink->ulogStreamComplete() || processor.written() < static_cast<quint32>(ulog.length())) && streamTimer.elapsed() < timeoutMsecs) {
+        QTest::qWait(20);
+    }
+    qint64 streamMsecs = streamTimer.elapsed();
+
+    disconnect(connection);
+
+    QVERIFY(!writeFailed);
+    QCOMPARE(processor.numDrops(), 0);
+    QCOMPARE(_readLog(processor), ulog);
+
+    qDebug() << "MockLink stream at" << bytesPerSecond << "bytes/sec -" << ulog.length() << "bytes," << cPackets << "packets in" << streamMsecs << "msecs,"
+             << (processNsecs / cPackets) / 1000.0 << "usecs/packet, processing" << (processNsecs / 10000.0) / streamMsecs << "% of stream time";
+
+    _disconnectMockLink();
+}
+
+void MAVLinkLogProcessorTest::_mockLinkRadioTest(void)
+{
+    // 57600 baud telemetry radio
+    _mockLinkStream(5000, 60);
+}
+
+void MAVLinkLogProcessorTest::_mockLinkEthernetTest(void)
+{
+    _mockLinkStream(2 * 1024 * 1024, 12000);
+}
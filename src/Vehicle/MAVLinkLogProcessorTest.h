@@ -0,0 +1,49 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QTemporaryDir>
+
+class MAVLinkLogProcessor;
+
+/// Tests MAVLinkLogProcessor against a synthetic ULog stream, fed directly and through MockLink
+class MAVLinkLogProcessorTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init                   (void);
+    void cleanup                (void);
+
+    void _streamTest            (void);
+    void _dropoutTest           (void);
+    void _mockLinkRadioTest     (void);
+    void _mockLinkEthernetTest  (void);
+
+private:
+    typedef struct {
+        uint16_t    sequence;
+        uint8_t     firstMessage;
+        QByteArray  data;
+    } Packet_t;
+
+    static QByteArray       _generateULog   (int cDataMessages, QVector<int>& messageStarts);
+    static QList<Packet_t>  _packetize      (const QByteArray& ulog, const QVector<int>& messageStarts);
+    static bool             _splitMessages  (const QByteArray& ulog, QList<QByteArray>& messages);
+    static uint64_t         _timestamp      (const QByteArray& message);
+
+    bool        _createProcessor    (MAVLinkLogProcessor& processor);
+    QByteArray  _readLog            (MAVLinkLogProcessor& processor);
+    void        _mockLinkStream     (int bytesPerSecond, int cDataMessages);
+
+    QTemporaryDir* _tempDir = nullptr;
+};
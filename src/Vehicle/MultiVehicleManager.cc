@@ -382,6 +382,7 @@ void MultiVehicleManager::_sendGCSHeartbeat(void)
                                             MAV_MODE_MANUAL_ARMED,   // MAV_MODE
                                             0,                       // custom mode
                                             MAV_STATE_ACTIVE);       // MAV_STATE
+            link->signMavlinkMessage(message);
 
             uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
             int len = mavlink_msg_to_send_buffer(buffer, &message);
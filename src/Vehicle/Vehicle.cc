@@ -220,7 +220,6 @@ Vehicle::Vehicle(LinkInterface*             link,
 
     // Listen for system messages
     connect(_toolbox->uasMessageHandler(), &UASMessageHandler::textMessageCountChanged,  this, &Vehicle::_handleTextMessage);
-    connect(_toolbox->uasMessageHandler(), &UASMessageHandler::textMessageReceived,      this, &Vehicle::_handletextMessageReceived);
 
     // MAV_TYPE_GENERIC is used by unit test for creating a vehicle which doesn't do the connect sequence. This
     // way we can test the methods that are used within the connect sequence.
@@ -564,6 +563,8 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     // We give the link manager first whack since it it reponsible for adding new links
     _vehicleLinkManager->mavlinkMessageReceived(link, message);
 
+    _initialConnectStateMachine->messageReceived(message);
+
     //-- Check link status
     _messagesReceived++;
     emit messagesReceivedChanged();
@@ -1617,6 +1618,9 @@ bool Vehicle::sendMessageOnLinkThreadSafe(LinkInterface* link, mavlink_message_t
     // Give the plugin a chance to adjust
     _firmwarePlugin->adjustOutgoingMavlinkMessageThreadSafe(this, link, &message);
 
+    // Signing must come last since it covers the final message contents
+    link->signMavlinkMessage(message);
+
     // Write message into buffer, prepending start sign
     uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
     int len = mavlink_msg_to_send_buffer(buffer, &message);
@@ -1625,6 +1629,8 @@ bool Vehicle::sendMessageOnLinkThreadSafe(LinkInterface* link, mavlink_message_t
     _messagesSent++;
     emit messagesSentChanged();
 
+    _initialConnectStateMachine->messageSent(message);
+
     return true;
 }
 
@@ -1702,23 +1708,23 @@ bool Vehicle::xConfigMotors()
 
 QString Vehicle::formattedMessages()
 {
+    UASMessageListModel* messageModel = _toolbox->uasMessageHandler()->messageModel();
+
     QString messages;
-    for(UASMessage* message: _toolbox->uasMessageHandler()->messages()) {
-        messages += message->getFormatedText();
+    for (int i=0; i<messageModel->count(); i++) {
+        messages += messageModel->at(i).getFormatedText(messageModel->showComponent());
     }
     return messages;
 }
 
-void Vehicle::clearMessages()
+QAbstractListModel* Vehicle::messageModel()
 {
-    _toolbox->uasMessageHandler()->clearMessages();
+    return _toolbox->uasMessageHandler()->messageModel();
 }
 
-void Vehicle::_handletextMessageReceived(UASMessage* message)
+void Vehicle::clearMessages()
 {
-    if (message) {
-        emit newFormattedMessage(message->getFormatedText());
-    }
+    _toolbox->uasMessageHandler()->clearMessages();
 }
 
 void Vehicle::_handleTextMessage(int newCount)
@@ -2046,13 +2052,13 @@ void Vehicle::_updateFlightTime()
 void Vehicle::_firstMissionLoadComplete()
 {
     disconnect(_missionManager, &MissionManager::newMissionItemsAvailable, this, &Vehicle::_firstMissionLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->stepComplete(InitialConnectStateMachine::StepMission);
 }
 
 void Vehicle::_firstGeoFenceLoadComplete()
 {
     disconnect(_geoFenceManager, &GeoFenceManager::loadComplete, this, &Vehicle::_firstGeoFenceLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->stepComplete(InitialConnectStateMachine::StepGeoFence);
 }
 
 void Vehicle::_firstRallyPointLoadComplete()
@@ -2060,7 +2066,7 @@ void Vehicle::_firstRallyPointLoadComplete()
     disconnect(_rallyPointManager, &RallyPointManager::loadComplete, this, &Vehicle::_firstRallyPointLoadComplete);
     _initialPlanRequestComplete = true;
     emit initialPlanRequestCompleteChanged(true);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->stepComplete(InitialConnectStateMachine::StepRallyPoints);
 }
 
 void Vehicle::_parametersReady(bool parametersReady)
@@ -2074,7 +2080,7 @@ void Vehicle::_parametersReady(bool parametersReady)
     if (parametersReady) {
         disconnect(_parameterManager, &ParameterManager::parametersReadyChanged, this, &Vehicle::_parametersReady);
         _setupAutoDisarmSignalling();
-        _initialConnectStateMachine->advance();
+        _initialConnectStateMachine->stepComplete(InitialConnectStateMachine::StepParameters);
     }
 }
 
@@ -47,7 +47,6 @@ class FirmwarePluginManager;
 class AutoPilotPlugin;
 class ParameterManager;
 class JoystickManager;
-class UASMessage;
 class SettingsManager;
 class QGCCameraManager;
 class Joystick;
@@ -162,6 +161,7 @@ public:
     Q_PROPERTY(int                  newMessageCount             READ newMessageCount                                                NOTIFY newMessageCountChanged)
     Q_PROPERTY(int                  messageCount                READ messageCount                                                   NOTIFY messageCountChanged)
     Q_PROPERTY(QString              formattedMessages           READ formattedMessages                                              NOTIFY formattedMessagesChanged)
+    Q_PROPERTY(QAbstractListModel*  messageModel                READ messageModel                                                   CONSTANT)
     Q_PROPERTY(QString              latestError                 READ latestError                                                    NOTIFY latestErrorChanged)
     Q_PROPERTY(bool                 joystickEnabled             READ joystickEnabled            WRITE setJoystickEnabled            NOTIFY joystickEnabledChanged)
     Q_PROPERTY(int                  flowImageIndex              READ flowImageIndex                                                 NOTIFY flowImageIndexChanged)
@@ -504,6 +504,7 @@ public:
     int             newMessageCount             () { return _currentMessageCount; }
     int             messageCount                () { return _messageCount; }
     QString         formattedMessages           ();
+    QAbstractListModel* messageModel            ();
     QString         latestError                 () { return _latestError; }
     float           latitude                    () { return static_cast<float>(_coordinate.latitude()); }
     float           longitude                   () { return static_cast<float>(_coordinate.longitude()); }
@@ -620,6 +621,7 @@ public:
     VehicleLinkManager*             vehicleLinkManager  () { return _vehicleLinkManager; }
     FTPManager*                     ftpManager          () { return _ftpManager; }
     ComponentInformationManager*    compInfoManager     () { return _componentInformationManager; }
+    InitialConnectStateMachine*     initialConnectStateMachine() { return _initialConnectStateMachine; }
     VehicleObjectAvoidance*         objectAvoidance     () { return _objectAvoidance; }
 
     static const int cMaxRcChannels = 18;
@@ -795,7 +797,6 @@ signals:
     void newMessageCountChanged         ();
     void messageCountChanged            ();
     void formattedMessagesChanged       ();
-    void newFormattedMessage            (QString formattedMessage);
     void latestErrorChanged             ();
     void longitudeChanged               ();
     void currentConfigChanged           ();
@@ -872,7 +873,6 @@ private slots:
     void _offlineCruiseSpeedSettingChanged  (QVariant value);
     void _offlineHoverSpeedSettingChanged   (QVariant value);
     void _handleTextMessage                 (int newCount);
-    void _handletextMessageReceived         (UASMessage* message);
     void _imageReady                        (UASInterface* uas);    ///< A new camera image has arrived
     void _prearmErrorTimeout                ();
     void _firstMissionLoadComplete          ();
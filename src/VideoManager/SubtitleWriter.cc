@@ -23,23 +23,48 @@
 #include <QDateTime>
 #include <QString>
 #include <QDate>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QtConcurrent>
 
 QGC_LOGGING_CATEGORY(SubtitleWriterLog, "SubtitleWriterLog")
 
-const int SubtitleWriter::_sampleRate = 1; // Sample rate in Hz for getting telemetry data, most players do weird stuff when > 1Hz
+const int SubtitleWriter::subtitleIntervalMsecs = 1000;
 
 SubtitleWriter::SubtitleWriter(QObject* parent)
     : QObject(parent)
 {
-    connect(&_timer, &QTimer::timeout, this, &SubtitleWriter::_captureTelemetry);
+    connect(&_trackWriter, &TelemetryTrackWriter::trackComplete, this, &SubtitleWriter::_trackComplete);
 }
 
-void SubtitleWriter::startCapturingTelemetry(const QString& videoFile)
+SubtitleWriter::~SubtitleWriter()
 {
-    // Delete facts of last run
-    _facts.clear();
+    // Subtitle generation only uses copies of the file names, so it is left to finish on its own
+    _trackWriter.stop();
+}
+
+QString SubtitleWriter::telemetryTrackFileName(const QString& videoFile)
+{
+    QFileInfo videoFileInfo(videoFile);
+    return QStringLiteral("%1/%2.%3").arg(videoFileInfo.path(), videoFileInfo.completeBaseName(), TelemetryTrack::fileSuffix);
+}
+
+QString SubtitleWriter::subtitleFileName(const QString& videoFile)
+{
+    QFileInfo videoFileInfo(videoFile);
+    return QStringLiteral("%1/%2.ass").arg(videoFileInfo.path(), videoFileInfo.completeBaseName());
+}
+
+void SubtitleWriter::startCapturingTelemetry(const QString& videoFile, TelemetryTrackWriter::Clock_t clock)
+{
+    if (!qgcApp()->toolbox()->multiVehicleManager()->activeVehicle()) {
+        qCWarning(SubtitleWriterLog) << "Attempting to capture fact data with no active vehicle!";
+        return;
+    }
 
-    // Gather the facts currently displayed into _facts
+    QList<Fact*> facts;
+
+    // Gather the facts currently displayed into facts
     FactValueGrid* grid = new FactValueGrid();
     grid->setProperty("userSettingsGroup", HorizontalFactValueGrid::telemetryBarUserSettingsGroup);
     grid->setProperty("defaultSettingsGroup", HorizontalFactValueGrid::telemetryBarDefaultSettingsGroup);
@@ -48,25 +73,63 @@ void SubtitleWriter::startCapturingTelemetry(const QString& videoFile)
         QmlObjectListModel* list = grid->columns()->value<QmlObjectListModel*>(colIndex);
         for (int rowIndex = 0; rowIndex < list->count(); rowIndex++) {
             InstrumentValueData* value = list->value<InstrumentValueData*>(rowIndex);
-            _facts += value->fact();
+            facts += value->fact();
         }
     }
     grid->deleteLater();
 
-    // One subtitle always starts where the previous ended
-    _lastEndTime = QTime(0, 0);
+    _subtitleFiles[telemetryTrackFileName(videoFile)] = subtitleFileName(videoFile);
+    _trackWriter.start(telemetryTrackFileName(videoFile), facts, clock);
+}
 
-    QFileInfo videoFileInfo(videoFile);
-    QString subtitleFilePath = QStringLiteral("%1/%2.ass").arg(videoFileInfo.path(), videoFileInfo.completeBaseName());
-    qCDebug(SubtitleWriterLog) << "Writing overlay to file:" << subtitleFilePath;
-    _file.setFileName(subtitleFilePath);
+void SubtitleWriter::stopCapturingTelemetry()
+{
+    if (!_trackWriter.running()) {
+        return;
+    }
 
-    if (!_file.open(QIODevice::ReadWrite)) {
-        qCWarning(SubtitleWriterLog) << "Unable to write subtitle data to file";
+    qCDebug(SubtitleWriterLog) << "Stopping writing";
+    _trackWriter.stop();
+}
+
+/// Called once the telemetry track file is completely written
+void SubtitleWriter::_trackComplete(const QString& trackFile)
+{
+    // Generating the subtitles for a long recording takes a while, don't block the ui for it. Subtitle files are
+    // written one at a time, each job waits for the previous one on the worker side.
+    if (!_subtitleFiles.contains(trackFile)) {
+        qCWarning(SubtitleWriterLog) << "Telemetry track completed for unknown recording" << trackFile;
         return;
     }
+    QString         subtitleFile    = _subtitleFiles.take(trackFile);
+    QFuture<bool>   previousFuture  = _subtitleFuture;
+    _subtitleFuture = QtConcurrent::run([trackFile, subtitleFile, previousFuture]() mutable {
+        previousFuture.waitForFinished();
+
+        QString errorString;
+        if (!SubtitleWriter::generateSubtitles(trackFile, subtitleFile, subtitleIntervalMsecs, errorString)) {
+            qCWarning(SubtitleWriterLog) << "Unable to write subtitle data to file" << errorString;
+            return false;
+        }
+        qCDebug(SubtitleWriterLog) << "Wrote overlay to file:" << subtitleFile;
+        return true;
+    });
+}
 
-    QTextStream stream( &_file );
+bool SubtitleWriter::generateSubtitles(const QString& telemetryTrackFile, const QString& subtitleFile, int intervalMsecs, QString& errorString)
+{
+    TelemetryTrack track;
+    if (!track.load(telemetryTrackFile, errorString)) {
+        return false;
+    }
+
+    QFile file(subtitleFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        errorString = tr("Unable to open file %1: %2").arg(subtitleFile, file.errorString());
+        return false;
+    }
+
+    QTextStream stream(&file);
 
     // This is file header
     stream << QStringLiteral(
@@ -90,51 +153,51 @@ void SubtitleWriter::startCapturingTelemetry(const QString& videoFile)
     // TODO: Find a good way to input title
     //stream << QStringLiteral("Dialogue: 0,0:00:00.00,999:00:00.00,Default,,0,0,0,,{\\pos(5,35)}%1\n");
 
-    _timer.start(1000/_sampleRate);
-}
-
-void SubtitleWriter::stopCapturingTelemetry()
-{
-    qCDebug(SubtitleWriterLog) << "Stopping writing";
-    _timer.stop();
-    _file.close();
-}
-
-void SubtitleWriter::_captureTelemetry()
-{
-    static const float nRows = 3; // number of rows used for displaying data
-    static const int offsetFactor = 700; // Used to simulate a larger resolution and reduce the borders in the layout
+    // Each entry shows the values as of the start of its interval
+    QStringList values;
+    for (int i=0; i<track.names.count(); i++) {
+        values.append(QString());
+    }
+    QStringList names;
+    for (const QString& name : track.names) {
+        names.append(QStringLiteral("%1:").arg(name));
+    }
 
-    auto *vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    const qint64    intervalNsecs   = static_cast<qint64>(qMax(intervalMsecs, 1)) * 1000000;
+    int             sampleIndex     = 0;
+    for (qint64 startNsecs = 0; startNsecs == 0 || startNsecs < track.endNsecs; startNsecs += intervalNsecs) {
+        while (sampleIndex < track.samples.count() && track.samples[sampleIndex].timeNsecs <= startNsecs) {
+            const TelemetryTrack::Sample_t& sample = track.samples[sampleIndex++];
+            values[sample.index] = QStringLiteral("%1 %2").arg(sample.value, track.units[sample.index]);
+        }
 
-    if (!vehicle) {
-        qCWarning(SubtitleWriterLog) << "Attempting to capture fact data with no active vehicle!";
-        return;
+        QTime       start       = QTime(0, 0).addMSecs(static_cast<int>(startNsecs / 1000000));
+        QTime       end         = start.addMSecs(static_cast<int>(intervalNsecs / 1000000));
+        QDateTime   timestamp   = QDateTime::fromMSecsSinceEpoch(track.startUtcMsecs + startNsecs / 1000000);
+        for (const QString& event : _subtitleEvents(names, values, start, end, timestamp)) {
+            stream << event;
+        }
     }
-    // Each list corresponds to a column in the subtitles
-    QStringList namesStrings;
-    QStringList valuesStrings;
-
-    // Make a list of "factname:" strings and other with the values, so one can be aligned left and the other right
-    for (const Fact* fact : _facts) {
-        valuesStrings << QStringLiteral("%2 %3").arg(fact->cookedValueString())
-                                                .arg(fact->cookedUnits());
-        namesStrings << QStringLiteral("%1:").arg(fact->shortDescription());
+
+    stream.flush();
+    if (file.error() != QFile::NoError) {
+        errorString = file.errorString();
+        return false;
     }
 
-    // The time to start displaying this subtitle text
-    QTime start = _lastEndTime;
+    return true;
+}
 
-    // The time to stop displaying this subtitle text
-    QTime end = start.addMSecs(1000/_sampleRate);
-    _lastEndTime = end;
+QStringList SubtitleWriter::_subtitleEvents(const QStringList& namesStrings, const QStringList& valuesStrings, const QTime& start, const QTime& end, const QDateTime& timestamp)
+{
+    static const float nRows = 3; // number of rows used for displaying data
+    static const int offsetFactor = 700; // Used to simulate a larger resolution and reduce the borders in the layout
 
     // This splits the screen in N parts and uses the N-1 internal parts to align the subtitles to.
     // Should we try to get the resolution from the pipeline? This seems to work fine with other resolutions too.
     static const int rowWidth = (1920 + offsetFactor)/(nRows+1);
-    int nValuesByRow = ceil(_facts.length() / nRows);
+    int nValuesByRow = ceil(namesStrings.length() / nRows);
 
-    QList<QStringList> dataColumns;
     QStringList stringColumns;
 
     // These templates are used for the data columns, one right-aligned for names and one for
@@ -166,10 +229,7 @@ void SubtitleWriter::_captureTelemetry()
     stringColumns << QStringLiteral("Dialogue: 0,%1,%2,Default,,0,0,0,,{\\pos(10,35)}%3\n")
         .arg(start.toString("H:mm:ss.zzz").chopped(2))
         .arg(end.toString("H:mm:ss.zzz").chopped(2))
-        .arg(QDateTime::currentDateTime().toString(Qt::SystemLocaleShortDate));
-    // Write new data
-    QTextStream stream(&_file);
-    for (const auto& i : stringColumns) {
-        stream << i;
-    }
+        .arg(timestamp.toString(Qt::SystemLocaleShortDate));
+
+    return stringColumns;
 }
@@ -18,34 +18,46 @@
 
 #include "QGCLoggingCategory.h"
 #include "Fact.h"
+#include "TelemetryTrack.h"
 #include <QObject>
-#include <QTimer>
 #include <QDateTime>
-#include <QFile>
+#include <QFuture>
+#include <QHash>
 
 Q_DECLARE_LOGGING_CATEGORY(SubtitleWriterLog)
 
+/// Records the telemetry bar values alongside a video recording. During recording every value change is written to a
+/// TelemetryTrack file timestamped against the video pipeline clock. Once recording stops an ASS subtitle file is
+/// generated from the track in the background.
 class SubtitleWriter : public QObject
 {
     Q_OBJECT
 
 public:
     explicit SubtitleWriter(QObject* parent = nullptr);
-    ~SubtitleWriter() = default;
+    ~SubtitleWriter();
 
     // starts capturing vehicle telemetry.
-    void startCapturingTelemetry(const QString& videoFile);
+    //  @param clock Video file time source, see TelemetryTrackWriter::Clock_t
+    void startCapturingTelemetry(const QString& videoFile, TelemetryTrackWriter::Clock_t clock = TelemetryTrackWriter::Clock_t());
     void stopCapturingTelemetry();
 
+    /// Generates an ASS subtitle file from a telemetry track
+    ///     @param intervalMsecs Length of each subtitle entry
+    static bool generateSubtitles(const QString& telemetryTrackFile, const QString& subtitleFile, int intervalMsecs, QString& errorString);
+
+    static QString telemetryTrackFileName   (const QString& videoFile);
+    static QString subtitleFileName         (const QString& videoFile);
+
+    static const int subtitleIntervalMsecs; // Most players do weird stuff when subtitles change faster than 1Hz
+
 private slots:
-    // Captures a snapshot of telemetry data from vehicle into the subtitles file.
-    void _captureTelemetry();
+    void _trackComplete(const QString& trackFile);
 
 private:
-    QTimer _timer;
-    QList<Fact*> _facts;
-    QTime _lastEndTime;
-    QFile _file;
+    static QStringList _subtitleEvents(const QStringList& names, const QStringList& values, const QTime& start, const QTime& end, const QDateTime& timestamp);
 
-    static const int _sampleRate; // Sample rate in Hz for getting telemetry data, most players do weird stuff when > 1Hz
+    TelemetryTrackWriter    _trackWriter;
+    QHash<QString, QString> _subtitleFiles;     ///< Subtitle file to generate for each telemetry track being written
+    QFuture<bool>           _subtitleFuture;    ///< Last subtitle file generation started
 };
@@ -0,0 +1,290 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryTrack.h"
+#include "Fact.h"
+
+#include <QDateTime>
+#include <QTextStream>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(TelemetryTrackLog, "TelemetryTrackLog")
+
+const char* TelemetryTrack::fileSuffix  = "telemetry.csv";
+const int   TelemetryTrack::fileVersion = 1;
+
+QByteArray TelemetryTrack::csvField(const QString& field)
+{
+    if (!field.contains(',') && !field.contains('"') && !field.contains('\n')) {
+        return field.toUtf8();
+    }
+
+    QString quoted = field;
+    quoted.replace(QStringLiteral("\""), QStringLiteral("\"\""));
+    quoted.replace('\n', ' ');
+    return QStringLiteral("\"%1\"").arg(quoted).toUtf8();
+}
+
+QStringList TelemetryTrack::parseCsvLine(const QString& line)
+{
+    QStringList fields;
+    QString     field;
+    bool        inQuotes = false;
+
+    for (int i=0; i<line.length(); i++) {
+        QChar c = line[i];
+        if (inQuotes) {
+            if (c == '"') {
+                if (i + 1 < line.length() && line[i + 1] == '"') {
+                    field += c;
+                    i++;
+                } else {
+                    inQuotes = false;
+                }
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            inQuotes = true;
+        } else if (c == ',') {
+            fields.append(field);
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields.append(field);
+
+    return fields;
+}
+
+bool TelemetryTrack::load(const QString& fileName, QString& errorString)
+{
+    names.clear();
+    units.clear();
+    samples.clear();
+    startUtcMsecs = endNsecs = 0;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        errorString = QObject::tr("Unable to open file %1: %2").arg(fileName, file.errorString());
+        return false;
+    }
+
+    QTextStream stream(&file);
+    bool        sawHeader = false;
+    while (!stream.atEnd()) {
+        QString line = stream.readLine();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        if (line.startsWith('#')) {
+            QStringList fields = parseCsvLine(line.mid(1).trimmed());
+            const QString& type = fields[0];
+            if (type == QStringLiteral("QGroundControl telemetry track")) {
+                if (fields.count() < 2 || fields[1].toInt() > fileVersion) {
+                    errorString = QObject::tr("Unsupported telemetry track version");
+                    return false;
+                }
+                sawHeader = true;
+            } else if (type == QStringLiteral("start") && fields.count() >= 2) {
+                startUtcMsecs = fields[1].toLongLong();
+            } else if (type == QStringLiteral("end") && fields.count() >= 2) {
+                endNsecs = fields[1].toLongLong();
+            } else if (type == QStringLiteral("fact") && fields.count() >= 4) {
+                int index = fields[1].toInt();
+                if (index != names.count()) {
+                    errorString = QObject::tr("Telemetry track fact index out of order");
+                    return false;
+                }
+                names.append(fields[2]);
+                units.append(fields[3]);
+            }
+            continue;
+        }
+
+        if (!sawHeader) {
+            errorString = QObject::tr("File is not a telemetry track");
+            return false;
+        }
+
+        // Quick split for the common unquoted case
+        int firstComma  = line.indexOf(',');
+        int secondComma = firstComma == -1 ? -1 : line.indexOf(',', firstComma + 1);
+        if (secondComma == -1) {
+            qCWarning(TelemetryTrackLog) << "Skipping bad sample" << line;
+            continue;
+        }
+
+        Sample_t sample;
+        sample.timeNsecs    = line.leftRef(firstComma).toLongLong();
+        sample.index        = line.midRef(firstComma + 1, secondComma - firstComma - 1).toInt();
+        sample.value        = line.mid(secondComma + 1);
+        if (sample.value.startsWith('"')) {
+            sample.value = parseCsvLine(sample.value).first();
+        }
+        if (sample.index < 0 || sample.index >= names.count()) {
+            qCWarning(TelemetryTrackLog) << "Skipping sample for unknown fact" << line;
+            continue;
+        }
+        samples.append(sample);
+    }
+
+    if (!sawHeader) {
+        errorString = QObject::tr("File is not a telemetry track");
+        return false;
+    }
+
+    // Samples are written in order, but the pipeline clock is not guaranteed to be monotonic across all platforms
+    std::stable_sort(samples.begin(), samples.end(), [](const Sample_t& a, const Sample_t& b) { return a.timeNsecs < b.timeNsecs; });
+    if (!samples.isEmpty()) {
+        endNsecs = qMax(endNsecs, samples.last().timeNsecs);
+    }
+
+    return true;
+}
+
+void TelemetryTrackFileWorker::open(const QString& fileName)
+{
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(TelemetryTrackLog) << "Unable to open telemetry track file" << fileName << _file.errorString();
+    }
+}
+
+void TelemetryTrackFileWorker::write(const QByteArray& data)
+{
+    if (_file.isOpen() && _file.write(data) != data.size()) {
+        qCWarning(TelemetryTrackLog) << "Telemetry track write failed" << _file.errorString();
+    }
+}
+
+void TelemetryTrackFileWorker::close(void)
+{
+    if (_file.isOpen()) {
+        _file.close();
+        emit closed(_file.fileName());
+    }
+}
+
+TelemetryTrackWriter::TelemetryTrackWriter(QObject* parent)
+    : QObject(parent)
+{
+    _worker = new TelemetryTrackFileWorker();
+    _worker->moveToThread(&_workerThread);
+    connect(&_workerThread, &QThread::finished, _worker, &QObject::deleteLater);
+    connect(this, &TelemetryTrackWriter::_openFile,  _worker, &TelemetryTrackFileWorker::open);
+    connect(this, &TelemetryTrackWriter::_writeData, _worker, &TelemetryTrackFileWorker::write);
+    connect(this, &TelemetryTrackWriter::_closeFile, _worker, &TelemetryTrackFileWorker::close);
+    connect(_worker, &TelemetryTrackFileWorker::closed, this, &TelemetryTrackWriter::trackComplete);
+    _workerThread.start();
+
+    _flushTimer.setSingleShot(false);
+    _flushTimer.setInterval(_flushIntervalMsecs);
+    connect(&_flushTimer, &QTimer::timeout, this, &TelemetryTrackWriter::_flush);
+}
+
+TelemetryTrackWriter::~TelemetryTrackWriter()
+{
+    stop();
+
+    // Quit from the worker thread so the queued writes and close are done first
+    QThread* thread = &_workerThread;
+    QMetaObject::invokeMethod(_worker, [thread]() { thread->quit(); }, Qt::QueuedConnection);
+    _workerThread.wait();
+}
+
+void TelemetryTrackWriter::start(const QString& fileName, const QList<Fact*>& facts, Clock_t clock)
+{
+    stop();
+
+    _facts          = facts;
+    _clock          = clock;
+    _sampleCount    = 0;
+    _running        = true;
+    _elapsed.start();
+    _factIndexMap.clear();
+
+    qCDebug(TelemetryTrackLog) << "Writing telemetry track to" << fileName;
+    emit _openFile(fileName);
+
+    _pending = QStringLiteral("# QGroundControl telemetry track,%1\n# start,%2\n").arg(TelemetryTrack::fileVersion).arg(QDateTime::currentMSecsSinceEpoch()).toUtf8();
+    for (int i=0; i<_facts.count(); i++) {
+        const Fact* fact = _facts[i];
+        _pending += "# fact," + QByteArray::number(i) + "," + TelemetryTrack::csvField(fact->shortDescription()) + "," + TelemetryTrack::csvField(fact->cookedUnits()) + "\n";
+        _factIndexMap.insert(fact, i);
+        connect(fact, &Fact::rawValueChanged, this, &TelemetryTrackWriter::_factValueChanged, Qt::UniqueConnection);
+    }
+
+    // Initial values
+    for (int i=0; i<_facts.count(); i++) {
+        _addSample(i, _facts[i]);
+    }
+
+    _flush();
+    _flushTimer.start();
+}
+
+void TelemetryTrackWriter::stop(void)
+{
+    if (!_running) {
+        return;
+    }
+
+    _flushTimer.stop();
+    for (const Fact* fact : _facts) {
+        disconnect(fact, &Fact::rawValueChanged, this, &TelemetryTrackWriter::_factValueChanged);
+    }
+
+    _pending += "# end," + QByteArray::number(_now()) + "\n";
+    _flush();
+
+    // Queued writes are processed in order, the worker signals trackComplete once the file is closed. Nothing waits
+    // for it here since slow storage would stall the ui.
+    emit _closeFile();
+
+    qCDebug(TelemetryTrackLog) << "Telemetry track complete, samples:" << _sampleCount;
+    _facts.clear();
+    _factIndexMap.clear();
+    _running = false;
+}
+
+qint64 TelemetryTrackWriter::_now(void)
+{
+    qint64 now = _clock ? _clock() : -1;
+    return now < 0 ? _elapsed.nsecsElapsed() : now;
+}
+
+void TelemetryTrackWriter::_addSample(int index, const Fact* fact)
+{
+    _pending += QByteArray::number(_now()) + "," + QByteArray::number(index) + "," + TelemetryTrack::csvField(fact->cookedValueString()) + "\n";
+    _sampleCount++;
+
+    if (_pending.size() >= _flushSize) {
+        _flush();
+    }
+}
+
+void TelemetryTrackWriter::_factValueChanged(void)
+{
+    // The same fact may be displayed more than once
+    for (auto it = _factIndexMap.constFind(sender()); it != _factIndexMap.constEnd() && it.key() == sender(); it++) {
+        _addSample(it.value(), _facts[it.value()]);
+    }
+}
+
+void TelemetryTrackWriter::_flush(void)
+{
+    if (!_pending.isEmpty()) {
+        emit _writeData(_pending);
+        _pending.clear();
+    }
+}
@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCLoggingCategory.h"
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QFile>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QVector>
+
+#include <functional>
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryTrackLog)
+
+class Fact;
+
+/// Telemetry track which is recorded alongside a video recording. The file is CSV:
+///     # QGroundControl telemetry track,1
+///     # start,<recording start in UTC msecs since epoch>
+///     # fact,<index>,<short description>,<units>
+///     <time nsecs>,<fact index>,<cooked value string>
+///     # end,<time nsecs>
+/// Times are in nanoseconds relative to the start of the video file.
+class TelemetryTrack
+{
+public:
+    typedef struct {
+        qint64  timeNsecs;
+        int     index;
+        QString value;
+    } Sample_t;
+
+    bool load(const QString& fileName, QString& errorString);
+
+    QStringList         names;
+    QStringList         units;
+    qint64              startUtcMsecs   = 0;
+    qint64              endNsecs        = 0;
+    QVector<Sample_t>   samples;                ///< Sorted by time
+
+    static QByteArray   csvField        (const QString& field);
+    static QStringList  parseCsvLine    (const QString& line);
+
+    static const char*  fileSuffix;
+    static const int    fileVersion;
+};
+
+/// Writes to the telemetry track file on a separate thread. Used internally by TelemetryTrackWriter.
+class TelemetryTrackFileWorker : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void open   (const QString& fileName);
+    void write  (const QByteArray& data);
+    void close  (void);
+
+signals:
+    void closed (const QString& fileName);
+
+private:
+    QFile _file;
+};
+
+/// Records the values of a set of facts at full update rate into a TelemetryTrack file.
+///
+/// Every fact value change is timestamped by the supplied clock, which for video recordings is the pipeline running
+/// time relative to the first frame in the file. Formatting happens on the calling thread since Facts are not thread
+/// safe, the samples are batched and written from a worker thread.
+class TelemetryTrackWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Returns the current time in nanoseconds, negative if not known in which case time since start is used
+    typedef std::function<qint64(void)> Clock_t;
+
+    TelemetryTrackWriter(QObject* parent = nullptr);
+    ~TelemetryTrackWriter();
+
+    /// Starts recording
+    ///     @param clock Time source for samples, may be empty
+    void start  (const QString& fileName, const QList<Fact*>& facts, Clock_t clock);
+
+    /// Stops recording. Returns right away, trackComplete is signalled once all samples have been written.
+    void stop   (void);
+
+    bool    running     (void) const { return _running; }
+    int     sampleCount (void) const { return _sampleCount; }
+
+signals:
+    void trackComplete  (const QString& fileName);
+
+    void _openFile      (const QString& fileName);
+    void _writeData     (const QByteArray& data);
+    void _closeFile     (void);
+
+private slots:
+    void _factValueChanged  (void);
+    void _flush             (void);
+
+private:
+    qint64  _now            (void);
+    void    _addSample      (int index, const Fact* fact);
+
+    QThread                         _workerThread;
+    TelemetryTrackFileWorker*       _worker         = nullptr;
+    QTimer                          _flushTimer;
+    QList<Fact*>                    _facts;
+    QMultiHash<const QObject*, int> _factIndexMap;
+    Clock_t                         _clock;
+    QElapsedTimer                   _elapsed;
+    QByteArray                      _pending;
+    int                             _sampleCount    = 0;
+    bool                            _running        = false;
+
+    static const int _flushIntervalMsecs    = 250;
+    static const int _flushSize             = 64 * 1024;
+};
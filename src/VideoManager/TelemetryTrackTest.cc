@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryTrackTest.h"
+#include "TelemetryTrack.h"
+#include "SubtitleWriter.h"
+#include "Fact.h"
+
+void TelemetryTrackTest::init(void)
+{
+    UnitTest::init();
+
+    _tempDir = new QTemporaryDir();
+    QVERIFY(_tempDir->isValid());
+
+    _voltageFact = new Fact(0, QStringLiteral("voltage"), FactMetaData::valueTypeDouble, this);
+    _voltageFact->metaData()->setShortDescription(QStringLiteral("Voltage, main"));
+    _voltageFact->metaData()->setRawUnits(QStringLiteral("V"));
+    _voltageFact->metaData()->setDecimalPlaces(2);
+
+    _modeFact = new Fact(0, QStringLiteral("mode"), FactMetaData::valueTypeString, this);
+    _modeFact->metaData()->setShortDescription(QStringLiteral("Mode"));
+    _modeFact->setRawValue(QStringLiteral("Manual"));
+}
+
+void TelemetryTrackTest::cleanup(void)
+{
+    delete _voltageFact;
+    delete _modeFact;
+    delete _tempDir;
+    _voltageFact    = nullptr;
+    _modeFact       = nullptr;
+    _tempDir        = nullptr;
+
+    UnitTest::cleanup();
+}
+
+void TelemetryTrackTest::_csvTest(void)
+{
+    QStringList fields = { QStringLiteral("plain"), QStringLiteral("with, comma"), QStringLiteral("with \"quote\""), QString() };
+
+    QByteArray line;
+    for (const QString& field : fields) {
+        if (!line.isEmpty()) {
+            line += ",";
+        }
+        line += TelemetryTrack::csvField(field);
+    }
+    QCOMPARE(TelemetryTrack::parseCsvLine(QString::fromUtf8(line)), fields);
+}
+
+/// Writes a track with the synthetic clock:
+///     0.000s      initial values
+///     0.033s      voltage 12.5
+///     0.066s      mode
+///     1.500s      voltage 12.4
+///     2.200s      end
+void TelemetryTrackTest::_writeTrack(const QString& fileName)
+{
+    TelemetryTrackWriter    writer;
+    qint64                  clockNsecs = 0;
+
+    writer.start(fileName, { _voltageFact, _modeFact }, [&clockNsecs]() { return clockNsecs; });
+    QVERIFY(writer.running());
+
+    clockNsecs = 33333333;
+    _voltageFact->setRawValue(12.5);
+    clockNsecs = 66666666;
+    _modeFact->setRawValue(QStringLiteral("Hold, \"pos\""));
+    clockNsecs = 1500000000;
+    _voltageFact->setRawValue(12.4);
+    clockNsecs = 2200000000;
+
+    // Stop doesn't wait for the file to be written
+    QSignalSpy completeSpy(&writer, &TelemetryTrackWriter::trackComplete);
+    writer.stop();
+
+    QVERIFY(!writer.running());
+    QCOMPARE(writer.sampleCount(), 5);
+    QVERIFY(completeSpy.count() || completeSpy.wait(5000));
+    QCOMPARE(completeSpy.takeFirst()[0].toString(), fileName);
+
+    // No samples after stop
+    _voltageFact->setRawValue(10.0);
+    QCOMPARE(writer.sampleCount(), 5);
+}
+
+void TelemetryTrackTest::_writeReadTest(void)
+{
+    QString fileName = _tempDir->filePath(QStringLiteral("test.telemetry.csv"));
+    _writeTrack(fileName);
+
+    TelemetryTrack  track;
+    QString         errorString;
+    QVERIFY2(track.load(fileName, errorString), qPrintable(errorString));
+
+    QCOMPARE(track.names, QStringList({ QStringLiteral("Voltage, main"), QStringLiteral("Mode") }));
+    QCOMPARE(track.units[0], QStringLiteral("V"));
+    QVERIFY(track.startUtcMsecs > 0);
+    QCOMPARE(track.endNsecs, 2200000000LL);
+    QCOMPARE(track.samples.count(), 5);
+
+    QCOMPARE(track.samples[0].timeNsecs, 0LL);
+    QCOMPARE(track.samples[0].index, 0);
+    QCOMPARE(track.samples[1].index, 1);
+    QCOMPARE(track.samples[1].value, QStringLiteral("Manual"));
+    QCOMPARE(track.samples[2].timeNsecs, 33333333LL);
+    QCOMPARE(track.samples[2].value, QStringLiteral("12.50"));
+    QCOMPARE(track.samples[3].timeNsecs, 66666666LL);
+    QCOMPARE(track.samples[3].value, QStringLiteral("Hold, \"pos\""));
+    QCOMPARE(track.samples[4].timeNsecs, 1500000000LL);
+    QCOMPARE(track.samples[4].value, QStringLiteral("12.40"));
+
+    // Not a track
+    QString badFileName = _tempDir->filePath(QStringLiteral("bad.csv"));
+    QFile badFile(badFileName);
+    QVERIFY(badFile.open(QIODevice::WriteOnly));
+    badFile.write("1,2,3\n");
+    badFile.close();
+    QVERIFY(!track.load(badFileName, errorString));
+}
+
+void TelemetryTrackTest::_fallbackClockTest(void)
+{
+    QString                 fileName = _tempDir->filePath(QStringLiteral("fallback.telemetry.csv"));
+    TelemetryTrackWriter    writer;
+
+    // Receiver which has not started recording yet
+    writer.start(fileName, { _voltageFact }, []() { return -1LL; });
+    QTest::qWait(10);
+    _voltageFact->setRawValue(11.0);
+    QSignalSpy completeSpy(&writer, &TelemetryTrackWriter::trackComplete);
+    writer.stop();
+    QVERIFY(completeSpy.wait(5000));
+
+    TelemetryTrack  track;
+    QString         errorString;
+    QVERIFY(track.load(fileName, errorString));
+    QCOMPARE(track.samples.count(), 2);
+    QVERIFY(track.samples[0].timeNsecs >= 0);
+    QVERIFY(track.samples[1].timeNsecs >= 10000000);
+    QVERIFY(track.endNsecs >= track.samples[1].timeNsecs);
+}
+
+void TelemetryTrackTest::_subtitleTest(void)
+{
+    QString trackFileName       = _tempDir->filePath(QStringLiteral("test.telemetry.csv"));
+    QString subtitleFileName    = _tempDir->filePath(QStringLiteral("test.ass"));
+    _writeTrack(trackFileName);
+
+    QString errorString;
+    QVERIFY2(SubtitleWriter::generateSubtitles(trackFileName, subtitleFileName, 500, errorString), qPrintable(errorString));
+
+    QFile subtitleFile(subtitleFileName);
+    QVERIFY(subtitleFile.open(QIODevice::ReadOnly | QIODevice::Text));
+    QStringList lines = QString::fromUtf8(subtitleFile.readAll()).split('\n');
+    QVERIFY(lines[0] == QStringLiteral("[Script Info]"));
+
+    // 2.2 seconds in 0.5 second entries, 3 name columns + 3 value columns + date for each
+    QStringList dialogueLines = lines.filter(QStringLiteral("Dialogue:"));
+    QCOMPARE(dialogueLines.count(), 5 * 7);
+
+    // Values are as of the start of each entry
+    QCOMPARE(dialogueLines.filter(QStringLiteral("0:00:00.0,0:00:00.5")).filter(QStringLiteral("0.00 V")).count(), 1);
+    QCOMPARE(dialogueLines.filter(QStringLiteral("0:00:00.5,0:00:01.0")).filter(QStringLiteral("12.50 V")).count(), 1);
+    QCOMPARE(dialogueLines.filter(QStringLiteral("0:00:01.5,0:00:02.0")).filter(QStringLiteral("12.40 V")).count(), 1);
+    QCOMPARE(dialogueLines.filter(QStringLiteral("0:00:02.0,0:00:02.5")).filter(QStringLiteral("Hold, \"pos\"")).count(), 1);
+}
@@ -0,0 +1,38 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QTemporaryDir>
+
+class Fact;
+
+/// Tests TelemetryTrackWriter and subtitle generation using a synthetic pipeline clock
+class TelemetryTrackTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init               (void);
+    void cleanup            (void);
+
+    void _csvTest           (void);
+    void _writeReadTest     (void);
+    void _fallbackClockTest (void);
+    void _subtitleTest      (void);
+
+private:
+    void _writeTrack(const QString& fileName);
+
+    QTemporaryDir*  _tempDir        = nullptr;
+    Fact*           _voltageFact    = nullptr;
+    Fact*           _modeFact       = nullptr;
+};
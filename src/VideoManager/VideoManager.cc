@@ -65,22 +65,11 @@ VideoManager::VideoManager(QGCApplication* app, QGCToolbox* toolbox)
 //-----------------------------------------------------------------------------
 VideoManager::~VideoManager()
 {
-    for (int i = 0; i < 2; i++) {
-        if (_videoReceiver[i] != nullptr) {
-            delete _videoReceiver[i];
-            _videoReceiver[i] = nullptr;
-        }
-#if defined(QGC_GST_STREAMING)
-        if (_videoSink[i] != nullptr) {
-            // FIXME: AV: we need some interaface for video sink with .release() call
-            // Currently VideoManager is destroyed after corePlugin() and we are crashing on app exit
-            // calling qgcApp()->toolbox()->corePlugin()->releaseVideoSink(_videoSink[i]);
-            // As for now let's call GStreamer::releaseVideoSink() directly
-            GStreamer::releaseVideoSink(_videoSink[i]);
-            _videoSink[i] = nullptr;
-        }
-#endif
-    }
+    // Telemetry capture uses the receiver clock
+    _subtitleWriter.stopCapturingTelemetry();
+
+    // Streams release their receiver and video sink
+    _streams.clearAndDeleteContents();
 }
 
 //-----------------------------------------------------------------------------
@@ -91,6 +80,7 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
    QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
    qmlRegisterUncreatableType<VideoManager> ("QGroundControl.VideoManager", 1, 0, "VideoManager", "Reference only");
    qmlRegisterUncreatableType<VideoReceiver>("QGroundControl",              1, 0, "VideoReceiver","Reference only");
+   qmlRegisterUncreatableType<VideoStream>  ("QGroundControl.VideoManager", 1, 0, "VideoStream",  "Reference only");
 
    // TODO: Those connections should be Per Video, not per VideoManager.
    _videoSettings = toolbox->settingsManager()->videoSettings();
@@ -114,90 +104,27 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
     emit isGStreamerChanged();
     qCDebug(VideoManagerLog) << "New Video Source:" << videoSource;
 #if defined(QGC_GST_STREAMING)
-    _videoReceiver[0] = toolbox->corePlugin()->createVideoReceiver(this);
-    _videoReceiver[1] = toolbox->corePlugin()->createVideoReceiver(this);
+    VideoStream* primaryStream = _createStream();
+    _createStream();
 
-    connect(_videoReceiver[0], &VideoReceiver::streamingChanged, this, [this](bool active){
-        _streaming = active;
-        emit streamingChanged();
-    });
+    connect(primaryStream, &VideoStream::streamingChanged,  this, &VideoManager::streamingChanged);
+    connect(primaryStream, &VideoStream::decodingChanged,   this, &VideoManager::decodingChanged);
+    connect(primaryStream, &VideoStream::videoSizeChanged,  this, &VideoManager::videoSizeChanged);
 
-    connect(_videoReceiver[0], &VideoReceiver::onStartComplete, this, [this](VideoReceiver::STATUS status) {
-        if (status == VideoReceiver::STATUS_OK) {
-            _videoStarted[0] = true;
-            if (_videoSink[0] != nullptr) {
-                // It is absolytely ok to have video receiver active (streaming) and decoding not active
-                // It should be handy for cases when you have many streams and want to show only some of them
-                // NOTE that even if decoder did not start it is still possible to record video
-                _videoReceiver[0]->startDecoding(_videoSink[0]);
-            }
-        } else if (status == VideoReceiver::STATUS_INVALID_URL) {
-            // Invalid URL - don't restart
-        } else if (status == VideoReceiver::STATUS_INVALID_STATE) {
-            // Already running
-        } else {
-            _restartVideo(0);
-        }
-    });
-
-    connect(_videoReceiver[0], &VideoReceiver::onStopComplete, this, [this](VideoReceiver::STATUS) {
-        _videoStarted[0] = false;
-        _startReceiver(0);
-    });
-
-    connect(_videoReceiver[0], &VideoReceiver::decodingChanged, this, [this](bool active){
-        _decoding = active;
-        emit decodingChanged();
-    });
-
-    connect(_videoReceiver[0], &VideoReceiver::recordingChanged, this, [this](bool active){
-        _recording = active;
+    connect(primaryStream, &VideoStream::recordingChanged, this, [this](bool active){
         if (!active) {
             _subtitleWriter.stopCapturingTelemetry();
         }
         emit recordingChanged();
     });
 
-    connect(_videoReceiver[0], &VideoReceiver::recordingStarted, this, [this](){
-        _subtitleWriter.startCapturingTelemetry(_videoFile);
-    });
-
-    connect(_videoReceiver[0], &VideoReceiver::videoSizeChanged, this, [this](QSize size){
-        _videoSize = ((quint32)size.width() << 16) | (quint32)size.height();
-        emit videoSizeChanged();
+    connect(primaryStream, &VideoStream::recordingStarted, this, [this, primaryStream](){
+        VideoReceiver* videoReceiver = primaryStream->receiver();
+        _subtitleWriter.startCapturingTelemetry(_videoFile, [videoReceiver]() { return videoReceiver->recordingTimeNsecs(); });
     });
-
-    //connect(_videoReceiver, &VideoReceiver::onTakeScreenshotComplete, this, [this](VideoReceiver::STATUS status){
-    //    if (status == VideoReceiver::STATUS_OK) {
-    //    }
-    //});
-
-    // FIXME: AV: I believe _thermalVideoReceiver should be handled just like _videoReceiver in terms of event
-    // and I expect that it will be changed during multiple video stream activity
-    if (_videoReceiver[1] != nullptr) {
-        connect(_videoReceiver[1], &VideoReceiver::onStartComplete, this, [this](VideoReceiver::STATUS status) {
-            if (status == VideoReceiver::STATUS_OK) {
-                _videoStarted[1] = true;
-                if (_videoSink[1] != nullptr) {
-                    _videoReceiver[1]->startDecoding(_videoSink[1]);
-                }
-            } else if (status == VideoReceiver::STATUS_INVALID_URL) {
-                // Invalid URL - don't restart
-            } else if (status == VideoReceiver::STATUS_INVALID_STATE) {
-                // Already running
-            } else {
-                _restartVideo(1);
-            }
-        });
-
-        connect(_videoReceiver[1], &VideoReceiver::onStopComplete, this, [this](VideoReceiver::STATUS) {
-            _videoStarted[1] = false;
-            _startReceiver(1);
-        });
-    }
 #endif
-    _updateSettings(0);
-    _updateSettings(1);
+    _updateSettings(kPrimaryStream);
+    _updateSettings(kThermalStream);
     if(isGStreamer()) {
         startVideo();
     } else {
@@ -261,8 +188,9 @@ VideoManager::startVideo()
         return;
     }
 
-    _startReceiver(0);
-    _startReceiver(1);
+    for (int i = 0; i < _streams.count(); i++) {
+        _startReceiver(i);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -273,8 +201,9 @@ VideoManager::stopVideo()
         return;
     }
 
-    _stopReceiver(1);
-    _stopReceiver(0);
+    for (int i = _streams.count() - 1; i >= 0; i--) {
+        _stopReceiver(i);
+    }
 }
 
 void
@@ -284,7 +213,7 @@ VideoManager::startRecording(const QString& videoFile)
         return;
     }
 #if defined(QGC_GST_STREAMING)
-    if (!_videoReceiver[0]) {
+    if (!_receiver(kPrimaryStream)) {
         qgcApp()->showAppMessage(tr("Video receiver is not ready."));
         return;
     }
@@ -307,17 +236,17 @@ VideoManager::startRecording(const QString& videoFile)
         return;
     }
 
-    _videoFile = savePath + "/"
+    const QString baseName = savePath + "/"
             + (videoFile.isEmpty() ? QDateTime::currentDateTime().toString("yyyy-MM-dd_hh.mm.ss") : videoFile)
             + ".";
-    QString videoFile2 = _videoFile + "2." + ext;
-    _videoFile += ext;
+    _videoFile = baseName + ext;
 
-    if (_videoReceiver[0] && _videoStarted[0]) {
-        _videoReceiver[0]->startRecording(_videoFile, fileFormat);
-    }
-    if (_videoReceiver[1] && _videoStarted[1]) {
-        _videoReceiver[1]->startRecording(videoFile2, fileFormat);
+    // Additional streams are recorded next to the primary one as <name>.2.<ext>, <name>.3.<ext>, ...
+    for (int i = 0; i < _streams.count(); i++) {
+        const QString streamFile = i == kPrimaryStream ? _videoFile : QStringLiteral("%1%2.%3").arg(baseName).arg(i + 1).arg(ext);
+        if (_stream(i)->startRecording(streamFile, fileFormat)) {
+            qCDebug(VideoManagerLog) << "Recording stream" << i << streamFile;
+        }
     }
 
 #else
@@ -333,10 +262,8 @@ VideoManager::stopRecording()
     }
 #if defined(QGC_GST_STREAMING)
 
-    for (int i = 0; i < 2; i++) {
-        if (_videoReceiver[i]) {
-            _videoReceiver[i]->stopRecording();
-        }
+    for (int i = 0; i < _streams.count(); i++) {
+        _stream(i)->stopRecording();
     }
 #endif
 }
@@ -348,7 +275,7 @@ VideoManager::grabImage(const QString& imageFile)
         return;
     }
 #if defined(QGC_GST_STREAMING)
-    if (!_videoReceiver[0]) {
+    if (!_receiver(kPrimaryStream)) {
         return;
     }
 
@@ -361,7 +288,7 @@ VideoManager::grabImage(const QString& imageFile)
 
     emit imageFileChanged();
 
-    _videoReceiver[0]->takeScreenshot(_imageFile);
+    _receiver(kPrimaryStream)->takeScreenshot(_imageFile);
 #else
     Q_UNUSED(imageFile)
 #endif
@@ -577,100 +504,119 @@ VideoManager::_initVideo()
 
     QQuickItem* widget = root->findChild<QQuickItem*>("videoContent");
 
-    if (widget != nullptr && _videoReceiver[0] != nullptr) {
-        _videoSink[0] = qgcApp()->toolbox()->corePlugin()->createVideoSink(this, widget);
-        if (_videoSink[0] != nullptr) {
-            if (_videoStarted[0]) {
-                _videoReceiver[0]->startDecoding(_videoSink[0]);
-            }
-        } else {
-            qCDebug(VideoManagerLog) << "createVideoSink() failed";
-        }
+    if (widget != nullptr && _receiver(kPrimaryStream) != nullptr) {
+        setVideoItem(kPrimaryStream, widget);
     } else {
         qCDebug(VideoManagerLog) << "video receiver disabled";
     }
 
     widget = root->findChild<QQuickItem*>("thermalVideo");
 
-    if (widget != nullptr && _videoReceiver[1] != nullptr) {
-        _videoSink[1] = qgcApp()->toolbox()->corePlugin()->createVideoSink(this, widget);
-        if (_videoSink[1] != nullptr) {
-            if (_videoStarted[1]) {
-                _videoReceiver[1]->startDecoding(_videoSink[1]);
-            }
-        } else {
-            qCDebug(VideoManagerLog) << "createVideoSink() failed";
-        }
+    if (widget != nullptr && _receiver(kThermalStream) != nullptr) {
+        setVideoItem(kThermalStream, widget);
     } else {
         qCDebug(VideoManagerLog) << "thermal video receiver disabled";
     }
 #endif
 }
 
+//-----------------------------------------------------------------------------
+void
+VideoManager::setVideoItem(int index, QQuickItem* videoItem)
+{
+#if defined(QGC_GST_STREAMING)
+    VideoStream* stream = _stream(index);
+
+    if (stream == nullptr || videoItem == nullptr) {
+        qCDebug(VideoManagerLog) << "setVideoItem: invalid stream or item" << index;
+        return;
+    }
+
+    void* videoSink = qgcApp()->toolbox()->corePlugin()->createVideoSink(this, videoItem);
+    if (videoSink != nullptr) {
+        stream->setVideoSink(videoSink);
+    } else {
+        qCDebug(VideoManagerLog) << "createVideoSink() failed" << index;
+    }
+#else
+    Q_UNUSED(index)
+    Q_UNUSED(videoItem)
+#endif
+}
+
+//-----------------------------------------------------------------------------
+QString
+VideoManager::_streamInfoUri(QGCVideoStreamInfo* pInfo)
+{
+    switch(pInfo->type()) {
+        case VIDEO_STREAM_TYPE_RTPUDP:
+            return QStringLiteral("udp://0.0.0.0:%1").arg(pInfo->uri());
+        case VIDEO_STREAM_TYPE_MPEG_TS_H264:
+            return QStringLiteral("mpegts://0.0.0.0:%1").arg(pInfo->uri());
+        case VIDEO_STREAM_TYPE_RTSP:
+        case VIDEO_STREAM_TYPE_TCP_MPEG:
+        default:
+            return pInfo->uri();
+    }
+}
+
 //-----------------------------------------------------------------------------
 bool
-VideoManager::_updateSettings(unsigned id)
+VideoManager::_updateSettings(int index)
 {
-    if(!_videoSettings)
+    VideoStream* stream = _stream(index);
+
+    if(!_videoSettings || !stream)
         return false;
 
     const bool lowLatencyStreaming  =_videoSettings->lowLatencyMode()->rawValue().toBool();
 
-    bool settingsChanged = _lowLatencyStreaming[id] != lowLatencyStreaming;
-
-    _lowLatencyStreaming[id] = lowLatencyStreaming;
+    bool settingsChanged = stream->setUri(stream->uri(), lowLatencyStreaming);
 
     //-- Auto discovery
 
     if(_activeVehicle && _activeVehicle->cameraManager()) {
         QGCVideoStreamInfo* pInfo = _activeVehicle->cameraManager()->currentStreamInstance();
         if(pInfo) {
-            if (id == 0) {
+            if (index == kPrimaryStream) {
                 qCDebug(VideoManagerLog) << "Configure primary stream:" << pInfo->uri();
                 switch(pInfo->type()) {
                     case VIDEO_STREAM_TYPE_RTSP:
-                        if ((settingsChanged |= _updateVideoUri(id, pInfo->uri()))) {
+                        if ((settingsChanged |= _updateVideoUri(index, pInfo->uri()))) {
                             _toolbox->settingsManager()->videoSettings()->videoSource()->setRawValue(VideoSettings::videoSourceRTSP);
                         }
                         break;
                     case VIDEO_STREAM_TYPE_TCP_MPEG:
-                        if ((settingsChanged |= _updateVideoUri(id, pInfo->uri()))) {
+                        if ((settingsChanged |= _updateVideoUri(index, pInfo->uri()))) {
                             _toolbox->settingsManager()->videoSettings()->videoSource()->setRawValue(VideoSettings::videoSourceTCP);
                         }
                         break;
                     case VIDEO_STREAM_TYPE_RTPUDP:
-                        if ((settingsChanged |= _updateVideoUri(id, QStringLiteral("udp://0.0.0.0:%1").arg(pInfo->uri())))) {
+                        if ((settingsChanged |= _updateVideoUri(index, QStringLiteral("udp://0.0.0.0:%1").arg(pInfo->uri())))) {
                             _toolbox->settingsManager()->videoSettings()->videoSource()->setRawValue(VideoSettings::videoSourceUDPH264);
                         }
                         break;
                     case VIDEO_STREAM_TYPE_MPEG_TS_H264:
-                        if ((settingsChanged |= _updateVideoUri(id, QStringLiteral("mpegts://0.0.0.0:%1").arg(pInfo->uri())))) {
+                        if ((settingsChanged |= _updateVideoUri(index, QStringLiteral("mpegts://0.0.0.0:%1").arg(pInfo->uri())))) {
                             _toolbox->settingsManager()->videoSettings()->videoSource()->setRawValue(VideoSettings::videoSourceMPEGTS);
                         }
                         break;
                     default:
-                        settingsChanged |= _updateVideoUri(id, pInfo->uri());
+                        settingsChanged |= _updateVideoUri(index, pInfo->uri());
                         break;
                 }
-            }
-            else if (id == 1) { //-- Thermal stream (if any)
+            } else if (index == kThermalStream) { //-- Thermal stream (if any)
                 QGCVideoStreamInfo* pTinfo = _activeVehicle->cameraManager()->thermalStreamInstance();
                 if (pTinfo) {
                     qCDebug(VideoManagerLog) << "Configure secondary stream:" << pTinfo->uri();
-                    switch(pTinfo->type()) {
-                        case VIDEO_STREAM_TYPE_RTSP:
-                        case VIDEO_STREAM_TYPE_TCP_MPEG:
-                            settingsChanged |= _updateVideoUri(id, pTinfo->uri());
-                            break;
-                        case VIDEO_STREAM_TYPE_RTPUDP:
-                            settingsChanged |= _updateVideoUri(id, QStringLiteral("udp://0.0.0.0:%1").arg(pTinfo->uri()));
-                            break;
-                        case VIDEO_STREAM_TYPE_MPEG_TS_H264:
-                            settingsChanged |= _updateVideoUri(id, QStringLiteral("mpegts://0.0.0.0:%1").arg(pTinfo->uri()));
-                            break;
-                        default:
-                            settingsChanged |= _updateVideoUri(id, pTinfo->uri());
-                            break;
+                    settingsChanged |= _updateVideoUri(index, _streamInfoUri(pTinfo));
+                }
+            } else {
+                for (QGCVideoStreamInfo* pAinfo: _additionalStreamInfos()) {
+                    if (pAinfo->streamID() == stream->streamID()) {
+                        qCDebug(VideoManagerLog) << "Configure additional stream" << index << ":" << pAinfo->uri();
+                        settingsChanged |= _updateVideoUri(index, _streamInfoUri(pAinfo));
+                        break;
                     }
                 }
             }
@@ -679,80 +625,72 @@ VideoManager::_updateSettings(unsigned id)
     }
     QString source = _videoSettings->videoSource()->rawValue().toString();
     if (source == VideoSettings::videoSourceUDPH264)
-        settingsChanged |= _updateVideoUri(0, QStringLiteral("udp://0.0.0.0:%1").arg(_videoSettings->udpPort()->rawValue().toInt()));
+        settingsChanged |= _updateVideoUri(kPrimaryStream, QStringLiteral("udp://0.0.0.0:%1").arg(_videoSettings->udpPort()->rawValue().toInt()));
     else if (source == VideoSettings::videoSourceUDPH265)
-        settingsChanged |= _updateVideoUri(0, QStringLiteral("udp265://0.0.0.0:%1").arg(_videoSettings->udpPort()->rawValue().toInt()));
+        settingsChanged |= _updateVideoUri(kPrimaryStream, QStringLiteral("udp265://0.0.0.0:%1").arg(_videoSettings->udpPort()->rawValue().toInt()));
     else if (source == VideoSettings::videoSourceMPEGTS)
-        settingsChanged |= _updateVideoUri(0, QStringLiteral("mpegts://0.0.0.0:%1").arg(_videoSettings->udpPort()->rawValue().toInt()));
+        settingsChanged |= _updateVideoUri(kPrimaryStream, QStringLiteral("mpegts://0.0.0.0:%1").arg(_videoSettings->udpPort()->rawValue().toInt()));
     else if (source == VideoSettings::videoSourceRTSP)
-        settingsChanged |= _updateVideoUri(0, _videoSettings->rtspUrl()->rawValue().toString());
+        settingsChanged |= _updateVideoUri(kPrimaryStream, _videoSettings->rtspUrl()->rawValue().toString());
     else if (source == VideoSettings::videoSourceTCP)
-        settingsChanged |= _updateVideoUri(0, QStringLiteral("tcp://%1").arg(_videoSettings->tcpUrl()->rawValue().toString()));
+        settingsChanged |= _updateVideoUri(kPrimaryStream, QStringLiteral("tcp://%1").arg(_videoSettings->tcpUrl()->rawValue().toString()));
     else if (source == VideoSettings::videoSource3DRSolo)
-        settingsChanged |= _updateVideoUri(0, QStringLiteral("udp://0.0.0.0:5600"));
+        settingsChanged |= _updateVideoUri(kPrimaryStream, QStringLiteral("udp://0.0.0.0:5600"));
     else if (source == VideoSettings::videoSourceParrotDiscovery)
-        settingsChanged |= _updateVideoUri(0, QStringLiteral("udp://0.0.0.0:8888"));
+        settingsChanged |= _updateVideoUri(kPrimaryStream, QStringLiteral("udp://0.0.0.0:8888"));
 
     return settingsChanged;
 }
 
 //-----------------------------------------------------------------------------
 bool
-VideoManager::_updateVideoUri(unsigned id, const QString& uri)
+VideoManager::_updateVideoUri(int index, const QString& uri)
 {
+    VideoStream* stream = _stream(index);
+
+    if (!stream) {
+        return false;
+    }
+
 #if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__android__) || defined(__ios__))
-    //-- Taisync on iOS or Android sends a raw h.264 stream
+    //-- Taisync on iOS or Android sends a raw h.264 stream over TCP which is received directly by the pipeline
     if (isTaisync()) {
-        if (id == 0) {
-            return _updateVideoUri(0, QString("tsusb://0.0.0.0:%1").arg(TAISYNC_VIDEO_UDP_PORT));
-        } if (id == 1) {
-            // FIXME: AV: TAISYNC_VIDEO_UDP_PORT is used by video stream, thermal stream should go via its own proxy
-            if (!_videoUri[1].isEmpty()) {
-                _videoUri[1].clear();
-                return true;
-            } else {
-                return false;
-            }
+        if (index == kPrimaryStream) {
+            return stream->setUri(QString("taisync://0.0.0.0:%1").arg(TAISYNC_VIDEO_TCP_PORT), stream->lowLatency());
+        } else {
+            // FIXME: AV: Taisync only provides a single video stream
+            return stream->setUri(QString(), stream->lowLatency());
         }
     }
 #endif
-    if (uri == _videoUri[id]) {
-        return false;
-    }
 
-    _videoUri[id] = uri;
-
-    return true;
+    return stream->setUri(uri, stream->lowLatency());
 }
 
 //-----------------------------------------------------------------------------
 void
-VideoManager::_restartVideo(unsigned id)
+VideoManager::_restartVideo(int index)
 {
     if (qgcApp()->runningUnitTests()) {
         return;
     }
 
 #if defined(QGC_GST_STREAMING)
-    bool oldLowLatencyStreaming = _lowLatencyStreaming[id];
-    QString oldUri = _videoUri[id];
-    _updateSettings(id);
-    bool newLowLatencyStreaming = _lowLatencyStreaming[id];
-    QString newUri = _videoUri[id];
-
-    // FIXME: AV: use _updateSettings() result to check if settings were changed
-    if (oldUri == newUri && oldLowLatencyStreaming == newLowLatencyStreaming && _videoStarted[id]) {
-        qCDebug(VideoManagerLog) << "No sense to restart video streaming, skipped"  << id;
+    VideoStream* stream = _stream(index);
+
+    if (!stream) {
+        qCDebug(VideoManagerLog) << "Unsupported stream index" << index;
         return;
     }
 
-    qCDebug(VideoManagerLog) << "Restart video streaming"  << id;
-
-    if (_videoStarted[id]) {
-        _stopReceiver(id);
-    } else {
-        _startReceiver(id);
+    if (!_updateSettings(index) && stream->started()) {
+        qCDebug(VideoManagerLog) << "No sense to restart video streaming, skipped"  << index;
+        return;
     }
+
+    qCDebug(VideoManagerLog) << "Restart video streaming"  << index;
+
+    stream->restart(_videoSettings->rtspTimeout()->rawValue().toUInt());
 #endif
 }
 
@@ -760,40 +698,182 @@ VideoManager::_restartVideo(unsigned id)
 void
 VideoManager::_restartAllVideos()
 {
-    _restartVideo(0);
-    _restartVideo(1);
+    for (int i = 0; i < _streams.count(); i++) {
+        _restartVideo(i);
+    }
 }
 
 //----------------------------------------------------------------------------------------
 void
-VideoManager::_startReceiver(unsigned id)
+VideoManager::_startReceiver(int index)
 {
 #if defined(QGC_GST_STREAMING)
-    const unsigned timeout = _videoSettings->rtspTimeout()->rawValue().toUInt();
+    VideoStream* stream = _stream(index);
 
-    if (id > 1) {
-        qCDebug(VideoManagerLog) << "Unsupported receiver id" << id;
-    } else if (_videoReceiver[id] != nullptr/* && _videoSink[id] != nullptr*/) {
-        if (!_videoUri[id].isEmpty()) {
-            _videoReceiver[id]->start(_videoUri[id], timeout, _lowLatencyStreaming[id] ? -1 : 0);
-        }
+    if (!stream) {
+        qCDebug(VideoManagerLog) << "Unsupported stream index" << index;
+    } else {
+        stream->start(_videoSettings->rtspTimeout()->rawValue().toUInt());
     }
+#else
+    Q_UNUSED(index)
 #endif
 }
 
 //----------------------------------------------------------------------------------------
 void
-VideoManager::_stopReceiver(unsigned id)
+VideoManager::_stopReceiver(int index)
 {
 #if defined(QGC_GST_STREAMING)
-    if (id > 1) {
-        qCDebug(VideoManagerLog) << "Unsupported receiver id" << id;
-    } else if (_videoReceiver[id] != nullptr) {
-        _videoReceiver[id]->stop();
+    VideoStream* stream = _stream(index);
+
+    if (!stream) {
+        qCDebug(VideoManagerLog) << "Unsupported stream index" << index;
+    } else {
+        stream->stop();
     }
+#else
+    Q_UNUSED(index)
 #endif
 }
 
+//----------------------------------------------------------------------------------------
+VideoStream*
+VideoManager::_createStream()
+{
+    VideoStream* stream = new VideoStream(_toolbox->corePlugin()->createVideoReceiver(nullptr), this);
+
+    connect(stream, &VideoStream::restartRequested, this, [this, stream]() {
+        _restartVideo(_streams.indexOf(stream));
+    });
+
+    _streams.append(stream);
+
+    return stream;
+}
+
+//----------------------------------------------------------------------------------------
+VideoStream*
+VideoManager::_stream(int index)
+{
+    if (index < 0 || index >= _streams.count()) {
+        return nullptr;
+    }
+    return _streams.value<VideoStream*>(index);
+}
+
+//----------------------------------------------------------------------------------------
+VideoReceiver*
+VideoManager::_receiver(int index)
+{
+    VideoStream* stream = _stream(index);
+    return stream ? stream->receiver() : nullptr;
+}
+
+//----------------------------------------------------------------------------------------
+QGCCameraControl*
+VideoManager::_currentCamera()
+{
+    if(_activeVehicle && _activeVehicle->cameraManager()) {
+        return _activeVehicle->cameraManager()->currentCameraInstance();
+    }
+    return nullptr;
+}
+
+//----------------------------------------------------------------------------------------
+QList<QGCVideoStreamInfo*>
+VideoManager::_additionalStreamInfos()
+{
+    QList<QGCVideoStreamInfo*> infos;
+
+    QGCCameraControl* pCamera = _currentCamera();
+    if(!pCamera) {
+        return infos;
+    }
+
+    // The current and thermal streams already have their fixed slots
+    QGCVideoStreamInfo* pCurrent = pCamera->currentStreamInstance();
+    QGCVideoStreamInfo* pThermal = pCamera->thermalStreamInstance();
+
+    QmlObjectListModel* streams = pCamera->streams();
+    for(int i = 0; i < streams->count(); i++) {
+        QGCVideoStreamInfo* pInfo = streams->value<QGCVideoStreamInfo*>(i);
+        if(pInfo && pInfo != pCurrent && pInfo != pThermal && !pInfo->uri().isEmpty()) {
+            infos.append(pInfo);
+        }
+    }
+
+    return infos;
+}
+
+//----------------------------------------------------------------------------------------
+void
+VideoManager::_updateStreams()
+{
+#if defined(QGC_GST_STREAMING)
+    if (_streams.count() < kThermalStream + 1) {
+        // Video not supported or not initialized yet
+        return;
+    }
+
+    const QList<QGCVideoStreamInfo*> infos = _additionalStreamInfos();
+
+    // Drop the streams the camera no longer advertises
+    for (int i = _streams.count() - 1; i > kThermalStream; i--) {
+        VideoStream* stream = _stream(i);
+        bool found = false;
+        for (QGCVideoStreamInfo* pInfo: infos) {
+            if (pInfo->streamID() == stream->streamID()) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            qCDebug(VideoManagerLog) << "Removing stream" << i << stream->streamID() << stream->name();
+            _streams.removeAt(i);
+            stream->release();
+        }
+    }
+
+    // Add the ones we don't have yet
+    for (QGCVideoStreamInfo* pInfo: infos) {
+        bool found = false;
+        for (int i = kThermalStream + 1; i < _streams.count(); i++) {
+            if (_stream(i)->streamID() == pInfo->streamID()) {
+                _stream(i)->setStreamInfo(pInfo->streamID(), pInfo->name());
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            VideoStream* stream = _createStream();
+            stream->setStreamInfo(pInfo->streamID(), pInfo->name());
+            qCDebug(VideoManagerLog) << "Adding stream" << _streams.indexOf(stream) << pInfo->streamID() << pInfo->name();
+        }
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+void
+VideoManager::_cameraStreamsChanged()
+{
+    QGCCameraControl* pCamera = _currentCamera();
+
+    if (pCamera != _streamsCamera) {
+        if (_streamsCamera) {
+            disconnect(_streamsCamera, &QGCCameraControl::streamsChanged, this, &VideoManager::_cameraStreamsChanged);
+        }
+        _streamsCamera = pCamera;
+        if (_streamsCamera) {
+            connect(_streamsCamera, &QGCCameraControl::streamsChanged, this, &VideoManager::_cameraStreamsChanged);
+        }
+    }
+
+    _updateStreams();
+    _restartAllVideos();
+}
+
 //----------------------------------------------------------------------------------------
 void
 VideoManager::_setActiveVehicle(Vehicle* vehicle)
@@ -805,14 +885,14 @@ VideoManager::_setActiveVehicle(Vehicle* vehicle)
             if(pCamera) {
                 pCamera->stopStream();
             }
-            disconnect(_activeVehicle->cameraManager(), &QGCCameraManager::streamChanged, this, &VideoManager::_restartAllVideos);
+            disconnect(_activeVehicle->cameraManager(), &QGCCameraManager::streamChanged, this, &VideoManager::_cameraStreamsChanged);
         }
     }
     _activeVehicle = vehicle;
     if(_activeVehicle) {
         connect(_activeVehicle->vehicleLinkManager(), &VehicleLinkManager::communicationLostChanged, this, &VideoManager::_communicationLostChanged);
         if(_activeVehicle->cameraManager()) {
-            connect(_activeVehicle->cameraManager(), &QGCCameraManager::streamChanged, this, &VideoManager::_restartAllVideos);
+            connect(_activeVehicle->cameraManager(), &QGCCameraManager::streamChanged, this, &VideoManager::_cameraStreamsChanged);
             QGCCameraControl* pCamera = _activeVehicle->cameraManager()->currentCameraInstance();
             if(pCamera) {
                 pCamera->resumeStream();
@@ -823,7 +903,7 @@ VideoManager::_setActiveVehicle(Vehicle* vehicle)
         setfullScreen(false);
     }
     emit autoStreamConfiguredChanged();
-    _restartAllVideos();
+    _cameraStreamsChanged();
 }
 
 //----------------------------------------------------------------------------------------
@@ -12,6 +12,7 @@
 #define VideoManager_H
 
 #include <QObject>
+#include <QPointer>
 #include <QTimer>
 #include <QTime>
 #include <QUrl>
@@ -21,12 +22,17 @@
 #include "VideoReceiver.h"
 #include "QGCToolbox.h"
 #include "SubtitleWriter.h"
+#include "QmlObjectListModel.h"
+#include "VideoStream.h"
 
 Q_DECLARE_LOGGING_CATEGORY(VideoManagerLog)
 
 class VideoSettings;
 class Vehicle;
 class Joystick;
+class QGCVideoStreamInfo;
+class QGCCameraControl;
+class QQuickItem;
 
 class VideoManager : public QGCTool
 {
@@ -55,6 +61,7 @@ public:
     Q_PROPERTY(bool             decoding                READ    decoding                                    NOTIFY decodingChanged)
     Q_PROPERTY(bool             recording               READ    recording                                   NOTIFY recordingChanged)
     Q_PROPERTY(QSize            videoSize               READ    videoSize                                   NOTIFY videoSizeChanged)
+    Q_PROPERTY(QmlObjectListModel* streams              READ    streams                                     CONSTANT)
 
     virtual bool        hasVideo            ();
     virtual bool        isGStreamer         ();
@@ -70,26 +77,36 @@ public:
     virtual QString     imageFile           ();
 
     bool streaming(void) {
-        return _streaming;
+        VideoStream* stream = _stream(kPrimaryStream);
+        return stream && stream->streaming();
     }
 
     bool decoding(void) {
-        return _decoding;
+        VideoStream* stream = _stream(kPrimaryStream);
+        return stream && stream->decoding();
     }
 
     bool recording(void) {
-        return _recording;
+        VideoStream* stream = _stream(kPrimaryStream);
+        return stream && stream->recording();
     }
 
     QSize videoSize(void) {
-        const quint32 size = _videoSize;
-        return QSize((size >> 16) & 0xFFFF, size & 0xFFFF);
+        VideoStream* stream = _stream(kPrimaryStream);
+        return stream ? stream->videoSize() : QSize(0, 0);
     }
 
-// FIXME: AV: they should be removed after finishing multiple video stream support
-// new arcitecture does not assume direct access to video receiver from QML side, even if it works for now
-    virtual VideoReceiver*  videoReceiver           () { return _videoReceiver[0]; }
-    virtual VideoReceiver*  thermalVideoReceiver    () { return _videoReceiver[1]; }
+    /// All video streams. Index kPrimaryStream is the main stream and kThermalStream the thermal stream (if any). Any
+    /// further streams advertised by the current camera through VIDEO_STREAM_INFORMATION follow, those are created
+    /// and removed as the camera reports them.
+    QmlObjectListModel* streams(void) { return &_streams; }
+
+    // Kept for the QML video items, which bind to the receiver
+    virtual VideoReceiver*  videoReceiver           () { return _receiver(kPrimaryStream); }
+    virtual VideoReceiver*  thermalVideoReceiver    () { return _receiver(kThermalStream); }
+
+    static const int kPrimaryStream = 0;
+    static const int kThermalStream = 1;
 
 #if defined(QGC_DISABLE_UVC)
     virtual bool        uvcEnabled          () { return false; }
@@ -111,6 +128,10 @@ public:
 
     Q_INVOKABLE void grabImage(const QString& imageFile = QString());
 
+    /// Renders the specified stream into a QGCVideoBackground item. Needed for the additional camera streams, the
+    /// primary and thermal streams are connected to the "videoContent" and "thermalVideo" items automatically.
+    Q_INVOKABLE void setVideoItem(int index, QQuickItem* videoItem);
+
 signals:
     void hasVideoChanged            ();
     void isGStreamerChanged         ();
@@ -137,38 +158,35 @@ protected slots:
     void _setActiveVehicle          (Vehicle* vehicle);
     void _aspectRatioChanged        ();
     void _communicationLostChanged  (bool communicationLost);
+    void _cameraStreamsChanged      ();
 
 protected:
     friend class FinishVideoInitialization;
 
-    void _initVideo                 ();
-    bool _updateSettings            (unsigned id);
-    bool _updateVideoUri            (unsigned id, const QString& uri);
-    void _cleanupOldVideos          ();
-    void _restartAllVideos          ();
-    void _restartVideo              (unsigned id);
-    void _startReceiver             (unsigned id);
-    void _stopReceiver              (unsigned id);
+    void            _initVideo                  ();
+    bool            _updateSettings             (int index);
+    bool            _updateVideoUri             (int index, const QString& uri);
+    void            _cleanupOldVideos           ();
+    void            _restartAllVideos           ();
+    void            _restartVideo               (int index);
+    void            _startReceiver              (int index);
+    void            _stopReceiver               (int index);
+    VideoStream*    _createStream               ();
+    void            _updateStreams              ();
+    VideoStream*    _stream                     (int index);
+    VideoReceiver*  _receiver                   (int index);
+    QGCCameraControl*           _currentCamera          ();
+    QList<QGCVideoStreamInfo*>  _additionalStreamInfos  ();
+
+    static QString  _streamInfoUri              (QGCVideoStreamInfo* pInfo);
 
 protected:
     QString                 _videoFile;
     QString                 _imageFile;
     SubtitleWriter          _subtitleWriter;
     bool                    _isTaisync              = false;
-    VideoReceiver*          _videoReceiver[2]       = { nullptr, nullptr };
-    void*                   _videoSink[2]           = { nullptr, nullptr };
-    QString                 _videoUri[2];
-    // FIXME: AV: _videoStarted seems to be access from 3 different threads, from time to time
-    // 1) Video Receiver thread
-    // 2) Video Manager/main app thread
-    // 3) Qt rendering thread (during video sink creation process which should happen in this thread)
-    // It works for now but...
-    bool                    _videoStarted[2]        = { false, false };
-    bool                    _lowLatencyStreaming[2] = { false, false };
-    QAtomicInteger<bool>    _streaming              = false;
-    QAtomicInteger<bool>    _decoding               = false;
-    QAtomicInteger<bool>    _recording              = false;
-    QAtomicInteger<quint32> _videoSize              = 0;
+    QmlObjectListModel      _streams;
+    QPointer<QGCCameraControl> _streamsCamera;
     VideoSettings*          _videoSettings          = nullptr;
     QString                 _videoSourceID;
     bool                    _fullScreen             = false;
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VideoStream.h"
+
+#if defined(QGC_GST_STREAMING)
+#include "GStreamer.h"
+#endif
+
+QGC_LOGGING_CATEGORY(VideoStreamLog, "VideoStreamLog")
+
+//-----------------------------------------------------------------------------
+VideoStream::VideoStream(VideoReceiver* receiver, QObject* parent)
+    : QObject   (parent)
+    , _receiver (receiver)
+{
+    if (_receiver == nullptr) {
+        return;
+    }
+
+    _receiver->setParent(this);
+
+    connect(_receiver, &VideoReceiver::onStartComplete, this, &VideoStream::_onStartComplete);
+    connect(_receiver, &VideoReceiver::onStopComplete,  this, &VideoStream::_onStopComplete);
+
+    connect(_receiver, &VideoReceiver::streamingChanged, this, [this](bool active) {
+        _streaming = active;
+        emit streamingChanged(active);
+    });
+
+    connect(_receiver, &VideoReceiver::decodingChanged, this, [this](bool active) {
+        _decoding = active;
+        emit decodingChanged(active);
+    });
+
+    connect(_receiver, &VideoReceiver::recordingChanged, this, [this](bool active) {
+        _recording = active;
+        emit recordingChanged(active);
+    });
+
+    connect(_receiver, &VideoReceiver::recordingStarted, this, &VideoStream::recordingStarted);
+
+    connect(_receiver, &VideoReceiver::videoSizeChanged, this, [this](QSize size) {
+        _videoSize = ((quint32)size.width() << 16) | (quint32)size.height();
+        emit videoSizeChanged(size);
+    });
+}
+
+//-----------------------------------------------------------------------------
+VideoStream::~VideoStream()
+{
+    delete _receiver;
+    _receiver = nullptr;
+
+#if defined(QGC_GST_STREAMING)
+    if (_videoSink != nullptr) {
+        // See VideoManager::~VideoManager as to why corePlugin()->releaseVideoSink() is not used
+        GStreamer::releaseVideoSink(_videoSink);
+        _videoSink = nullptr;
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::setDecodingEnabled(bool enabled)
+{
+    if (enabled == _decodingEnabled) {
+        return;
+    }
+
+    _decodingEnabled = enabled;
+    emit decodingEnabledChanged(enabled);
+
+    if (_receiver && _started && _videoSink) {
+        if (enabled) {
+            _receiver->startDecoding(_videoSink);
+        } else {
+            _receiver->stopDecoding();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::setRecordingEnabled(bool enabled)
+{
+    if (enabled == _recordingEnabled) {
+        return;
+    }
+
+    _recordingEnabled = enabled;
+    emit recordingEnabledChanged(enabled);
+
+    if (!enabled && _recording) {
+        stopRecording();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::setStreamInfo(int streamID, const QString& name)
+{
+    if (streamID != _streamID || name != _name) {
+        _streamID   = streamID;
+        _name       = name;
+        emit streamInfoChanged();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+VideoStream::setUri(const QString& uri, bool lowLatency)
+{
+    bool changed = false;
+
+    if (lowLatency != _lowLatency) {
+        _lowLatency = lowLatency;
+        changed = true;
+    }
+
+    if (uri != _uri) {
+        _uri = uri;
+        emit uriChanged();
+        changed = true;
+    }
+
+    return changed;
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::setVideoSink(void* videoSink)
+{
+#if defined(QGC_GST_STREAMING)
+    if (_videoSink != nullptr && _videoSink != videoSink) {
+        GStreamer::releaseVideoSink(_videoSink);
+    }
+#endif
+    _videoSink = videoSink;
+
+    if (_receiver && _videoSink && _started && _decodingEnabled) {
+        _receiver->startDecoding(_videoSink);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::start(unsigned timeout)
+{
+    _timeout = timeout;
+
+    if (_receiver && !_uri.isEmpty() && !_releasing) {
+        qCDebug(VideoStreamLog) << "Start" << _streamID << _uri;
+        _startRequested = true;
+        _receiver->start(_uri, timeout, _lowLatency ? -1 : 0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::stop(void)
+{
+    if (_receiver) {
+        _receiver->stop();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::restart(unsigned timeout)
+{
+    _timeout = timeout;
+
+    // The receiver is started again once it reports the stop as complete
+    if (_started) {
+        stop();
+    } else {
+        start(timeout);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::release(void)
+{
+    _releasing = true;
+
+    if (_receiver && _startRequested) {
+        // Stop is queued behind any pending start, so the pipeline is always torn down before the receiver goes away
+        _receiver->stop();
+    } else {
+        deleteLater();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+VideoStream::startRecording(const QString& videoFile, VideoReceiver::FILE_FORMAT format)
+{
+    if (!_receiver || !_started || !_recordingEnabled) {
+        return false;
+    }
+
+    _receiver->startRecording(videoFile, format);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::stopRecording(void)
+{
+    if (_receiver) {
+        _receiver->stopRecording();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+VideoStream::takeScreenshot(const QString& imageFile)
+{
+    if (!_receiver || !_started) {
+        return false;
+    }
+
+    _receiver->takeScreenshot(imageFile);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::_onStartComplete(VideoReceiver::STATUS status)
+{
+    if (status == VideoReceiver::STATUS_OK) {
+        _started = true;
+        if (_videoSink != nullptr && _decodingEnabled) {
+            // It is absolutely ok to have video receiver active (streaming) and decoding not active
+            // It should be handy for cases when you have many streams and want to show only some of them
+            // NOTE that even if decoder did not start it is still possible to record video
+            _receiver->startDecoding(_videoSink);
+        }
+    } else if (status == VideoReceiver::STATUS_INVALID_URL) {
+        // Invalid URL - don't restart
+    } else if (status == VideoReceiver::STATUS_INVALID_STATE) {
+        // Already running
+    } else if (!_releasing) {
+        emit restartRequested();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoStream::_onStopComplete(VideoReceiver::STATUS status)
+{
+    Q_UNUSED(status)
+
+    _started = false;
+
+    if (_releasing) {
+        deleteLater();
+    } else {
+        start(_timeout);
+    }
+}
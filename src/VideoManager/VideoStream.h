@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QSize>
+
+#include "QGCLoggingCategory.h"
+#include "VideoReceiver.h"
+
+Q_DECLARE_LOGGING_CATEGORY(VideoStreamLog)
+
+/// A single video stream shown and/or recorded by VideoManager. Owns the receiver and video sink for the stream and
+/// tracks receiver state such that any number of streams can be handled the same way.
+class VideoStream : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param receiver Receiver for this stream, ownership is transferred. May be nullptr if video is not supported.
+    VideoStream(VideoReceiver* receiver, QObject* parent = nullptr);
+    ~VideoStream();
+
+    Q_PROPERTY(int              streamID            READ streamID                                       NOTIFY streamInfoChanged)
+    Q_PROPERTY(QString          name                READ name                                           NOTIFY streamInfoChanged)
+    Q_PROPERTY(QString          uri                 READ uri                                            NOTIFY uriChanged)
+    Q_PROPERTY(VideoReceiver*   receiver            READ receiver                                       CONSTANT)
+    Q_PROPERTY(bool             decodingEnabled     READ decodingEnabled    WRITE setDecodingEnabled    NOTIFY decodingEnabledChanged)
+    Q_PROPERTY(bool             recordingEnabled    READ recordingEnabled   WRITE setRecordingEnabled   NOTIFY recordingEnabledChanged)
+    Q_PROPERTY(bool             streaming           READ streaming                                      NOTIFY streamingChanged)
+    Q_PROPERTY(bool             decoding            READ decoding                                       NOTIFY decodingChanged)
+    Q_PROPERTY(bool             recording           READ recording                                      NOTIFY recordingChanged)
+    Q_PROPERTY(QSize            videoSize           READ videoSize                                      NOTIFY videoSizeChanged)
+
+    int             streamID            (void) const { return _streamID; }
+    QString         name                (void) const { return _name; }
+    QString         uri                 (void) const { return _uri; }
+    VideoReceiver*  receiver            (void) { return _receiver; }
+    bool            decodingEnabled     (void) const { return _decodingEnabled; }
+    bool            recordingEnabled    (void) const { return _recordingEnabled; }
+    bool            streaming           (void) const { return _streaming; }
+    bool            decoding            (void) const { return _decoding; }
+    bool            recording           (void) const { return _recording; }
+    bool            started             (void) const { return _started; }
+    bool            lowLatency          (void) const { return _lowLatency; }
+    void*           videoSink           (void) { return _videoSink; }
+
+    QSize videoSize(void) const {
+        const quint32 size = _videoSize;
+        return QSize((size >> 16) & 0xFFFF, size & 0xFFFF);
+    }
+
+    /// Decoding can be turned off to save cpu for streams which are not currently shown. Recording still works.
+    void setDecodingEnabled     (bool enabled);
+
+    /// Streams which are not enabled for recording are skipped by VideoManager::startRecording
+    void setRecordingEnabled    (bool enabled);
+
+    /// Identifies the VIDEO_STREAM_INFORMATION stream this is showing
+    void setStreamInfo          (int streamID, const QString& name);
+
+    /// @return true: uri or latency mode changed, stream must be restarted to pick up the change
+    bool setUri                 (const QString& uri, bool lowLatency);
+
+    /// Sets the sink which decoded video is rendered to. Ownership is transferred, it is released with the stream.
+    void setVideoSink           (void* videoSink);
+
+    /// Starts the receiver if there is an uri
+    void start                  (unsigned timeout);
+    void stop                   (void);
+
+    /// Stops the receiver if running, the receiver is then started again using the current uri. Otherwise it is started.
+    void restart                (unsigned timeout);
+
+    /// Stops the receiver and deletes the stream once it has stopped
+    void release                (void);
+
+    /// @return false: stream is not running or not enabled for recording
+    bool startRecording         (const QString& videoFile, VideoReceiver::FILE_FORMAT format);
+    void stopRecording          (void);
+
+    /// @return false: stream is not running
+    bool takeScreenshot         (const QString& imageFile);
+
+signals:
+    void streamInfoChanged          (void);
+    void uriChanged                 (void);
+    void decodingEnabledChanged     (bool enabled);
+    void recordingEnabledChanged    (bool enabled);
+    void streamingChanged           (bool active);
+    void decodingChanged            (bool active);
+    void recordingChanged           (bool active);
+    void recordingStarted           (void);
+    void videoSizeChanged           (QSize size);
+
+    /// The receiver failed to start. Owner should update the stream settings and call restart.
+    void restartRequested           (void);
+
+private slots:
+    void _onStartComplete   (VideoReceiver::STATUS status);
+    void _onStopComplete    (VideoReceiver::STATUS status);
+
+private:
+    VideoReceiver*          _receiver           = nullptr;
+    void*                   _videoSink          = nullptr;
+    int                     _streamID           = -1;
+    QString                 _name;
+    QString                 _uri;
+    unsigned                _timeout            = 0;
+    bool                    _lowLatency         = false;
+    bool                    _decodingEnabled    = true;
+    bool                    _recordingEnabled   = true;
+    bool                    _startRequested     = false;
+    bool                    _releasing          = false;
+    // Receiver state as reported by the receiver signals. Those may come from the receiver thread.
+    QAtomicInteger<bool>    _started            = false;
+    QAtomicInteger<bool>    _streaming          = false;
+    QAtomicInteger<bool>    _decoding           = false;
+    QAtomicInteger<bool>    _recording          = false;
+    QAtomicInteger<quint32> _videoSize          = 0;
+};
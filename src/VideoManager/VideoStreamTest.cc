@@ -0,0 +1,396 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VideoStreamTest.h"
+#include "VideoStream.h"
+
+#if defined(QGC_GST_STREAMING)
+#include "GStreamer.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "VideoSettings.h"
+
+#include <QElapsedTimer>
+
+#include <atomic>
+#endif
+
+/// @return Sink which can be handed to a VideoStream, it is released together with the stream
+static void* _createVideoSink(void)
+{
+#if defined(QGC_GST_STREAMING)
+    return gst_element_factory_make("fakesink", nullptr);
+#else
+    static int fakeSink = 0;
+    return &fakeSink;
+#endif
+}
+
+void VideoStreamTest::_startStopTest(void)
+{
+    MockVideoReceiver*  receiver = new MockVideoReceiver();
+    VideoStream         stream(receiver);
+
+    QVERIFY(receiver->parent() == &stream);
+
+    // No uri, nothing to start
+    stream.start(5);
+    QVERIFY(receiver->calls.isEmpty());
+
+    QVERIFY(stream.setUri(QStringLiteral("udp://0.0.0.0:5600"), false));
+    QVERIFY(!stream.setUri(QStringLiteral("udp://0.0.0.0:5600"), false));
+    QVERIFY(stream.setUri(QStringLiteral("udp://0.0.0.0:5600"), true));
+
+    stream.start(5);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("start:-1") }));
+    QCOMPARE(receiver->lastUri, QStringLiteral("udp://0.0.0.0:5600"));
+    QVERIFY(!stream.started());
+
+    emit receiver->onStartComplete(VideoReceiver::STATUS_OK);
+    QVERIFY(stream.started());
+
+    QSignalSpy streamingSpy(&stream, &VideoStream::streamingChanged);
+    QSignalSpy sizeSpy(&stream, &VideoStream::videoSizeChanged);
+    emit receiver->streamingChanged(true);
+    emit receiver->videoSizeChanged(QSize(1280, 720));
+    QCOMPARE(streamingSpy.count(), 1);
+    QCOMPARE(sizeSpy.count(), 1);
+    QVERIFY(stream.streaming());
+    QCOMPARE(stream.videoSize(), QSize(1280, 720));
+}
+
+void VideoStreamTest::_decodingControlTest(void)
+{
+    MockVideoReceiver*  receiver = new MockVideoReceiver();
+    VideoStream         stream(receiver);
+
+    stream.setUri(QStringLiteral("udp://0.0.0.0:5600"), false);
+
+    // Sink before start: decoding starts once the receiver is up
+    stream.setVideoSink(_createVideoSink());
+    QVERIFY(receiver->calls.isEmpty());
+    stream.start(5);
+    emit receiver->onStartComplete(VideoReceiver::STATUS_OK);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("start:0"), QStringLiteral("startDecoding") }));
+
+    receiver->calls.clear();
+    stream.setDecodingEnabled(false);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("stopDecoding") }));
+    stream.setDecodingEnabled(false);
+    QCOMPARE(receiver->calls.count(), 1);
+    stream.setDecodingEnabled(true);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("stopDecoding"), QStringLiteral("startDecoding") }));
+
+    // Disabled stream does not decode after a restart
+    receiver->calls.clear();
+    stream.setDecodingEnabled(false);
+    receiver->calls.clear();
+    stream.restart(5);
+    emit receiver->onStopComplete(VideoReceiver::STATUS_OK);
+    emit receiver->onStartComplete(VideoReceiver::STATUS_OK);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("stop"), QStringLiteral("start:0") }));
+}
+
+void VideoStreamTest::_recordingControlTest(void)
+{
+    MockVideoReceiver*  receiver = new MockVideoReceiver();
+    VideoStream         stream(receiver);
+
+    // Not running
+    QVERIFY(!stream.startRecording(QStringLiteral("a.mkv"), VideoReceiver::FILE_FORMAT_MKV));
+
+    stream.setUri(QStringLiteral("udp://0.0.0.0:5600"), false);
+    stream.start(5);
+    emit receiver->onStartComplete(VideoReceiver::STATUS_OK);
+    receiver->calls.clear();
+
+    QVERIFY(stream.startRecording(QStringLiteral("a.mkv"), VideoReceiver::FILE_FORMAT_MKV));
+    QCOMPARE(receiver->lastFile, QStringLiteral("a.mkv"));
+    emit receiver->recordingChanged(true);
+    QVERIFY(stream.recording());
+
+    // Disabling recording stops the running recording
+    stream.setRecordingEnabled(false);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("startRecording"), QStringLiteral("stopRecording") }));
+    emit receiver->recordingChanged(false);
+
+    receiver->calls.clear();
+    QVERIFY(!stream.startRecording(QStringLiteral("b.mkv"), VideoReceiver::FILE_FORMAT_MKV));
+    QVERIFY(receiver->calls.isEmpty());
+}
+
+void VideoStreamTest::_restartTest(void)
+{
+    MockVideoReceiver*  receiver = new MockVideoReceiver();
+    VideoStream         stream(receiver);
+    QSignalSpy          restartSpy(&stream, &VideoStream::restartRequested);
+
+    stream.setUri(QStringLiteral("udp://0.0.0.0:5600"), false);
+    stream.start(5);
+
+    // Failures ask the owner for a restart, bad uri or already running do not
+    emit receiver->onStartComplete(VideoReceiver::STATUS_INVALID_URL);
+    emit receiver->onStartComplete(VideoReceiver::STATUS_INVALID_STATE);
+    QCOMPARE(restartSpy.count(), 0);
+    emit receiver->onStartComplete(VideoReceiver::STATUS_FAIL);
+    QCOMPARE(restartSpy.count(), 1);
+
+    // Not started: restart starts directly
+    receiver->calls.clear();
+    stream.restart(5);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("start:0") }));
+    emit receiver->onStartComplete(VideoReceiver::STATUS_OK);
+
+    // Started: receiver is stopped and started again with the new uri once the stop completes
+    receiver->calls.clear();
+    stream.setUri(QStringLiteral("udp://0.0.0.0:5601"), false);
+    stream.restart(5);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("stop") }));
+    emit receiver->onStopComplete(VideoReceiver::STATUS_OK);
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("stop"), QStringLiteral("start:0") }));
+    QCOMPARE(receiver->lastUri, QStringLiteral("udp://0.0.0.0:5601"));
+}
+
+void VideoStreamTest::_releaseTest(void)
+{
+    // Never started: goes away right away
+    VideoStream* stream = new VideoStream(new MockVideoReceiver());
+    QSignalSpy destroyedSpy(stream, &QObject::destroyed);
+    stream->release();
+    QTRY_COMPARE(destroyedSpy.count(), 1);
+
+    // Started: receiver is stopped first and not started again
+    MockVideoReceiver* receiver = new MockVideoReceiver();
+    stream = new VideoStream(receiver);
+    QSignalSpy destroyedSpy2(stream, &QObject::destroyed);
+    QSignalSpy restartSpy(stream, &VideoStream::restartRequested);
+    stream->setUri(QStringLiteral("udp://0.0.0.0:5600"), false);
+    stream->start(5);
+    stream->release();
+    QCOMPARE(receiver->calls, QStringList({ QStringLiteral("start:0"), QStringLiteral("stop") }));
+
+    emit receiver->onStartComplete(VideoReceiver::STATUS_FAIL);
+    QCOMPARE(restartSpy.count(), 0);
+    QTest::qWait(10);
+    QCOMPARE(destroyedSpy2.count(), 0);
+
+    emit receiver->onStopComplete(VideoReceiver::STATUS_OK);
+    QCOMPARE(receiver->calls.count(), 2);
+    QTRY_COMPARE(destroyedSpy2.count(), 1);
+}
+
+#if defined(QGC_GST_STREAMING)
+bool VideoStreamTest::_gstElementsAvailable(void)
+{
+    for (const char* element: { "videotestsrc", "x264enc", "rtph264pay", "avdec_h264" }) {
+        GstElementFactory* factory = gst_element_factory_find(element);
+        if (!factory) {
+            qDebug() << "GStreamer element not available:" << element;
+            return false;
+        }
+        gst_object_unref(factory);
+    }
+    return true;
+}
+
+/// @return Local H.264 RTP/UDP sender with a keyframe every half second, not started yet
+GstElement* VideoStreamTest::_gstSender(int port)
+{
+    const QString description = QStringLiteral("videotestsrc is-live=true pattern=ball ! video/x-raw,width=320,height=240,framerate=30/1 ! "
+                                               "x264enc tune=zerolatency speed-preset=ultrafast key-int-max=15 ! rtph264pay config-interval=1 pt=96 ! "
+                                               "udpsink host=127.0.0.1 port=%1").arg(port);
+    GError*     error   = nullptr;
+    GstElement* sender  = gst_parse_launch(description.toUtf8().constData(), &error);
+    if (error) {
+        qWarning() << "gst_parse_launch failed" << error->message;
+        g_error_free(error);
+    }
+    return sender;
+}
+
+/// Starts cStreams local H.264 RTP/UDP senders and the same number of streams receiving them with software decoding.
+/// Reports how long it takes for all streams to show video.
+void VideoStreamTest::_gstScaling(int cStreams)
+{
+    const int basePort = 5700;
+
+    QList<GstElement*>      senders;
+    QList<VideoStream*>     streams;
+    QList<qint64>           firstFrameMsecs;
+    QElapsedTimer           timer;
+
+    timer.start();
+
+    for (int i=0; i<cStreams; i++) {
+        GstElement* sender = _gstSender(basePort + i);
+        QVERIFY(sender);
+        senders.append(sender);
+
+        VideoStream* stream = new VideoStream(GStreamer::createVideoReceiver(nullptr));
+        streams.append(stream);
+        firstFrameMsecs.append(-1);
+
+        void* sink = _createVideoSink();
+        QVERIFY(sink);
+        stream->setVideoSink(sink);
+
+        connect(stream, &VideoStream::decodingChanged, this, [&firstFrameMsecs, &timer, i](bool active) {
+            if (active && firstFrameMsecs[i] == -1) {
+                firstFrameMsecs[i] = timer.elapsed();
+            }
+        });
+
+        stream->setUri(QStringLiteral("udp://0.0.0.0:%1").arg(basePort + i), true /* lowLatency */);
+        stream->start(5);
+        gst_element_set_state(sender, GST_STATE_PLAYING);
+    }
+
+    while (timer.elapsed() < 20000 && firstFrameMsecs.contains(-1)) {
+        QTest::qWait(50);
+    }
+
+    for (int i=0; i<cStreams; i++) {
+        qDebug() << "Streams:" << cStreams << "stream" << i << "first frame msecs" << firstFrameMsecs[i] << streams[i]->videoSize();
+    }
+    QVERIFY(!firstFrameMsecs.contains(-1));
+
+    for (VideoStream* stream: streams) {
+        QVERIFY(stream->streaming());
+        QVERIFY(stream->decoding());
+        QCOMPARE(stream->videoSize(), QSize(320, 240));
+    }
+
+    // All streams keep decoding concurrently
+    QTest::qWait(2000);
+    for (VideoStream* stream: streams) {
+        QVERIFY(stream->decoding());
+    }
+
+    QList<QSignalSpy*> destroyedSpies;
+    for (VideoStream* stream: streams) {
+        destroyedSpies.append(new QSignalSpy(stream, &QObject::destroyed));
+        stream->release();
+    }
+    for (QSignalSpy* spy: destroyedSpies) {
+        QTRY_COMPARE_WITH_TIMEOUT(spy->count(), 1, 10000);
+    }
+    qDeleteAll(destroyedSpies);
+
+    for (GstElement* sender: senders) {
+        gst_element_set_state(sender, GST_STATE_NULL);
+        gst_object_unref(sender);
+    }
+}
+#endif
+
+void VideoStreamTest::_gstScalingTest(void)
+{
+#if defined(QGC_GST_STREAMING)
+    if (!_gstElementsAvailable()) {
+        QSKIP("GStreamer elements for test stream not available");
+    }
+
+    VideoSettings* videoSettings = qgcApp()->toolbox()->settingsManager()->videoSettings();
+
+    GStreamer::blacklist(VideoSettings::ForceVideoDecoderSoftware);
+    for (int cStreams: { 1, 2, 4 }) {
+        _gstScaling(cStreams);
+        if (QTest::currentTestFailed()) {
+            break;
+        }
+    }
+    GStreamer::blacklist(static_cast<VideoSettings::VideoDecoderOptions>(videoSettings->forceVideoDecoder()->rawValue().toInt()));
+#else
+    QSKIP("GStreamer support not built");
+#endif
+}
+
+#if defined(QGC_GST_STREAMING)
+typedef struct {
+    std::atomic<qint64> resumeMsecs;
+    std::atomic<qint64> firstFrameMsecs;
+} SinkWatch_t;
+
+static GstPadProbeReturn _sinkWatchProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+    Q_UNUSED(info)
+
+    SinkWatch_t*    watch   = static_cast<SinkWatch_t*>(user_data);
+    const qint64    now     = g_get_monotonic_time() / 1000;
+
+    if (watch->resumeMsecs != 0 && watch->firstFrameMsecs == 0) {
+        watch->firstFrameMsecs = now;
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+#endif
+
+/// Pauses a local UDP sender long enough for the receiver to notice the loss, then resumes it and measures the time
+/// until the first frame makes it to the video sink. The pipeline must not be restarted for that.
+void VideoStreamTest::_gstOutageRecoveryTest(void)
+{
+#if defined(QGC_GST_STREAMING)
+    if (!_gstElementsAvailable()) {
+        QSKIP("GStreamer elements for test stream not available");
+    }
+
+    const int       port = 5710;
+    SinkWatch_t     watch;
+    watch.resumeMsecs       = 0;
+    watch.firstFrameMsecs   = 0;
+
+    GstElement* sender = _gstSender(port);
+    QVERIFY(sender);
+
+    VideoStream* stream = new VideoStream(GStreamer::createVideoReceiver(nullptr));
+
+    GstElement* sink = static_cast<GstElement*>(_createVideoSink());
+    QVERIFY(sink);
+    GstPad* sinkPad = gst_element_get_static_pad(sink, "sink");
+    gst_pad_add_probe(sinkPad, GST_PAD_PROBE_TYPE_BUFFER, _sinkWatchProbe, &watch, nullptr);
+    gst_object_unref(sinkPad);
+    stream->setVideoSink(sink);
+
+    stream->setUri(QStringLiteral("udp://0.0.0.0:%1").arg(port), true /* lowLatency */);
+    stream->start(5);
+    gst_element_set_state(sender, GST_STATE_PLAYING);
+
+    QTRY_VERIFY_WITH_TIMEOUT(stream->decoding(), 10000);
+
+    QSignalSpy streamingSpy(stream, &VideoStream::streamingChanged);
+
+    // Outage: well past loss detection but shorter than the full restart timeout
+    gst_element_set_state(sender, GST_STATE_PAUSED);
+    QTest::qWait(2000);
+
+    watch.resumeMsecs = g_get_monotonic_time() / 1000;
+    gst_element_set_state(sender, GST_STATE_PLAYING);
+
+    QTRY_VERIFY_WITH_TIMEOUT(watch.firstFrameMsecs != 0, 5000);
+
+    const qint64 recoveryMsecs = watch.firstFrameMsecs - watch.resumeMsecs;
+    qDebug() << "Outage to first frame after resume:" << recoveryMsecs << "msecs";
+
+    // Source only recovery waits for the next keyframe (every 500 msecs) rather than restarting the pipeline
+    QVERIFY(recoveryMsecs < 1500);
+    QCOMPARE(streamingSpy.count(), 0);
+    QVERIFY(stream->streaming());
+
+    QSignalSpy destroyedSpy(stream, &QObject::destroyed);
+    stream->release();
+    QTRY_COMPARE_WITH_TIMEOUT(destroyedSpy.count(), 1, 10000);
+
+    gst_element_set_state(sender, GST_STATE_NULL);
+    gst_object_unref(sender);
+#else
+    QSKIP("GStreamer support not built");
+#endif
+}
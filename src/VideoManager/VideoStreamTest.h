@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "VideoReceiver.h"
+
+#if defined(QGC_GST_STREAMING)
+#include <gst/gst.h>
+#endif
+
+/// Receiver which records the calls made to it. Completion signals are emitted by the test.
+class MockVideoReceiver : public VideoReceiver
+{
+    Q_OBJECT
+
+public:
+    MockVideoReceiver(QObject* parent = nullptr) : VideoReceiver(parent) { }
+
+    QStringList calls;
+    QString     lastUri;
+    QString     lastFile;
+
+public slots:
+    void start          (const QString& uri, unsigned timeout, int buffer = 0) override { Q_UNUSED(timeout) calls << QStringLiteral("start:%1").arg(buffer); lastUri = uri; }
+    void stop           (void) override                                        { calls << QStringLiteral("stop"); }
+    void startDecoding  (void* sink) override                                  { Q_UNUSED(sink) calls << QStringLiteral("startDecoding"); }
+    void stopDecoding   (void) override                                        { calls << QStringLiteral("stopDecoding"); }
+    void startRecording (const QString& videoFile, FILE_FORMAT format) override { Q_UNUSED(format) calls << QStringLiteral("startRecording"); lastFile = videoFile; }
+    void stopRecording  (void) override                                        { calls << QStringLiteral("stopRecording"); }
+    void takeScreenshot (const QString& imageFile) override                    { Q_UNUSED(imageFile) calls << QStringLiteral("takeScreenshot"); }
+};
+
+/// Tests VideoStream state handling against a mock receiver and, if GStreamer is available, stream count scaling
+/// with local videotestsrc RTP/UDP sources
+class VideoStreamTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _startStopTest         (void);
+    void _decodingControlTest   (void);
+    void _recordingControlTest  (void);
+    void _restartTest           (void);
+    void _releaseTest           (void);
+    void _gstScalingTest        (void);
+    void _gstOutageRecoveryTest (void);
+
+private:
+#if defined(QGC_GST_STREAMING)
+    bool        _gstElementsAvailable   (void);
+    void        _gstScaling             (int cStreams);
+    GstElement* _gstSender              (int port);
+#endif
+};
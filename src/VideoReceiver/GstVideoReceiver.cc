@@ -49,21 +49,36 @@ GstVideoReceiver::GstVideoReceiver(QObject* parent)
     , _fileSink(nullptr)
     , _pipeline(nullptr)
     , _lastSourceFrameTime(0)
+    , _sourceFrameIntervalUsecs(0)
     , _lastVideoFrameTime(0)
+    , _startTime(0)
+    , _streamLost(false)
+    , _lossStartTime(0)
+    , _reconnectDelayMsecs(kReconnectMinMsecs)
+    , _nextReconnectTime(0)
+    , _reconnectCount(0)
+    , _waitingForKeyframe(false)
     , _resetVideoSink(true)
     , _videoSinkProbeId(0)
     , _udpReconnect_us(5000000)
     , _signalDepth(0)
     , _endOfStream(false)
+    , _recordingClock(nullptr)
+    , _recordingClockStart(0)
 {
     _slotHandler.start();
     connect(&_watchdogTimer, &QTimer::timeout, this, &GstVideoReceiver::_watchdog);
-    _watchdogTimer.start(1000);
+    _watchdogTimer.start(kWatchdogMsecs);
 }
 
 GstVideoReceiver::~GstVideoReceiver(void)
 {
     _slotHandler.shutdown();
+
+    if (_recordingClock != nullptr) {
+        gst_object_unref(_recordingClock);
+        _recordingClock = nullptr;
+    }
 }
 
 void
@@ -101,6 +116,13 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
     _endOfStream = false;
 
+    _startTime                  = _nowMsecs();
+    _sourceFrameIntervalUsecs   = 0;
+    _streamLost                 = false;
+    _reconnectDelayMsecs        = kReconnectMinMsecs;
+    _reconnectCount             = 0;
+    _waitingForKeyframe         = false;
+
     bool running    = false;
     bool pipelineUp = false;
 
@@ -166,30 +188,7 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
         pipelineUp = true;
 
-        GstPad* srcPad = nullptr;
-
-        GstIterator* it;
-
-        if ((it = gst_element_iterate_src_pads(_source)) != nullptr) {
-            GValue vpad = G_VALUE_INIT;
-
-            if (gst_iterator_next(it, &vpad) == GST_ITERATOR_OK) {
-                srcPad = GST_PAD(g_value_get_object(&vpad));
-                gst_object_ref(srcPad);
-                g_value_reset(&vpad);
-            }
-
-            gst_iterator_free(it);
-            it = nullptr;
-        }
-
-        if (srcPad != nullptr) {
-            _onNewSourcePad(srcPad);
-            gst_object_unref(srcPad);
-            srcPad = nullptr;
-        } else {
-            g_signal_connect(_source, "pad-added", G_CALLBACK(_onNewPad), this);
-        }
+        _linkSource();
 
         if(!gst_element_link_many(_tee, decoderQueue, _decoderValve, nullptr)) {
             qCCritical(VideoReceiverLog) << "Unable to link decoder queue";
@@ -346,6 +345,8 @@ GstVideoReceiver::stop(void)
         _source = nullptr;
 
         _lastSourceFrameTime = 0;
+        _waitingForKeyframe = false;
+        _streamLost = false;
 
         if (_streaming) {
             _streaming = false;
@@ -618,12 +619,26 @@ GstVideoReceiver::takeScreenshot(const QString& imageFile)
     });
 }
 
+const int GstVideoReceiver::kWatchdogMsecs;
+const int GstVideoReceiver::kMinLossMsecs;
+const int GstVideoReceiver::kMaxLossMsecs;
+const int GstVideoReceiver::kReconnectMinMsecs;
+const int GstVideoReceiver::kReconnectMaxMsecs;
+const guint GstVideoReceiver::_kTaisyncBacklogBytes;
+
 const char* GstVideoReceiver::_kFileMux[FILE_FORMAT_MAX - FILE_FORMAT_MIN] = {
     "matroskamux",
     "qtmux",
     "mp4mux"
 };
 
+// Stream loss handling:
+//  - The source is considered lost once no buffers made it to the tee for a few frame intervals (_lossThresholdMsecs)
+//  - Decoder and video sink stay in place. The decoder is fed again starting with the next keyframe such that the
+//    first frame shown after the outage is a clean one.
+//  - Connection oriented sources (RTSP, TCP) are rebuilt with backoff until data flows again. UDP sources simply keep
+//    listening.
+//  - The whole pipeline is only restarted if the stream never started or the decoder stalls on flowing data.
 void
 GstVideoReceiver::_watchdog(void)
 {
@@ -632,18 +647,49 @@ GstVideoReceiver::_watchdog(void)
             return;
         }
 
-        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        const qint64 now                = _nowMsecs();
+        const qint64 lastSourceFrame    = _lastSourceFrameTime;
 
-        if (_lastSourceFrameTime == 0) {
-            _lastSourceFrameTime = now;
+        if (lastSourceFrame == 0) {
+            if (now - _startTime > static_cast<qint64>(_timeout) * 1000) {
+                qCDebug(VideoReceiverLog) << "Stream timeout, no frames since start" << now - _startTime << "msecs" << _uri;
+                _dispatchSignal([this](){
+                    emit timeout();
+                });
+                stop();
+            }
+            return;
         }
 
-        if (now - _lastSourceFrameTime > _timeout) {
-            qCDebug(VideoReceiverLog) << "Stream timeout, no frames for " << now - _lastSourceFrameTime << "" << _uri;
+        if (!_streamLost && now - lastSourceFrame > _lossThresholdMsecs()) {
+            _streamLost             = true;
+            _lossStartTime          = lastSourceFrame;
+            _reconnectDelayMsecs    = kReconnectMinMsecs;
+            _nextReconnectTime      = now + _reconnectDelayMsecs;
+            _reconnectCount         = 0;
+            qCDebug(VideoReceiverLog) << "Stream lost, no frames for" << now - lastSourceFrame << "msecs" << _uri;
+            _armDecoderKeyframeWatch();
             _dispatchSignal([this](){
                 emit timeout();
             });
-            stop();
+        } else if (_streamLost && lastSourceFrame > _lossStartTime && now - lastSourceFrame <= _lossThresholdMsecs()) {
+            _streamLost = false;
+            _lastVideoFrameTime = 0;
+            qCDebug(VideoReceiverLog) << "Stream data back after" << lastSourceFrame - _lossStartTime << "msecs," << _reconnectCount << "reconnects" << _uri;
+        }
+
+        if (_streamLost) {
+            if (_isConnectionOrientedSource() && now >= _nextReconnectTime) {
+                _reconnectCount++;
+                qCDebug(VideoReceiverLog) << "Reconnecting source, attempt" << _reconnectCount << _uri;
+                if (!_rebuildSource()) {
+                    qCCritical(VideoReceiverLog) << "_rebuildSource() failed" << _uri;
+                }
+                _reconnectDelayMsecs    = qMin(_reconnectDelayMsecs * 2, static_cast<qint64>(kReconnectMaxMsecs));
+                _nextReconnectTime      = now + _reconnectDelayMsecs;
+            }
+            // Decoder has nothing to work on
+            return;
         }
 
         if (_decoding && !_removingDecoder) {
@@ -651,8 +697,8 @@ GstVideoReceiver::_watchdog(void)
                 _lastVideoFrameTime = now;
             }
 
-            if (now - _lastVideoFrameTime > _timeout * 2) {
-                qCDebug(VideoReceiverLog) << "Video decoder timeout, no frames for " << now - _lastVideoFrameTime << " " << _uri;
+            if (now - _lastVideoFrameTime > static_cast<qint64>(_timeout) * 2 * 1000) {
+                qCDebug(VideoReceiverLog) << "Video decoder timeout, no frames for " << now - _lastVideoFrameTime << "msecs" << _uri;
                 _dispatchSignal([this](){
                     emit timeout();
                 });
@@ -662,6 +708,113 @@ GstVideoReceiver::_watchdog(void)
     });
 }
 
+qint64
+GstVideoReceiver::_nowMsecs(void)
+{
+    return g_get_monotonic_time() / 1000;
+}
+
+qint64
+GstVideoReceiver::_lossThresholdMsecs(void) const
+{
+    // A few frame intervals, such that low frame rate streams are not considered lost between frames
+    const qint64 intervalMsecs = _sourceFrameIntervalUsecs / 1000;
+    return qBound(static_cast<qint64>(kMinLossMsecs), intervalMsecs * 8, static_cast<qint64>(kMaxLossMsecs));
+}
+
+bool
+GstVideoReceiver::_isConnectionOrientedSource(void) const
+{
+    return _uri.contains("rtsp://", Qt::CaseInsensitive) || _uri.contains("tcp://", Qt::CaseInsensitive) || _uri.contains("taisync://", Qt::CaseInsensitive);
+}
+
+// Links the source to the tee once it has a source pad
+void
+GstVideoReceiver::_linkSource(void)
+{
+    GstPad* srcPad = nullptr;
+
+    GstIterator* it;
+
+    if ((it = gst_element_iterate_src_pads(_source)) != nullptr) {
+        GValue vpad = G_VALUE_INIT;
+
+        if (gst_iterator_next(it, &vpad) == GST_ITERATOR_OK) {
+            srcPad = GST_PAD(g_value_get_object(&vpad));
+            gst_object_ref(srcPad);
+            g_value_reset(&vpad);
+        }
+
+        gst_iterator_free(it);
+        it = nullptr;
+    }
+
+    if (srcPad != nullptr) {
+        _onNewSourcePad(srcPad);
+        gst_object_unref(srcPad);
+        srcPad = nullptr;
+    } else {
+        g_signal_connect(_source, "pad-added", G_CALLBACK(_onNewPad), this);
+    }
+}
+
+// Replaces the source while leaving tee, decoder, video sink and recording branch alone
+bool
+GstVideoReceiver::_rebuildSource(void)
+{
+    GstElement* source;
+
+    if ((source = _makeSource(_uri)) == nullptr) {
+        qCCritical(VideoReceiverLog) << "_makeSource() failed" << _uri;
+        return false;
+    }
+
+    if (_source != nullptr) {
+        // Old source goes away without an EOS, downstream must not see the stream end
+        g_signal_handlers_disconnect_by_data(_source, this);
+        gst_element_unlink(_source, _tee);
+        gst_element_set_state(_source, GST_STATE_NULL);
+        gst_bin_remove(GST_BIN(_pipeline), _source);
+        _source = nullptr;
+    }
+
+    _source = source;
+
+    gst_bin_add(GST_BIN(_pipeline), _source);
+
+    _linkSource();
+
+    if (!gst_element_sync_state_with_parent(_source)) {
+        qCCritical(VideoReceiverLog) << "gst_element_sync_state_with_parent() failed" << _uri;
+        return false;
+    }
+
+    GST_DEBUG_BIN_TO_DOT_FILE(GST_BIN(_pipeline), GST_DEBUG_GRAPH_SHOW_ALL, "pipeline-source-rebuilt");
+
+    return true;
+}
+
+// Drops the buffers going to the decoder until the next keyframe
+void
+GstVideoReceiver::_armDecoderKeyframeWatch(void)
+{
+    if (_decoderValve == nullptr || _waitingForKeyframe) {
+        return;
+    }
+
+    GstPad* probepad;
+
+    if ((probepad = gst_element_get_static_pad(_decoderValve, "src")) == nullptr) {
+        qCCritical(VideoReceiverLog) << "gst_element_get_static_pad() failed" << _uri;
+        return;
+    }
+
+    _waitingForKeyframe = true;
+    gst_pad_add_probe(probepad, GST_PAD_PROBE_TYPE_BUFFER, _decoderKeyframeWatch, this, nullptr);
+    gst_object_unref(probepad);
+    probepad = nullptr;
+}
+
 void
 GstVideoReceiver::_handleEOS(void)
 {
@@ -692,6 +845,7 @@ GstVideoReceiver::_makeSource(const QString& uri)
     }
 
     bool isTaisync  = uri.contains("tsusb://",  Qt::CaseInsensitive);
+    bool isTaisyncTcp = uri.contains("taisync://", Qt::CaseInsensitive);
     bool isUdp264   = uri.contains("udp://",    Qt::CaseInsensitive);
     bool isRtsp     = uri.contains("rtsp://",   Qt::CaseInsensitive);
     bool isUdp265   = uri.contains("udp265://", Qt::CaseInsensitive);
@@ -701,6 +855,7 @@ GstVideoReceiver::_makeSource(const QString& uri)
     GstElement* source  = nullptr;
     GstElement* buffer  = nullptr;
     GstElement* tsdemux = nullptr;
+    GstElement* backlog = nullptr;
     GstElement* parser  = nullptr;
     GstElement* bin     = nullptr;
     GstElement* srcbin  = nullptr;
@@ -716,6 +871,11 @@ GstVideoReceiver::_makeSource(const QString& uri)
             if ((source = gst_element_factory_make("rtspsrc", "source")) != nullptr) {
                 g_object_set(static_cast<gpointer>(source), "location", qPrintable(uri), "latency", 17, "udp-reconnect", 1, "timeout", _udpReconnect_us, NULL);
             }
+        } else if (isTaisyncTcp) {
+            // The Taisync ground unit connects to us and sends a raw h.264 byte stream
+            if ((source = gst_element_factory_make("tcpserversrc", "source")) != nullptr) {
+                g_object_set(static_cast<gpointer>(source), "host", qPrintable(url.host()), "port", url.port(), nullptr);
+            }
         } else if(isUdp264 || isUdp265 || isUdpMPEGTS || isTaisync) {
             if ((source = gst_element_factory_make("udpsrc", "source")) != nullptr) {
                 g_object_set(static_cast<gpointer>(source), "uri", QString("udp://%1:%2").arg(qPrintable(url.host()), QString::number(url.port())).toUtf8().data(), nullptr);
@@ -780,6 +940,32 @@ GstVideoReceiver::_makeSource(const QString& uri)
             tsdemux = nullptr;
         }
 
+        if (isTaisyncTcp) {
+            // The socket is always drained such that the ground unit never stalls. If decoding falls behind the
+            // oldest data is dropped, just like a congested UDP link would, instead of piling up latency.
+            if ((backlog = gst_element_factory_make("queue", nullptr)) == nullptr) {
+                qCCritical(VideoReceiverLog) << "gst_element_factory_make('queue') failed";
+                break;
+            }
+
+            g_object_set(static_cast<gpointer>(backlog),
+                         "leaky",               2,  // downstream
+                         "max-size-buffers",    0,
+                         "max-size-time",       G_GUINT64_CONSTANT(0),
+                         "max-size-bytes",      _kTaisyncBacklogBytes,
+                         nullptr);
+
+            gst_bin_add(GST_BIN(bin), backlog);
+
+            if (!gst_element_link(source, backlog)) {
+                qCCritical(VideoReceiverLog) << "gst_element_link() failed";
+                break;
+            }
+
+            source = backlog;
+            backlog = nullptr;
+        }
+
         int probeRes = 0;
 
         gst_element_foreach_src_pad(source, _padProbe, &probeRes);
@@ -809,7 +995,7 @@ GstVideoReceiver::_makeSource(const QString& uri)
 
         g_signal_connect(parser, "pad-added", G_CALLBACK(_wrapWithGhostPad), nullptr);
 
-        source = tsdemux = buffer = parser = nullptr;
+        source = tsdemux = backlog = buffer = parser = nullptr;
 
         srcbin = bin;
         bin = nullptr;
@@ -830,6 +1016,11 @@ GstVideoReceiver::_makeSource(const QString& uri)
         tsdemux = nullptr;
     }
 
+    if (backlog != nullptr) {
+        gst_object_unref(backlog);
+        backlog = nullptr;
+    }
+
     if (buffer != nullptr) {
         gst_object_unref(buffer);
         buffer = nullptr;
@@ -966,7 +1157,8 @@ GstVideoReceiver::_onNewSourcePad(GstPad* pad)
 
     gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, _eosProbe, this, nullptr);
 
-    if (_videoSink == nullptr) {
+    // Decoder survives a source rebuild
+    if (_videoSink == nullptr || _decoder != nullptr) {
         return;
     }
 
@@ -1121,13 +1313,21 @@ GstVideoReceiver::_addVideoSink(GstPad* pad)
 void
 GstVideoReceiver::_noteTeeFrame(void)
 {
-    _lastSourceFrameTime = QDateTime::currentSecsSinceEpoch();
+    const qint64 now    = _nowMsecs();
+    const qint64 last   = _lastSourceFrameTime.exchange(now);
+
+    // Running average of the buffer interval over roughly the last 16 buffers, gaps from outages are left out
+    if (last != 0 && now - last < kMaxLossMsecs) {
+        const qint64 intervalUsecs  = (now - last) * 1000;
+        const qint64 average        = _sourceFrameIntervalUsecs;
+        _sourceFrameIntervalUsecs   = average == 0 ? intervalUsecs : average + ((intervalUsecs - average) / 16);
+    }
 }
 
 void
 GstVideoReceiver::_noteVideoSinkFrame(void)
 {
-    _lastVideoFrameTime = QDateTime::currentSecsSinceEpoch();
+    _lastVideoFrameTime = _nowMsecs();
     if (!_decoding) {
         _decoding = true;
         qCDebug(VideoReceiverLog) << "Decoding started";
@@ -1249,6 +1449,13 @@ GstVideoReceiver::_shutdownDecodingBranch(void)
 void
 GstVideoReceiver::_shutdownRecordingBranch(void)
 {
+    _recordingClockMutex.lock();
+    if (_recordingClock != nullptr) {
+        gst_object_unref(_recordingClock);
+        _recordingClock = nullptr;
+    }
+    _recordingClockMutex.unlock();
+
     gst_bin_remove(GST_BIN(_pipeline), _fileSink);
     gst_element_set_state(_fileSink, GST_STATE_NULL);
     gst_object_unref(_fileSink);
@@ -1267,6 +1474,18 @@ GstVideoReceiver::_shutdownRecordingBranch(void)
     GST_DEBUG_BIN_TO_DOT_FILE(GST_BIN(_pipeline), GST_DEBUG_GRAPH_SHOW_ALL, "pipeline-recording-stopped");
 }
 
+qint64
+GstVideoReceiver::recordingTimeNsecs(void)
+{
+    QMutexLocker lock(&_recordingClockMutex);
+
+    if (_recordingClock == nullptr) {
+        return -1;
+    }
+
+    return static_cast<qint64>(gst_clock_get_time(_recordingClock)) - static_cast<qint64>(_recordingClockStart);
+}
+
 bool
 GstVideoReceiver::_needDispatch(void)
 {
@@ -1533,6 +1752,12 @@ GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer us
         return GST_PAD_PROBE_DROP;
     }
 
+    // Without a timestamp neither the file offset nor the telemetry clock origin is known, wait for the next keyframe
+    if (!GST_BUFFER_PTS_IS_VALID(buf)) {
+        qCDebug(VideoReceiverLog) << "Dropping keyframe without timestamp";
+        return GST_PAD_PROBE_DROP;
+    }
+
     // set media file '0' offset to current timeline position - we don't want to touch other elements in the graph, except these which are downstream!
     gst_pad_set_offset(pad, -static_cast<gint64>(buf->pts));
 
@@ -1540,9 +1765,48 @@ GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer us
 
     qCDebug(VideoReceiverLog) << "Got keyframe, stop dropping buffers";
 
+    // Remember where the file starts on the pipeline clock so telemetry can be lined up with the recorded frames
+    pThis->_recordingClockMutex.lock();
+    if (pThis->_recordingClock != nullptr) {
+        gst_object_unref(pThis->_recordingClock);
+    }
+    pThis->_recordingClock      = gst_element_get_clock(pThis->_pipeline);
+    pThis->_recordingClockStart = gst_element_get_base_time(pThis->_pipeline) + buf->pts;
+    pThis->_recordingClockMutex.unlock();
+
     pThis->_dispatchSignal([pThis]() {
         pThis->recordingStarted();
     });
 
     return GST_PAD_PROBE_REMOVE;
 }
+
+GstPadProbeReturn
+GstVideoReceiver::_decoderKeyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+
+    if (info == nullptr || user_data == nullptr) {
+        qCCritical(VideoReceiverLog) << "Invalid arguments";
+        return GST_PAD_PROBE_DROP;
+    }
+
+    GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+
+    // Stream might have been stopped while we were waiting
+    if (!pThis->_waitingForKeyframe) {
+        return GST_PAD_PROBE_REMOVE;
+    }
+
+    GstBuffer* buf = gst_pad_probe_info_get_buffer(info);
+
+    if (GST_BUFFER_FLAG_IS_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT)) { // wait for a keyframe
+        return GST_PAD_PROBE_DROP;
+    }
+
+    qCDebug(VideoReceiverLog) << "Got keyframe after stream loss, decoding resumes" << pThis->_uri;
+
+    pThis->_waitingForKeyframe = false;
+
+    return GST_PAD_PROBE_REMOVE;
+}
@@ -23,6 +23,8 @@
 #include <QQueue>
 #include <QQuickItem>
 
+#include <atomic>
+
 #include "VideoReceiver.h"
 
 #include <gst/gst.h>
@@ -88,6 +90,14 @@ public:
     explicit GstVideoReceiver(QObject* parent = nullptr);
     ~GstVideoReceiver(void);
 
+    qint64 recordingTimeNsecs(void) override;
+
+    static const int    kWatchdogMsecs          = 100;  ///< Watchdog interval, bounds how quickly a stream loss is noticed
+    static const int    kMinLossMsecs           = 250;  ///< No source buffers for this long (at least) is a stream loss
+    static const int    kMaxLossMsecs           = 1000; ///< No source buffers for this long (at most) is a stream loss
+    static const int    kReconnectMinMsecs      = 250;  ///< First source reconnect delay after a loss
+    static const int    kReconnectMaxMsecs      = 4000; ///< Reconnect delay doubles up to this
+
 public slots:
     virtual void start(const QString& uri, unsigned timeout, int buffer = 0);
     virtual void stop(void);
@@ -110,6 +120,7 @@ protected:
     virtual void _onNewDecoderPad(GstPad* pad);
     virtual bool _addDecoder(GstElement* src);
     virtual bool _addVideoSink(GstPad* pad);
+    virtual bool _rebuildSource(void);
     virtual void _noteTeeFrame(void);
     virtual void _noteVideoSinkFrame(void);
     virtual void _noteEndOfStream(void);
@@ -118,6 +129,11 @@ protected:
     virtual void _shutdownRecordingBranch(void);
 
     bool _needDispatch(void);
+    void _linkSource(void);
+    void _armDecoderKeyframeWatch(void);
+    qint64 _lossThresholdMsecs(void) const;
+    bool _isConnectionOrientedSource(void) const;
+    static qint64 _nowMsecs(void);
     void _dispatchSignal(std::function<void()> emitter);
 
     static gboolean _onBusMessage(GstBus* bus, GstMessage* message, gpointer user_data);
@@ -129,6 +145,7 @@ protected:
     static GstPadProbeReturn _videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _eosProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _decoderKeyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
 
     bool                _streaming;
     bool                _decoding;
@@ -144,8 +161,19 @@ protected:
     GstElement*         _fileSink;
     GstElement*         _pipeline;
 
-    qint64              _lastSourceFrameTime;
+    // Monotonic msecs. Source frame time and interval are written from the streaming thread.
+    std::atomic<qint64> _lastSourceFrameTime;
+    std::atomic<qint64> _sourceFrameIntervalUsecs;  ///< Running average of the time between source buffers
     qint64              _lastVideoFrameTime;
+    qint64              _startTime;
+
+    // Stream loss handling, see _watchdog
+    bool                _streamLost;
+    qint64              _lossStartTime;
+    qint64              _reconnectDelayMsecs;
+    qint64              _nextReconnectTime;
+    int                 _reconnectCount;
+    std::atomic<bool>   _waitingForKeyframe;
     bool                _resetVideoSink;
     gulong              _videoSinkProbeId;
 
@@ -163,7 +191,13 @@ protected:
 
     bool                _endOfStream;
 
+    // Pipeline clock and its value at the start of the recorded file, protected by _recordingClockMutex
+    QMutex              _recordingClockMutex;
+    GstClock*           _recordingClock;
+    GstClockTime        _recordingClockStart;
+
     static const char*  _kFileMux[FILE_FORMAT_MAX - FILE_FORMAT_MIN];
+    static const guint  _kTaisyncBacklogBytes = 1024 * 1024;    ///< Taisync stream data queued for decoding before the oldest is dropped
 };
 
 void* createVideoSink(void* widget);
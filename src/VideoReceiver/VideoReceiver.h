@@ -47,6 +47,10 @@ public:
 
     Q_ENUM(STATUS)
 
+    /// @return Current position within the file being recorded in nanoseconds, based on the pipeline clock. Negative
+    ///         if not recording or not supported. May be called from any thread.
+    virtual qint64 recordingTimeNsecs(void) { return -1; }
+
 signals:
     void timeout(void);
     void streamingChanged(bool active);
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "LinkConfiguration.h"
+#include "MAVLinkSigning.h"
 #ifndef NO_SERIAL_LINK
 #include "SerialLink.h"
 #endif
@@ -42,6 +43,10 @@ LinkConfiguration::LinkConfiguration(LinkConfiguration* copy)
     _dynamic    = copy->isDynamic();
     _autoConnect= copy->isAutoConnect();
     _highLatency= copy->isHighLatency();
+    _receiveCoalesceBytes = copy->receiveCoalesceBytes();
+    _receiveCoalesceUSecs = copy->receiveCoalesceUSecs();
+    _signingKey           = copy->signingKey();
+    _signingAllowUnsigned = copy->signingAllowUnsigned();
     Q_ASSERT(!_name.isEmpty());
 }
 
@@ -53,6 +58,30 @@ void LinkConfiguration::copyFrom(LinkConfiguration* source)
     _dynamic    = source->isDynamic();
     _autoConnect= source->isAutoConnect();
     _highLatency= source->isHighLatency();
+    _receiveCoalesceBytes = source->receiveCoalesceBytes();
+    _receiveCoalesceUSecs = source->receiveCoalesceUSecs();
+    if (_signingKey != source->signingKey() || _signingAllowUnsigned != source->signingAllowUnsigned()) {
+        _signingKey           = source->signingKey();
+        _signingAllowUnsigned = source->signingAllowUnsigned();
+        // Open links pick up the new key from this
+        emit signingChanged();
+    }
+}
+
+void LinkConfiguration::setSigningKey(const QString& hexKey)
+{
+    QString key = hexKey.trimmed().toLower();
+    if (!key.isEmpty() && QByteArray::fromHex(key.toLatin1()).length() != MAVLinkSigning::keyLength) {
+        qWarning() << "Invalid signing key length, signing disabled" << name();
+        key.clear();
+    }
+    _signingKey = key;
+    emit signingChanged();
+}
+
+void LinkConfiguration::setSigningPassphrase(const QString& passphrase)
+{
+    setSigningKey(passphrase.isEmpty() ? QString() : QString::fromLatin1(MAVLinkSigning::keyFromPassphrase(passphrase).toHex()));
 }
 
 /*!
@@ -33,6 +33,11 @@ public:
     Q_PROPERTY(QString          settingsURL         READ settingsURL                            CONSTANT)
     Q_PROPERTY(QString          settingsTitle       READ settingsTitle                          CONSTANT)
     Q_PROPERTY(bool             highLatency         READ isHighLatency  WRITE setHighLatency    NOTIFY highLatencyChanged)
+    Q_PROPERTY(int              receiveCoalesceBytes    READ receiveCoalesceBytes   WRITE setReceiveCoalesceBytes   NOTIFY receiveCoalescingChanged)
+    Q_PROPERTY(int              receiveCoalesceUSecs    READ receiveCoalesceUSecs   WRITE setReceiveCoalesceUSecs   NOTIFY receiveCoalescingChanged)
+    Q_PROPERTY(QString          signingKey              READ signingKey             WRITE setSigningKey             NOTIFY signingChanged)
+    Q_PROPERTY(bool             signingAllowUnsigned    READ signingAllowUnsigned   WRITE setSigningAllowUnsigned   NOTIFY signingChanged)
+    Q_PROPERTY(bool             signingEnabled          READ signingEnabled                                         NOTIFY signingChanged)
 
     // Property accessors
 
@@ -86,6 +91,28 @@ public:
     */
     void setHighLatency(bool hl = false) { _highLatency = hl; emit highLatencyChanged(); }
 
+    /*!
+     * Read coalescing for stream based links. Small reads are held back until this many bytes are pending
+     * or the oldest pending byte is this many microseconds old. 0 for either value disables coalescing.
+    */
+    int  receiveCoalesceBytes   () const { return _receiveCoalesceBytes; }
+    int  receiveCoalesceUSecs   () const { return _receiveCoalesceUSecs; }
+    void setReceiveCoalesceBytes(int bytes) { _receiveCoalesceBytes = bytes; emit receiveCoalescingChanged(); }
+    void setReceiveCoalesceUSecs(int usecs) { _receiveCoalesceUSecs = usecs; emit receiveCoalescingChanged(); }
+
+    /*!
+     * MAVLink 2 signing. The key is 32 bytes stored as a hex string, an empty key disables signing.
+    */
+    QString     signingKey              () const { return _signingKey; }
+    QByteArray  signingKeyBytes         () const { return QByteArray::fromHex(_signingKey.toLatin1()); }
+    bool        signingAllowUnsigned    () const { return _signingAllowUnsigned; }
+    bool        signingEnabled          () const { return !_signingKey.isEmpty(); }
+    void        setSigningKey           (const QString& hexKey);
+    void        setSigningAllowUnsigned (bool allowUnsigned) { _signingAllowUnsigned = allowUnsigned; emit signingChanged(); }
+
+    /// Sets the signing key to the one derived from the specified passphrase. An empty passphrase disables signing.
+    Q_INVOKABLE void setSigningPassphrase(const QString& passphrase);
+
     /// Virtual Methods
 
     /*!
@@ -167,6 +194,8 @@ signals:
     void dynamicChanged     ();
     void autoConnectChanged ();
     void highLatencyChanged ();
+    void receiveCoalescingChanged();
+    void signingChanged     ();
     void linkChanged        ();
 
 protected:
@@ -177,6 +206,10 @@ private:
     bool    _dynamic;       ///< A connection added automatically and not persistent (unless it's edited).
     bool    _autoConnect;   ///< This connection is started automatically at boot
     bool    _highLatency;
+    int     _receiveCoalesceBytes   = 0;
+    int     _receiveCoalesceUSecs   = 0;
+    QString _signingKey;
+    bool    _signingAllowUnsigned   = false;
 };
 
 typedef std::shared_ptr<LinkConfiguration>  SharedLinkConfigurationPtr;
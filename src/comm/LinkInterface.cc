@@ -10,6 +10,8 @@
 #include "LinkInterface.h"
 #include "QGCApplication.h"
 
+#include <QIODevice>
+
 LinkInterface::LinkInterface(SharedLinkConfigurationPtr& config, bool isPX4Flow)
     : QThread   (0)
     , _config   (config)
@@ -18,6 +20,21 @@ LinkInterface::LinkInterface(SharedLinkConfigurationPtr& config, bool isPX4Flow)
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
 
     qRegisterMetaType<LinkInterface*>("LinkInterface*");
+
+    // Parented so the timer follows the link if it is moved to its own thread
+    _receiveFlushTimer.setParent(this);
+    _receiveFlushTimer.setSingleShot(true);
+    _receiveFlushTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_receiveFlushTimer, &QTimer::timeout, this, &LinkInterface::_flushReceiveBuffer);
+
+    if (_config) {
+        setReceiveCoalescing(_config->receiveCoalesceBytes(), _config->receiveCoalesceUSecs());
+        if (_config->signingEnabled()) {
+            setSigningKey(_config->signingKeyBytes(), _config->signingAllowUnsigned());
+        }
+        // Key changes made in settings apply to the open link as well
+        connect(_config.get(), &LinkConfiguration::signingChanged, this, &LinkInterface::_signingConfigChanged);
+    }
 }
 
 LinkInterface::~LinkInterface()
@@ -26,6 +43,7 @@ LinkInterface::~LinkInterface()
         qWarning() << "~LinkInterface still have vehicle references:" << _vehicleReferenceCount;
     }
     _config.reset();
+    delete _signing;
 }
 
 uint8_t LinkInterface::mavlinkChannel(void) const
@@ -43,6 +61,81 @@ void LinkInterface::_setMavlinkChannel(uint8_t channel)
     }
     _mavlinkChannelSet = true;
     _mavlinkChannel = channel;
+
+    QMutexLocker locker(&_signingMutex);
+    if (_signing) {
+        _signing->setLinkId(channel);
+    }
+}
+
+void LinkInterface::setSigningKey(const QByteArray& key, bool allowUnsigned)
+{
+    QMutexLocker locker(&_signingMutex);
+
+    delete _signing;
+    _signing = nullptr;
+    if (!key.isEmpty()) {
+        _signing = new MAVLinkSigning(key, allowUnsigned);
+        if (_mavlinkChannelSet) {
+            _signing->setLinkId(_mavlinkChannel);
+        }
+    }
+}
+
+void LinkInterface::_signingConfigChanged(void)
+{
+    QByteArray key = _config->signingKeyBytes();
+    bool allowUnsigned = _config->signingAllowUnsigned();
+
+    {
+        QMutexLocker locker(&_signingMutex);
+        if (_signing && !key.isEmpty() && _signing->secretKey() == key) {
+            // Same key, keep the replay protection state
+            _signing->setAllowUnsigned(allowUnsigned);
+            return;
+        }
+    }
+
+    qCDebug(MAVLinkSigningLog) << "Signing key changed on open link" << _config->name() << "enabled:" << !key.isEmpty();
+    setSigningKey(key, allowUnsigned);
+}
+
+bool LinkInterface::signingEnabled(void) const
+{
+    QMutexLocker locker(&_signingMutex);
+    return _signing != nullptr;
+}
+
+void LinkInterface::signMavlinkMessage(mavlink_message_t& message)
+{
+    QMutexLocker locker(&_signingMutex);
+    if (_signing) {
+        _signing->sign(message);
+    }
+}
+
+bool LinkInterface::verifyMavlinkMessage(const mavlink_message_t& message)
+{
+    QMutexLocker locker(&_signingMutex);
+    if (!_signing) {
+        return true;
+    }
+
+    MAVLinkSigning::VerifyResult_t result = _signing->verify(message);
+    if (result != MAVLinkSigning::VerifyOk) {
+        qCDebug(MAVLinkSigningLog) << "Dropping message" << message.msgid << "from" << message.sysid << message.compid << MAVLinkSigning::verifyResultString(result);
+        return false;
+    }
+    return true;
+}
+
+MAVLinkSigning::Stats_t LinkInterface::signingStats(void) const
+{
+    QMutexLocker locker(&_signingMutex);
+    if (_signing) {
+        return _signing->stats();
+    }
+    return MAVLinkSigning::Stats_t();
 }
 
 void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
@@ -70,6 +163,39 @@ void LinkInterface::removeVehicleReference(void)
     }
 }
 
+void LinkInterface::setReceiveCoalescing(int maxBytes, int maxUSecs)
+{
+    _flushReceiveBuffer();
+    _receiveBuffer.setCoalescing(maxBytes, maxUSecs);
+}
+
+void LinkInterface::_readBytesFromDevice(QIODevice* device)
+{
+    qint64 byteCount = device->bytesAvailable();
+    if (byteCount <= 0) {
+        return;
+    }
+
+    char*  data         = _receiveBuffer.writePointer(static_cast<int>(byteCount));
+    qint64 bytesRead    = device->read(data, byteCount);
+    _receiveBuffer.commit(static_cast<int>(qMax(bytesRead, static_cast<qint64>(0))));
+
+    if (_receiveBuffer.flushRequired()) {
+        _flushReceiveBuffer();
+    } else if (_receiveBuffer.pendingBytes() && !_receiveFlushTimer.isActive()) {
+        // Timer resolution is milliseconds, the microsecond limit is also checked on each read
+        _receiveFlushTimer.start(qMax(1, (_receiveBuffer.usecsUntilFlush() + 999) / 1000));
+    }
+}
+
+void LinkInterface::_flushReceiveBuffer(void)
+{
+    _receiveFlushTimer.stop();
+    if (_receiveBuffer.pendingBytes()) {
+        emit bytesReceived(this, _receiveBuffer.take());
+    }
+}
+
 void LinkInterface::_connectionRemoved(void)
 {
     if (_vehicleReferenceCount == 0) {
@@ -23,8 +23,11 @@
 #include "QGCMAVLink.h"
 #include "LinkConfiguration.h"
 #include "MavlinkMessagesTimer.h"
+#include "LinkReceiveBuffer.h"
+#include "MAVLinkSigning.h"
 
 class LinkManager;
+class QIODevice;
 
 /**
 * @brief The link interface defines the interface for all links used to communicate
@@ -64,6 +67,28 @@ public:
     void    addVehicleReference         (void);
     void    removeVehicleReference      (void);
 
+    /// Configures coalescing of small reads for stream based links. See LinkReceiveBuffer::setCoalescing.
+    void    setReceiveCoalescing        (int maxBytes, int maxUSecs);
+
+    /// @return Receive buffer statistics for this link: read calls, bytes, allocations
+    const LinkReceiveBuffer::Stats_t&   receiveStats        (void) const { return _receiveBuffer.stats(); }
+    double                              averageBytesPerRead (void) const { return _receiveBuffer.averageBytesPerRead(); }
+
+    /// Enables MAVLink 2 signing on this link. An empty key disables signing.
+    void    setSigningKey               (const QByteArray& key, bool allowUnsigned = false);
+    bool    signingEnabled              (void) const;
+
+    /// Signs an outgoing message if signing is enabled on this link. Must be called after the message is
+    /// finalized and before it is serialized. Thread safe.
+    void    signMavlinkMessage          (mavlink_message_t& message);
+
+    /// Checks the signature of an incoming message if signing is enabled on this link
+    ///     @return true: message should be processed, false: drop it
+    bool    verifyMavlinkMessage        (const mavlink_message_t& message);
+
+    /// @return Signing statistics, all zero if signing is not enabled
+    MAVLinkSigning::Stats_t signingStats(void) const;
+
 signals:
     void bytesReceived      (LinkInterface* link, QByteArray data);
     void bytesSent          (LinkInterface* link, QByteArray data);
@@ -77,6 +102,13 @@ protected:
 
     void _connectionRemoved(void);
 
+    /// Reads everything available from the device into the pooled receive buffer. Emits bytesReceived
+    /// right away unless read coalescing is enabled, in which case it is deferred until a limit is hit.
+    void _readBytesFromDevice(QIODevice* device);
+
+    /// Emits bytesReceived for any bytes held back by read coalescing
+    void _flushReceiveBuffer(void);
+
     SharedLinkConfigurationPtr _config;
 
 private:
@@ -86,6 +118,7 @@ private:
     virtual void _writeBytes(const QByteArray) = 0; // Not thread safe, only writeBytesThreadSafe is thread safe
 
     void _setMavlinkChannel(uint8_t channel);
+    void _signingConfigChanged(void);
 
     bool    _mavlinkChannelSet          = false;
     uint8_t _mavlinkChannel;
@@ -94,8 +127,13 @@ private:
     int     _vehicleReferenceCount      = 0;
 
     mutable QMutex _writeBytesMutex;
+    mutable QMutex _signingMutex;
+    MAVLinkSigning* _signing = nullptr;
 
     QMap<int /* vehicle id */, MavlinkMessagesTimer*> _mavlinkMessagesTimers;
+
+    LinkReceiveBuffer   _receiveBuffer;
+    QTimer              _receiveFlushTimer;     ///< Flushes coalesced reads once the time limit expires
 };
 
 typedef std::shared_ptr<LinkInterface>  SharedLinkInterfacePtr;
@@ -50,6 +50,7 @@ const int LinkManager::_autoconnectConnectDelayMSecs =  6000;
 #else
 const int LinkManager::_autoconnectConnectDelayMSecs =  1000;
 #endif
+const int LinkManager::_serialHotplugSettleMSecs =      100;
 
 LinkManager::LinkManager(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
@@ -68,6 +69,8 @@ LinkManager::LinkManager(QGCApplication* app, QGCToolbox* toolbox)
     qmlRegisterUncreatableType<LinkManager>         ("QGroundControl", 1, 0, "LinkManager",         "Reference only");
     qmlRegisterUncreatableType<LinkConfiguration>   ("QGroundControl", 1, 0, "LinkConfiguration",   "Reference only");
     qmlRegisterUncreatableType<LinkInterface>       ("QGroundControl", 1, 0, "LinkInterface",       "Reference only");
+
+    _autoconnectElapsedTimer.start();
 }
 
 LinkManager::~LinkManager()
@@ -89,6 +92,31 @@ void LinkManager::setToolbox(QGCToolbox *toolbox)
     connect(&_portListTimer, &QTimer::timeout, this, &LinkManager::_updateAutoConnectLinks);
     _portListTimer.start(_autoconnectUpdateTimerMSecs); // timeout must be long enough to get past bootloader on second pass
 
+#ifndef NO_SERIAL_LINK
+    // If hotplug notifications are available serial ports are only enumerated when something changed. Otherwise
+    // _updateAutoConnectLinks falls back to enumerating on every pass.
+    _serialPortScanTimer.setSingleShot(true);
+    connect(&_serialPortScanTimer,  &QTimer::timeout,                   this, &LinkManager::_updateAutoConnectSerialLinks);
+    connect(&_serialPortWatcher,    &SerialPortWatcher::portsChanged,   this, &LinkManager::_serialPortsChanged);
+    _serialPortWatcher.start();
+
+    // Settings changes can make an already present port eligible for auto-connect
+    QList<Fact*> rgAutoConnectFacts = {
+        _autoConnectSettings->autoConnectPixhawk(),
+        _autoConnectSettings->autoConnectSiKRadio(),
+        _autoConnectSettings->autoConnectPX4Flow(),
+        _autoConnectSettings->autoConnectLibrePilot(),
+        _autoConnectSettings->autoConnectRTKGPS(),
+        _autoConnectSettings->autoConnectNmeaPort(),
+        _autoConnectSettings->autoConnectNmeaBaud(),
+    };
+    for (Fact* fact: rgAutoConnectFacts) {
+        connect(fact, &Fact::rawValueChanged, this, [this]() { _scheduleSerialPortScan(0); });
+    }
+
+    // Pick up ports which are already present
+    _scheduleSerialPortScan(0);
+#endif
 }
 
 // This should only be used by Qml code
@@ -202,6 +230,13 @@ void LinkManager::_linkDisconnected(void)
     disconnect(link, &LinkInterface::bytesSent,           _mavlinkProtocol,    &MAVLinkProtocol::logSentBytes);
     disconnect(link, &LinkInterface::disconnected,        this,                &LinkManager::_linkDisconnected);
 
+#ifndef NO_SERIAL_LINK
+    if (link->linkConfiguration()->type() == LinkConfiguration::TypeSerial) {
+        // The port may still be present and eligible for auto-connect again
+        _scheduleSerialPortScan(_autoconnectUpdateTimerMSecs);
+    }
+#endif
+
     _freeMavlinkChannel(link->mavlinkChannel());
     for (int i=0; i<_rgLinks.count(); i++) {
         if (_rgLinks[i].get() == link) {
@@ -243,6 +278,14 @@ void LinkManager::setConnectionsSuspended(QString reason)
     _connectionsSuspendedReason = reason;
 }
 
+void LinkManager::setConnectionsAllowed(void)
+{
+    _connectionsSuspended = false;
+#ifndef NO_SERIAL_LINK
+    _scheduleSerialPortScan(0);
+#endif
+}
+
 void LinkManager::suspendConfigurationUpdates(bool suspend)
 {
     _configUpdateSuspended = suspend;
@@ -263,6 +306,10 @@ void LinkManager::saveLinkConfigurationList()
                 settings.setValue(root + "/type", linkConfig->type());
                 settings.setValue(root + "/auto", linkConfig->isAutoConnect());
                 settings.setValue(root + "/high_latency", linkConfig->isHighLatency());
+                settings.setValue(root + "/receive_coalesce_bytes", linkConfig->receiveCoalesceBytes());
+                settings.setValue(root + "/receive_coalesce_usecs", linkConfig->receiveCoalesceUSecs());
+                settings.setValue(root + "/signing_key", linkConfig->signingKey());
+                settings.setValue(root + "/signing_allow_unsigned", linkConfig->signingAllowUnsigned());
                 // Have the instance save its own values
                 linkConfig->saveSettings(settings, root);
             }
@@ -293,6 +340,10 @@ void LinkManager::loadLinkConfigurationList()
                             LinkConfiguration* link = nullptr;
                             bool autoConnect = settings.value(root + "/auto").toBool();
                             bool highLatency = settings.value(root + "/high_latency").toBool();
+                            int coalesceBytes = settings.value(root + "/receive_coalesce_bytes", 0).toInt();
+                            int coalesceUSecs = settings.value(root + "/receive_coalesce_usecs", 0).toInt();
+                            QString signingKey = settings.value(root + "/signing_key").toString();
+                            bool signingAllowUnsigned = settings.value(root + "/signing_allow_unsigned", false).toBool();
 
                             switch(type) {
 #ifndef NO_SERIAL_LINK
@@ -326,6 +377,10 @@ void LinkManager::loadLinkConfigurationList()
                                 //-- Have the instance load its own values
                                 link->setAutoConnect(autoConnect);
                                 link->setHighLatency(highLatency);
+                                link->setReceiveCoalesceBytes(coalesceBytes);
+                                link->setReceiveCoalesceUSecs(coalesceUSecs);
+                                link->setSigningKey(signingKey);
+                                link->setSigningAllowUnsigned(signingAllowUnsigned);
                                 link->loadSettings(settings, root);
                                 addConfiguration(link);
                             }
@@ -453,6 +508,21 @@ void LinkManager::_updateAutoConnectLinks(void)
 #endif
 
 #ifndef NO_SERIAL_LINK
+    if (!_serialPortWatcher.isEventDriven()) {
+        // No hotplug notifications available, we have to poll
+        _updateAutoConnectSerialLinks();
+    }
+#endif
+}
+
+void LinkManager::_updateAutoConnectSerialLinks(void)
+{
+#ifndef NO_SERIAL_LINK
+    if (_connectionsSuspended || qgcApp()->runningUnitTests()) {
+        return;
+    }
+
+    bool                        bootloaderWait = false;
     QStringList                 currentPorts;
     QList<QGCSerialPortInfo>    portList;
 #ifdef __android__
@@ -515,6 +585,7 @@ void LinkManager::_updateAutoConnectLinks(void)
                 if (portInfo.isBootloader()) {
                     // Don't connect to bootloader
                     qCDebug(LinkManagerLog) << "Waiting for bootloader to finish" << portInfo.systemLocation();
+                    bootloaderWait = true;
                     continue;
                 }
                 if (_portAlreadyConnected(portInfo.systemLocation()) || _autoConnectRTKPort == portInfo.systemLocation()) {
@@ -524,8 +595,8 @@ void LinkManager::_updateAutoConnectLinks(void)
                     // are in the bootloader is flaky from a cross-platform standpoint. So by putting it on a wait list
                     // and only connect on the second pass we leave enough time for the board to boot up.
                     qCDebug(LinkManagerLog) << "Waiting for next autoconnect pass" << portInfo.systemLocation();
-                    _autoconnectPortWaitList[portInfo.systemLocation()] = 1;
-                } else if (++_autoconnectPortWaitList[portInfo.systemLocation()] * _autoconnectUpdateTimerMSecs > _autoconnectConnectDelayMSecs) {
+                    _autoconnectPortWaitList[portInfo.systemLocation()] = _autoconnectElapsedTimer.elapsed();
+                } else if (_autoconnectElapsedTimer.elapsed() - _autoconnectPortWaitList[portInfo.systemLocation()] >= _autoconnectConnectDelayMSecs) {
                     SerialConfiguration* pSerialConfig = nullptr;
                     _autoconnectPortWaitList.remove(portInfo.systemLocation());
                     switch (boardType) {
@@ -586,9 +657,56 @@ void LinkManager::_updateAutoConnectLinks(void)
     }
 #endif
 
+    // Forget about ports which went away while waiting
+    for (const QString& portName: _autoconnectPortWaitList.keys()) {
+        if (!currentPorts.contains(portName)) {
+            _autoconnectPortWaitList.remove(portName);
+        }
+    }
+
+    if (_serialPortWatcher.isEventDriven()) {
+        // No polling pass is coming, so schedule another scan for ports which are still settling
+        int nextScanMSecs = bootloaderWait ? _autoconnectUpdateTimerMSecs : -1;
+        for (qint64 firstSeenMSecs: _autoconnectPortWaitList) {
+            int remainingMSecs = qMax(0, static_cast<int>(firstSeenMSecs + _autoconnectConnectDelayMSecs - _autoconnectElapsedTimer.elapsed()));
+            nextScanMSecs = nextScanMSecs == -1 ? remainingMSecs : qMin(nextScanMSecs, remainingMSecs);
+        }
+        if (nextScanMSecs != -1) {
+            _scheduleSerialPortScan(nextScanMSecs);
+        }
+    }
 #endif // NO_SERIAL_LINK
 }
 
+void LinkManager::_serialPortsChanged(void)
+{
+#ifndef NO_SERIAL_LINK
+    // Cached port lists are rebuilt on next access
+    _commPortList.clear();
+    _commPortDisplayList.clear();
+    emit commPortsChanged();
+    emit commPortStringsChanged();
+
+    if (_serialPortWatcher.isEventDriven()) {
+        // Give the device node a moment to settle (permissions, udev rules) before probing
+        _scheduleSerialPortScan(_serialHotplugSettleMSecs);
+    }
+#endif
+}
+
+#ifndef NO_SERIAL_LINK
+void LinkManager::_scheduleSerialPortScan(int delayMSecs)
+{
+    if (!_serialPortWatcher.isEventDriven()) {
+        // Polling pass will pick it up
+        return;
+    }
+    if (!_serialPortScanTimer.isActive() || _serialPortScanTimer.remainingTime() > delayMSecs) {
+        _serialPortScanTimer.start(delayMSecs);
+    }
+}
+#endif
+
 void LinkManager::shutdown(void)
 {
     setConnectionsSuspended(tr("Shutdown"));
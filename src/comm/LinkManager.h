@@ -9,9 +9,11 @@
 
 #pragma once
 
+#include <QElapsedTimer>
 #include <QList>
 #include <QMultiMap>
 #include <QMutex>
+#include <QTimer>
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
@@ -26,6 +28,7 @@
 
 #ifndef NO_SERIAL_LINK
     #include "SerialLink.h"
+    #include "SerialPortWatcher.h"
 #endif
 
 Q_DECLARE_LOGGING_CATEGORY(LinkManagerLog)
@@ -91,7 +94,7 @@ public:
     void setConnectionsSuspended(QString reason);
 
     /// Sets the flag to allow new connections to be made
-    void setConnectionsAllowed(void) { _connectionsSuspended = false; }
+    void setConnectionsAllowed(void);
 
     /// Creates, connects (and adds) a link  based on the given configuration instance.
     bool createConnectedLink(SharedLinkConfigurationPtr& config, bool isPX4Flow = false);
@@ -136,7 +139,9 @@ signals:
     void commPortsChanged();
 
 private slots:
-    void _linkDisconnected  (void);
+    void _linkDisconnected          (void);
+    void _updateAutoConnectSerialLinks(void);
+    void _serialPortsChanged        (void);
 
 private:
     QmlObjectListModel* _qmlLinkConfigurations      (void) { return &_qmlConfigurations; }
@@ -152,6 +157,7 @@ private:
 
 #ifndef NO_SERIAL_LINK
     bool                _portAlreadyConnected       (const QString& portName);
+    void                _scheduleSerialPortScan     (int delayMSecs);
 #endif
 
     bool                                _configUpdateSuspended;                     ///< true: stop updating configuration list
@@ -169,12 +175,15 @@ private:
     QString                             _autoConnectRTKPort;
     QmlObjectListModel                  _qmlConfigurations;
 
-    QMap<QString, int>                  _autoconnectPortWaitList;               ///< key: QGCSerialPortInfo::systemLocation, value: wait count
+    QMap<QString, qint64>               _autoconnectPortWaitList;               ///< key: QGCSerialPortInfo::systemLocation, value: _autoconnectElapsedTimer msecs when first seen
+    QElapsedTimer                       _autoconnectElapsedTimer;
     QStringList                         _commPortList;
     QStringList                         _commPortDisplayList;
 
 #ifndef NO_SERIAL_LINK
     QList<SerialLink*>                  _activeLinkCheckList;                   ///< List of links we are waiting for a vehicle to show up on
+    SerialPortWatcher                   _serialPortWatcher;
+    QTimer                              _serialPortScanTimer;                   ///< Single shot, used for serial port scans when hotplug events are available
 #endif
 
     // NMEA GPS device for GCS position
@@ -191,6 +200,7 @@ private:
     static const char*  _mavlinkForwardingLinkName;
     static const int    _autoconnectUpdateTimerMSecs;
     static const int    _autoconnectConnectDelayMSecs;
+    static const int    _serialHotplugSettleMSecs;
 
 };
 
@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkReceiveBuffer.h"
+
+LinkReceiveBuffer::LinkReceiveBuffer(void)
+{
+    resetStats();
+}
+
+void LinkReceiveBuffer::setCoalescing(int maxBytes, int maxUSecs)
+{
+    _coalesceMaxBytes = qMax(maxBytes, 0);
+    _coalesceMaxUSecs = qMax(maxUSecs, 0);
+}
+
+void LinkReceiveBuffer::resetStats(void)
+{
+    _stats.readCalls    = 0;
+    _stats.bytesRead    = 0;
+    _stats.buffersTaken = 0;
+    _stats.allocations  = 0;
+}
+
+int LinkReceiveBuffer::_acquire(void)
+{
+    // A slot is free for reuse once all receivers have released their shared copy of it
+    for (int i=0; i<_poolSize; i++) {
+        QByteArray& buffer = _pool[i];
+        if (buffer.capacity() && buffer.isDetached()) {
+            buffer.resize(0);   // Keeps the reserved capacity
+            return i;
+        }
+    }
+
+    // Nothing available, replace one of the slots. Any receiver still holding the old data keeps its own reference.
+    int slot = _nextVictim;
+    _nextVictim = (_nextVictim + 1) % _poolSize;
+
+    _pool[slot] = QByteArray();
+    _pool[slot].reserve(qMax(_initialCapacity, _coalesceMaxBytes));
+    _stats.allocations++;
+
+    return slot;
+}
+
+char* LinkReceiveBuffer::writePointer(int size)
+{
+    if (_current == -1) {
+        _current = _acquire();
+    }
+
+    QByteArray& buffer      = _pool[_current];
+    int         oldSize     = buffer.size();
+    int         oldCapacity = buffer.capacity();
+
+    if (oldSize == 0) {
+        _pendingTimer.start();
+    }
+    buffer.resize(oldSize + size);
+    _writeSize = size;
+    if (buffer.capacity() != oldCapacity) {
+        _stats.allocations++;
+    }
+
+    return buffer.data() + oldSize;
+}
+
+void LinkReceiveBuffer::commit(int bytesWritten)
+{
+    if (_current == -1) {
+        return;
+    }
+
+    QByteArray& buffer = _pool[_current];
+
+    // Give back whatever part of the write area wasn't used. Shrinking never reallocates.
+    bytesWritten = qBound(0, bytesWritten, _writeSize);
+    buffer.resize(buffer.size() - _writeSize + bytesWritten);
+    _writeSize = 0;
+
+    _stats.readCalls++;
+    _stats.bytesRead += static_cast<quint64>(bytesWritten);
+}
+
+bool LinkReceiveBuffer::flushRequired(void) const
+{
+    if (!pendingBytes()) {
+        return false;
+    }
+    if (!coalescing()) {
+        return true;
+    }
+    return _pool[_current].size() >= _coalesceMaxBytes || _pendingTimer.nsecsElapsed() / 1000 >= _coalesceMaxUSecs;
+}
+
+int LinkReceiveBuffer::usecsUntilFlush(void) const
+{
+    if (!pendingBytes()) {
+        return _coalesceMaxUSecs;
+    }
+    return static_cast<int>(qMax(static_cast<qint64>(0), _coalesceMaxUSecs - _pendingTimer.nsecsElapsed() / 1000));
+}
+
+QByteArray LinkReceiveBuffer::take(void)
+{
+    if (!pendingBytes()) {
+        return QByteArray();
+    }
+
+    // The returned copy shares storage with the pool slot
+    QByteArray bytes = _pool[_current];
+    _current = -1;
+    _stats.buffersTaken++;
+
+    return bytes;
+}
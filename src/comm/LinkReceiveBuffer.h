@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+
+/// Receive side buffering for links which read from a byte stream.
+///
+/// Reads go into a small pool of pre-sized buffers. The buffers handed out by take() are implicitly shared
+/// QByteArrays, so once every receiver has released its copy the pool slot is detached again and its storage
+/// is reused for the next read. In steady state this means no allocation per read.
+///
+/// Optionally small reads can be coalesced: bytes are held until either maxBytes are pending or the oldest
+/// pending byte is maxUSecs old. The owner is responsible for calling take() when the time limit expires.
+class LinkReceiveBuffer
+{
+public:
+    LinkReceiveBuffer(void);
+
+    typedef struct {
+        quint64 readCalls;          ///< Number of reads from the underlying device
+        quint64 bytesRead;          ///< Total bytes read
+        quint64 buffersTaken;       ///< Number of buffers handed on to the protocol layer
+        quint64 allocations;        ///< Number of times buffer storage had to be (re)allocated
+    } Stats_t;
+
+    /// Configures read coalescing. A value of 0 for either limit disables coalescing.
+    void setCoalescing(int maxBytes, int maxUSecs);
+
+    bool    coalescing          (void) const { return _coalesceMaxBytes > 0 && _coalesceMaxUSecs > 0; }
+    int     coalesceMaxBytes    (void) const { return _coalesceMaxBytes; }
+    int     coalesceMaxUSecs    (void) const { return _coalesceMaxUSecs; }
+
+    /// Returns a pointer to at least size writable bytes following the currently pending bytes. Must be
+    /// followed by a call to commit.
+    char* writePointer(int size);
+
+    /// Marks the specified number of bytes returned by writePointer as filled in.
+    void commit(int bytesWritten);
+
+    /// @return true: Pending bytes should be handed on now, either because coalescing is off or a limit has been reached
+    bool flushRequired(void) const;
+
+    /// @return Microseconds until the coalescing time limit for the pending bytes expires, 0 if already expired
+    int usecsUntilFlush(void) const;
+
+    bool pendingBytes(void) const { return _current != -1 && !_pool[_current].isEmpty(); }
+
+    /// Hands out the pending bytes and starts a new buffer on the next write. Returns an empty array if
+    /// nothing is pending.
+    QByteArray take(void);
+
+    const Stats_t&  stats       (void) const { return _stats; }
+    void            resetStats  (void);
+
+    /// @return Average number of bytes per device read
+    double averageBytesPerRead(void) const { return _stats.readCalls ? static_cast<double>(_stats.bytesRead) / _stats.readCalls : 0; }
+
+private:
+    int _acquire(void);
+
+    static const int    _poolSize           = 4;
+    static const int    _initialCapacity    = 4096;
+
+    QByteArray      _pool[_poolSize];
+    int             _current            = -1;   ///< Pool slot being filled, -1 for none
+    int             _writeSize          = 0;    ///< Size of the area handed out by the last writePointer call
+    int             _nextVictim         = 0;    ///< Slot which is replaced if all slots are still referenced
+    int             _coalesceMaxBytes   = 0;
+    int             _coalesceMaxUSecs   = 0;
+    QElapsedTimer   _pendingTimer;              ///< Started when the first byte of the current buffer arrives
+    Stats_t         _stats;
+};
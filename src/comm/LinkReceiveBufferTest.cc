@@ -0,0 +1,207 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkReceiveBufferTest.h"
+#include "LinkReceiveBuffer.h"
+#include "LinkManager.h"
+#include "QGCApplication.h"
+
+#include <QElapsedTimer>
+
+#if defined(Q_OS_LINUX) && !defined(__android__) && !defined(NO_SERIAL_LINK)
+#include "SerialLink.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#define QGC_LINK_PTY_BENCHMARK
+#endif
+
+static void _writeToBuffer(LinkReceiveBuffer& buffer, const QByteArray& bytes)
+{
+    char* data = buffer.writePointer(bytes.size() + 16);
+    memcpy(data, bytes.constData(), static_cast<size_t>(bytes.size()));
+    buffer.commit(bytes.size());
+}
+
+void LinkReceiveBufferTest::_poolReuseTest(void)
+{
+    LinkReceiveBuffer   buffer;
+    const QByteArray    chunk(100, 'x');
+
+    // Receiver releases each buffer right away: storage is allocated once and then reused
+    for (int i=0; i<100; i++) {
+        _writeToBuffer(buffer, chunk);
+        QVERIFY(buffer.flushRequired());
+        QByteArray bytes = buffer.take();
+        QCOMPARE(bytes, chunk);
+    }
+    QCOMPARE(buffer.stats().readCalls,      static_cast<quint64>(100));
+    QCOMPARE(buffer.stats().bytesRead,      static_cast<quint64>(100 * chunk.size()));
+    QCOMPARE(buffer.stats().buffersTaken,   static_cast<quint64>(100));
+    QCOMPARE(buffer.stats().allocations,    static_cast<quint64>(1));
+    QCOMPARE(buffer.averageBytesPerRead(),  static_cast<double>(chunk.size()));
+
+    // Receivers which hold on to buffers force new storage, but what they hold is never overwritten
+    buffer.resetStats();
+    QList<QByteArray> held;
+    for (int i=0; i<10; i++) {
+        _writeToBuffer(buffer, QByteArray(10, static_cast<char>('a' + i)));
+        held.append(buffer.take());
+    }
+    QVERIFY(buffer.stats().allocations >= 9);
+    for (int i=0; i<10; i++) {
+        QCOMPARE(held[i], QByteArray(10, static_cast<char>('a' + i)));
+    }
+
+    // Once released the pool is reused again
+    held.clear();
+    buffer.resetStats();
+    for (int i=0; i<10; i++) {
+        _writeToBuffer(buffer, chunk);
+        buffer.take();
+    }
+    QCOMPARE(buffer.stats().allocations, static_cast<quint64>(0));
+
+    QVERIFY(!buffer.pendingBytes());
+    QVERIFY(buffer.take().isEmpty());
+}
+
+void LinkReceiveBufferTest::_coalescingTest(void)
+{
+    LinkReceiveBuffer buffer;
+
+    buffer.setCoalescing(64, 1000000);
+    QVERIFY(buffer.coalescing());
+
+    // Held back until the byte limit is reached
+    for (int i=0; i<6; i++) {
+        _writeToBuffer(buffer, QByteArray(10, 'x'));
+        QVERIFY(!buffer.flushRequired());
+    }
+    QVERIFY(buffer.usecsUntilFlush() > 0);
+    _writeToBuffer(buffer, QByteArray(10, 'x'));
+    QVERIFY(buffer.flushRequired());
+    QCOMPARE(buffer.take().size(), 70);
+    QCOMPARE(buffer.stats().readCalls,      static_cast<quint64>(7));
+    QCOMPARE(buffer.stats().buffersTaken,   static_cast<quint64>(1));
+
+    // Held back until the time limit expires
+    buffer.setCoalescing(1024, 2000);
+    _writeToBuffer(buffer, QByteArray(10, 'x'));
+    QVERIFY(!buffer.flushRequired());
+    QTest::qSleep(5);
+    QVERIFY(buffer.flushRequired());
+    QCOMPARE(buffer.usecsUntilFlush(), 0);
+    QCOMPARE(buffer.take().size(), 10);
+
+    // Unused write space is given back
+    char* data = buffer.writePointer(100);
+    memset(data, 'y', 100);
+    buffer.commit(3);
+    QCOMPARE(buffer.take(), QByteArray(3, 'y'));
+
+    buffer.setCoalescing(0, 0);
+    QVERIFY(!buffer.coalescing());
+}
+
+void LinkReceiveBufferTest::_serialPtyBenchmark(void)
+{
+#ifdef QGC_LINK_PTY_BENCHMARK
+    _runPtyStream(0, 0);
+    _runPtyStream(1024, 2000);
+#else
+    QSKIP("Pseudo terminal benchmark is only supported on Linux");
+#endif
+}
+
+/// Streams synthetic mavlink traffic into a SerialLink through a pseudo terminal, trickled in small writes
+/// the way a serial device delivers it, and reports the receive buffer statistics.
+void LinkReceiveBufferTest::_runPtyStream(int coalesceBytes, int coalesceUSecs)
+{
+#ifdef QGC_LINK_PTY_BENCHMARK
+    const int cFrames       = 2000;
+    const int cWriteChunk   = 16;
+
+    int masterFd = ::posix_openpt(O_RDWR | O_NOCTTY);
+    QVERIFY(masterFd != -1);
+    QCOMPARE(::grantpt(masterFd), 0);
+    QCOMPARE(::unlockpt(masterFd), 0);
+    QString slavePath = QString::fromLocal8Bit(::ptsname(masterFd));
+
+    LinkManager*            linkManager = qgcApp()->toolbox()->linkManager();
+    SerialConfiguration*    serialConfig = new SerialConfiguration(QStringLiteral("PtyBenchmark"));
+    serialConfig->setPortName(slavePath);
+    serialConfig->setDynamic(true);
+    serialConfig->setReceiveCoalesceBytes(coalesceBytes);
+    serialConfig->setReceiveCoalesceUSecs(coalesceUSecs);
+    SharedLinkConfigurationPtr config = linkManager->addConfiguration(serialConfig);
+    QVERIFY(linkManager->createConnectedLink(config));
+
+    LinkInterface* link = config->link();
+    QVERIFY(link);
+
+    // Count without keeping the buffers, holding on to them would defeat the pool
+    qint64  bytesReceived   = 0;
+    int     signalCount     = 0;
+    QMetaObject::Connection conn = connect(link, &LinkInterface::bytesReceived, this, [&bytesReceived, &signalCount](LinkInterface*, QByteArray bytes) {
+        bytesReceived += bytes.size();
+        signalCount++;
+    });
+
+    mavlink_message_t msg;
+    uint8_t sendBuffer[MAVLINK_MAX_PACKET_LEN];
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 bytesSent = 0;
+    for (int i=0; i<cFrames; i++) {
+        mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, 0, &msg, static_cast<uint32_t>(i), 0.1f, 0.2f, 0.3f, 0, 0, 0);
+        int frameLength = mavlink_msg_to_send_buffer(sendBuffer, &msg);
+        for (int offset=0; offset<frameLength; offset+=cWriteChunk) {
+            ssize_t cBytes = ::write(masterFd, sendBuffer + offset, static_cast<size_t>(qMin(cWriteChunk, frameLength - offset)));
+            QVERIFY(cBytes > 0);
+            bytesSent += cBytes;
+        }
+        QCoreApplication::processEvents();
+    }
+
+    for (int i=0; i<200 && bytesReceived < bytesSent; i++) {
+        QTest::qWait(10);
+    }
+    qint64 elapsedUSecs = timer.nsecsElapsed() / 1000;
+
+    QCOMPARE(bytesReceived, bytesSent);
+
+    const LinkReceiveBuffer::Stats_t& stats = link->receiveStats();
+    qDebug() << "Coalescing bytes:usecs" << coalesceBytes << coalesceUSecs
+             << "bytes" << stats.bytesRead
+             << "reads" << stats.readCalls
+             << "avg bytes/read" << link->averageBytesPerRead()
+             << "bytesReceived signals" << signalCount
+             << "allocations" << stats.allocations
+             << "MB/s" << (elapsedUSecs ? static_cast<double>(stats.bytesRead) / elapsedUSecs : 0);
+
+    QCOMPARE(stats.bytesRead, static_cast<quint64>(bytesSent));
+    QCOMPARE(stats.buffersTaken, static_cast<quint64>(signalCount));
+    // Receivers release the buffers right away so the pool should not need to keep allocating
+    QVERIFY(stats.allocations < static_cast<quint64>(stats.readCalls / 10 + 10));
+    if (coalesceBytes) {
+        QVERIFY(stats.buffersTaken <= stats.readCalls);
+    }
+
+    disconnect(conn);
+    link->disconnect();
+    QTest::qWait(50);
+    ::close(masterFd);
+#else
+    Q_UNUSED(coalesceBytes)
+    Q_UNUSED(coalesceUSecs)
+#endif
+}
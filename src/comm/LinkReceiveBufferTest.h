@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Tests LinkReceiveBuffer pooling/coalescing and benchmarks SerialLink reads over a pseudo terminal
+class LinkReceiveBufferTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _poolReuseTest     (void);
+    void _coalescingTest    (void);
+    void _serialPtyBenchmark(void);
+
+private:
+    void _runPtyStream(int coalesceBytes, int coalesceUSecs);
+};
@@ -206,6 +206,11 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
 
     for (int position = 0; position < b.size(); position++) {
         if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &_message, &_status)) {
+            // Messages which fail signing checks are dropped before anything else gets to see them
+            if (!link->verifyMavlinkMessage(_message)) {
+                continue;
+            }
+
             // Got a valid message
             if (!link->decodedFirstMavlinkPacket()) {
                 link->setDecodedFirstMavlinkPacket(true);
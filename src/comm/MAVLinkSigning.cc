@@ -0,0 +1,388 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkSigning.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+
+#include <string.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define QGC_SHA256_X86
+#define QGC_SHA256_X86_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define QGC_SHA256_X86
+#define QGC_SHA256_X86_TARGET
+#endif
+
+QGC_LOGGING_CATEGORY(MAVLinkSigningLog, "MAVLinkSigningLog")
+
+namespace {
+
+const uint32_t _sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+typedef void (*Sha256Compress_t)(uint32_t state[8], const uint8_t* data, int blocks);
+
+inline uint32_t _sha256Rotr(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+void _sha256CompressPortable(uint32_t state[8], const uint8_t* data, int blocks)
+{
+    uint32_t w[64];
+
+    while (blocks-- > 0) {
+        for (int i=0; i<16; i++) {
+            w[i] = (static_cast<uint32_t>(data[i*4]) << 24) | (static_cast<uint32_t>(data[i*4+1]) << 16) | (static_cast<uint32_t>(data[i*4+2]) << 8) | data[i*4+3];
+        }
+        for (int i=16; i<64; i++) {
+            uint32_t s0 = _sha256Rotr(w[i-15], 7) ^ _sha256Rotr(w[i-15], 18) ^ (w[i-15] >> 3);
+            uint32_t s1 = _sha256Rotr(w[i-2], 17) ^ _sha256Rotr(w[i-2], 19) ^ (w[i-2] >> 10);
+            w[i] = w[i-16] + s0 + w[i-7] + s1;
+        }
+
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+        uint32_t f = state[5];
+        uint32_t g = state[6];
+        uint32_t h = state[7];
+
+        for (int i=0; i<64; i++) {
+            uint32_t t1 = h + (_sha256Rotr(e, 6) ^ _sha256Rotr(e, 11) ^ _sha256Rotr(e, 25)) + ((e & f) ^ (~e & g)) + _sha256K[i] + w[i];
+            uint32_t t2 = (_sha256Rotr(a, 2) ^ _sha256Rotr(a, 13) ^ _sha256Rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+
+        data += 64;
+    }
+}
+
+#ifdef QGC_SHA256_X86
+/// SHA-256 block compression using the x86 SHA extensions (sha256rnds2/msg1/msg2)
+QGC_SHA256_X86_TARGET void _sha256CompressX86(uint32_t state[8], const uint8_t* data, int blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The instructions want the state as ABEF/CDGH
+    __m128i tmp     = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1);  // CDAB
+    __m128i state1  = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B);  // EFGH
+    __m128i state0  = _mm_alignr_epi8(tmp, state1, 8);      // ABEF
+    state1          = _mm_blend_epi16(state1, tmp, 0xF0);   // CDGH
+
+    while (blocks-- > 0) {
+        const __m128i abefSave = state0;
+        const __m128i cdghSave = state1;
+        __m128i msg[4];
+
+        for (int i=0; i<4; i++) {
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i*16)), byteSwap);
+        }
+
+        // Four rounds per iteration, the message schedule is computed on the fly in a four entry window
+        for (int group=0; group<16; group++) {
+            __m128i& current = msg[group & 3];
+            __m128i  rounds  = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&_sha256K[group * 4])));
+
+            state1 = _mm_sha256rnds2_epu32(state1, state0, rounds);
+            if (group >= 3 && group <= 14) {
+                __m128i& next = msg[(group + 1) & 3];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(current, msg[(group - 1) & 3], 4));
+                next = _mm_sha256msg2_epu32(next, current);
+            }
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(rounds, 0x0E));
+            if (group >= 1 && group <= 12) {
+                __m128i& previous = msg[(group - 1) & 3];
+                previous = _mm_sha256msg1_epu32(previous, current);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+
+        data += 64;
+    }
+
+    tmp     = _mm_shuffle_epi32(state0, 0x1B);      // FEBA
+    state1  = _mm_shuffle_epi32(state1, 0xB1);      // DCHG
+    state0  = _mm_blend_epi16(tmp, state1, 0xF0);   // DCBA
+    state1  = _mm_alignr_epi8(state1, tmp, 8);      // HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+bool _x86ShaSupported(void)
+{
+    const unsigned int sse41Bit = 1u << 19;
+    const unsigned int ssse3Bit = 1u << 9;
+    const unsigned int shaBit   = 1u << 29;
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    unsigned int ecx1 = static_cast<unsigned int>(info[2]);
+    __cpuidex(info, 7, 0);
+    unsigned int ebx7 = static_cast<unsigned int>(info[1]);
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, nullptr) < 7 || !__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    unsigned int ecx1 = ecx;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    unsigned int ebx7 = ebx;
+#endif
+    return (ecx1 & sse41Bit) && (ecx1 & ssse3Bit) && (ebx7 & shaBit);
+}
+#endif
+
+Sha256Compress_t _selectCompress(void)
+{
+#ifdef QGC_SHA256_X86
+    if (_x86ShaSupported()) {
+        return _sha256CompressX86;
+    }
+#endif
+    return _sha256CompressPortable;
+}
+
+const Sha256Compress_t _hardwareCompress = _selectCompress();
+
+} // namespace
+
+MAVLinkSigning::MAVLinkSigning(const QByteArray& secretKey, bool allowUnsigned)
+    : _allowUnsigned(allowUnsigned)
+    , _timestamp    (currentTimestamp())
+{
+    memset(_secretKey, 0, sizeof(_secretKey));
+    memcpy(_secretKey, secretKey.constData(), static_cast<size_t>(qMin(secretKey.length(), keyLength)));
+    if (secretKey.length() != keyLength) {
+        qCWarning(MAVLinkSigningLog) << "Signing key should be" << keyLength << "bytes, got" << secretKey.length();
+    }
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool MAVLinkSigning::hardwareSha256(void)
+{
+    return _hardwareCompress != _sha256CompressPortable;
+}
+
+void MAVLinkSigning::sha256(const uint8_t* data, int length, uint8_t digest[32], bool useHardware)
+{
+    Sha256Compress_t compress = useHardware ? _hardwareCompress : _sha256CompressPortable;
+
+    uint32_t state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+    // Full blocks are hashed straight from the input, only the padded tail is copied
+    int fullBlocks = length / 64;
+    compress(state, data, fullBlocks);
+
+    uint8_t tail[128];
+    int     remaining   = length - (fullBlocks * 64);
+    int     tailBlocks  = remaining + 9 > 64 ? 2 : 1;
+
+    memcpy(tail, data + (fullBlocks * 64), static_cast<size_t>(remaining));
+    tail[remaining] = 0x80;
+    memset(tail + remaining + 1, 0, static_cast<size_t>((tailBlocks * 64) - remaining - 1 - 8));
+    quint64 bitLength = static_cast<quint64>(length) * 8;
+    for (int i=0; i<8; i++) {
+        tail[(tailBlocks * 64) - 1 - i] = static_cast<uint8_t>(bitLength >> (i * 8));
+    }
+    compress(state, tail, tailBlocks);
+
+    for (int i=0; i<8; i++) {
+        digest[i*4]     = static_cast<uint8_t>(state[i] >> 24);
+        digest[i*4+1]   = static_cast<uint8_t>(state[i] >> 16);
+        digest[i*4+2]   = static_cast<uint8_t>(state[i] >> 8);
+        digest[i*4+3]   = static_cast<uint8_t>(state[i]);
+    }
+}
+
+QByteArray MAVLinkSigning::keyFromPassphrase(const QString& passphrase)
+{
+    return QCryptographicHash::hash(passphrase.toUtf8(), QCryptographicHash::Sha256);
+}
+
+quint64 MAVLinkSigning::currentTimestamp(void)
+{
+    qint64 msecs = QDateTime::currentMSecsSinceEpoch() - static_cast<qint64>(_epoch2015MSecs);
+    return msecs > 0 ? static_cast<quint64>(msecs) * 100 : 0;
+}
+
+quint64 MAVLinkSigning::_timestampFromSignature(const uint8_t* signature)
+{
+    // Link id followed by 48 bit little endian timestamp
+    quint64 timestamp = 0;
+    for (int i=6; i>=1; i--) {
+        timestamp = (timestamp << 8) | signature[i];
+    }
+    return timestamp;
+}
+
+void MAVLinkSigning::_signature(const mavlink_message_t& message, uint8_t signature[6]) const
+{
+    // secret key + header (including magic) + payload + crc + link id + timestamp
+    const int   headerPayloadLength = MAVLINK_CORE_HEADER_LEN + 1 + message.len;
+    uint8_t     buffer[keyLength + MAVLINK_CORE_HEADER_LEN + 1 + MAVLINK_MAX_PAYLOAD_LEN + 2 + 7];
+    uint8_t*    p = buffer;
+
+    memcpy(p, _secretKey, keyLength);
+    p += keyLength;
+    // The header and payload are contiguous in mavlink_message_t, starting at magic
+    memcpy(p, &message.magic, static_cast<size_t>(headerPayloadLength));
+    p += headerPayloadLength;
+    memcpy(p, message.ck, 2);
+    p += 2;
+    memcpy(p, message.signature, 7);
+    p += 7;
+
+    uint8_t digest[32];
+    sha256(buffer, static_cast<int>(p - buffer), digest);
+    memcpy(signature, digest, 6);
+}
+
+bool MAVLinkSigning::sign(mavlink_message_t& message)
+{
+    if (message.magic != MAVLINK_STX) {
+        return false;
+    }
+    const mavlink_msg_entry_t* msgEntry = mavlink_get_msg_entry(message.msgid);
+    if (!msgEntry) {
+        qCWarning(MAVLinkSigningLog) << "Unable to sign unknown message id" << message.msgid;
+        return false;
+    }
+
+    // The signed flag is part of the header so the checksum has to be redone
+    message.incompat_flags |= MAVLINK_IFLAG_SIGNED;
+    uint16_t checksum = crc_calculate(&message.len, MAVLINK_CORE_HEADER_LEN);
+    crc_accumulate_buffer(&checksum, _MAV_PAYLOAD(&message), message.len);
+    crc_accumulate(msgEntry->crc_extra, &checksum);
+    message.checksum    = checksum;
+    message.ck[0]       = static_cast<uint8_t>(checksum & 0xFF);
+    message.ck[1]       = static_cast<uint8_t>(checksum >> 8);
+    mavlink_ck_a(&message) = message.ck[0];
+    mavlink_ck_b(&message) = message.ck[1];
+
+    // Timestamps must increase for every message and should track wall clock time
+    _timestamp = qMax(_timestamp + 1, currentTimestamp());
+
+    message.signature[0] = _linkId;
+    for (int i=0; i<6; i++) {
+        message.signature[1 + i] = static_cast<uint8_t>(_timestamp >> (i * 8));
+    }
+    _signature(message, &message.signature[7]);
+
+    _stats.signedOut++;
+    return true;
+}
+
+MAVLinkSigning::VerifyResult_t MAVLinkSigning::verify(const mavlink_message_t& message)
+{
+    if (!(message.incompat_flags & MAVLINK_IFLAG_SIGNED)) {
+        // SiK radios inject unsigned RADIO_STATUS messages into the stream, these are always accepted
+        if (_allowUnsigned || message.msgid == MAVLINK_MSG_ID_RADIO_STATUS) {
+            _stats.unsignedAccepted++;
+            return VerifyOk;
+        }
+        _stats.unsignedRejected++;
+        return VerifyUnsigned;
+    }
+
+    // Cheap timestamp checks first so replayed traffic never gets hashed
+    const uint8_t*  signature   = message.signature;
+    const quint64   timestamp   = _timestampFromSignature(signature);
+    const quint32   streamKey   = _streamKey(signature[0], message.sysid, message.compid);
+
+    auto stream = _streams.constFind(streamKey);
+    if (stream != _streams.constEnd()) {
+        if (timestamp <= stream.value()) {
+            _stats.replayed++;
+            return VerifyReplay;
+        }
+    } else {
+        if (_streams.count() >= _maxStreams) {
+            _stats.replayed++;
+            return VerifyTooManyStreams;
+        }
+        if (timestamp + _newStreamMaxAge < _timestamp) {
+            _stats.replayed++;
+            return VerifyOldTimestamp;
+        }
+    }
+
+    uint8_t expected[6];
+    _signature(message, expected);
+    if (memcmp(expected, &signature[7], sizeof(expected)) != 0) {
+        _stats.badSignature++;
+        return VerifyBadSignature;
+    }
+
+    _streams[streamKey] = timestamp;
+    if (timestamp > _timestamp) {
+        _timestamp = timestamp;
+    }
+    _stats.verified++;
+
+    return VerifyOk;
+}
+
+const char* MAVLinkSigning::verifyResultString(VerifyResult_t result)
+{
+    switch (result) {
+    case VerifyOk:
+        return "Ok";
+    case VerifyUnsigned:
+        return "Unsigned";
+    case VerifyBadSignature:
+        return "Bad signature";
+    case VerifyReplay:
+        return "Replay";
+    case VerifyOldTimestamp:
+        return "Old timestamp";
+    case VerifyTooManyStreams:
+        return "Too many streams";
+    }
+    return "Unknown";
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+#include "QGCMAVLink.h"
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkSigningLog)
+
+/// MAVLink 2 message signing state for a single link: signs outgoing messages and verifies the signature
+/// and timestamp of incoming ones (https://mavlink.io/en/guide/message_signing.html).
+///
+/// Verification runs for every message received on a signed link so it is kept cheap: replayed and stale
+/// timestamps are rejected before any hashing is done, and the signature hash is computed in one pass over a
+/// contiguous buffer using the SHA extensions of the cpu where available.
+///
+/// Not thread safe, LinkInterface serializes access.
+class MAVLinkSigning
+{
+public:
+    /// @param secretKey 32 byte secret key
+    /// @param allowUnsigned true: unsigned incoming messages are accepted as well
+    MAVLinkSigning(const QByteArray& secretKey, bool allowUnsigned = false);
+
+    typedef enum {
+        VerifyOk,
+        VerifyUnsigned,             ///< Message is not signed and unsigned messages are not accepted
+        VerifyBadSignature,         ///< Signature does not match the message contents
+        VerifyReplay,               ///< Timestamp is not newer than the last one seen for the stream
+        VerifyOldTimestamp,         ///< First message of a new stream with a timestamp too far in the past
+        VerifyTooManyStreams,       ///< Stream table is full
+    } VerifyResult_t;
+
+    typedef struct {
+        quint64 signedOut;          ///< Outgoing messages signed
+        quint64 verified;           ///< Incoming signed messages which passed verification
+        quint64 unsignedAccepted;   ///< Incoming unsigned messages which were let through
+        quint64 unsignedRejected;
+        quint64 badSignature;
+        quint64 replayed;           ///< Replayed or stale timestamps, including new streams which are too old
+    } Stats_t;
+
+    static const int keyLength = 32;
+
+    bool            allowUnsigned       (void) const { return _allowUnsigned; }
+    uint8_t         linkId              (void) const { return _linkId; }
+    quint64         timestamp           (void) const { return _timestamp; }
+    const Stats_t&  stats               (void) const { return _stats; }
+    QByteArray      secretKey           (void) const { return QByteArray(reinterpret_cast<const char*>(_secretKey), keyLength); }
+
+    void            setAllowUnsigned    (bool allowUnsigned)    { _allowUnsigned = allowUnsigned; }
+    void            setLinkId           (uint8_t linkId)        { _linkId = linkId; }
+
+    /// Signs a finalized MAVLink 2 message in place. Since the incompat flags are covered by the checksum it is
+    /// recalculated as well. MAVLink 1 messages can't be signed and are left alone.
+    ///     @return false: message could not be signed
+    bool sign(mavlink_message_t& message);
+
+    /// Verifies an incoming message and updates the per stream replay protection on success
+    VerifyResult_t verify(const mavlink_message_t& message);
+
+    /// Forgets all known streams
+    void resetStreams(void) { _streams.clear(); }
+
+    /// @return 32 byte key derived from a passphrase (SHA-256 of the UTF-8 passphrase), as done by other ground stations
+    static QByteArray keyFromPassphrase(const QString& passphrase);
+
+    /// @return Current time in MAVLink signing timestamp units: 10us since 1st January 2015 GMT
+    static quint64 currentTimestamp(void);
+
+    /// One shot SHA-256 of a contiguous buffer
+    ///     @param useHardware false: force the portable implementation (used for testing)
+    static void sha256(const uint8_t* data, int length, uint8_t digest[32], bool useHardware = true);
+
+    /// @return true: the cpu SHA extensions are used for hashing
+    static bool hardwareSha256(void);
+
+    static const char* verifyResultString(VerifyResult_t result);
+
+private:
+    /// Computes the 6 byte signature of the message with the link id and timestamp already in message.signature
+    void _signature(const mavlink_message_t& message, uint8_t signature[6]) const;
+
+    static quint64  _timestampFromSignature (const uint8_t* signature);
+    static quint32  _streamKey              (uint8_t linkId, uint8_t sysid, uint8_t compid) { return (static_cast<quint32>(linkId) << 16) | (static_cast<quint32>(sysid) << 8) | compid; }
+
+    uint8_t                 _secretKey[keyLength];
+    bool                    _allowUnsigned;
+    uint8_t                 _linkId         = 0;
+    quint64                 _timestamp;                 ///< Last timestamp used or seen, never goes backwards
+    QHash<quint32, quint64> _streams;                   ///< Last timestamp per (link id, sysid, compid)
+    Stats_t                 _stats;
+
+    static const int        _maxStreams             = 64;
+    static const quint64    _newStreamMaxAge        = 6000 * 1000;  ///< One minute in 10us units
+    static const quint64    _epoch2015MSecs         = 1420070400000;
+};
@@ -0,0 +1,304 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkSigningTest.h"
+#include "MAVLinkSigning.h"
+#include "MockLink.h"
+#include "LinkManager.h"
+#include "QGCApplication.h"
+
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+
+static const char* _testPassphrase = "qgc signing test";
+
+static mavlink_message_t _attitudeMessage(uint32_t timeBootMs, uint8_t sysid = 1)
+{
+    // Packed as MAVLink 2 on a private status, so the shared channel status used by the rest of the app and tests is left alone
+    static mavlink_status_t status = {};
+
+    mavlink_message_t   message;
+    mavlink_attitude_t  attitude = { timeBootMs, 0.1f, 0.2f, 0.3f, 0.01f, 0.02f, 0.03f };
+
+    memcpy(_MAV_PAYLOAD_NON_CONST(&message), &attitude, MAVLINK_MSG_ID_ATTITUDE_LEN);
+    message.msgid = MAVLINK_MSG_ID_ATTITUDE;
+    mavlink_finalize_message_buffer(&message, sysid, MAV_COMP_ID_AUTOPILOT1, &status, MAVLINK_MSG_ID_ATTITUDE_MIN_LEN, MAVLINK_MSG_ID_ATTITUDE_LEN, MAVLINK_MSG_ID_ATTITUDE_CRC);
+
+    return message;
+}
+
+/// Signature as described by the MAVLink spec, computed independently from MAVLinkSigning
+static QByteArray _referenceSignature(const QByteArray& key, const mavlink_message_t& message)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+
+    hash.addData(key);
+    hash.addData(reinterpret_cast<const char*>(&message.magic), MAVLINK_CORE_HEADER_LEN + 1 + message.len);
+    hash.addData(reinterpret_cast<const char*>(message.ck), 2);
+    hash.addData(reinterpret_cast<const char*>(message.signature), 7);
+
+    return hash.result().left(6);
+}
+
+void MAVLinkSigningTest::_sha256Test(void)
+{
+    const struct {
+        const char* input;
+        const char* digest;
+    } rgVectors[] = {
+        { "",       "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+        { "abc",    "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+        { "abcdbcdecdefdefgefghfghighijhijkijkljklmmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    };
+
+    uint8_t digest[32];
+    for (const auto& vector: rgVectors) {
+        for (bool useHardware: { true, false }) {
+            MAVLinkSigning::sha256(reinterpret_cast<const uint8_t*>(vector.input), static_cast<int>(strlen(vector.input)), digest, useHardware);
+            QCOMPARE(QByteArray(reinterpret_cast<const char*>(digest), 32).toHex(), QByteArray(vector.digest));
+        }
+    }
+
+    // Cover all the padding cases, hardware and portable paths must agree with each other and with Qt
+    QByteArray data;
+    for (int length=0; length<=300; length++) {
+        uint8_t hardwareDigest[32];
+        MAVLinkSigning::sha256(reinterpret_cast<const uint8_t*>(data.constData()), data.length(), hardwareDigest, true);
+        MAVLinkSigning::sha256(reinterpret_cast<const uint8_t*>(data.constData()), data.length(), digest, false);
+        QCOMPARE(memcmp(hardwareDigest, digest, sizeof(digest)), 0);
+        QCOMPARE(QByteArray(reinterpret_cast<const char*>(digest), 32), QCryptographicHash::hash(data, QCryptographicHash::Sha256));
+        data.append(static_cast<char>((length * 7) ^ 0x5A));
+    }
+
+    qDebug() << "Hardware SHA-256:" << MAVLinkSigning::hardwareSha256();
+}
+
+void MAVLinkSigningTest::_signVerifyTest(void)
+{
+    const QByteArray key = MAVLinkSigning::keyFromPassphrase(_testPassphrase);
+    QCOMPARE(key.length(), MAVLinkSigning::keyLength);
+
+    MAVLinkSigning sender(key);
+    MAVLinkSigning receiver(key);
+    sender.setLinkId(3);
+
+    mavlink_message_t message = _attitudeMessage(1000);
+    QVERIFY(sender.sign(message));
+    QVERIFY(message.incompat_flags & MAVLINK_IFLAG_SIGNED);
+    QCOMPARE(message.signature[0], static_cast<uint8_t>(3));
+    QCOMPARE(QByteArray(reinterpret_cast<const char*>(&message.signature[7]), 6), _referenceSignature(key, message));
+    QCOMPARE(sender.stats().signedOut, static_cast<quint64>(1));
+
+    QCOMPARE(receiver.verify(message), MAVLinkSigning::VerifyOk);
+    QCOMPARE(receiver.stats().verified, static_cast<quint64>(1));
+
+    // Same message again is a replay
+    QCOMPARE(receiver.verify(message), MAVLinkSigning::VerifyReplay);
+
+    // Newer messages keep verifying, timestamps increase even if sent within the same clock tick
+    mavlink_message_t message2 = _attitudeMessage(1001);
+    mavlink_message_t message3 = _attitudeMessage(1002);
+    sender.sign(message2);
+    sender.sign(message3);
+    QCOMPARE(receiver.verify(message2), MAVLinkSigning::VerifyOk);
+    QCOMPARE(receiver.verify(message3), MAVLinkSigning::VerifyOk);
+
+    // Out of order delivery of an older message is rejected as well
+    mavlink_message_t message4 = _attitudeMessage(1003);
+    mavlink_message_t message5 = _attitudeMessage(1004);
+    sender.sign(message4);
+    sender.sign(message5);
+    QCOMPARE(receiver.verify(message5), MAVLinkSigning::VerifyOk);
+    QCOMPARE(receiver.verify(message4), MAVLinkSigning::VerifyReplay);
+
+    // Tampered payload
+    mavlink_message_t tampered = _attitudeMessage(1005);
+    sender.sign(tampered);
+    _MAV_PAYLOAD_NON_CONST(&tampered)[4] ^= 0x01;
+    QCOMPARE(receiver.verify(tampered), MAVLinkSigning::VerifyBadSignature);
+
+    // Wrong key
+    MAVLinkSigning otherSender(MAVLinkSigning::keyFromPassphrase("wrong"));
+    mavlink_message_t wrongKey = _attitudeMessage(1006, 2);
+    otherSender.sign(wrongKey);
+    QCOMPARE(receiver.verify(wrongKey), MAVLinkSigning::VerifyBadSignature);
+    QCOMPARE(receiver.stats().badSignature, static_cast<quint64>(2));
+
+    // A new stream which starts with a timestamp more than a minute old is rejected
+    mavlink_message_t stale = _attitudeMessage(1007, 3);
+    stale.incompat_flags |= MAVLINK_IFLAG_SIGNED;
+    quint64 staleTimestamp = MAVLinkSigning::currentTimestamp() - (120 * 100000);
+    stale.signature[0] = 0;
+    for (int i=0; i<6; i++) {
+        stale.signature[1 + i] = static_cast<uint8_t>(staleTimestamp >> (i * 8));
+    }
+    memcpy(&stale.signature[7], _referenceSignature(key, stale).constData(), 6);
+    QCOMPARE(receiver.verify(stale), MAVLinkSigning::VerifyOldTimestamp);
+
+    // Unsigned messages
+    mavlink_message_t unsignedMessage = _attitudeMessage(1008);
+    QCOMPARE(receiver.verify(unsignedMessage), MAVLinkSigning::VerifyUnsigned);
+    mavlink_message_t radioStatus;
+    mavlink_msg_radio_status_pack_chan(1, MAV_COMP_ID_UDP_BRIDGE, 0, &radioStatus, 100, 100, 50, 10, 10, 0, 0);
+    QCOMPARE(receiver.verify(radioStatus), MAVLinkSigning::VerifyOk);
+    receiver.setAllowUnsigned(true);
+    QCOMPARE(receiver.verify(unsignedMessage), MAVLinkSigning::VerifyOk);
+    QCOMPARE(receiver.stats().unsignedRejected, static_cast<quint64>(1));
+    QCOMPARE(receiver.stats().unsignedAccepted, static_cast<quint64>(2));
+}
+
+void MAVLinkSigningTest::_parserRoundTripTest(void)
+{
+    const QByteArray key = MAVLinkSigning::keyFromPassphrase(_testPassphrase);
+
+    MAVLinkSigning sender(key);
+    MAVLinkSigning receiver(key);
+
+    // The checksum is redone when signing, make sure the real parser still accepts the message
+    mavlink_message_t message = _attitudeMessage(2000);
+    QVERIFY(sender.sign(message));
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int     cBuffer = mavlink_msg_to_send_buffer(buffer, &message);
+    QCOMPARE(cBuffer, MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len + MAVLINK_SIGNATURE_BLOCK_LEN);
+
+    mavlink_message_t   rxBuffer;
+    mavlink_status_t    rxStatus;
+    mavlink_message_t   rxMessage;
+    mavlink_status_t    rxStatusOut;
+    memset(&rxBuffer, 0, sizeof(rxBuffer));
+    memset(&rxStatus, 0, sizeof(rxStatus));
+
+    int framing = MAVLINK_FRAMING_INCOMPLETE;
+    for (int i=0; i<cBuffer; i++) {
+        framing = mavlink_frame_char_buffer(&rxBuffer, &rxStatus, buffer[i], &rxMessage, &rxStatusOut);
+    }
+    QCOMPARE(framing, static_cast<int>(MAVLINK_FRAMING_OK));
+    QCOMPARE(receiver.verify(rxMessage), MAVLinkSigning::VerifyOk);
+}
+
+void MAVLinkSigningTest::_mockLinkSigningTest(void)
+{
+    const QByteArray key = MAVLinkSigning::keyFromPassphrase(_testPassphrase);
+
+    _connectMockLink();
+
+    // Vehicle first, so everything QGC sees from here on is signed
+    _mockLink->setVehicleSigning(MockLink::VehicleSigningValid, key);
+    QTest::qWait(200);
+    _mockLink->setSigningKey(key);
+    QVERIFY(_mockLink->signingEnabled());
+
+    QTest::qWait(1000);
+    MAVLinkSigning::Stats_t stats = _mockLink->signingStats();
+    QVERIFY(stats.verified > 0);
+    QVERIFY(stats.signedOut > 0);       // GCS heartbeat at least
+    QCOMPARE(stats.badSignature,    static_cast<quint64>(0));
+    QCOMPARE(stats.replayed,        static_cast<quint64>(0));
+
+    // Tampered signatures are dropped
+    _mockLink->setVehicleSigning(MockLink::VehicleSigningTampered, key);
+    QTest::qWait(1000);
+    MAVLinkSigning::Stats_t tamperedStats = _mockLink->signingStats();
+    QVERIFY(tamperedStats.badSignature > 0);
+
+    // Replays are dropped while the originals get through
+    _mockLink->setVehicleSigning(MockLink::VehicleSigningReplayed, key);
+    QTest::qWait(1000);
+    MAVLinkSigning::Stats_t replayedStats = _mockLink->signingStats();
+    QVERIFY(replayedStats.replayed > 0);
+    QVERIFY(replayedStats.verified > tamperedStats.verified);
+
+    // Unsigned traffic is dropped
+    _mockLink->setVehicleSigning(MockLink::VehicleSigningOff);
+    QTest::qWait(1000);
+    QVERIFY(_mockLink->signingStats().unsignedRejected > 0);
+
+    // Key changes made through the link settings apply to the open link. The vehicle still signs with the old
+    // key so all of its traffic now fails verification.
+    _mockLink->setVehicleSigning(MockLink::VehicleSigningValid, key);
+    LinkManager*        linkManager     = qgcApp()->toolbox()->linkManager();
+    LinkConfiguration*  config          = _mockLink->linkConfiguration().get();
+    LinkConfiguration*  editedConfig    = linkManager->startConfigurationEditing(config);
+    editedConfig->setSigningPassphrase(QStringLiteral("changed passphrase"));
+    linkManager->endConfigurationEditing(config, editedConfig);
+    QVERIFY(_mockLink->signingEnabled());
+    QTest::qWait(1000);
+    MAVLinkSigning::Stats_t changedKeyStats = _mockLink->signingStats();
+    QVERIFY(changedKeyStats.badSignature > 0);
+    QCOMPARE(changedKeyStats.verified, static_cast<quint64>(0));
+
+    editedConfig = linkManager->startConfigurationEditing(config);
+    editedConfig->setSigningKey(QString());
+    linkManager->endConfigurationEditing(config, editedConfig);
+    QVERIFY(!_mockLink->signingEnabled());
+
+    _disconnectMockLink();
+}
+
+void MAVLinkSigningTest::_throughputBenchmark(void)
+{
+    const int           cMessages   = 20000;
+    const QByteArray    key         = MAVLinkSigning::keyFromPassphrase(_testPassphrase);
+
+    // Build the same traffic unsigned and signed
+    QByteArray      unsignedStream;
+    QByteArray      signedStream;
+    MAVLinkSigning  sender(key);
+    uint8_t         buffer[MAVLINK_MAX_PACKET_LEN];
+
+    for (int i=0; i<cMessages; i++) {
+        mavlink_message_t message = _attitudeMessage(static_cast<uint32_t>(i));
+        unsignedStream.append(reinterpret_cast<const char*>(buffer), mavlink_msg_to_send_buffer(buffer, &message));
+        sender.sign(message);
+        signedStream.append(reinterpret_cast<const char*>(buffer), mavlink_msg_to_send_buffer(buffer, &message));
+    }
+
+    for (bool signing: { false, true }) {
+        const QByteArray&   stream = signing ? signedStream : unsignedStream;
+        MAVLinkSigning      receiver(key);
+        mavlink_message_t   rxBuffer;
+        mavlink_status_t    rxStatus;
+        mavlink_message_t   rxMessage;
+        mavlink_status_t    rxStatusOut;
+        int                 cReceived = 0;
+
+        memset(&rxBuffer, 0, sizeof(rxBuffer));
+        memset(&rxStatus, 0, sizeof(rxStatus));
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i=0; i<stream.length(); i++) {
+            if (mavlink_frame_char_buffer(&rxBuffer, &rxStatus, static_cast<uint8_t>(stream[i]), &rxMessage, &rxStatusOut) == MAVLINK_FRAMING_OK) {
+                if (!signing || receiver.verify(rxMessage) == MAVLinkSigning::VerifyOk) {
+                    cReceived++;
+                }
+            }
+        }
+        qint64 elapsedNSecs = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+
+        QCOMPARE(cReceived, cMessages);
+        qDebug() << (signing ? "Signed:" : "Unsigned:") << cMessages << "messages" << stream.length() << "bytes"
+                 << "msgs/sec" << static_cast<qint64>(cMessages * 1e9 / elapsedNSecs)
+                 << "ns/msg" << elapsedNSecs / cMessages;
+    }
+
+    // Raw hash cost for a typical signed message, hardware vs portable
+    uint8_t digest[32];
+    uint8_t data[32 + 10 + 28 + 2 + 7] = {};
+    for (bool useHardware: { true, false }) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i=0; i<cMessages; i++) {
+            data[0] = static_cast<uint8_t>(i);
+            MAVLinkSigning::sha256(data, static_cast<int>(sizeof(data)), digest, useHardware);
+        }
+        qDebug() << (useHardware ? "sha256 default path:" : "sha256 portable:") << timer.nsecsElapsed() / cMessages << "ns/hash";
+    }
+}
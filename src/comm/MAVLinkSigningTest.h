@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Tests MAVLink 2 message signing and verification
+class MAVLinkSigningTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _sha256Test            (void);
+    void _signVerifyTest        (void);
+    void _parserRoundTripTest   (void);
+    void _mockLinkSigningTest   (void);
+    void _throughputBenchmark   (void);
+};
@@ -112,6 +112,7 @@ MockLink::MockLink(SharedLinkConfigurationPtr& config)
 MockLink::~MockLink(void)
 {
     disconnect();
+    delete _vehicleSigning;
     if (!_logDownloadFilename.isEmpty()) {
         QFile::remove(_logDownloadFilename);
     }
@@ -222,8 +223,10 @@ void MockLink::_run500HzTasks(void)
     }
 
     if (_mavlinkStarted && _connected) {
+        _linkLatencyWorker();
         _paramRequestListWorker();
         _logDownloadWorker();
+        _ulogStreamWorker();
     }
 }
 
@@ -487,10 +490,59 @@ void MockLink::respondWithMavlinkMessage(const mavlink_message_t& msg)
 {
     if (!_commLost) {
         uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        int     cBuffer;
+        bool    replay = false;
+
+        _vehicleSigningMutex.lock();
+        if (_vehicleSigningMode == VehicleSigningOff) {
+            cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
+        } else {
+            mavlink_message_t signedMsg = msg;
+            _vehicleSigning->sign(signedMsg);
+            if (_vehicleSigningMode == VehicleSigningTampered) {
+                // Corrupting the signature leaves the crc intact so the message makes it through the parser
+                signedMsg.signature[MAVLINK_SIGNATURE_BLOCK_LEN - 1] ^= 0xFF;
+            }
+            replay = _vehicleSigningMode == VehicleSigningReplayed;
+            cBuffer = mavlink_msg_to_send_buffer(buffer, &signedMsg);
+        }
+        _vehicleSigningMutex.unlock();
 
-        int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
         QByteArray bytes((char *)buffer, cBuffer);
+
+        {
+            QMutexLocker locker(&_linkQualityMutex);
+
+            if (_linkDropMessage(_linkSentCount)) {
+                return;
+            }
+            if (_linkLatencyMsecs > 0 || !_linkDelayedBytes.isEmpty()) {
+                // Delivered by _linkLatencyWorker, messages queued before a latency change still go out first
+                const qint64 deliveryMsecs = _runningTime.elapsed() + _linkLatencyMsecs;
+                _linkDelayedBytes.append(qMakePair(deliveryMsecs, bytes));
+                if (replay) {
+                    _linkDelayedBytes.append(qMakePair(deliveryMsecs, bytes));
+                }
+                return;
+            }
+        }
+
         emit bytesReceived(this, bytes);
+        if (replay) {
+            emit bytesReceived(this, bytes);
+        }
+    }
+}
+
+void MockLink::setVehicleSigning(VehicleSigningMode_t mode, const QByteArray& key)
+{
+    QMutexLocker locker(&_vehicleSigningMutex);
+
+    delete _vehicleSigning;
+    _vehicleSigning     = nullptr;
+    _vehicleSigningMode = mode;
+    if (mode != VehicleSigningOff) {
+        _vehicleSigning = new MAVLinkSigning(key);
     }
 }
 
@@ -551,6 +603,13 @@ void MockLink::_handleIncomingMavlinkBytes(const uint8_t* bytes, int cBytes)
             continue;
         }
 
+        _linkQualityMutex.lock();
+        const bool drop = _linkDropMessage(_linkReceivedCount);
+        _linkQualityMutex.unlock();
+        if (drop) {
+            continue;
+        }
+
         if (_missionItemHandler.handleMessage(msg)) {
             continue;
         }
@@ -1287,6 +1346,28 @@ void MockLink::_sendStatusTextMessages(void)
     _sendChunkedStatusText(4, true /* missingChunks */);    // This should cause the timeout to fire
 }
 
+void MockLink::sendStatusTextFlood(int count)
+{
+    mavlink_message_t msg;
+
+    for (int i=0; i<count; i++) {
+        char msgBuf[MAVLINK_MSG_STATUSTEXT_FIELD_TEXT_LEN];
+
+        memset(msgBuf, 0, sizeof(msgBuf));
+        snprintf(msgBuf, sizeof(msgBuf), "Flood %d", i);
+
+        mavlink_msg_statustext_pack_chan(_vehicleSystemId,
+                                         _vehicleComponentId,
+                                         _mavlinkChannel,
+                                         &msg,
+                                         static_cast<uint8_t>(i % (MAV_SEVERITY_DEBUG + 1)),
+                                         msgBuf,
+                                         0,                     // Not a chunked sequence
+                                         0);                    // Not a chunked sequence
+        respondWithMavlinkMessage(msg);
+    }
+}
+
 MockConfiguration::MockConfiguration(const QString& name)
     : LinkConfiguration(name)
 {
@@ -1542,6 +1623,132 @@ void MockLink::_logDownloadWorker(void)
     }
 }
 
+void MockLink::startULogStream(const QByteArray& ulog, int bytesPerSecond, int dropInterval)
+{
+    QMutexLocker locker(&_ulogStreamMutex);
+
+    _ulogStream                 = ulog;
+    _ulogStreamOffset           = 0;
+    _ulogStreamStartIndex       = 0;
+    _ulogStreamBytesPerSecond   = bytesPerSecond;
+    _ulogStreamDropInterval     = dropInterval;
+    _ulogStreamSequence         = 0;
+
+    // The file header is followed by messages which each start with their uint16 payload length
+    _ulogStreamMessageStarts.clear();
+    for (int offset = 16; offset + 3 <= ulog.length(); ) {
+        _ulogStreamMessageStarts.append(offset);
+        offset += static_cast<uint8_t>(ulog[offset]) + (static_cast<uint8_t>(ulog[offset + 1]) * 256) + 3;
+    }
+
+    _ulogStreamTimer.start();
+}
+
+bool MockLink::ulogStreamComplete(void)
+{
+    QMutexLocker locker(&_ulogStreamMutex);
+    return _ulogStreamOffset >= _ulogStream.length();
+}
+
+void MockLink::sendShellOutput(const QByteArray& data)
+{
+    for (int offset = 0; offset < data.length(); offset += MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN) {
+        const int length = qMin(data.length() - offset, static_cast<int>(MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN));
+
+        // Pack always copies the full data field, the last chunk must not be read past the end of data
+        uint8_t chunk[MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN] = {};
+        memcpy(chunk, data.constData() + offset, static_cast<size_t>(length));
+
+        mavlink_message_t msg;
+        mavlink_msg_serial_control_pack_chan(_vehicleSystemId,
+                                             _vehicleComponentId,
+                                             _mavlinkChannel,
+                                             &msg,
+                                             SERIAL_CONTROL_DEV_SHELL,
+                                             SERIAL_CONTROL_FLAG_REPLY,
+                                             0,                             // timeout
+                                             0,                             // baudrate
+                                             static_cast<uint8_t>(length),
+                                             chunk);
+        respondWithMavlinkMessage(msg);
+    }
+}
+
+void MockLink::setLinkQuality(int latencyMsecs, int dropInterval)
+{
+    QMutexLocker locker(&_linkQualityMutex);
+
+    _linkLatencyMsecs = latencyMsecs;
+    _linkDropInterval = dropInterval;
+}
+
+/// Must be called with _linkQualityMutex locked
+///     @param messageCount Message counter for the direction the message is travelling in
+///     @return true: Message is lost
+bool MockLink::_linkDropMessage(uint32_t& messageCount)
+{
+    return _linkDropInterval > 0 && (++messageCount % static_cast<uint32_t>(_linkDropInterval)) == 0;
+}
+
+/// Sends the messages to QGC whose simulated latency has passed
+void MockLink::_linkLatencyWorker(void)
+{
+    QList<QByteArray> dueBytes;
+
+    {
+        QMutexLocker locker(&_linkQualityMutex);
+
+        const qint64 nowMsecs = _runningTime.elapsed();
+        while (!_linkDelayedBytes.isEmpty() && _linkDelayedBytes.first().first <= nowMsecs) {
+            dueBytes.append(_linkDelayedBytes.takeFirst().second);
+        }
+    }
+
+    for (const QByteArray& bytes: dueBytes) {
+        emit bytesReceived(this, bytes);
+    }
+}
+
+void MockLink::_ulogStreamWorker(void)
+{
+    QMutexLocker locker(&_ulogStreamMutex);
+
+    // Send whatever the rate allows for the time since the stream was started
+    qint64 bytesAllowed = (_ulogStreamTimer.elapsed() * _ulogStreamBytesPerSecond) / 1000;
+
+    while (_ulogStreamOffset < _ulogStream.length() && _ulogStreamOffset < bytesAllowed) {
+        int length = qMin(_ulogStream.length() - _ulogStreamOffset, static_cast<int>(MAVLINK_MSG_LOGGING_DATA_FIELD_DATA_LEN));
+
+        while (_ulogStreamStartIndex < _ulogStreamMessageStarts.count() && _ulogStreamMessageStarts[_ulogStreamStartIndex] < _ulogStreamOffset) {
+            _ulogStreamStartIndex++;
+        }
+        uint8_t firstMessageOffset = 255;
+        if (_ulogStreamOffset == 0) {
+            firstMessageOffset = 0;
+        } else if (_ulogStreamStartIndex < _ulogStreamMessageStarts.count() && _ulogStreamMessageStarts[_ulogStreamStartIndex] < _ulogStreamOffset + length) {
+            firstMessageOffset = static_cast<uint8_t>(_ulogStreamMessageStarts[_ulogStreamStartIndex] - _ulogStreamOffset);
+        }
+
+        if (_ulogStreamDropInterval == 0 || (_ulogStreamSequence % _ulogStreamDropInterval) != static_cast<uint16_t>(_ulogStreamDropInterval - 1)) {
+            mavlink_message_t msg;
+            mavlink_msg_logging_data_pack_chan(_vehicleSystemId,
+                                               _vehicleComponentId,
+                                               _mavlinkChannel,
+                                               &msg,
+                                               0,                           // target_system
+                                               0,                           // target_component
+                                               _ulogStreamSequence,
+                                               static_cast<uint8_t>(length),
+                                               firstMessageOffset,
+                                               reinterpret_cast<const uint8_t*>(_ulogStream.constData() + _ulogStreamOffset));
+            respondWithMavlinkMessage(msg);
+        }
+
+        _ulogStreamSequence++;
+        _ulogStreamOffset += length;
+    }
+}
+
 void MockLink::_sendADSBVehicles(void)
 {
     _adsbAngle += 2;
@@ -1646,7 +1853,7 @@ void MockLink::_sendParameterMetaData(void)
 #else
     char                metaDataURI[MAVLINK_MSG_COMPONENT_INFORMATION_FIELD_METADATA_URI_LEN]       = "https://bit.ly/2ZKRIRE";
 #endif
-    char                translationURI[MAVLINK_MSG_COMPONENT_INFORMATION_FIELD_TRANSLATION_URI_LEN] = "";
+    char                translationURI[MAVLINK_MSG_COMPONENT_INFORMATION_FIELD_TRANSLATION_URI_LEN] = "mftp://[;comp=1]parameter.translation.json";
 
     mavlink_msg_component_information_pack_chan(_vehicleSystemId,
                                                 _vehicleComponentId,
@@ -1656,7 +1863,7 @@ void MockLink::_sendParameterMetaData(void)
                                                 COMP_METADATA_TYPE_PARAMETER,
                                                 1,                              // comp_metadata_uid
                                                 metaDataURI,
-                                                0,                              // comp_translation_uid
+                                                1,                              // comp_translation_uid
                                                 translationURI);
     respondWithMavlinkMessage(responseMsg);
 }
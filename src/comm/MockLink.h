@@ -136,12 +136,51 @@ public:
 
     void sendUnexpectedCommandAck(MAV_CMD command, MAV_RESULT ackResult);
 
+    /// Sends a burst of non-chunked STATUSTEXT messages which cycle through all severities. Message text
+    /// is in the form "Flood <index>". Used for stress testing message handling.
+    ///     @param count Number of messages to send
+    void sendStatusTextFlood(int count);
+
+    typedef enum {
+        VehicleSigningOff,          ///< Vehicle messages are sent unsigned
+        VehicleSigningValid,        ///< Vehicle messages are correctly signed
+        VehicleSigningTampered,     ///< Vehicle messages are signed but the signature is corrupted
+        VehicleSigningReplayed,     ///< Vehicle messages are correctly signed and then each one is sent a second time
+    } VehicleSigningMode_t;
+
+    /// Controls MAVLink 2 signing of the messages sent by the simulated vehicle. This is independent of
+    /// signing on the QGC side of the link which is set through LinkInterface::setSigningKey.
+    ///     @param key 32 byte secret key, ignored for VehicleSigningOff
+    void setVehicleSigning(VehicleSigningMode_t mode, const QByteArray& key = QByteArray());
+
     /// Reset the state of the MissionItemHandler to no items, no transactions in progress.
     void resetMissionItemHandler(void) { _missionItemHandler.reset(); }
 
+    void setMissionItemPartialWriteSupported(bool partialWriteSupported) { _missionItemHandler.setPartialWriteSupported(partialWriteSupported); }
+
+    /// @return Number of mission, fence and rally point items written to the vehicle
+    int missionItemsWritten(void) const { return _missionItemHandler.missionItemsWritten(); }
+
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile(void) { return _logDownloadFilename; }
 
+    /// Streams the ULog data as LOGGING_DATA messages, the way the PX4 logger streams to the ground station.
+    ///     @param ulog Complete ULog file contents, including the 16 byte file header
+    ///     @param bytesPerSecond Rate at which log data is sent
+    ///     @param dropInterval Every dropInterval'th message is not sent to simulate link loss, 0 for no loss
+    void startULogStream(const QByteArray& ulog, int bytesPerSecond, int dropInterval = 0);
+
+    /// @return true: All data from startULogStream was sent
+    bool ulogStreamComplete(void);
+
+    /// Sends the data as SERIAL_CONTROL shell output, split into maximum sized messages
+    void sendShellOutput(const QByteArray& data);
+
+    /// Simulates a slow and lossy link to the vehicle
+    ///     @param latencyMsecs Messages from the vehicle reach QGC this much later, 0 for no added latency
+    ///     @param dropInterval Every dropInterval'th message in each direction is lost, 0 for no loss
+    void setLinkQuality(int latencyMsecs, int dropInterval);
+
     Q_INVOKABLE void setCommLost                    (bool commLost)   { _commLost = commLost; }
     Q_INVOKABLE void simulateConnectionRemoved      (void);
     static MockLink* startPX4MockLink               (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
@@ -225,6 +264,9 @@ private:
     void _sendRCChannels                (void);
     void _paramRequestListWorker        (void);
     void _logDownloadWorker             (void);
+    void _ulogStreamWorker              (void);
+    void _linkLatencyWorker             (void);
+    bool _linkDropMessage               (uint32_t& messageCount);
     void _sendADSBVehicles              (void);
     void _moveADSBVehicle               (void);
     void _sendVersionMetaData           (void);
@@ -266,6 +308,10 @@ private:
     bool                        _commLost                       = false;
     bool                        _highLatencyTransmissionEnabled = true;
 
+    QMutex                      _vehicleSigningMutex;
+    VehicleSigningMode_t        _vehicleSigningMode             = VehicleSigningOff;
+    MAVLinkSigning*             _vehicleSigning                 = nullptr;
+
     MockLinkFTP* _mockLinkFTP = nullptr;
 
     bool _sendStatusText;
@@ -285,6 +331,23 @@ private:
     uint32_t    _logDownloadCurrentOffset;  ///< Current offset we are sending from
     uint32_t    _logDownloadBytesRemaining; ///< Number of bytes still to send, 0 = send inactive
 
+    QMutex          _ulogStreamMutex;
+    QByteArray      _ulogStream;                        ///< ULog data being streamed
+    QVector<int>    _ulogStreamMessageStarts;           ///< Offsets of the ULog messages in _ulogStream
+    int             _ulogStreamOffset           = 0;    ///< Offset of next byte to send
+    int             _ulogStreamStartIndex       = 0;    ///< Index into _ulogStreamMessageStarts for the next message start
+    int             _ulogStreamBytesPerSecond   = 0;
+    int             _ulogStreamDropInterval     = 0;
+    uint16_t        _ulogStreamSequence         = 0;
+    QElapsedTimer   _ulogStreamTimer;
+
+    QMutex                              _linkQualityMutex;
+    int                                 _linkLatencyMsecs   = 0;
+    int                                 _linkDropInterval   = 0;
+    uint32_t                            _linkSentCount      = 0;    ///< Messages sent to QGC
+    uint32_t                            _linkReceivedCount  = 0;    ///< Messages received from QGC
+    QList<QPair<qint64, QByteArray>>    _linkDelayedBytes;          ///< Messages to QGC waiting out the latency, with their delivery time
+
     QGeoCoordinate  _adsbVehicleCoordinate;
     double          _adsbAngle;
 
@@ -111,6 +111,8 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     Q_UNUSED(cchPath); // Fix initialized-but-not-referenced warning on release builds
     path = (char *)request->data;
 
+    emit openCommandReceived(path);
+
     _currentFile.close();
 
     QString sizePrefix = sizeFilenamePrefix;
@@ -125,6 +127,8 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
         tmpFilename = ":MockLink/Parameter.MetaData.json";
     } else if (path == "/parameter.json.xz") {
         tmpFilename = ":MockLink/Parameter.MetaData.json.xz";
+    } else if (path == "/parameter.translation.json") {
+        tmpFilename = ":MockLink/Parameter.Translation.json";
     }
 
     if (!tmpFilename.isEmpty()) {
@@ -63,6 +63,9 @@ signals:
     
     /// You can connect to this signal to be notified when the server receives a Reset command.
     void resetCommandReceived(void);
+
+    /// You can connect to this signal to be notified when the server receives an Open command.
+    void openCommandReceived(const QString& path);
     
 private:
     void        _sendAck                (uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
@@ -24,6 +24,8 @@ MockLinkMissionItemHandler::MockLinkMissionItemHandler(MockLink* mockLink, MAVLi
     , _failReadRequestListFirstResponse     (true)
     , _failReadRequest1FirstResponse        (true)
     , _failWriteMissionCountFirstResponse   (true)
+    , _partialWriteSupported                (true)
+    , _missionItemsWritten                  (0)
 {
     Q_ASSERT(mockLink);
 }
@@ -61,6 +63,10 @@ bool MockLinkMissionItemHandler::handleMessage(const mavlink_message_t& msg)
         _handleMissionCount(msg);
         break;
 
+    case MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST:
+        _handleMissionWritePartialList(msg);
+        break;
+
     case MAVLINK_MSG_ID_MISSION_ACK:
         // Acks are received back for each MISSION_ITEM message
         break;
@@ -284,6 +290,32 @@ void MockLinkMissionItemHandler::_handleMissionCount(const mavlink_message_t& ms
     }
 }
 
+void MockLinkMissionItemHandler::_handleMissionWritePartialList(const mavlink_message_t& msg)
+{
+    mavlink_mission_write_partial_list_t partialList;
+
+    mavlink_msg_mission_write_partial_list_decode(&msg, &partialList);
+    Q_ASSERT(partialList.target_system == _mockLink->vehicleId());
+
+    _requestType = (MAV_MISSION_TYPE)partialList.mission_type;
+
+    qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionWritePartialList write sequence start:end" << partialList.start_index << partialList.end_index;
+
+    // Same as ArduPilot: partial writes are only supported for missions and must replace existing items
+    if (!_partialWriteSupported || _requestType != MAV_MISSION_TYPE_MISSION) {
+        _sendAck(MAV_MISSION_UNSUPPORTED);
+        return;
+    }
+    if (partialList.start_index < 0 || partialList.end_index < partialList.start_index || partialList.end_index >= _missionItems.count()) {
+        _sendAck(MAV_MISSION_ERROR);
+        return;
+    }
+
+    _writeSequenceIndex = partialList.start_index;
+    _writeSequenceCount = partialList.end_index + 1;
+    _requestNextMissionItem(_writeSequenceIndex);
+}
+
 void MockLinkMissionItemHandler::_requestNextMissionItem(int sequenceNumber)
 {
     qCDebug(MockLinkMissionItemHandlerLog) << "_requestNextMissionItem write sequence sequenceNumber:" << sequenceNumber << "_failureMode:" << _failureMode;
@@ -354,6 +386,7 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
     mavlink_msg_mission_item_int_decode(&msg, &missionItemInt);
     missionType = static_cast<MAV_MISSION_TYPE>(missionItemInt.mission_type);
     seq = missionItemInt.seq;
+    _missionItemsWritten++;
     
     switch (missionType) {
     case MAV_MISSION_TYPE_MISSION:
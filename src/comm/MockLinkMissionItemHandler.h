@@ -80,6 +80,12 @@ public:
 
     void setSendHomePositionOnEmptyList(bool sendHomePositionOnEmptyList) { _sendHomePositionOnEmptyList = sendHomePositionOnEmptyList; }
 
+    /// false: MISSION_WRITE_PARTIAL_LIST is rejected with MAV_MISSION_UNSUPPORTED
+    void setPartialWriteSupported(bool partialWriteSupported) { _partialWriteSupported = partialWriteSupported; }
+
+    /// @return Number of MISSION_ITEM_INT messages received for all mission types
+    int missionItemsWritten(void) const { return _missionItemsWritten; }
+
 private slots:
     void _missionItemResponseTimeout(void);
 
@@ -88,6 +94,7 @@ private:
     void _handleMissionRequest          (const mavlink_message_t& msg);
     void _handleMissionItem             (const mavlink_message_t& msg);
     void _handleMissionCount            (const mavlink_message_t& msg);
+    void _handleMissionWritePartialList (const mavlink_message_t& msg);
     void _handleMissionClearAll         (const mavlink_message_t& msg);
     void _requestNextMissionItem        (int sequenceNumber);
     void _sendAck                       (MAV_MISSION_RESULT ackType);
@@ -114,5 +121,7 @@ private:
     bool                _failReadRequestListFirstResponse;
     bool                _failReadRequest1FirstResponse;
     bool                _failWriteMissionCountFirstResponse;
+    bool                _partialWriteSupported;
+    int                 _missionItemsWritten;
 };
 
@@ -81,6 +81,7 @@ void SerialLink::disconnect(void)
     if (_port) {
         // This prevents stale signals from calling the link after it has been deleted
         QObject::disconnect(_port, &QIODevice::readyRead, this, &SerialLink::_readBytes);
+        _flushReceiveBuffer();
         _port->close();
         _port->deleteLater();
         _port = nullptr;
@@ -231,13 +232,7 @@ bool SerialLink::_hardwareConnect(QSerialPort::SerialPortError& error, QString&
 void SerialLink::_readBytes(void)
 {
     if (_port && _port->isOpen()) {
-        qint64 byteCount = _port->bytesAvailable();
-        if (byteCount) {
-            QByteArray buffer;
-            buffer.resize(byteCount);
-            _port->read(buffer.data(), buffer.size());
-            emit bytesReceived(this, buffer);
-        }
+        _readBytesFromDevice(_port);
     } else {
         // Error occurred
         qWarning() << "Serial port not readable";
@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SerialPortWatcher.h"
+
+#include <QDir>
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+
+#if defined(Q_OS_UNIX)
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#if defined(Q_OS_LINUX) && !defined(__android__)
+#include <linux/netlink.h>
+#define QGC_SERIAL_HOTPLUG_NETLINK
+#endif
+
+QGC_LOGGING_CATEGORY(SerialPortWatcherLog, "SerialPortWatcherLog")
+
+const char* SerialPortWatcher::_devPath = "/dev";
+
+SerialPortWatcher::SerialPortWatcher(QObject* parent)
+    : QObject(parent)
+{
+
+}
+
+SerialPortWatcher::~SerialPortWatcher()
+{
+    stop();
+}
+
+void SerialPortWatcher::start(void)
+{
+    stop();
+
+    if (_startUeventNetlink()) {
+        qCDebug(SerialPortWatcherLog) << "Using kernel uevents for serial port hotplug";
+    } else if (_startDevDirectory()) {
+        qCDebug(SerialPortWatcherLog) << "Using /dev directory watcher for serial port hotplug";
+    } else {
+        qCDebug(SerialPortWatcherLog) << "Serial port hotplug not available, falling back to polling";
+    }
+}
+
+bool SerialPortWatcher::startWithUeventSocket(int socketFd)
+{
+    stop();
+    return _watchUeventSocket(socketFd, false /* ownsSocket */);
+}
+
+void SerialPortWatcher::stop(void)
+{
+    if (_ueventNotifier) {
+        // May be called from within the notifier's own activated signal
+        _ueventNotifier->setEnabled(false);
+        _ueventNotifier->deleteLater();
+        _ueventNotifier = nullptr;
+    }
+#if defined(Q_OS_UNIX)
+    if (_ueventSocket != -1 && _ownsUeventSocket) {
+        ::close(_ueventSocket);
+    }
+#endif
+    _ueventSocket       = -1;
+    _ownsUeventSocket   = false;
+
+    delete _devWatcher;
+    _devWatcher = nullptr;
+    _devTtyList.clear();
+
+    _backend = BackendPolling;
+}
+
+bool SerialPortWatcher::_startUeventNetlink(void)
+{
+#ifdef QGC_SERIAL_HOTPLUG_NETLINK
+    int socketFd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (socketFd == -1) {
+        qCDebug(SerialPortWatcherLog) << "Unable to create netlink socket" << strerror(errno);
+        return false;
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family  = AF_NETLINK;
+    addr.nl_pid     = 0;    // Let the kernel assign the port id
+    addr.nl_groups  = 1;    // Kernel uevent multicast group
+
+    if (::bind(socketFd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+        qCDebug(SerialPortWatcherLog) << "Unable to bind netlink socket" << strerror(errno);
+        ::close(socketFd);
+        return false;
+    }
+
+    return _watchUeventSocket(socketFd, true /* ownsSocket */);
+#else
+    return false;
+#endif
+}
+
+bool SerialPortWatcher::_watchUeventSocket(int socketFd, bool ownsSocket)
+{
+#if defined(Q_OS_UNIX)
+    _ueventSocket       = socketFd;
+    _ownsUeventSocket   = ownsSocket;
+    _ueventNotifier     = new QSocketNotifier(socketFd, QSocketNotifier::Read, this);
+    connect(_ueventNotifier, &QSocketNotifier::activated, this, &SerialPortWatcher::_readUevents);
+    _backend = BackendUevent;
+    return true;
+#else
+    Q_UNUSED(socketFd)
+    Q_UNUSED(ownsSocket)
+    return false;
+#endif
+}
+
+bool SerialPortWatcher::_startDevDirectory(void)
+{
+#if defined(Q_OS_LINUX) && !defined(__android__)
+    _devWatcher = new QFileSystemWatcher(this);
+    if (!_devWatcher->addPath(_devPath)) {
+        delete _devWatcher;
+        _devWatcher = nullptr;
+        return false;
+    }
+    _devTtyList = _devTtyEntries();
+    connect(_devWatcher, &QFileSystemWatcher::directoryChanged, this, &SerialPortWatcher::_devDirectoryChanged);
+    _backend = BackendDevDirectory;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SerialPortWatcher::_readUevents(void)
+{
+#if defined(Q_OS_UNIX)
+    // A uevent is limited to a single page of environment plus the header
+    char buffer[8192];
+    bool changed = false;
+
+    while (true) {
+        ssize_t cBytes = ::recv(_ueventSocket, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (cBytes <= 0) {
+            if (cBytes == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                qCWarning(SerialPortWatcherLog) << "uevent socket read failed, falling back to polling" << strerror(errno);
+                stop();
+                emit portsChanged();
+                return;
+            }
+            break;
+        }
+
+        QString action;
+        QString systemLocation;
+        if (parseUevent(QByteArray::fromRawData(buffer, static_cast<int>(cBytes)), action, systemLocation)) {
+            qCDebug(SerialPortWatcherLog) << "uevent" << action << systemLocation;
+            if (action == QStringLiteral("add")) {
+                emit portAdded(systemLocation);
+                changed = true;
+            } else if (action == QStringLiteral("remove")) {
+                emit portRemoved(systemLocation);
+                changed = true;
+            }
+        }
+    }
+
+    if (changed) {
+        emit portsChanged();
+    }
+#endif
+}
+
+void SerialPortWatcher::_devDirectoryChanged(void)
+{
+    QStringList newList = _devTtyEntries();
+    bool        changed = false;
+
+    for (const QString& entry: newList) {
+        if (!_devTtyList.contains(entry)) {
+            emit portAdded(QStringLiteral("%1/%2").arg(_devPath, entry));
+            changed = true;
+        }
+    }
+    for (const QString& entry: _devTtyList) {
+        if (!newList.contains(entry)) {
+            emit portRemoved(QStringLiteral("%1/%2").arg(_devPath, entry));
+            changed = true;
+        }
+    }
+    _devTtyList = newList;
+
+    if (changed) {
+        emit portsChanged();
+    }
+}
+
+QStringList SerialPortWatcher::_devTtyEntries(void) const
+{
+    return QDir(_devPath).entryList(QStringList(QStringLiteral("tty*")), QDir::System | QDir::NoDotAndDotDot, QDir::Name);
+}
+
+bool SerialPortWatcher::parseUevent(const QByteArray& datagram, QString& action, QString& systemLocation)
+{
+    // Messages from udevd (as opposed to the kernel) start with a binary header which we don't handle
+    if (datagram.startsWith("libudev")) {
+        return false;
+    }
+
+    QString subsystem;
+    QString devName;
+
+    action.clear();
+    systemLocation.clear();
+
+    // First entry is the "action@devpath" summary, followed by null terminated KEY=VALUE pairs
+    int index = datagram.indexOf('\0');
+    while (index != -1 && index < datagram.length()) {
+        int start = index + 1;
+        index = datagram.indexOf('\0', start);
+        int end = index == -1 ? datagram.length() : index;
+
+        const QByteArray entry = datagram.mid(start, end - start);
+        if (entry.startsWith("ACTION=")) {
+            action = QString::fromLatin1(entry.mid(7));
+        } else if (entry.startsWith("SUBSYSTEM=")) {
+            subsystem = QString::fromLatin1(entry.mid(10));
+        } else if (entry.startsWith("DEVNAME=")) {
+            devName = QString::fromLatin1(entry.mid(8));
+        }
+    }
+
+    if (subsystem != QStringLiteral("tty") || action.isEmpty() || devName.isEmpty()) {
+        return false;
+    }
+
+    systemLocation = devName.startsWith('/') ? devName : QStringLiteral("%1/%2").arg(_devPath, devName);
+    return true;
+}
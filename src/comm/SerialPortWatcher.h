@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(SerialPortWatcherLog)
+
+class QSocketNotifier;
+class QFileSystemWatcher;
+
+/// Notifies about serial port hotplug events such that serial port enumeration only needs to happen when
+/// something actually changed.
+///
+/// On Linux kernel uevents are received through a netlink socket. If that is not available (for example in a
+/// sandbox) it falls back to watching the /dev directory. On all other platforms isEventDriven returns false and
+/// the caller is expected to poll.
+class SerialPortWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    SerialPortWatcher(QObject* parent = nullptr);
+    ~SerialPortWatcher();
+
+    typedef enum {
+        BackendPolling,         ///< No hotplug notifications available, caller must poll
+        BackendUevent,          ///< Kernel uevents from netlink socket (or fake source for unit tests)
+        BackendDevDirectory,    ///< Watching /dev for tty device node changes
+    } Backend_t;
+
+    /// Starts watching using the best backend available on this platform
+    void start(void);
+
+    /// Starts watching for uevents on the specified datagram socket. Ownership of the socket is not transferred.
+    /// This is used by unit tests to supply fake device events.
+    ///     @return false: socket can't be watched on this platform
+    bool startWithUeventSocket(int socketFd);
+
+    void stop(void);
+
+    Backend_t   backend         (void) const { return _backend; }
+    bool        isEventDriven   (void) const { return _backend != BackendPolling; }
+
+    /// Parses a kernel uevent datagram ("add@/devices/...\0ACTION=add\0SUBSYSTEM=tty\0DEVNAME=ttyACM0\0...").
+    ///     @param[out] action uevent action: "add", "remove", ...
+    ///     @param[out] systemLocation Device node path, for example "/dev/ttyACM0"
+    ///     @return true: uevent is for a tty device and outputs were filled in
+    static bool parseUevent(const QByteArray& datagram, QString& action, QString& systemLocation);
+
+signals:
+    void portAdded      (const QString& systemLocation);
+    void portRemoved    (const QString& systemLocation);
+
+    /// Signalled after portAdded/portRemoved
+    void portsChanged   (void);
+
+private slots:
+    void _readUevents           (void);
+    void _devDirectoryChanged   (void);
+
+private:
+    bool        _startUeventNetlink     (void);
+    bool        _startDevDirectory      (void);
+    bool        _watchUeventSocket      (int socketFd, bool ownsSocket);
+    QStringList _devTtyEntries          (void) const;
+
+    Backend_t           _backend            = BackendPolling;
+    int                 _ueventSocket       = -1;
+    bool                _ownsUeventSocket   = false;
+    QSocketNotifier*    _ueventNotifier     = nullptr;
+    QFileSystemWatcher* _devWatcher         = nullptr;
+    QStringList         _devTtyList;
+
+    static const char*  _devPath;
+};
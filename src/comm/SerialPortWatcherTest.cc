@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SerialPortWatcherTest.h"
+#include "SerialPortWatcher.h"
+
+#if defined(Q_OS_UNIX)
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static QByteArray _uevent(const char* action, const char* subsystem, const char* devName)
+{
+    QByteArray datagram;
+
+    datagram.append(QStringLiteral("%1@/devices/pci0000:00/usb1/1-1/1-1:1.0/tty/%2").arg(action, devName).toLatin1()).append('\0');
+    datagram.append("ACTION=").append(action).append('\0');
+    datagram.append("DEVPATH=/devices/pci0000:00/usb1/1-1/1-1:1.0/tty/").append(devName).append('\0');
+    datagram.append("SUBSYSTEM=").append(subsystem).append('\0');
+    datagram.append("DEVNAME=").append(devName).append('\0');
+    datagram.append("SEQNUM=4242").append('\0');
+
+    return datagram;
+}
+
+void SerialPortWatcherTest::_parseUeventTest(void)
+{
+    QString action;
+    QString systemLocation;
+
+    QVERIFY(SerialPortWatcher::parseUevent(_uevent("add", "tty", "ttyACM0"), action, systemLocation));
+    QCOMPARE(action,            QStringLiteral("add"));
+    QCOMPARE(systemLocation,    QStringLiteral("/dev/ttyACM0"));
+
+    QVERIFY(SerialPortWatcher::parseUevent(_uevent("remove", "tty", "ttyUSB3"), action, systemLocation));
+    QCOMPARE(action,            QStringLiteral("remove"));
+    QCOMPARE(systemLocation,    QStringLiteral("/dev/ttyUSB3"));
+
+    // Non tty devices, udevd messages and garbage are ignored
+    QVERIFY(!SerialPortWatcher::parseUevent(_uevent("add", "usb", "bus/usb/001/002"), action, systemLocation));
+    QVERIFY(!SerialPortWatcher::parseUevent(QByteArray("libudev\0\0\0\0", 11), action, systemLocation));
+    QVERIFY(!SerialPortWatcher::parseUevent(QByteArray(), action, systemLocation));
+    QVERIFY(!SerialPortWatcher::parseUevent(QByteArray("add@/devices/foo"), action, systemLocation));
+}
+
+void SerialPortWatcherTest::_fakeEventTest(void)
+{
+#if defined(Q_OS_UNIX)
+    int sockets[2];
+    QCOMPARE(::socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets), 0);
+
+    SerialPortWatcher watcher;
+    QVERIFY(watcher.startWithUeventSocket(sockets[0]));
+    QCOMPARE(watcher.backend(), SerialPortWatcher::BackendUevent);
+    QVERIFY(watcher.isEventDriven());
+
+    QSignalSpy spyAdded     (&watcher, &SerialPortWatcher::portAdded);
+    QSignalSpy spyRemoved   (&watcher, &SerialPortWatcher::portRemoved);
+    QSignalSpy spyChanged   (&watcher, &SerialPortWatcher::portsChanged);
+
+    // A burst of events delivered together should only signal a single change
+    const QList<QByteArray> rgEvents = {
+        _uevent("add",      "usb",  "bus/usb/001/002"),
+        _uevent("add",      "tty",  "ttyACM0"),
+        _uevent("add",      "tty",  "ttyACM1"),
+        _uevent("change",   "tty",  "ttyACM1"),
+    };
+    for (const QByteArray& event: rgEvents) {
+        QCOMPARE(::send(sockets[1], event.constData(), static_cast<size_t>(event.length()), 0), static_cast<ssize_t>(event.length()));
+    }
+
+    QVERIFY(spyChanged.wait(1000));
+    QCOMPARE(spyChanged.count(),    1);
+    QCOMPARE(spyAdded.count(),      2);
+    QCOMPARE(spyRemoved.count(),    0);
+    QCOMPARE(spyAdded[0][0].toString(), QStringLiteral("/dev/ttyACM0"));
+    QCOMPARE(spyAdded[1][0].toString(), QStringLiteral("/dev/ttyACM1"));
+
+    QByteArray event = _uevent("remove", "tty", "ttyACM0");
+    QCOMPARE(::send(sockets[1], event.constData(), static_cast<size_t>(event.length()), 0), static_cast<ssize_t>(event.length()));
+    QVERIFY(spyChanged.wait(1000));
+    QCOMPARE(spyRemoved.count(),            1);
+    QCOMPARE(spyRemoved[0][0].toString(),   QStringLiteral("/dev/ttyACM0"));
+
+    watcher.stop();
+    QVERIFY(!watcher.isEventDriven());
+
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+#else
+    QSKIP("Fake uevent source requires unix domain sockets");
+#endif
+}
@@ -71,17 +71,7 @@ void TCPLink::_writeBytes(const QByteArray data)
 void TCPLink::_readBytes()
 {
     if (_socket) {
-        qint64 byteCount = _socket->bytesAvailable();
-        if (byteCount)
-        {
-            QByteArray buffer;
-            buffer.resize(byteCount);
-            _socket->read(buffer.data(), buffer.size());
-            emit bytesReceived(this, buffer);
-#ifdef TCPLINK_READWRITE_DEBUG
-            writeDebugBytes(buffer.data(), buffer.size());
-#endif
-        }
+        _readBytesFromDevice(_socket);
     }
 }
 
@@ -90,6 +80,7 @@ void TCPLink::disconnect(void)
     if (_socket) {
         // This prevents stale signal from calling the link after it has been deleted
         QObject::disconnect(_socket, &QIODevice::readyRead, this, &TCPLink::_readBytes);
+        _flushReceiveBuffer();
         _socketIsConnected = false;
         _socket->disconnectFromHost(); // Disconnect tcp
         _socket->deleteLater(); // Make sure delete happens on correct thread
@@ -16,6 +16,9 @@
 #include "GeoTest.h"
 #include "QGCGeo.h"
 
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
 /*
 GeoTest::GeoTest(void)
 {
@@ -91,3 +94,176 @@ void GeoTest::_convertNedToGeoAtOrigin_test(void)
     QCOMPARE(coord.longitude(), expectedLon);
     QCOMPARE(coord.altitude(), expectedAlt);
 }
+
+/// Fills the arrays with random coordinates within radius degrees of _origin
+void GeoTest::_generateCoords(int count, double radius, QVector<double>& lat, QVector<double>& lon, QVector<double>& alt)
+{
+    QRandomGenerator random(1234);
+
+    lat.resize(count);
+    lon.resize(count);
+    alt.resize(count);
+    for (int i=0; i<count; i++) {
+        lat[i] = _origin.latitude() + (random.generateDouble() * 2.0 - 1.0) * radius;
+        lon[i] = _origin.longitude() + (random.generateDouble() * 2.0 - 1.0) * radius;
+        alt[i] = random.generateDouble() * 500.0;
+    }
+}
+
+void GeoTest::_convertGeoToNedBatch_test(void)
+{
+    const int       count = 1000;
+    QVector<double> lat, lon, alt;
+    QVector<double> x(count), y(count), z(count);
+
+    _generateCoords(count, 0.5, lat, lon, alt);
+
+    // Include the origin itself to check the short circuit
+    lat[0] = _origin.latitude();
+    lon[0] = _origin.longitude();
+
+    convertGeoToNed(geoTangentOrigin(_origin), lat.constData(), lon.constData(), alt.constData(), x.data(), y.data(), z.data(), count);
+
+    QCOMPARE(x[0], 0.0);
+    QCOMPARE(y[0], 0.0);
+    for (int i=0; i<count; i++) {
+        double expectedX, expectedY, expectedZ;
+        convertGeoToNed(QGeoCoordinate(lat[i], lon[i], alt[i]), _origin, &expectedX, &expectedY, &expectedZ);
+        QVERIFY(qAbs(x[i] - expectedX) < 1e-6);
+        QVERIFY(qAbs(y[i] - expectedY) < 1e-6);
+        QVERIFY(qAbs(z[i] - expectedZ) < 1e-6);
+    }
+}
+
+void GeoTest::_convertNedToGeoBatch_test(void)
+{
+    const int       count = 1000;
+    QVector<double> x(count), y(count), z(count);
+    QVector<double> lat(count), lon(count), alt(count);
+    QRandomGenerator random(4321);
+
+    for (int i=0; i<count; i++) {
+        x[i] = (random.generateDouble() * 2.0 - 1.0) * 50000.0;
+        y[i] = (random.generateDouble() * 2.0 - 1.0) * 50000.0;
+        z[i] = -random.generateDouble() * 500.0;
+    }
+    x[0] = y[0] = 0;
+
+    convertNedToGeo(geoTangentOrigin(_origin), x.constData(), y.constData(), z.constData(), lat.data(), lon.data(), alt.data(), count);
+
+    QCOMPARE(lat[0], _origin.latitude());
+    QCOMPARE(lon[0], _origin.longitude());
+    for (int i=0; i<count; i++) {
+        QGeoCoordinate expected;
+        convertNedToGeo(x[i], y[i], z[i], _origin, &expected);
+        QVERIFY(qAbs(lat[i] - expected.latitude()) < 1e-9);
+        QVERIFY(qAbs(lon[i] - expected.longitude()) < 1e-9);
+        QVERIFY(qAbs(alt[i] - expected.altitude()) < 1e-6);
+    }
+
+    // Altitude is optional
+    convertNedToGeo(geoTangentOrigin(_origin), x.constData(), y.constData(), nullptr, lat.data(), lon.data(), nullptr, count);
+}
+
+void GeoTest::_convertPointsBatch_test(void)
+{
+    QList<QGeoCoordinate> coords;
+    coords << _origin << QGeoCoordinate(47.364869, 8.594398) << QGeoCoordinate(47.38, 8.50) << QGeoCoordinate(47.39, 8.56);
+
+    // Points are QPointF(east, north) as used by the planners
+    QList<QPointF> points = convertGeoToNed(coords, _origin);
+    QCOMPARE(points.count(), coords.count());
+    QCOMPARE(points[0], QPointF(0, 0));
+    QVERIFY(qAbs(points[1].x() - 3486.949719522415307437768) < 1e-6);
+    QVERIFY(qAbs(points[1].y() - -1281.152128182419801305514) < 1e-6);
+
+    // Round trip
+    QList<QGeoCoordinate> roundTrip = convertNedToGeo(points, _origin);
+    QCOMPARE(roundTrip.count(), coords.count());
+    for (int i=0; i<coords.count(); i++) {
+        QVERIFY(roundTrip[i].distanceTo(coords[i]) < 0.001);
+        QCOMPARE(roundTrip[i].altitude(), _origin.altitude());
+    }
+}
+
+void GeoTest::_convertGeoToUTMBatch_test(void)
+{
+    const int       count = 1000;
+    QVector<double> lat, lon, alt;
+    QVector<double> easting(count), northing(count);
+    QVector<int>    zone(count);
+
+    // Spans UTM zones 31/32 boundary at 6E as well as 32/33 at 12E
+    _generateCoords(count, 4.0, lat, lon, alt);
+    lat[1] = 91; // Invalid latitude
+
+    QCOMPARE(convertGeoToUTM(lat.constData(), lon.constData(), easting.data(), northing.data(), zone.data(), count), 1);
+    QCOMPARE(zone[1], 0);
+
+    for (int i=0; i<count; i++) {
+        double expectedEasting, expectedNorthing;
+        int expectedZone = convertGeoToUTM(QGeoCoordinate(lat[i], lon[i]), expectedEasting, expectedNorthing);
+        QCOMPARE(zone[i], expectedZone);
+        if (expectedZone) {
+            QCOMPARE(easting[i], expectedEasting);
+            QCOMPARE(northing[i], expectedNorthing);
+        }
+    }
+}
+
+void GeoTest::_convertGeoToMGRSBatch_test(void)
+{
+    const int       count = 100;
+    QVector<double> lat, lon, alt;
+
+    _generateCoords(count, 4.0, lat, lon, alt);
+
+    QStringList rgMGRS = convertGeoToMGRS(lat.constData(), lon.constData(), count);
+    QCOMPARE(rgMGRS.count(), count);
+    for (int i=0; i<count; i++) {
+        QCOMPARE(rgMGRS[i], convertGeoToMGRS(QGeoCoordinate(lat[i], lon[i])));
+    }
+}
+
+void GeoTest::_batchBenchmark_test(void)
+{
+    const int       count = 1000000;
+    QVector<double> lat, lon, alt;
+    QVector<double> x(count), y(count), z(count);
+    QElapsedTimer   timer;
+
+    _generateCoords(count, 0.5, lat, lon, alt);
+
+    QList<QGeoCoordinate> coords;
+    coords.reserve(count);
+    for (int i=0; i<count; i++) {
+        coords.append(QGeoCoordinate(lat[i], lon[i], alt[i]));
+    }
+
+    timer.start();
+    for (int i=0; i<count; i++) {
+        convertGeoToNed(coords[i], _origin, &x[i], &y[i], &z[i]);
+    }
+    qint64 scalarGeoToNed = timer.nsecsElapsed();
+
+    timer.restart();
+    convertGeoToNed(geoTangentOrigin(_origin), lat.constData(), lon.constData(), alt.constData(), x.data(), y.data(), z.data(), count);
+    qint64 batchGeoToNed = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i=0; i<count; i++) {
+        convertNedToGeo(x[i], y[i], z[i], _origin, &coords[i]);
+    }
+    qint64 scalarNedToGeo = timer.nsecsElapsed();
+
+    timer.restart();
+    convertNedToGeo(geoTangentOrigin(_origin), x.constData(), y.constData(), z.constData(), lat.data(), lon.data(), alt.data(), count);
+    qint64 batchNedToGeo = timer.nsecsElapsed();
+
+    qDebug() << "convertGeoToNed" << count << "points: scalar(ms)" << scalarGeoToNed / 1000000.0 << "batch(ms)" << batchGeoToNed / 1000000.0;
+    qDebug() << "convertNedToGeo" << count << "points: scalar(ms)" << scalarNedToGeo / 1000000.0 << "batch(ms)" << batchNedToGeo / 1000000.0;
+
+    // Batch results must still match after the round trip
+    QVERIFY(qAbs(lat[count / 2] - coords[count / 2].latitude()) < 1e-9);
+    QVERIFY(qAbs(lon[count / 2] - coords[count / 2].longitude()) < 1e-9);
+}
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QGeoCoordinate>
+#include <QVector>
 
 #include "UnitTest.h"
 
@@ -33,7 +34,17 @@ private slots:
     void _convertGeoToNedAtOrigin_test(void);
     void _convertNedToGeo_test(void);
     void _convertNedToGeoAtOrigin_test(void);
+    void _convertGeoToNedBatch_test(void);
+    void _convertNedToGeoBatch_test(void);
+    void _convertPointsBatch_test(void);
+    void _convertGeoToUTMBatch_test(void);
+    void _convertGeoToMGRSBatch_test(void);
+    void _batchBenchmark_test(void);
+
 private:
+    void _generateCoords(int count, double radius, QVector<double>& lat, QVector<double>& lon, QVector<double>& alt);
+
+
     QGeoCoordinate _origin;
 };
 
@@ -48,6 +48,24 @@
 #include "MissionCommandTreeEditorTest.h"
 #include "VehicleLinkManagerTest.h"
 #include "LandingComplexItemTest.h"
+#include "UASMessageHandlerTest.h"
+#include "SerialPortWatcherTest.h"
+#include "LinkReceiveBufferTest.h"
+#include "MAVLinkSigningTest.h"
+#include "QGCCompressionTest.h"
+#include "FollowMeEstimatorTest.h"
+#include "TelemetryTrackTest.h"
+#include "QGCSettingsStoreTest.h"
+#include "APMCompassCalTest.h"
+#include "MAVLinkLogProcessorTest.h"
+#include "VideoStreamTest.h"
+#include "MavlinkConsoleControllerTest.h"
+#include "GPSSerialIOTest.h"
+#include "ComponentInformationManagerTest.h"
+#include "InitialConnectStateMachineTest.h"
+#include "AppMessagesTest.h"
+#include "FlightPathSegmentTest.h"
+#include "TerrainProfileTest.h"
 
 UT_REGISTER_TEST(FactSystemTestGeneric)
 UT_REGISTER_TEST(FactSystemTestPX4)
@@ -82,6 +100,24 @@ UT_REGISTER_TEST(QGCMapPolylineTest)
 UT_REGISTER_TEST(CameraCalcTest)
 UT_REGISTER_TEST(FWLandingPatternTest)
 UT_REGISTER_TEST(LandingComplexItemTest)
+UT_REGISTER_TEST(UASMessageHandlerTest)
+UT_REGISTER_TEST(SerialPortWatcherTest)
+UT_REGISTER_TEST(LinkReceiveBufferTest)
+UT_REGISTER_TEST(MAVLinkSigningTest)
+UT_REGISTER_TEST(QGCCompressionTest)
+UT_REGISTER_TEST(FollowMeEstimatorTest)
+UT_REGISTER_TEST(TelemetryTrackTest)
+UT_REGISTER_TEST(QGCSettingsStoreTest)
+UT_REGISTER_TEST(APMCompassCalTest)
+UT_REGISTER_TEST(MAVLinkLogProcessorTest)
+UT_REGISTER_TEST(VideoStreamTest)
+UT_REGISTER_TEST(MavlinkConsoleControllerTest)
+UT_REGISTER_TEST(GPSSerialIOTest)
+UT_REGISTER_TEST(ComponentInformationManagerTest)
+UT_REGISTER_TEST(InitialConnectStateMachineTest)
+UT_REGISTER_TEST(AppMessagesTest)
+UT_REGISTER_TEST(FlightPathSegmentTest)
+UT_REGISTER_TEST(TerrainProfileTest)
 
 UT_REGISTER_TEST_STANDALONE(MissionCommandTreeEditorTest)
 
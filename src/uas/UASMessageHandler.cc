@@ -19,26 +19,6 @@
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
 
-UASMessage::UASMessage(int componentid, int severity, QString text)
-{
-    _compId   = componentid;
-    _severity = severity;
-    _text     = text;
-}
-
-bool UASMessage::severityIsError()
-{
-    switch (_severity) {
-        case MAV_SEVERITY_EMERGENCY:
-        case MAV_SEVERITY_ALERT:
-        case MAV_SEVERITY_CRITICAL:
-        case MAV_SEVERITY_ERROR:
-            return true;
-        default:
-            return false;
-    }
-}
-
 UASMessageHandler::UASMessageHandler(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
     , _activeVehicle(nullptr)
@@ -48,10 +28,12 @@ UASMessageHandler::UASMessageHandler(QGCApplication* app, QGCToolbox* toolbox)
     , _errorCountTotal(0)
     , _warningCount(0)
     , _normalCount(0)
+    , _droppedCount(0)
     , _showErrorsInToolbar(false)
     , _multiVehicleManager(nullptr)
 {
-
+    _messageModel = new UASMessageListModel(_cMaxMessages, this);
+    memset(_severityCounts, 0, sizeof(_severityCounts));
 }
 
 UASMessageHandler::~UASMessageHandler()
@@ -66,20 +48,18 @@ void UASMessageHandler::setToolbox(QGCToolbox *toolbox)
    _multiVehicleManager = _toolbox->multiVehicleManager();
 
    connect(_multiVehicleManager, &MultiVehicleManager::activeVehicleChanged, this, &UASMessageHandler::_activeVehicleChanged);
-   emit textMessageReceived(nullptr);
    emit textMessageCountChanged(0);
 }
 
 void UASMessageHandler::clearMessages()
 {
+    _messageModel->clear();
     _mutex.lock();
-    while(_messages.count()) {
-        delete _messages.last();
-        _messages.pop_back();
-    }
     _errorCount   = 0;
     _warningCount = 0;
     _normalCount  = 0;
+    _droppedCount = 0;
+    memset(_severityCounts, 0, sizeof(_severityCounts));
     _mutex.unlock();
     emit textMessageCountChanged(0);
 }
@@ -91,7 +71,6 @@ void UASMessageHandler::_activeVehicleChanged(Vehicle* vehicle)
         disconnect(_activeVehicle, &Vehicle::textMessageReceived, this, &UASMessageHandler::handleTextMessage);
         _activeVehicle = nullptr;
         clearMessages();
-        emit textMessageReceived(nullptr);
     }
 
     // And now if there's an autopilot to follow, set up the UI.
@@ -110,10 +89,8 @@ void UASMessageHandler::handleTextMessage(int, int compId, int severity, QString
         return;
     }
 
-    // Color the output depending on the message severity. We have 3 distinct cases:
-    // 1: If we have an ERROR or worse, make it bigger, bolder, and highlight it red.
-    // 2: If we have a warning or notice, just make it bold and color it orange.
-    // 3: Otherwise color it the standard color, white.
+    // Only a compact record is kept here. Html formatting for display is done on demand by the message model.
+    UASMessage message(compId, severity, text);
 
     _mutex.lock();
 
@@ -125,84 +102,45 @@ void UASMessageHandler::handleTextMessage(int, int compId, int severity, QString
         _multiComp = true;
     }
 
-    // So first determine the styling based on the severity.
-    QString style;
     switch (severity)
     {
     case MAV_SEVERITY_EMERGENCY:
     case MAV_SEVERITY_ALERT:
     case MAV_SEVERITY_CRITICAL:
     case MAV_SEVERITY_ERROR:
-        style = QString("<#E>");
         _errorCount++;
         _errorCountTotal++;
         break;
     case MAV_SEVERITY_NOTICE:
     case MAV_SEVERITY_WARNING:
-        style = QString("<#I>");
         _warningCount++;
         break;
     default:
-        style = QString("<#N>");
         _normalCount++;
         break;
     }
-
-    // And determine the text for the severitie
-    QString severityText;
-    switch (severity)
-    {
-    case MAV_SEVERITY_EMERGENCY:
-        severityText = tr(" EMERGENCY:");
-        break;
-    case MAV_SEVERITY_ALERT:
-        severityText = tr(" ALERT:");
-        break;
-    case MAV_SEVERITY_CRITICAL:
-        severityText = tr(" Critical:");
-        break;
-    case MAV_SEVERITY_ERROR:
-        severityText = tr(" Error:");
-        break;
-    case MAV_SEVERITY_WARNING:
-        severityText = tr(" Warning:");
-        break;
-    case MAV_SEVERITY_NOTICE:
-        severityText = tr(" Notice:");
-        break;
-    case MAV_SEVERITY_INFO:
-        severityText = tr(" Info:");
-        break;
-    case MAV_SEVERITY_DEBUG:
-        severityText = tr(" Debug:");
-        break;
-    default:
-        break;
-    }
-
-    // Finally preppend the properly-styled text with a timestamp.
-    QString dateString = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-    UASMessage* message = new UASMessage(compId, severity, text);
-    QString compString;
-    if (_multiComp) {
-        compString = QString(" COMP:%1").arg(compId);
+    if (severity >= 0 && severity < _cSeverities) {
+        _severityCounts[severity]++;
     }
-    message->_setFormatedText(QString("<font style=\"%1\">[%2%3]%4 %5</font><br/>").arg(style).arg(dateString).arg(compString).arg(severityText).arg(text));
 
-    if (message->severityIsError()) {
-        _latestError = severityText + " " + text;
+    if (message.severityIsError()) {
+        _latestError = UASMessage::severityText(severity) + " " + text;
     }
 
     _mutex.unlock();
 
-    emit textMessageReceived(message);
+    _messageModel->setShowComponent(_multiComp);
+    if (_messageModel->append(message)) {
+        _mutex.lock();
+        _droppedCount++;
+        _mutex.unlock();
+    }
 
-    _messages.append(message);
-    int count = _messages.count();
-    emit textMessageCountChanged(count);
+    emit textMessageReceived(message);
+    emit textMessageCountChanged(_messageModel->count());
 
-    if (_showErrorsInToolbar && message->severityIsError()) {
-        _app->showCriticalVehicleMessage(message->getText());
+    if (_showErrorsInToolbar && message.severityIsError()) {
+        _app->showCriticalVehicleMessage(message.getText());
     }
 }
 
@@ -236,3 +174,20 @@ int UASMessageHandler::getNormalCount() {
     _mutex.unlock();
     return c;
 }
+
+int UASMessageHandler::getSeverityCount(int severity) {
+    if (severity < 0 || severity >= _cSeverities) {
+        return 0;
+    }
+    _mutex.lock();
+    int c = _severityCounts[severity];
+    _mutex.unlock();
+    return c;
+}
+
+int UASMessageHandler::getDroppedCount() {
+    _mutex.lock();
+    int c = _droppedCount;
+    _mutex.unlock();
+    return c;
+}
@@ -10,54 +10,16 @@
 #pragma once
 
 #include <QObject>
-#include <QVector>
 #include <QMutex>
 
 #include "QGCToolbox.h"
+#include "QGCMAVLink.h"
+#include "UASMessageListModel.h"
 
 class Vehicle;
 class UASInterface;
-class UASMessageHandler;
 class QGCApplication;
 
-/*!
- * @class UASMessage
- * @brief Message element
- */
-class UASMessage
-{
-    friend class UASMessageHandler;
-public:
-    /**
-     * @brief Get message source component ID
-     */
-    int getComponentID()        { return _compId; }
-    /**
-     * @brief Get message severity (from MAV_SEVERITY_XXX enum)
-     */
-    int getSeverity()           { return _severity; }
-    /**
-     * @brief Get message text (e.g. "[pm] sending list")
-     */
-    QString getText()           { return _text; }
-    /**
-     * @brief Get (html) formatted text (in the form: "[11:44:21.137 - COMP:50] Info: [pm] sending list")
-     */
-    QString getFormatedText()   { return _formatedText; }
-    /**
-     * @return true: This message is a of a severity which is considered an error
-     */
-    bool severityIsError();
-
-private:
-    UASMessage(int componentid, int severity, QString text);
-    void _setFormatedText(const QString formatedText) { _formatedText = formatedText; }
-    int _compId;
-    int _severity;
-    QString _text;
-    QString _formatedText;
-};
-
 class UASMessageHandler : public QGCTool
 {
     Q_OBJECT
@@ -67,17 +29,13 @@ public:
     ~UASMessageHandler();
 
     /**
-     * @brief Locks access to the message list
-     */
-    void lockAccess()   {_mutex.lock(); }
-    /**
-     * @brief Unlocks access to the message list
+     * @brief Access to the message list. Only holds the most recent maxMessages() messages.
      */
-    void unlockAccess() {_mutex.unlock(); }
+    UASMessageListModel* messageModel() { return _messageModel; }
     /**
-     * @brief Access to the message list
+     * @brief Maximum number of messages which are kept
      */
-    const QVector<UASMessage*>& messages() { return _messages; }
+    int maxMessages() const { return _messageModel->capacity(); }
     /**
      * @brief Clear messages
      */
@@ -98,6 +56,14 @@ public:
      * @brief Get normal message count (Resets count once read)
      */
     int getNormalCount();
+    /**
+     * @brief Get count of messages received for the specified MAV_SEVERITY since last clear (never reset once read)
+     */
+    int getSeverityCount(int severity);
+    /**
+     * @brief Get count of older messages which were dropped from the message list since last clear
+     */
+    int getDroppedCount();
     /**
      * @brief Get latest error message
      */
@@ -122,9 +88,9 @@ public slots:
 signals:
     /**
      * @brief Sent out when new message arrives
-     * @param message A pointer to the message. NULL if resetting (new UAS assigned)
+     * @param message The new message
      */
-    void textMessageReceived(UASMessage* message);
+    void textMessageReceived(const UASMessage& message);
     /**
      * @brief Sent out when the message count changes
      * @param count The new message count
@@ -135,15 +101,20 @@ private slots:
     void _activeVehicleChanged(Vehicle* vehicle);
 
 private:
+    static const int _cMaxMessages  = 500;
+    static const int _cSeverities   = MAV_SEVERITY_DEBUG + 1;
+
     Vehicle*                _activeVehicle;
     int                     _activeComponent;
     bool                    _multiComp;
-    QVector<UASMessage*>    _messages;
+    UASMessageListModel*    _messageModel;
     QMutex                  _mutex;
     int                     _errorCount;
     int                     _errorCountTotal;
     int                     _warningCount;
     int                     _normalCount;
+    int                     _droppedCount;
+    int                     _severityCounts[_cSeverities];
     QString                 _latestError;
     bool                    _showErrorsInToolbar;
     MultiVehicleManager*    _multiVehicleManager;
@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UASMessageHandlerTest.h"
+#include "UASMessageHandler.h"
+#include "QGCApplication.h"
+#include "MockLink.h"
+
+#include <QElapsedTimer>
+
+void UASMessageHandlerTest::_ringBufferTest(void)
+{
+    const int cCapacity = 4;
+    UASMessageListModel model(cCapacity);
+
+    QSignalSpy spyRowsRemoved(&model, &QAbstractItemModel::rowsRemoved);
+
+    for (int i=0; i<cCapacity; i++) {
+        QCOMPARE(model.append(UASMessage(MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_INFO, QString::number(i))), false);
+    }
+    QCOMPARE(model.count(),         cCapacity);
+    QCOMPARE(spyRowsRemoved.count(), 0);
+
+    // Once full the oldest entry should be dropped for each new entry
+    for (int i=cCapacity; i<cCapacity * 2 + 1; i++) {
+        QCOMPARE(model.append(UASMessage(MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_ERROR, QString::number(i))), true);
+    }
+    QCOMPARE(model.count(),             cCapacity);
+    QCOMPARE(model.rowCount(),          cCapacity);
+    QCOMPARE(spyRowsRemoved.count(),    cCapacity + 1);
+    for (int i=0; i<cCapacity; i++) {
+        QCOMPARE(model.at(i).getText(), QString::number(cCapacity + 1 + i));
+        QCOMPARE(model.data(model.index(i), UASMessageListModel::TextRole).toString(), QString::number(cCapacity + 1 + i));
+    }
+
+    // Formatting is done on demand and follows the current component display setting
+    QString formatted = model.data(model.index(0), UASMessageListModel::FormattedTextRole).toString();
+    QVERIFY(formatted.startsWith(QStringLiteral("<font style=\"<#E>\">")));
+    QVERIFY(!formatted.contains(QStringLiteral("COMP:")));
+    QSignalSpy spyDataChanged(&model, &QAbstractItemModel::dataChanged);
+    model.setShowComponent(true);
+    QCOMPARE(spyDataChanged.count(), 1);
+    formatted = model.data(model.index(0), UASMessageListModel::FormattedTextRole).toString();
+    QVERIFY(formatted.contains(QStringLiteral(" COMP:%1").arg(MAV_COMP_ID_AUTOPILOT1)));
+
+    model.clear();
+    QCOMPARE(model.count(), 0);
+    QCOMPARE(model.append(UASMessage(MAV_COMP_ID_AUTOPILOT1, MAV_SEVERITY_INFO, QStringLiteral("after clear"))), false);
+    QCOMPARE(model.at(0).getText(), QStringLiteral("after clear"));
+}
+
+void UASMessageHandlerTest::_floodTest(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    UASMessageHandler*      handler     = qgcApp()->toolbox()->uasMessageHandler();
+    UASMessageListModel*    model       = handler->messageModel();
+    const int               cSeverities = MAV_SEVERITY_DEBUG + 1;
+    const int               cMessages   = handler->maxMessages() * cSeverities;
+
+    handler->clearMessages();
+
+    QElapsedTimer timer;
+    timer.start();
+    _mockLink->sendStatusTextFlood(cMessages);
+
+    auto totalReceived = [&]() {
+        int total = 0;
+        for (int severity=0; severity<cSeverities; severity++) {
+            total += handler->getSeverityCount(severity);
+        }
+        return total;
+    };
+    QVERIFY(QTest::qWaitFor([&]() { return totalReceived() == cMessages; }, 10000));
+    qDebug() << "Processed" << cMessages << "STATUSTEXT messages in" << timer.elapsed() << "msecs";
+
+    // Memory is bounded by the ring buffer, with only the most recent messages kept
+    QCOMPARE(model->count(),                handler->maxMessages());
+    QCOMPARE(handler->getDroppedCount(),    cMessages - handler->maxMessages());
+    QCOMPARE(model->at(0).getText(),                    QStringLiteral("Flood %1").arg(cMessages - handler->maxMessages()));
+    QCOMPARE(model->at(model->count() - 1).getText(),   QStringLiteral("Flood %1").arg(cMessages - 1));
+
+    for (int severity=0; severity<cSeverities; severity++) {
+        QCOMPARE(handler->getSeverityCount(severity), cMessages / cSeverities);
+    }
+
+    handler->clearMessages();
+    QCOMPARE(model->count(),                0);
+    QCOMPARE(handler->getDroppedCount(),    0);
+    QCOMPARE(totalReceived(),               0);
+
+    _disconnectMockLink();
+}
@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UASMessageListModel.h"
+#include "QGCMAVLink.h"
+
+#include <QDateTime>
+#include <QQmlEngine>
+
+UASMessage::UASMessage(int componentid, int severity, const QString& text)
+    : _timestamp(QDateTime::currentMSecsSinceEpoch())
+    , _text     (text)
+    , _compId   (static_cast<quint8>(componentid))
+    , _severity (static_cast<quint8>(severity))
+{
+
+}
+
+bool UASMessage::severityIsError(int severity)
+{
+    switch (severity) {
+        case MAV_SEVERITY_EMERGENCY:
+        case MAV_SEVERITY_ALERT:
+        case MAV_SEVERITY_CRITICAL:
+        case MAV_SEVERITY_ERROR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+QString UASMessage::severityText(int severity)
+{
+    switch (severity) {
+    case MAV_SEVERITY_EMERGENCY:
+        return QObject::tr(" EMERGENCY:");
+    case MAV_SEVERITY_ALERT:
+        return QObject::tr(" ALERT:");
+    case MAV_SEVERITY_CRITICAL:
+        return QObject::tr(" Critical:");
+    case MAV_SEVERITY_ERROR:
+        return QObject::tr(" Error:");
+    case MAV_SEVERITY_WARNING:
+        return QObject::tr(" Warning:");
+    case MAV_SEVERITY_NOTICE:
+        return QObject::tr(" Notice:");
+    case MAV_SEVERITY_INFO:
+        return QObject::tr(" Info:");
+    case MAV_SEVERITY_DEBUG:
+        return QObject::tr(" Debug:");
+    default:
+        return QString();
+    }
+}
+
+QString UASMessage::getFormatedText(bool showComponent) const
+{
+    // Color the output depending on the message severity. We have 3 distinct cases:
+    // 1: If we have an ERROR or worse, make it bigger, bolder, and highlight it red.
+    // 2: If we have a warning or notice, just make it bold and color it orange.
+    // 3: Otherwise color it the standard color, white.
+    QString style;
+    switch (_severity) {
+    case MAV_SEVERITY_EMERGENCY:
+    case MAV_SEVERITY_ALERT:
+    case MAV_SEVERITY_CRITICAL:
+    case MAV_SEVERITY_ERROR:
+        style = QStringLiteral("<#E>");
+        break;
+    case MAV_SEVERITY_NOTICE:
+    case MAV_SEVERITY_WARNING:
+        style = QStringLiteral("<#I>");
+        break;
+    default:
+        style = QStringLiteral("<#N>");
+        break;
+    }
+
+    QString dateString = QDateTime::fromMSecsSinceEpoch(_timestamp).toString(QStringLiteral("hh:mm:ss.zzz"));
+    QString compString;
+    if (showComponent) {
+        compString = QStringLiteral(" COMP:%1").arg(_compId);
+    }
+
+    return QStringLiteral("<font style=\"%1\">[%2%3]%4 %5</font><br/>").arg(style, dateString, compString, severityText(_severity), _text);
+}
+
+UASMessageListModel::UASMessageListModel(int capacity, QObject* parent)
+    : QAbstractListModel(parent)
+    , _ring             (qMax(capacity, 1))
+{
+    QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+}
+
+bool UASMessageListModel::append(const UASMessage& message)
+{
+    bool dropped = false;
+
+    if (_count == _ring.count()) {
+        beginRemoveRows(QModelIndex(), 0, 0);
+        _first = (_first + 1) % _ring.count();
+        _count--;
+        endRemoveRows();
+        dropped = true;
+    }
+
+    beginInsertRows(QModelIndex(), _count, _count);
+    _ring[(_first + _count) % _ring.count()] = message;
+    _count++;
+    endInsertRows();
+
+    if (!dropped) {
+        emit countChanged(_count);
+    }
+
+    return dropped;
+}
+
+void UASMessageListModel::clear(void)
+{
+    if (_count == 0) {
+        return;
+    }
+
+    beginResetModel();
+    // Release the text storage, the record slots themselves are reused
+    for (int i=0; i<_ring.count(); i++) {
+        _ring[i] = UASMessage();
+    }
+    _first = 0;
+    _count = 0;
+    endResetModel();
+
+    emit countChanged(0);
+}
+
+void UASMessageListModel::setShowComponent(bool showComponent)
+{
+    if (showComponent != _showComponent) {
+        _showComponent = showComponent;
+        if (_count) {
+            emit dataChanged(index(0), index(_count - 1), { FormattedTextRole });
+        }
+        emit showComponentChanged(_showComponent);
+    }
+}
+
+int UASMessageListModel::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+
+    return _count;
+}
+
+QVariant UASMessageListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= _count) {
+        return QVariant();
+    }
+
+    const UASMessage& message = at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return message.getText();
+    case FormattedTextRole:
+        return message.getFormatedText(_showComponent);
+    case SeverityRole:
+        return message.getSeverity();
+    case ComponentIdRole:
+        return message.getComponentID();
+    case TimestampRole:
+        return QDateTime::fromMSecsSinceEpoch(message.getTimestamp());
+    case IsErrorRole:
+        return message.severityIsError();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> UASMessageListModel::roleNames(void) const
+{
+    QHash<int, QByteArray> hash;
+
+    hash[TextRole]          = "text";
+    hash[FormattedTextRole] = "formattedText";
+    hash[SeverityRole]      = "severity";
+    hash[ComponentIdRole]   = "componentId";
+    hash[TimestampRole]     = "timestamp";
+    hash[IsErrorRole]       = "isError";
+
+    return hash;
+}
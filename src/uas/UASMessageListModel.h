@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QVector>
+
+/*!
+ * @class UASMessage
+ * @brief Compact message record. Display formatting is only done when asked for.
+ */
+class UASMessage
+{
+public:
+    UASMessage(void) = default;
+    UASMessage(int componentid, int severity, const QString& text);
+
+    /**
+     * @brief Get message source component ID
+     */
+    int getComponentID() const  { return _compId; }
+    /**
+     * @brief Get message severity (from MAV_SEVERITY_XXX enum)
+     */
+    int getSeverity() const     { return _severity; }
+    /**
+     * @brief Get message text (e.g. "[pm] sending list")
+     */
+    QString getText() const     { return _text; }
+    /**
+     * @brief Get time message was received in msecs since epoch
+     */
+    qint64 getTimestamp() const { return _timestamp; }
+    /**
+     * @brief Get (html) formatted text (in the form: "[11:44:21.137 - COMP:50] Info: [pm] sending list")
+     * @param showComponent true: include the source component id in the output
+     */
+    QString getFormatedText(bool showComponent) const;
+    /**
+     * @return true: This message is a of a severity which is considered an error
+     */
+    bool severityIsError() const { return severityIsError(_severity); }
+
+    static bool     severityIsError (int severity);
+    static QString  severityText    (int severity);
+
+private:
+    qint64  _timestamp  = 0;
+    QString _text;
+    quint8  _compId     = 0;
+    quint8  _severity   = 0;
+};
+
+/// Fixed capacity ring buffer of vehicle messages which is exposed to QML as a list model.
+/// Once full, the oldest message is dropped for each new one which is appended.
+class UASMessageListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    UASMessageListModel(int capacity, QObject* parent = nullptr);
+
+    Q_PROPERTY(int  count           READ count          NOTIFY countChanged)
+    Q_PROPERTY(bool showComponent   READ showComponent  NOTIFY showComponentChanged)
+
+    enum Roles {
+        TextRole = Qt::UserRole + 1,
+        FormattedTextRole,
+        SeverityRole,
+        ComponentIdRole,
+        TimestampRole,
+        IsErrorRole,
+    };
+
+    int     capacity        (void) const { return _ring.count(); }
+    int     count           (void) const { return _count; }
+    bool    showComponent   (void) const { return _showComponent; }
+
+    /// @return Message at the specified index, 0 is the oldest message
+    const UASMessage& at(int index) const { return _ring[(_first + index) % _ring.count()]; }
+
+    /// Adds a new message, dropping the oldest if the buffer is full
+    ///     @return true: an older message was dropped
+    bool append(const UASMessage& message);
+
+    void clear              (void);
+    void setShowComponent   (bool showComponent);
+
+    // Overrides from QAbstractListModel
+    int                     rowCount    (const QModelIndex& parent = QModelIndex()) const override;
+    QVariant                data        (const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray>  roleNames   (void) const override;
+
+signals:
+    void countChanged           (int count);
+    void showComponentChanged   (bool showComponent);
+
+private:
+    QVector<UASMessage> _ring;
+    int                 _first          = 0;
+    int                 _count          = 0;
+    bool                _showComponent  = false;
+};
@@ -91,26 +91,14 @@ Item {
             }
 
             Component.onCompleted: {
-                messageText.text = formatMessage(_activeVehicle.formattedMessages)
-                //-- Hack to scroll to last message
-                for (var i = 0; i < _activeVehicle.messageCount; i++)
-                    messageFlick.flick(0,-5000)
+                messageList.positionViewAtEnd()
                 _activeVehicle.resetMessages()
             }
 
-            Connections {
-                target: _activeVehicle
-                onNewFormattedMessage :{
-                    messageText.append(formatMessage(formattedMessage))
-                    //-- Hack to scroll down
-                    messageFlick.flick(0,-500)
-                }
-            }
-
             QGCLabel {
                 anchors.centerIn:   parent
                 text:               qsTr("No Messages")
-                visible:            messageText.length === 0
+                visible:            messageList.count === 0
             }
 
             //-- Clear Messages
@@ -126,7 +114,7 @@ Item {
                 mipmap:             true
                 smooth:             true
                 color:              qgcPal.text
-                visible:            messageText.length !== 0
+                visible:            messageList.count !== 0
                 MouseArea {
                     anchors.fill:   parent
                     onClicked: {
@@ -138,19 +126,33 @@ Item {
                 }
             }
 
-            QGCFlickable {
-                id:                 messageFlick
+            QGCListView {
+                id:                 messageList
                 anchors.margins:    ScreenTools.defaultFontPixelHeight
                 anchors.fill:       parent
-                contentHeight:      messageText.height
-                contentWidth:       messageText.width
+                clip:               true
                 pixelAligned:       true
+                model:              _activeVehicle ? _activeVehicle.messageModel : 0
 
-                TextEdit {
-                    id:             messageText
+                // Html formatting only happens for the rows which are actually visible
+                delegate: TextEdit {
+                    width:          messageList.width
                     readOnly:       true
+                    selectByMouse:  true
+                    wrapMode:       TextEdit.WrapAtWordBoundaryOrAnywhere
                     textFormat:     TextEdit.RichText
                     color:          qgcPal.text
+                    text:           formatMessage(formattedText)
+                }
+
+                Component.onCompleted:  positionViewAtEnd()
+                onModelChanged:         positionViewAtEnd()
+
+                //-- Keep the latest message in view as new ones arrive. Once the model is full each new message
+                //-- replaces the oldest one, so the count no longer changes.
+                Connections {
+                    target:         _activeVehicle ? _activeVehicle.messageModel : null
+                    onRowsInserted: messageList.positionViewAtEnd()
                 }
             }
         }